@@ -0,0 +1,96 @@
+//
+//  mglBltSpritesCommand.swift
+//  mglMetal
+//
+//  Created by justin gardner on 10/19/26.
+//  Copyright © 2026 GRU. All rights reserved.
+//
+
+import Foundation
+import MetalKit
+
+// Many sprites from atlas pages in one command, with one record per sprite: [x y width height rotation alpha u0 v0 u1 v1 textureNumber].
+// u0 v0 u1 v1 is where the sprite is on its page, with v going down, and textureNumber is the page (see mglAtlasCreate).
+// Each record is drawn as an instance of a quad, with one draw for each run of records from the same page,
+// so sprites are drawn in the order given, and a whole frame of letters or icons takes one command.
+class mglBltSpritesCommand : mglCommand {
+    private let spriteBuffer: MTLBuffer
+    private let spriteCount: Int
+    // consecutive records with the same texture number, drawn together
+    private let runs: [(textureNumber: UInt32, start: Int, count: Int)]
+
+    init(spriteBuffer: MTLBuffer, spriteCount: Int) {
+        self.spriteBuffer = spriteBuffer
+        self.spriteCount = spriteCount
+        self.runs = findRuns(spriteBuffer: spriteBuffer, spriteCount: spriteCount)
+        super.init(framesRemaining: 1)
+    }
+
+    init?(commandInterface: mglCommandInterface, device: MTLDevice) {
+        // Read and buffer sprite records, which are the same size as vertices with 11 values.
+        guard let (spriteBuffer, spriteCount) = commandInterface.readVertices(device: device, extraVals: 8) else {
+            return nil
+        }
+        self.spriteBuffer = spriteBuffer
+        self.spriteCount = spriteCount
+        self.runs = findRuns(spriteBuffer: spriteBuffer, spriteCount: spriteCount)
+        super.init(framesRemaining: 1)
+    }
+
+    override func draw(
+        logger: mglLogger,
+        view: MTKView,
+        depthStencilState: mglDepthStencilState,
+        colorRenderingState: mglColorRenderingState,
+        deg2metal: inout simd_float4x4,
+        targetPresentationTimestamp: CFTimeInterval?,
+        renderEncoder: MTLRenderCommandEncoder
+    ) -> Bool {
+        if spriteCount == 0 {
+            return true
+        }
+        guard let device = view.device else {
+            return false
+        }
+
+        // Sprites are packed next to each other on a page, so sample without wrapping or mipmaps,
+        // and let the padding that mglAtlasCreate leaves around each one take the linear filtering.
+        let samplerDescriptor = MTLSamplerDescriptor()
+        samplerDescriptor.minFilter = .linear
+        samplerDescriptor.magFilter = .linear
+        samplerDescriptor.mipFilter = .notMipmapped
+        samplerDescriptor.sAddressMode = .clampToEdge
+        samplerDescriptor.tAddressMode = .clampToEdge
+        samplerDescriptor.rAddressMode = .clampToEdge
+        let samplerState = device.makeSamplerState(descriptor: samplerDescriptor)
+
+        // Render each sprite as an instance of two triangles, with the page of each run.
+        renderEncoder.setRenderPipelineState(colorRenderingState.getSpritesPipelineState())
+        renderEncoder.setVertexBuffer(spriteBuffer, offset: 0, index: 0)
+        renderEncoder.setFragmentSamplerState(samplerState, index: 0)
+        for run in runs {
+            guard let texture = colorRenderingState.getTexture(textureNumber: run.textureNumber) else {
+                logger.error(component: "mglBltSpritesCommand", details: "Sprites \(run.start) to \(run.start + run.count - 1) are on texture \(run.textureNumber), which does not exist.")
+                return false
+            }
+            renderEncoder.setFragmentTexture(texture, index: 0)
+            renderEncoder.drawPrimitives(type: .triangle, vertexStart: 0, vertexCount: 6, instanceCount: run.count, baseInstance: run.start)
+        }
+        return true
+    }
+}
+
+// Find the runs of records from each page, from the last value of each record.
+private func findRuns(spriteBuffer: MTLBuffer, spriteCount: Int) -> [(textureNumber: UInt32, start: Int, count: Int)] {
+    let records = spriteBuffer.contents().bindMemory(to: Float32.self, capacity: spriteCount * 11)
+    var runs: [(textureNumber: UInt32, start: Int, count: Int)] = []
+    for index in 0 ..< spriteCount {
+        let textureNumber = UInt32(records[index * 11 + 10])
+        if let last = runs.last, last.textureNumber == textureNumber {
+            runs[runs.count - 1].count += 1
+        } else {
+            runs.append((textureNumber: textureNumber, start: index, count: 1))
+        }
+    }
+    return runs
+}
@@ -56,6 +56,21 @@ class mglBltTextureCommand : mglCommand {
         super.init(framesRemaining: 1)
     }
 
+    override func substituting(parameter: mglDisplayListParameter) -> mglCommand? {
+        guard case let .textureNumber(textureNumber) = parameter else {
+            return nil
+        }
+        return mglBltTextureCommand(
+            minMagFilter: minMagFilter,
+            mipFilter: mipFilter,
+            addressMode: addressMode,
+            vertexBufferTexture: vertexBufferTexture,
+            vertexCount: vertexCount,
+            phase: phase,
+            textureNumber: textureNumber
+        )
+    }
+
     override func draw(
         logger: mglLogger,
         view: MTKView,
@@ -0,0 +1,127 @@
+//
+//  mglCallDisplayListCommand.swift
+//  mglMetal
+//
+//  Created by justin gardner on 10/19/26.
+//  Copyright © 2026 GRU. All rights reserved.
+//
+
+import Foundation
+import MetalKit
+
+// Replay the commands of a display list into the current frame, with some parameters swapped in.
+class mglCallDisplayListCommand : mglCommand {
+    private let displayListNumber: UInt32
+    private let commands: [mglCommand]?
+
+    init(displayListNumber: UInt32, displayList: mglDisplayList, parameters: [(commandIndex: Int, parameter: mglDisplayListParameter)] = []) {
+        self.displayListNumber = displayListNumber
+        self.commands = displayList.commandsForCall(parameters: parameters)
+        super.init(framesRemaining: 1)
+    }
+
+    init?(commandInterface: mglCommandInterface) {
+        guard let displayListNumber = commandInterface.readUInt32(),
+              let parameterCount = commandInterface.readUInt32() else {
+            return nil
+        }
+
+        // Read the parameter block: for each parameter, which command, which kind, and the value.
+        var parameters = [(commandIndex: Int, parameter: mglDisplayListParameter)]()
+        for _ in 0 ..< parameterCount {
+            guard let commandIndex = commandInterface.readUInt32(),
+                  let kind = commandInterface.readUInt32() else {
+                return nil
+            }
+            switch kind {
+            case mglDisplayListParameter.textureNumberKind:
+                guard let textureNumber = commandInterface.readUInt32() else {
+                    return nil
+                }
+                parameters.append((Int(commandIndex), .textureNumber(textureNumber)))
+            case mglDisplayListParameter.xformKind:
+                guard let xform = commandInterface.readXform() else {
+                    return nil
+                }
+                parameters.append((Int(commandIndex), .xform(xform)))
+            case mglDisplayListParameter.colorKind:
+                guard let color = commandInterface.readColor() else {
+                    return nil
+                }
+                parameters.append((Int(commandIndex), .color(color)))
+            default:
+                return nil
+            }
+        }
+        self.displayListNumber = displayListNumber
+
+        // Look up the display list now, so that it can be deleted right after this call is sent.
+        // If it's missing or the parameters don't fit, this command will report failure when processed.
+        self.commands = commandInterface.getDisplayList(displayListNumber: displayListNumber)?.commandsForCall(parameters: parameters)
+        super.init(framesRemaining: 1)
+    }
+
+    override func doNondrawingWork(
+        logger: mglLogger,
+        view: MTKView,
+        depthStencilState: mglDepthStencilState,
+        colorRenderingState: mglColorRenderingState,
+        renderer: mglRenderer2,
+        deg2metal: inout simd_float4x4,
+        targetPresentationTimestamp: CFTimeInterval?
+    ) -> Bool {
+        guard let commands = commands else {
+            logger.error(component: "mglCallDisplayListCommand", details: "Display list number \(displayListNumber) does not exist or does not take the given parameters")
+            return false
+        }
+
+        // Let all the recorded commands do their nondrawing work, like setting the clear color,
+        // up front, so that it applies to this frame as if the commands had been sent one at a time.
+        for command in commands {
+            let nondrawingSuccess = command.doNondrawingWork(
+                logger: logger,
+                view: view,
+                depthStencilState: depthStencilState,
+                colorRenderingState: colorRenderingState,
+                renderer: renderer,
+                deg2metal: &deg2metal,
+                targetPresentationTimestamp: targetPresentationTimestamp
+            )
+            if !nondrawingSuccess {
+                return false
+            }
+        }
+        return true
+    }
+
+    override func draw(
+        logger: mglLogger,
+        view: MTKView,
+        depthStencilState: mglDepthStencilState,
+        colorRenderingState: mglColorRenderingState,
+        deg2metal: inout simd_float4x4,
+        targetPresentationTimestamp: CFTimeInterval?,
+        renderEncoder: MTLRenderCommandEncoder
+    ) -> Bool {
+        guard let commands = commands else {
+            return false
+        }
+
+        // Draw the recorded commands in the order they were sent.
+        for command in commands {
+            let drawSuccess = command.draw(
+                logger: logger,
+                view: view,
+                depthStencilState: depthStencilState,
+                colorRenderingState: colorRenderingState,
+                deg2metal: &deg2metal,
+                targetPresentationTimestamp: targetPresentationTimestamp,
+                renderEncoder: renderEncoder
+            )
+            if !drawSuccess {
+                return false
+            }
+        }
+        return true
+    }
+}
@@ -0,0 +1,68 @@
+//
+//  mglCreateGeometryCommand.swift
+//  mglMetal
+//
+//  Created by justin gardner on 10/19/26.
+//  Copyright © 2026 GRU. All rights reserved.
+//
+
+import Foundation
+import MetalKit
+
+class mglCreateGeometryCommand : mglCommand {
+    private let geometry: mglGeometry
+    var geometryNumber: UInt32 = 0
+    var geometryCount: UInt32 = 0
+
+    init(geometry: mglGeometry) {
+        self.geometry = geometry
+        super.init()
+    }
+
+    init?(commandInterface: mglCommandInterface, device: MTLDevice) {
+        // Read the type of geometry, which says how many values each vertex has.
+        guard let geometryTypeCode = commandInterface.readUInt32(),
+              let geometryType = mglGeometryType(rawValue: geometryTypeCode) else {
+            return nil
+        }
+
+        // Read and buffer the vertices, which have xyz plus extra values depending on the type.
+        guard let (buffer, vertexCount) = commandInterface.readVertices(device: device, extraVals: geometryType.valuesPerVertex - 3) else {
+            return nil
+        }
+        geometry = mglGeometry(geometryType: geometryType, buffer: buffer, vertexCount: vertexCount)
+        super.init()
+    }
+
+    override func doNondrawingWork(
+        logger: mglLogger,
+        view: MTKView,
+        depthStencilState: mglDepthStencilState,
+        colorRenderingState: mglColorRenderingState,
+        renderer: mglRenderer2,
+        deg2metal: inout simd_float4x4,
+        targetPresentationTimestamp: CFTimeInterval?
+    ) -> Bool {
+        geometryNumber = colorRenderingState.addGeometry(geometry: geometry)
+        geometryCount = colorRenderingState.getGeometryCount()
+        return true
+    }
+
+    override func writeQueryResults(
+        logger: mglLogger,
+        commandInterface : mglCommandInterface
+    ) -> Bool {
+        if (geometryNumber < 1) {
+            // A heads up that something went wrong.
+            _ = commandInterface.writeDouble(data: -commandInterface.secs.get())
+        }
+
+        // A heads up that return data is on the way.
+        _ = commandInterface.writeDouble(data: commandInterface.secs.get())
+
+        // Specific return data for this command.
+        _ = commandInterface.writeUInt32(data: geometryNumber)
+        _ = commandInterface.writeUInt32(data: geometryCount)
+        return true
+    }
+}
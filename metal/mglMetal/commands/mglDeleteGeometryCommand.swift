@@ -0,0 +1,39 @@
+//
+//  mglDeleteGeometryCommand.swift
+//  mglMetal
+//
+//  Created by justin gardner on 10/19/26.
+//  Copyright © 2026 GRU. All rights reserved.
+//
+
+import Foundation
+import MetalKit
+
+class mglDeleteGeometryCommand : mglCommand {
+    let geometryNumber: UInt32
+
+    init(geometryNumber: UInt32) {
+        self.geometryNumber = geometryNumber
+        super.init()
+    }
+
+    init?(commandInterface: mglCommandInterface) {
+        guard let geometryNumber = commandInterface.readUInt32() else {
+            return nil
+        }
+        self.geometryNumber = geometryNumber
+        super.init()
+    }
+
+    override func doNondrawingWork(
+        logger: mglLogger,
+        view: MTKView,
+        depthStencilState: mglDepthStencilState,
+        colorRenderingState: mglColorRenderingState,
+        renderer: mglRenderer2,
+        deg2metal: inout simd_float4x4,
+        targetPresentationTimestamp: CFTimeInterval?
+    ) -> Bool {
+        return colorRenderingState.removeGeometry(geometryNumber: geometryNumber) != nil
+    }
+}
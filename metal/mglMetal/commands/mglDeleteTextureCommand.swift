@@ -34,6 +34,6 @@ class mglDeleteTextureCommand : mglCommand {
         deg2metal: inout simd_float4x4,
         targetPresentationTimestamp: CFTimeInterval?
     ) -> Bool {
-        return colorRenderingState.removeTexture(textureNumber: textureNumber) != nil
+        return colorRenderingState.removeTexture(textureNumber: textureNumber)
     }
 }
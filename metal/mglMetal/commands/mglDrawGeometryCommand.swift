@@ -0,0 +1,74 @@
+//
+//  mglDrawGeometryCommand.swift
+//  mglMetal
+//
+//  Created by justin gardner on 10/19/26.
+//  Copyright © 2026 GRU. All rights reserved.
+//
+
+import Foundation
+import MetalKit
+
+// Draw existing geometry by number, optionally moved by its own transform.
+class mglDrawGeometryCommand : mglCommand {
+    private let geometryNumber: UInt32
+    private let xform: simd_float4x4?
+
+    init(geometryNumber: UInt32, xform: simd_float4x4? = nil) {
+        self.geometryNumber = geometryNumber
+        self.xform = xform
+        super.init(framesRemaining: 1)
+    }
+
+    init?(commandInterface: mglCommandInterface) {
+        guard let geometryNumber = commandInterface.readUInt32(),
+              let hasXform = commandInterface.readUInt32() else {
+            return nil
+        }
+        var xform: simd_float4x4? = nil
+        if hasXform != 0 {
+            guard let geometryXform = commandInterface.readXform() else {
+                return nil
+            }
+            xform = geometryXform
+        }
+        self.geometryNumber = geometryNumber
+        self.xform = xform
+        super.init(framesRemaining: 1)
+    }
+
+    override func substituting(parameter: mglDisplayListParameter) -> mglCommand? {
+        guard case let .xform(xform) = parameter else {
+            return nil
+        }
+        return mglDrawGeometryCommand(geometryNumber: geometryNumber, xform: xform)
+    }
+
+    override func draw(
+        logger: mglLogger,
+        view: MTKView,
+        depthStencilState: mglDepthStencilState,
+        colorRenderingState: mglColorRenderingState,
+        deg2metal: inout simd_float4x4,
+        targetPresentationTimestamp: CFTimeInterval?,
+        renderEncoder: MTLRenderCommandEncoder
+    ) -> Bool {
+        guard let geometry = colorRenderingState.getGeometry(geometryNumber: geometryNumber) else {
+            return false
+        }
+
+        // Apply the geometry's own transform, for this draw only.
+        if let xform = xform {
+            var geometryDeg2metal = deg2metal * xform
+            renderEncoder.setVertexBytes(&geometryDeg2metal, length: MemoryLayout<float4x4>.stride, index: 1)
+        }
+
+        geometry.draw(colorRenderingState: colorRenderingState, renderEncoder: renderEncoder)
+
+        // Put back the usual transform for whatever is drawn next.
+        if xform != nil {
+            renderEncoder.setVertexBytes(&deg2metal, length: MemoryLayout<float4x4>.stride, index: 1)
+        }
+        return true
+    }
+}
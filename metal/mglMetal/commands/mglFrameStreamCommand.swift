@@ -0,0 +1,229 @@
+//
+//  mglFrameStreamCommand.swift
+//  mglMetal
+//
+//  Created by justin gardner on 10/19/26.
+//  Copyright © 2026 GRU. All rights reserved.
+//
+
+import Foundation
+import MetalKit
+
+//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++
+// command to open a file of precomputed frames (see mglFrameStream.h)
+// and start prefetching them onto a ring of slotCount textures
+//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++
+class mglFrameStreamOpenCommand : mglCommand {
+    private let path: String
+    private let slotCount: UInt32
+    private var frameStream: mglFrameStreamTextures? = nil
+    private(set) var frameStreamNumber = UInt32(0)
+
+    init(path: String, slotCount: UInt32) {
+        self.path = path
+        self.slotCount = slotCount
+        super.init()
+    }
+
+    init?(commandInterface: mglCommandInterface) {
+        self.path = commandInterface.readString()
+        guard let slotCount = commandInterface.readUInt32() else {
+            return nil
+        }
+        self.slotCount = slotCount
+        super.init()
+    }
+
+    override func doNondrawingWork(
+        logger: mglLogger,
+        view: MTKView,
+        depthStencilState: mglDepthStencilState,
+        colorRenderingState: mglColorRenderingState,
+        renderer: mglRenderer2,
+        deg2metal: inout simd_float4x4,
+        targetPresentationTimestamp: CFTimeInterval?
+    ) -> Bool {
+        guard let device = view.device,
+              let frameStream = mglFrameStreamTextures(path: path, slotCount: Int(slotCount), device: device, logger: logger) else {
+            return false
+        }
+        self.frameStream = frameStream
+        frameStreamNumber = colorRenderingState.addFrameStream(frameStream: frameStream)
+        return true
+    }
+
+    // Return status, then the frame stream number, frame count, width, height and frame rate.
+    override func writeQueryResults(
+        logger: mglLogger,
+        commandInterface : mglCommandInterface
+    ) -> Bool {
+        guard let frameStream = frameStream else {
+            _ = commandInterface.writeDouble(data: -1.0)
+            return true
+        }
+        _ = commandInterface.writeDouble(data: 1.0)
+        _ = commandInterface.writeUInt32(data: frameStreamNumber)
+        _ = commandInterface.writeUInt32(data: frameStream.frameCount)
+        _ = commandInterface.writeUInt32(data: frameStream.width)
+        _ = commandInterface.writeUInt32(data: frameStream.height)
+        _ = commandInterface.writeDouble(data: frameStream.frameRate)
+        return true
+    }
+}
+
+//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++
+// command to show one frame of a frame stream on the next flush,
+// blted on the given vertices [xyz uv] like mglBltTexture
+//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++
+class mglFrameStreamShowFrameCommand : mglCommand {
+    private let frameStreamNumber: UInt32
+    private let frame: UInt32
+    private let timeoutSecs: Float32
+    private let vertexBufferTexture: MTLBuffer
+    private let vertexCount: Int
+    private var frameStream: mglFrameStreamTextures? = nil
+
+    init(frameStreamNumber: UInt32, frame: UInt32, timeoutSecs: Float32, vertexBufferTexture: MTLBuffer, vertexCount: Int) {
+        self.frameStreamNumber = frameStreamNumber
+        self.frame = frame
+        self.timeoutSecs = timeoutSecs
+        self.vertexBufferTexture = vertexBufferTexture
+        self.vertexCount = vertexCount
+        super.init(framesRemaining: 1)
+    }
+
+    init?(commandInterface: mglCommandInterface, device: MTLDevice) {
+        guard let frameStreamNumber = commandInterface.readUInt32(),
+              let frame = commandInterface.readUInt32(),
+              let timeoutSecs = commandInterface.readFloat(),
+              let (vertexBufferTexture, vertexCount) = commandInterface.readVertices(device: device, extraVals: 2) else {
+            return nil
+        }
+        self.frameStreamNumber = frameStreamNumber
+        self.frame = frame
+        self.timeoutSecs = timeoutSecs
+        self.vertexBufferTexture = vertexBufferTexture
+        self.vertexCount = vertexCount
+        super.init(framesRemaining: 1)
+    }
+
+    // Start decoding this frame now, so it is more likely ready by the time it is drawn.
+    override func doNondrawingWork(
+        logger: mglLogger,
+        view: MTKView,
+        depthStencilState: mglDepthStencilState,
+        colorRenderingState: mglColorRenderingState,
+        renderer: mglRenderer2,
+        deg2metal: inout simd_float4x4,
+        targetPresentationTimestamp: CFTimeInterval?
+    ) -> Bool {
+        guard let frameStream = colorRenderingState.getFrameStream(frameStreamNumber: frameStreamNumber) else {
+            return false
+        }
+        frameStream.prefetch(frame: frame)
+        self.frameStream = frameStream
+        return true
+    }
+
+    override func draw(
+        logger: mglLogger,
+        view: MTKView,
+        depthStencilState: mglDepthStencilState,
+        colorRenderingState: mglColorRenderingState,
+        deg2metal: inout simd_float4x4,
+        targetPresentationTimestamp: CFTimeInterval?,
+        renderEncoder: MTLRenderCommandEncoder
+    ) -> Bool {
+        guard let frameStream = frameStream ?? colorRenderingState.getFrameStream(frameStreamNumber: frameStreamNumber),
+              let device = view.device else {
+            return false
+        }
+        guard let texture = frameStream.acquire(frame: frame, currentFrame: colorRenderingState.getFrameCount(), timeoutSecs: Double(timeoutSecs)) else {
+            logger.error(component: "mglFrameStreamShowFrameCommand", details: "Frame \(frame) of frame stream \(frameStreamNumber) (\(frameStream.frameCount) frames) was not ready within \(timeoutSecs) secs.")
+            return false
+        }
+
+        // Frames are shown as they are, so no mipmaps or wrapping.
+        let samplerDescriptor = MTLSamplerDescriptor()
+        samplerDescriptor.minFilter = .linear
+        samplerDescriptor.magFilter = .linear
+        samplerDescriptor.mipFilter = .notMipmapped
+        samplerDescriptor.sAddressMode = .clampToEdge
+        samplerDescriptor.tAddressMode = .clampToEdge
+        samplerDescriptor.rAddressMode = .clampToEdge
+        let samplerState = device.makeSamplerState(descriptor: samplerDescriptor)
+
+        // Draw vertices as triangles with 5 values per vertex: [xyz uv].
+        var phase = Float32(0)
+        renderEncoder.setRenderPipelineState(colorRenderingState.getTexturePipelineState())
+        renderEncoder.setVertexBuffer(vertexBufferTexture, offset: 0, index: 0)
+        renderEncoder.setFragmentSamplerState(samplerState, index: 0)
+        renderEncoder.setFragmentBytes(&phase, length: MemoryLayout<Float>.stride, index: 2)
+        renderEncoder.setFragmentTexture(texture, index: 0)
+        renderEncoder.drawPrimitives(type: .triangle, vertexStart: 0, vertexCount: vertexCount)
+        return true
+    }
+}
+
+//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++
+// command to close a frame stream, which reports how many frames
+// were ready when shown, how many had to be waited for, how many
+// were missed and the longest wait
+//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++
+class mglFrameStreamCloseCommand : mglCommand {
+    private let frameStreamNumber: UInt32
+    private var frameStream: mglFrameStreamTextures? = nil
+
+    init(frameStreamNumber: UInt32) {
+        self.frameStreamNumber = frameStreamNumber
+        super.init()
+    }
+
+    init?(commandInterface: mglCommandInterface) {
+        guard let frameStreamNumber = commandInterface.readUInt32() else {
+            return nil
+        }
+        self.frameStreamNumber = frameStreamNumber
+        super.init()
+    }
+
+    override func doNondrawingWork(
+        logger: mglLogger,
+        view: MTKView,
+        depthStencilState: mglDepthStencilState,
+        colorRenderingState: mglColorRenderingState,
+        renderer: mglRenderer2,
+        deg2metal: inout simd_float4x4,
+        targetPresentationTimestamp: CFTimeInterval?
+    ) -> Bool {
+        // Keep the frame stream until its counts are written, then it closes when this command goes away.
+        frameStream = colorRenderingState.removeFrameStream(frameStreamNumber: frameStreamNumber)
+        return frameStream != nil
+    }
+
+    // Frames shown, whether they were ready or waited for, and frames missed.
+    var shownCount: UInt32 {
+        return (frameStream?.readyCount ?? 0) + (frameStream?.waitedCount ?? 0)
+    }
+
+    var missedCount: UInt32 {
+        return frameStream?.missedCount ?? 0
+    }
+
+    // Return status, then counts of frames ready, waited for and missed, and the longest wait.
+    override func writeQueryResults(
+        logger: mglLogger,
+        commandInterface : mglCommandInterface
+    ) -> Bool {
+        guard let frameStream = frameStream else {
+            _ = commandInterface.writeDouble(data: -1.0)
+            return true
+        }
+        _ = commandInterface.writeDouble(data: 1.0)
+        _ = commandInterface.writeUInt32(data: frameStream.readyCount)
+        _ = commandInterface.writeUInt32(data: frameStream.waitedCount)
+        _ = commandInterface.writeUInt32(data: frameStream.missedCount)
+        _ = commandInterface.writeDouble(data: frameStream.maxWaitSecs)
+        return true
+    }
+}
@@ -0,0 +1,63 @@
+//
+//  mglGetFrameTelemetryCommand.swift
+//  mglMetal
+//
+//  Created by justin gardner on 10/19/26.
+//  Copyright © 2026 GRU. All rights reserved.
+//
+
+import Foundation
+import MetalKit
+
+//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++
+// command to get the timing of onscreen frames after a given
+// frame number, from the frame telemetry ring buffer, as one
+// array with all of each field in turn (struct of arrays)
+//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++
+class mglGetFrameTelemetryCommand : mglCommand {
+    private let afterFrameNumber: UInt64
+    private var records: [mglFrameTelemetryRecord] = []
+    private var frameCount: UInt64 = 0
+
+    init(afterFrameNumber: UInt64 = 0) {
+        self.afterFrameNumber = afterFrameNumber
+        super.init()
+    }
+
+    init?(commandInterface: mglCommandInterface) {
+        guard let afterFrameNumber = commandInterface.readDouble() else {
+            return nil
+        }
+        self.afterFrameNumber = UInt64(max(0, afterFrameNumber))
+        super.init()
+    }
+
+    override func doNondrawingWork(
+        logger: mglLogger,
+        view: MTKView,
+        depthStencilState: mglDepthStencilState,
+        colorRenderingState: mglColorRenderingState,
+        renderer: mglRenderer2,
+        deg2metal: inout simd_float4x4,
+        targetPresentationTimestamp: CFTimeInterval?
+    ) -> Bool {
+        (records, frameCount) = renderer.getFrameTelemetry(after: afterFrameNumber)
+        return true
+    }
+
+    override func writeQueryResults(
+        logger: mglLogger,
+        commandInterface : mglCommandInterface
+    ) -> Bool {
+        // How many frames there have been in all, then the records in one array, one field after another.
+        var blob = Array(repeating: 0.0, count: records.count * mglFrameTelemetryRecord.fieldCount)
+        for (recordIndex, record) in records.enumerated() {
+            for (fieldIndex, value) in record.fields.enumerated() {
+                blob[fieldIndex * records.count + recordIndex] = value
+            }
+        }
+        _ = commandInterface.writeDouble(data: Double(frameCount))
+        _ = commandInterface.writeDoubleArray(data: blob)
+        return true
+    }
+}
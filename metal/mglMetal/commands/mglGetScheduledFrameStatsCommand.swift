@@ -0,0 +1,57 @@
+//
+//  mglGetScheduledFrameStatsCommand.swift
+//  mglMetal
+//
+//  Created by justin gardner on 10/19/26.
+//  Copyright © 2026 GRU. All rights reserved.
+//
+
+import Foundation
+import MetalKit
+
+//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++
+// command to get records of scheduled frames that were due since
+// the last time, with their target, tick and presented times,
+// how many refreshes late they were, and whether they were missed
+//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++
+class mglGetScheduledFrameStatsCommand : mglCommand {
+    private var records: [mglScheduledFrameRecord] = []
+    private var pendingCount: Int = 0
+
+    init() {
+        super.init()
+    }
+
+    init?(commandInterface: mglCommandInterface) {
+        super.init()
+    }
+
+    override func doNondrawingWork(
+        logger: mglLogger,
+        view: MTKView,
+        depthStencilState: mglDepthStencilState,
+        colorRenderingState: mglColorRenderingState,
+        renderer: mglRenderer2,
+        deg2metal: inout simd_float4x4,
+        targetPresentationTimestamp: CFTimeInterval?
+    ) -> Bool {
+        (records, pendingCount) = renderer.takeScheduledFrameRecords()
+        return true
+    }
+
+    override func writeQueryResults(
+        logger: mglLogger,
+        commandInterface : mglCommandInterface
+    ) -> Bool {
+        // How many frames are still waiting, how many records, then all of each field in turn.
+        _ = commandInterface.writeUInt32(data: mglUInt32(pendingCount))
+        _ = commandInterface.writeUInt32(data: mglUInt32(records.count))
+        records.forEach { _ = commandInterface.writeDouble(data: Double($0.frameNumber)) }
+        records.forEach { _ = commandInterface.writeDouble(data: $0.targetTime) }
+        records.forEach { _ = commandInterface.writeDouble(data: $0.tickTime) }
+        records.forEach { _ = commandInterface.writeDouble(data: $0.presentedTime) }
+        records.forEach { _ = commandInterface.writeDouble(data: Double($0.framesLate)) }
+        records.forEach { _ = commandInterface.writeDouble(data: Double($0.missed)) }
+        return true
+    }
+}
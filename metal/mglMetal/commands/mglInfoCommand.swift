@@ -29,6 +29,9 @@ class mglInfoCommand : mglCommand {
     // info about displays
     var currentDisplayIndex: Int = -1
     var displays: [mglDisplayInfo] = []
+
+    // texture memory budget and residency counts
+    var textureBudget = mglTextureBudget()
     
     override func doNondrawingWork(
         logger: mglLogger,
@@ -46,6 +49,7 @@ class mglInfoCommand : mglCommand {
         }
         self.device = device
         self.view = view
+        textureBudget = colorRenderingState.getTextureBudget()
         
         // reinitialize variables
         currentDisplayIndex = -1
@@ -195,6 +199,24 @@ class mglInfoCommand : mglCommand {
         let drawableSize: [Double] = [Double(view.drawableSize.width), Double(view.drawableSize.height)]
         _ = commandInterface.writeDoubleArray(data: drawableSize)
 
+        // send texture budget and residency counts (see mglTextureBudget.h)
+        let textureCounts: [(String, Double)] = [
+            ("texture.budgetBytes", Double(textureBudget.budgetBytes)),
+            ("texture.residentCount", Double(textureBudget.residentCount)),
+            ("texture.residentBytes", Double(textureBudget.residentBytes)),
+            ("texture.spilledCount", Double(textureBudget.spilledCount)),
+            ("texture.spilledBytes", Double(textureBudget.spilledBytes)),
+            ("texture.compressedBytes", Double(textureBudget.compressedBytes)),
+            ("texture.spillCount", Double(textureBudget.spillCount)),
+            ("texture.restoreCount", Double(textureBudget.restoreCount))
+        ]
+        for (name, value) in textureCounts {
+            _ = commandInterface.writeCommand(data: mglSendString)
+            _ = commandInterface.writeString(data: name)
+            _ = commandInterface.writeCommand(data: mglSendDouble)
+            _ = commandInterface.writeDouble(data: value)
+        }
+
         // send number of displays
         _ = commandInterface.writeCommand(data: mglSendString)
         _ = commandInterface.writeString(data: "display.numDisplays")
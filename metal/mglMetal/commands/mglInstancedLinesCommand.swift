@@ -0,0 +1,53 @@
+//
+//  mglInstancedLinesCommand.swift
+//  mglMetal
+//
+//  Created by justin gardner on 10/19/26.
+//  Copyright © 2026 GRU. All rights reserved.
+//
+
+import Foundation
+import MetalKit
+
+// Lines or rotated rectangles, with one record per line: [x0 y0 x1 y1 width rgba].
+// Each record is drawn as an instance of a quad, which the shader expands from the record (see mglInstancedLines.h).
+class mglInstancedLinesCommand : mglCommand {
+    private let lineBuffer: MTLBuffer
+    private let lineCount: Int
+
+    init(lineBuffer: MTLBuffer, lineCount: Int) {
+        self.lineBuffer = lineBuffer
+        self.lineCount = lineCount
+        super.init(framesRemaining: 1)
+    }
+
+    init?(commandInterface: mglCommandInterface, device: MTLDevice) {
+        // Read and buffer line records, which are the same size as vertices with 9 values: [x0 y0 x1 y1 width rgba]
+        guard let (lineBuffer, lineCount) = commandInterface.readVertices(device: device, extraVals: 6) else {
+            return nil
+        }
+        self.lineBuffer = lineBuffer
+        self.lineCount = lineCount
+        super.init(framesRemaining: 1)
+    }
+
+    override func draw(
+        logger: mglLogger,
+        view: MTKView,
+        depthStencilState: mglDepthStencilState,
+        colorRenderingState: mglColorRenderingState,
+        deg2metal: inout simd_float4x4,
+        targetPresentationTimestamp: CFTimeInterval?,
+        renderEncoder: MTLRenderCommandEncoder
+    ) -> Bool {
+        if lineCount == 0 {
+            return true
+        }
+
+        // Render each line as an instance of two triangles.
+        renderEncoder.setRenderPipelineState(colorRenderingState.getInstancedLinesPipelineState())
+        renderEncoder.setVertexBuffer(lineBuffer, offset: 0, index: 0)
+        renderEncoder.drawPrimitives(type: .triangle, vertexStart: 0, vertexCount: 6, instanceCount: lineCount)
+        return true
+    }
+}
@@ -0,0 +1,54 @@
+//
+//  mglProceduralGratingsCommand.swift
+//  mglMetal
+//
+//  Created by justin gardner on 10/19/26.
+//  Copyright © 2026 GRU. All rights reserved.
+//
+
+import Foundation
+import MetalKit
+
+// Gratings and gabors, with one record per grating: [x y width height sf angle phase contrast sdx sdy alphaMask].
+// Each record is drawn as an instance of a quad, and the fragment shader computes the grating at each pixel,
+// so changing contrast or phase from frame to frame only means sending a new record (see mglProceduralGratings.h).
+class mglProceduralGratingsCommand : mglCommand {
+    private let gratingBuffer: MTLBuffer
+    private let gratingCount: Int
+
+    init(gratingBuffer: MTLBuffer, gratingCount: Int) {
+        self.gratingBuffer = gratingBuffer
+        self.gratingCount = gratingCount
+        super.init(framesRemaining: 1)
+    }
+
+    init?(commandInterface: mglCommandInterface, device: MTLDevice) {
+        // Read and buffer grating records, which are the same size as vertices with 11 values.
+        guard let (gratingBuffer, gratingCount) = commandInterface.readVertices(device: device, extraVals: 8) else {
+            return nil
+        }
+        self.gratingBuffer = gratingBuffer
+        self.gratingCount = gratingCount
+        super.init(framesRemaining: 1)
+    }
+
+    override func draw(
+        logger: mglLogger,
+        view: MTKView,
+        depthStencilState: mglDepthStencilState,
+        colorRenderingState: mglColorRenderingState,
+        deg2metal: inout simd_float4x4,
+        targetPresentationTimestamp: CFTimeInterval?,
+        renderEncoder: MTLRenderCommandEncoder
+    ) -> Bool {
+        if gratingCount == 0 {
+            return true
+        }
+
+        // Render each grating as an instance of two triangles.
+        renderEncoder.setRenderPipelineState(colorRenderingState.getProceduralGratingsPipelineState())
+        renderEncoder.setVertexBuffer(gratingBuffer, offset: 0, index: 0)
+        renderEncoder.drawPrimitives(type: .triangle, vertexStart: 0, vertexCount: 6, instanceCount: gratingCount)
+        return true
+    }
+}
@@ -0,0 +1,177 @@
+//
+//  mglReadbackCommand.swift
+//  mglMetal
+//
+//  Created by justin gardner on 10/19/26.
+//  Copyright © 2026 GRU. All rights reserved.
+//
+
+import Foundation
+import MetalKit
+
+//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++
+// command to start reading back a region of the render target
+// (textureNumber 0) or a texture, after the frames drawn so far,
+// without waiting for it (see mglReadbackRing)
+//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++
+class mglReadbackIssueCommand : mglCommand {
+    private let textureNumber: UInt32
+    private let x: UInt32
+    private let y: UInt32
+    private let width: UInt32
+    private let height: UInt32
+    private let format: UInt32
+    private(set) var ticket = UInt32(0)
+    private var regionWidth = UInt32(0)
+    private var regionHeight = UInt32(0)
+    private var issuedInFrame = UInt64(0)
+
+    init(textureNumber: UInt32, x: UInt32, y: UInt32, width: UInt32, height: UInt32, format: UInt32) {
+        self.textureNumber = textureNumber
+        self.x = x
+        self.y = y
+        self.width = width
+        self.height = height
+        self.format = format
+        super.init()
+    }
+
+    init?(commandInterface: mglCommandInterface) {
+        guard let textureNumber = commandInterface.readUInt32(),
+              let x = commandInterface.readUInt32(),
+              let y = commandInterface.readUInt32(),
+              let width = commandInterface.readUInt32(),
+              let height = commandInterface.readUInt32(),
+              let format = commandInterface.readUInt32() else {
+            return nil
+        }
+        self.textureNumber = textureNumber
+        self.x = x
+        self.y = y
+        self.width = width
+        self.height = height
+        self.format = format
+        super.init()
+    }
+
+    override func doNondrawingWork(
+        logger: mglLogger,
+        view: MTKView,
+        depthStencilState: mglDepthStencilState,
+        colorRenderingState: mglColorRenderingState,
+        renderer: mglRenderer2,
+        deg2metal: inout simd_float4x4,
+        targetPresentationTimestamp: CFTimeInterval?
+    ) -> Bool {
+        // Like mglFrameGrab, what is drawn to the screen can't be read back, only an offscreen render target.
+        let texture = textureNumber == 0
+            ? colorRenderingState.getRenderTargetTexture()
+            : colorRenderingState.getTexture(textureNumber: textureNumber)
+        guard let texture = texture else {
+            if textureNumber == 0 {
+                logger.error(component: "mglReadbackIssueCommand", details: "Cannot read back the screen, set an offscreen render target with mglMetalSetRenderTarget or mglFrameGrab('init').")
+            }
+            return false
+        }
+        issuedInFrame = colorRenderingState.getFrameCount()
+        guard let (ticket, regionWidth, regionHeight) = colorRenderingState.getReadbackRing().issue(
+            texture: texture,
+            x: x,
+            y: y,
+            width: width,
+            height: height,
+            format: format,
+            currentFrame: issuedInFrame,
+            renderer: renderer,
+            logger: logger
+        ) else {
+            return false
+        }
+        self.ticket = ticket
+        self.regionWidth = regionWidth
+        self.regionHeight = regionHeight
+        return true
+    }
+
+    // Return status, then the ticket to collect, the width and height of the region and the frame count it was issued in.
+    override func writeQueryResults(
+        logger: mglLogger,
+        commandInterface : mglCommandInterface
+    ) -> Bool {
+        if ticket == 0 {
+            _ = commandInterface.writeDouble(data: -1.0)
+            return true
+        }
+        _ = commandInterface.writeDouble(data: 1.0)
+        _ = commandInterface.writeUInt32(data: ticket)
+        _ = commandInterface.writeUInt32(data: regionWidth)
+        _ = commandInterface.writeUInt32(data: regionHeight)
+        _ = commandInterface.writeDouble(data: Double(issuedInFrame))
+        return true
+    }
+}
+
+//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++
+// command to collect a readback started with mglReadbackIssue,
+// waiting for it only if the GPU has not copied it yet, and
+// return it as a height x width x 4 image of single or uint8
+//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++
+class mglReadbackCollectCommand : mglCommand {
+    private let ticket: UInt32
+    private(set) var width = UInt32(0)
+    private(set) var height = UInt32(0)
+    private(set) var format = UInt32(0)
+    private(set) var waitedSecs = 0.0
+    private(set) var image: [UInt8]? = nil
+
+    init(ticket: UInt32) {
+        self.ticket = ticket
+        super.init()
+    }
+
+    init?(commandInterface: mglCommandInterface) {
+        guard let ticket = commandInterface.readUInt32() else {
+            return nil
+        }
+        self.ticket = ticket
+        super.init()
+    }
+
+    override func doNondrawingWork(
+        logger: mglLogger,
+        view: MTKView,
+        depthStencilState: mglDepthStencilState,
+        colorRenderingState: mglColorRenderingState,
+        renderer: mglRenderer2,
+        deg2metal: inout simd_float4x4,
+        targetPresentationTimestamp: CFTimeInterval?
+    ) -> Bool {
+        guard let readback = colorRenderingState.getReadbackRing().collect(ticket: ticket, logger: logger) else {
+            return false
+        }
+        width = readback.width
+        height = readback.height
+        format = readback.format
+        waitedSecs = readback.waitedSecs
+        image = readback.image
+        return true
+    }
+
+    // Return status, then width, height and format, and the bytes of the image with their count first.
+    override func writeQueryResults(
+        logger: mglLogger,
+        commandInterface : mglCommandInterface
+    ) -> Bool {
+        guard let image = image else {
+            _ = commandInterface.writeDouble(data: -1.0)
+            return true
+        }
+        _ = commandInterface.writeDouble(data: 1.0)
+        _ = commandInterface.writeUInt32(data: width)
+        _ = commandInterface.writeUInt32(data: height)
+        _ = commandInterface.writeUInt32(data: format)
+        _ = commandInterface.writeDouble(data: waitedSecs)
+        _ = commandInterface.writeUInt8Array(data: image)
+        return true
+    }
+}
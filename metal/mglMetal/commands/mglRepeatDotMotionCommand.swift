@@ -0,0 +1,140 @@
+//
+//  mglRepeatDotMotionCommand.swift
+//  mglMetal
+//
+//  Created by justin gardner on 10/19/26.
+//  Copyright © 2026 GRU. All rights reserved.
+//
+
+import Foundation
+import MetalKit
+
+// Moving dots that are advanced here each frame from a few motion parameters,
+// instead of the client computing and sending every dot every frame.
+// The motion itself is in mglDotMotion.h, which follows dotMotionFrame.m.
+class mglRepeatDotMotionCommand : mglCommand {
+    private let repeatCount: UInt32
+    private let objectCount: UInt32
+    private let randomSeed: UInt32
+    private var params = mglDotMotionParams()
+    private var state = mglDotMotionState()
+
+    private var secs = mglSecs()
+    private var drawTime: Double = 0.0
+
+    init?(repeatCount: UInt32, objectCount: UInt32, randomSeed: UInt32, params: mglDotMotionParams) {
+        self.repeatCount = repeatCount
+        self.objectCount = objectCount
+        self.randomSeed = randomSeed
+        self.params = params
+        super.init(framesRemaining: Int(repeatCount))
+        if mglDotMotionCreate(&state, objectCount, randomSeed) == 0 {
+            return nil
+        }
+    }
+
+    init?(commandInterface: mglCommandInterface) {
+        // Read counts, seed and motion types.
+        guard let repeatCount = commandInterface.readUInt32(),
+              let objectCount = commandInterface.readUInt32(),
+              let randomSeed = commandInterface.readUInt32(),
+              let coherentMotionType = commandInterface.readUInt32(),
+              let incoherentMotionType = commandInterface.readUInt32(),
+              let nDirections = commandInterface.readUInt32() else {
+            return nil
+        }
+        if Int(nDirections) > Int(MGL_DOT_MOTION_MAX_DIRECTIONS) {
+            return nil
+        }
+
+        // Read the directions followed by the other motion parameters, as doubles so that the dots move as dotMotionFrame moves them:
+        // [coherence speed lifetime originX originY frameRate deviceRect(4)]
+        var motion = [Double]()
+        for _ in 0 ..< Int(nDirections) + 10 {
+            guard let value = commandInterface.readDouble() else {
+                return nil
+            }
+            motion.append(value)
+        }
+
+        // Then how the dots look, as floats: [rgba wh isRound borderSize]
+        guard let looks = commandInterface.readFloatArray(count: 8) else {
+            return nil
+        }
+
+        self.repeatCount = repeatCount
+        self.objectCount = objectCount
+        self.randomSeed = randomSeed
+        params.coherentMotionType = coherentMotionType
+        params.incoherentMotionType = incoherentMotionType
+        params.nDirections = nDirections
+        withUnsafeMutableBytes(of: &params.direction) { buffer in
+            let directions = buffer.bindMemory(to: Double.self)
+            for index in 0 ..< Int(nDirections) {
+                directions[index] = motion[index]
+            }
+        }
+        let offset = Int(nDirections)
+        params.coherence = motion[offset + 0]
+        params.speed = motion[offset + 1]
+        params.lifetime = motion[offset + 2]
+        params.origin = (motion[offset + 3], motion[offset + 4])
+        params.frameRate = motion[offset + 5]
+        params.deviceRect = (motion[offset + 6], motion[offset + 7], motion[offset + 8], motion[offset + 9])
+        params.color = (looks[0], looks[1], looks[2], looks[3])
+        params.dotSize = (looks[4], looks[5])
+        params.isRound = looks[6]
+        params.borderSize = looks[7]
+
+        super.init(framesRemaining: Int(repeatCount))
+        if mglDotMotionCreate(&state, objectCount, randomSeed) == 0 {
+            return nil
+        }
+    }
+
+    deinit {
+        mglDotMotionDestroy(&state)
+    }
+
+    override func draw(
+        logger: mglLogger,
+        view: MTKView,
+        depthStencilState: mglDepthStencilState,
+        colorRenderingState: mglColorRenderingState,
+        deg2metal: inout simd_float4x4,
+        targetPresentationTimestamp: CFTimeInterval?,
+        renderEncoder: MTLRenderCommandEncoder
+    ) -> Bool {
+        // Move the dots by one frame.
+        mglDotMotionFrame(&state, &params)
+
+        // Pack a vertex buffer with dots: each has 1 vertex and 11 values per vertex vertex: [xyz rgba wh isRound borderSize].
+        let vertexCount = Int(objectCount)
+        let byteCount = Int(mglSizeOfFloatVertexArray(mglUInt32(vertexCount), mglUInt32(MGL_DOT_MOTION_VALUES_PER_DOT)))
+        guard let vertexBuffer = view.device?.makeBuffer(length: byteCount, options: .storageModeManaged) else {
+            logger.error(component: "mglRepeatDotMotionCommand", details: "Could not make vertex buffer of size \(byteCount)")
+            return false
+        }
+        let bufferFloats = vertexBuffer.contents().bindMemory(to: Float32.self, capacity: vertexCount * Int(MGL_DOT_MOTION_VALUES_PER_DOT))
+        mglDotMotionPackVertices(&state, &params, bufferFloats)
+
+        // Draw all the vertices as points.
+        renderEncoder.setRenderPipelineState(colorRenderingState.getDotsPipelineState())
+        renderEncoder.setVertexBuffer(vertexBuffer, offset: 0, index: 0)
+        renderEncoder.drawPrimitives(type: .point, vertexStart: 0, vertexCount: vertexCount)
+
+        // Record draw time to send back to the client.
+        drawTime = secs.get()
+
+        return true
+    }
+
+    override func writeQueryResults(
+        logger: mglLogger,
+        commandInterface : mglCommandInterface
+    ) -> Bool {
+        // Report to the client when drawing commands were finished.
+        _ = commandInterface.writeDouble(data: drawTime)
+        return true
+    }
+}
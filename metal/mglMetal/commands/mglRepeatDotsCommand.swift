@@ -8,13 +8,16 @@
 
 import Foundation
 import MetalKit
-import GameplayKit
 
 class mglRepeatDotsCommand : mglCommand {
+    // Dots are made in chunks of this many, which are spread across threads.
+    // The dots come out the same for a given seed no matter how they are chunked (see mglRandomDots.h).
+    static let dotsPerChunk = 8192
+
     private let repeatCount: UInt32
     private let objectCount: UInt32
     private let randomSeed: UInt32
-    private let randomSource: GKMersenneTwisterRandomSource
+    private var frameIndex: UInt32 = 0
 
     private var secs = mglSecs()
     private var drawTime: Double = 0.0
@@ -23,7 +26,6 @@ class mglRepeatDotsCommand : mglCommand {
         self.repeatCount = repeatCount
         self.objectCount = objectCount
         self.randomSeed = randomSeed
-        self.randomSource = GKMersenneTwisterRandomSource(seed: UInt64(randomSeed))
         super.init(framesRemaining: Int(repeatCount))
     }
 
@@ -36,7 +38,6 @@ class mglRepeatDotsCommand : mglCommand {
         self.repeatCount = repeatCount
         self.objectCount = objectCount
         self.randomSeed = randomSeed
-        self.randomSource = GKMersenneTwisterRandomSource(seed: UInt64(randomSeed))
         super.init(framesRemaining: Int(repeatCount))
     }
 
@@ -51,16 +52,21 @@ class mglRepeatDotsCommand : mglCommand {
     ) -> Bool {
         // Pack a vertex buffer with dots: each has 1 vertex and 11 values per vertex vertex: [xyz rgba wh isRound borderSize].
         let vertexCount = Int(objectCount)
-        let byteCount = Int(mglSizeOfFloatVertexArray(mglUInt32(vertexCount), 11))
+        let byteCount = Int(mglSizeOfFloatVertexArray(mglUInt32(vertexCount), mglUInt32(MGL_RANDOM_DOTS_VALUES_PER_DOT)))
         guard let vertexBuffer = view.device?.makeBuffer(length: byteCount, options: .storageModeManaged) else {
             logger.error(component: "mglRepeatDotsCommand", details: "Could not make vertex buffer of size \(byteCount)")
             return false
         }
-        let bufferFloats = vertexBuffer.contents().bindMemory(to: Float32.self, capacity: vertexCount)
-        for dotIndex in (0 ..< vertexCount) {
-            let offset = Int(11 * dotIndex)
-            packRandomDot(buffer: bufferFloats, offset: offset)
+        let bufferFloats = vertexBuffer.contents().bindMemory(to: Float32.self, capacity: vertexCount * Int(MGL_RANDOM_DOTS_VALUES_PER_DOT))
+        let chunkCount = (vertexCount + mglRepeatDotsCommand.dotsPerChunk - 1) / mglRepeatDotsCommand.dotsPerChunk
+        let seed = randomSeed
+        let frame = frameIndex
+        DispatchQueue.concurrentPerform(iterations: chunkCount) { chunk in
+            let firstDot = chunk * mglRepeatDotsCommand.dotsPerChunk
+            let chunkDots = min(mglRepeatDotsCommand.dotsPerChunk, vertexCount - firstDot)
+            mglRandomDotsPack(seed, frame, UInt32(firstDot), UInt32(chunkDots), bufferFloats + Int(MGL_RANDOM_DOTS_VALUES_PER_DOT) * firstDot)
         }
+        frameIndex += 1
 
         // Draw all the vertices as points with 11 values per vertex: [xyz rgba wh isRound borderSize].
         renderEncoder.setRenderPipelineState(colorRenderingState.getDotsPipelineState())
@@ -73,30 +79,6 @@ class mglRepeatDotsCommand : mglCommand {
         return true
     }
 
-    // Create a random dot as the next vertex, with 11 elements per vertex, of the given vertex buffer.
-    private func packRandomDot(buffer: UnsafeMutablePointer<Float32>, offset: Int) {
-        // xyz
-        buffer[offset + 0] = Float32(randomSource.nextUniform() * 2 - 1)
-        buffer[offset + 1] = Float32(randomSource.nextUniform() * 2 - 1)
-        buffer[offset + 2] = 0
-
-        // rgba
-        buffer[offset + 3] = Float32(randomSource.nextUniform())
-        buffer[offset + 4] = Float32(randomSource.nextUniform())
-        buffer[offset + 5] = Float32(randomSource.nextUniform())
-        buffer[offset + 6] = 1
-        
-        // wh
-        buffer[offset + 7] = 1
-        buffer[offset + 8] = 1
-
-        // round
-        buffer[offset + 9] = 0
-
-        // border size
-        buffer[offset + 10] = 0
-    }
-
     override func writeQueryResults(
         logger: mglLogger,
         commandInterface : mglCommandInterface
@@ -0,0 +1,58 @@
+//
+//  mglScheduleFrameCommand.swift
+//  mglMetal
+//
+//  Created by justin gardner on 10/19/26.
+//  Copyright © 2026 GRU. All rights reserved.
+//
+
+import Foundation
+import MetalKit
+
+//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++
+// command to render the next frame ahead of time, into a pooled
+// texture, and present it on the display tick that matches a
+// target time (in the same seconds as mglGetSecs)
+//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++
+class mglScheduleFrameCommand : mglCommand {
+    private let targetTime: Double
+    private var frameNumber: UInt32 = 0
+
+    init(targetTime: Double) {
+        self.targetTime = targetTime
+        super.init()
+    }
+
+    init?(commandInterface: mglCommandInterface) {
+        guard let targetTime = commandInterface.readDouble() else {
+            return nil
+        }
+        self.targetTime = targetTime
+        super.init()
+    }
+
+    override func doNondrawingWork(
+        logger: mglLogger,
+        view: MTKView,
+        depthStencilState: mglDepthStencilState,
+        colorRenderingState: mglColorRenderingState,
+        renderer: mglRenderer2,
+        deg2metal: inout simd_float4x4,
+        targetPresentationTimestamp: CFTimeInterval?
+    ) -> Bool {
+        guard let frameNumber = renderer.scheduleFrame(view: view, targetTime: targetTime) else {
+            return false
+        }
+        self.frameNumber = frameNumber
+        return true
+    }
+
+    override func writeQueryResults(
+        logger: mglLogger,
+        commandInterface : mglCommandInterface
+    ) -> Bool {
+        // Report the number of the frame, to find it in the records from mglGetScheduledFrameStats.
+        _ = commandInterface.writeUInt32(data: frameNumber)
+        return true
+    }
+}
@@ -25,6 +25,13 @@ class mglSetClearColorCommand : mglCommand {
         super.init(framesRemaining: 1)
     }
 
+    override func substituting(parameter: mglDisplayListParameter) -> mglCommand? {
+        guard case let .color(color) = parameter else {
+            return nil
+        }
+        return mglSetClearColorCommand(red: Double(color[0]), green: Double(color[1]), blue: Double(color[2]))
+    }
+
     override func doNondrawingWork(
         logger: mglLogger,
         view: MTKView,
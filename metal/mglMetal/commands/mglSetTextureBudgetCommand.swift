@@ -0,0 +1,46 @@
+//
+//  mglSetTextureBudgetCommand.swift
+//  mglMetal
+//
+//  Created by justin gardner on 10/19/26.
+//  Copyright © 2026 GRU. All rights reserved.
+//
+
+import Foundation
+import MetalKit
+
+//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++
+// command to set how many bytes of textures to keep in GPU
+// memory, spilling the least recently used ones to compressed
+// host memory beyond that (see mglTextureBudget.h), 0 for no limit
+//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++
+class mglSetTextureBudgetCommand : mglCommand {
+    private let budgetBytes: UInt64
+
+    init(budgetBytes: UInt64) {
+        self.budgetBytes = budgetBytes
+        super.init()
+    }
+
+    init?(commandInterface: mglCommandInterface) {
+        guard let budgetBytes = commandInterface.readDouble(),
+              budgetBytes >= 0 else {
+            return nil
+        }
+        self.budgetBytes = UInt64(budgetBytes)
+        super.init()
+    }
+
+    override func doNondrawingWork(
+        logger: mglLogger,
+        view: MTKView,
+        depthStencilState: mglDepthStencilState,
+        colorRenderingState: mglColorRenderingState,
+        renderer: mglRenderer2,
+        deg2metal: inout simd_float4x4,
+        targetPresentationTimestamp: CFTimeInterval?
+    ) -> Bool {
+        colorRenderingState.setTextureBudget(byteCount: budgetBytes)
+        return true
+    }
+}
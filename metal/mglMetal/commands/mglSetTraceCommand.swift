@@ -0,0 +1,51 @@
+//
+//  mglSetTraceCommand.swift
+//  mglMetal
+//
+//  Created by justin gardner on 10/19/26.
+//  Copyright © 2026 GRU. All rights reserved.
+//
+
+import Foundation
+import MetalKit
+
+//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++
+// command to start tracing the render loop to a binary file
+// (see mglTrace.h), or to stop tracing if given an empty path
+//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++//++
+class mglSetTraceCommand : mglCommand {
+    private let path: String
+
+    init(path: String) {
+        self.path = path
+        super.init()
+    }
+
+    init?(commandInterface: mglCommandInterface) {
+        self.path = commandInterface.readString()
+        super.init()
+    }
+
+    override func doNondrawingWork(
+        logger: mglLogger,
+        view: MTKView,
+        depthStencilState: mglDepthStencilState,
+        colorRenderingState: mglColorRenderingState,
+        renderer: mglRenderer2,
+        deg2metal: inout simd_float4x4,
+        targetPresentationTimestamp: CFTimeInterval?
+    ) -> Bool {
+        if path.isEmpty {
+            mglTraceStop()
+            logger.info(component: "mglSetTraceCommand", details: "Stopped tracing.")
+            return true
+        }
+
+        if mglTraceStart(path) == 0 {
+            logger.error(component: "mglSetTraceCommand", details: "Could not start tracing to \(path)")
+            return false
+        }
+        logger.info(component: "mglSetTraceCommand", details: "Tracing to \(path)")
+        return true
+    }
+}
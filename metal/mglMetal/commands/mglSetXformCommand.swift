@@ -25,6 +25,13 @@ class mglSetXformCommand : mglCommand {
         super.init(framesRemaining: 1)
     }
 
+    override func substituting(parameter: mglDisplayListParameter) -> mglCommand? {
+        guard case let .xform(xform) = parameter else {
+            return nil
+        }
+        return mglSetXformCommand(deg2metal: xform)
+    }
+
     override func draw(
         logger: mglLogger,
         view: MTKView,
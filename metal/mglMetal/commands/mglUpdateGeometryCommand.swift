@@ -0,0 +1,67 @@
+//
+//  mglUpdateGeometryCommand.swift
+//  mglMetal
+//
+//  Created by justin gardner on 10/19/26.
+//  Copyright © 2026 GRU. All rights reserved.
+//
+
+import Foundation
+import MetalKit
+
+// Patch a range of values of existing geometry, in place, so that only the values that change need to be sent.
+class mglUpdateGeometryCommand : mglCommand {
+    private let geometryNumber: UInt32
+    private let firstValue: UInt32
+    private let values: [Float]
+
+    init(geometryNumber: UInt32, firstValue: UInt32, values: [Float]) {
+        self.geometryNumber = geometryNumber
+        self.firstValue = firstValue
+        self.values = values
+        super.init()
+    }
+
+    init?(commandInterface: mglCommandInterface) {
+        guard let geometryNumber = commandInterface.readUInt32(),
+              let firstValue = commandInterface.readUInt32(),
+              let valueCount = commandInterface.readUInt32(),
+              let values = commandInterface.readFloatArray(count: Int(valueCount)) else {
+            return nil
+        }
+        self.geometryNumber = geometryNumber
+        self.firstValue = firstValue
+        self.values = values
+        super.init()
+    }
+
+    override func doNondrawingWork(
+        logger: mglLogger,
+        view: MTKView,
+        depthStencilState: mglDepthStencilState,
+        colorRenderingState: mglColorRenderingState,
+        renderer: mglRenderer2,
+        deg2metal: inout simd_float4x4,
+        targetPresentationTimestamp: CFTimeInterval?
+    ) -> Bool {
+        guard let geometry = colorRenderingState.getGeometry(geometryNumber: geometryNumber),
+              let device = view.device else {
+            return false
+        }
+        if values.isEmpty {
+            return true
+        }
+        let success = values.withUnsafeBytes { buffer in
+            return geometry.update(
+                device: device,
+                currentFrame: colorRenderingState.getFrameCount(),
+                firstValue: Int(firstValue),
+                values: buffer.baseAddress!,
+                valueCount: values.count)
+        }
+        if !success {
+            logger.error(component: "mglUpdateGeometryCommand", details: "Could not update \(values.count) values starting at \(firstValue) of geometry number \(geometryNumber), which has \(geometry.valueCount) values")
+        }
+        return success
+    }
+}
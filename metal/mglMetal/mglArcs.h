@@ -0,0 +1,57 @@
+//
+//  mglArcs.h
+//  mglMetal
+//
+//  Created by justin gardner on 10/19/26.
+//  Copyright © 2026 GRU. All rights reserved.
+//
+
+#ifndef mglArcs_h
+#define mglArcs_h
+
+#include <stdint.h>
+#include <string.h>
+
+// Arcs are drawn as instances, with one record per arc as mglMetalArcs sends it:
+// [xyz rgba radii(4) wedge(2) border]. The vertex_arcs shader reads the record for
+// its instance and makes the corners of a square around the arc, and gets the
+// viewport size from a uniform, so nothing needs to be copied per vertex.
+// Before, mglArcsCommand copied each record into 6 vertices of
+// [xyz rgba radii wedge border centerPosition viewportSize]. mglArcsExpand below
+// makes those same vertices from the records, the way the shader does, so that
+// a mex function (mglPrivateExpandArcs) can check the packing without a GPU.
+
+#define MGL_ARC_VALUES 14
+#define MGL_ARC_VERTICES 6
+#define MGL_ARC_VERTEX_VALUES 19
+
+// Which side of the square around the arc each of the 6 vertices is on.
+// These need to match arcCornerX and arcCornerY in mglShaders.metal.
+static const float mglArcCornerX[MGL_ARC_VERTICES] = {-1, -1, 1, -1, 1, 1};
+static const float mglArcCornerY[MGL_ARC_VERTICES] = {-1, 1, 1, -1, -1, 1};
+
+// Expand nArcs records into 6 vertices each, with 19 values per vertex.
+static inline void mglArcsExpand(const float *records, uint32_t nArcs, float viewportWidth, float viewportHeight, float *vertices) {
+    for (uint32_t arcIndex = 0; arcIndex < nArcs; arcIndex++) {
+        const float *record = records + MGL_ARC_VALUES * arcIndex;
+        // radius is the outer radius + half the border
+        const float rX = record[8] + record[13] / 2;
+        const float rY = record[10] + record[13] / 2;
+        for (uint32_t vertexIndex = 0; vertexIndex < MGL_ARC_VERTICES; vertexIndex++) {
+            float *vertex = vertices + MGL_ARC_VERTEX_VALUES * (MGL_ARC_VERTICES * arcIndex + vertexIndex);
+            memcpy(vertex, record, MGL_ARC_VALUES * sizeof(float));
+            // corner of the square
+            vertex[0] = record[0] + mglArcCornerX[vertexIndex] * rX;
+            vertex[1] = record[1] + mglArcCornerY[vertexIndex] * rY;
+            // center of the arc, with y flipped
+            vertex[14] = record[0];
+            vertex[15] = -record[1];
+            vertex[16] = record[2];
+            // viewport
+            vertex[17] = viewportWidth;
+            vertex[18] = viewportHeight;
+        }
+    }
+}
+
+#endif /* mglArcs_h */
@@ -9,6 +9,17 @@
 import Foundation
 import MetalKit
 
+// What it takes to remake a texture that was spilled out of GPU memory to stay within the texture budget.
+struct mglSpilledTexture {
+    let width: Int
+    let height: Int
+    let pixelFormat: MTLPixelFormat
+    let usage: MTLTextureUsage
+    let bytesPerRow: Int
+    let bufferLength: Int
+    let compressed: Data
+}
+
 /*
  mglColorRenderingState keeps track the current color rendering state for the app, including:
  - whether we're rendering to screen or to an offscreen texture
@@ -36,14 +47,46 @@ class mglColorRenderingState {
     // A collection of user-managed textures to render to and/or blt to screen.
     private var textureSequence = UInt32(1)
     private var textures : [UInt32: MTLTexture] = [:]
+
+    // With a texture memory budget set, the least recently used textures are spilled out of GPU memory,
+    // compressed, and restored when they are next used (see mglTextureBudget.h).
+    private let device: MTLDevice
+    private var textureBudget = mglTextureBudget()
+    private var spilledTextures : [UInt32: mglSpilledTexture] = [:]
     
     // A collection of user-managed movies (stored as AVPlayerItems) that
     // can be rendered to the screen
     private var movieSequence = UInt32(1)
     private var movies : [UInt32: mglMovie] = [:]
     
+    // A collection of user-managed frame streams (files of precomputed
+    // frames) that can be shown on the screen one frame at a time
+    private var frameStreamSequence = UInt32(1)
+    private var frameStreams : [UInt32: mglFrameStreamTextures] = [:]
+    
+    // Readbacks of rendered images, issued after a frame and collected later
+    // so that reading them back does not hold up the render loop
+    private let readbackRing = mglReadbackRing(slotCount: 4)
+    
+    // A collection of user-managed geometry (vertex buffers) that stay
+    // on the server and can be drawn by number
+    private var geometrySequence = UInt32(1)
+    private var geometries : [UInt32: mglGeometry] = [:]
+    
+    // How many frames have finished drawing, so that geometry can tell
+    // whether it was drawn in the frame that is being put together now.
+    private var frameCount = UInt64(0)
+    
+    // A small pool of offscreen configs for frames that are rendered ahead of time
+    // and presented later (see mglPresentationQueue), and which of them are waiting to be presented.
+    private let scheduledFramePoolSize = 8
+    private var scheduledFrameConfigs: [mglOffScreenTextureRenderingConfig] = []
+    private var scheduledFramesInUse = Set<Int>()
+    private var configBeforeScheduledFrame: mglColorRenderingConfig? = nil
+    
     init(logger: mglLogger, device: MTLDevice, view: MTKView) {
         self.logger = logger
+        self.device = device
         
         guard let library = device.makeDefaultLibrary() else {
             fatalError("Could not create Metal shader library!")
@@ -62,6 +105,10 @@ class mglColorRenderingState {
         self.onscreenRenderingConfig = onscreenRenderingConfig
         self.currentColorRenderingConfig = onscreenRenderingConfig
     }
+
+    deinit {
+        mglTextureBudgetFree(&textureBudget)
+    }
     
     // Collaborate with mglRenderer to set up a render pass.
     func getRenderPassDescriptor(view: MTKView) -> MTLRenderPassDescriptor? {
@@ -99,9 +146,15 @@ class mglColorRenderingState {
     
     // Collaborate with mglRenderer to set up a render pass.
     func finishDrawing(commandBuffer: MTLCommandBuffer, drawable: CAMetalDrawable?) {
+        frameCount += 1
         return currentColorRenderingConfig.finishDrawing(commandBuffer: commandBuffer, drawable: drawable)
     }
     
+    // Report how many frames have finished drawing.
+    func getFrameCount() -> UInt64 {
+        return frameCount
+    }
+    
     // Collaborate with mglRenderer to set up a render pass.
     func getDotsPipelineState() -> MTLRenderPipelineState {
         return currentColorRenderingConfig.dotsPipelineState
@@ -122,6 +175,21 @@ class mglColorRenderingState {
         return currentColorRenderingConfig.verticesWithColorPipelineState
     }
     
+    // Collaborate with mglRenderer to set up a render pass.
+    func getInstancedLinesPipelineState() -> MTLRenderPipelineState {
+        return currentColorRenderingConfig.instancedLinesPipelineState
+    }
+
+    // Collaborate with mglRenderer to set up a render pass.
+    func getProceduralGratingsPipelineState() -> MTLRenderPipelineState {
+        return currentColorRenderingConfig.proceduralGratingsPipelineState
+    }
+
+    // Collaborate with mglRenderer to set up a render pass.
+    func getSpritesPipelineState() -> MTLRenderPipelineState {
+        return currentColorRenderingConfig.spritesPipelineState
+    }
+    
     // Let mglRenderer grab the current fame from a texture target.
     func frameGrab() -> (width: Int, height: Int, pointer: UnsafeMutablePointer<Float>?) {
         return currentColorRenderingConfig.frameGrab()
@@ -165,6 +233,11 @@ class mglColorRenderingState {
         return currentColorRenderingConfig is mglOffScreenTextureRenderingConfig
     }
 
+    // The offscreen texture we're currently rendering to, or nil when rendering to the screen.
+    func getRenderTargetTexture() -> MTLTexture? {
+        return (currentColorRenderingConfig as? mglOffScreenTextureRenderingConfig)?.colorTexture
+    }
+
     // Should we configure depth/stencil and timestamps?
     // Returns true if we need to configure (offscreen OR MTKView path)
     // Returns false if already pre-configured (CAMetalDisplayLink onscreen path)
@@ -197,9 +270,87 @@ class mglColorRenderingState {
             return false
         }
         currentColorRenderingConfig = newTextureRenderingConfig
+
+        // What is rendered into the texture is only on the GPU, so keep it resident.
+        if let textureNumber = textures.first(where: { $0.value === targetTexture })?.key {
+            mglTextureBudgetPin(&textureBudget, textureNumber)
+        }
         return true
     }
     
+    // Start rendering a frame that will be presented later, into a pooled texture like the drawable.
+    // Returns the number of the pooled frame, or nil if every pooled frame is waiting to be presented.
+    func startScheduledFrame(view: MTKView) -> Int? {
+        if configBeforeScheduledFrame != nil {
+            logger.error(component: "mglColorRenderingState", details: "Can't start a scheduled frame before the last one was flushed.")
+            return nil
+        }
+
+        // (Re)make the pool when there is none yet, or the drawable changed and no pooled frames are waiting.
+        let width = Int(view.drawableSize.width)
+        let height = Int(view.drawableSize.height)
+        let poolMatchesView = scheduledFrameConfigs.first.map {
+            $0.colorTexture.width == width && $0.colorTexture.height == height && $0.colorTexture.pixelFormat == view.colorPixelFormat
+        } ?? false
+        if !poolMatchesView && scheduledFramesInUse.isEmpty {
+            guard let device = view.device else {
+                return nil
+            }
+            let textureDescriptor = MTLTextureDescriptor.texture2DDescriptor(
+                pixelFormat: view.colorPixelFormat,
+                width: width,
+                height: height,
+                mipmapped: false)
+            textureDescriptor.storageMode = .managed
+            textureDescriptor.usage = [.renderTarget, .shaderRead]
+            var configs: [mglOffScreenTextureRenderingConfig] = []
+            for _ in 0 ..< scheduledFramePoolSize {
+                guard let texture = device.makeTexture(descriptor: textureDescriptor),
+                      let config = mglOffScreenTextureRenderingConfig(logger: logger, device: device, library: library, view: view, texture: texture) else {
+                    logger.error(component: "mglColorRenderingState", details: "Could not create pooled textures for scheduled frames.")
+                    return nil
+                }
+                configs.append(config)
+            }
+            scheduledFrameConfigs = configs
+
+            // Pooled frames are copied to the drawable, so the drawable can't be framebuffer only.
+            view.framebufferOnly = false
+            logger.info(component: "mglColorRenderingState", details: "Created \(scheduledFramePoolSize) pooled textures \(width) x \(height) for scheduled frames.")
+        }
+
+        guard let index = scheduledFrameConfigs.indices.first(where: { !scheduledFramesInUse.contains($0) }) else {
+            logger.error(component: "mglColorRenderingState", details: "All \(scheduledFrameConfigs.count) pooled frames are waiting to be presented, can't schedule another.")
+            return nil
+        }
+        scheduledFramesInUse.insert(index)
+        configBeforeScheduledFrame = currentColorRenderingConfig
+        currentColorRenderingConfig = scheduledFrameConfigs[index]
+        return index
+    }
+
+    // Go back to the render target from before startScheduledFrame().
+    func finishScheduledFrame() {
+        if let config = configBeforeScheduledFrame {
+            currentColorRenderingConfig = config
+            configBeforeScheduledFrame = nil
+        }
+    }
+
+    // Get the texture a scheduled frame was rendered into.
+    func getScheduledFrameTexture(index: Int) -> MTLTexture? {
+        if !scheduledFrameConfigs.indices.contains(index) {
+            return nil
+        }
+        return scheduledFrameConfigs[index].colorTexture
+    }
+
+    // Let a pooled frame be used again, after it was presented or given up on.
+    // Later rendering into it is encoded on the same command queue, so it will wait for the GPU to finish presenting it.
+    func releaseScheduledFrame(index: Int) {
+        scheduledFramesInUse.remove(index)
+    }
+
     // Report the size of the onscreen drawable or offscreen texture.
     func getSize(view: MTKView) -> (Float, Float) {
         return currentColorRenderingConfig.getSize(view: view)
@@ -209,37 +360,131 @@ class mglColorRenderingState {
     func addTexture(texture: MTLTexture) -> UInt32 {
         // Consume a texture number from the bookkeeping sequence.
         let consumedTextureNumber = textureSequence
+        let textureBytes = texture.buffer?.length ?? texture.allocatedSize
+        makeRoomForTexture(byteCount: textureBytes)
         textures[consumedTextureNumber] = texture
+        if mglTextureBudgetAdd(&textureBudget, consumedTextureNumber, UInt64(textureBytes), frameCount) == 0 {
+            logger.error(component: "mglColorRenderingState", details: "Could not keep track of texture number \(consumedTextureNumber) for the texture budget, it will stay resident.")
+        }
         textureSequence += 1
         return consumedTextureNumber
     }
     
     // Get an existing texture from the collection, if one exists with the given number.
+    // A texture that was spilled to stay within the texture budget is restored first.
     func getTexture(textureNumber: UInt32) -> MTLTexture? {
-        guard let texture = textures[textureNumber] else {
-            logger.error(component: "mglColorRenderingState", details: "Can't get invalid texture number \(textureNumber), valid numbers are \(String(describing: textures.keys))")
-            return nil
+        if let texture = textures[textureNumber] {
+            _ = mglTextureBudgetUse(&textureBudget, textureNumber, frameCount)
+            return texture
         }
-        return texture
+        if spilledTextures[textureNumber] != nil {
+            _ = mglTextureBudgetUse(&textureBudget, textureNumber, frameCount)
+            return restoreTexture(textureNumber: textureNumber)
+        }
+        logger.error(component: "mglColorRenderingState", details: "Can't get invalid texture number \(textureNumber), valid numbers are \(String(describing: getTextureNumbers()))")
+        return nil
     }
     
-    // Remove and return an existing texture from the collection, if one exists with the given number.
-    func removeTexture(textureNumber: UInt32) -> MTLTexture? {
-        guard let texture = textures.removeValue(forKey: textureNumber) else {
-            logger.error(component: "mglColorRenderingState", details: "Can't remove invalid texture number \(textureNumber), valid numbers are \(String(describing: textures.keys))")
-            return nil
+    // Remove an existing texture from the collection, resident or spilled, if one exists with the given number.
+    func removeTexture(textureNumber: UInt32) -> Bool {
+        guard textures.removeValue(forKey: textureNumber) != nil || spilledTextures.removeValue(forKey: textureNumber) != nil else {
+            logger.error(component: "mglColorRenderingState", details: "Can't remove invalid texture number \(textureNumber), valid numbers are \(String(describing: getTextureNumbers()))")
+            return false
         }
+        _ = mglTextureBudgetRemove(&textureBudget, textureNumber)
         
-        logger.info(component: "mglColorRenderingState", details: "Removed texture number \(textureNumber), remaining numbers are \(String(describing: textures.keys))")
-        return texture
+        logger.info(component: "mglColorRenderingState", details: "Removed texture number \(textureNumber), remaining numbers are \(String(describing: getTextureNumbers()))")
+        return true
     }
     
     func getTextureCount() -> UInt32 {
-        return UInt32(textures.count)
+        return UInt32(textures.count + spilledTextures.count)
     }
     
     func getTextureNumbers() -> Array<UInt32> {
-        return Array(textures.keys).sorted()
+        return (Array(textures.keys) + Array(spilledTextures.keys)).sorted()
+    }
+
+    // Set how many bytes of textures to keep in GPU memory, 0 for no limit, and spill textures to get within it.
+    func setTextureBudget(byteCount: UInt64) {
+        textureBudget.budgetBytes = byteCount
+        makeRoomForTexture(byteCount: 0)
+        logger.info(component: "mglColorRenderingState", details: "Texture budget \(byteCount) bytes, \(textureBudget.residentBytes) bytes in \(textureBudget.residentCount) textures resident, \(textureBudget.spilledCount) spilled.")
+    }
+
+    // Report the texture budget and residency counts, for mglInfo.
+    func getTextureBudget() -> mglTextureBudget {
+        return textureBudget
+    }
+
+    // Spill the least recently used textures, as chosen by mglTextureBudgetChooseSpills, so that byteCount more fits in the budget.
+    private func makeRoomForTexture(byteCount: Int) {
+        var victims = [UInt32](repeating: 0, count: Int(textureBudget.entryCount))
+        let victimCount = mglTextureBudgetChooseSpills(&textureBudget, UInt64(byteCount), frameCount, &victims, UInt32(victims.count))
+        for textureNumber in victims.prefix(Int(victimCount)) {
+            if !spillTexture(textureNumber: textureNumber) {
+                // Don't choose this one again.
+                mglTextureBudgetPin(&textureBudget, textureNumber)
+            }
+        }
+    }
+
+    // Compress a texture's contents into host memory and let go of its GPU memory.
+    // Command buffers keep their own references to textures, so frames that are still drawing with it are not affected.
+    private func spillTexture(textureNumber: UInt32) -> Bool {
+        guard let texture = textures[textureNumber],
+              let buffer = texture.buffer else {
+            logger.error(component: "mglColorRenderingState", details: "Can't spill texture number \(textureNumber), which has no buffer to read back, it will stay resident.")
+            return false
+        }
+        let contents = NSData(bytesNoCopy: buffer.contents(), length: buffer.length, freeWhenDone: false)
+        guard let compressed = try? contents.compressed(using: .lz4) else {
+            logger.error(component: "mglColorRenderingState", details: "Could not compress texture number \(textureNumber) to spill it, it will stay resident.")
+            return false
+        }
+        spilledTextures[textureNumber] = mglSpilledTexture(
+            width: texture.width,
+            height: texture.height,
+            pixelFormat: texture.pixelFormat,
+            usage: texture.usage,
+            bytesPerRow: texture.bufferBytesPerRow,
+            bufferLength: buffer.length,
+            compressed: compressed as Data
+        )
+        textures.removeValue(forKey: textureNumber)
+        mglTextureBudgetSpilled(&textureBudget, textureNumber, UInt64(compressed.length))
+        logger.info(component: "mglColorRenderingState", details: "Spilled texture number \(textureNumber), \(buffer.length) bytes compressed to \(compressed.length).")
+        return true
+    }
+
+    // Make a spilled texture again, the same way mglCommandInterface.createTexture does, making room for it first.
+    private func restoreTexture(textureNumber: UInt32) -> MTLTexture? {
+        guard let spilled = spilledTextures[textureNumber] else {
+            return nil
+        }
+        makeRoomForTexture(byteCount: spilled.bufferLength)
+        guard let contents = try? (spilled.compressed as NSData).decompressed(using: .lz4),
+              contents.length == spilled.bufferLength,
+              let buffer = device.makeBuffer(bytes: contents.bytes, length: contents.length, options: .storageModeManaged) else {
+            logger.error(component: "mglColorRenderingState", details: "Could not restore spilled texture number \(textureNumber).")
+            return nil
+        }
+        buffer.didModifyRange(0 ..< buffer.length)
+        let textureDescriptor = MTLTextureDescriptor.texture2DDescriptor(
+            pixelFormat: spilled.pixelFormat,
+            width: spilled.width,
+            height: spilled.height,
+            mipmapped: false)
+        textureDescriptor.usage = spilled.usage
+        guard let texture = buffer.makeTexture(descriptor: textureDescriptor, offset: 0, bytesPerRow: spilled.bytesPerRow) else {
+            logger.error(component: "mglColorRenderingState", details: "Could not make texture to restore spilled texture number \(textureNumber).")
+            return nil
+        }
+        spilledTextures.removeValue(forKey: textureNumber)
+        textures[textureNumber] = texture
+        mglTextureBudgetRestored(&textureBudget, textureNumber)
+        logger.info(component: "mglColorRenderingState", details: "Restored spilled texture number \(textureNumber).")
+        return texture
     }
     
     // Add a new movie to our collection
@@ -279,6 +524,76 @@ class mglColorRenderingState {
         return Array(movies.keys).sorted()
     }
 
+    // Add a new frame stream to our collection
+    func addFrameStream(frameStream: mglFrameStreamTextures) -> UInt32 {
+        // Consume a frame stream number from the bookkeeping sequence.
+        let consumedFrameStreamNumber = frameStreamSequence
+        frameStreams[consumedFrameStreamNumber] = frameStream
+        frameStreamSequence += 1
+        return consumedFrameStreamNumber
+    }
+
+    // Get an existing frame stream from the collection, if one exists with the given number.
+    func getFrameStream(frameStreamNumber: UInt32) -> mglFrameStreamTextures? {
+        guard let frameStream = frameStreams[frameStreamNumber] else {
+            logger.error(component: "mglColorRenderingState", details: "Can't get invalid frame stream number \(frameStreamNumber), valid numbers are \(String(describing: frameStreams.keys))")
+            return nil
+        }
+        return frameStream
+    }
+
+    // Remove and return an existing frame stream from the collection, if one exists with the given number.
+    func removeFrameStream(frameStreamNumber: UInt32) -> mglFrameStreamTextures? {
+        guard let frameStream = frameStreams.removeValue(forKey: frameStreamNumber) else {
+            logger.error(component: "mglColorRenderingState", details: "Can't remove invalid frame stream number \(frameStreamNumber), valid numbers are \(String(describing: frameStreams.keys))")
+            return nil
+        }
+
+        logger.info(component: "mglColorRenderingState", details: "Removed frame stream number \(frameStreamNumber), remaining numbers are \(String(describing: frameStreams.keys))")
+        return frameStream
+    }
+
+    func getFrameStreamCount() -> UInt32 {
+        return UInt32(frameStreams.count)
+    }
+
+    func getReadbackRing() -> mglReadbackRing {
+        return readbackRing
+    }
+
+    // Add new geometry to our collection
+    func addGeometry(geometry: mglGeometry) -> UInt32 {
+        // Consume a geometry number from the bookkeeping sequence.
+        let consumedGeometryNumber = geometrySequence
+        geometries[consumedGeometryNumber] = geometry
+        geometrySequence += 1
+        return consumedGeometryNumber
+    }
+
+    // Get existing geometry from the collection, if one exists with the given number.
+    func getGeometry(geometryNumber: UInt32) -> mglGeometry? {
+        guard let geometry = geometries[geometryNumber] else {
+            logger.error(component: "mglColorRenderingState", details: "Can't get invalid geometry number \(geometryNumber), valid numbers are \(String(describing: geometries.keys))")
+            return nil
+        }
+        return geometry
+    }
+
+    // Remove and return existing geometry from the collection, if one exists with the given number.
+    func removeGeometry(geometryNumber: UInt32) -> mglGeometry? {
+        guard let geometry = geometries.removeValue(forKey: geometryNumber) else {
+            logger.error(component: "mglColorRenderingState", details: "Can't remove invalid geometry number \(geometryNumber), valid numbers are \(String(describing: geometries.keys))")
+            return nil
+        }
+
+        logger.info(component: "mglColorRenderingState", details: "Removed geometry number \(geometryNumber), remaining numbers are \(String(describing: geometries.keys))")
+        return geometry
+    }
+
+    func getGeometryCount() -> UInt32 {
+        return UInt32(geometries.count)
+    }
+
 }
 
 // This declares the operations that mglRenderer relies on to set up Metal rendering passes and pipelines.
@@ -287,6 +602,9 @@ private protocol mglColorRenderingConfig {
     var dotsPipelineState: MTLRenderPipelineState { get }
     var arcsPipelineState: MTLRenderPipelineState { get }
     var verticesWithColorPipelineState: MTLRenderPipelineState { get }
+    var instancedLinesPipelineState: MTLRenderPipelineState { get }
+    var proceduralGratingsPipelineState: MTLRenderPipelineState { get }
+    var spritesPipelineState: MTLRenderPipelineState { get }
     var texturePipelineState: MTLRenderPipelineState { get }
 
     func getRenderPassDescriptor(view: MTKView) -> MTLRenderPassDescriptor?
@@ -301,6 +619,9 @@ private class mglOnscreenRenderingConfig : mglColorRenderingConfig {
     let dotsPipelineState: MTLRenderPipelineState
     let arcsPipelineState: MTLRenderPipelineState
     let verticesWithColorPipelineState: MTLRenderPipelineState
+    let instancedLinesPipelineState: MTLRenderPipelineState
+    let proceduralGratingsPipelineState: MTLRenderPipelineState
+    let spritesPipelineState: MTLRenderPipelineState
     let texturePipelineState: MTLRenderPipelineState
 
     init?(logger: mglLogger, device: MTLDevice, library: MTLLibrary, view: MTKView) {
@@ -324,6 +645,24 @@ private class mglOnscreenRenderingConfig : mglColorRenderingConfig {
                     depthPixelFormat: view.depthStencilPixelFormat,
                     stencilPixelFormat: view.depthStencilPixelFormat,
                     library: library))
+            instancedLinesPipelineState = try device.makeRenderPipelineState(
+                descriptor: instancedLinesPipelineStateDescriptor(
+                    colorPixelFormat: view.colorPixelFormat,
+                    depthPixelFormat: view.depthStencilPixelFormat,
+                    stencilPixelFormat: view.depthStencilPixelFormat,
+                    library: library))
+            proceduralGratingsPipelineState = try device.makeRenderPipelineState(
+                descriptor: proceduralGratingsPipelineStateDescriptor(
+                    colorPixelFormat: view.colorPixelFormat,
+                    depthPixelFormat: view.depthStencilPixelFormat,
+                    stencilPixelFormat: view.depthStencilPixelFormat,
+                    library: library))
+            spritesPipelineState = try device.makeRenderPipelineState(
+                descriptor: spritesPipelineStateDescriptor(
+                    colorPixelFormat: view.colorPixelFormat,
+                    depthPixelFormat: view.depthStencilPixelFormat,
+                    stencilPixelFormat: view.depthStencilPixelFormat,
+                    library: library))
             texturePipelineState = try device.makeRenderPipelineState(
                 descriptor: bltTexturePipelineStateDescriptor(
                     colorPixelFormat: view.colorPixelFormat,
@@ -364,6 +703,9 @@ private class mglOffScreenTextureRenderingConfig : mglColorRenderingConfig {
     let dotsPipelineState: MTLRenderPipelineState
     let arcsPipelineState: MTLRenderPipelineState
     let verticesWithColorPipelineState: MTLRenderPipelineState
+    let instancedLinesPipelineState: MTLRenderPipelineState
+    let proceduralGratingsPipelineState: MTLRenderPipelineState
+    let spritesPipelineState: MTLRenderPipelineState
     let texturePipelineState: MTLRenderPipelineState
 
     let colorTexture: MTLTexture
@@ -415,6 +757,24 @@ private class mglOffScreenTextureRenderingConfig : mglColorRenderingConfig {
                     depthPixelFormat: view.depthStencilPixelFormat,
                     stencilPixelFormat: view.depthStencilPixelFormat,
                     library: library))
+            instancedLinesPipelineState = try device.makeRenderPipelineState(
+                descriptor: instancedLinesPipelineStateDescriptor(
+                    colorPixelFormat: texture.pixelFormat,
+                    depthPixelFormat: view.depthStencilPixelFormat,
+                    stencilPixelFormat: view.depthStencilPixelFormat,
+                    library: library))
+            proceduralGratingsPipelineState = try device.makeRenderPipelineState(
+                descriptor: proceduralGratingsPipelineStateDescriptor(
+                    colorPixelFormat: texture.pixelFormat,
+                    depthPixelFormat: view.depthStencilPixelFormat,
+                    stencilPixelFormat: view.depthStencilPixelFormat,
+                    library: library))
+            spritesPipelineState = try device.makeRenderPipelineState(
+                descriptor: spritesPipelineStateDescriptor(
+                    colorPixelFormat: texture.pixelFormat,
+                    depthPixelFormat: view.depthStencilPixelFormat,
+                    stencilPixelFormat: view.depthStencilPixelFormat,
+                    library: library))
             texturePipelineState = try device.makeRenderPipelineState(
                 descriptor: bltTexturePipelineStateDescriptor(
                     colorPixelFormat: texture.pixelFormat,
@@ -536,37 +896,7 @@ private func arcsPipelineStateDescriptor(
     pipelineDescriptor.colorAttachments[0].destinationRGBBlendFactor = MTLBlendFactor.oneMinusSourceAlpha;
     pipelineDescriptor.colorAttachments[0].destinationAlphaBlendFactor = MTLBlendFactor.oneMinusSourceAlpha;
 
-    let vertexDescriptor = MTLVertexDescriptor()
-    // xyz
-    vertexDescriptor.attributes[0].format = .float3
-    vertexDescriptor.attributes[0].offset = 0
-    vertexDescriptor.attributes[0].bufferIndex = 0
-    // rgba
-    vertexDescriptor.attributes[1].format = .float4
-    vertexDescriptor.attributes[1].offset = 3 * MemoryLayout<Float>.stride
-    vertexDescriptor.attributes[1].bufferIndex = 0
-    // radii
-    vertexDescriptor.attributes[2].format = .float4
-    vertexDescriptor.attributes[2].offset = 7 * MemoryLayout<Float>.stride
-    vertexDescriptor.attributes[2].bufferIndex = 0
-    // wedge
-    vertexDescriptor.attributes[3].format = .float2
-    vertexDescriptor.attributes[3].offset = 11 * MemoryLayout<Float>.stride
-    vertexDescriptor.attributes[3].bufferIndex = 0
-    // border
-    vertexDescriptor.attributes[4].format = .float
-    vertexDescriptor.attributes[4].offset = 13 * MemoryLayout<Float>.stride
-    vertexDescriptor.attributes[4].bufferIndex = 0
-    // center vertex (computed)
-    vertexDescriptor.attributes[5].format = .float3
-    vertexDescriptor.attributes[5].offset = 14 * MemoryLayout<Float>.stride
-    vertexDescriptor.attributes[5].bufferIndex = 0
-    // viewport size
-    vertexDescriptor.attributes[6].format = .float2
-    vertexDescriptor.attributes[6].offset = 17 * MemoryLayout<Float>.stride
-    vertexDescriptor.attributes[6].bufferIndex = 0
-    vertexDescriptor.layouts[0].stride = 19 * MemoryLayout<Float>.stride
-    pipelineDescriptor.vertexDescriptor = vertexDescriptor
+    // There is no vertex descriptor, since the shader reads one record per arc from the buffer by instance id.
     pipelineDescriptor.vertexFunction = library?.makeFunction(name: "vertex_arcs")
     pipelineDescriptor.fragmentFunction = library?.makeFunction(name: "fragment_arcs")
 
@@ -642,3 +972,81 @@ private func drawVerticesPipelineStateDescriptor(
 
     return pipelineDescriptor
 }
+
+// Create the config for drawing with our mgl "instanced lines" shaders.
+// This depends on whether we're rendering to screen or to offscreen texture.
+// There is no vertex descriptor, since the shader reads one record per line from the buffer by instance id.
+private func instancedLinesPipelineStateDescriptor(
+    colorPixelFormat:  MTLPixelFormat,
+    depthPixelFormat:  MTLPixelFormat,
+    stencilPixelFormat:  MTLPixelFormat,
+    library: MTLLibrary?
+) -> MTLRenderPipelineDescriptor {
+    let pipelineDescriptor = MTLRenderPipelineDescriptor()
+    pipelineDescriptor.depthAttachmentPixelFormat = depthPixelFormat
+    pipelineDescriptor.stencilAttachmentPixelFormat = stencilPixelFormat
+    pipelineDescriptor.colorAttachments[0].pixelFormat = colorPixelFormat
+    pipelineDescriptor.colorAttachments[0].isBlendingEnabled = true;
+    pipelineDescriptor.colorAttachments[0].rgbBlendOperation = MTLBlendOperation.add;
+    pipelineDescriptor.colorAttachments[0].alphaBlendOperation = MTLBlendOperation.add;
+    pipelineDescriptor.colorAttachments[0].sourceRGBBlendFactor = MTLBlendFactor.sourceAlpha;
+    pipelineDescriptor.colorAttachments[0].sourceAlphaBlendFactor = MTLBlendFactor.sourceAlpha;
+    pipelineDescriptor.colorAttachments[0].destinationRGBBlendFactor = MTLBlendFactor.oneMinusSourceAlpha;
+    pipelineDescriptor.colorAttachments[0].destinationAlphaBlendFactor = MTLBlendFactor.oneMinusSourceAlpha;
+    pipelineDescriptor.vertexFunction = library?.makeFunction(name: "vertex_instanced_lines")
+    pipelineDescriptor.fragmentFunction = library?.makeFunction(name: "fragment_instanced_lines")
+
+    return pipelineDescriptor
+}
+
+// Create the config for drawing with our mgl "procedural gratings" shaders.
+// This depends on whether we're rendering to screen or to offscreen texture.
+// There is no vertex descriptor, since the shader reads one record per grating from the buffer by instance id.
+private func proceduralGratingsPipelineStateDescriptor(
+    colorPixelFormat:  MTLPixelFormat,
+    depthPixelFormat:  MTLPixelFormat,
+    stencilPixelFormat:  MTLPixelFormat,
+    library: MTLLibrary?
+) -> MTLRenderPipelineDescriptor {
+    let pipelineDescriptor = MTLRenderPipelineDescriptor()
+    pipelineDescriptor.depthAttachmentPixelFormat = depthPixelFormat
+    pipelineDescriptor.stencilAttachmentPixelFormat = stencilPixelFormat
+    pipelineDescriptor.colorAttachments[0].pixelFormat = colorPixelFormat
+    pipelineDescriptor.colorAttachments[0].isBlendingEnabled = true;
+    pipelineDescriptor.colorAttachments[0].rgbBlendOperation = MTLBlendOperation.add;
+    pipelineDescriptor.colorAttachments[0].alphaBlendOperation = MTLBlendOperation.add;
+    pipelineDescriptor.colorAttachments[0].sourceRGBBlendFactor = MTLBlendFactor.sourceAlpha;
+    pipelineDescriptor.colorAttachments[0].sourceAlphaBlendFactor = MTLBlendFactor.sourceAlpha;
+    pipelineDescriptor.colorAttachments[0].destinationRGBBlendFactor = MTLBlendFactor.oneMinusSourceAlpha;
+    pipelineDescriptor.colorAttachments[0].destinationAlphaBlendFactor = MTLBlendFactor.oneMinusSourceAlpha;
+    pipelineDescriptor.vertexFunction = library?.makeFunction(name: "vertex_procedural_gratings")
+    pipelineDescriptor.fragmentFunction = library?.makeFunction(name: "fragment_procedural_gratings")
+
+    return pipelineDescriptor
+}
+
+// Create the config for drawing with our mgl "sprites" shaders.
+// This depends on whether we're rendering to screen or to offscreen texture.
+// There is no vertex descriptor, since the shader reads one record per sprite from the buffer by instance id.
+private func spritesPipelineStateDescriptor(
+    colorPixelFormat:  MTLPixelFormat,
+    depthPixelFormat:  MTLPixelFormat,
+    stencilPixelFormat:  MTLPixelFormat,
+    library: MTLLibrary?
+) -> MTLRenderPipelineDescriptor {
+    let pipelineDescriptor = MTLRenderPipelineDescriptor()
+    pipelineDescriptor.depthAttachmentPixelFormat = depthPixelFormat
+    pipelineDescriptor.stencilAttachmentPixelFormat = stencilPixelFormat
+    pipelineDescriptor.colorAttachments[0].pixelFormat = colorPixelFormat
+    pipelineDescriptor.colorAttachments[0].isBlendingEnabled = true;
+    pipelineDescriptor.colorAttachments[0].rgbBlendOperation = MTLBlendOperation.add;
+    pipelineDescriptor.colorAttachments[0].alphaBlendOperation = MTLBlendOperation.add;
+    pipelineDescriptor.colorAttachments[0].sourceRGBBlendFactor = MTLBlendFactor.sourceAlpha;
+    pipelineDescriptor.colorAttachments[0].sourceAlphaBlendFactor = MTLBlendFactor.sourceAlpha;
+    pipelineDescriptor.colorAttachments[0].destinationRGBBlendFactor = MTLBlendFactor.oneMinusSourceAlpha;
+    pipelineDescriptor.colorAttachments[0].destinationAlphaBlendFactor = MTLBlendFactor.oneMinusSourceAlpha;
+    pipelineDescriptor.vertexFunction = library?.makeFunction(name: "vertex_sprites")
+    pipelineDescriptor.fragmentFunction = library?.makeFunction(name: "fragment_sprites")
+
+    return pipelineDescriptor
+}
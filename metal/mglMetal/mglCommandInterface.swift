@@ -74,6 +74,13 @@ class mglCommandInterface {
     // What state is the command interface in with respect to batches: none, building, or processing?
     private var batchState: BatchState = .none
 
+    // The display list being recorded, if any, between startDisplayList and finishDisplayList.
+    private var recordingDisplayList: mglDisplayList? = nil
+
+    // Display lists that have been recorded and can be called by number.
+    private var displayListSequence = UInt32(1)
+    private var displayLists: [UInt32: mglDisplayList] = [:]
+
     // Utility to get system nano time.
     let secs = mglSecs()
 
@@ -107,9 +114,72 @@ class mglCommandInterface {
         return nil
     }
 
+    // Start recording commands into a new display list, instead of processing them.
+    func startDisplayList() -> mglCommand? {
+        if batchState != .none {
+            logger.error(component: "mglCommandInterface", details: "Can't record a display list while in a command batch.")
+            return nil
+        }
+        recordingDisplayList = mglDisplayList()
+        return nil
+    }
+
+    // Stop recording and report the new display list number (0 on failure) and how many commands it has.
+    func finishDisplayList() -> mglCommand? {
+        var displayListNumber = UInt32(0)
+        var commandCount = UInt32(0)
+        if let displayList = recordingDisplayList {
+            commandCount = UInt32(displayList.commands.count)
+            if displayList.failed {
+                logger.error(component: "mglCommandInterface", details: "Display list had commands that can't be recorded, not keeping it.")
+            } else {
+                displayListNumber = addDisplayList(displayList: displayList)
+            }
+        } else {
+            logger.error(component: "mglCommandInterface", details: "Can't finish a display list that was never started.")
+        }
+        recordingDisplayList = nil
+        _ = writeUInt32(data: displayListNumber)
+        _ = writeUInt32(data: commandCount)
+        return nil
+    }
+
+    // Forget a display list and report whether it existed.
+    func deleteDisplayList() -> mglCommand? {
+        guard let displayListNumber = readUInt32() else {
+            return nil
+        }
+        let removed = displayLists.removeValue(forKey: displayListNumber) != nil
+        if !removed {
+            logger.error(component: "mglCommandInterface", details: "Can't remove invalid display list number \(displayListNumber), valid numbers are \(String(describing: displayLists.keys))")
+        }
+        _ = writeUInt32(data: removed ? 1 : 0)
+        return nil
+    }
+
+    // Keep a display list to be called by number -- also used directly during testing.
+    func addDisplayList(displayList: mglDisplayList) -> UInt32 {
+        let consumedDisplayListNumber = displayListSequence
+        displayLists[consumedDisplayListNumber] = displayList
+        displayListSequence += 1
+        return consumedDisplayListNumber
+    }
+
+    // Get a display list by number, if one exists.
+    func getDisplayList(displayListNumber: UInt32) -> mglDisplayList? {
+        guard let displayList = displayLists[displayListNumber] else {
+            logger.error(component: "mglCommandInterface", details: "Can't get invalid display list number \(displayListNumber), valid numbers are \(String(describing: displayLists.keys))")
+            return nil
+        }
+        return displayList
+    }
+
     // Wait for the next command from the client, read it fully, and add to the todo queue for processing.
     // Require a MTLDevice so that commands can immediately write data to GPU device buffers, with no intermediate.
     private func awaitCommand(device: MTLDevice) -> mglCommand? {
+        mglTraceBegin(mglTraceAwaitCommand, 0)
+        defer { mglTraceEnd(mglTraceAwaitCommand, 0) }
+
         // Consume the command code that tells us what to do next.
         // This will block until one arrives.
         guard let commandCode = readCommandCode() else {
@@ -126,6 +196,9 @@ class mglCommandInterface {
             case mglStartBatch: return startBatch()
             case mglProcessBatch: return processBatch()
             case mglFinishBatch: return finishBatch()
+            case mglStartDisplayList: return startDisplayList()
+            case mglFinishDisplayList: return finishDisplayList()
+            case mglDeleteDisplayList: return deleteDisplayList()
 
             // Instantiate a new command by reading it fully from the socket.
             // This will block until all command-specific parameters arrive.
@@ -148,12 +221,20 @@ class mglCommandInterface {
             case mglMinimize: command = mglMinimizeCommand(commandInterface: self)
             case mglDisplayCursor: command = mglDisplayCursorCommand(commandInterface: self)
             case mglSampleTimestamps: command = mglSampleTimestampsCommand(device: device)
+            case mglCreateGeometry: command = mglCreateGeometryCommand(commandInterface: self, device: device)
+            case mglUpdateGeometry: command = mglUpdateGeometryCommand(commandInterface: self)
+            case mglDeleteGeometry: command = mglDeleteGeometryCommand(commandInterface: self)
             case mglFlush: command = mglFlushCommand(commandInterface: self)
             case mglBltTexture: command = mglBltTextureCommand(commandInterface: self, device: device)
             case mglSetXform: command = mglSetXformCommand(commandInterface: self)
             case mglDots: command = mglDotsCommand(commandInterface: self, device: device)
             case mglLine: command = mglLineCommand(commandInterface: self, device: device)
             case mglQuad: command = mglQuadCommand(commandInterface: self, device: device)
+            case mglInstancedLines: command = mglInstancedLinesCommand(commandInterface: self, device: device)
+            case mglProceduralGratings: command = mglProceduralGratingsCommand(commandInterface: self, device: device)
+            case mglBltSprites: command = mglBltSpritesCommand(commandInterface: self, device: device)
+            case mglDrawGeometry: command = mglDrawGeometryCommand(commandInterface: self)
+            case mglCallDisplayList: command = mglCallDisplayListCommand(commandInterface: self)
             case mglPolygon: command = mglPolygonCommand(commandInterface: self, device: device)
             case mglArcs: command = mglArcsCommand(commandInterface: self, device: device)
             case mglUpdateTexture: command = mglUpdateTextureCommand(commandInterface: self, device: device)
@@ -164,6 +245,7 @@ class mglCommandInterface {
             case mglRepeatQuads: command = mglRepeatQuadsCommand(commandInterface: self)
             case mglRepeatDots: command = mglRepeatDotsCommand(commandInterface: self)
             case mglRepeatFlush: command = mglRepeatFlushCommand(commandInterface: self)
+            case mglRepeatDotMotion: command = mglRepeatDotMotionCommand(commandInterface: self)
             case mglMovieCreate: command = mglMovieCreateCommand(commandInterface: self, device: device, logger: self.logger)
             case mglMoviePlay: command = mglMoviePlayCommand(commandInterface: self, logger: self.logger)
             case mglMovieStatus: command = mglMovieStatusCommand(commandInterface: self, logger: self.logger)
@@ -173,6 +255,16 @@ class mglCommandInterface {
 
             case mglSetDesiredFrameRate: command = mglSetDesiredFrameRateCommand(commandInterface: self, logger: self.logger)
             case mglGetTargetPresentationTimestamp: command = mglGetTargetPresentationTimestampCommand(commandInterface: self, logger: self.logger)
+            case mglScheduleFrame: command = mglScheduleFrameCommand(commandInterface: self)
+            case mglGetScheduledFrameStats: command = mglGetScheduledFrameStatsCommand(commandInterface: self)
+            case mglGetFrameTelemetry: command = mglGetFrameTelemetryCommand(commandInterface: self)
+            case mglSetTrace: command = mglSetTraceCommand(commandInterface: self)
+            case mglSetTextureBudget: command = mglSetTextureBudgetCommand(commandInterface: self)
+            case mglFrameStreamOpen: command = mglFrameStreamOpenCommand(commandInterface: self)
+            case mglFrameStreamShowFrame: command = mglFrameStreamShowFrameCommand(commandInterface: self, device: device)
+            case mglFrameStreamClose: command = mglFrameStreamCloseCommand(commandInterface: self)
+            case mglReadbackIssue: command = mglReadbackIssueCommand(commandInterface: self)
+            case mglReadbackCollect: command = mglReadbackCollectCommand(commandInterface: self)
             default: command = nil
         }
  
@@ -188,6 +280,23 @@ class mglCommandInterface {
         // Note when this command was created.
         command?.results.ackTime = ackTime
 
+        // When recording a display list, keep the command there instead of processing it,
+        // and unblock the client by sending immediate results (placeholders, or a failure if it can't be recorded).
+        // A command that couldn't be read leaves a hole in the list, so the list is no good either.
+        if let displayList = recordingDisplayList, command == nil {
+            displayList.recordUnreadable()
+        }
+        if let displayList = recordingDisplayList, let command = command {
+            if displayList.record(command: command) {
+                writeResults(command: command, asPlaceholder: true)
+            } else {
+                logger.error(component: "mglCommandInterface", details: "Can't record \(String(describing: command)) in a display list.")
+                command.results.processedTime = secs.get()
+                writeResults(command: command)
+            }
+            return nil
+        }
+
         // When building up a batch, unblock the client by sending immediate placeholder results.
         if batchState == .building && command != nil {
             writeResults(command: command!, asPlaceholder: true)
@@ -200,11 +309,26 @@ class mglCommandInterface {
     // Read zero or more available commands from the client into the todo queue.
     // Don't block waiting for commands.
     func readAny(device: MTLDevice) {
+        mglTraceBegin(mglTraceReadAny, 0)
+        defer { mglTraceEnd(mglTraceReadAny, 0) }
+
         // Give the client a chance to connect.
         if !server.acceptClientConnection() {
             return
         }
 
+        // When recording a display list, keep reading commands as long as data is available,
+        // as for building a batch, so that recording doesn't take a frame per command.
+        if recordingDisplayList != nil {
+            while server.dataWaiting() {
+                let command = awaitCommand(device: device)
+                if command != nil {
+                    todo.append(command!)
+                }
+            }
+            return
+        }
+
         switch (batchState) {
         case BatchState.building:
             // Keep reading commands as long as data is available.
@@ -401,6 +525,20 @@ class mglCommandInterface {
         return server.sendData(buffer: &localData, byteCount: expectedByteCount)
     }
 
+    //\/\/\/\/\/\/\/\/\/\/\/\/\/\/
+    // readDouble
+    //\/\/\/\/\/\/\/\/\/\/\/\/\/\/
+    func readDouble() -> mglDouble? {
+        var data = mglDouble(0)
+        let expectedByteCount = MemoryLayout<mglDouble>.size
+        let bytesRead = server.readData(buffer: &data, expectedByteCount: expectedByteCount)
+        if (bytesRead != expectedByteCount) {
+            logger.error(component: "mglCommandInterface", details: "Expeted to read double \(expectedByteCount) bytes but read \(bytesRead)")
+            return nil
+        }
+        return data
+    }
+
     //\/\/\/\/\/\/\/\/\/\/\/\/\/\/
     // readFloat
     //\/\/\/\/\/\/\/\/\/\/\/\/\/\/
@@ -415,6 +553,25 @@ class mglCommandInterface {
         return data
     }
 
+    //\/\/\/\/\/\/\/\/\/\/\/\/\/\/
+    // readFloatArray
+    //\/\/\/\/\/\/\/\/\/\/\/\/\/\/
+    func readFloatArray(count: Int) -> [mglFloat]? {
+        if count == 0 {
+            return []
+        }
+        var data = [mglFloat](repeating: 0, count: count)
+        let expectedByteCount = Int(mglSizeOfFloatArray(mglUInt32(count)))
+        let bytesRead = data.withUnsafeMutableBytes { buffer in
+            return server.readData(buffer: buffer.baseAddress!, expectedByteCount: expectedByteCount)
+        }
+        if (bytesRead != expectedByteCount) {
+            logger.error(component: "mglCommandInterface", details: "Expeted to read float array \(expectedByteCount) bytes but read \(bytesRead)")
+            return nil
+        }
+        return data
+    }
+
     //\/\/\/\/\/\/\/\/\/\/\/\/\/\/
     // readColor
     //\/\/\/\/\/\/\/\/\/\/\/\/\/\/
@@ -73,6 +73,12 @@ class mglCommand {
         return true
     }
     
+    // Make a copy of this command with one value swapped out, for calling a display list with parameters.
+    // Return nil if this command doesn't take the given kind of parameter.
+    func substituting(parameter: mglDisplayListParameter) -> mglCommand? {
+        return nil
+    }
+
     // setUpFlushInFlight - this is used for repeating commands, because
     // the default logic assumes that a command will get only one
     // drawablePresented time - if there are multiple, we need to buffer
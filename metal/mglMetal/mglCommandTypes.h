@@ -15,7 +15,15 @@
 // Source of truth for supported commands and their numeric codes.
 // Communication code should use these enum symbols, not the numeric values themselves.
 // Matlab and mglMetal should share this header so that they agree on the commands.
+// Compilers without enums of a fixed type (gcc before C23, as for the plain C parts of
+// mgllib built on Linux) get the same codes as constants of a uint16_t type, the same size.
+#if defined(__clang__) || defined(__cplusplus) || (defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 202311L))
+#define MGL_COMMAND_CODE_FIXED_ENUM
 typedef enum mglCommandCode : uint16_t {
+#else
+typedef uint16_t mglCommandCode;
+enum {
+#endif
     mglPing = 0,
     mglDrainSystemEvents = 1,
     mglFullscreen = 2,
@@ -39,9 +47,15 @@ typedef enum mglCommandCode : uint16_t {
     mglMinimize = 21,
     mglDisplayCursor = 22,
     mglSampleTimestamps = 23,
+    mglCreateGeometry = 24,
+    mglUpdateGeometry = 25,
+    mglDeleteGeometry = 26,
     mglStartBatch = 100,
     mglProcessBatch = 101,
     mglFinishBatch = 102,
+    mglStartDisplayList = 103,
+    mglFinishDisplayList = 104,
+    mglDeleteDisplayList = 105,
     mglDrawingCommands = 1000,
     mglFlush = 1001,
     mglBltTexture = 1003,
@@ -67,8 +81,28 @@ typedef enum mglCommandCode : uint16_t {
     mglMovieDelete = 1026,
     mglSetDesiredFrameRate = 1024,
     mglGetTargetPresentationTimestamp = 1025,
+    mglRepeatDotMotion = 1027,
+    mglInstancedLines = 1028,
+    mglDrawGeometry = 1029,
+    mglCallDisplayList = 1030,
+    mglScheduleFrame = 1031,
+    mglGetScheduledFrameStats = 1032,
+    mglGetFrameTelemetry = 1033,
+    mglSetTrace = 1034,
+    mglProceduralGratings = 1035,
+    mglSetTextureBudget = 1036,
+    mglBltSprites = 1037,
+    mglFrameStreamOpen = 1038,
+    mglFrameStreamShowFrame = 1039,
+    mglFrameStreamClose = 1040,
+    mglReadbackIssue = 1041,
+    mglReadbackCollect = 1042,
     mglUnknownCommand = UINT16_MAX
+#ifdef MGL_COMMAND_CODE_FIXED_ENUM
 } mglCommandCode;
+#else
+};
+#endif
 
 // Utilities to list out and describe supported commands.
 // These should be useful for exposing supported commands in dynamic environments like Matlab.
@@ -97,9 +131,15 @@ const mglCommandCode mglCommandCodes[] = {
     mglMinimize,
     mglDisplayCursor,
     mglSampleTimestamps,
+    mglCreateGeometry,
+    mglUpdateGeometry,
+    mglDeleteGeometry,
     mglStartBatch,
     mglProcessBatch,
     mglFinishBatch,
+    mglStartDisplayList,
+    mglFinishDisplayList,
+    mglDeleteDisplayList,
     mglFlush,
     mglBltTexture,
     mglSetXform,
@@ -123,7 +163,23 @@ const mglCommandCode mglCommandCodes[] = {
     mglMovieSetDisplayPosition,
     mglMovieDelete,
     mglSetDesiredFrameRate,
-    mglGetTargetPresentationTimestamp
+    mglGetTargetPresentationTimestamp,
+    mglRepeatDotMotion,
+    mglInstancedLines,
+    mglDrawGeometry,
+    mglCallDisplayList,
+    mglScheduleFrame,
+    mglGetScheduledFrameStats,
+    mglGetFrameTelemetry,
+    mglSetTrace,
+    mglProceduralGratings,
+    mglSetTextureBudget,
+    mglBltSprites,
+    mglFrameStreamOpen,
+    mglFrameStreamShowFrame,
+    mglFrameStreamClose,
+    mglReadbackIssue,
+    mglReadbackCollect
 };
 const char* mglCommandNames[] = {
     "mglPing",
@@ -149,9 +205,15 @@ const char* mglCommandNames[] = {
     "mglMinimize",
     "mglDisplayCursor",
     "mglSampleTimestamps",
+    "mglCreateGeometry",
+    "mglUpdateGeometry",
+    "mglDeleteGeometry",
     "mglStartBatch",
     "mglProcessBatch",
     "mglFinishBatch",
+    "mglStartDisplayList",
+    "mglFinishDisplayList",
+    "mglDeleteDisplayList",
     "mglFlush",
     "mglBltTexture",
     "mglSetXform",
@@ -168,7 +230,6 @@ const char* mglCommandNames[] = {
     "mglRepeatQuads",
     "mglRepeatDots",
     "mglRepeatFlush",
-    "mglFrameGrab",
     "mglMovieCreate",
     "mglMoviePlay",
     "mglMovieDrawFrame",
@@ -176,7 +237,23 @@ const char* mglCommandNames[] = {
     "mglMovieSetDisplayPosition",
     "mglMovieDelete",
     "mglSetDesiredFrameRate",
-    "mglGetTargetPresentationTimestamp"
+    "mglGetTargetPresentationTimestamp",
+    "mglRepeatDotMotion",
+    "mglInstancedLines",
+    "mglDrawGeometry",
+    "mglCallDisplayList",
+    "mglScheduleFrame",
+    "mglGetScheduledFrameStats",
+    "mglGetFrameTelemetry",
+    "mglSetTrace",
+    "mglProceduralGratings",
+    "mglSetTextureBudget",
+    "mglBltSprites",
+    "mglFrameStreamOpen",
+    "mglFrameStreamShowFrame",
+    "mglFrameStreamClose",
+    "mglReadbackIssue",
+    "mglReadbackCollect"
 };
 
 // Type aliases for supported scalar data types of known, fixed sizes.
@@ -0,0 +1,85 @@
+//
+//  mglDisplayList.swift
+//  mglMetal
+//
+//  Created by justin gardner on 10/19/26.
+//  Copyright © 2026 GRU. All rights reserved.
+//
+
+import Foundation
+import MetalKit
+
+/*
+ A value to swap into one command of a display list when it is replayed.
+ The kind codes need to match mglMetalCallDisplayList.m.
+ */
+enum mglDisplayListParameter {
+    // The texture number for mglBltTexture.
+    case textureNumber(UInt32)
+    // The transform for mglSetXform or mglDrawGeometry.
+    case xform(simd_float4x4)
+    // The color for mglSetClearColor.
+    case color(simd_float3)
+
+    static let textureNumberKind = UInt32(0)
+    static let xformKind = UInt32(1)
+    static let colorKind = UInt32(2)
+}
+
+/*
+ mglDisplayList is a sequence of drawing commands that the client sent once, between
+ mglStartDisplayList and mglFinishDisplayList, and which stays on the server so that it can
+ be replayed with a single mglCallDisplayList, for example once per frame of a trial.
+
+ This is different from a command batch. A batch still sends every command, and runs each once.
+ A display list runs the same commands each time it's called, with only a few parameters swapped in.
+
+ Only commands that draw into a frame can be recorded. Commands that query the app, repeat across
+ frames, or flush a frame can't be, since replaying them wouldn't mean the same thing.
+ */
+class mglDisplayList {
+    private(set) var commands = [mglCommand]()
+
+    // Set if the client tried to record a command that can't be recorded.
+    private(set) var failed = false
+
+    init(commands: [mglCommand] = []) {
+        self.commands = commands
+    }
+
+    // Can this command be replayed as part of a frame?
+    static func canRecord(command: mglCommand) -> Bool {
+        return command.framesRemaining == 1 && !(command is mglFlushCommand)
+    }
+
+    // Add the next command, or note that the list is no good if the command can't be recorded.
+    func record(command: mglCommand) -> Bool {
+        if !mglDisplayList.canRecord(command: command) {
+            failed = true
+            return false
+        }
+        commands.append(command)
+        return true
+    }
+
+    // Note that the list is no good because the client sent a command that couldn't be read.
+    func recordUnreadable() {
+        failed = true
+    }
+
+    // Get the commands to replay, with parameters swapped into the commands at the given indices.
+    // The recorded commands are left as they were, so each call starts from what was recorded.
+    func commandsForCall(parameters: [(commandIndex: Int, parameter: mglDisplayListParameter)]) -> [mglCommand]? {
+        var callCommands = commands
+        for (commandIndex, parameter) in parameters {
+            if commandIndex < 0 || commandIndex >= callCommands.count {
+                return nil
+            }
+            guard let substituted = callCommands[commandIndex].substituting(parameter: parameter) else {
+                return nil
+            }
+            callCommands[commandIndex] = substituted
+        }
+        return callCommands
+    }
+}
@@ -0,0 +1,279 @@
+//
+//  mglDotMotion.h
+//  mglMetal
+//
+//  Created by justin gardner on 10/19/26.
+//  Copyright © 2026 GRU. All rights reserved.
+//
+
+#ifndef mglDotMotion_h
+#define mglDotMotion_h
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// Procedural dot motion, advanced one frame at a time on the CPU.
+// This follows utils/dotMotionFrame.m step for step, including the order in which
+// random numbers are drawn, and uses the same Mersenne twister that Matlab uses
+// for rng(seed,'twister'). So starting from the same seed the dots should match
+// what dotMotionFrame gives, to within the rounding of cos/sin.
+// This is plain C so that it can be shared between mglMetal (through the bridging header)
+// and a mex function (mglPrivateDotMotion) which is used to validate it against Matlab.
+
+// Coherent and incoherent motion types, named as in dotMotionFrame.
+// Matlab and mglMetal should share this header so that they agree on the codes.
+// These are plain enums so that the header also builds with gcc, and are kept in
+// the uint32_t fields of mglDotMotionParams so the size doesn't depend on the compiler.
+typedef enum mglDotMotionCoherentType {
+    mglDotMotionExpanding = 0,
+    mglDotMotionContracting = 1,
+    mglDotMotionTranslating = 2,
+    mglDotMotionRotating = 3
+} mglDotMotionCoherentType;
+
+typedef enum mglDotMotionIncoherentType {
+    mglDotMotionRandom = 0,
+    mglDotMotionBrownian = 1,
+    mglDotMotionMovshon = 2
+} mglDotMotionIncoherentType;
+
+#define MGL_DOT_MOTION_MAX_DIRECTIONS 8
+#define MGL_DOT_MOTION_VALUES_PER_DOT 11
+
+// The stimParams and displayParams fields that dotMotionFrame uses, along with how the dots look.
+typedef struct mglDotMotionParams {
+    double coherence;
+    uint32_t coherentMotionType;
+    uint32_t incoherentMotionType;
+    double speed;
+    double lifetime;
+    double origin[2];
+    uint32_t nDirections;
+    double direction[MGL_DOT_MOTION_MAX_DIRECTIONS];
+    double frameRate;
+    double deviceRect[4];
+    float color[4];
+    float dotSize[2];
+    float isRound;
+    float borderSize;
+} mglDotMotionParams;
+
+// Mersenne twister (mt19937) with the 53 bit doubles that Matlab's rand returns.
+#define MGL_MT_N 624
+#define MGL_MT_M 397
+typedef struct mglMersenneTwister {
+    uint32_t state[MGL_MT_N];
+    int index;
+} mglMersenneTwister;
+
+// Per-dot state, kept as separate arrays so that the motion loops vectorize.
+typedef struct mglDotMotionState {
+    uint32_t nDots;
+    int initialized;
+    double *x, *y, *direction, *lifetime;
+    double *dx, *dy;
+    uint8_t *dead;
+    mglMersenneTwister twister;
+} mglDotMotionState;
+
+static inline void mglMersenneTwisterSeed(mglMersenneTwister *mt, uint32_t seed) {
+    // Matlab uses the reference default seed for rng(0)
+    if (seed == 0) seed = 5489;
+    mt->state[0] = seed;
+    for (int i = 1; i < MGL_MT_N; i++) {
+        mt->state[i] = 1812433253U * (mt->state[i-1] ^ (mt->state[i-1] >> 30)) + (uint32_t)i;
+    }
+    mt->index = MGL_MT_N;
+}
+
+static inline uint32_t mglMersenneTwisterNextUInt32(mglMersenneTwister *mt) {
+    static const uint32_t mag01[2] = {0x0U, 0x9908b0dfU};
+    uint32_t y;
+    if (mt->index >= MGL_MT_N) {
+        int k;
+        for (k = 0; k < MGL_MT_N - MGL_MT_M; k++) {
+            y = (mt->state[k] & 0x80000000U) | (mt->state[k+1] & 0x7fffffffU);
+            mt->state[k] = mt->state[k+MGL_MT_M] ^ (y >> 1) ^ mag01[y & 0x1U];
+        }
+        for (; k < MGL_MT_N - 1; k++) {
+            y = (mt->state[k] & 0x80000000U) | (mt->state[k+1] & 0x7fffffffU);
+            mt->state[k] = mt->state[k+(MGL_MT_M-MGL_MT_N)] ^ (y >> 1) ^ mag01[y & 0x1U];
+        }
+        y = (mt->state[MGL_MT_N-1] & 0x80000000U) | (mt->state[0] & 0x7fffffffU);
+        mt->state[MGL_MT_N-1] = mt->state[MGL_MT_M-1] ^ (y >> 1) ^ mag01[y & 0x1U];
+        mt->index = 0;
+    }
+    y = mt->state[mt->index++];
+    y ^= (y >> 11);
+    y ^= (y << 7) & 0x9d2c5680U;
+    y ^= (y << 15) & 0xefc60000U;
+    y ^= (y >> 18);
+    return y;
+}
+
+static inline double mglMersenneTwisterNextDouble(mglMersenneTwister *mt) {
+    uint32_t a = mglMersenneTwisterNextUInt32(mt) >> 5;
+    uint32_t b = mglMersenneTwisterNextUInt32(mt) >> 6;
+    return (a * 67108864.0 + b) * (1.0 / 9007199254740992.0);
+}
+
+// Allocate state for nDots, which start uninitialized and get placed on the first frame.
+static inline int mglDotMotionCreate(mglDotMotionState *state, uint32_t nDots, uint32_t seed) {
+    memset(state, 0, sizeof(mglDotMotionState));
+    state->nDots = nDots;
+    size_t n = nDots > 0 ? nDots : 1;
+    state->x = (double *)calloc(n, sizeof(double));
+    state->y = (double *)calloc(n, sizeof(double));
+    state->direction = (double *)calloc(n, sizeof(double));
+    state->lifetime = (double *)calloc(n, sizeof(double));
+    state->dx = (double *)calloc(n, sizeof(double));
+    state->dy = (double *)calloc(n, sizeof(double));
+    state->dead = (uint8_t *)calloc(n, sizeof(uint8_t));
+    mglMersenneTwisterSeed(&state->twister, seed);
+    return state->x && state->y && state->direction && state->lifetime && state->dx && state->dy && state->dead;
+}
+
+static inline void mglDotMotionDestroy(mglDotMotionState *state) {
+    free(state->x);
+    free(state->y);
+    free(state->direction);
+    free(state->lifetime);
+    free(state->dx);
+    free(state->dy);
+    free(state->dead);
+    memset(state, 0, sizeof(mglDotMotionState));
+}
+
+// Advance the dots by one frame, the same as one call to dotMotionFrame with displayParams.
+static inline void mglDotMotionFrame(mglDotMotionState *state, const mglDotMotionParams *params) {
+    const uint32_t nDots = state->nDots;
+    double * restrict x = state->x;
+    double * restrict y = state->y;
+    double * restrict direction = state->direction;
+    double * restrict lifetime = state->lifetime;
+    double * restrict dx = state->dx;
+    double * restrict dy = state->dy;
+    uint8_t * restrict dead = state->dead;
+    mglMersenneTwister *mt = &state->twister;
+    const double twoPi = 2 * M_PI;
+
+    const double xrange = params->deviceRect[2] - params->deviceRect[0];
+    const double yrange = params->deviceRect[3] - params->deviceRect[1];
+    const double xoffs = params->deviceRect[0];
+    const double yoffs = params->deviceRect[1];
+    const double dist = params->speed / params->frameRate;
+
+    // Place the dots the first time through, drawing each column of random numbers in turn.
+    if (!state->initialized) {
+        for (uint32_t i = 0; i < nDots; i++) x[i] = xrange * (2 * mglMersenneTwisterNextDouble(mt) - 1);
+        for (uint32_t i = 0; i < nDots; i++) y[i] = yrange * (2 * mglMersenneTwisterNextDouble(mt) - 1);
+        for (uint32_t i = 0; i < nDots; i++) lifetime[i] = round(params->lifetime * mglMersenneTwisterNextDouble(mt));
+        for (uint32_t i = 0; i < nDots; i++) direction[i] = twoPi * mglMersenneTwisterNextDouble(mt);
+        state->initialized = 1;
+    }
+
+    // Find dots that have died or gone out of range (compared against the range, as dotMotionFrame does).
+    uint32_t nDead = 0;
+    for (uint32_t i = 0; i < nDots; i++) {
+        dx[i] = 0;
+        dy[i] = 0;
+        dead[i] = (lifetime[i] < 1) | (x[i] < xoffs) | (x[i] > xrange) | (y[i] < yoffs) | (y[i] > yrange);
+        nDead += dead[i];
+    }
+
+    // Reinitialize dead dots.
+    if (nDead > 0) {
+        for (uint32_t i = 0; i < nDots; i++) if (dead[i]) x[i] = xrange * mglMersenneTwisterNextDouble(mt) + xoffs;
+        for (uint32_t i = 0; i < nDots; i++) if (dead[i]) y[i] = yrange * mglMersenneTwisterNextDouble(mt) + yoffs;
+        for (uint32_t i = 0; i < nDots; i++) if (dead[i]) direction[i] = twoPi * mglMersenneTwisterNextDouble(mt);
+        for (uint32_t i = 0; i < nDots; i++) if (dead[i]) lifetime[i] = params->lifetime;
+    }
+
+    // The first nIncoherent dots move incoherently, the rest coherently.
+    const double incoherent = ceil((1 - params->coherence) * nDots);
+    const uint32_t nIncoherent = (incoherent < 0) ? 0 : ((incoherent > nDots) ? nDots : (uint32_t)incoherent);
+    const uint32_t nCoherent = nDots - nIncoherent;
+
+    if (params->coherence < 1) {
+        switch (params->incoherentMotionType) {
+            case mglDotMotionBrownian:
+                for (uint32_t i = 0; i < nIncoherent; i++) direction[i] = twoPi * mglMersenneTwisterNextDouble(mt);
+                // fall through to move in the new direction
+            case mglDotMotionRandom:
+                for (uint32_t i = 0; i < nIncoherent; i++) {
+                    dx[i] = dist * cos(direction[i]);
+                    dy[i] = dist * sin(direction[i]);
+                }
+                break;
+            case mglDotMotionMovshon:
+                for (uint32_t i = 0; i < nIncoherent; i++) x[i] = xrange * mglMersenneTwisterNextDouble(mt) + xoffs;
+                for (uint32_t i = 0; i < nIncoherent; i++) y[i] = yrange * mglMersenneTwisterNextDouble(mt) + yoffs;
+                break;
+        }
+    }
+
+    if (params->coherence > 0) {
+        switch (params->coherentMotionType) {
+            case mglDotMotionExpanding:
+                for (uint32_t i = nIncoherent; i < nDots; i++) {
+                    dx[i] = dist * (x[i] - params->origin[0]);
+                    dy[i] = dist * (y[i] - params->origin[1]);
+                }
+                break;
+            case mglDotMotionContracting:
+                for (uint32_t i = nIncoherent; i < nDots; i++) {
+                    dx[i] = -dist * (x[i] - params->origin[0]);
+                    dy[i] = -dist * (y[i] - params->origin[1]);
+                }
+                break;
+            case mglDotMotionTranslating: {
+                // Split the coherent dots evenly between the directions.
+                const uint32_t nDirections = params->nDirections;
+                const double nPerDirection = (double)nCoherent / nDirections;
+                for (uint32_t n = 0; n < nDirections; n++) {
+                    const uint32_t first = (uint32_t)floor(n * nPerDirection);
+                    const uint32_t last = (uint32_t)floor((n + 1) * nPerDirection);
+                    const double ddx = dist * cos(params->direction[n]);
+                    const double ddy = dist * sin(params->direction[n]);
+                    for (uint32_t i = nIncoherent + first; i < nIncoherent + last; i++) {
+                        dx[i] = ddx;
+                        dy[i] = ddy;
+                    }
+                }
+                break;
+            }
+            case mglDotMotionRotating:
+                // dotMotionFrame does not move rotating dots.
+                break;
+        }
+    }
+
+    // Add displacement and update lifetime.
+    for (uint32_t i = 0; i < nDots; i++) {
+        x[i] += dx[i];
+        y[i] += dy[i];
+        lifetime[i] -= 1;
+    }
+}
+
+// Pack the dots as vertices with 11 values each: [xyz rgba wh isRound borderSize], as mglMetalDots sends them.
+static inline void mglDotMotionPackVertices(const mglDotMotionState *state, const mglDotMotionParams *params, float *buffer) {
+    for (uint32_t i = 0; i < state->nDots; i++) {
+        float *vertex = buffer + MGL_DOT_MOTION_VALUES_PER_DOT * i;
+        vertex[0] = (float)state->x[i];
+        vertex[1] = (float)state->y[i];
+        vertex[2] = 0;
+        vertex[3] = params->color[0];
+        vertex[4] = params->color[1];
+        vertex[5] = params->color[2];
+        vertex[6] = params->color[3];
+        vertex[7] = params->dotSize[0];
+        vertex[8] = params->dotSize[1];
+        vertex[9] = params->isRound;
+        vertex[10] = params->borderSize;
+    }
+}
+
+#endif /* mglDotMotion_h */
@@ -0,0 +1,660 @@
+//
+//  mglFrameStream.h
+//  mglMetal
+//
+//  Created by justin gardner on 10/19/26.
+//  Copyright © 2026 GRU. All rights reserved.
+//
+
+#ifndef mglFrameStream_h
+#define mglFrameStream_h
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+
+// Precomputed stimulus movies, stored as a file of frames that are shown frame by frame, exactly.
+// Unlike movies played with AVPlayer, nothing is decoded with its own timing: the file is mapped into memory,
+// and a background thread copies the frames that will be shown next into a ring of buffers (which mglMetal
+// makes textures from), so that each frame is ready when the command to show it is drawn.
+//
+// The file is a header, then the frames, then an index with where each frame is. Each frame is the pixels,
+// rows top first, either as they are or run-length encoded, which is cheap to decode and makes frames with
+// large areas of the same color (like a gray background) much smaller.
+//
+// This is plain C with no Apple dependencies, so that the container and prefetching can be tested on their own
+// (see mgllib/mglBenchmark/mglBenchmarkFrameStream.c), and so that Matlab can write files with the same code.
+
+#define MGL_FRAME_STREAM_MAGIC "MGLFRMS1"
+#define MGL_FRAME_STREAM_VERSION 1
+// frames start on this many bytes, so that they can be read a whole cache line at a time
+#define MGL_FRAME_STREAM_ALIGNMENT 64
+#define MGL_FRAME_STREAM_MAX_SLOTS 64
+// top bit of the count of each run of an encoded frame, for a pixel repeated count times
+#define MGL_FRAME_STREAM_REPEAT 0x80000000u
+
+// How pixels are stored.
+typedef enum {
+    // rgba bytes, shown as 0-1
+    mglFrameStreamRGBA8 = 0,
+    // rgba floats, like textures made by mglCreateTexture
+    mglFrameStreamRGBA32Float = 1
+} mglFrameStreamPixelFormat;
+
+// How each frame is stored.
+typedef enum {
+    mglFrameStreamRaw = 0,
+    mglFrameStreamRunLength = 1
+} mglFrameStreamEncoding;
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t pixelFormat;
+    uint32_t width;
+    uint32_t height;
+    uint32_t frameCount;
+    uint32_t reserved;
+    double frameRate;
+    uint64_t indexOffset;
+} mglFrameStreamHeader;
+
+typedef struct {
+    uint64_t offset;
+    uint32_t bytes;
+    uint32_t encoding;
+} mglFrameStreamIndexEntry;
+
+// A file opened for reading, mapped into memory.
+typedef struct {
+    int fileDescriptor;
+    const uint8_t *map;
+    size_t mapBytes;
+    mglFrameStreamHeader header;
+    const mglFrameStreamIndexEntry *index;
+} mglFrameStream;
+
+// A file being written.
+typedef struct {
+    FILE *file;
+    mglFrameStreamHeader header;
+    mglFrameStreamIndexEntry *index;
+    uint32_t indexCapacity;
+    uint64_t offset;
+    int runLength;
+    uint8_t *encoded;
+} mglFrameStreamWriter;
+
+// Bytes of one pixel, or 0 for an unknown format.
+static inline uint32_t mglFrameStreamPixelBytes(uint32_t pixelFormat) {
+    switch (pixelFormat) {
+        case mglFrameStreamRGBA8: return 4;
+        case mglFrameStreamRGBA32Float: return 16;
+        default: return 0;
+    }
+}
+
+// Bytes of one frame, as it is decoded with rows next to each other.
+static inline size_t mglFrameStreamFrameBytes(const mglFrameStreamHeader *header) {
+    return (size_t)header->width * header->height * mglFrameStreamPixelBytes(header->pixelFormat);
+}
+
+//\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/
+// Run-length encoding
+//\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/
+
+// Encode pixelCount pixels as runs, each a uint32 count followed by one pixel to repeat count times
+// (with MGL_FRAME_STREAM_REPEAT set in count), or by count pixels as they are.
+// output needs room for mglFrameStreamRunLengthBound bytes. Returns the bytes of encoded output.
+static inline size_t mglFrameStreamRunLengthBound(size_t pixelCount, uint32_t pixelBytes) {
+    return pixelCount * pixelBytes + ((pixelCount + 1) / 2 + 1) * sizeof(uint32_t);
+}
+
+static inline size_t mglFrameStreamRunLengthEncode(const uint8_t *pixels, size_t pixelCount, uint32_t pixelBytes, uint8_t *output) {
+    size_t outputBytes = 0;
+    size_t i = 0;
+    while (i < pixelCount) {
+        // how many times this pixel repeats
+        size_t repeat = 1;
+        while ((i + repeat < pixelCount) && (repeat < MGL_FRAME_STREAM_REPEAT - 1) &&
+               (memcmp(pixels + (i + repeat) * pixelBytes, pixels + i * pixelBytes, pixelBytes) == 0)) {
+            repeat++;
+        }
+        if (repeat >= 3) {
+            uint32_t count = (uint32_t)repeat | MGL_FRAME_STREAM_REPEAT;
+            memcpy(output + outputBytes, &count, sizeof(count));
+            memcpy(output + outputBytes + sizeof(count), pixels + i * pixelBytes, pixelBytes);
+            outputBytes += sizeof(count) + pixelBytes;
+            i += repeat;
+            continue;
+        }
+
+        // pixels as they are, up to where a run of 3 starts
+        size_t literal = 0;
+        while ((i + literal < pixelCount) && (literal < MGL_FRAME_STREAM_REPEAT - 1)) {
+            const uint8_t *pixel = pixels + (i + literal) * pixelBytes;
+            if ((i + literal + 2 < pixelCount) && (memcmp(pixel, pixel + pixelBytes, pixelBytes) == 0) && (memcmp(pixel, pixel + 2 * pixelBytes, pixelBytes) == 0)) {
+                break;
+            }
+            literal++;
+        }
+        uint32_t count = (uint32_t)literal;
+        memcpy(output + outputBytes, &count, sizeof(count));
+        memcpy(output + outputBytes + sizeof(count), pixels + i * pixelBytes, literal * pixelBytes);
+        outputBytes += sizeof(count) + literal * pixelBytes;
+        i += literal;
+    }
+    return outputBytes;
+}
+
+// Decode runs into rows of width pixels, bytesPerRow apart. Returns 0 if the runs don't make exactly the frame.
+static inline int mglFrameStreamRunLengthDecode(const uint8_t *input, size_t inputBytes, uint32_t pixelBytes, uint32_t width, uint32_t height, uint8_t *output, size_t bytesPerRow) {
+    size_t pixelCount = (size_t)width * height;
+    size_t pixel = 0;
+    size_t used = 0;
+    uint32_t row = 0, column = 0;
+    while (used < inputBytes) {
+        uint32_t count;
+        if (inputBytes - used < sizeof(count)) {
+            return 0;
+        }
+        memcpy(&count, input + used, sizeof(count));
+        used += sizeof(count);
+        int isRepeat = (count & MGL_FRAME_STREAM_REPEAT) != 0;
+        count &= ~MGL_FRAME_STREAM_REPEAT;
+        size_t runBytes = isRepeat ? pixelBytes : (size_t)count * pixelBytes;
+        if ((count > pixelCount - pixel) || (inputBytes - used < runBytes)) {
+            return 0;
+        }
+        const uint8_t *run = input + used;
+        used += runBytes;
+        pixel += count;
+
+        // write the run a row at a time
+        while (count > 0) {
+            uint32_t inRow = (count < width - column) ? count : width - column;
+            uint8_t *out = output + row * bytesPerRow + (size_t)column * pixelBytes;
+            if (isRepeat) {
+                for (uint32_t i = 0; i < inRow; i++) {
+                    memcpy(out + (size_t)i * pixelBytes, run, pixelBytes);
+                }
+            } else {
+                memcpy(out, run, (size_t)inRow * pixelBytes);
+                run += (size_t)inRow * pixelBytes;
+            }
+            count -= inRow;
+            column += inRow;
+            if (column == width) {
+                column = 0;
+                row++;
+            }
+        }
+    }
+    return pixel == pixelCount;
+}
+
+//\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/
+// Reading
+//\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/
+
+// Map a file and check its header and index. Returns 1, or 0 if it can't be read or is not a whole frame stream.
+static inline int mglFrameStreamMap(mglFrameStream *stream, const char *path) {
+    memset(stream, 0, sizeof(*stream));
+    stream->fileDescriptor = open(path, O_RDONLY);
+    if (stream->fileDescriptor < 0) {
+        return 0;
+    }
+    struct stat fileStat;
+    if ((fstat(stream->fileDescriptor, &fileStat) != 0) || ((size_t)fileStat.st_size < sizeof(mglFrameStreamHeader))) {
+        close(stream->fileDescriptor);
+        stream->fileDescriptor = -1;
+        return 0;
+    }
+    stream->mapBytes = (size_t)fileStat.st_size;
+    void *map = mmap(NULL, stream->mapBytes, PROT_READ, MAP_SHARED, stream->fileDescriptor, 0);
+    if (map == MAP_FAILED) {
+        close(stream->fileDescriptor);
+        stream->fileDescriptor = -1;
+        return 0;
+    }
+    stream->map = (const uint8_t *)map;
+    memcpy(&stream->header, stream->map, sizeof(mglFrameStreamHeader));
+
+    // check the header, and that the index and every frame are in the file
+    const mglFrameStreamHeader *header = &stream->header;
+    size_t frameBytes = mglFrameStreamFrameBytes(header);
+    int valid = (memcmp(header->magic, MGL_FRAME_STREAM_MAGIC, sizeof(header->magic)) == 0) &&
+        (header->version == MGL_FRAME_STREAM_VERSION) && (frameBytes > 0) &&
+        (header->indexOffset <= stream->mapBytes) &&
+        ((stream->mapBytes - header->indexOffset) / sizeof(mglFrameStreamIndexEntry) >= header->frameCount) &&
+        (header->indexOffset % sizeof(uint64_t) == 0);
+    if (valid) {
+        stream->index = (const mglFrameStreamIndexEntry *)(stream->map + header->indexOffset);
+        for (uint32_t frame = 0; valid && (frame < header->frameCount); frame++) {
+            const mglFrameStreamIndexEntry *entry = &stream->index[frame];
+            valid = (entry->offset <= stream->mapBytes) && (entry->bytes <= stream->mapBytes - entry->offset) &&
+                (((entry->encoding == mglFrameStreamRaw) && (entry->bytes == frameBytes)) || (entry->encoding == mglFrameStreamRunLength));
+        }
+    }
+    if (!valid) {
+        munmap((void *)stream->map, stream->mapBytes);
+        close(stream->fileDescriptor);
+        memset(stream, 0, sizeof(*stream));
+        stream->fileDescriptor = -1;
+        return 0;
+    }
+    return 1;
+}
+
+static inline void mglFrameStreamUnmap(mglFrameStream *stream) {
+    if (stream->map != NULL) {
+        munmap((void *)stream->map, stream->mapBytes);
+    }
+    if (stream->fileDescriptor >= 0) {
+        close(stream->fileDescriptor);
+    }
+    memset(stream, 0, sizeof(*stream));
+    stream->fileDescriptor = -1;
+}
+
+// Ask the system to start reading frames from disk, if they are not already in memory.
+static inline void mglFrameStreamWillNeed(const mglFrameStream *stream, uint32_t firstFrame, uint32_t frameCount) {
+    if (firstFrame >= stream->header.frameCount) {
+        return;
+    }
+    if (frameCount > stream->header.frameCount - firstFrame) {
+        frameCount = stream->header.frameCount - firstFrame;
+    }
+    if (frameCount == 0) {
+        return;
+    }
+    const mglFrameStreamIndexEntry *first = &stream->index[firstFrame];
+    const mglFrameStreamIndexEntry *last = &stream->index[firstFrame + frameCount - 1];
+    if (last->offset + last->bytes <= first->offset) {
+        return;
+    }
+    // madvise wants whole pages
+    uintptr_t pageBytes = (uintptr_t)sysconf(_SC_PAGESIZE);
+    uintptr_t start = ((uintptr_t)(stream->map + first->offset)) & ~(pageBytes - 1);
+    uintptr_t end = (uintptr_t)(stream->map + last->offset + last->bytes);
+    madvise((void *)start, end - start, MADV_WILLNEED);
+}
+
+// Decode a frame into rows bytesPerRow apart (at least width times the pixel bytes). Returns 1, or 0 on error.
+static inline int mglFrameStreamDecode(const mglFrameStream *stream, uint32_t frame, void *output, size_t bytesPerRow) {
+    const mglFrameStreamHeader *header = &stream->header;
+    uint32_t pixelBytes = mglFrameStreamPixelBytes(header->pixelFormat);
+    size_t rowBytes = (size_t)header->width * pixelBytes;
+    if ((frame >= header->frameCount) || (bytesPerRow < rowBytes)) {
+        return 0;
+    }
+    const mglFrameStreamIndexEntry *entry = &stream->index[frame];
+    const uint8_t *input = stream->map + entry->offset;
+    if (entry->encoding == mglFrameStreamRunLength) {
+        return mglFrameStreamRunLengthDecode(input, entry->bytes, pixelBytes, header->width, header->height, (uint8_t *)output, bytesPerRow);
+    }
+    if (bytesPerRow == rowBytes) {
+        memcpy(output, input, rowBytes * header->height);
+    } else {
+        for (uint32_t row = 0; row < header->height; row++) {
+            memcpy((uint8_t *)output + row * bytesPerRow, input + row * rowBytes, rowBytes);
+        }
+    }
+    return 1;
+}
+
+//\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/
+// Writing
+//\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/
+
+// Start a file of width x height frames. With runLength, frames are encoded when that makes them smaller.
+// Returns 1, or 0 if the file can't be made, in which case there is nothing to close.
+static inline int mglFrameStreamWriterOpen(mglFrameStreamWriter *writer, const char *path, uint32_t width, uint32_t height, uint32_t pixelFormat, double frameRate, int runLength) {
+    memset(writer, 0, sizeof(*writer));
+    if ((width == 0) || (height == 0) || (mglFrameStreamPixelBytes(pixelFormat) == 0)) {
+        return 0;
+    }
+    memcpy(writer->header.magic, MGL_FRAME_STREAM_MAGIC, sizeof(writer->header.magic));
+    writer->header.version = MGL_FRAME_STREAM_VERSION;
+    writer->header.pixelFormat = pixelFormat;
+    writer->header.width = width;
+    writer->header.height = height;
+    writer->header.frameRate = frameRate;
+    writer->runLength = runLength;
+    if (runLength) {
+        writer->encoded = (uint8_t *)malloc(mglFrameStreamRunLengthBound((size_t)width * height, mglFrameStreamPixelBytes(pixelFormat)));
+        if (writer->encoded == NULL) {
+            return 0;
+        }
+    }
+    writer->file = fopen(path, "wb");
+    if (writer->file == NULL) {
+        free(writer->encoded);
+        writer->encoded = NULL;
+        return 0;
+    }
+    // the header is written again with the frame count and index when the file is closed
+    writer->offset = sizeof(mglFrameStreamHeader);
+    if (fwrite(&writer->header, sizeof(mglFrameStreamHeader), 1, writer->file) != 1) {
+        fclose(writer->file);
+        free(writer->encoded);
+        memset(writer, 0, sizeof(*writer));
+        return 0;
+    }
+    return 1;
+}
+
+// Pad the file out to a multiple of alignment bytes.
+static inline int mglFrameStreamWriterAlign(mglFrameStreamWriter *writer, uint64_t alignment) {
+    static const uint8_t zeros[MGL_FRAME_STREAM_ALIGNMENT] = {0};
+    uint64_t padding = (alignment - writer->offset % alignment) % alignment;
+    if ((padding > 0) && (fwrite(zeros, 1, padding, writer->file) != padding)) {
+        return 0;
+    }
+    writer->offset += padding;
+    return 1;
+}
+
+// Add a frame of rows next to each other, top row first. Returns 1, or 0 if it could not be written.
+static inline int mglFrameStreamWriterAdd(mglFrameStreamWriter *writer, const void *pixels) {
+    if (writer->header.frameCount == writer->indexCapacity) {
+        uint32_t newCapacity = writer->indexCapacity ? 2 * writer->indexCapacity : 256;
+        mglFrameStreamIndexEntry *newIndex = (mglFrameStreamIndexEntry *)realloc(writer->index, newCapacity * sizeof(mglFrameStreamIndexEntry));
+        if (newIndex == NULL) {
+            return 0;
+        }
+        writer->index = newIndex;
+        writer->indexCapacity = newCapacity;
+    }
+    if (!mglFrameStreamWriterAlign(writer, MGL_FRAME_STREAM_ALIGNMENT)) {
+        return 0;
+    }
+
+    size_t frameBytes = mglFrameStreamFrameBytes(&writer->header);
+    const void *data = pixels;
+    size_t dataBytes = frameBytes;
+    uint32_t encoding = mglFrameStreamRaw;
+    if (writer->runLength) {
+        size_t encodedBytes = mglFrameStreamRunLengthEncode((const uint8_t *)pixels, (size_t)writer->header.width * writer->header.height, mglFrameStreamPixelBytes(writer->header.pixelFormat), writer->encoded);
+        if (encodedBytes < frameBytes) {
+            data = writer->encoded;
+            dataBytes = encodedBytes;
+            encoding = mglFrameStreamRunLength;
+        }
+    }
+    if ((dataBytes > UINT32_MAX) || (fwrite(data, 1, dataBytes, writer->file) != dataBytes)) {
+        return 0;
+    }
+    mglFrameStreamIndexEntry *entry = &writer->index[writer->header.frameCount++];
+    entry->offset = writer->offset;
+    entry->bytes = (uint32_t)dataBytes;
+    entry->encoding = encoding;
+    writer->offset += dataBytes;
+    return 1;
+}
+
+// Write the index and the finished header, and close the file. Returns 1, or 0 if any of it could not be written.
+static inline int mglFrameStreamWriterClose(mglFrameStreamWriter *writer) {
+    int written = (writer->file != NULL) && mglFrameStreamWriterAlign(writer, sizeof(uint64_t));
+    if (written) {
+        writer->header.indexOffset = writer->offset;
+        written = (fwrite(writer->index, sizeof(mglFrameStreamIndexEntry), writer->header.frameCount, writer->file) == writer->header.frameCount) &&
+            (fseek(writer->file, 0, SEEK_SET) == 0) &&
+            (fwrite(&writer->header, sizeof(mglFrameStreamHeader), 1, writer->file) == 1);
+    }
+    if ((writer->file != NULL) && (fclose(writer->file) != 0)) {
+        written = 0;
+    }
+    free(writer->index);
+    free(writer->encoded);
+    memset(writer, 0, sizeof(*writer));
+    return written;
+}
+
+//\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/
+// Prefetching
+//\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/
+
+typedef enum {
+    mglFrameStreamSlotEmpty = 0,
+    mglFrameStreamSlotDecoding = 1,
+    mglFrameStreamSlotReady = 2,
+    // the frame could not be decoded, and is kept so it is not tried again and again
+    mglFrameStreamSlotFailed = 3
+} mglFrameStreamSlotState;
+
+// A ring of slots that a background thread keeps filled with the frames from the one asked for onward.
+// Slots are memory the caller gives, for mglMetal the contents of the buffers its textures are made from.
+// Frames that are acquired stay in their slot until they are released, so they can be shown while
+// the thread goes on filling other slots.
+typedef struct {
+    const mglFrameStream *stream;
+    uint32_t slotCount;
+    void *slots[MGL_FRAME_STREAM_MAX_SLOTS];
+    size_t bytesPerRow;
+    int64_t slotFrames[MGL_FRAME_STREAM_MAX_SLOTS];
+    int slotStates[MGL_FRAME_STREAM_MAX_SLOTS];
+    uint32_t slotHolds[MGL_FRAME_STREAM_MAX_SLOTS];
+    // frames wanted in slots, from firstWanted for as many as there are slots
+    uint32_t firstWanted;
+    int running;
+    int stopping;
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    // counts for checking that frames were ready in time
+    uint64_t decodedCount;
+    uint64_t readyCount;
+    uint64_t waitedCount;
+    uint64_t failedCount;
+} mglFrameStreamPrefetcher;
+
+// Which slot has a frame, in any state but empty, or -1. Call with the mutex locked.
+static inline int mglFrameStreamFindSlot(const mglFrameStreamPrefetcher *prefetcher, int64_t frame) {
+    for (uint32_t slot = 0; slot < prefetcher->slotCount; slot++) {
+        if ((prefetcher->slotStates[slot] != mglFrameStreamSlotEmpty) && (prefetcher->slotFrames[slot] == frame)) {
+            return (int)slot;
+        }
+    }
+    return -1;
+}
+
+// Choose a slot to decode a wanted frame into: an empty one, or else the decoded one that is not held, and
+// furthest from being wanted, so frames already passed go first, then the ones furthest ahead. Frames wanted
+// before this one are kept, so with slots held there may be none. Call with the mutex locked. Returns -1 if none.
+static inline int mglFrameStreamChooseSlot(const mglFrameStreamPrefetcher *prefetcher, uint32_t wantedFrame) {
+    int chosen = -1;
+    int64_t chosenDistance = -1;
+    for (uint32_t slot = 0; slot < prefetcher->slotCount; slot++) {
+        if (prefetcher->slotStates[slot] == mglFrameStreamSlotEmpty) {
+            return (int)slot;
+        }
+        if ((prefetcher->slotStates[slot] == mglFrameStreamSlotDecoding) || (prefetcher->slotHolds[slot] > 0)) {
+            continue;
+        }
+        int64_t frame = prefetcher->slotFrames[slot];
+        int64_t distance;
+        if (frame < (int64_t)prefetcher->firstWanted) {
+            distance = (int64_t)UINT32_MAX + prefetcher->firstWanted - frame;
+        } else if (frame > (int64_t)wantedFrame) {
+            distance = frame - wantedFrame;
+        } else {
+            continue;
+        }
+        if (distance > chosenDistance) {
+            chosen = (int)slot;
+            chosenDistance = distance;
+        }
+    }
+    return chosen;
+}
+
+static inline void *mglFrameStreamPrefetchThread(void *arg) {
+    mglFrameStreamPrefetcher *prefetcher = (mglFrameStreamPrefetcher *)arg;
+    const mglFrameStream *stream = prefetcher->stream;
+    pthread_mutex_lock(&prefetcher->mutex);
+    uint32_t lastAdvised = UINT32_MAX;
+    while (!prefetcher->stopping) {
+        // the next wanted frame that is not in a slot yet
+        uint32_t frameCount = stream->header.frameCount;
+        uint32_t lastWanted = prefetcher->firstWanted + prefetcher->slotCount - 1;
+        if ((lastWanted >= frameCount) || (lastWanted < prefetcher->firstWanted)) {
+            lastWanted = frameCount - 1;
+        }
+        int64_t frame = -1;
+        for (uint32_t wanted = prefetcher->firstWanted; (wanted < frameCount) && (wanted <= lastWanted); wanted++) {
+            if (mglFrameStreamFindSlot(prefetcher, wanted) < 0) {
+                frame = wanted;
+                break;
+            }
+        }
+        int slot = (frame >= 0) ? mglFrameStreamChooseSlot(prefetcher, (uint32_t)frame) : -1;
+        if (slot < 0) {
+            pthread_cond_wait(&prefetcher->cond, &prefetcher->mutex);
+            continue;
+        }
+
+        // let the system start reading the wanted frames when they change
+        if (prefetcher->firstWanted != lastAdvised) {
+            lastAdvised = prefetcher->firstWanted;
+            mglFrameStreamWillNeed(stream, prefetcher->firstWanted, prefetcher->slotCount);
+        }
+
+        // decode without the lock, so frames can be acquired meanwhile
+        prefetcher->slotStates[slot] = mglFrameStreamSlotDecoding;
+        prefetcher->slotFrames[slot] = frame;
+        pthread_mutex_unlock(&prefetcher->mutex);
+        int decoded = mglFrameStreamDecode(stream, (uint32_t)frame, prefetcher->slots[slot], prefetcher->bytesPerRow);
+        pthread_mutex_lock(&prefetcher->mutex);
+        if (decoded) {
+            prefetcher->slotStates[slot] = mglFrameStreamSlotReady;
+            prefetcher->decodedCount++;
+        } else {
+            // so acquiring a broken frame fails, rather than waiting for it forever
+            prefetcher->slotStates[slot] = mglFrameStreamSlotFailed;
+            prefetcher->failedCount++;
+        }
+        pthread_cond_broadcast(&prefetcher->cond);
+    }
+    pthread_mutex_unlock(&prefetcher->mutex);
+    return NULL;
+}
+
+// Start filling slotCount slots of bytesPerRow rows from frame 0. Returns 1, or 0 if the thread can't start.
+static inline int mglFrameStreamPrefetcherStart(mglFrameStreamPrefetcher *prefetcher, const mglFrameStream *stream, void *const *slots, uint32_t slotCount, size_t bytesPerRow) {
+    memset(prefetcher, 0, sizeof(*prefetcher));
+    if ((slotCount == 0) || (slotCount > MGL_FRAME_STREAM_MAX_SLOTS) || (stream->header.frameCount == 0)) {
+        return 0;
+    }
+    prefetcher->stream = stream;
+    prefetcher->slotCount = slotCount;
+    prefetcher->bytesPerRow = bytesPerRow;
+    for (uint32_t slot = 0; slot < slotCount; slot++) {
+        prefetcher->slots[slot] = slots[slot];
+        prefetcher->slotFrames[slot] = -1;
+    }
+    pthread_mutex_init(&prefetcher->mutex, NULL);
+    pthread_cond_init(&prefetcher->cond, NULL);
+    if (pthread_create(&prefetcher->thread, NULL, mglFrameStreamPrefetchThread, prefetcher) != 0) {
+        pthread_mutex_destroy(&prefetcher->mutex);
+        pthread_cond_destroy(&prefetcher->cond);
+        return 0;
+    }
+    prefetcher->running = 1;
+    return 1;
+}
+
+static inline void mglFrameStreamPrefetcherStop(mglFrameStreamPrefetcher *prefetcher) {
+    if (!prefetcher->running) {
+        return;
+    }
+    pthread_mutex_lock(&prefetcher->mutex);
+    prefetcher->stopping = 1;
+    pthread_cond_broadcast(&prefetcher->cond);
+    pthread_mutex_unlock(&prefetcher->mutex);
+    pthread_join(prefetcher->thread, NULL);
+    pthread_mutex_destroy(&prefetcher->mutex);
+    pthread_cond_destroy(&prefetcher->cond);
+    prefetcher->running = 0;
+}
+
+// Say that frames from firstFrame on will be wanted next, so the thread starts on them now.
+static inline void mglFrameStreamPrefetch(mglFrameStreamPrefetcher *prefetcher, uint32_t firstFrame) {
+    pthread_mutex_lock(&prefetcher->mutex);
+    if (prefetcher->firstWanted != firstFrame) {
+        prefetcher->firstWanted = firstFrame;
+        pthread_cond_broadcast(&prefetcher->cond);
+    }
+    pthread_mutex_unlock(&prefetcher->mutex);
+}
+
+// Get the slot with a frame, waiting up to timeoutSecs for it to be decoded, and hold it until it is released.
+// Frames from this one on are wanted next. Returns the slot, or -1 if the frame does not exist, could not be
+// decoded, or was not ready in time. waitedSecs is how long it waited, 0 when the frame was ready already.
+static inline int mglFrameStreamAcquire(mglFrameStreamPrefetcher *prefetcher, uint32_t frame, double timeoutSecs, double *waitedSecs) {
+    *waitedSecs = 0;
+    if (frame >= prefetcher->stream->header.frameCount) {
+        return -1;
+    }
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    double deadlineSecs = (double)now.tv_sec + now.tv_usec * 1e-6 + timeoutSecs;
+    struct timespec deadline;
+    deadline.tv_sec = (time_t)deadlineSecs;
+    deadline.tv_nsec = (long)((deadlineSecs - (double)deadline.tv_sec) * 1e9);
+
+    pthread_mutex_lock(&prefetcher->mutex);
+    if (prefetcher->firstWanted != frame) {
+        prefetcher->firstWanted = frame;
+        pthread_cond_broadcast(&prefetcher->cond);
+    }
+    int slot = mglFrameStreamFindSlot(prefetcher, frame);
+    int waited = 0;
+    int timedOut = 0;
+    while (((slot < 0) || (prefetcher->slotStates[slot] == mglFrameStreamSlotDecoding)) && !timedOut) {
+        waited = 1;
+        timedOut = (pthread_cond_timedwait(&prefetcher->cond, &prefetcher->mutex, &deadline) == ETIMEDOUT);
+        slot = mglFrameStreamFindSlot(prefetcher, frame);
+    }
+    if ((slot >= 0) && (prefetcher->slotStates[slot] == mglFrameStreamSlotReady)) {
+        prefetcher->slotHolds[slot]++;
+        if (waited) {
+            prefetcher->waitedCount++;
+        } else {
+            prefetcher->readyCount++;
+        }
+    } else {
+        slot = -1;
+    }
+    pthread_mutex_unlock(&prefetcher->mutex);
+
+    if (waited) {
+        struct timespec end;
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        *waitedSecs = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) * 1e-9;
+    }
+    return slot;
+}
+
+// Let a slot be filled again.
+static inline void mglFrameStreamRelease(mglFrameStreamPrefetcher *prefetcher, int slot) {
+    pthread_mutex_lock(&prefetcher->mutex);
+    if ((slot >= 0) && ((uint32_t)slot < prefetcher->slotCount) && (prefetcher->slotHolds[slot] > 0)) {
+        prefetcher->slotHolds[slot]--;
+        pthread_cond_broadcast(&prefetcher->cond);
+    }
+    pthread_mutex_unlock(&prefetcher->mutex);
+}
+
+#endif /* mglFrameStream_h */
@@ -0,0 +1,141 @@
+//
+//  mglFrameStreamTextures.swift
+//  mglMetal
+//
+//  Created by justin gardner on 10/19/26.
+//  Copyright © 2026 GRU. All rights reserved.
+//
+
+import Foundation
+import MetalKit
+
+/*
+ mglFrameStreamTextures shows a file of precomputed frames (see mglFrameStream.h), one exact frame per command.
+ The file is mapped into memory, and a background thread decodes the frames that are wanted next into a ring of
+ buffers, each with a texture made from it, so that showing a frame copies nothing on the render thread.
+ A frame acquired for drawing keeps its buffer until the GPU is done with it, two frames later.
+ */
+class mglFrameStreamTextures {
+    let width: UInt32
+    let height: UInt32
+    let frameCount: UInt32
+    let frameRate: Double
+
+    // The C structs are allocated here so that they never move, since the background thread points at them.
+    private let stream: UnsafeMutablePointer<mglFrameStream>
+    private let prefetcher: UnsafeMutablePointer<mglFrameStreamPrefetcher>
+    private var prefetching = false
+    private var buffers: [MTLBuffer] = []
+    private var textures: [MTLTexture] = []
+
+    // Slots acquired for drawing, and the frame count when each was drawn.
+    private var held: [(slot: Int32, drawnInFrame: UInt64)] = []
+
+    // Frames that were not ready in time, and the longest wait for one that was.
+    private(set) var missedCount = UInt32(0)
+    private(set) var maxWaitSecs = 0.0
+
+    init?(path: String, slotCount: Int, device: MTLDevice, logger: mglLogger) {
+        stream = UnsafeMutablePointer<mglFrameStream>.allocate(capacity: 1)
+        prefetcher = UnsafeMutablePointer<mglFrameStreamPrefetcher>.allocate(capacity: 1)
+        if mglFrameStreamMap(stream, path) == 0 {
+            logger.error(component: "mglFrameStreamTextures", details: "Could not open \(path) as a frame stream.")
+            stream.deallocate()
+            prefetcher.deallocate()
+            return nil
+        }
+        let header = stream.pointee.header
+        width = header.width
+        height = header.height
+        frameCount = header.frameCount
+        frameRate = header.frameRate
+        // From here on everything is initialized, so returning nil runs deinit, which closes the stream.
+
+        // Textures made from buffers need rows aligned for the device.
+        let pixelFormat: MTLPixelFormat = header.pixelFormat == UInt32(mglFrameStreamRGBA32Float.rawValue) ? .rgba32Float : .rgba8Unorm
+        let rowBytes = Int(width) * Int(mglFrameStreamPixelBytes(header.pixelFormat))
+        let alignment = device.minimumLinearTextureAlignment(for: pixelFormat)
+        let bytesPerRow = ((rowBytes + alignment - 1) / alignment) * alignment
+        let textureDescriptor = MTLTextureDescriptor.texture2DDescriptor(
+            pixelFormat: pixelFormat,
+            width: Int(width),
+            height: Int(height),
+            mipmapped: false)
+        textureDescriptor.storageMode = .managed
+        textureDescriptor.usage = .shaderRead
+
+        // With two frames held by the GPU, fewer than three slots would leave none to fill.
+        let slots = min(max(slotCount, 3), Int(MGL_FRAME_STREAM_MAX_SLOTS))
+        for _ in 0 ..< slots {
+            guard let buffer = device.makeBuffer(length: bytesPerRow * Int(height), options: .storageModeManaged),
+                  let texture = buffer.makeTexture(descriptor: textureDescriptor, offset: 0, bytesPerRow: bytesPerRow) else {
+                logger.error(component: "mglFrameStreamTextures", details: "Could not make \(slots) textures of \(width)x\(height) for \(path).")
+                return nil
+            }
+            buffers.append(buffer)
+            textures.append(texture)
+        }
+        let slotPointers: [UnsafeMutableRawPointer?] = buffers.map { $0.contents() }
+        if mglFrameStreamPrefetcherStart(prefetcher, stream, slotPointers, UInt32(slots), bytesPerRow) == 0 {
+            logger.error(component: "mglFrameStreamTextures", details: "Could not start prefetching frames of \(path).")
+            return nil
+        }
+        prefetching = true
+        logger.info(component: "mglFrameStreamTextures", details: "Opened \(frameCount) frames of \(width)x\(height) from \(path) with \(slots) slots.")
+    }
+
+    deinit {
+        // Stop the thread before the buffers it writes into go away.
+        if prefetching {
+            mglFrameStreamPrefetcherStop(prefetcher)
+        }
+        mglFrameStreamUnmap(stream)
+        stream.deallocate()
+        prefetcher.deallocate()
+    }
+
+    // Let slots go that the GPU is done with. Commands for a frame are only taken after the
+    // previous frame is done on the GPU, so anything drawn two or more frames ago is free.
+    func releaseFinished(currentFrame: UInt64) {
+        held.removeAll { hold in
+            if hold.drawnInFrame + 2 <= currentFrame {
+                mglFrameStreamRelease(prefetcher, hold.slot)
+                return true
+            }
+            return false
+        }
+    }
+
+    // Start decoding from a frame, ahead of acquiring it.
+    func prefetch(frame: UInt32) {
+        mglFrameStreamPrefetch(prefetcher, frame)
+    }
+
+    // Get the texture with a frame to draw in currentFrame, waiting up to timeoutSecs for it to be decoded.
+    // Returns nil if the frame does not exist, or was not ready in time.
+    func acquire(frame: UInt32, currentFrame: UInt64, timeoutSecs: Double) -> MTLTexture? {
+        releaseFinished(currentFrame: currentFrame)
+        var waitedSecs = 0.0
+        let slot = mglFrameStreamAcquire(prefetcher, frame, timeoutSecs, &waitedSecs)
+        if slot < 0 {
+            missedCount += 1
+            return nil
+        }
+        maxWaitSecs = max(maxWaitSecs, waitedSecs)
+        held.append((slot: slot, drawnInFrame: currentFrame))
+
+        // With storageModeManaged, we must explicitly sync the decoded frame to the GPU.
+        let buffer = buffers[Int(slot)]
+        buffer.didModifyRange(0 ..< buffer.length)
+        return textures[Int(slot)]
+    }
+
+    // Frames that were ready when acquired, and frames that had to be waited for.
+    var readyCount: UInt32 {
+        return UInt32(truncatingIfNeeded: prefetcher.pointee.readyCount)
+    }
+
+    var waitedCount: UInt32 {
+        return UInt32(truncatingIfNeeded: prefetcher.pointee.waitedCount)
+    }
+}
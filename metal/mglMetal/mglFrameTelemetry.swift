@@ -0,0 +1,118 @@
+//
+//  mglFrameTelemetry.swift
+//  mglMetal
+//
+//  Created by justin gardner on 10/19/26.
+//  Copyright © 2026 GRU. All rights reserved.
+//
+
+import Foundation
+
+// Timing of one onscreen frame, from the display tick it was meant for to when it was presented.
+// All times are in seconds on the same clock as mglSecs and mglGetSecs.
+struct mglFrameTelemetryRecord {
+    // Frames are numbered from 1 in the order they were committed.
+    var frameNumber: UInt64 = 0
+
+    // When the display link wanted the frame to be presented (the vsync target), or 0 if not known.
+    var targetTime: Double = 0.0
+
+    // When the drawable was acquired and when the frame was committed to the GPU.
+    var drawableAcquired: Double = 0.0
+    var committed: Double = 0.0
+
+    // When the GPU started and finished the frame's work, or 0 if not finished yet.
+    var gpuStart: Double = 0.0
+    var gpuEnd: Double = 0.0
+
+    // When the frame was presented, following presentedTimeHolder: -1 if not known yet, 0 if the frame was dropped.
+    var presented: Double = -1.0
+
+    // The fields in the order they are reported to the client.
+    static let fieldCount = 7
+    var fields: [Double] {
+        return [Double(frameNumber), targetTime, drawableAcquired, committed, gpuStart, gpuEnd, presented]
+    }
+}
+
+/*
+ mglFrameTelemetry keeps a record of every onscreen frame in a fixed-size ring buffer,
+ so that the client can check for dropped and late frames during a run without asking about each frame.
+
+ The renderer starts a record when it commits a frame, and system callbacks on other threads fill in
+ GPU and presented times later, so records are guarded by a lock.
+ Once the buffer is full, each new frame overwrites the oldest record.
+ A callback that comes after its record was overwritten is ignored.
+ */
+class mglFrameTelemetry {
+    let capacity: Int
+    private var records: [mglFrameTelemetryRecord]
+    private var lastFrameNumber: UInt64 = 0
+    private let lock = NSLock()
+
+    // 8192 frames is a bit over a minute at 120Hz.
+    init(capacity: Int = 8192) {
+        self.capacity = capacity
+        records = Array(repeating: mglFrameTelemetryRecord(), count: capacity)
+    }
+
+    // How many frames have been recorded in all, including ones that have since been overwritten.
+    var frameCount: UInt64 {
+        lock.lock()
+        defer { lock.unlock() }
+        return lastFrameNumber
+    }
+
+    // Start a record for a frame that is about to be committed, returning its frame number.
+    func commitFrame(targetTime: Double, drawableAcquired: Double, committed: Double) -> UInt64 {
+        lock.lock()
+        defer { lock.unlock() }
+        lastFrameNumber += 1
+        records[slot(lastFrameNumber)] = mglFrameTelemetryRecord(
+            frameNumber: lastFrameNumber,
+            targetTime: targetTime,
+            drawableAcquired: drawableAcquired,
+            committed: committed)
+        return lastFrameNumber
+    }
+
+    // Fill in when the GPU did the frame's work.
+    func setGpuTimes(frameNumber: UInt64, gpuStart: Double, gpuEnd: Double) {
+        update(frameNumber: frameNumber) { record in
+            record.gpuStart = gpuStart
+            record.gpuEnd = gpuEnd
+        }
+    }
+
+    // Fill in when the frame was presented, or 0 if it was dropped.
+    func setPresented(frameNumber: UInt64, presented: Double) {
+        update(frameNumber: frameNumber) { record in
+            record.presented = presented
+        }
+    }
+
+    // Copy out the records still in the buffer for frames after the given frame number, oldest first.
+    func records(after frameNumber: UInt64) -> [mglFrameTelemetryRecord] {
+        lock.lock()
+        defer { lock.unlock() }
+        let oldestFrameNumber = lastFrameNumber >= UInt64(capacity) ? lastFrameNumber - UInt64(capacity) + 1 : 1
+        let firstFrameNumber = max(frameNumber + 1, oldestFrameNumber)
+        if firstFrameNumber > lastFrameNumber {
+            return []
+        }
+        return (firstFrameNumber ... lastFrameNumber).map { records[slot($0)] }
+    }
+
+    private func slot(_ frameNumber: UInt64) -> Int {
+        return Int(frameNumber % UInt64(capacity))
+    }
+
+    private func update(frameNumber: UInt64, change: (inout mglFrameTelemetryRecord) -> Void) {
+        lock.lock()
+        defer { lock.unlock() }
+        let index = slot(frameNumber)
+        if records[index].frameNumber == frameNumber {
+            change(&records[index])
+        }
+    }
+}
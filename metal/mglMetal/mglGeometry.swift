@@ -0,0 +1,108 @@
+//
+//  mglGeometry.swift
+//  mglMetal
+//
+//  Created by justin gardner on 10/19/26.
+//  Copyright © 2026 GRU. All rights reserved.
+//
+
+import Foundation
+import MetalKit
+
+// Kinds of geometry, which say how the vertices are laid out and drawn.
+// These need to match the types in mglCreateGeometry.m.
+enum mglGeometryType : UInt32 {
+    // [xyz rgb] vertices drawn as triangles, like mglQuad.
+    case triangles = 0
+    // [xyz rgb] vertices drawn as separate lines, like mglLines.
+    case lines = 1
+    // [xyz rgb] vertices drawn as a triangle strip, like mglPolygon.
+    case triangleStrip = 2
+    // [xyz rgba wh isRound borderSize] vertices drawn as points, like mglMetalDots.
+    case dots = 3
+    // [x0 y0 x1 y1 width rgba] records drawn as instanced quads, like mglMetalLines.
+    case instancedLines = 4
+
+    // How many values per vertex (or record) each type has.
+    var valuesPerVertex: Int {
+        switch self {
+        case .triangles, .lines, .triangleStrip: return 6
+        case .dots: return 11
+        case .instancedLines: return 9
+        }
+    }
+}
+
+/*
+ mglGeometry is a vertex buffer that stays on the server, so that stimuli that don't change,
+ or only change a little, don't need to be sent every frame. The client creates one once,
+ can patch ranges of its values, and then draws it by number with an optional transform.
+ */
+class mglGeometry {
+    let geometryType: mglGeometryType
+    let vertexCount: Int
+    private(set) var buffer: MTLBuffer
+
+    // The frame this geometry was last drawn in, so that updates know whether the GPU might still need the buffer.
+    private var drawnInFrame: UInt64?
+
+    init(geometryType: mglGeometryType, buffer: MTLBuffer, vertexCount: Int) {
+        self.geometryType = geometryType
+        self.buffer = buffer
+        self.vertexCount = vertexCount
+    }
+
+    var valueCount: Int {
+        return vertexCount * geometryType.valuesPerVertex
+    }
+
+    // Patch valueCount values starting at firstValue, from the given floats.
+    // Commands for a frame are only taken after the previous frame is done on the GPU,
+    // so usually the buffer can be patched in place. But if this geometry was already drawn in the
+    // frame that is being put together now, the GPU hasn't used the buffer yet, so patch a copy instead.
+    func update(device: MTLDevice, currentFrame: UInt64, firstValue: Int, values: UnsafeRawPointer, valueCount: Int) -> Bool {
+        if firstValue < 0 || valueCount < 0 || firstValue + valueCount > self.valueCount {
+            return false
+        }
+        if drawnInFrame == currentFrame {
+            guard let newBuffer = device.makeBuffer(bytes: buffer.contents(), length: buffer.length, options: .storageModeManaged) else {
+                return false
+            }
+            buffer = newBuffer
+            drawnInFrame = nil
+        }
+        let byteOffset = firstValue * MemoryLayout<Float>.stride
+        let byteCount = valueCount * MemoryLayout<Float>.stride
+        memcpy(buffer.contents() + byteOffset, values, byteCount)
+
+        // With storageModeManaged, we must explicitly sync the new data to the GPU.
+        buffer.didModifyRange(byteOffset ..< byteOffset + byteCount)
+        return true
+    }
+
+    // Draw with whatever pipeline state suits the type of geometry.
+    func draw(colorRenderingState: mglColorRenderingState, renderEncoder: MTLRenderCommandEncoder) {
+        drawnInFrame = colorRenderingState.getFrameCount()
+        if vertexCount == 0 {
+            return
+        }
+        renderEncoder.setVertexBuffer(buffer, offset: 0, index: 0)
+        switch geometryType {
+        case .triangles:
+            renderEncoder.setRenderPipelineState(colorRenderingState.getVerticesWithColorPipelineState())
+            renderEncoder.drawPrimitives(type: .triangle, vertexStart: 0, vertexCount: vertexCount)
+        case .lines:
+            renderEncoder.setRenderPipelineState(colorRenderingState.getVerticesWithColorPipelineState())
+            renderEncoder.drawPrimitives(type: .line, vertexStart: 0, vertexCount: vertexCount)
+        case .triangleStrip:
+            renderEncoder.setRenderPipelineState(colorRenderingState.getVerticesWithColorPipelineState())
+            renderEncoder.drawPrimitives(type: .triangleStrip, vertexStart: 0, vertexCount: vertexCount)
+        case .dots:
+            renderEncoder.setRenderPipelineState(colorRenderingState.getDotsPipelineState())
+            renderEncoder.drawPrimitives(type: .point, vertexStart: 0, vertexCount: vertexCount)
+        case .instancedLines:
+            renderEncoder.setRenderPipelineState(colorRenderingState.getInstancedLinesPipelineState())
+            renderEncoder.drawPrimitives(type: .triangle, vertexStart: 0, vertexCount: 6, instanceCount: vertexCount)
+        }
+    }
+}
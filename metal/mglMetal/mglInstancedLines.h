@@ -0,0 +1,55 @@
+//
+//  mglInstancedLines.h
+//  mglMetal
+//
+//  Created by justin gardner on 10/19/26.
+//  Copyright © 2026 GRU. All rights reserved.
+//
+
+#ifndef mglInstancedLines_h
+#define mglInstancedLines_h
+
+#include <stdint.h>
+#include <math.h>
+
+// Lines (and rotated rectangles) drawn as instances, with one compact record per line:
+// [x0 y0 x1 y1 width rgba]. The vertex_instanced_lines shader expands each record into a quad
+// of two triangles. A rectangle with center, size and angle is the same thing as a line through
+// its center along the angle, with the rectangle's width as its length and its height as the line width.
+// The expansion below is a plain C version of what the shader does, so that a mex function
+// (mglPrivateExpandLines) can check the records against the old Matlab expansion, without a GPU.
+
+#define MGL_INSTANCED_LINE_VALUES 9
+#define MGL_INSTANCED_LINE_VERTICES 6
+#define MGL_INSTANCED_LINE_VERTEX_VALUES 7
+
+// Which corner each of the 6 vertices is, for two triangles in the same order that mglQuad uses.
+// Corners go around the quad: 0 is start + offset, 1 is end + offset, 2 is end - offset, 3 is start - offset.
+// This needs to match instancedLineCorners in mglShaders.metal.
+static const uint32_t mglInstancedLineCorners[MGL_INSTANCED_LINE_VERTICES] = {0, 1, 2, 2, 3, 0};
+
+// Expand nLines records into 6 vertices each with values [xyz rgba], as the shader does.
+// The line is widened perpendicular to its heading, as mglMetalLines used to do in Matlab.
+static inline void mglInstancedLinesExpand(const float *records, uint32_t nLines, float *vertices) {
+    for (uint32_t lineIndex = 0; lineIndex < nLines; lineIndex++) {
+        const float *record = records + MGL_INSTANCED_LINE_VALUES * lineIndex;
+        const double angle = atan2((double)record[3] - record[1], (double)record[2] - record[0]);
+        const double offsetX = 0.5 * record[4] * -sin(angle);
+        const double offsetY = 0.5 * record[4] * cos(angle);
+        for (uint32_t vertexIndex = 0; vertexIndex < MGL_INSTANCED_LINE_VERTICES; vertexIndex++) {
+            const uint32_t corner = mglInstancedLineCorners[vertexIndex];
+            const float *point = ((corner == 0) || (corner == 3)) ? record : record + 2;
+            const double sign = (corner < 2) ? 1.0 : -1.0;
+            float *vertex = vertices + MGL_INSTANCED_LINE_VERTEX_VALUES * (MGL_INSTANCED_LINE_VERTICES * lineIndex + vertexIndex);
+            vertex[0] = (float)(point[0] + sign * offsetX);
+            vertex[1] = (float)(point[1] + sign * offsetY);
+            vertex[2] = 0;
+            vertex[3] = record[5];
+            vertex[4] = record[6];
+            vertex[5] = record[7];
+            vertex[6] = record[8];
+        }
+    }
+}
+
+#endif /* mglInstancedLines_h */
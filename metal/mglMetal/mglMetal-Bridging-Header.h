@@ -7,3 +7,11 @@
 
 #include "mglSecs.h"
 #include "mglCommandTypes.h"
+#include "mglDotMotion.h"
+#include "mglRandomDots.h"
+#include "mglProceduralGratings.h"
+#include "mglTextureBudget.h"
+#include "mglTrace.h"
+#include "mglFrameStream.h"
+#include "mglReadback.h"
+#include "mglPresentationQueue.h"
@@ -0,0 +1,233 @@
+//
+//  mglPresentationQueue.h
+//  mglMetal
+//
+//  Created by justin gardner on 10/19/26.
+//  Copyright © 2026 GRU. All rights reserved.
+//
+
+#ifndef mglPresentationQueue_h
+#define mglPresentationQueue_h
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+// Frames that were rendered ahead of time, each with a target time, and which frame to present on each display tick.
+//
+// A frame is due on the first tick that comes no more than half a refresh before its target time.
+// Frames are presented in order of target time, at most one per tick, and never skipped.
+// So if frames are scheduled closer together than the refresh period, or a tick is missed,
+// the frames that were due will go up late, on the following ticks, and be counted as late.
+// A frame that was due but couldn't be presented (no drawable, say) is counted as missed.
+//
+// This is plain C with no Apple dependencies and knows only times, not drawables, so that the scheduling
+// can be tested with a simulated clock (see mgllib/mglBenchmark/mglBenchmarkPresentationQueue.c).
+// A frame is whatever the renderer needs to find the rendered frame again, like the number of a pooled texture.
+
+#define MGL_PRESENTATION_QUEUE_MAX_PENDING 64
+#define MGL_PRESENTATION_QUEUE_TICK_INTERVALS 15
+
+// What happened to one scheduled frame, to report back to the client.
+typedef struct mglScheduledFrameRecord {
+    // Frames are numbered from 1 in the order they were scheduled.
+    uint32_t frameNumber;
+
+    // How many refreshes after its target the frame was presented, 0 means on time.
+    int32_t framesLate;
+
+    // When the client asked for the frame to be presented.
+    double targetTime;
+
+    // When the display tick the frame was presented on was due to be presented.
+    double tickTime;
+
+    // When the system reports that the frame was actually presented, or 0 if not known (yet).
+    double presentedTime;
+
+    // 1 if the frame was due on tickTime but couldn't be presented, so it never went up.
+    uint32_t missed;
+    uint32_t reserved;
+} mglScheduledFrameRecord;
+
+typedef struct mglPresentationQueueEntry {
+    int64_t frame;
+    mglScheduledFrameRecord record;
+} mglPresentationQueueEntry;
+
+typedef struct mglPresentationQueueState {
+    // Frames waiting to be presented, in order of target time.
+    mglPresentationQueueEntry pending[MGL_PRESENTATION_QUEUE_MAX_PENDING];
+    uint32_t pendingCount;
+    uint32_t frameSequence;
+
+    // Records of frames that were due, until the client takes them.
+    // Presented times are filled in from system callbacks on other threads, so records are guarded by a lock.
+    mglScheduledFrameRecord *records;
+    uint32_t recordCount;
+    uint32_t recordCapacity;
+    pthread_mutex_t recordsLock;
+
+    // The refresh period is estimated as the median of recent tick intervals,
+    // which ignores the occasional missed tick but follows changes in frame rate.
+    double refreshPeriod;
+    double lastTickTime;
+    int hasLastTickTime;
+    double tickIntervals[MGL_PRESENTATION_QUEUE_TICK_INTERVALS];
+    uint32_t tickIntervalCount;
+} mglPresentationQueueState;
+
+static inline void mglPresentationQueueCreate(mglPresentationQueueState *queue, double refreshPeriod) {
+    memset(queue, 0, sizeof(mglPresentationQueueState));
+    queue->frameSequence = 1;
+    queue->refreshPeriod = refreshPeriod;
+    pthread_mutex_init(&queue->recordsLock, NULL);
+}
+
+static inline void mglPresentationQueueDestroy(mglPresentationQueueState *queue) {
+    pthread_mutex_destroy(&queue->recordsLock);
+    free(queue->records);
+    memset(queue, 0, sizeof(mglPresentationQueueState));
+}
+
+// Add a rendered frame to be presented at the given time, returning its frame number, or 0 if the queue is full.
+static inline uint32_t mglPresentationQueueEnqueue(mglPresentationQueueState *queue, int64_t frame, double targetTime) {
+    if (queue->pendingCount >= MGL_PRESENTATION_QUEUE_MAX_PENDING) {
+        return 0;
+    }
+
+    // Keep frames in order of target time, and in the order they came for equal target times.
+    uint32_t index = queue->pendingCount;
+    while (index > 0 && queue->pending[index - 1].record.targetTime > targetTime) {
+        queue->pending[index] = queue->pending[index - 1];
+        index--;
+    }
+    mglPresentationQueueEntry *entry = &queue->pending[index];
+    memset(entry, 0, sizeof(mglPresentationQueueEntry));
+    entry->frame = frame;
+    entry->record.frameNumber = queue->frameSequence++;
+    entry->record.targetTime = targetTime;
+    queue->pendingCount++;
+    return entry->record.frameNumber;
+}
+
+static inline void mglPresentationQueueUpdateRefreshPeriod(mglPresentationQueueState *queue, double time) {
+    if (queue->hasLastTickTime && time > queue->lastTickTime) {
+        if (queue->tickIntervalCount == MGL_PRESENTATION_QUEUE_TICK_INTERVALS) {
+            memmove(queue->tickIntervals, queue->tickIntervals + 1, (MGL_PRESENTATION_QUEUE_TICK_INTERVALS - 1) * sizeof(double));
+            queue->tickIntervalCount--;
+        }
+        queue->tickIntervals[queue->tickIntervalCount++] = time - queue->lastTickTime;
+
+        // Median by insertion sort, there are only a few.
+        double sorted[MGL_PRESENTATION_QUEUE_TICK_INTERVALS];
+        for (uint32_t i = 0; i < queue->tickIntervalCount; i++) {
+            uint32_t j = i;
+            for (; j > 0 && sorted[j - 1] > queue->tickIntervals[i]; j--) {
+                sorted[j] = sorted[j - 1];
+            }
+            sorted[j] = queue->tickIntervals[i];
+        }
+        queue->refreshPeriod = sorted[queue->tickIntervalCount / 2];
+    }
+    queue->lastTickTime = time;
+    queue->hasLastTickTime = 1;
+}
+
+// Call once per display tick, with the time this tick's frame is due to be presented.
+// Returns 1 with the frame to present on this tick, and its frame number, or 0 if none is due.
+static inline int mglPresentationQueueTick(mglPresentationQueueState *queue, double time, int64_t *frame, uint32_t *frameNumber) {
+    mglPresentationQueueUpdateRefreshPeriod(queue, time);
+
+    if (queue->pendingCount == 0 || time < queue->pending[0].record.targetTime - queue->refreshPeriod / 2) {
+        return 0;
+    }
+
+    mglPresentationQueueEntry entry = queue->pending[0];
+    queue->pendingCount--;
+    memmove(queue->pending, queue->pending + 1, queue->pendingCount * sizeof(mglPresentationQueueEntry));
+    entry.record.tickTime = time;
+    long framesLate = lround((time - entry.record.targetTime) / queue->refreshPeriod);
+    entry.record.framesLate = framesLate > 0 ? (int32_t)framesLate : 0;
+
+    pthread_mutex_lock(&queue->recordsLock);
+    if (queue->recordCount == queue->recordCapacity) {
+        uint32_t capacity = queue->recordCapacity > 0 ? 2 * queue->recordCapacity : 64;
+        mglScheduledFrameRecord *records = realloc(queue->records, capacity * sizeof(mglScheduledFrameRecord));
+        if (records != NULL) {
+            queue->records = records;
+            queue->recordCapacity = capacity;
+        }
+    }
+    if (queue->recordCount < queue->recordCapacity) {
+        queue->records[queue->recordCount++] = entry.record;
+    }
+    pthread_mutex_unlock(&queue->recordsLock);
+
+    *frame = entry.frame;
+    *frameNumber = entry.record.frameNumber;
+    return 1;
+}
+
+// Find the record of a frame that was due, the last one since frame numbers aren't reused. Call with the lock held.
+static inline mglScheduledFrameRecord *mglPresentationQueueFindRecord(mglPresentationQueueState *queue, uint32_t frameNumber) {
+    for (uint32_t i = queue->recordCount; i > 0; i--) {
+        if (queue->records[i - 1].frameNumber == frameNumber) {
+            return &queue->records[i - 1];
+        }
+    }
+    return NULL;
+}
+
+// Fill in when the system says a frame was actually presented.
+static inline void mglPresentationQueuePresented(mglPresentationQueueState *queue, uint32_t frameNumber, double presentedTime) {
+    pthread_mutex_lock(&queue->recordsLock);
+    mglScheduledFrameRecord *record = mglPresentationQueueFindRecord(queue, frameNumber);
+    if (record != NULL) {
+        record->presentedTime = presentedTime;
+    }
+    pthread_mutex_unlock(&queue->recordsLock);
+}
+
+// Note that a frame that was due couldn't be presented.
+static inline void mglPresentationQueueMissed(mglPresentationQueueState *queue, uint32_t frameNumber) {
+    pthread_mutex_lock(&queue->recordsLock);
+    mglScheduledFrameRecord *record = mglPresentationQueueFindRecord(queue, frameNumber);
+    if (record != NULL) {
+        record->missed = 1;
+        record->presentedTime = 0.0;
+    }
+    pthread_mutex_unlock(&queue->recordsLock);
+}
+
+// Take up to maxCount of the oldest records, to report to the client, returning how many were taken.
+static inline uint32_t mglPresentationQueueTakeRecords(mglPresentationQueueState *queue, mglScheduledFrameRecord *records, uint32_t maxCount) {
+    pthread_mutex_lock(&queue->recordsLock);
+    uint32_t count = queue->recordCount < maxCount ? queue->recordCount : maxCount;
+    memcpy(records, queue->records, count * sizeof(mglScheduledFrameRecord));
+    queue->recordCount -= count;
+    memmove(queue->records, queue->records + count, queue->recordCount * sizeof(mglScheduledFrameRecord));
+    pthread_mutex_unlock(&queue->recordsLock);
+    return count;
+}
+
+static inline uint32_t mglPresentationQueueRecordCount(mglPresentationQueueState *queue) {
+    pthread_mutex_lock(&queue->recordsLock);
+    uint32_t count = queue->recordCount;
+    pthread_mutex_unlock(&queue->recordsLock);
+    return count;
+}
+
+// Forget all the frames waiting to be presented, copying them out so they can be cleaned up, returning how many.
+static inline uint32_t mglPresentationQueueRemoveAll(mglPresentationQueueState *queue, int64_t *frames) {
+    uint32_t count = queue->pendingCount;
+    for (uint32_t i = 0; i < count; i++) {
+        frames[i] = queue->pending[i].frame;
+    }
+    queue->pendingCount = 0;
+    return count;
+}
+
+#endif /* mglPresentationQueue_h */
@@ -0,0 +1,92 @@
+//
+//  mglPresentationQueue.swift
+//  mglMetal
+//
+//  Created by justin gardner on 10/19/26.
+//  Copyright © 2026 GRU. All rights reserved.
+//
+
+import Foundation
+
+/*
+ mglPresentationQueue holds frames that were rendered ahead of time, each with a target time,
+ and decides which frame to present on each display tick.
+
+ The scheduling itself is in mglPresentationQueue.h, which is plain C so that it can be tested with a
+ simulated clock. This keeps the queue state at a fixed address for the lock that guards its records.
+ Frame is the number of a pooled texture, which the renderer uses to find the rendered frame again.
+ */
+class mglPresentationQueue {
+    private let state: UnsafeMutablePointer<mglPresentationQueueState>
+
+    init(refreshPeriod: Double = 1.0 / 60.0) {
+        state = UnsafeMutablePointer<mglPresentationQueueState>.allocate(capacity: 1)
+        mglPresentationQueueCreate(state, refreshPeriod)
+    }
+
+    deinit {
+        mglPresentationQueueDestroy(state)
+        state.deallocate()
+    }
+
+    // How many frames are waiting to be presented.
+    var pendingCount: Int {
+        return Int(state.pointee.pendingCount)
+    }
+
+    // The number the next scheduled frame will get.
+    var nextFrameNumber: UInt32 {
+        return state.pointee.frameSequence
+    }
+
+    // The refresh period, estimated from recent ticks.
+    var refreshPeriod: Double {
+        return state.pointee.refreshPeriod
+    }
+
+    // Add a rendered frame to be presented at the given time, returning its frame number, or nil if the queue is full.
+    func enqueue(frame: Int, targetTime: Double) -> UInt32? {
+        let frameNumber = mglPresentationQueueEnqueue(state, Int64(frame), targetTime)
+        return frameNumber > 0 ? frameNumber : nil
+    }
+
+    // Call once per display tick, with the time this tick's frame is due to be presented.
+    // Returns the frame to present on this tick, if any, along with its frame number.
+    func tick(time: Double) -> (frame: Int, frameNumber: UInt32)? {
+        var frame = Int64(0)
+        var frameNumber = UInt32(0)
+        if mglPresentationQueueTick(state, time, &frame, &frameNumber) == 0 {
+            return nil
+        }
+        return (Int(frame), frameNumber)
+    }
+
+    // Fill in when the system says a frame was actually presented.
+    func presented(frameNumber: UInt32, presentedTime: Double) {
+        mglPresentationQueuePresented(state, frameNumber, presentedTime)
+    }
+
+    // Note that a frame that was due couldn't be presented.
+    func missed(frameNumber: UInt32) {
+        mglPresentationQueueMissed(state, frameNumber)
+    }
+
+    // Take the records of frames that were due so far, to report to the client.
+    func takeRecords() -> [mglScheduledFrameRecord] {
+        let count = Int(mglPresentationQueueRecordCount(state))
+        var records = [mglScheduledFrameRecord](repeating: mglScheduledFrameRecord(), count: count)
+        let taken = records.withUnsafeMutableBufferPointer { buffer in
+            return mglPresentationQueueTakeRecords(state, buffer.baseAddress, UInt32(count))
+        }
+        return Array(records.prefix(Int(taken)))
+    }
+
+    // Forget all the frames waiting to be presented, returning them so they can be cleaned up.
+    func removeAll() -> [Int] {
+        var frames = [Int64](repeating: 0, count: Int(MGL_PRESENTATION_QUEUE_MAX_PENDING))
+        let count = frames.withUnsafeMutableBufferPointer { buffer in
+            return mglPresentationQueueRemoveAll(state, buffer.baseAddress)
+        }
+        return frames.prefix(Int(count)).map { Int($0) }
+    }
+}
@@ -0,0 +1,84 @@
+//
+//  mglProceduralGratings.h
+//  mglMetal
+//
+//  Created by justin gardner on 10/19/26.
+//  Copyright © 2026 GRU. All rights reserved.
+//
+
+#ifndef mglProceduralGratings_h
+#define mglProceduralGratings_h
+
+#include <stdint.h>
+#include <math.h>
+
+// Gratings and gabors computed by the fragment shader, instead of made in Matlab and uploaded as textures.
+// Each grating is one record: [x y width height sf angle phase contrast sdx sdy alphaMask], in device units
+// (degrees, with mglVisualAngleCoordinates), so deg2pix comes from the current transform as for everything else.
+// sf, angle and phase are as for mglMakeGrating and sdx, sdy as for mglMakeGaussian, centered on the grating.
+// sdx or sdy of 0 means no envelope. The value is shown around gray as (contrast*grating*envelope+1)/2 with
+// alpha 1, or with alphaMask as (contrast*grating+1)/2 with the envelope as alpha, like taskTemplateStaircase.
+//
+// mglMakeGrating makes row 1 of the image at y = -height/2, and textures are shown with row 1 at the top,
+// so the grating is evaluated with y flipped so that it looks the same as the texture would.
+//
+// The rasterizer below is a plain C version of what vertex_procedural_gratings and fragment_procedural_gratings
+// do, so that a mex function (mglPrivateProceduralGratings) can check the gratings against mglMakeGrating and
+// mglMakeGaussian without a GPU, and so that tests can check the shader against it. They need to match.
+
+#define MGL_PROCEDURAL_GRATING_VALUES 11
+
+// envelopes are clamped to 0 below this, as mglMakeGaussian does
+#define MGL_PROCEDURAL_GRATING_ENVELOPE_CLAMP 0.01
+
+// Value and alpha of a grating record at an offset in device units from its center.
+static inline void mglProceduralGratingValue(const float *record, double dx, double dy, double *value, double *alpha) {
+    const double angle = M_PI * ((double)record[5] - 90) / 180;
+    const double a = cos(angle) * record[4] * 2 * M_PI;
+    const double b = sin(angle) * record[4] * 2 * M_PI;
+    const double grating = cos(a * dx - b * dy + M_PI * record[6] / 180);
+    double envelope = 1;
+    if ((record[8] > 0) && (record[9] > 0)) {
+        envelope = exp(-(dx * dx / (2.0 * record[8] * record[8]) + dy * dy / (2.0 * record[9] * record[9])));
+        if (envelope < MGL_PROCEDURAL_GRATING_ENVELOPE_CLAMP) envelope = 0;
+    }
+    if (record[10] > 0) {
+        *value = (record[7] * grating + 1) / 2;
+        *alpha = envelope;
+    } else {
+        *value = (record[7] * grating * envelope + 1) / 2;
+        *alpha = 1;
+    }
+}
+
+// Draw nGratings records into rgba, which is widthPixels x heightPixels rgba floats with the top row first,
+// like a frame grab, and already holds whatever is behind the gratings. Pixel centers are at
+// x = left + (column + 0.5) / xDeg2pix and y = top - (row + 0.5) / yDeg2pix. Pixels whose centers are on the
+// left or top edge of a grating are drawn and ones on the right or bottom edge are not, as the GPU does,
+// and each grating is blended over what is there with source alpha, as the pipeline does.
+static inline void mglProceduralGratingsRasterize(const float *records, uint32_t nGratings, double left, double top, double xDeg2pix, double yDeg2pix, uint32_t widthPixels, uint32_t heightPixels, float *rgba) {
+    for (uint32_t gratingIndex = 0; gratingIndex < nGratings; gratingIndex++) {
+        const float *record = records + MGL_PROCEDURAL_GRATING_VALUES * gratingIndex;
+        const double gratingLeft = record[0] - record[2] / 2.0;
+        const double gratingRight = record[0] + record[2] / 2.0;
+        const double gratingTop = record[1] + record[3] / 2.0;
+        const double gratingBottom = record[1] - record[3] / 2.0;
+        for (uint32_t row = 0; row < heightPixels; row++) {
+            const double y = top - (row + 0.5) / yDeg2pix;
+            if ((y > gratingTop) || (y <= gratingBottom)) continue;
+            for (uint32_t column = 0; column < widthPixels; column++) {
+                const double x = left + (column + 0.5) / xDeg2pix;
+                if ((x < gratingLeft) || (x >= gratingRight)) continue;
+                double value, alpha;
+                mglProceduralGratingValue(record, x - record[0], y - record[1], &value, &alpha);
+                float *pixel = rgba + 4 * ((size_t)row * widthPixels + column);
+                pixel[0] = (float)(value * alpha + pixel[0] * (1 - alpha));
+                pixel[1] = (float)(value * alpha + pixel[1] * (1 - alpha));
+                pixel[2] = (float)(value * alpha + pixel[2] * (1 - alpha));
+                pixel[3] = (float)(alpha * alpha + pixel[3] * (1 - alpha));
+            }
+        }
+    }
+}
+
+#endif /* mglProceduralGratings_h */
@@ -0,0 +1,121 @@
+//
+//  mglRandomDots.h
+//  mglMetal
+//
+//  Created by justin gardner on 10/19/26.
+//  Copyright © 2026 GRU. All rights reserved.
+//
+
+#ifndef mglRandomDots_h
+#define mglRandomDots_h
+
+#include <stdint.h>
+
+// Random dots for mglRepeatDotsCommand, made with a counter-based random number generator (Philox4x32-10).
+// Each random value is a pure function of the seed, the frame, and which dot and value it is for,
+// so any range of dots can be filled independently of the others. This lets the vertex buffer be
+// filled in chunks on several threads and still come out the same for a given seed, however many
+// threads there are or however the dots are split up.
+// This is plain C so that it can be shared between mglMetal (through the bridging header)
+// and a mex function (mglPrivateRandomDots) which is used to test and time it.
+
+// Each dot has 11 values per vertex: [xyz rgba wh isRound borderSize],
+// of which x, y, r, g, b are random. x and y are uniform from -1 to 1 and rgb from 0 to 1.
+#define MGL_RANDOM_DOTS_VALUES_PER_DOT 11
+#define MGL_RANDOM_DOTS_RANDOM_PER_DOT 5
+
+// Dots are made in groups of 4, which use exactly 5 Philox blocks of 4 random words each.
+// Groups are made a batch at a time, so the rounds below run over arrays that the compiler can vectorize.
+#define MGL_RANDOM_DOTS_PER_GROUP 4
+#define MGL_RANDOM_DOTS_BLOCKS_PER_GROUP 5
+#define MGL_RANDOM_DOTS_GROUPS_PER_BATCH 8
+#define MGL_RANDOM_DOTS_BLOCKS_PER_BATCH (MGL_RANDOM_DOTS_BLOCKS_PER_GROUP * MGL_RANDOM_DOTS_GROUPS_PER_BATCH)
+
+// Run Philox4x32-10 on a batch of counters, in place. Counter word 0 is the block number,
+// word 1 is the frame, and the key is the seed.
+static inline void mglRandomDotsPhilox(uint32_t c0[], uint32_t c1[], uint32_t c2[], uint32_t c3[], int nBlocks, uint32_t seed) {
+    uint32_t k0 = seed;
+    uint32_t k1 = 0x6d676c00;
+    for (int round = 0; round < 10; round++) {
+        for (int i = 0; i < nBlocks; i++) {
+            const uint64_t product0 = (uint64_t)0xD2511F53 * c0[i];
+            const uint64_t product1 = (uint64_t)0xCD9E8D57 * c2[i];
+            const uint32_t x0 = (uint32_t)(product1 >> 32) ^ c1[i] ^ k0;
+            const uint32_t x2 = (uint32_t)(product0 >> 32) ^ c3[i] ^ k1;
+            c0[i] = x0;
+            c1[i] = (uint32_t)product1;
+            c2[i] = x2;
+            c3[i] = (uint32_t)product0;
+        }
+        k0 += 0x9E3779B9;
+        k1 += 0xBB67AE85;
+    }
+}
+
+// Convert a random word to a float from 0 to 1, using the top 24 bits that a float can hold exactly.
+static inline float mglRandomDotsUniform(uint32_t word) {
+    return (float)(word >> 8) * (1.0f / 16777216.0f);
+}
+
+// Write one dot, given its 5 random words.
+static inline void mglRandomDotsPackDot(float *vertex, const uint32_t *words) {
+    // xyz
+    vertex[0] = mglRandomDotsUniform(words[0]) * 2 - 1;
+    vertex[1] = mglRandomDotsUniform(words[1]) * 2 - 1;
+    vertex[2] = 0;
+
+    // rgba
+    vertex[3] = mglRandomDotsUniform(words[2]);
+    vertex[4] = mglRandomDotsUniform(words[3]);
+    vertex[5] = mglRandomDotsUniform(words[4]);
+    vertex[6] = 1;
+
+    // wh
+    vertex[7] = 1;
+    vertex[8] = 1;
+
+    // round
+    vertex[9] = 0;
+
+    // border size
+    vertex[10] = 0;
+}
+
+// Fill in dots firstDot up to (not including) firstDot + nDots for the given seed and frame.
+// buffer points at the vertex for firstDot. This can be called on separate ranges from separate threads.
+static inline void mglRandomDotsPack(uint32_t seed, uint32_t frame, uint32_t firstDot, uint32_t nDots, float *buffer) {
+    uint32_t c0[MGL_RANDOM_DOTS_BLOCKS_PER_BATCH], c1[MGL_RANDOM_DOTS_BLOCKS_PER_BATCH];
+    uint32_t c2[MGL_RANDOM_DOTS_BLOCKS_PER_BATCH], c3[MGL_RANDOM_DOTS_BLOCKS_PER_BATCH];
+    uint32_t words[4 * MGL_RANDOM_DOTS_BLOCKS_PER_BATCH];
+
+    const uint32_t lastDot = firstDot + nDots;
+    uint32_t group = firstDot / MGL_RANDOM_DOTS_PER_GROUP;
+    while (group * MGL_RANDOM_DOTS_PER_GROUP < lastDot) {
+        // Make random words for a batch of groups.
+        for (int i = 0; i < MGL_RANDOM_DOTS_BLOCKS_PER_BATCH; i++) {
+            c0[i] = group * MGL_RANDOM_DOTS_BLOCKS_PER_GROUP + i;
+            c1[i] = frame;
+            c2[i] = 0;
+            c3[i] = 0;
+        }
+        mglRandomDotsPhilox(c0, c1, c2, c3, MGL_RANDOM_DOTS_BLOCKS_PER_BATCH, seed);
+        for (int i = 0; i < MGL_RANDOM_DOTS_BLOCKS_PER_BATCH; i++) {
+            words[4 * i + 0] = c0[i];
+            words[4 * i + 1] = c1[i];
+            words[4 * i + 2] = c2[i];
+            words[4 * i + 3] = c3[i];
+        }
+
+        // Pack the dots from the batch that are in range, which may not be all of them at the ends.
+        const uint32_t batchFirstDot = group * MGL_RANDOM_DOTS_PER_GROUP;
+        for (uint32_t i = 0; i < MGL_RANDOM_DOTS_PER_GROUP * MGL_RANDOM_DOTS_GROUPS_PER_BATCH; i++) {
+            const uint32_t dot = batchFirstDot + i;
+            if ((dot >= firstDot) && (dot < lastDot)) {
+                mglRandomDotsPackDot(buffer + MGL_RANDOM_DOTS_VALUES_PER_DOT * (dot - firstDot), words + MGL_RANDOM_DOTS_RANDOM_PER_DOT * i);
+            }
+        }
+        group += MGL_RANDOM_DOTS_GROUPS_PER_BATCH;
+    }
+}
+
+#endif /* mglRandomDots_h */
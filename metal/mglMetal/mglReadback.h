@@ -0,0 +1,102 @@
+//
+//  mglReadback.h
+//  mglMetal
+//
+//  Created by justin gardner on 10/19/26.
+//  Copyright © 2026 GRU. All rights reserved.
+//
+
+#ifndef mglReadback_h
+#define mglReadback_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Reading back rendered images without holding up the render loop, used by mglReadbackRing.
+// A readback is issued after a frame is drawn: the GPU copies a region of the render target (or a texture)
+// into a staging buffer, after the frame, while the client goes on drawing the next one. When the readback
+// is collected, one or more frames later, the copy is long done, and the RGBA32Float rows in the staging
+// buffer are converted here into the image the client wants: height x width x 4, in Matlab's column major
+// order, so the client does not have to permute it, as single or as uint8, which is a quarter of the bytes
+// to send over the socket.
+// This is plain C so that it can be tested without Metal (see mglBenchmarkReadback.c).
+
+typedef enum {
+    mglReadbackSingle = 0,
+    mglReadbackUInt8 = 1
+} mglReadbackFormat;
+
+// Pixels are converted a square tile at a time, so that both the rows read and the columns written stay in cache.
+#define MGL_READBACK_TILE 32
+
+static inline size_t mglReadbackValueBytes(uint32_t format) {
+    return format == mglReadbackUInt8 ? sizeof(uint8_t) : sizeof(float);
+}
+
+static inline size_t mglReadbackImageBytes(uint32_t width, uint32_t height, uint32_t format) {
+    return (size_t)width * height * 4 * mglReadbackValueBytes(format);
+}
+
+// Check a region of a texture that is textureWidth x textureHeight, with x and y from the top left.
+// A width or height of 0 means to the right or bottom edge. Returns 0 if the region is not within the texture.
+static inline int mglReadbackRegion(uint32_t textureWidth, uint32_t textureHeight, uint32_t x, uint32_t y, uint32_t *width, uint32_t *height) {
+    if (x >= textureWidth || y >= textureHeight) {
+        return 0;
+    }
+    if (*width == 0) {
+        *width = textureWidth - x;
+    }
+    if (*height == 0) {
+        *height = textureHeight - y;
+    }
+    if (*width > textureWidth - x || *height > textureHeight - y) {
+        return 0;
+    }
+    return 1;
+}
+
+// Rendered values are 0-1, clamped and rounded to 0-255, with NaN as 0.
+static inline uint8_t mglReadbackFloatToUInt8(float value) {
+    if (!(value > 0.0f)) {
+        return 0;
+    }
+    if (value >= 1.0f) {
+        return 255;
+    }
+    return (uint8_t)(value * 255.0f + 0.5f);
+}
+
+// Convert width x height RGBA32Float pixels, rows bytesPerRow apart as copied from a texture, into a
+// height x width x 4 image in column major order, of single or uint8 values.
+static inline void mglReadbackToImage(const void *rows, size_t bytesPerRow, uint32_t width, uint32_t height, uint32_t format, void *image) {
+    const size_t planeCount = (size_t)width * height;
+    for (uint32_t y0 = 0; y0 < height; y0 += MGL_READBACK_TILE) {
+        const uint32_t y1 = y0 + MGL_READBACK_TILE < height ? y0 + MGL_READBACK_TILE : height;
+        for (uint32_t x0 = 0; x0 < width; x0 += MGL_READBACK_TILE) {
+            const uint32_t x1 = x0 + MGL_READBACK_TILE < width ? x0 + MGL_READBACK_TILE : width;
+            for (uint32_t x = x0; x < x1; x++) {
+                // Each column of the tile goes down the four planes of the image.
+                const size_t column = (size_t)x * height;
+                for (uint32_t y = y0; y < y1; y++) {
+                    const float *pixel = (const float *)((const uint8_t *)rows + y * bytesPerRow) + 4 * (size_t)x;
+                    const size_t index = column + y;
+                    if (format == mglReadbackUInt8) {
+                        uint8_t *out = (uint8_t *)image;
+                        out[index] = mglReadbackFloatToUInt8(pixel[0]);
+                        out[index + planeCount] = mglReadbackFloatToUInt8(pixel[1]);
+                        out[index + 2 * planeCount] = mglReadbackFloatToUInt8(pixel[2]);
+                        out[index + 3 * planeCount] = mglReadbackFloatToUInt8(pixel[3]);
+                    } else {
+                        float *out = (float *)image;
+                        out[index] = pixel[0];
+                        out[index + planeCount] = pixel[1];
+                        out[index + 2 * planeCount] = pixel[2];
+                        out[index + 3 * planeCount] = pixel[3];
+                    }
+                }
+            }
+        }
+    }
+}
+
+#endif /* mglReadback_h */
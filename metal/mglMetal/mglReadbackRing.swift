@@ -0,0 +1,150 @@
+//
+//  mglReadbackRing.swift
+//  mglMetal
+//
+//  Created by justin gardner on 10/19/26.
+//  Copyright © 2026 GRU. All rights reserved.
+//
+
+import Foundation
+import MetalKit
+
+/*
+ mglReadbackRing reads back rendered images without holding up the render loop (see mglReadback.h).
+ Issuing a readback commits a blit that copies a region of a texture into one of a ring of shared staging
+ buffers, ordered after the frames already committed, and returns a ticket right away.
+ Collecting the ticket, usually a frame or more later, finds the copy done (or waits for it), converts
+ the staging buffer to the bytes of the image the client wants and frees the slot for another readback.
+ */
+class mglReadbackRing {
+    private class Slot {
+        var buffer: MTLBuffer? = nil
+        var ticket = UInt32(0)
+        var commandBuffer: MTLCommandBuffer? = nil
+        var width = UInt32(0)
+        var height = UInt32(0)
+        var bytesPerRow = 0
+        var format = UInt32(mglReadbackSingle.rawValue)
+        var issuedInFrame = UInt64(0)
+    }
+
+    private let slots: [Slot]
+    private var nextTicket = UInt32(1)
+
+    init(slotCount: Int) {
+        slots = (0 ..< max(1, slotCount)).map { _ in Slot() }
+    }
+
+    var slotCount: Int {
+        return slots.count
+    }
+
+    // Readbacks issued and not yet collected.
+    var pendingCount: Int {
+        return slots.filter { $0.ticket != 0 }.count
+    }
+
+    // Copy a region of texture, from the top left, into a free slot, after the work already committed to the GPU.
+    // A width or height of 0 means to the edge. Returns the ticket and the size of the region, or nil.
+    func issue(
+        texture: MTLTexture,
+        x: UInt32,
+        y: UInt32,
+        width: UInt32,
+        height: UInt32,
+        format: UInt32,
+        currentFrame: UInt64,
+        renderer: mglRenderer2,
+        logger: mglLogger
+    ) -> (ticket: UInt32, width: UInt32, height: UInt32)? {
+        if texture.pixelFormat != .rgba32Float {
+            logger.error(component: "mglReadbackRing", details: "Can only read back rgba32Float textures, not \(texture.pixelFormat).")
+            return nil
+        }
+        if format != UInt32(mglReadbackSingle.rawValue) && format != UInt32(mglReadbackUInt8.rawValue) {
+            logger.error(component: "mglReadbackRing", details: "Unknown readback format \(format).")
+            return nil
+        }
+        var regionWidth = width
+        var regionHeight = height
+        if mglReadbackRegion(UInt32(texture.width), UInt32(texture.height), x, y, &regionWidth, &regionHeight) == 0 {
+            logger.error(component: "mglReadbackRing", details: "Region x \(x) y \(y) width \(width) height \(height) is not within the \(texture.width)x\(texture.height) texture.")
+            return nil
+        }
+        guard let slot = slots.first(where: { $0.ticket == 0 }) else {
+            logger.error(component: "mglReadbackRing", details: "All \(slots.count) readbacks are waiting to be collected, collect some before issuing more.")
+            return nil
+        }
+
+        // Reuse the slot's staging buffer when it is big enough.
+        let bytesPerRow = Int(regionWidth) * 4 * MemoryLayout<Float>.stride
+        let byteCount = bytesPerRow * Int(regionHeight)
+        if slot.buffer == nil || slot.buffer!.length < byteCount {
+            slot.buffer = nil
+            guard let buffer = texture.device.makeBuffer(length: byteCount, options: .storageModeShared) else {
+                logger.error(component: "mglReadbackRing", details: "Could not make a staging buffer of \(byteCount) bytes.")
+                return nil
+            }
+            slot.buffer = buffer
+        }
+
+        guard let commandBuffer = renderer.makeCommandBuffer(),
+              let bltCommandEncoder = commandBuffer.makeBlitCommandEncoder() else {
+            logger.error(component: "mglReadbackRing", details: "Could not make a command buffer for the readback.")
+            return nil
+        }
+        bltCommandEncoder.copy(
+            from: texture,
+            sourceSlice: 0,
+            sourceLevel: 0,
+            sourceOrigin: MTLOrigin(x: Int(x), y: Int(y), z: 0),
+            sourceSize: MTLSize(width: Int(regionWidth), height: Int(regionHeight), depth: 1),
+            to: slot.buffer!,
+            destinationOffset: 0,
+            destinationBytesPerRow: bytesPerRow,
+            destinationBytesPerImage: byteCount)
+        bltCommandEncoder.endEncoding()
+        commandBuffer.commit()
+
+        slot.ticket = nextTicket
+        slot.commandBuffer = commandBuffer
+        slot.width = regionWidth
+        slot.height = regionHeight
+        slot.bytesPerRow = bytesPerRow
+        slot.format = format
+        slot.issuedInFrame = currentFrame
+        nextTicket = nextTicket == UInt32.max ? 1 : nextTicket + 1
+        return (slot.ticket, regionWidth, regionHeight)
+    }
+
+    // Wait for a readback if it is not done yet, and convert it into a height x width x 4 image.
+    // Frees the slot either way. Returns nil if there is no such ticket or the copy failed.
+    func collect(ticket: UInt32, logger: mglLogger) -> (width: UInt32, height: UInt32, format: UInt32, issuedInFrame: UInt64, waitedSecs: Double, image: [UInt8])? {
+        guard ticket != 0, let slot = slots.first(where: { $0.ticket == ticket }) else {
+            logger.error(component: "mglReadbackRing", details: "No readback \(ticket) to collect, it may have been collected already.")
+            return nil
+        }
+        defer {
+            slot.ticket = 0
+            slot.commandBuffer = nil
+        }
+
+        var waitedSecs = 0.0
+        if let commandBuffer = slot.commandBuffer, commandBuffer.status != .completed {
+            let startSecs = CACurrentMediaTime()
+            commandBuffer.waitUntilCompleted()
+            waitedSecs = CACurrentMediaTime() - startSecs
+        }
+        guard slot.commandBuffer?.status == .completed,
+              let buffer = slot.buffer else {
+            logger.error(component: "mglReadbackRing", details: "Readback \(ticket) did not complete: \(String(describing: slot.commandBuffer?.error))")
+            return nil
+        }
+
+        var image = [UInt8](repeating: 0, count: mglReadbackImageBytes(slot.width, slot.height, slot.format))
+        image.withUnsafeMutableBytes { imageBytes in
+            mglReadbackToImage(buffer.contents(), slot.bytesPerRow, slot.width, slot.height, slot.format, imageBytes.baseAddress)
+        }
+        return (slot.width, slot.height, slot.format, slot.issuedInFrame, waitedSecs, image)
+    }
+}
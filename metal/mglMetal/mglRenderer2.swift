@@ -72,6 +72,15 @@ class mglRenderer2: NSObject {
     // Keeps the current coordinate xform specified by the client, like screen pixels vs device visual degrees.
     private var deg2metal = matrix_identity_float4x4
     
+    // Frames rendered ahead of time into pooled textures, waiting to be presented at their target times.
+    // The frame in progress, if the client scheduled one with mglScheduleFrame, and its target time.
+    private let presentationQueue = mglPresentationQueue()
+    private var scheduledFrameIndex: Int? = nil
+    private var scheduledFrameTargetTime: Double = 0.0
+
+    // Timing of every onscreen frame, for the client to check for dropped and late frames.
+    private let frameTelemetry = mglFrameTelemetry()
+
     // For use with CTMetalDisplayLink which requires setting up the
     // renderPassDescriptor once, and updating its texture
     var onscreenRenderPassDescriptor: MTLRenderPassDescriptor?
@@ -239,6 +248,13 @@ extension mglRenderer2: MTKViewDelegate {
             flushInFlight = nil
         }
 
+        // Present a frame that was rendered ahead of time, if one is due on this tick.
+        // If one is, it uses up this tick's drawable, so onscreen drawing will wait for the next tick.
+        let presentedScheduledFrame = presentScheduledFrame(
+            view: view,
+            metalDisplayLinkDrawable: metalDisplayLinkDrawable,
+            targetPresentationTimestamp: targetPresentationTimestamp)
+
         // Let the command interface read new commands from the client, if any.
         // This will wait up to a new milliseconds before timing out.
         // Waiting a little is good here: it gives the client a chance to compute and send the next command.
@@ -246,7 +262,14 @@ extension mglRenderer2: MTKViewDelegate {
         // so we'd drop this frame and wait all the way until the next frame before reading the next command.
         // However, we dont' want to wait forever, so this won't block indefinitely.
         commandInterface.readAny(device: device)
-        
+
+        // If a scheduled frame used this tick's drawable, leave commands for the next tick.
+        // Taking a drawing command now would mean doing its nondrawing work twice,
+        // once now and again when it is tried on the next tick.
+        if presentedScheduledFrame && !colorRenderingState.isRenderingOffscreen() {
+            return
+        }
+
         // Get the next command to be processed from the command interface, if any.
         // If we don't get one this time, that's fine, we'll check again on the next frame.
         guard var command = commandInterface.next() else {
@@ -254,6 +277,7 @@ extension mglRenderer2: MTKViewDelegate {
         }
 
         // Let the command do non-drawing work, like getting and setting the state of the app.
+        mglTraceBegin(mglTraceNondrawingWork, UInt64(command.results.commandCode))
         let nondrawingSuccess = command.doNondrawingWork(
             logger: logger,
             view: view,
@@ -263,6 +287,7 @@ extension mglRenderer2: MTKViewDelegate {
             deg2metal: &deg2metal,
             targetPresentationTimestamp: targetPresentationTimestamp
         )
+        mglTraceEnd(mglTraceNondrawingWork, UInt64(command.results.commandCode))
         
         // On failure, exit right away.
         if !nondrawingSuccess {
@@ -310,7 +335,9 @@ extension mglRenderer2: MTKViewDelegate {
         let isRenderingOffscreen = colorRenderingState.isRenderingOffscreen()
         
         // Acquire drawable if rendering onscreen, nil if offscreen
+        mglTraceBegin(mglTraceAcquireDrawable, 0)
         let drawable: CAMetalDrawable? = isRenderingOffscreen ? nil : (metalDisplayLinkDrawable ?? view.currentDrawable)
+        mglTraceEnd(mglTraceAcquireDrawable, 0)
         
         // Validate we got a drawable when we need one
         if !isRenderingOffscreen && drawable == nil {
@@ -330,6 +357,7 @@ extension mglRenderer2: MTKViewDelegate {
         ) else {
             logger.error(component: "mglRenderer2", details: "Could not get render pass descriptor, aborting render pass.")
             commandInterface.done(command: command, success: false)
+            finishScheduledFrame(enqueue: false)
             return
         }
 
@@ -345,6 +373,7 @@ extension mglRenderer2: MTKViewDelegate {
               let renderEncoder = commandBuffer.makeRenderCommandEncoder(descriptor: renderPassDescriptor) else {
             logger.error(component: "mglRenderer2", details: "Could not get command buffer and renderEncoder from the command queue, aborting render pass.")
             commandInterface.done(command: command, success: false)
+            finishScheduledFrame(enqueue: false)
             return
         }
         depthStencilState.configureRenderEncoder(renderEncoder: renderEncoder)
@@ -362,6 +391,7 @@ extension mglRenderer2: MTKViewDelegate {
             //  - the command received above with framesRemaining > 0, which initiated this frame's tight loop
             //  - another command received below which is being processed as part of the same frame
             command.results.drawableAcquired = drawableAcquired
+            mglTraceBegin(mglTraceDraw, UInt64(command.results.commandCode))
             let drawSuccess = command.draw(
                 logger: logger,
                 view: view,
@@ -371,14 +401,15 @@ extension mglRenderer2: MTKViewDelegate {
                 targetPresentationTimestamp: targetPresentationTimestamp,
                 renderEncoder: renderEncoder
             )
+            mglTraceEnd(mglTraceDraw, UInt64(command.results.commandCode))
             
             // On failure, end the frame.
             if !drawSuccess {
                 commandInterface.done(command: command, success: false)
                 renderEncoder.endEncoding()
                 colorRenderingState.finishDrawing(commandBuffer: commandBuffer, drawable: drawable)
-                if let drawable = drawable { commandBuffer.present(drawable) }
-                commandBuffer.commit()
+                presentAndCommit(commandBuffer: commandBuffer, drawable: drawable, drawableAcquired: drawableAcquired, targetPresentationTimestamp: targetPresentationTimestamp)
+                finishScheduledFrame(enqueue: false)
                 return
             }
             
@@ -405,8 +436,8 @@ extension mglRenderer2: MTKViewDelegate {
                 
                 // Present this frame.
                 colorRenderingState.finishDrawing(commandBuffer: commandBuffer, drawable: drawable)
-                if let drawable = drawable { commandBuffer.present(drawable) }
-                commandBuffer.commit()
+                presentAndCommit(commandBuffer: commandBuffer, drawable: drawable, drawableAcquired: drawableAcquired, targetPresentationTimestamp: targetPresentationTimestamp)
+                finishScheduledFrame(enqueue: true)
                 
                 // And also re-add this command so it will be the one processed on the next frame.
                 commandInterface.addNext(command: command)
@@ -424,6 +455,7 @@ extension mglRenderer2: MTKViewDelegate {
                 command = nextCommand
                 
                 // Let the next command get or set app state, even during the frame tight loop.
+                mglTraceBegin(mglTraceNondrawingWork, UInt64(command.results.commandCode))
                 let nextNondrawingSuccess = command.doNondrawingWork(
                     logger: logger,
                     view: view,
@@ -433,14 +465,15 @@ extension mglRenderer2: MTKViewDelegate {
                     deg2metal: &deg2metal,
                     targetPresentationTimestamp: targetPresentationTimestamp
                 )
+                mglTraceEnd(mglTraceNondrawingWork, UInt64(command.results.commandCode))
                 
                 // On failure, end the frame.
                 if !nextNondrawingSuccess {
                     commandInterface.done(command: command, success: false)
                     renderEncoder.endEncoding()
                     colorRenderingState.finishDrawing(commandBuffer: commandBuffer, drawable: drawable)
-                    if let drawable = drawable { commandBuffer.present(drawable) }
-                    commandBuffer.commit()
+                    presentAndCommit(commandBuffer: commandBuffer, drawable: drawable, drawableAcquired: drawableAcquired, targetPresentationTimestamp: targetPresentationTimestamp)
+                    finishScheduledFrame(enqueue: false)
                     return
                 }
                 
@@ -450,8 +483,8 @@ extension mglRenderer2: MTKViewDelegate {
                 commandInterface.done(command: command, success: false)
                 renderEncoder.endEncoding()
                 colorRenderingState.finishDrawing(commandBuffer: commandBuffer, drawable: drawable)
-                if let drawable = drawable { commandBuffer.present(drawable) }
-                commandBuffer.commit()
+                presentAndCommit(commandBuffer: commandBuffer, drawable: drawable, drawableAcquired: drawableAcquired, targetPresentationTimestamp: targetPresentationTimestamp)
+                finishScheduledFrame(enqueue: false)
                 return
             }
         }
@@ -474,11 +507,135 @@ extension mglRenderer2: MTKViewDelegate {
         // We'll report this to the client at the start of the next frame's render() call.
         setUpFlushInFlight(drawable: drawable, commandBuffer: commandBuffer, command: command)
         
-        // Present this frame.
+        // Present this frame, or if it was scheduled, queue it to be presented at its target time.
         colorRenderingState.finishDrawing(commandBuffer: commandBuffer, drawable: drawable)
-        if let drawable = drawable { commandBuffer.present(drawable) }
-        commandBuffer.commit()
+        presentAndCommit(commandBuffer: commandBuffer, drawable: drawable, drawableAcquired: drawableAcquired, targetPresentationTimestamp: targetPresentationTimestamp)
+        finishScheduledFrame(enqueue: true)
+    }
+
+    // Called by mglScheduleFrameCommand: render the next frame into a pooled texture, instead of the
+    // current render target, and present it on the display tick that matches the given target time.
+    // Returns the number the frame will have in the scheduled frame records, or nil if it can't be scheduled.
+    func scheduleFrame(view: MTKView, targetTime: Double) -> UInt32? {
+        guard let index = colorRenderingState.startScheduledFrame(view: view) else {
+            return nil
+        }
+        scheduledFrameIndex = index
+        scheduledFrameTargetTime = targetTime
+        return presentationQueue.nextFrameNumber
+    }
+
+    // Called by mglReadbackRing: a command buffer for GPU work outside of a frame, which runs after the frames already committed.
+    func makeCommandBuffer() -> MTLCommandBuffer? {
+        return commandQueue.makeCommandBuffer()
+    }
+
+    // Called by mglGetScheduledFrameStatsCommand: records of scheduled frames presented so far, and how many are still waiting.
+    func takeScheduledFrameRecords() -> (records: [mglScheduledFrameRecord], pendingCount: Int) {
+        return (presentationQueue.takeRecords(), presentationQueue.pendingCount)
+    }
 
+    // At the end of a frame that was scheduled, queue it for presentation (or give up its pooled texture),
+    // and go back to the usual render target.
+    private func finishScheduledFrame(enqueue: Bool) {
+        guard let index = scheduledFrameIndex else {
+            return
+        }
+        if !enqueue || presentationQueue.enqueue(frame: index, targetTime: scheduledFrameTargetTime) == nil {
+            colorRenderingState.releaseScheduledFrame(index: index)
+        }
+        colorRenderingState.finishScheduledFrame()
+        scheduledFrameIndex = nil
+    }
+
+    // On each display tick, copy a scheduled frame that is due into the drawable and present it.
+    // Returns whether a frame was presented, which uses up the drawable for this tick.
+    // A frame that is due but can't be presented is gone from the queue, so it's recorded as missed.
+    private func presentScheduledFrame(view: MTKView, metalDisplayLinkDrawable: CAMetalDrawable?, targetPresentationTimestamp: CFTimeInterval?) -> Bool {
+        // Without a display link, there's no target presentation time, so the best we can do is now.
+        let tickTime = targetPresentationTimestamp ?? secs.get()
+        guard let (index, frameNumber) = presentationQueue.tick(time: tickTime) else {
+            return false
+        }
+        defer {
+            colorRenderingState.releaseScheduledFrame(index: index)
+        }
+
+        guard let texture = colorRenderingState.getScheduledFrameTexture(index: index),
+              let drawable = metalDisplayLinkDrawable ?? view.currentDrawable,
+              let commandBuffer = commandQueue.makeCommandBuffer(),
+              let bltCommandEncoder = commandBuffer.makeBlitCommandEncoder() else {
+            logger.error(component: "mglRenderer2", details: "Could not get drawable or command buffer to present scheduled frame \(frameNumber).")
+            presentationQueue.missed(frameNumber: frameNumber)
+            return false
+        }
+        let drawableAcquired = secs.get()
+        if texture.pixelFormat != drawable.texture.pixelFormat {
+            logger.error(component: "mglRenderer2", details: "Scheduled frame \(frameNumber) has pixel format \(texture.pixelFormat.rawValue) but the drawable has \(drawable.texture.pixelFormat.rawValue).")
+            bltCommandEncoder.endEncoding()
+            presentationQueue.missed(frameNumber: frameNumber)
+            return false
+        }
+
+        // Copy the frame, as much as fits if the drawable changed size since it was rendered.
+        let size = MTLSize(
+            width: min(texture.width, drawable.texture.width),
+            height: min(texture.height, drawable.texture.height),
+            depth: 1)
+        bltCommandEncoder.copy(
+            from: texture,
+            sourceSlice: 0,
+            sourceLevel: 0,
+            sourceOrigin: MTLOrigin(x: 0, y: 0, z: 0),
+            sourceSize: size,
+            to: drawable.texture,
+            destinationSlice: 0,
+            destinationLevel: 0,
+            destinationOrigin: MTLOrigin(x: 0, y: 0, z: 0))
+        bltCommandEncoder.endEncoding()
+
+        if #available(macOS 10.15.4, *) {
+            drawable.addPresentedHandler { [presentationQueue] drawable in
+                presentationQueue.presented(frameNumber: frameNumber, presentedTime: drawable.presentedTime)
+            }
+        }
+        presentAndCommit(commandBuffer: commandBuffer, drawable: drawable, drawableAcquired: drawableAcquired, targetPresentationTimestamp: targetPresentationTimestamp)
+        return true
+    }
+
+    // Called by mglGetFrameTelemetryCommand: timing of onscreen frames after the given frame number.
+    func getFrameTelemetry(after frameNumber: UInt64) -> (records: [mglFrameTelemetryRecord], frameCount: UInt64) {
+        return (frameTelemetry.records(after: frameNumber), frameTelemetry.frameCount)
+    }
+
+    // Present the drawable, if rendering onscreen, and commit the frame.
+    // Onscreen frames get a telemetry record, which the system fills in when the GPU is done and when the frame is presented.
+    private func presentAndCommit(commandBuffer: MTLCommandBuffer, drawable: CAMetalDrawable?, drawableAcquired: Double, targetPresentationTimestamp: CFTimeInterval?) {
+        guard let drawable = drawable else {
+            mglTraceBegin(mglTraceCommit, 0)
+            commandBuffer.commit()
+            mglTraceEnd(mglTraceCommit, 0)
+            return
+        }
+
+        let frameNumber = frameTelemetry.commitFrame(
+            targetTime: targetPresentationTimestamp ?? 0.0,
+            drawableAcquired: drawableAcquired,
+            committed: secs.get())
+        commandBuffer.addCompletedHandler { [frameTelemetry] commandBuffer in
+            frameTelemetry.setGpuTimes(frameNumber: frameNumber, gpuStart: commandBuffer.gpuStartTime, gpuEnd: commandBuffer.gpuEndTime)
+            mglTraceInstantAt(mglTraceGpuDone, frameNumber, commandBuffer.gpuEndTime)
+        }
+        if #available(macOS 10.15.4, *) {
+            drawable.addPresentedHandler { [frameTelemetry] drawable in
+                frameTelemetry.setPresented(frameNumber: frameNumber, presented: drawable.presentedTime)
+                mglTraceInstantAt(mglTracePresented, frameNumber, drawable.presentedTime)
+            }
+        }
+        mglTraceBegin(mglTraceCommit, frameNumber)
+        commandBuffer.present(drawable)
+        commandBuffer.commit()
+        mglTraceEnd(mglTraceCommit, frameNumber)
     }
     
     // Wait for a flush command in-flight, as set up by setUpFlushInFlight().
@@ -81,16 +81,20 @@ fragment float4 fragment_dots(const VertexDotsOut in [[stage_in]],
 //\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/
 // Arcs
 //\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/
-struct VertexArcsIn {
-    float3 position [[ attribute(0) ]];
-    float4 color [[ attribute(1) ]];
-    float4 radii [[ attribute(2) ]];
-    float2 wedge [[ attribute(3) ]];
-    float border [[ attribute(4) ]];
-    float3 centerPosition [[ attribute(5) ]];
-    float2 viewportSize [[attribute(6)]];
+// One record per arc: [xyz rgba radii(4) wedge(2) border], see mglArcs.h
+struct ArcIn {
+    packed_float3 position;
+    packed_float4 color;
+    packed_float4 radii;
+    packed_float2 wedge;
+    float border;
 };
 
+// Which side of the square around the arc each of the 6 vertices is on.
+// These need to match mglArcCornerX and mglArcCornerY.
+constant float arcCornerX[6] = {-1, -1, 1, -1, 1, 1};
+constant float arcCornerY[6] = {-1, 1, 1, -1, -1, 1};
+
 struct VertexArcsOut {
     float4 position [[position]];
     float4 color;
@@ -103,16 +107,28 @@ struct VertexArcsOut {
     float2 halfBorderOuterRadiusRatio;
 };
 
-vertex VertexArcsOut vertex_arcs(const VertexArcsIn vertexIn [[ stage_in ]],
-                                 constant float4x4 &deg2metal [[buffer(1)]])
+vertex VertexArcsOut vertex_arcs(uint vertexId [[vertex_id]],
+                                 uint instanceId [[instance_id]],
+                                 const device ArcIn *arcs [[buffer(0)]],
+                                 constant float4x4 &deg2metal [[buffer(1)]],
+                                 constant float2 &viewportSize [[buffer(2)]])
 {
+    const ArcIn arc = arcs[instanceId];
+    float3 center = float3(arc.position);
+    float4 radii = float4(arc.radii);
+    float2 wedge = float2(arc.wedge);
+
+    // make the corners of a square around the arc, the radius is the outer radius + half the border
+    float2 corner = center.xy + float2(arcCornerX[vertexId] * (radii[1] + arc.border / 2.0), arcCornerY[vertexId] * (radii[3] + arc.border / 2.0));
+
     VertexArcsOut vertex_out {
-        .position = deg2metal * float4(vertexIn.position, 1.0),
-        .color = vertexIn.color,
+        .position = deg2metal * float4(corner, center.z, 1.0),
+        .color = float4(arc.color),
         .point_size = 0,
-        .start_angle = vertexIn.wedge[0],
-        .half_sweep = vertexIn.wedge[1] / 2.0,
-        .centerPosition = deg2metal * float4(vertexIn.centerPosition, 1.0),
+        .start_angle = wedge[0],
+        .half_sweep = wedge[1] / 2.0,
+        // the center position with y flipped
+        .centerPosition = deg2metal * float4(center.x, -center.y, center.z, 1.0),
         // compute the outerRadius in pixel coordinates. Note that the x and y
         // dimensions of the screen may be different (and the outer radius can be
         // different in x/y), so we are taking the projection
@@ -120,15 +136,15 @@ vertex VertexArcsOut vertex_arcs(const VertexArcsIn vertexIn [[ stage_in ]],
         // vector accounting for potential difference in the scaling of x and y. In
         // the end this value should be 1 if the pixel is at the outside radius, < 1
         // if it is inside that radius and > 1 if it is outside the radius
-        .outerRadius = float2((deg2metal[0][0] * vertexIn.radii[1] / 2.0) * vertexIn.viewportSize[0],(deg2metal[1][1] * vertexIn.radii[3] / 2.0) * vertexIn.viewportSize[1]),
-        .innerRadius = float2((deg2metal[0][0] * vertexIn.radii[0] / 2.0) * vertexIn.viewportSize[0],(deg2metal[1][1] * vertexIn.radii[2] / 2.0) * vertexIn.viewportSize[1]),
-        .halfBorderOuterRadiusRatio = float2((vertexIn.border/vertexIn.radii[1]) / 2.0,(vertexIn.border/vertexIn.radii[3]) / 2.0)
+        .outerRadius = float2((deg2metal[0][0] * radii[1] / 2.0) * viewportSize[0],(deg2metal[1][1] * radii[3] / 2.0) * viewportSize[1]),
+        .innerRadius = float2((deg2metal[0][0] * radii[0] / 2.0) * viewportSize[0],(deg2metal[1][1] * radii[2] / 2.0) * viewportSize[1]),
+        .halfBorderOuterRadiusRatio = float2((arc.border/radii[1]) / 2.0,(arc.border/radii[3]) / 2.0)
     };
     // convert the centerPosition into pixels
     // divide by homogenous component - probably not necessary, but doesn't hurt
     vertex_out.centerPosition /= vertex_out.centerPosition.w;
     // convert to pixels
-    vertex_out.centerPosition.xy = (vertex_out.centerPosition.xy * 0.5 + 0.5) * vertexIn.viewportSize;
+    vertex_out.centerPosition.xy = (vertex_out.centerPosition.xy * 0.5 + 0.5) * viewportSize;
     // return the vertex
     return(vertex_out);
 }
@@ -180,6 +196,177 @@ fragment float4 fragment_arcs(const VertexArcsOut in [[stage_in]]) {
     return float4(in.color[0], in.color[1], in.color[2], a);
 }
 
+//\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/
+// Instanced lines
+//\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/
+
+// One record per line: [x0 y0 x1 y1 width rgba], see mglInstancedLines.h
+struct InstancedLineIn {
+    packed_float2 start;
+    packed_float2 end;
+    float width;
+    packed_float4 color;
+};
+
+struct VertexInstancedLinesOut {
+    float4 position [[position]];
+    float4 color;
+};
+
+// Which corner of the quad each of the 6 vertices is: 0 is start + offset, 1 is end + offset,
+// 2 is end - offset and 3 is start - offset. This needs to match mglInstancedLineCorners.
+constant uint instancedLineCorners[6] = {0, 1, 2, 2, 3, 0};
+
+vertex VertexInstancedLinesOut vertex_instanced_lines(uint vertexId [[vertex_id]],
+                                                      uint instanceId [[instance_id]],
+                                                      const device InstancedLineIn *lines [[buffer(0)]],
+                                                      constant float4x4 &deg2metal [[buffer(1)]])
+{
+    const InstancedLineIn line = lines[instanceId];
+    float2 start = float2(line.start);
+    float2 end = float2(line.end);
+
+    // widen the line by its width, perpendicular to its heading
+    float angle = atan2(end.y - start.y, end.x - start.x);
+    float2 offset = 0.5 * line.width * float2(-sin(angle), cos(angle));
+    uint corner = instancedLineCorners[vertexId];
+    float2 position = ((corner == 0) || (corner == 3)) ? start : end;
+    position += (corner < 2) ? offset : -offset;
+
+    VertexInstancedLinesOut vertex_out {
+        .position = deg2metal * float4(position, 0.0, 1.0),
+        .color = float4(line.color)
+    };
+    return(vertex_out);
+}
+
+fragment float4 fragment_instanced_lines(VertexInstancedLinesOut in [[stage_in]]) {
+    return(in.color);
+}
+
+//\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/
+// Procedural gratings
+//\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/
+
+// One record per grating: [x y width height sf angle phase contrast sdx sdy alphaMask], see mglProceduralGratings.h
+struct ProceduralGratingIn {
+    packed_float2 center;
+    packed_float2 size;
+    float sf;
+    float angle;
+    float phase;
+    float contrast;
+    float sdx;
+    float sdy;
+    float alphaMask;
+};
+
+struct VertexProceduralGratingsOut {
+    float4 position [[position]];
+    // offset from the center of the grating, in device units
+    float2 offset;
+    // grating wave vector and phase in radians, as mglMakeGrating computes them
+    float2 k [[flat]];
+    float phase [[flat]];
+    float contrast [[flat]];
+    // 1/(2 sd^2) in x and y, and the clamp, which are 0 for no envelope
+    float3 envelope [[flat]];
+    float alphaMask [[flat]];
+};
+
+// Corners of the quad for each of the 6 vertices, two triangles in the same order as mglInstancedLineCorners.
+constant float2 proceduralGratingCorners[6] = {
+    float2(-0.5, 0.5), float2(0.5, 0.5), float2(0.5, -0.5),
+    float2(0.5, -0.5), float2(-0.5, -0.5), float2(-0.5, 0.5)
+};
+
+vertex VertexProceduralGratingsOut vertex_procedural_gratings(uint vertexId [[vertex_id]],
+                                                              uint instanceId [[instance_id]],
+                                                              const device ProceduralGratingIn *gratings [[buffer(0)]],
+                                                              constant float4x4 &deg2metal [[buffer(1)]])
+{
+    const ProceduralGratingIn grating = gratings[instanceId];
+    float2 offset = proceduralGratingCorners[vertexId] * float2(grating.size);
+    float angle = M_PI_F * (grating.angle - 90) / 180;
+    bool hasEnvelope = (grating.sdx > 0) && (grating.sdy > 0);
+
+    VertexProceduralGratingsOut vertex_out {
+        .position = deg2metal * float4(float2(grating.center) + offset, 0.0, 1.0),
+        .offset = offset,
+        .k = 2 * M_PI_F * grating.sf * float2(precise::cos(angle), precise::sin(angle)),
+        .phase = M_PI_F * grating.phase / 180,
+        .contrast = grating.contrast,
+        .envelope = hasEnvelope ? float3(1 / (2 * grating.sdx * grating.sdx), 1 / (2 * grating.sdy * grating.sdy), 0.01) : float3(0),
+        .alphaMask = grating.alphaMask
+    };
+    return(vertex_out);
+}
+
+// y is flipped so that the grating looks like an mglMakeGrating texture would, see mglProceduralGratingValue.
+fragment float4 fragment_procedural_gratings(VertexProceduralGratingsOut in [[stage_in]]) {
+    float grating = precise::cos(in.k.x * in.offset.x - in.k.y * in.offset.y + in.phase);
+    float envelope = precise::exp(-(in.offset.x * in.offset.x * in.envelope.x + in.offset.y * in.offset.y * in.envelope.y));
+    if (envelope < in.envelope.z) {
+        envelope = 0;
+    }
+    if (in.alphaMask > 0) {
+        return(float4(float3((in.contrast * grating + 1) / 2), envelope));
+    }
+    return(float4(float3((in.contrast * grating * envelope + 1) / 2), 1));
+}
+
+//\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/
+// Sprites
+//\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/
+
+// One record per sprite: [x y width height rotation alpha u0 v0 u1 v1 textureNumber], see mglBltSpritesCommand
+struct SpriteIn {
+    packed_float2 center;
+    packed_float2 size;
+    float rotation;
+    float alpha;
+    packed_float2 uvTopLeft;
+    packed_float2 uvBottomRight;
+    float textureNumber;
+};
+
+struct VertexSpritesOut {
+    float4 position [[position]];
+    float2 texCoords;
+    float alpha [[flat]];
+};
+
+vertex VertexSpritesOut vertex_sprites(uint vertexId [[vertex_id]],
+                                       uint instanceId [[instance_id]],
+                                       const device SpriteIn *sprites [[buffer(0)]],
+                                       constant float4x4 &deg2metal [[buffer(1)]])
+{
+    const SpriteIn sprite = sprites[instanceId];
+    float2 corner = proceduralGratingCorners[vertexId];
+
+    // rotate counterclockwise about the center, as mglMetalBltTexture does
+    float angle = M_PI_F * sprite.rotation / 180;
+    float2 offset = corner * float2(sprite.size);
+    offset = float2(offset.x * cos(angle) - offset.y * sin(angle), offset.x * sin(angle) + offset.y * cos(angle));
+
+    // texture coordinates have +Y going down, opposite of vertices
+    float2 uvTopLeft = float2(sprite.uvTopLeft);
+    float2 uvBottomRight = float2(sprite.uvBottomRight);
+    VertexSpritesOut vertex_out {
+        .position = deg2metal * float4(float2(sprite.center) + offset, 0.0, 1.0),
+        .texCoords = mix(uvTopLeft, uvBottomRight, float2(corner.x + 0.5, 0.5 - corner.y)),
+        .alpha = sprite.alpha
+    };
+    return(vertex_out);
+}
+
+fragment float4 fragment_sprites(VertexSpritesOut in [[stage_in]],
+                                 texture2d<float> myTexture [[texture(0)]],
+                                 sampler mySampler [[sampler(0)]]) {
+    float4 c = myTexture.sample(mySampler, in.texCoords);
+    return(float4(c[0], c[1], c[2], c[3] * in.alpha));
+}
+
 //\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/
 // Textures
 //\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/
@@ -0,0 +1,207 @@
+//
+//  mglTextureBudget.h
+//  mglMetal
+//
+//  Created by justin gardner on 10/19/26.
+//  Copyright © 2026 GRU. All rights reserved.
+//
+
+#ifndef mglTextureBudget_h
+#define mglTextureBudget_h
+
+#include <stdint.h>
+#include <stdlib.h>
+
+// Bookkeeping for a texture memory budget, used by mglColorRenderingState.
+// With about 1 GB of textures loaded, getting the next drawable can stall for 7-14 ms (see mglRenderer2).
+// With a budget set, the least recently used textures are spilled out of GPU memory, compressed into
+// host memory, when making or restoring a texture would go over the budget, and are restored when
+// they are next used. This decides which textures to spill and keeps the counts that mglInfo reports.
+// mglColorRenderingState does the spilling and restoring that it decides on.
+// This is plain C so that the policy can be tested without Metal, against a fake texture store.
+
+typedef struct {
+    uint32_t textureNumber;
+    // bytes the texture takes on the GPU, and compressed in host memory when spilled
+    uint64_t bytes;
+    uint64_t compressedBytes;
+    // the frame the texture was made or last used in, to find the least recently used
+    uint64_t lastUsedFrame;
+    // one more than the frame the texture was last used in, or 0 when not used since it was made
+    uint64_t usedInFrame;
+    int resident;
+    // pinned textures are never spilled, for example render targets, whose contents are only on the GPU
+    int pinned;
+} mglTextureBudgetEntry;
+
+typedef struct {
+    // 0 for no budget, which keeps all textures resident
+    uint64_t budgetBytes;
+    mglTextureBudgetEntry *entries;
+    uint32_t entryCount;
+    uint32_t entryCapacity;
+    // counts for mglInfo
+    uint32_t residentCount;
+    uint64_t residentBytes;
+    uint32_t spilledCount;
+    uint64_t spilledBytes;
+    uint64_t compressedBytes;
+    uint64_t spillCount;
+    uint64_t restoreCount;
+} mglTextureBudget;
+
+// Find the entry for a texture, or NULL.
+static inline mglTextureBudgetEntry *mglTextureBudgetFind(mglTextureBudget *budget, uint32_t textureNumber) {
+    for (uint32_t i = 0; i < budget->entryCount; i++) {
+        if (budget->entries[i].textureNumber == textureNumber) {
+            return &budget->entries[i];
+        }
+    }
+    return NULL;
+}
+
+// Start keeping track of a new, resident texture. Returns 0 if there was no memory to keep track of it.
+static inline int mglTextureBudgetAdd(mglTextureBudget *budget, uint32_t textureNumber, uint64_t bytes, uint64_t frame) {
+    if (budget->entryCount == budget->entryCapacity) {
+        uint32_t newCapacity = budget->entryCapacity ? 2 * budget->entryCapacity : 64;
+        mglTextureBudgetEntry *newEntries = (mglTextureBudgetEntry *)realloc(budget->entries, newCapacity * sizeof(mglTextureBudgetEntry));
+        if (newEntries == NULL) {
+            return 0;
+        }
+        budget->entries = newEntries;
+        budget->entryCapacity = newCapacity;
+    }
+    mglTextureBudgetEntry *entry = &budget->entries[budget->entryCount++];
+    entry->textureNumber = textureNumber;
+    entry->bytes = bytes;
+    entry->compressedBytes = 0;
+    entry->lastUsedFrame = frame;
+    entry->usedInFrame = 0;
+    entry->resident = 1;
+    entry->pinned = 0;
+    budget->residentCount++;
+    budget->residentBytes += bytes;
+    return 1;
+}
+
+// Stop keeping track of a deleted texture. Returns 0 if it was not being kept track of.
+static inline int mglTextureBudgetRemove(mglTextureBudget *budget, uint32_t textureNumber) {
+    mglTextureBudgetEntry *entry = mglTextureBudgetFind(budget, textureNumber);
+    if (entry == NULL) {
+        return 0;
+    }
+    if (entry->resident) {
+        budget->residentCount--;
+        budget->residentBytes -= entry->bytes;
+    } else {
+        budget->spilledCount--;
+        budget->spilledBytes -= entry->bytes;
+        budget->compressedBytes -= entry->compressedBytes;
+    }
+    *entry = budget->entries[--budget->entryCount];
+    return 1;
+}
+
+// Note that a texture is used in the frame being drawn.
+// Returns 1 if it is resident, 0 if it is spilled and has to be restored first, or -1 if it is unknown.
+static inline int mglTextureBudgetUse(mglTextureBudget *budget, uint32_t textureNumber, uint64_t frame) {
+    mglTextureBudgetEntry *entry = mglTextureBudgetFind(budget, textureNumber);
+    if (entry == NULL) {
+        return -1;
+    }
+    entry->lastUsedFrame = frame;
+    entry->usedInFrame = frame + 1;
+    return entry->resident;
+}
+
+// Keep a texture resident from now on.
+static inline void mglTextureBudgetPin(mglTextureBudget *budget, uint32_t textureNumber) {
+    mglTextureBudgetEntry *entry = mglTextureBudgetFind(budget, textureNumber);
+    if (entry != NULL) {
+        entry->pinned = 1;
+    }
+}
+
+// Sort spill candidates oldest first, and by texture number among textures last used in the same frame.
+static int mglTextureBudgetCompare(const void *a, const void *b) {
+    const mglTextureBudgetEntry *entryA = *(const mglTextureBudgetEntry * const *)a;
+    const mglTextureBudgetEntry *entryB = *(const mglTextureBudgetEntry * const *)b;
+    if (entryA->lastUsedFrame != entryB->lastUsedFrame) {
+        return (entryA->lastUsedFrame < entryB->lastUsedFrame) ? -1 : 1;
+    }
+    return (entryA->textureNumber < entryB->textureNumber) ? -1 : (entryA->textureNumber > entryB->textureNumber);
+}
+
+// Choose which textures to spill so that bytesNeeded more would fit in the budget, least recently used first.
+// Textures that are pinned or used in the frame being drawn are not chosen, so the budget can still be
+// gone over if they alone take more. Fills in up to maxVictims texture numbers and returns how many.
+static inline uint32_t mglTextureBudgetChooseSpills(mglTextureBudget *budget, uint64_t bytesNeeded, uint64_t frame, uint32_t *victims, uint32_t maxVictims) {
+    if ((budget->budgetBytes == 0) || (budget->residentBytes + bytesNeeded <= budget->budgetBytes) || (budget->entryCount == 0)) {
+        return 0;
+    }
+    uint64_t bytesToFree = budget->residentBytes + bytesNeeded - budget->budgetBytes;
+
+    mglTextureBudgetEntry **candidates = (mglTextureBudgetEntry **)malloc(budget->entryCount * sizeof(mglTextureBudgetEntry *));
+    if (candidates == NULL) {
+        return 0;
+    }
+    uint32_t candidateCount = 0;
+    for (uint32_t i = 0; i < budget->entryCount; i++) {
+        mglTextureBudgetEntry *entry = &budget->entries[i];
+        if (entry->resident && !entry->pinned && (entry->usedInFrame != frame + 1)) {
+            candidates[candidateCount++] = entry;
+        }
+    }
+    qsort(candidates, candidateCount, sizeof(mglTextureBudgetEntry *), mglTextureBudgetCompare);
+
+    uint32_t victimCount = 0;
+    uint64_t bytesFreed = 0;
+    for (uint32_t i = 0; (i < candidateCount) && (victimCount < maxVictims) && (bytesFreed < bytesToFree); i++) {
+        victims[victimCount++] = candidates[i]->textureNumber;
+        bytesFreed += candidates[i]->bytes;
+    }
+    free(candidates);
+    return victimCount;
+}
+
+// Note that a texture was spilled, taking compressedBytes of host memory.
+static inline void mglTextureBudgetSpilled(mglTextureBudget *budget, uint32_t textureNumber, uint64_t compressedBytes) {
+    mglTextureBudgetEntry *entry = mglTextureBudgetFind(budget, textureNumber);
+    if ((entry == NULL) || !entry->resident) {
+        return;
+    }
+    entry->resident = 0;
+    entry->compressedBytes = compressedBytes;
+    budget->residentCount--;
+    budget->residentBytes -= entry->bytes;
+    budget->spilledCount++;
+    budget->spilledBytes += entry->bytes;
+    budget->compressedBytes += compressedBytes;
+    budget->spillCount++;
+}
+
+// Note that a spilled texture was restored to GPU memory.
+static inline void mglTextureBudgetRestored(mglTextureBudget *budget, uint32_t textureNumber) {
+    mglTextureBudgetEntry *entry = mglTextureBudgetFind(budget, textureNumber);
+    if ((entry == NULL) || entry->resident) {
+        return;
+    }
+    entry->resident = 1;
+    budget->spilledCount--;
+    budget->spilledBytes -= entry->bytes;
+    budget->compressedBytes -= entry->compressedBytes;
+    entry->compressedBytes = 0;
+    budget->residentCount++;
+    budget->residentBytes += entry->bytes;
+    budget->restoreCount++;
+}
+
+// Let go of the bookkeeping.
+static inline void mglTextureBudgetFree(mglTextureBudget *budget) {
+    free(budget->entries);
+    budget->entries = NULL;
+    budget->entryCount = 0;
+    budget->entryCapacity = 0;
+}
+
+#endif /* mglTextureBudget_h */
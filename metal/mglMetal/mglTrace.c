@@ -0,0 +1,318 @@
+//
+//  mglTrace.c
+//  mglMetal
+//
+//  Created by justin gardner on 10/19/26.
+//  Copyright © 2026 GRU. All rights reserved.
+//
+
+#include "mglTrace.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// How long the flusher thread sleeps between draining the buffers.
+#define MGL_TRACE_FLUSH_NANOSECONDS 5000000
+
+static const char *mglTraceEventNames[mglTraceEventCount] = {
+    "readAny",
+    "awaitCommand",
+    "nondrawingWork",
+    "draw",
+    "acquireDrawable",
+    "commit",
+    "presented",
+    "gpuDone",
+    "dropped"
+};
+
+// One thread's ring buffer.  Only the owning thread moves head, and only the flusher moves tail.
+// A buffer whose thread has exited is given to the next new thread that traces.
+typedef struct mglTraceBuffer {
+    _Atomic uint64_t head;
+    _Atomic uint64_t tail;
+    _Atomic uint64_t dropped;
+    _Atomic int owned;
+    uint32_t thread;
+    mglTraceRecord records[MGL_TRACE_BUFFER_RECORDS];
+} mglTraceBuffer;
+
+static mglTraceBuffer *_Atomic mglTraceBuffers[MGL_TRACE_MAX_THREADS];
+static _Atomic uint32_t mglTraceThreadCount = 0;
+static _Atomic int mglTraceOn = 0;
+
+static pthread_once_t mglTraceOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t mglTraceBufferKey;
+static pthread_mutex_t mglTraceStartStopMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t mglTraceFlusher;
+static FILE *mglTraceFile = NULL;
+
+//\/\/\/\/\/\/\/\/\/\/\/\/\/\/
+// mglTraceNow
+//\/\/\/\/\/\/\/\/\/\/\/\/\/\/
+// Nanoseconds on the same clock as mglSecs (mach_absolute_time), or the monotonic clock elsewhere.
+static uint64_t mglTraceNow(void)
+{
+#ifdef __APPLE__
+    return clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+#endif
+}
+
+//\/\/\/\/\/\/\/\/\/\/\/\/\/\/
+// mglTraceReleaseBuffer
+//\/\/\/\/\/\/\/\/\/\/\/\/\/\/
+// Called when a thread exits, so its buffer can go to another thread.
+static void mglTraceReleaseBuffer(void *buffer)
+{
+    atomic_store_explicit(&((mglTraceBuffer *)buffer)->owned, 0, memory_order_release);
+}
+
+static void mglTraceInit(void)
+{
+    pthread_key_create(&mglTraceBufferKey, mglTraceReleaseBuffer);
+}
+
+//\/\/\/\/\/\/\/\/\/\/\/\/\/\/
+// mglTraceGetBuffer
+//\/\/\/\/\/\/\/\/\/\/\/\/\/\/
+// Get this thread's buffer, claiming a released buffer or making a new one the first time.
+static mglTraceBuffer *mglTraceGetBuffer(void)
+{
+    pthread_once(&mglTraceOnce, mglTraceInit);
+    mglTraceBuffer *buffer = pthread_getspecific(mglTraceBufferKey);
+    if (buffer != NULL) {
+        return buffer;
+    }
+
+    // Claim a buffer that a thread released, or a free slot for a new buffer.
+    for (int i = 0; i < MGL_TRACE_MAX_THREADS; i++) {
+        mglTraceBuffer *existing = atomic_load_explicit(&mglTraceBuffers[i], memory_order_acquire);
+        if (existing == NULL) {
+            mglTraceBuffer *newBuffer = calloc(1, sizeof(mglTraceBuffer));
+            if (newBuffer == NULL) {
+                return NULL;
+            }
+            atomic_store_explicit(&newBuffer->owned, 1, memory_order_relaxed);
+            newBuffer->thread = atomic_fetch_add(&mglTraceThreadCount, 1) + 1;
+            mglTraceBuffer *expectedNull = NULL;
+            if (atomic_compare_exchange_strong(&mglTraceBuffers[i], &expectedNull, newBuffer)) {
+                buffer = newBuffer;
+                break;
+            }
+            // Another thread took this slot first, try the next one.
+            free(newBuffer);
+            continue;
+        }
+        int expectedReleased = 0;
+        if (atomic_compare_exchange_strong(&existing->owned, &expectedReleased, 1)) {
+            existing->thread = atomic_fetch_add(&mglTraceThreadCount, 1) + 1;
+            buffer = existing;
+            break;
+        }
+    }
+
+    // With too many threads, this one just doesn't get traced.
+    if (buffer != NULL) {
+        pthread_setspecific(mglTraceBufferKey, buffer);
+    }
+    return buffer;
+}
+
+//\/\/\/\/\/\/\/\/\/\/\/\/\/\/
+// mglTraceRecordEvent
+//\/\/\/\/\/\/\/\/\/\/\/\/\/\/
+static void mglTraceRecordEvent(mglTraceEvent event, mglTracePhase phase, uint64_t arg, uint64_t time)
+{
+    mglTraceBuffer *buffer = mglTraceGetBuffer();
+    if (buffer == NULL) {
+        return;
+    }
+
+    uint64_t head = atomic_load_explicit(&buffer->head, memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(&buffer->tail, memory_order_acquire);
+    if (head - tail >= MGL_TRACE_BUFFER_RECORDS) {
+        atomic_fetch_add_explicit(&buffer->dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    mglTraceRecord *record = &buffer->records[head % MGL_TRACE_BUFFER_RECORDS];
+    record->time = time;
+    record->arg = arg;
+    record->event = event;
+    record->phase = phase;
+    record->reserved = 0;
+    record->thread = buffer->thread;
+    atomic_store_explicit(&buffer->head, head + 1, memory_order_release);
+}
+
+//\/\/\/\/\/\/\/\/\/\/\/\/\/\/
+// mglTraceDrain
+//\/\/\/\/\/\/\/\/\/\/\/\/\/\/
+// Write out everything in all the buffers, called only from the flusher (or with the flusher stopped).
+static void mglTraceDrain(void)
+{
+    for (int i = 0; i < MGL_TRACE_MAX_THREADS; i++) {
+        mglTraceBuffer *buffer = atomic_load_explicit(&mglTraceBuffers[i], memory_order_acquire);
+        if (buffer == NULL) {
+            continue;
+        }
+        uint64_t head = atomic_load_explicit(&buffer->head, memory_order_acquire);
+        uint64_t tail = atomic_load_explicit(&buffer->tail, memory_order_relaxed);
+        while (tail < head) {
+            // Write up to the end of the ring, then around again.
+            uint64_t start = tail % MGL_TRACE_BUFFER_RECORDS;
+            uint64_t count = head - tail;
+            if (start + count > MGL_TRACE_BUFFER_RECORDS) {
+                count = MGL_TRACE_BUFFER_RECORDS - start;
+            }
+            fwrite(&buffer->records[start], sizeof(mglTraceRecord), count, mglTraceFile);
+            tail += count;
+        }
+        atomic_store_explicit(&buffer->tail, tail, memory_order_release);
+    }
+}
+
+//\/\/\/\/\/\/\/\/\/\/\/\/\/\/
+// mglTraceFlush
+//\/\/\/\/\/\/\/\/\/\/\/\/\/\/
+// The flusher thread drains the buffers every few milliseconds until tracing stops.
+static void *mglTraceFlush(void *unused)
+{
+    struct timespec sleepTime = { 0, MGL_TRACE_FLUSH_NANOSECONDS };
+    while (atomic_load_explicit(&mglTraceOn, memory_order_acquire)) {
+        mglTraceDrain();
+        nanosleep(&sleepTime, NULL);
+    }
+    mglTraceDrain();
+    return NULL;
+}
+
+//\/\/\/\/\/\/\/\/\/\/\/\/\/\/
+// mglTraceStart
+//\/\/\/\/\/\/\/\/\/\/\/\/\/\/
+int mglTraceStart(const char *path)
+{
+    mglTraceStop();
+
+    pthread_mutex_lock(&mglTraceStartStopMutex);
+    mglTraceFile = fopen(path, "wb");
+    if (mglTraceFile == NULL) {
+        pthread_mutex_unlock(&mglTraceStartStopMutex);
+        return 0;
+    }
+
+    // The header says what's in the file and names the events.
+    uint32_t header[4] = { MGL_TRACE_VERSION, sizeof(mglTraceRecord), mglTraceEventCount, MGL_TRACE_EVENT_NAME_BYTES };
+    fwrite(MGL_TRACE_MAGIC, 1, strlen(MGL_TRACE_MAGIC), mglTraceFile);
+    fwrite(header, sizeof(uint32_t), 4, mglTraceFile);
+    for (int i = 0; i < mglTraceEventCount; i++) {
+        char name[MGL_TRACE_EVENT_NAME_BYTES] = { 0 };
+        strncpy(name, mglTraceEventNames[i], MGL_TRACE_EVENT_NAME_BYTES - 1);
+        fwrite(name, 1, MGL_TRACE_EVENT_NAME_BYTES, mglTraceFile);
+    }
+
+    // Forget anything left over from a previous trace.
+    for (int i = 0; i < MGL_TRACE_MAX_THREADS; i++) {
+        mglTraceBuffer *buffer = atomic_load_explicit(&mglTraceBuffers[i], memory_order_acquire);
+        if (buffer == NULL) {
+            continue;
+        }
+        atomic_store_explicit(&buffer->tail, atomic_load_explicit(&buffer->head, memory_order_acquire), memory_order_release);
+        atomic_store_explicit(&buffer->dropped, 0, memory_order_relaxed);
+    }
+
+    atomic_store_explicit(&mglTraceOn, 1, memory_order_release);
+    if (pthread_create(&mglTraceFlusher, NULL, mglTraceFlush, NULL) != 0) {
+        atomic_store_explicit(&mglTraceOn, 0, memory_order_release);
+        fclose(mglTraceFile);
+        mglTraceFile = NULL;
+        pthread_mutex_unlock(&mglTraceStartStopMutex);
+        return 0;
+    }
+    pthread_mutex_unlock(&mglTraceStartStopMutex);
+    return 1;
+}
+
+//\/\/\/\/\/\/\/\/\/\/\/\/\/\/
+// mglTraceStop
+//\/\/\/\/\/\/\/\/\/\/\/\/\/\/
+void mglTraceStop(void)
+{
+    pthread_mutex_lock(&mglTraceStartStopMutex);
+    if (mglTraceFile == NULL) {
+        pthread_mutex_unlock(&mglTraceStartStopMutex);
+        return;
+    }
+
+    // The flusher drains what's left when it sees tracing is off.
+    atomic_store_explicit(&mglTraceOn, 0, memory_order_release);
+    pthread_join(mglTraceFlusher, NULL);
+
+    // Note how many records each thread dropped, if any.
+    uint64_t now = mglTraceNow();
+    for (int i = 0; i < MGL_TRACE_MAX_THREADS; i++) {
+        mglTraceBuffer *buffer = atomic_load_explicit(&mglTraceBuffers[i], memory_order_acquire);
+        if (buffer == NULL) {
+            continue;
+        }
+        uint64_t dropped = atomic_load_explicit(&buffer->dropped, memory_order_relaxed);
+        if (dropped > 0) {
+            mglTraceRecord record = { now, dropped, mglTraceDropped, mglTracePhaseInstant, 0, buffer->thread };
+            fwrite(&record, sizeof(mglTraceRecord), 1, mglTraceFile);
+        }
+    }
+
+    fclose(mglTraceFile);
+    mglTraceFile = NULL;
+    pthread_mutex_unlock(&mglTraceStartStopMutex);
+}
+
+int mglTraceIsOn(void)
+{
+    return atomic_load_explicit(&mglTraceOn, memory_order_relaxed);
+}
+
+void mglTraceBegin(mglTraceEvent event, uint64_t arg)
+{
+    if (!atomic_load_explicit(&mglTraceOn, memory_order_relaxed)) {
+        return;
+    }
+    mglTraceRecordEvent(event, mglTracePhaseBegin, arg, mglTraceNow());
+}
+
+void mglTraceEnd(mglTraceEvent event, uint64_t arg)
+{
+    if (!atomic_load_explicit(&mglTraceOn, memory_order_relaxed)) {
+        return;
+    }
+    mglTraceRecordEvent(event, mglTracePhaseEnd, arg, mglTraceNow());
+}
+
+void mglTraceInstant(mglTraceEvent event, uint64_t arg)
+{
+    if (!atomic_load_explicit(&mglTraceOn, memory_order_relaxed)) {
+        return;
+    }
+    mglTraceRecordEvent(event, mglTracePhaseInstant, arg, mglTraceNow());
+}
+
+void mglTraceInstantAt(mglTraceEvent event, uint64_t arg, double seconds)
+{
+    if (!atomic_load_explicit(&mglTraceOn, memory_order_relaxed)) {
+        return;
+    }
+    mglTraceRecordEvent(event, mglTracePhaseInstant, arg, seconds > 0 ? (uint64_t)(seconds * 1e9) : mglTraceNow());
+}
+
+const char *mglTraceEventName(mglTraceEvent event)
+{
+    return event < mglTraceEventCount ? mglTraceEventNames[event] : "unknown";
+}
@@ -0,0 +1,109 @@
+//
+//  mglTrace.h
+//  mglMetal
+//
+//  Created by justin gardner on 10/19/26.
+//  Copyright © 2026 GRU. All rights reserved.
+//
+
+#ifndef mglTrace_h
+#define mglTrace_h
+
+#include <stdint.h>
+
+// A low-overhead trace of what the render loop is doing, cheap enough to leave on while running an experiment.
+// Each thread that traces gets its own ring buffer of fixed-size binary records, which only that thread writes,
+// and a background thread drains all the buffers to a file. So tracing never takes a lock or touches the file.
+// If a buffer fills up because the file can't keep up, new records are dropped and counted, rather than waiting.
+// When tracing is off, each trace call is just a check of one flag.
+//
+// The file starts with a header that names the events, followed by records in the order they were drained.
+// Records from one thread are in order, but records from different threads are interleaved.
+// mgllib/mglMetalTraceToChrome converts the file to the Chrome trace / Perfetto JSON format.
+//
+// This is plain C with no Apple dependencies, so that it can be tested on its own.
+
+// Compilers without enums of a fixed type (gcc before C23) get the same values as constants of a type
+// the same size, as in mglCommandTypes.h.
+#if defined(__clang__) || defined(__cplusplus) || (defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 202311L))
+#define MGL_TRACE_FIXED_ENUM
+#endif
+
+// Events that can be traced.  New events should go at the end so that old trace files can still be read.
+#ifdef MGL_TRACE_FIXED_ENUM
+typedef enum mglTraceEvent : uint16_t {
+#else
+typedef uint16_t mglTraceEvent;
+enum {
+#endif
+    mglTraceReadAny = 0,
+    mglTraceAwaitCommand = 1,
+    mglTraceNondrawingWork = 2,
+    mglTraceDraw = 3,
+    mglTraceAcquireDrawable = 4,
+    mglTraceCommit = 5,
+    mglTracePresented = 6,
+    mglTraceGpuDone = 7,
+    mglTraceDropped = 8,
+    mglTraceEventCount = 9
+#ifdef MGL_TRACE_FIXED_ENUM
+} mglTraceEvent;
+#else
+};
+#endif
+
+// Record phases, as in the Chrome trace format: duration begin and end, or an instant.
+#ifdef MGL_TRACE_FIXED_ENUM
+typedef enum mglTracePhase : uint8_t {
+#else
+typedef uint8_t mglTracePhase;
+enum {
+#endif
+    mglTracePhaseBegin = 'B',
+    mglTracePhaseEnd = 'E',
+    mglTracePhaseInstant = 'i'
+#ifdef MGL_TRACE_FIXED_ENUM
+} mglTracePhase;
+#else
+};
+#endif
+
+// One trace record, as written to the file.
+// The arg depends on the event, for example the command code for mglTraceDraw, or a frame number.
+typedef struct mglTraceRecord {
+    uint64_t time;
+    uint64_t arg;
+    uint16_t event;
+    uint8_t phase;
+    uint8_t reserved;
+    uint32_t thread;
+} mglTraceRecord;
+
+#define MGL_TRACE_MAGIC "MGLTRACE"
+#define MGL_TRACE_VERSION 1
+#define MGL_TRACE_EVENT_NAME_BYTES 32
+#define MGL_TRACE_BUFFER_RECORDS 16384
+#define MGL_TRACE_MAX_THREADS 64
+
+// Start tracing to the given file, replacing it if it exists.  Returns 1 on success, 0 on failure.
+int mglTraceStart(const char *path);
+
+// Stop tracing, drain what's left, and close the file.
+void mglTraceStop(void);
+
+// Whether tracing is on.
+int mglTraceIsOn(void);
+
+// Record the beginning or end of a duration event, or an instant event, now on this thread.
+void mglTraceBegin(mglTraceEvent event, uint64_t arg);
+void mglTraceEnd(mglTraceEvent event, uint64_t arg);
+void mglTraceInstant(mglTraceEvent event, uint64_t arg);
+
+// Record an instant event that happened at a given time, in seconds on the same clock as mglSecs,
+// for example when the system reports that a frame was presented.  A time of 0 or less means now.
+void mglTraceInstantAt(mglTraceEvent event, uint64_t arg, double seconds);
+
+// The names of the events, as written to the file.
+const char *mglTraceEventName(mglTraceEvent event);
+
+#endif /* mglTrace_h */
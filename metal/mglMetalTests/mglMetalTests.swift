@@ -400,4 +400,613 @@ class mglMetalTests: XCTestCase {
         assertCommandResultsReply(commandCode: mglFlush)
         XCTAssertFalse(client.dataWaiting())
     }
+
+    func testDisplayListInMemory() {
+        // Create a texture for offscreen rendering and make it the target.
+        let createTexture = mglCreateTextureCommand(texture: offscreenTexture)
+        commandInterface.addLast(command: createTexture)
+        drawNextFrame()
+        assertSuccess(command: createTexture)
+        let setRenderTarget = mglSetRenderTargetCommand(textureNumber: createTexture.textureNumber)
+        commandInterface.addLast(command: setRenderTarget)
+        drawNextFrame()
+        assertSuccess(command: setRenderTarget)
+
+        // Record a display list that clears to red.
+        let displayList = mglDisplayList()
+        XCTAssertTrue(displayList.record(command: mglSetClearColorCommand(red: 1.0, green: 0.0, blue: 0.0)))
+        XCTAssertFalse(displayList.failed)
+        let displayListNumber = commandInterface.addDisplayList(displayList: displayList)
+
+        // Call it with the clear color swapped for blue.
+        let blueCall = mglCallDisplayListCommand(
+            displayListNumber: displayListNumber,
+            displayList: displayList,
+            parameters: [(commandIndex: 0, parameter: .color(simd_make_float3(0.0, 0.0, 1.0)))]
+        )
+        commandInterface.addLast(command: blueCall)
+        commandInterface.addLast(command: mglFlushCommand())
+        drawNextFrame()
+        drawNextFrame()
+        assertSuccess(command: blueCall)
+        assertAllOffscreenPixels(expectedPixel: RGBAFloat32Pixel(r: 0.0, g: 0.0, b: 1.0, a: 1.0))
+
+        // Call it again with no parameters, which should replay red as recorded.
+        let redCall = mglCallDisplayListCommand(displayListNumber: displayListNumber, displayList: displayList)
+        commandInterface.addLast(command: redCall)
+        commandInterface.addLast(command: mglFlushCommand())
+        drawNextFrame()
+        drawNextFrame()
+        assertSuccess(command: redCall)
+        assertAllOffscreenPixels(expectedPixel: RGBAFloat32Pixel(r: 1.0, g: 0.0, b: 0.0, a: 1.0))
+
+        // A parameter that doesn't fit the recorded command should fail the call.
+        let badCall = mglCallDisplayListCommand(
+            displayListNumber: displayListNumber,
+            displayList: displayList,
+            parameters: [(commandIndex: 0, parameter: .textureNumber(1))]
+        )
+        commandInterface.addLast(command: badCall)
+        drawNextFrame()
+        XCTAssertFalse(badCall.results.success)
+    }
+
+    func testDisplayListViaClientBytes() {
+        // Start recording a display list.
+        sendCommandCode(commandCode: mglStartDisplayList)
+        drawNextFrame()
+        assertTimestampReply()
+
+        // Record a clear color command, which should get a placeholder result and not be processed.
+        sendCommandCode(commandCode: mglSetClearColor)
+        sendColor(r: 1.0, g: 0.0, b: 0.0)
+        drawNextFrame()
+        assertTimestampReply()
+        assertCommandResultsReply(commandCode: mglSetClearColor)
+        assertViewClearColor(r: 0.5, g: 0.5, b: 0.5)
+
+        // Finish recording, which should report the display list number and command count.
+        sendCommandCode(commandCode: mglFinishDisplayList)
+        drawNextFrame()
+        assertTimestampReply()
+        assertUInt32Reply(expected: 1)
+        assertUInt32Reply(expected: 1)
+        XCTAssertFalse(client.dataWaiting())
+
+        // Call the display list with the clear color swapped for green, then flush.
+        sendCommandCode(commandCode: mglCallDisplayList)
+        sendUInt32(value: 1)
+        sendUInt32(value: 1)
+        sendUInt32(value: 0)
+        sendUInt32(value: mglDisplayListParameter.colorKind)
+        sendColor(r: 0.0, g: 1.0, b: 0.0)
+        sendCommandCode(commandCode: mglFlush)
+        drawNextFrame(sleepSecs: 0.5)
+        assertViewClearColor(r: 0.0, g: 1.0, b: 0.0)
+        assertTimestampReply()
+        assertCommandResultsReply(commandCode: mglCallDisplayList)
+        assertTimestampReply()
+        drawNextFrame()
+        assertCommandResultsReply(commandCode: mglFlush)
+
+        // Delete the display list, then calling it should fail.
+        sendCommandCode(commandCode: mglDeleteDisplayList)
+        sendUInt32(value: 1)
+        drawNextFrame()
+        assertTimestampReply()
+        assertUInt32Reply(expected: 1)
+
+        sendCommandCode(commandCode: mglCallDisplayList)
+        sendUInt32(value: 1)
+        sendUInt32(value: 0)
+        drawNextFrame()
+        assertTimestampReply()
+        assertCommandResultsReply(commandCode: mglCallDisplayList, status: 0, processedAtLeast: -Double.greatestFiniteMagnitude)
+        XCTAssertFalse(client.dataWaiting())
+    }
+
+    func testDisplayListRejectsFlushViaClientBytes() {
+        sendCommandCode(commandCode: mglStartDisplayList)
+        drawNextFrame()
+        assertTimestampReply()
+
+        // A flush can't be recorded, so it should get a failure result right away.
+        sendCommandCode(commandCode: mglFlush)
+        drawNextFrame()
+        assertTimestampReply()
+        assertCommandResultsReply(commandCode: mglFlush, status: 0, processedAtLeast: -Double.greatestFiniteMagnitude)
+
+        // And the display list should not be kept.
+        sendCommandCode(commandCode: mglFinishDisplayList)
+        drawNextFrame()
+        assertTimestampReply()
+        assertUInt32Reply(expected: 0)
+        assertUInt32Reply(expected: 0)
+        XCTAssertFalse(client.dataWaiting())
+    }
+
+    func testDisplayListRejectsUnknownCommandViaClientBytes() {
+        sendCommandCode(commandCode: mglStartDisplayList)
+        drawNextFrame()
+        assertTimestampReply()
+
+        // An unknown command can't be read, so it gets only the ack timestamp.
+        sendCommandCode(commandCode: mglUnknownCommand)
+        drawNextFrame()
+        assertTimestampReply()
+
+        // And the display list should not be kept, since it's missing a command.
+        sendCommandCode(commandCode: mglFinishDisplayList)
+        drawNextFrame()
+        assertTimestampReply()
+        assertUInt32Reply(expected: 0)
+        assertUInt32Reply(expected: 0)
+        XCTAssertFalse(client.dataWaiting())
+    }
+
+    func testFrameTelemetryRingBuffer() {
+        let telemetry = mglFrameTelemetry(capacity: 8)
+
+        // Commit 12 frames, so the first 4 get overwritten.
+        var frameNumbers: [UInt64] = []
+        for frame in 0 ..< 12 {
+            let committed = 100.0 + Double(frame) / 60.0
+            frameNumbers.append(telemetry.commitFrame(targetTime: committed + 0.01, drawableAcquired: committed - 0.001, committed: committed))
+        }
+        XCTAssertEqual(frameNumbers, Array(1 ... 12))
+        XCTAssertEqual(telemetry.frameCount, 12)
+
+        // System callbacks can come in any order, and late ones for overwritten frames are ignored.
+        for frameNumber in frameNumbers.reversed() {
+            telemetry.setGpuTimes(frameNumber: frameNumber, gpuStart: 1.0, gpuEnd: 2.0)
+            telemetry.setPresented(frameNumber: frameNumber, presented: frameNumber == 10 ? 0.0 : Double(frameNumber))
+        }
+
+        // Only the last 8 frames are left, oldest first.
+        let records = telemetry.records(after: 0)
+        XCTAssertEqual(records.map { $0.frameNumber }, Array(5 ... 12))
+        XCTAssertTrue(records.allSatisfy { $0.gpuStart == 1.0 && $0.gpuEnd == 2.0 })
+        XCTAssertEqual(records.map { $0.presented }, [5.0, 6.0, 7.0, 8.0, 9.0, 0.0, 11.0, 12.0])
+
+        // Asking for frames after a given one gets only the newer ones.
+        XCTAssertEqual(telemetry.records(after: 10).map { $0.frameNumber }, [11, 12])
+        XCTAssertTrue(telemetry.records(after: 12).isEmpty)
+
+        // A new frame starts out not known to be presented.
+        let newFrameNumber = telemetry.commitFrame(targetTime: 0.0, drawableAcquired: 0.0, committed: 0.0)
+        XCTAssertEqual(telemetry.records(after: 12).map { $0.presented }, [-1.0])
+        XCTAssertEqual(newFrameNumber, 13)
+    }
+
+    func testProceduralGratingsMatchReference() {
+        // Create a texture for offscreen rendering and make it the target.
+        let createTexture = mglCreateTextureCommand(texture: offscreenTexture)
+        commandInterface.addLast(command: createTexture)
+        drawNextFrame()
+        assertSuccess(command: createTexture)
+        let setRenderTarget = mglSetRenderTargetCommand(textureNumber: createTexture.textureNumber)
+        commandInterface.addLast(command: setRenderTarget)
+        drawNextFrame()
+        assertSuccess(command: setRenderTarget)
+
+        // A gabor around gray and one with its envelope in alpha, in the default coordinates where the texture is 2 x 2.
+        let records: [Float32] = [
+            -0.4, 0.1, 0.8, 1.0, 3.0, 37.0, 123.0, 0.75, 0.2, 0.25, 0.0,
+            0.5, -0.3, 0.6, 0.6, 4.0, 100.0, 45.0, 1.0, 0.15, 0.1, 1.0
+        ]
+        let gratingBuffer = view.device!.makeBuffer(bytes: records, length: records.count * MemoryLayout<Float32>.stride, options: .storageModeShared)!
+        let gratings = mglProceduralGratingsCommand(gratingBuffer: gratingBuffer, gratingCount: 2)
+        commandInterface.addLast(command: mglSetClearColorCommand(red: 0.5, green: 0.5, blue: 0.5))
+        commandInterface.addLast(command: gratings)
+        commandInterface.addLast(command: mglFlushCommand())
+        drawNextFrame()
+        drawNextFrame()
+        assertSuccess(command: gratings)
+
+        // Draw the same gratings on the CPU, over the same gray.
+        let width = offscreenTexture.width
+        let height = offscreenTexture.height
+        var expected = [Float32](repeating: 0.5, count: width * height * 4)
+        for pixel in 0 ..< width * height {
+            expected[4 * pixel + 3] = 1.0
+        }
+        mglProceduralGratingsRasterize(records, 2, -1.0, 1.0, Double(width) / 2.0, Double(height) / 2.0, UInt32(width), UInt32(height), &expected)
+
+        // They should match to within single precision, apart from pixels right where the envelope is clamped.
+        var rendered = [Float32](repeating: 0.0, count: width * height * 4)
+        offscreenTexture.getBytes(&rendered, bytesPerRow: width * 4 * MemoryLayout<Float32>.stride, from: MTLRegionMake2D(0, 0, width, height), mipmapLevel: 0)
+        let errors = zip(rendered, expected).map { abs($0 - $1) }
+        XCTAssertLessThan(errors.filter { $0 > 1e-3 }.count, 50)
+        XCTAssertLessThan(errors.max()!, 0.02)
+    }
+
+    func testTextureBudgetPolicyWithFakeStore() {
+        // A fake store that just remembers which textures are resident, spilling and restoring as the policy says.
+        var budget = mglTextureBudget()
+        defer { mglTextureBudgetFree(&budget) }
+        var resident: [UInt32: Bool] = [:]
+        func makeRoom(byteCount: UInt64, frame: UInt64) -> [UInt32] {
+            var victims = [UInt32](repeating: 0, count: Int(budget.entryCount))
+            let victimCount = mglTextureBudgetChooseSpills(&budget, byteCount, frame, &victims, UInt32(victims.count))
+            let spilled = Array(victims.prefix(Int(victimCount)))
+            for textureNumber in spilled {
+                resident[textureNumber] = false
+                mglTextureBudgetSpilled(&budget, textureNumber, 10)
+            }
+            return spilled
+        }
+        func add(textureNumber: UInt32, frame: UInt64) -> [UInt32] {
+            let spilled = makeRoom(byteCount: 100, frame: frame)
+            XCTAssertEqual(mglTextureBudgetAdd(&budget, textureNumber, 100, frame), 1)
+            resident[textureNumber] = true
+            return spilled
+        }
+        func use(textureNumber: UInt32, frame: UInt64) -> [UInt32] {
+            if mglTextureBudgetUse(&budget, textureNumber, frame) == 1 {
+                return []
+            }
+            let spilled = makeRoom(byteCount: 100, frame: frame)
+            resident[textureNumber] = true
+            mglTextureBudgetRestored(&budget, textureNumber)
+            return spilled
+        }
+
+        // With no budget, nothing is spilled.
+        XCTAssertEqual(add(textureNumber: 1, frame: 0), [])
+        XCTAssertEqual(add(textureNumber: 2, frame: 1), [])
+        XCTAssertEqual(add(textureNumber: 3, frame: 2), [])
+        XCTAssertEqual(makeRoom(byteCount: 1000, frame: 2), [])
+
+        // Texture 1 is used again, so texture 2 is least recently used when texture 4 needs room.
+        budget.budgetBytes = 300
+        XCTAssertEqual(use(textureNumber: 1, frame: 3), [])
+        XCTAssertEqual(add(textureNumber: 4, frame: 3), [2])
+        XCTAssertEqual(budget.residentCount, 3)
+        XCTAssertEqual(budget.residentBytes, 300)
+        XCTAssertEqual(budget.spilledCount, 1)
+        XCTAssertEqual(budget.spilledBytes, 100)
+        XCTAssertEqual(budget.compressedBytes, 10)
+
+        // Using texture 2 restores it, spilling texture 3, and not textures used in this frame.
+        XCTAssertEqual(use(textureNumber: 4, frame: 4), [])
+        XCTAssertEqual(use(textureNumber: 2, frame: 4), [3])
+        XCTAssertEqual(resident, [1: true, 2: true, 3: false, 4: true])
+        XCTAssertEqual(budget.spillCount, 2)
+        XCTAssertEqual(budget.restoreCount, 1)
+
+        // A smaller budget spills all it can, but not pinned textures or ones used in this frame.
+        mglTextureBudgetPin(&budget, 1)
+        budget.budgetBytes = 100
+        XCTAssertEqual(use(textureNumber: 2, frame: 5), [])
+        XCTAssertEqual(makeRoom(byteCount: 0, frame: 5), [4])
+        XCTAssertEqual(resident, [1: true, 2: true, 3: false, 4: false])
+        XCTAssertEqual(budget.residentBytes, 200)
+
+        // Deleting textures, resident or spilled, takes them out of the counts.
+        XCTAssertEqual(mglTextureBudgetRemove(&budget, 3), 1)
+        XCTAssertEqual(mglTextureBudgetRemove(&budget, 2), 1)
+        XCTAssertEqual(mglTextureBudgetRemove(&budget, 2), 0)
+        XCTAssertEqual(mglTextureBudgetUse(&budget, 2, 6), -1)
+        XCTAssertEqual(budget.residentCount, 1)
+        XCTAssertEqual(budget.residentBytes, 100)
+        XCTAssertEqual(budget.spilledCount, 1)
+        XCTAssertEqual(budget.spilledBytes, 100)
+        XCTAssertEqual(budget.compressedBytes, 10)
+    }
+
+    func testTextureBudgetSpillsAndRestoresTextures() {
+        // Create a texture for offscreen rendering and make it the target, which keeps it resident.
+        let createTexture = mglCreateTextureCommand(texture: offscreenTexture)
+        commandInterface.addLast(command: createTexture)
+        drawNextFrame()
+        let setRenderTarget = mglSetRenderTargetCommand(textureNumber: createTexture.textureNumber)
+        commandInterface.addLast(command: setRenderTarget)
+        drawNextFrame()
+        assertSuccess(command: setRenderTarget)
+
+        // Textures made the way mglCommandInterface.createTexture makes them, each one color.
+        func makeColorTexture(_ color: [Float32]) -> MTLTexture {
+            let width = 16
+            let pixels = [Float32]((0 ..< width * width).flatMap { _ in color })
+            let buffer = view.device!.makeBuffer(bytes: pixels, length: pixels.count * MemoryLayout<Float32>.stride, options: .storageModeManaged)!
+            let textureDescriptor = MTLTextureDescriptor.texture2DDescriptor(pixelFormat: .rgba32Float, width: width, height: width, mipmapped: false)
+            textureDescriptor.usage = [.renderTarget, .shaderRead, .shaderWrite]
+            return buffer.makeTexture(descriptor: textureDescriptor, offset: 0, bytesPerRow: width * 16)!
+        }
+        func getTextureBudget() -> mglTextureBudget {
+            let info = mglInfoCommand()
+            commandInterface.addLast(command: info)
+            drawNextFrame()
+
+            // Skip the replies to this and the commands before it, so the socket doesn't fill up.
+            while client.dataWaiting() {
+                var byte = UInt8(0)
+                _ = client.readData(buffer: &byte, expectedByteCount: 1)
+            }
+            return info.textureBudget
+        }
+        let createA = mglCreateTextureCommand(texture: makeColorTexture([0.25, 0.5, 0.75, 1.0]))
+        let createB = mglCreateTextureCommand(texture: makeColorTexture([1.0, 0.0, 0.0, 1.0]))
+        commandInterface.addLast(command: createA)
+        commandInterface.addLast(command: createB)
+        drawNextFrame()
+        drawNextFrame()
+
+        // With a budget of what is resident now, making another texture spills the oldest one.
+        let residentBytes = getTextureBudget().residentBytes
+        commandInterface.addLast(command: mglSetTextureBudgetCommand(budgetBytes: residentBytes))
+        let createC = mglCreateTextureCommand(texture: makeColorTexture([0.0, 1.0, 0.0, 1.0]))
+        commandInterface.addLast(command: createC)
+        drawNextFrame()
+        drawNextFrame()
+        var budget = getTextureBudget()
+        XCTAssertEqual(budget.spilledCount, 1)
+        XCTAssertEqual(budget.residentBytes, residentBytes)
+        XCTAssertEqual(createC.textureCount, 4)
+
+        // Blting the spilled texture restores it as it was, spilling the next oldest.
+        let vertices: [Float32] = [
+            1, 1, 0, 1, 0,  -1, 1, 0, 0, 0,  -1, -1, 0, 0, 1,
+            1, 1, 0, 1, 0,  -1, -1, 0, 0, 1,  1, -1, 0, 1, 1
+        ]
+        let vertexBuffer = view.device!.makeBuffer(bytes: vertices, length: vertices.count * MemoryLayout<Float32>.stride, options: .storageModeShared)!
+        let blt = mglBltTextureCommand(vertexBufferTexture: vertexBuffer, vertexCount: 6, textureNumber: createA.textureNumber)
+        commandInterface.addLast(command: blt)
+        commandInterface.addLast(command: mglFlushCommand())
+        drawNextFrame()
+        drawNextFrame()
+        assertSuccess(command: blt)
+        assertAllOffscreenPixels(expectedPixel: RGBAFloat32Pixel(r: 0.25, g: 0.5, b: 0.75, a: 1.0))
+        budget = getTextureBudget()
+        XCTAssertEqual(budget.spilledCount, 1)
+        XCTAssertEqual(budget.spillCount, 2)
+        XCTAssertEqual(budget.restoreCount, 1)
+
+        // Deleting a spilled texture works like any other, and no budget keeps what is left resident.
+        let deleteB = mglDeleteTextureCommand(textureNumber: createB.textureNumber)
+        commandInterface.addLast(command: deleteB)
+        commandInterface.addLast(command: mglSetTextureBudgetCommand(budgetBytes: 0))
+        drawNextFrame()
+        drawNextFrame()
+        assertSuccess(command: deleteB)
+        budget = getTextureBudget()
+        XCTAssertEqual(budget.spilledCount, 0)
+        XCTAssertEqual(budget.residentCount, 3)
+    }
+
+    func testBltSpritesFromTwoPages() {
+        // Create a texture for offscreen rendering and make it the target.
+        let createTexture = mglCreateTextureCommand(texture: offscreenTexture)
+        commandInterface.addLast(command: createTexture)
+        drawNextFrame()
+        let setRenderTarget = mglSetRenderTargetCommand(textureNumber: createTexture.textureNumber)
+        commandInterface.addLast(command: setRenderTarget)
+        drawNextFrame()
+        assertSuccess(command: setRenderTarget)
+
+        // Two atlas pages, one with a red sprite on the left and a green one on the right, and one all blue.
+        func makePage(width: Int, height: Int, color: (Int) -> [Float32]) -> MTLTexture {
+            let pixels = [Float32]((0 ..< width * height).flatMap { color($0 % width) })
+            let buffer = view.device!.makeBuffer(bytes: pixels, length: pixels.count * MemoryLayout<Float32>.stride, options: .storageModeManaged)!
+            let textureDescriptor = MTLTextureDescriptor.texture2DDescriptor(pixelFormat: .rgba32Float, width: width, height: height, mipmapped: false)
+            textureDescriptor.usage = [.renderTarget, .shaderRead, .shaderWrite]
+            return buffer.makeTexture(descriptor: textureDescriptor, offset: 0, bytesPerRow: width * 16)!
+        }
+        let createPageA = mglCreateTextureCommand(texture: makePage(width: 16, height: 8) { $0 < 8 ? [1, 0, 0, 1] : [0, 1, 0, 1] })
+        let createPageB = mglCreateTextureCommand(texture: makePage(width: 4, height: 4) { _ in [0, 0, 1, 1] })
+        commandInterface.addLast(command: createPageA)
+        commandInterface.addLast(command: createPageB)
+        drawNextFrame()
+        drawNextFrame()
+        let pageA = Float32(createPageA.textureNumber)
+        let pageB = Float32(createPageB.textureNumber)
+
+        // Red on the left half, then half transparent blue turned 45 degrees in the top left, then green on the right half,
+        // in the default coordinates where the target is 2 x 2. That is three runs, alternating pages.
+        let records: [Float32] = [
+            -0.5, 0.0, 1.0, 2.0, 0.0, 1.0, 0.0, 0.0, 0.5, 1.0, pageA,
+            -0.5, 0.5, 0.5, 0.5, 45.0, 0.5, 0.0, 0.0, 1.0, 1.0, pageB,
+            0.5, 0.0, 1.0, 2.0, 0.0, 1.0, 0.5, 0.0, 1.0, 1.0, pageA
+        ]
+        let spriteBuffer = view.device!.makeBuffer(bytes: records, length: records.count * MemoryLayout<Float32>.stride, options: .storageModeShared)!
+        let sprites = mglBltSpritesCommand(spriteBuffer: spriteBuffer, spriteCount: 3)
+        commandInterface.addLast(command: mglSetClearColorCommand(red: 0.0, green: 0.0, blue: 0.0))
+        commandInterface.addLast(command: sprites)
+        commandInterface.addLast(command: mglFlushCommand())
+        drawNextFrame()
+        drawNextFrame()
+        assertSuccess(command: sprites)
+
+        // Check pixels away from the edges of sprites, where linear filtering blends.
+        let width = offscreenTexture.width
+        let height = offscreenTexture.height
+        var rendered = [Float32](repeating: 0.0, count: width * height * 4)
+        offscreenTexture.getBytes(&rendered, bytesPerRow: width * 4 * MemoryLayout<Float32>.stride, from: MTLRegionMake2D(0, 0, width, height), mipmapLevel: 0)
+        func rgb(column: Int, row: Int) -> [Float32] {
+            let index = 4 * (row * width + column)
+            return Array(rendered[index ..< index + 3])
+        }
+        XCTAssertEqual(rgb(column: width / 4, row: 3 * height / 4), [1, 0, 0])
+        XCTAssertEqual(rgb(column: width / 4, row: height / 4), [0.5, 0, 0.5])
+        XCTAssertEqual(rgb(column: 3 * width / 4, row: height / 2), [0, 1, 0])
+    }
+
+    func testFrameStreamShowsEachFrame() {
+        // Three solid frames, red, green then blue, written as a frame stream.
+        let path = NSTemporaryDirectory() + "mglMetalTests.frames"
+        let colors: [[UInt8]] = [[255, 0, 0, 255], [0, 255, 0, 255], [0, 0, 255, 255]]
+        var writer = mglFrameStreamWriter()
+        XCTAssertEqual(mglFrameStreamWriterOpen(&writer, path, 4, 4, UInt32(mglFrameStreamRGBA8.rawValue), 60.0, 1), 1)
+        for color in colors {
+            let pixels = [UInt8]((0 ..< 16).flatMap { _ in color })
+            XCTAssertEqual(mglFrameStreamWriterAdd(&writer, pixels), 1)
+        }
+        XCTAssertEqual(mglFrameStreamWriterClose(&writer), 1)
+
+        // Create a texture for offscreen rendering and make it the target.
+        let createTexture = mglCreateTextureCommand(texture: offscreenTexture)
+        commandInterface.addLast(command: createTexture)
+        drawNextFrame()
+        let setRenderTarget = mglSetRenderTargetCommand(textureNumber: createTexture.textureNumber)
+        commandInterface.addLast(command: setRenderTarget)
+        drawNextFrame()
+        assertSuccess(command: setRenderTarget)
+
+        let open = mglFrameStreamOpenCommand(path: path, slotCount: 4)
+        commandInterface.addLast(command: open)
+        drawNextFrame()
+        XCTAssertTrue(open.results.success)
+
+        // Show each frame over the whole target, in the default coordinates where the target is 2 x 2.
+        let vertices: [Float32] = [
+            1, 1, 0, 1, 0,
+            -1, 1, 0, 0, 0,
+            -1, -1, 0, 0, 1,
+            1, 1, 0, 1, 0,
+            -1, -1, 0, 0, 1,
+            1, -1, 0, 1, 1
+        ]
+        let vertexBuffer = view.device!.makeBuffer(bytes: vertices, length: vertices.count * MemoryLayout<Float32>.stride, options: .storageModeShared)!
+        for (frame, color) in colors.enumerated() {
+            let showFrame = mglFrameStreamShowFrameCommand(frameStreamNumber: open.frameStreamNumber, frame: UInt32(frame), timeoutSecs: 1.0, vertexBufferTexture: vertexBuffer, vertexCount: 6)
+            commandInterface.addLast(command: showFrame)
+            commandInterface.addLast(command: mglFlushCommand())
+            drawNextFrame()
+            drawNextFrame()
+            assertSuccess(command: showFrame)
+            assertAllOffscreenPixels(expectedPixel: RGBAFloat32Pixel(r: Float32(color[0]) / 255, g: Float32(color[1]) / 255, b: Float32(color[2]) / 255, a: 1))
+        }
+
+        // A frame past the end fails, and closing counts the frames shown and the one missed.
+        let pastEnd = mglFrameStreamShowFrameCommand(frameStreamNumber: open.frameStreamNumber, frame: 3, timeoutSecs: 0.0, vertexBufferTexture: vertexBuffer, vertexCount: 6)
+        commandInterface.addLast(command: pastEnd)
+        commandInterface.addLast(command: mglFlushCommand())
+        drawNextFrame()
+        drawNextFrame()
+        XCTAssertFalse(pastEnd.results.success)
+
+        let close = mglFrameStreamCloseCommand(frameStreamNumber: open.frameStreamNumber)
+        commandInterface.addLast(command: close)
+        drawNextFrame()
+        XCTAssertTrue(close.results.success)
+        XCTAssertEqual(close.shownCount, 3)
+        XCTAssertEqual(close.missedCount, 1)
+
+        // Once closed, its frames can't be shown.
+        let afterClose = mglFrameStreamShowFrameCommand(frameStreamNumber: open.frameStreamNumber, frame: 0, timeoutSecs: 0.0, vertexBufferTexture: vertexBuffer, vertexCount: 6)
+        commandInterface.addLast(command: afterClose)
+        drawNextFrame()
+        XCTAssertFalse(afterClose.results.success)
+        try? FileManager.default.removeItem(atPath: path)
+    }
+
+    func testReadbackCollectsFramesAfterTheNextIsDrawn() {
+        // Create a texture for offscreen rendering and make it the target.
+        let createTexture = mglCreateTextureCommand(texture: offscreenTexture)
+        commandInterface.addLast(command: createTexture)
+        drawNextFrame()
+        let setRenderTarget = mglSetRenderTargetCommand(textureNumber: createTexture.textureNumber)
+        commandInterface.addLast(command: setRenderTarget)
+        drawNextFrame()
+        assertSuccess(command: setRenderTarget)
+
+        // Draw a red frame and issue a readback of a region of it, as uint8.
+        commandInterface.addLast(command: mglSetClearColorCommand(red: 1.0, green: 0.0, blue: 0.0))
+        commandInterface.addLast(command: mglFlushCommand())
+        drawNextFrame()
+        drawNextFrame()
+        let issueRed = mglReadbackIssueCommand(textureNumber: 0, x: 10, y: 20, width: 3, height: 2, format: UInt32(mglReadbackUInt8.rawValue))
+        commandInterface.addLast(command: issueRed)
+        drawNextFrame()
+        assertSuccess(command: issueRed)
+        XCTAssertGreaterThan(issueRed.ticket, 0)
+
+        // Draw a blue frame over it before collecting, and issue a readback of all of it, as single.
+        commandInterface.addLast(command: mglSetClearColorCommand(red: 0.0, green: 0.0, blue: 1.0))
+        commandInterface.addLast(command: mglFlushCommand())
+        drawNextFrame()
+        drawNextFrame()
+        let issueBlue = mglReadbackIssueCommand(textureNumber: 0, x: 0, y: 0, width: 0, height: 0, format: UInt32(mglReadbackSingle.rawValue))
+        commandInterface.addLast(command: issueBlue)
+        drawNextFrame()
+        assertSuccess(command: issueBlue)
+
+        // The first readback is still the red frame, as planes of 3 x 2 values each.
+        let collectRed = mglReadbackCollectCommand(ticket: issueRed.ticket)
+        commandInterface.addLast(command: collectRed)
+        drawNextFrame()
+        assertSuccess(command: collectRed)
+        XCTAssertEqual(collectRed.width, 3)
+        XCTAssertEqual(collectRed.height, 2)
+        XCTAssertEqual(collectRed.image, [UInt8](repeating: 255, count: 6) + [UInt8](repeating: 0, count: 12) + [UInt8](repeating: 255, count: 6))
+
+        let collectBlue = mglReadbackCollectCommand(ticket: issueBlue.ticket)
+        commandInterface.addLast(command: collectBlue)
+        drawNextFrame()
+        assertSuccess(command: collectBlue)
+        XCTAssertEqual(collectBlue.width, 640)
+        XCTAssertEqual(collectBlue.height, 480)
+        let blue = collectBlue.image!.withUnsafeBytes { Array($0.bindMemory(to: Float32.self)) }
+        let planeCount = 640 * 480
+        XCTAssertTrue(blue[0 ..< 2 * planeCount].allSatisfy { $0 == 0.0 })
+        XCTAssertTrue(blue[2 * planeCount ..< 4 * planeCount].allSatisfy { $0 == 1.0 })
+
+        // Each readback can only be collected once, and regions must be within the texture.
+        let collectAgain = mglReadbackCollectCommand(ticket: issueRed.ticket)
+        commandInterface.addLast(command: collectAgain)
+        drawNextFrame()
+        XCTAssertFalse(collectAgain.results.success)
+        let outside = mglReadbackIssueCommand(textureNumber: 0, x: 600, y: 0, width: 41, height: 0, format: UInt32(mglReadbackUInt8.rawValue))
+        commandInterface.addLast(command: outside)
+        drawNextFrame()
+        XCTAssertFalse(outside.results.success)
+    }
+
+    func testTraceWritesRecordsFromEachThread() {
+        let path = NSTemporaryDirectory() + "mglMetalTests.trace"
+        XCTAssertEqual(mglTraceStart(path), 1)
+        XCTAssertEqual(mglTraceIsOn(), 1)
+
+        // Trace from a few threads at once, each with its own buffer.
+        let recordsPerThread = 1000
+        DispatchQueue.concurrentPerform(iterations: 4) { _ in
+            for arg in 0 ..< recordsPerThread {
+                mglTraceBegin(mglTraceDraw, UInt64(arg))
+                mglTraceEnd(mglTraceDraw, UInt64(arg))
+            }
+        }
+        mglTraceInstantAt(mglTracePresented, 42, 123.0)
+        mglTraceStop()
+        XCTAssertEqual(mglTraceIsOn(), 0)
+
+        // Nothing is recorded once tracing is stopped.
+        mglTraceInstant(mglTracePresented, 43)
+
+        // The header names the events, then come the records.
+        guard let data = FileManager.default.contents(atPath: path) else {
+            XCTFail("Could not read trace file \(path)")
+            return
+        }
+        let magic = String(decoding: data.prefix(8), as: UTF8.self)
+        XCTAssertEqual(magic, MGL_TRACE_MAGIC)
+        let header: [UInt32] = (0 ..< 4).map { index in
+            data.subdata(in: (8 + 4 * index) ..< (12 + 4 * index)).withUnsafeBytes { $0.load(as: UInt32.self) }
+        }
+        XCTAssertEqual(header, [UInt32(MGL_TRACE_VERSION), UInt32(MemoryLayout<mglTraceRecord>.size), UInt32(mglTraceEventCount.rawValue), UInt32(MGL_TRACE_EVENT_NAME_BYTES)])
+        let recordsStart = 8 + 16 + Int(header[2] * header[3])
+        let records: [mglTraceRecord] = data.subdata(in: recordsStart ..< data.count).withUnsafeBytes { Array($0.bindMemory(to: mglTraceRecord.self)) }
+
+        // Every record is there, and each thread's records are in order.
+        XCTAssertEqual(records.count, 4 * 2 * recordsPerThread + 1)
+        var lastTimeByThread: [UInt32: UInt64] = [:]
+        for record in records where record.event == mglTraceDraw.rawValue {
+            XCTAssertGreaterThanOrEqual(record.time, lastTimeByThread[record.thread] ?? 0)
+            lastTimeByThread[record.thread] = record.time
+        }
+        let presented = records.filter { $0.event == mglTracePresented.rawValue }
+        XCTAssertEqual(presented.count, 1)
+        XCTAssertEqual(presented.first?.arg, 42)
+        XCTAssertEqual(presented.first?.time, 123000000000)
+        XCTAssertEqual(presented.first?.phase, mglTracePhaseInstant.rawValue)
+    }
 }
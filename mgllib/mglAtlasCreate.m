@@ -0,0 +1,114 @@
+% mglAtlasCreate.m
+%
+%      usage: atlas = mglAtlasCreate(images, <pageSize>, <padding>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: Packs many small images (letters, icons, faces, the images
+%             of an RSVP stream) onto a few large textures, called pages,
+%             so that any number of them can be drawn each frame with one
+%             mglMetalBltSprites command, instead of making a texture for
+%             each image and blting each one with its own command.
+%
+%             images is a cell array of images, each m x n grayscale,
+%             m x n x 3 rgb or m x n x 4 rgba, with values 0-1, or 0-255
+%             as for mglCreateTexture. Sprite i of the atlas is images{i}.
+%
+%             pageSize is the width and height of each page in pixels
+%             (default 2048). Pages are made only as large as what is on
+%             them, so a few small images do not take a whole page.
+%             padding (default 1) is the number of pixels around each
+%             image, filled with copies of its edge, so that neighbors do
+%             not bleed in when it is drawn scaled.
+%
+%             Images are packed with a skyline packer (see mglAtlasPacker.h)
+%             which usually uses 85-98% of each page.
+%
+%             atlas.pages is the textures, one for each page, and for each
+%             sprite, atlas.page is which page it is on (0 for images that
+%             were too big for a page, or empty), atlas.textureNumber is
+%             the texture of that page, atlas.uv is its [u0 v0 u1 v1] on
+%             that page and atlas.imageWidth and atlas.imageHeight are its
+%             size in pixels. Delete the atlas with
+%             mglDeleteTexture(atlas.pages).
+%
+%             mglOpen;
+%             mglVisualAngleCoordinates(57,[16 12]);
+%             for i = 1:26
+%               letters{i} = mglFigureText(char('A'+i-1));
+%             end
+%             atlas = mglAtlasCreate(letters);
+%             mglMetalBltSprites(atlas,1:26,linspace(-7,7,26),0);
+%             mglFlush;
+%
+function atlas = mglAtlasCreate(images, pageSize, padding)
+
+% check arguments
+atlas = [];
+if ~any(nargin == [1 2 3])
+  help mglAtlasCreate
+  return
+end
+
+% check that the packer is compiled
+if exist('mglPrivateAtlasPack')~=3
+  disp(sprintf('(mglAtlasCreate) mglPrivateAtlasPack is not compiled. Run mglMakeMetal'));
+  return
+end
+
+if ~iscell(images)
+  images = {images};
+end
+if nargin < 2 || isempty(pageSize), pageSize = 2048; end
+if length(pageSize) == 1, pageSize = [pageSize pageSize]; end
+if nargin < 3 || isempty(padding), padding = 1; end
+
+% pack
+nSprites = numel(images);
+imageHeight = cellfun(@(im) size(im,1), images);
+imageWidth = cellfun(@(im) size(im,2), images);
+[page x y nPages] = mglPrivateAtlasPack(imageWidth, imageHeight, pageSize, padding);
+if any(page == 0)
+  disp(sprintf('(mglAtlasCreate) %i images are empty or too big for %ix%i pages with %i pixels of padding and were left out', sum(page == 0), pageSize(1), pageSize(2), padding));
+end
+
+% make each page only as big as what is on it
+atlas.pages = [];
+atlas.page = page;
+atlas.uv = zeros(4, nSprites);
+atlas.imageWidth = imageWidth;
+atlas.imageHeight = imageHeight;
+atlas.textureNumber = zeros(1, nSprites);
+atlas.padding = padding;
+for iPage = 1:nPages
+  onPage = find(page == iPage);
+  pageWidth = max(x(onPage) + imageWidth(onPage) - 1) + padding;
+  pageHeight = max(y(onPage) + imageHeight(onPage) - 1) + padding;
+  pageImage = zeros(pageHeight, pageWidth, 4, 'single');
+  for iSprite = onPage(:)'
+    % values 0-1 in rgba, as mglCreateTexture would make them
+    im = single(images{iSprite});
+    if max(im(:)) > 1
+      im = im / 255;
+    end
+    switch size(im,3)
+      case 1
+        im = cat(3, im, im, im, ones(size(im), 'single'));
+      case 3
+        im = cat(3, im, ones(size(im,1), size(im,2), 'single'));
+    end
+    % extend the edges into the padding
+    rows = min(max((1-padding):(imageHeight(iSprite)+padding), 1), imageHeight(iSprite));
+    columns = min(max((1-padding):(imageWidth(iSprite)+padding), 1), imageWidth(iSprite));
+    pageImage(y(iSprite)-padding+(0:length(rows)-1), x(iSprite)-padding+(0:length(columns)-1), :) = im(rows, columns, 1:4);
+    % texture coordinates of the image itself, with +Y going down
+    atlas.uv(:, iSprite) = [(x(iSprite)-1)/pageWidth; (y(iSprite)-1)/pageHeight; (x(iSprite)-1+imageWidth(iSprite))/pageWidth; (y(iSprite)-1+imageHeight(iSprite))/pageHeight];
+  end
+  tex = mglCreateTexture(pageImage);
+  if isempty(atlas.pages)
+    atlas.pages = tex;
+  else
+    atlas.pages(iPage) = tex;
+  end
+  atlas.textureNumber(onPage) = tex.textureNumber;
+end
@@ -0,0 +1,237 @@
+#ifdef documentation
+=========================================================================
+
+  program: mglAtlasPacker.h
+       by: justin gardner
+     date: 10/19/2026
+copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+  purpose: packs many small images (letters, icons, faces) into a few
+           large atlas pages, so that they can all be drawn from a few
+           textures with one mglMetalBltSprites command, instead of one
+           texture and one mglBltTexture for each.
+
+           Uses a skyline packer: each page keeps the outline of the tops
+           of what is packed so far, as a list of level segments from left
+           to right. Each image goes where its top edge would be lowest
+           (closest to the top of the page, since rows go down), and among
+           those the leftmost, trying pages in the order they were opened
+           and opening a new page when it fits on none. Images are packed
+           tallest first, then widest, which keeps the skyline flat and
+           uses 85-98% of 2048x2048 pages for sets like letters, icons and
+           faces (see mglBenchmark/mglBenchmarkAtlasPacker.c).
+
+           padding is the number of pixels to leave around each image,
+           for mglAtlasCreate to fill with copies of the image edge, so
+           that linear filtering does not pick up neighboring images.
+
+           This is plain C with no Matlab dependencies, see
+           mglBenchmark/mglBenchmarkAtlasPacker.c for a standalone test
+           and benchmark.
+
+=========================================================================
+#endif
+
+#ifndef MGL_ATLAS_PACKER_H
+#define MGL_ATLAS_PACKER_H
+
+/////////////////////////
+//   include section   //
+/////////////////////////
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// where an image went, page is -1 for an image that is too big for a page, or empty
+typedef struct {
+  int32_t page;
+  // top left of the image itself, inside its padding
+  uint32_t x;
+  uint32_t y;
+} mglAtlasPlacement;
+
+// one level of the skyline, from x to x+width, with everything above y used
+typedef struct {
+  uint32_t x;
+  uint32_t y;
+  uint32_t width;
+} mglAtlasSegment;
+
+typedef struct {
+  mglAtlasSegment *segments;
+  uint32_t segmentCount;
+} mglAtlasSkyline;
+
+// for sorting images tallest first
+typedef struct {
+  uint32_t width;
+  uint32_t height;
+  uint32_t index;
+} mglAtlasRect;
+
+//////////////////////////
+//   mglAtlasRectCompare //
+//////////////////////////
+// Tallest first, then widest, then in the order given, so packing is the same on every platform.
+static int mglAtlasRectCompare(const void *a, const void *b)
+{
+  const mglAtlasRect *rectA = (const mglAtlasRect *)a;
+  const mglAtlasRect *rectB = (const mglAtlasRect *)b;
+  if (rectA->height != rectB->height) return (rectA->height > rectB->height) ? -1 : 1;
+  if (rectA->width != rectB->width) return (rectA->width > rectB->width) ? -1 : 1;
+  return (rectA->index < rectB->index) ? -1 : (rectA->index > rectB->index);
+}
+
+///////////////////////////
+//   mglAtlasSkylineFit  //
+///////////////////////////
+// Where the top of a width x height rect would be if its left edge were at segment i,
+// which is the highest skyline under it. Returns 0 if it would go off the page.
+static inline int mglAtlasSkylineFit(const mglAtlasSkyline *skyline, uint32_t i, uint32_t width, uint32_t height, uint32_t pageWidth, uint32_t pageHeight, uint32_t *y)
+{
+  uint32_t x = skyline->segments[i].x;
+  if (x + width > pageWidth) return 0;
+  uint32_t top = 0;
+  uint32_t widthLeft = width;
+  while (widthLeft > 0) {
+    if (skyline->segments[i].y > top) top = skyline->segments[i].y;
+    if (top + height > pageHeight) return 0;
+    if (skyline->segments[i].width >= widthLeft) break;
+    widthLeft -= skyline->segments[i].width;
+    i++;
+  }
+  *y = top;
+  return 1;
+}
+
+///////////////////////////
+//   mglAtlasSkylineAdd  //
+///////////////////////////
+// Put a width x height rect with its left edge at segment i and its top at y, raising the skyline.
+static inline void mglAtlasSkylineAdd(mglAtlasSkyline *skyline, uint32_t i, uint32_t y, uint32_t width, uint32_t height)
+{
+  mglAtlasSegment *segments = skyline->segments;
+  mglAtlasSegment added = {segments[i].x, y + height, width};
+  uint32_t right = added.x + width;
+
+  // drop or shorten the segments that are now under the rect
+  uint32_t next = i;
+  while ((next < skyline->segmentCount) && (segments[next].x + segments[next].width <= right)) next++;
+  if ((next < skyline->segmentCount) && (segments[next].x < right)) {
+    segments[next].width -= right - segments[next].x;
+    segments[next].x = right;
+  }
+  // the rect replaces segments i to next-1
+  uint32_t removed = next - i;
+  if (removed != 1) {
+    memmove(&segments[i + 1], &segments[next], (skyline->segmentCount - next) * sizeof(mglAtlasSegment));
+    skyline->segmentCount = skyline->segmentCount - removed + 1;
+  }
+  segments[i] = added;
+
+  // join with neighbors at the same level
+  if ((i + 1 < skyline->segmentCount) && (segments[i + 1].y == segments[i].y)) {
+    segments[i].width += segments[i + 1].width;
+    memmove(&segments[i + 1], &segments[i + 2], (skyline->segmentCount - i - 2) * sizeof(mglAtlasSegment));
+    skyline->segmentCount--;
+  }
+  if ((i > 0) && (segments[i - 1].y == segments[i].y)) {
+    segments[i - 1].width += segments[i].width;
+    memmove(&segments[i], &segments[i + 1], (skyline->segmentCount - i - 1) * sizeof(mglAtlasSegment));
+    skyline->segmentCount--;
+  }
+}
+
+//////////////////////////////
+//   mglAtlasSkylineChoose  //
+//////////////////////////////
+// Find the segment to put a rect at, lowest top edge and then leftmost. Returns 0 if it does not fit.
+static inline int mglAtlasSkylineChoose(const mglAtlasSkyline *skyline, uint32_t width, uint32_t height, uint32_t pageWidth, uint32_t pageHeight, uint32_t *bestSegment, uint32_t *bestY)
+{
+  int found = 0;
+  uint32_t i, y;
+  for (i = 0; i < skyline->segmentCount; i++) {
+    if (mglAtlasSkylineFit(skyline, i, width, height, pageWidth, pageHeight, &y) && (!found || (y < *bestY))) {
+      found = 1;
+      *bestSegment = i;
+      *bestY = y;
+    }
+  }
+  return found;
+}
+
+//////////////////////
+//   mglAtlasPack   //
+//////////////////////
+// Pack n images of the given sizes onto as few pageWidth x pageHeight pages as the skyline finds,
+// filling in where each one went. Returns the number of images packed, which is less than n if
+// some were too big for a page or empty, or -1 if memory could not be had. nPages is how many pages are used.
+static inline int mglAtlasPack(const uint32_t *widths, const uint32_t *heights, uint32_t n, uint32_t pageWidth, uint32_t pageHeight, uint32_t padding, mglAtlasPlacement *placements, uint32_t *nPages)
+{
+  *nPages = 0;
+  if (n == 0) return 0;
+  mglAtlasRect *rects = (mglAtlasRect *)malloc(n * sizeof(mglAtlasRect));
+  if (rects == NULL) return -1;
+  uint32_t i;
+  for (i = 0; i < n; i++) {
+    rects[i].width = widths[i] + 2 * padding;
+    rects[i].height = heights[i] + 2 * padding;
+    rects[i].index = i;
+  }
+  qsort(rects, n, sizeof(mglAtlasRect), mglAtlasRectCompare);
+
+  // a skyline has at most one segment for each column of the page
+  mglAtlasSkyline *skylines = NULL;
+  uint32_t skylineCapacity = 0;
+  int packed = 0;
+  for (i = 0; i < n; i++) {
+    mglAtlasPlacement *placement = &placements[rects[i].index];
+    placement->page = -1;
+    placement->x = placement->y = 0;
+    if ((rects[i].width > pageWidth) || (rects[i].height > pageHeight) || (widths[rects[i].index] == 0) || (heights[rects[i].index] == 0)) continue;
+
+    // first page it fits on
+    uint32_t page, segment = 0, y = 0;
+    for (page = 0; page < *nPages; page++)
+      if (mglAtlasSkylineChoose(&skylines[page], rects[i].width, rects[i].height, pageWidth, pageHeight, &segment, &y)) break;
+
+    // or a new page
+    if (page == *nPages) {
+      if (*nPages == skylineCapacity) {
+        uint32_t newCapacity = skylineCapacity ? 2 * skylineCapacity : 4;
+        mglAtlasSkyline *newSkylines = (mglAtlasSkyline *)realloc(skylines, newCapacity * sizeof(mglAtlasSkyline));
+        if (newSkylines == NULL) {
+          packed = -1;
+          break;
+        }
+        skylines = newSkylines;
+        skylineCapacity = newCapacity;
+      }
+      skylines[page].segments = (mglAtlasSegment *)malloc(pageWidth * sizeof(mglAtlasSegment));
+      if (skylines[page].segments == NULL) {
+        packed = -1;
+        break;
+      }
+      skylines[page].segments[0].x = 0;
+      skylines[page].segments[0].y = 0;
+      skylines[page].segments[0].width = pageWidth;
+      skylines[page].segmentCount = 1;
+      (*nPages)++;
+      segment = 0;
+      y = 0;
+    }
+
+    placement->page = (int32_t)page;
+    placement->x = skylines[page].segments[segment].x + padding;
+    placement->y = y + padding;
+    mglAtlasSkylineAdd(&skylines[page], segment, y, rects[i].width, rects[i].height);
+    packed++;
+  }
+
+  for (i = 0; i < *nPages; i++)
+    free(skylines[i].segments);
+  free(skylines);
+  free(rects);
+  return packed;
+}
+
+#endif // MGL_ATLAS_PACKER_H
@@ -0,0 +1,280 @@
+#ifdef documentation
+=========================================================================
+
+     program: mglBenchmarkAtlasPacker.c
+          by: justin gardner
+        date: 10/19/2026
+   copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+     purpose: standalone test and benchmark of mglAtlasPacker.h, the
+              skyline packer that mglAtlasCreate uses to put many small
+              images onto a few atlas pages. Checks that packed images,
+              with their padding, are on a page, inside it, and do not
+              overlap each other, that images too big for a page or
+              empty are left out, and that packing is the same every
+              time. Then reports how much of the pages is used, and how
+              long packing takes, for sets like letters, icons, faces and
+              mixed sizes, next to simple shelves (rows as tall as their
+              tallest image) for comparison. Needs no Matlab, and builds on Linux
+              or Mac with the makefile in this directory.
+       usage: mglBenchmarkAtlasPacker [pageWidth pageHeight padding]
+
+=========================================================================
+#endif
+
+/////////////////////////
+//   include section   //
+/////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../mglAtlasPacker.h"
+
+///////////////////////////////
+//   function declarations   //
+///////////////////////////////
+static int checkPacking(const char *name, const uint32_t *widths, const uint32_t *heights, uint32_t n, uint32_t pageWidth, uint32_t pageHeight, uint32_t padding);
+static uint32_t shelfPages(const uint32_t *widths, const uint32_t *heights, uint32_t n, uint32_t pageWidth, uint32_t pageHeight, uint32_t padding, double *lastPageFraction);
+static uint32_t makeSet(int set, uint32_t *widths, uint32_t *heights, unsigned int seed);
+static double getSecs(void);
+
+////////////////////////
+//   define section   //
+////////////////////////
+#define MAX_IMAGES 4096
+#define NUM_SETS 5
+
+static const char *setNames[NUM_SETS] = {"letters", "icons", "faces", "mixed", "strips"};
+
+//////////////
+//   main   //
+//////////////
+int main(int argc, char *argv[])
+{
+  uint32_t pageWidth = (argc > 1) ? atoi(argv[1]) : 2048;
+  uint32_t pageHeight = (argc > 2) ? atoi(argv[2]) : 2048;
+  uint32_t padding = (argc > 3) ? atoi(argv[3]) : 1;
+  uint32_t *widths = (uint32_t *)malloc(MAX_IMAGES * sizeof(uint32_t));
+  uint32_t *heights = (uint32_t *)malloc(MAX_IMAGES * sizeof(uint32_t));
+  int failed = 0;
+
+  // small cases where the answer is known
+  {
+    uint32_t w[] = {10, 10, 10, 10}, h[] = {10, 10, 10, 10};
+    mglAtlasPlacement placements[4];
+    uint32_t nPages;
+    int packed = mglAtlasPack(w, h, 4, 20, 20, 0, placements, &nPages);
+    if ((packed != 4) || (nPages != 1)) {
+      printf("(mglBenchmarkAtlasPacker) Four 10x10 images do not fill one 20x20 page FAILED\n");
+      failed = 1;
+    }
+    packed = mglAtlasPack(w, h, 4, 20, 20, 1, placements, &nPages);
+    if ((packed != 4) || (nPages != 4)) {
+      printf("(mglBenchmarkAtlasPacker) Four padded 12x12 images do not take four 20x20 pages FAILED\n");
+      failed = 1;
+    }
+    uint32_t w2[] = {5, 21, 3, 0}, h2[] = {5, 3, 21, 4};
+    packed = mglAtlasPack(w2, h2, 4, 20, 20, 0, placements, &nPages);
+    if ((packed != 1) || (placements[0].page != 0) || (placements[1].page != -1) || (placements[2].page != -1) || (placements[3].page != -1)) {
+      printf("(mglBenchmarkAtlasPacker) Images too big for a page or empty are not left out FAILED\n");
+      failed = 1;
+    }
+    packed = mglAtlasPack(w, h, 0, 20, 20, 0, placements, &nPages);
+    if ((packed != 0) || (nPages != 0)) {
+      printf("(mglBenchmarkAtlasPacker) No images do not take no pages FAILED\n");
+      failed = 1;
+    }
+  }
+
+  // every set, on small pages that take many and on the full size
+  for (int set = 0; set < NUM_SETS; set++) {
+    for (unsigned int seed = 1; seed <= 3; seed++) {
+      uint32_t n = makeSet(set, widths, heights, seed);
+      failed |= checkPacking(setNames[set], widths, heights, n, 512, 512, padding);
+      failed |= checkPacking(setNames[set], widths, heights, n, pageWidth, pageHeight, padding);
+    }
+  }
+  if (!failed) printf("(mglBenchmarkAtlasPacker) Packing is in bounds, without overlaps, and repeatable OK\n");
+
+  // how much of the pages is used, and how long it takes
+  mglAtlasPlacement *placements = (mglAtlasPlacement *)malloc(MAX_IMAGES * sizeof(mglAtlasPlacement));
+  for (int set = 0; set < NUM_SETS; set++) {
+    uint32_t n = makeSet(set, widths, heights, 1);
+    double area = 0;
+    for (uint32_t i = 0; i < n; i++)
+      area += (double)(widths[i] + 2 * padding) * (heights[i] + 2 * padding);
+
+    uint32_t nPages = 0;
+    int repeats = 10;
+    double startTime = getSecs();
+    for (int iRepeat = 0; iRepeat < repeats; iRepeat++)
+      mglAtlasPack(widths, heights, n, pageWidth, pageHeight, padding, placements, &nPages);
+    double packTime = (getSecs() - startTime) / repeats;
+
+    // count the last page only down to the lowest image on it
+    uint32_t lastPageBottom = 0;
+    for (uint32_t i = 0; i < n; i++)
+      if ((placements[i].page == (int32_t)nPages - 1) && (placements[i].y + heights[i] + padding > lastPageBottom))
+        lastPageBottom = placements[i].y + heights[i] + padding;
+    double usedArea = ((double)(nPages - 1) * pageHeight + lastPageBottom) * pageWidth;
+
+    double shelfLastPageFraction;
+    uint32_t nShelfPages = shelfPages(widths, heights, n, pageWidth, pageHeight, padding, &shelfLastPageFraction);
+    double shelfUsedArea = ((double)(nShelfPages - 1) + shelfLastPageFraction) * pageWidth * pageHeight;
+
+    printf("(mglBenchmarkAtlasPacker) %-7s %4u images on %ux%u pages: skyline %u pages %0.1f%% used in %0.2f ms, shelves %u pages %0.1f%% used\n",
+           setNames[set], n, pageWidth, pageHeight, nPages, 100 * area / usedArea, 1000 * packTime,
+           nShelfPages, 100 * area / shelfUsedArea);
+  }
+  free(placements);
+  free(widths);
+  free(heights);
+  return failed;
+}
+
+//////////////////////
+//   checkPacking   //
+//////////////////////
+// Pack a set and check it by drawing each padded image into a map of each page.
+static int checkPacking(const char *name, const uint32_t *widths, const uint32_t *heights, uint32_t n, uint32_t pageWidth, uint32_t pageHeight, uint32_t padding)
+{
+  mglAtlasPlacement *placements = (mglAtlasPlacement *)calloc(n, sizeof(mglAtlasPlacement));
+  mglAtlasPlacement *again = (mglAtlasPlacement *)calloc(n, sizeof(mglAtlasPlacement));
+  uint32_t nPages, nPagesAgain;
+  int packed = mglAtlasPack(widths, heights, n, pageWidth, pageHeight, padding, placements, &nPages);
+  mglAtlasPack(widths, heights, n, pageWidth, pageHeight, padding, again, &nPagesAgain);
+  int failed = 0;
+
+  if ((nPagesAgain != nPages) || memcmp(placements, again, n * sizeof(mglAtlasPlacement))) {
+    printf("(mglBenchmarkAtlasPacker) %s on %ux%u pages packs differently the second time FAILED\n", name, pageWidth, pageHeight);
+    failed = 1;
+  }
+
+  int expectedPacked = 0;
+  for (uint32_t i = 0; i < n; i++) {
+    int fits = (widths[i] > 0) && (heights[i] > 0) && (widths[i] + 2 * padding <= pageWidth) && (heights[i] + 2 * padding <= pageHeight);
+    expectedPacked += fits;
+    if (fits != (placements[i].page >= 0)) {
+      printf("(mglBenchmarkAtlasPacker) %s image %u (%ux%u) on %ux%u pages is on page %d FAILED\n", name, i, widths[i], heights[i], pageWidth, pageHeight, placements[i].page);
+      failed = 1;
+    }
+  }
+  if (packed != expectedPacked) {
+    printf("(mglBenchmarkAtlasPacker) %s on %ux%u pages packed %d of %d images FAILED\n", name, pageWidth, pageHeight, packed, expectedPacked);
+    failed = 1;
+  }
+
+  uint8_t *used = (uint8_t *)calloc((size_t)nPages * pageWidth * pageHeight, 1);
+  for (uint32_t i = 0; (i < n) && !failed; i++) {
+    if (placements[i].page < 0) continue;
+    if ((placements[i].page >= (int32_t)nPages) || (placements[i].x < padding) || (placements[i].y < padding) ||
+        (placements[i].x + widths[i] + padding > pageWidth) || (placements[i].y + heights[i] + padding > pageHeight)) {
+      printf("(mglBenchmarkAtlasPacker) %s image %u on %ux%u pages is off its page FAILED\n", name, i, pageWidth, pageHeight);
+      failed = 1;
+      break;
+    }
+    uint8_t *page = used + (size_t)placements[i].page * pageWidth * pageHeight;
+    for (uint32_t y = placements[i].y - padding; (y < placements[i].y + heights[i] + padding) && !failed; y++)
+      for (uint32_t x = placements[i].x - padding; x < placements[i].x + widths[i] + padding; x++) {
+        if (page[(size_t)y * pageWidth + x]) {
+          printf("(mglBenchmarkAtlasPacker) %s image %u on %ux%u pages overlaps another at %u,%u FAILED\n", name, i, pageWidth, pageHeight, x, y);
+          failed = 1;
+          break;
+        }
+        page[(size_t)y * pageWidth + x] = 1;
+      }
+  }
+  free(used);
+  free(placements);
+  free(again);
+  return failed;
+}
+
+////////////////////
+//   shelfPages   //
+////////////////////
+// Pages taken by packing the same images tallest first onto shelves, for comparison.
+static uint32_t shelfPages(const uint32_t *widths, const uint32_t *heights, uint32_t n, uint32_t pageWidth, uint32_t pageHeight, uint32_t padding, double *lastPageFraction)
+{
+  mglAtlasRect *rects = (mglAtlasRect *)malloc(n * sizeof(mglAtlasRect));
+  for (uint32_t i = 0; i < n; i++) {
+    rects[i].width = widths[i] + 2 * padding;
+    rects[i].height = heights[i] + 2 * padding;
+    rects[i].index = i;
+  }
+  qsort(rects, n, sizeof(mglAtlasRect), mglAtlasRectCompare);
+  uint32_t nPages = 0, shelfTop = 0, shelfHeight = 0, x = 0;
+  for (uint32_t i = 0; i < n; i++) {
+    if ((rects[i].width > pageWidth) || (rects[i].height > pageHeight)) continue;
+    if ((nPages == 0) || (x + rects[i].width > pageWidth)) {
+      // next shelf, or next page
+      shelfTop += shelfHeight;
+      shelfHeight = rects[i].height;
+      x = 0;
+      if ((nPages == 0) || (shelfTop + shelfHeight > pageHeight)) {
+        nPages++;
+        shelfTop = 0;
+      }
+    }
+    x += rects[i].width;
+  }
+  *lastPageFraction = (double)(shelfTop + shelfHeight) / pageHeight;
+  free(rects);
+  return nPages;
+}
+
+/////////////////
+//   makeSet   //
+/////////////////
+// Sizes like the images tasks show, returns how many.
+static uint32_t makeSet(int set, uint32_t *widths, uint32_t *heights, unsigned int seed)
+{
+  srand(seed);
+  uint32_t n = 0, i;
+  switch (set) {
+    case 0:
+      // letters and digits in 8 fonts at 4 sizes, same height and varying width within a size
+      for (i = 0; i < 62 * 8 * 4; i++, n++) {
+        uint32_t size = 24 + 16 * ((i / 62) % 4);
+        heights[n] = size + size / 3;
+        widths[n] = size / 3 + rand() % size;
+      }
+      break;
+    case 1:
+      // icons, mostly square at a few sizes
+      for (i = 0; i < 1000; i++, n++)
+        widths[n] = heights[n] = 32 << (rand() % 3);
+      break;
+    case 2:
+      // face images, portrait and similar in size
+      for (i = 0; i < 120; i++, n++) {
+        widths[n] = 180 + rand() % 40;
+        heights[n] = 240 + rand() % 40;
+      }
+      break;
+    case 3:
+      // anything from 4 to 300 pixels on a side
+      for (i = 0; i < 2000; i++, n++) {
+        widths[n] = 4 + rand() % 297;
+        heights[n] = 4 + rand() % 297;
+      }
+      break;
+    default:
+      // words and short strings of text, wide and short
+      for (i = 0; i < 800; i++, n++) {
+        heights[n] = 20 + rand() % 30;
+        widths[n] = 40 + rand() % 400;
+      }
+      break;
+  }
+  return n;
+}
+
+/////////////////
+//   getSecs   //
+/////////////////
+static double getSecs(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
@@ -0,0 +1,492 @@
+#ifdef documentation
+=========================================================================
+
+     program: mglBenchmarkFrameStream.c
+          by: justin gardner
+        date: 10/19/2026
+   copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+     purpose: standalone test and benchmark of mglFrameStream.h, the
+              file of precomputed stimulus frames that mglMetal maps
+              into memory and prefetches onto textures. Checks that run
+              length encoding gives back the same pixels for runs of
+              every kind, that frames written raw or encoded read back
+              the same with and without padding at the end of each row,
+              that broken or truncated files are not opened and that a
+              frame that can not be decoded fails rather than hangs.
+              Then shows frames to a simulated display at frameRate,
+              holding each until two frames later as the GPU would, and
+              reports how many were ready when asked for, how long any
+              wait took, and how fast frames decode. Needs no Matlab,
+              and builds on Linux or Mac with the makefile in this
+              directory.
+       usage: mglBenchmarkFrameStream [width height frames frameRate slots]
+
+=========================================================================
+#endif
+
+/////////////////////////
+//   include section   //
+/////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "../../metal/mglMetal/mglFrameStream.h"
+
+///////////////////////////////
+//   function declarations   //
+///////////////////////////////
+static int checkRunLength(const char *name, const uint8_t *pixels, uint32_t width, uint32_t height, uint32_t pixelBytes);
+static int checkRoundTrip(const char *path, uint32_t width, uint32_t height, uint32_t pixelFormat, uint32_t frames, int runLength);
+static int checkBrokenFiles(const char *path);
+static int checkPrefetcher(const char *path, uint32_t slotCount, uint32_t frames);
+static int showFrames(const char *path, double frameRate, uint32_t slotCount);
+static void makeFrame(uint8_t *pixels, uint32_t width, uint32_t height, uint32_t pixelFormat, uint32_t frame);
+static int writeStream(const char *path, uint32_t width, uint32_t height, uint32_t pixelFormat, uint32_t frames, double frameRate, int runLength);
+static double getSecs(void);
+static void sleepSecs(double secs);
+
+////////////////////////
+//   define section   //
+////////////////////////
+#define MAX_SLOTS MGL_FRAME_STREAM_MAX_SLOTS
+
+//////////////
+//   main   //
+//////////////
+int main(int argc, char *argv[])
+{
+  uint32_t width = (argc > 1) ? atoi(argv[1]) : 1024;
+  uint32_t height = (argc > 2) ? atoi(argv[2]) : 1024;
+  uint32_t frames = (argc > 3) ? atoi(argv[3]) : 600;
+  double frameRate = (argc > 4) ? atof(argv[4]) : 120;
+  uint32_t slotCount = (argc > 5) ? atoi(argv[5]) : 8;
+  int failed = 0;
+
+  // a file to write and read back
+  char path[256];
+  const char *tmpDir = getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp";
+  snprintf(path, sizeof(path), "%s/mglBenchmarkFrameStreamXXXXXX", tmpDir);
+  int fileDescriptor = mkstemp(path);
+  if (fileDescriptor < 0) {
+    printf("(mglBenchmarkFrameStream) Could not make a file in %s\n", tmpDir);
+    return 1;
+  }
+  close(fileDescriptor);
+
+  // runs of every kind, including ones that cross rows
+  {
+    uint8_t pixels[4 * 64];
+    memset(pixels, 7, sizeof(pixels));
+    failed |= checkRunLength("all the same", pixels, 8, 8, 4);
+    for (int i = 0; i < (int)sizeof(pixels); i++) pixels[i] = (uint8_t)(i * 37);
+    failed |= checkRunLength("all different", pixels, 8, 8, 4);
+    for (int i = 0; i < (int)sizeof(pixels); i++) pixels[i] = (uint8_t)((i / 4) % 2);
+    failed |= checkRunLength("alternating", pixels, 16, 4, 4);
+    for (int i = 0; i < (int)sizeof(pixels); i++) pixels[i] = (uint8_t)((i / 4) / 5 + ((i / 4) % 7 == 0));
+    failed |= checkRunLength("mixed runs", pixels, 5, 12, 4);
+    failed |= checkRunLength("one pixel", pixels, 1, 1, 4);
+    failed |= checkRunLength("one column", pixels, 1, 16, 16);
+  }
+
+  // frames written and read back
+  failed |= checkRoundTrip(path, 64, 48, mglFrameStreamRGBA8, 12, 0);
+  failed |= checkRoundTrip(path, 64, 48, mglFrameStreamRGBA8, 12, 1);
+  failed |= checkRoundTrip(path, 33, 17, mglFrameStreamRGBA32Float, 6, 1);
+  failed |= checkBrokenFiles(path);
+  if (!failed) printf("(mglBenchmarkFrameStream) Frames read back the same raw and encoded, broken files are refused OK\n");
+
+  // prefetching in and out of order
+  failed |= checkPrefetcher(path, 4, 40);
+  if (!failed) printf("(mglBenchmarkFrameStream) Prefetched frames are the right ones, in and out of order OK\n");
+
+  // a movie shown at frameRate, and how fast frames decode
+  if (writeStream(path, width, height, mglFrameStreamRGBA8, frames, frameRate, 1)) {
+    failed |= showFrames(path, frameRate, slotCount);
+  } else {
+    printf("(mglBenchmarkFrameStream) Could not write %ux%u frames to %s FAILED\n", width, height, path);
+    failed = 1;
+  }
+
+  unlink(path);
+  return failed;
+}
+
+////////////////////////
+//   checkRunLength   //
+////////////////////////
+// Encode and decode into rows with padding, and check the pixels and that the padding is untouched.
+static int checkRunLength(const char *name, const uint8_t *pixels, uint32_t width, uint32_t height, uint32_t pixelBytes)
+{
+  size_t pixelCount = (size_t)width * height;
+  size_t rowBytes = (size_t)width * pixelBytes;
+  size_t bytesPerRow = rowBytes + 3 * pixelBytes;
+  uint8_t *encoded = (uint8_t *)malloc(mglFrameStreamRunLengthBound(pixelCount, pixelBytes));
+  uint8_t *decoded = (uint8_t *)malloc(bytesPerRow * height);
+  memset(decoded, 0xAB, bytesPerRow * height);
+  int failed = 0;
+
+  size_t encodedBytes = mglFrameStreamRunLengthEncode(pixels, pixelCount, pixelBytes, encoded);
+  if (!mglFrameStreamRunLengthDecode(encoded, encodedBytes, pixelBytes, width, height, decoded, bytesPerRow)) {
+    printf("(mglBenchmarkFrameStream) Run length %s does not decode FAILED\n", name);
+    failed = 1;
+  }
+  for (uint32_t row = 0; (row < height) && !failed; row++) {
+    if (memcmp(decoded + row * bytesPerRow, pixels + row * rowBytes, rowBytes)) {
+      printf("(mglBenchmarkFrameStream) Run length %s row %u is different FAILED\n", name, row);
+      failed = 1;
+    }
+    for (size_t i = rowBytes; (i < bytesPerRow) && !failed; i++) {
+      if (decoded[row * bytesPerRow + i] != 0xAB) {
+        printf("(mglBenchmarkFrameStream) Run length %s wrote past row %u FAILED\n", name, row);
+        failed = 1;
+      }
+    }
+  }
+
+  // missing the last byte, or with a run too long, must not decode
+  if ((encodedBytes > 0) && mglFrameStreamRunLengthDecode(encoded, encodedBytes - 1, pixelBytes, width, height, decoded, bytesPerRow)) {
+    printf("(mglBenchmarkFrameStream) Run length %s decodes with a byte missing FAILED\n", name);
+    failed = 1;
+  }
+  uint32_t tooLong = (uint32_t)pixelCount + 1;
+  memcpy(encoded, &tooLong, sizeof(tooLong));
+  if (mglFrameStreamRunLengthDecode(encoded, encodedBytes, pixelBytes, width, height, decoded, bytesPerRow)) {
+    printf("(mglBenchmarkFrameStream) Run length %s decodes with a run too long FAILED\n", name);
+    failed = 1;
+  }
+  free(encoded);
+  free(decoded);
+  return failed;
+}
+
+////////////////////////
+//   checkRoundTrip   //
+////////////////////////
+// Write frames, map them and decode each with and without row padding.
+static int checkRoundTrip(const char *path, uint32_t width, uint32_t height, uint32_t pixelFormat, uint32_t frames, int runLength)
+{
+  uint32_t pixelBytes = mglFrameStreamPixelBytes(pixelFormat);
+  size_t rowBytes = (size_t)width * pixelBytes;
+  size_t bytesPerRow = (rowBytes + 255) & ~(size_t)255;
+  uint8_t *expected = (uint8_t *)malloc(rowBytes * height);
+  uint8_t *decoded = (uint8_t *)malloc(bytesPerRow * height);
+  int failed = 0;
+
+  if (!writeStream(path, width, height, pixelFormat, frames, 60, runLength)) {
+    printf("(mglBenchmarkFrameStream) Could not write %ux%u frames FAILED\n", width, height);
+    free(expected);
+    free(decoded);
+    return 1;
+  }
+  mglFrameStream stream;
+  if (!mglFrameStreamMap(&stream, path)) {
+    printf("(mglBenchmarkFrameStream) Could not open %ux%u frames just written FAILED\n", width, height);
+    free(expected);
+    free(decoded);
+    return 1;
+  }
+  if ((stream.header.width != width) || (stream.header.height != height) || (stream.header.frameCount != frames) ||
+      (stream.header.pixelFormat != pixelFormat) || (stream.header.frameRate != 60)) {
+    printf("(mglBenchmarkFrameStream) Header of %ux%u frames is not what was written FAILED\n", width, height);
+    failed = 1;
+  }
+  uint32_t encodedCount = 0;
+  for (uint32_t frame = 0; (frame < stream.header.frameCount) && !failed; frame++) {
+    makeFrame(expected, width, height, pixelFormat, frame);
+    encodedCount += (stream.index[frame].encoding == mglFrameStreamRunLength);
+    if (stream.index[frame].offset % MGL_FRAME_STREAM_ALIGNMENT) {
+      printf("(mglBenchmarkFrameStream) Frame %u is not aligned FAILED\n", frame);
+      failed = 1;
+    }
+    // rows next to each other, then rows padded like a texture
+    if (!mglFrameStreamDecode(&stream, frame, decoded, rowBytes) || memcmp(decoded, expected, rowBytes * height)) {
+      printf("(mglBenchmarkFrameStream) Frame %u of %ux%u %s frames is different FAILED\n", frame, width, height, runLength ? "encoded" : "raw");
+      failed = 1;
+    }
+    if (!mglFrameStreamDecode(&stream, frame, decoded, bytesPerRow)) {
+      failed = 1;
+    }
+    for (uint32_t row = 0; (row < height) && !failed; row++) {
+      if (memcmp(decoded + row * bytesPerRow, expected + row * rowBytes, rowBytes)) {
+        printf("(mglBenchmarkFrameStream) Frame %u row %u of %ux%u padded rows is different FAILED\n", frame, row, width, height);
+        failed = 1;
+      }
+    }
+  }
+  // odd frames are noise, which is kept raw, and even frames are a patch on gray, which encodes smaller
+  if (!failed && (encodedCount != (runLength ? (frames + 1) / 2 : 0))) {
+    printf("(mglBenchmarkFrameStream) %u of %u %ux%u frames were encoded FAILED\n", encodedCount, frames, width, height);
+    failed = 1;
+  }
+  if (mglFrameStreamDecode(&stream, frames, decoded, bytesPerRow) || mglFrameStreamDecode(&stream, 0, decoded, rowBytes - 1)) {
+    printf("(mglBenchmarkFrameStream) Decoding past the last frame or into short rows did not fail FAILED\n");
+    failed = 1;
+  }
+  mglFrameStreamUnmap(&stream);
+  free(expected);
+  free(decoded);
+  return failed;
+}
+
+//////////////////////////
+//   checkBrokenFiles   //
+//////////////////////////
+// Files that are cut short or not frame streams do not open, and a frame that does not decode fails.
+static int checkBrokenFiles(const char *path)
+{
+  mglFrameStream stream;
+  int failed = 0;
+  if (mglFrameStreamMap(&stream, "/nonexistent/mglBenchmarkFrameStream")) {
+    printf("(mglBenchmarkFrameStream) A file that does not exist opened FAILED\n");
+    failed = 1;
+  }
+
+  // cut short, in the index
+  writeStream(path, 16, 16, mglFrameStreamRGBA8, 4, 60, 1);
+  struct stat fileStat;
+  stat(path, &fileStat);
+  if (truncate(path, fileStat.st_size - 1) || mglFrameStreamMap(&stream, path)) {
+    printf("(mglBenchmarkFrameStream) A file cut short opened FAILED\n");
+    failed = 1;
+  }
+
+  // not a frame stream
+  writeStream(path, 16, 16, mglFrameStreamRGBA8, 4, 60, 1);
+  FILE *file = fopen(path, "r+b");
+  fwrite("MGLFRMS0", 1, 8, file);
+  fclose(file);
+  if (mglFrameStreamMap(&stream, path)) {
+    printf("(mglBenchmarkFrameStream) A file with the wrong magic opened FAILED\n");
+    failed = 1;
+  }
+
+  // a run in frame 2 longer than the frame
+  writeStream(path, 16, 16, mglFrameStreamRGBA8, 4, 60, 1);
+  if (!mglFrameStreamMap(&stream, path) || (stream.index[2].encoding != mglFrameStreamRunLength)) {
+    printf("(mglBenchmarkFrameStream) Could not open frames to break FAILED\n");
+    return 1;
+  }
+  uint64_t offset = stream.index[2].offset;
+  mglFrameStreamUnmap(&stream);
+  file = fopen(path, "r+b");
+  uint32_t tooLong = 16 * 16 + 1;
+  fseek(file, (long)offset, SEEK_SET);
+  fwrite(&tooLong, sizeof(tooLong), 1, file);
+  fclose(file);
+  mglFrameStreamMap(&stream, path);
+  uint8_t *slotMemory = (uint8_t *)malloc(2 * 16 * 16 * 4);
+  void *slots[2] = {slotMemory, slotMemory + 16 * 16 * 4};
+  mglFrameStreamPrefetcher prefetcher;
+  mglFrameStreamPrefetcherStart(&prefetcher, &stream, slots, 2, 16 * 4);
+  double waitedSecs;
+  double startTime = getSecs();
+  int slot = mglFrameStreamAcquire(&prefetcher, 2, 5.0, &waitedSecs);
+  if ((slot >= 0) || (getSecs() - startTime > 1.0) || (prefetcher.failedCount != 1)) {
+    printf("(mglBenchmarkFrameStream) A frame that does not decode did not fail right away FAILED\n");
+    failed = 1;
+  }
+  slot = mglFrameStreamAcquire(&prefetcher, 3, 5.0, &waitedSecs);
+  if (slot < 0) {
+    printf("(mglBenchmarkFrameStream) The frame after one that does not decode is not shown FAILED\n");
+    failed = 1;
+  }
+  mglFrameStreamRelease(&prefetcher, slot);
+  mglFrameStreamPrefetcherStop(&prefetcher);
+  mglFrameStreamUnmap(&stream);
+  free(slotMemory);
+  return failed;
+}
+
+/////////////////////////
+//   checkPrefetcher   //
+/////////////////////////
+// Acquire frames forward, backward and skipping, and check each slot has the right frame.
+static int checkPrefetcher(const char *path, uint32_t slotCount, uint32_t frames)
+{
+  uint32_t width = 24, height = 20;
+  size_t frameBytes = (size_t)width * height * 4;
+  if (!writeStream(path, width, height, mglFrameStreamRGBA8, frames, 60, 1)) return 1;
+  mglFrameStream stream;
+  if (!mglFrameStreamMap(&stream, path)) return 1;
+  uint8_t *slotMemory = (uint8_t *)malloc(slotCount * frameBytes);
+  uint8_t *expected = (uint8_t *)malloc(frameBytes);
+  void *slots[MAX_SLOTS];
+  for (uint32_t slot = 0; slot < slotCount; slot++) slots[slot] = slotMemory + slot * frameBytes;
+  mglFrameStreamPrefetcher prefetcher;
+  if (!mglFrameStreamPrefetcherStart(&prefetcher, &stream, slots, slotCount, width * 4)) {
+    printf("(mglBenchmarkFrameStream) Could not start prefetching FAILED\n");
+    return 1;
+  }
+
+  // forward holding two at a time like the display, then back, then skipping about
+  uint32_t order[64];
+  uint32_t n = 0;
+  for (uint32_t frame = 0; frame < 20; frame++) order[n++] = frame;
+  for (uint32_t frame = 10; frame > 5; frame--) order[n++] = frame;
+  uint32_t skips[] = {frames - 1, 0, 30, 31, 3, frames - 1, frames - 2};
+  for (uint32_t i = 0; i < sizeof(skips) / sizeof(skips[0]); i++) order[n++] = skips[i];
+
+  int failed = 0;
+  int held[2] = {-1, -1};
+  for (uint32_t i = 0; (i < n) && !failed; i++) {
+    double waitedSecs;
+    int slot = mglFrameStreamAcquire(&prefetcher, order[i], 5.0, &waitedSecs);
+    makeFrame(expected, width, height, mglFrameStreamRGBA8, order[i]);
+    if ((slot < 0) || memcmp(slots[slot], expected, frameBytes)) {
+      printf("(mglBenchmarkFrameStream) Frame %u acquired %u of %u is %s FAILED\n", order[i], i, n, (slot < 0) ? "missing" : "different");
+      failed = 1;
+    }
+    // release two later, as the display would
+    mglFrameStreamRelease(&prefetcher, held[i % 2]);
+    held[i % 2] = slot;
+  }
+  mglFrameStreamRelease(&prefetcher, held[0]);
+  mglFrameStreamRelease(&prefetcher, held[1]);
+  double waitedSecs;
+  if (mglFrameStreamAcquire(&prefetcher, frames, 0.1, &waitedSecs) >= 0) {
+    printf("(mglBenchmarkFrameStream) Frame past the last was acquired FAILED\n");
+    failed = 1;
+  }
+  mglFrameStreamPrefetcherStop(&prefetcher);
+  mglFrameStreamUnmap(&stream);
+  free(slotMemory);
+  free(expected);
+  return failed;
+}
+
+////////////////////
+//   showFrames   //
+////////////////////
+// Acquire each frame at its time, as mglMetal would for a frame stream shown every refresh.
+static int showFrames(const char *path, double frameRate, uint32_t slotCount)
+{
+  mglFrameStream stream;
+  if (!mglFrameStreamMap(&stream, path)) {
+    printf("(mglBenchmarkFrameStream) Could not open %s FAILED\n", path);
+    return 1;
+  }
+  uint32_t width = stream.header.width, height = stream.header.height, frames = stream.header.frameCount;
+  size_t frameBytes = mglFrameStreamFrameBytes(&stream.header);
+  struct stat fileStat;
+  stat(path, &fileStat);
+
+  // how fast frames decode on one thread
+  uint8_t *slotMemory = (uint8_t *)malloc(slotCount * frameBytes);
+  void *slots[MAX_SLOTS];
+  for (uint32_t slot = 0; slot < slotCount; slot++) slots[slot] = slotMemory + slot * frameBytes;
+  double startTime = getSecs();
+  for (uint32_t frame = 0; frame < frames; frame++)
+    mglFrameStreamDecode(&stream, frame, slots[frame % slotCount], width * 4);
+  double decodeSecs = (getSecs() - startTime) / frames;
+  printf("(mglBenchmarkFrameStream) %u %ux%u frames, %0.1f MB in file (%0.0f%% of raw), decode in %0.2f ms each (%0.0f MB/s)\n",
+         frames, width, height, fileStat.st_size / 1e6, 100.0 * fileStat.st_size / ((double)frameBytes * frames),
+         1000 * decodeSecs, frameBytes / decodeSecs / 1e6);
+
+  // shown at frameRate, holding each frame until two frames later
+  mglFrameStreamPrefetcher prefetcher;
+  if (!mglFrameStreamPrefetcherStart(&prefetcher, &stream, slots, slotCount, width * 4)) {
+    printf("(mglBenchmarkFrameStream) Could not start prefetching FAILED\n");
+    return 1;
+  }
+  double frameSecs = 1 / frameRate;
+  int held[2] = {-1, -1};
+  uint32_t missed = 0;
+  double maxWaitedSecs = 0, totalWaitedSecs = 0;
+  double firstWaitedSecs = 0;
+  startTime = getSecs();
+  for (uint32_t frame = 0; frame < frames; frame++) {
+    // wait for the refresh, then acquire with up to half a frame to spare
+    sleepSecs(startTime + frame * frameSecs - getSecs());
+    double waitedSecs;
+    int slot = mglFrameStreamAcquire(&prefetcher, frame, frameSecs / 2, &waitedSecs);
+    if (slot < 0) missed++;
+    if (frame == 0)
+      firstWaitedSecs = waitedSecs;
+    else {
+      totalWaitedSecs += waitedSecs;
+      if (waitedSecs > maxWaitedSecs) maxWaitedSecs = waitedSecs;
+    }
+    mglFrameStreamRelease(&prefetcher, held[frame % 2]);
+    held[frame % 2] = slot;
+  }
+  mglFrameStreamRelease(&prefetcher, held[0]);
+  mglFrameStreamRelease(&prefetcher, held[1]);
+  printf("(mglBenchmarkFrameStream) Shown at %0.0f Hz with %u slots: %llu ready, %llu waited (mean %0.3f ms, max %0.3f ms after the first which took %0.2f ms), %u missed\n",
+         frameRate, slotCount, (unsigned long long)prefetcher.readyCount, (unsigned long long)prefetcher.waitedCount,
+         1000 * totalWaitedSecs / (frames > 1 ? frames - 1 : 1), 1000 * maxWaitedSecs, 1000 * firstWaitedSecs, missed);
+  mglFrameStreamPrefetcherStop(&prefetcher);
+  mglFrameStreamUnmap(&stream);
+  free(slotMemory);
+  return 0;
+}
+
+///////////////////
+//   makeFrame   //
+///////////////////
+// Even frames are a moving patch on a gray background, which encodes small, and odd frames are noise, which does not.
+static void makeFrame(uint8_t *pixels, uint32_t width, uint32_t height, uint32_t pixelFormat, uint32_t frame)
+{
+  unsigned int seed = frame * 2654435761u + 1;
+  for (uint32_t y = 0; y < height; y++)
+    for (uint32_t x = 0; x < width; x++) {
+      float rgba[4];
+      if (frame % 2) {
+        for (int c = 0; c < 3; c++) {
+          seed = seed * 1103515245u + 12345u;
+          rgba[c] = (float)((seed >> 16) & 255) / 255.0f;
+        }
+      } else {
+        int inPatch = ((x + frame) % width < width / 3) && (y > height / 4) && (y < height / 2);
+        float value = inPatch ? (float)(0.5 + 0.5 * sin(x * 0.3 + frame * 0.1)) : 0.5f;
+        rgba[0] = rgba[1] = rgba[2] = value;
+      }
+      rgba[3] = 1;
+      size_t pixel = (size_t)y * width + x;
+      for (int c = 0; c < 4; c++) {
+        if (pixelFormat == mglFrameStreamRGBA32Float)
+          ((float *)pixels)[pixel * 4 + c] = rgba[c];
+        else
+          pixels[pixel * 4 + c] = (uint8_t)(rgba[c] * 255 + 0.5f);
+      }
+    }
+}
+
+/////////////////////
+//   writeStream   //
+/////////////////////
+static int writeStream(const char *path, uint32_t width, uint32_t height, uint32_t pixelFormat, uint32_t frames, double frameRate, int runLength)
+{
+  mglFrameStreamWriter writer;
+  if (!mglFrameStreamWriterOpen(&writer, path, width, height, pixelFormat, frameRate, runLength)) return 0;
+  uint8_t *pixels = (uint8_t *)malloc((size_t)width * height * mglFrameStreamPixelBytes(pixelFormat));
+  int written = 1;
+  for (uint32_t frame = 0; (frame < frames) && written; frame++) {
+    makeFrame(pixels, width, height, pixelFormat, frame);
+    written = mglFrameStreamWriterAdd(&writer, pixels);
+  }
+  free(pixels);
+  return mglFrameStreamWriterClose(&writer) && written;
+}
+
+/////////////////
+//   getSecs   //
+/////////////////
+static double getSecs(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+///////////////////
+//   sleepSecs   //
+///////////////////
+static void sleepSecs(double secs)
+{
+  if (secs <= 0) return;
+  struct timespec duration;
+  duration.tv_sec = (time_t)secs;
+  duration.tv_nsec = (long)((secs - (double)duration.tv_sec) * 1e9);
+  nanosleep(&duration, NULL);
+}
@@ -0,0 +1,403 @@
+#ifdef documentation
+=========================================================================
+
+     program: mglBenchmarkGlyphCache.c
+          by: justin gardner
+        date: 10/19/2026
+   copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+     purpose: standalone test and benchmark of mglGlyphCache.h, the cache
+              of glyphs on atlas pages that mglTextDraw uses to draw text
+              as glyph quads. Checks that glyphs are found again in the
+              font they were added to, that missing characters are each
+              listed once, that glyphs with their padding are inside their
+              page and do not overlap, that layout of known glyphs puts
+              them where they should be for each alignment and over many
+              lines, and that a full cache says so and can be flushed and
+              filled again. Then times a feedback counter that changes
+              every frame and a page of text with many different
+              characters, and reports how many pixels of glyphs had to be
+              rendered and sent, next to rendering each string as a whole
+              (mglText). Needs no Matlab, and builds on Linux or Mac with
+              the makefile in this directory.
+       usage: mglBenchmarkGlyphCache [nFrames]
+
+=========================================================================
+#endif
+
+/////////////////////////
+//   include section   //
+/////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "../mglGlyphCache.h"
+
+///////////////////////////////
+//   function declarations   //
+///////////////////////////////
+static int checkFind(void);
+static int checkMissing(void);
+static int checkPlacement(void);
+static int checkLayout(void);
+static int checkFull(void);
+static int32_t addGlyph(mglGlyphCache *cache, uint32_t font, uint32_t codepoint);
+static uint32_t addMissing(mglGlyphCache *cache, uint32_t font, const uint32_t *codepoints, uint32_t n, double *pixels);
+static uint32_t toCodepoints(const char *string, uint32_t *codepoints);
+static double stringPixels(const mglGlyphCache *cache, uint32_t font, const uint32_t *codepoints, uint32_t n);
+static int failure(const char *message);
+static double getSecs(void);
+
+////////////////////////
+//   define section   //
+////////////////////////
+#define MAX_STRING 4096
+#define LINE_HEIGHT 28
+
+//////////////
+//   main   //
+//////////////
+int main(int argc, char *argv[])
+{
+  int nFrames = (argc > 1) ? atoi(argv[1]) : 100000;
+  int failed = 0;
+
+  failed |= checkFind();
+  failed |= checkMissing();
+  failed |= checkPlacement();
+  failed |= checkLayout();
+  failed |= checkFull();
+  if (!failed) printf("(mglBenchmarkGlyphCache) Glyphs are found, placed, laid out and flushed as they should be OK\n");
+
+  uint32_t *codepoints = (uint32_t *)malloc(MAX_STRING * sizeof(uint32_t));
+  uint32_t *missing = (uint32_t *)malloc(MAX_STRING * sizeof(uint32_t));
+  mglGlyphQuad *quads = (mglGlyphQuad *)malloc(MAX_STRING * sizeof(mglGlyphQuad));
+  mglGlyphCache cache;
+  mglGlyphCacheInit(&cache, 512, 512, 1, 4);
+  uint32_t font = (uint32_t)mglGlyphCacheFont(&cache, "Helvetica 32 0 0 [1 1 1 1]");
+
+  // a feedback counter, a new string every frame
+  char string[256];
+  double glyphPixels = 0, wholePixels = 0, layoutTime = 0;
+  uint32_t nGlyphs = 0, nRendered = 0;
+  float width, height;
+  for (int frame = 0; frame < nFrames; frame++) {
+    snprintf(string, sizeof(string), "Correct: %d/%d  Time: %0.2f s", frame / 3, frame, frame / 120.0);
+    uint32_t n = toCodepoints(string, codepoints);
+    double startTime = getSecs();
+    uint32_t nMissing = mglGlyphCacheMissing(&cache, font, codepoints, n, missing);
+    if (nMissing) {
+      layoutTime -= getSecs() - startTime;
+      nRendered += addMissing(&cache, font, missing, nMissing, &glyphPixels);
+      startTime = getSecs();
+    }
+    nGlyphs += mglGlyphCacheLayout(&cache, font, codepoints, n, 0, 0, quads, &width, &height);
+    layoutTime += getSecs() - startTime;
+    wholePixels += stringPixels(&cache, font, codepoints, n);
+  }
+  printf("(mglBenchmarkGlyphCache) counter, %i frames: %0.1f ns a glyph to lay out, %u glyphs rendered with %0.0f pixels, whole strings would be %0.0f pixels\n",
+         nFrames, 1e9 * layoutTime / (nGlyphs ? nGlyphs : 1), nRendered, glyphPixels, wholePixels);
+
+  // a page of text with many different characters, as for a language with thousands, which
+  // fills two pages and flushes the cache
+  mglGlyphCacheFree(&cache);
+  mglGlyphCacheInit(&cache, 512, 512, 1, 2);
+  font = (uint32_t)mglGlyphCacheFont(&cache, "Helvetica 32 0 0 [1 1 1 1]");
+  glyphPixels = wholePixels = layoutTime = 0;
+  nGlyphs = nRendered = 0;
+  srand(1);
+  int nPages = nFrames / 100 + 1;
+  for (int page = 0; page < nPages; page++) {
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < 2000; i++) {
+      // common characters much more often than rare ones
+      uint32_t rank = (uint32_t)(3000.0 * ((double)rand() / RAND_MAX) * ((double)rand() / RAND_MAX) * ((double)rand() / RAND_MAX));
+      codepoints[n++] = ((i % 40) == 39) ? '\n' : 0x4e00 + rank;
+    }
+    double startTime = getSecs();
+    for (int attempt = 0; attempt < 2; attempt++) {
+      uint32_t nMissing = mglGlyphCacheMissing(&cache, font, codepoints, n, missing);
+      if (nMissing == 0) break;
+      layoutTime -= getSecs() - startTime;
+      uint64_t flushesBefore = cache.flushes;
+      nRendered += addMissing(&cache, font, missing, nMissing, &glyphPixels);
+      startTime = getSecs();
+      if (cache.flushes == flushesBefore) break;
+    }
+    nGlyphs += mglGlyphCacheLayout(&cache, font, codepoints, n, -1, -1, quads, &width, &height);
+    layoutTime += getSecs() - startTime;
+    wholePixels += stringPixels(&cache, font, codepoints, n);
+  }
+  printf("(mglBenchmarkGlyphCache) pages of text, %i pages: %0.1f ns a glyph to lay out, %u glyphs rendered with %0.0f pixels, %u flushes, whole strings would be %0.0f pixels\n",
+         nPages, 1e9 * layoutTime / (nGlyphs ? nGlyphs : 1), nRendered, glyphPixels, (unsigned int)cache.flushes, wholePixels);
+
+  mglGlyphCacheFree(&cache);
+  free(codepoints);
+  free(missing);
+  free(quads);
+  return failed;
+}
+
+///////////////////
+//   checkFind   //
+///////////////////
+// Glyphs are found again in their own font only, and fonts keep their numbers.
+static int checkFind(void)
+{
+  mglGlyphCache cache;
+  mglGlyphCacheInit(&cache, 256, 256, 1, 64);
+  int32_t helvetica = mglGlyphCacheFont(&cache, "Helvetica 32");
+  int32_t times = mglGlyphCacheFont(&cache, "Times 32");
+  int failed = 0;
+  if ((helvetica != 0) || (times != 1) || (mglGlyphCacheFont(&cache, "Helvetica 32") != 0))
+    failed |= failure("Fonts are not numbered in the order they are first used");
+
+  // many glyphs, so the table grows a few times
+  for (uint32_t codepoint = 0; codepoint < 3000; codepoint++) {
+    int32_t index = addGlyph(&cache, (uint32_t)helvetica, codepoint);
+    if ((index < 0) || (addGlyph(&cache, (uint32_t)helvetica, codepoint) != index)) {
+      failed |= failure("Adding a glyph again does not give the one that is cached");
+      break;
+    }
+  }
+  for (uint32_t codepoint = 0; codepoint < 3000; codepoint++) {
+    int32_t index = mglGlyphCacheFind(&cache, (uint32_t)helvetica, codepoint);
+    if ((index < 0) || (cache.glyphs[index].codepoint != codepoint) || (cache.glyphs[index].font != (uint32_t)helvetica)) {
+      failed |= failure("A glyph is not found after the table grows");
+      break;
+    }
+  }
+  if (mglGlyphCacheFind(&cache, (uint32_t)times, 'A') >= 0)
+    failed |= failure("A glyph is found in a font it was not added to");
+  mglGlyphCacheFree(&cache);
+  return failed;
+}
+
+//////////////////////
+//   checkMissing   //
+//////////////////////
+// Missing characters are each listed once, in order, and not newlines or cached ones.
+static int checkMissing(void)
+{
+  mglGlyphCache cache;
+  mglGlyphCacheInit(&cache, 256, 256, 1, 4);
+  uint32_t font = (uint32_t)mglGlyphCacheFont(&cache, "Helvetica 32");
+  addGlyph(&cache, font, 'l');
+  uint32_t codepoints[MAX_STRING], missing[MAX_STRING];
+  uint32_t n = toCodepoints("hello\nworld", codepoints);
+  uint32_t nMissing = mglGlyphCacheMissing(&cache, font, codepoints, n, missing);
+  uint32_t expected[] = {'h', 'e', 'o', 'w', 'r', 'd'};
+  int failed = 0;
+  if ((nMissing != 6) || memcmp(missing, expected, sizeof(expected)))
+    failed |= failure("Missing characters of hello\\nworld are not h e o w r d");
+  mglGlyphCacheFree(&cache);
+  return failed;
+}
+
+////////////////////////
+//   checkPlacement   //
+////////////////////////
+// Glyphs with their padding are inside their page and do not overlap, and spaces take no room.
+static int checkPlacement(void)
+{
+  uint32_t pageWidth = 128, pageHeight = 96, padding = 2;
+  mglGlyphCache cache;
+  mglGlyphCacheInit(&cache, pageWidth, pageHeight, padding, 64);
+  uint32_t font = (uint32_t)mglGlyphCacheFont(&cache, "Helvetica 32");
+  int failed = 0;
+  for (uint32_t codepoint = 0; codepoint < 1000; codepoint++)
+    if (addGlyph(&cache, font, codepoint) < 0) {
+      failed |= failure("Glyphs do not fit on 64 pages");
+      break;
+    }
+
+  uint8_t *used = (uint8_t *)calloc((size_t)cache.pageCount * pageWidth * pageHeight, 1);
+  for (uint32_t i = 0; (i < cache.glyphCount) && !failed; i++) {
+    const mglGlyph *glyph = &cache.glyphs[i];
+    if (glyph->codepoint == ' ') {
+      if (glyph->page != -1) failed |= failure("A space is put on a page");
+      continue;
+    }
+    if ((glyph->page < 0) || ((uint32_t)glyph->page >= cache.pageCount) || (glyph->x < padding) || (glyph->y < padding) ||
+        (glyph->x + glyph->width + padding > pageWidth) || (glyph->y + glyph->height + padding > pageHeight)) {
+      failed |= failure("A glyph is not inside its page");
+      break;
+    }
+    for (uint32_t y = glyph->y - padding; y < glyph->y + glyph->height + padding; y++)
+      for (uint32_t x = glyph->x - padding; x < glyph->x + glyph->width + padding; x++) {
+        uint8_t *pixel = &used[((size_t)glyph->page * pageHeight + y) * pageWidth + x];
+        if (*pixel && !failed) failed |= failure("Glyphs overlap");
+        *pixel = 1;
+      }
+  }
+  free(used);
+  mglGlyphCacheFree(&cache);
+  return failed;
+}
+
+/////////////////////
+//   checkLayout   //
+/////////////////////
+// Glyphs of known size go where they should for each alignment, over two lines.
+static int checkLayout(void)
+{
+  mglGlyphCache cache;
+  mglGlyphCacheInit(&cache, 100, 100, 0, 4);
+  uint32_t font = (uint32_t)mglGlyphCacheFont(&cache, "Courier 20");
+  // every glyph is 8x10 of ink, 1 from the left and 4 from the top of a 20 high line, and advances 10
+  const char *characters = "abc";
+  for (int i = 0; i < 3; i++)
+    mglGlyphCacheAdd(&cache, font, characters[i], 8, 10, 1, 4, 10, 20);
+  mglGlyphCacheAdd(&cache, font, ' ', 0, 0, 0, 0, 10, 20);
+
+  uint32_t codepoints[16];
+  uint32_t n = toCodepoints("ab c\nbc", codepoints);
+  mglGlyphQuad quads[16];
+  float width, height;
+  int failed = 0;
+  for (int hAlignment = -1; hAlignment <= 1; hAlignment++)
+    for (int vAlignment = -1; vAlignment <= 1; vAlignment++) {
+      uint32_t nQuads = mglGlyphCacheLayout(&cache, font, codepoints, n, hAlignment, vAlignment, quads, &width, &height);
+      // first line is 40 wide and the second 20, the block is 40 x 40
+      float lineShift[2], blockShift = (vAlignment + 1) * -20.0f;
+      for (int line = 0; line < 2; line++)
+        lineShift[line] = (hAlignment + 1) * ((line == 0) ? -20.0f : -10.0f);
+      float expectedX[5] = {1 + lineShift[0], 11 + lineShift[0], 31 + lineShift[0], 1 + lineShift[1], 11 + lineShift[1]};
+      float expectedY[5] = {4 + blockShift, 4 + blockShift, 4 + blockShift, 24 + blockShift, 24 + blockShift};
+      int wrong = (nQuads != 5) || (width != 40) || (height != 40);
+      for (uint32_t i = 0; (i < nQuads) && !wrong; i++)
+        wrong = (quads[i].x != expectedX[i]) || (quads[i].y != expectedY[i]) || (quads[i].width != 8) || (quads[i].height != 10) ||
+          (fabsf(quads[i].u1 - quads[i].u0 - 0.08f) > 1e-6f) || (fabsf(quads[i].v1 - quads[i].v0 - 0.1f) > 1e-6f);
+      if (wrong) {
+        char message[128];
+        snprintf(message, sizeof(message), "Layout of ab c\\nbc with alignment %i %i is not where it should be", hAlignment, vAlignment);
+        failed |= failure(message);
+      }
+    }
+
+  // characters that are not cached are left out and counted
+  cache.hits = cache.misses = 0;
+  n = toCodepoints("axb", codepoints);
+  if ((mglGlyphCacheLayout(&cache, font, codepoints, n, -1, -1, quads, &width, &height) != 2) || (cache.hits != 2) || (cache.misses != 1) || (quads[1].x != 11))
+    failed |= failure("A character that is not cached is not left out of layout");
+  mglGlyphCacheFree(&cache);
+  return failed;
+}
+
+///////////////////
+//   checkFull   //
+///////////////////
+// A full cache says so, and can be flushed and filled again with the same fonts.
+static int checkFull(void)
+{
+  mglGlyphCache cache;
+  mglGlyphCacheInit(&cache, 64, 64, 1, 2);
+  uint32_t font = (uint32_t)mglGlyphCacheFont(&cache, "Helvetica 32");
+  int failed = 0;
+  uint32_t codepoint;
+  int32_t index = 0;
+  for (codepoint = 'A'; (codepoint < 1000) && (index >= 0); codepoint++)
+    index = addGlyph(&cache, font, codepoint);
+  if ((index != MGL_GLYPH_CACHE_FULL) || (cache.pageCount != 2))
+    failed |= failure("Two pages do not fill up");
+  if (mglGlyphCacheAdd(&cache, font, 'B', 100, 10, 0, 0, 100, 20) != mglGlyphCacheFind(&cache, font, 'B'))
+    failed |= failure("A cached glyph is not found when the pages are full");
+  if (mglGlyphCacheAdd(&cache, font, 1000, 70, 10, 0, 0, 70, 20) != MGL_GLYPH_CACHE_FULL)
+    failed |= failure("A glyph too big for a page is added");
+
+  mglGlyphCacheFlush(&cache);
+  if ((cache.glyphCount != 0) || (cache.pageCount != 0) || (mglGlyphCacheFind(&cache, font, 'A') >= 0) || (cache.flushes != 1))
+    failed |= failure("Flushing does not empty the cache");
+  if ((mglGlyphCacheFont(&cache, "Helvetica 32") != (int32_t)font) || (addGlyph(&cache, font, 'A') != 0))
+    failed |= failure("The cache can not be filled again after a flush");
+  mglGlyphCacheFree(&cache);
+  return failed;
+}
+
+//////////////////
+//   addGlyph   //
+//////////////////
+// A made up glyph for a character, 6-15 pixels wide and 10-17 high, except space which has no ink.
+static int32_t addGlyph(mglGlyphCache *cache, uint32_t font, uint32_t codepoint)
+{
+  if (codepoint == ' ')
+    return mglGlyphCacheAdd(cache, font, codepoint, 0, 0, 0, 0, 8, LINE_HEIGHT);
+  uint32_t width = 6 + (codepoint * 7) % 10, height = 10 + codepoint % 8;
+  return mglGlyphCacheAdd(cache, font, codepoint, width, height, 1, (float)(22 - height + codepoint % 3), (float)(width + 2), LINE_HEIGHT);
+}
+
+////////////////////
+//   addMissing   //
+////////////////////
+// Add missing glyphs as mglTextDraw does, flushing and adding them again if the pages are full,
+// but only once, and count the pixels that had to be rendered. Returns how many glyphs were rendered.
+static uint32_t addMissing(mglGlyphCache *cache, uint32_t font, const uint32_t *codepoints, uint32_t n, double *pixels)
+{
+  uint32_t i, nRendered = 0;
+  int flushed = 0;
+  for (i = 0; i < n; i++) {
+    int32_t index = addGlyph(cache, font, codepoints[i]);
+    nRendered++;
+    if ((index == MGL_GLYPH_CACHE_FULL) && !flushed) {
+      mglGlyphCacheFlush(cache);
+      flushed = 1;
+      i = (uint32_t)-1;
+      continue;
+    }
+    if (index >= 0) *pixels += (double)cache->glyphs[index].width * cache->glyphs[index].height;
+  }
+  return nRendered;
+}
+
+//////////////////////
+//   toCodepoints   //
+//////////////////////
+static uint32_t toCodepoints(const char *string, uint32_t *codepoints)
+{
+  uint32_t n = 0;
+  while (string[n] && (n < MAX_STRING)) {
+    codepoints[n] = (unsigned char)string[n];
+    n++;
+  }
+  return n;
+}
+
+//////////////////////
+//   stringPixels   //
+//////////////////////
+// Pixels of an image of the whole string, as mglText renders and sends it.
+static double stringPixels(const mglGlyphCache *cache, uint32_t font, const uint32_t *codepoints, uint32_t n)
+{
+  double lineWidth = 0, width = 0;
+  uint32_t nLines = 1;
+  for (uint32_t i = 0; i < n; i++) {
+    if (codepoints[i] == '\n') {
+      nLines++;
+      lineWidth = 0;
+      continue;
+    }
+    int32_t index = mglGlyphCacheFind(cache, font, codepoints[i]);
+    if (index >= 0) lineWidth += cache->glyphs[index].advance;
+    if (lineWidth > width) width = lineWidth;
+  }
+  return width * nLines * cache->fonts[font].lineHeight;
+}
+
+/////////////////
+//   failure   //
+/////////////////
+static int failure(const char *message)
+{
+  printf("(mglBenchmarkGlyphCache) %s FAILED\n", message);
+  return 1;
+}
+
+/////////////////
+//   getSecs   //
+/////////////////
+static double getSecs(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
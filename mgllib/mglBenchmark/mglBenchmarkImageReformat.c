@@ -0,0 +1,175 @@
+#ifdef documentation
+=========================================================================
+
+     program: mglBenchmarkImageReformat.c
+          by: justin gardner
+        date: 10/19/2026
+   copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+     purpose: standalone test and benchmark of mglImageReformat.h, the
+              tiled conversion that mglPrivateCreateTexture uses to turn
+              Matlab images into rgba bytes. Checks that the output is
+              bit-identical to the column at a time loops that
+              mglPrivateCreateTexture used to have, for grayscale, color
+              and color+alpha images of awkward sizes, on one thread and
+              on many, and then times both. Needs no Matlab, and builds
+              on Linux or Mac with the makefile in this directory.
+       usage: mglBenchmarkImageReformat [width height repeats]
+
+=========================================================================
+#endif
+
+/////////////////////////
+//   include section   //
+/////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <math.h>
+#include "../mglImageReformat.h"
+
+////////////////////////
+//   define section   //
+////////////////////////
+#define BYTEDEPTH 4
+
+///////////////////////////////
+//   function declarations   //
+///////////////////////////////
+static void oldReformat(const double *imageData, int imageHeight, int imageWidth, int imageType, uint8_t *imageFormatted);
+static void makeImage(double *image, size_t n, unsigned int seed);
+static double getSecs(void);
+
+//////////////
+//   main   //
+//////////////
+int main(int argc, char *argv[])
+{
+  int width = (argc > 1) ? atoi(argv[1]) : 1920;
+  int height = (argc > 2) ? atoi(argv[2]) : 1080;
+  int repeats = (argc > 3) ? atoi(argv[3]) : 20;
+  int failed = 0;
+  int types[] = {1, 3, 4};
+  const char *typeNames[] = {"grayscale", "color", "color+alpha"};
+
+#if defined(__AVX__)
+  printf("(mglBenchmarkImageReformat) Using SSE2 with AVX loads\n");
+#elif defined(__SSE2__)
+  printf("(mglBenchmarkImageReformat) Using SSE2\n");
+#elif defined(__ARM_NEON)
+  printf("(mglBenchmarkImageReformat) Using NEON\n");
+#else
+  printf("(mglBenchmarkImageReformat) Using scalar fallback\n");
+#endif
+
+  // check bit-identical output for sizes that are and are not multiples of tiles and vectors
+  int sizes[][2] = {{1, 1}, {3, 1}, {1, 7}, {5, 3}, {64, 64}, {65, 63}, {130, 67}, {257, 129}, {1001, 1001}};
+  int nSizes = sizeof(sizes) / sizeof(sizes[0]);
+  for (int iType = 0; iType < 3; iType++) {
+    for (int iSize = 0; iSize < nSizes; iSize++) {
+      int w = sizes[iSize][0], h = sizes[iSize][1];
+      size_t n = (size_t)w * h;
+      double *image = (double *)malloc(n * types[iType] * sizeof(double));
+      uint8_t *expected = (uint8_t *)malloc(n * BYTEDEPTH);
+      uint8_t *output = (uint8_t *)malloc(n * BYTEDEPTH);
+      makeImage(image, n * types[iType], iSize);
+      oldReformat(image, h, w, types[iType], expected);
+      for (int nThreads = 1; nThreads <= 8; nThreads += 7) {
+        memset(output, 0xAB, n * BYTEDEPTH);
+        mglImageReformat(image, h, w, types[iType], output, nThreads);
+        if (memcmp(output, expected, n * BYTEDEPTH)) {
+          printf("(mglBenchmarkImageReformat) %s %ix%i on %i threads does not match FAILED\n", typeNames[iType], w, h, nThreads);
+          failed = 1;
+        }
+      }
+      free(image);
+      free(expected);
+      free(output);
+    }
+  }
+  if (!failed) printf("(mglBenchmarkImageReformat) Output is bit-identical for %i sizes of each type OK\n", nSizes);
+
+  // time the old loops against the tiled version on one thread and on all
+  size_t n = (size_t)width * height;
+  double *image = (double *)malloc(n * 4 * sizeof(double));
+  uint8_t *output = (uint8_t *)malloc(n * BYTEDEPTH);
+  makeImage(image, n * 4, 1);
+  for (int iType = 0; iType < 3; iType++) {
+    double oldTime = 0, oneThreadTime = 0, allThreadsTime = 0;
+    int nThreads = 0;
+    for (int iRepeat = 0; iRepeat < repeats; iRepeat++) {
+      double startTime = getSecs();
+      oldReformat(image, height, width, types[iType], output);
+      oldTime += getSecs() - startTime;
+      startTime = getSecs();
+      mglImageReformat(image, height, width, types[iType], output, 1);
+      oneThreadTime += getSecs() - startTime;
+      startTime = getSecs();
+      nThreads = mglImageReformat(image, height, width, types[iType], output, 0);
+      allThreadsTime += getSecs() - startTime;
+    }
+    printf("(mglBenchmarkImageReformat) %s %ix%i: %0.2f ms before, %0.2f ms tiled (%0.1fx), %0.2f ms on %i threads (%0.1fx)\n",
+           typeNames[iType], width, height, 1000 * oldTime / repeats, 1000 * oneThreadTime / repeats, oldTime / oneThreadTime,
+           1000 * allThreadsTime / repeats, nThreads, oldTime / allThreadsTime);
+  }
+  free(image);
+  free(output);
+  return failed;
+}
+
+/////////////////////
+//   oldReformat   //
+/////////////////////
+// The loops that mglPrivateCreateTexture used, for reference, with the (GLubyte) cast as it compiled on Intel.
+static void oldReformat(const double *imageData, int imageHeight, int imageWidth, int imageType, uint8_t *imageFormatted)
+{
+  int i, j;
+  int widthDepth = imageWidth*BYTEDEPTH;
+  int c = 0;
+  int imageSize = imageWidth*imageHeight;
+  for (j = 0; j < imageWidth; j++, c+=BYTEDEPTH) {
+    int colStart = j*imageHeight;
+    for (i = 0; i < imageHeight; i++) {
+      int ind = i + colStart;
+      int outind = i*widthDepth;
+      if (imageType == 1) {
+        imageFormatted[c+outind] = (uint8_t)(int32_t)imageData[ind];
+        imageFormatted[c+outind+1] = (uint8_t)(int32_t)imageData[ind];
+        imageFormatted[c+outind+2] = (uint8_t)(int32_t)imageData[ind];
+        imageFormatted[c+outind+3] = (uint8_t)255;
+      }
+      else {
+        imageFormatted[c+outind] = (uint8_t)(int32_t)imageData[ind];
+        imageFormatted[c+outind+1] = (uint8_t)(int32_t)imageData[ind+imageSize];
+        imageFormatted[c+outind+2] = (uint8_t)(int32_t)imageData[ind+2*imageSize];
+        imageFormatted[c+outind+3] = (imageType == 4) ? (uint8_t)(int32_t)imageData[ind+3*imageSize] : (uint8_t)255;
+      }
+    }
+  }
+}
+
+///////////////////
+//   makeImage   //
+///////////////////
+// Values from 0 to 255 with fractions, and exact integers and values just below them, where truncation matters.
+static void makeImage(double *image, size_t n, unsigned int seed)
+{
+  srand(seed);
+  for (size_t i = 0; i < n; i++) {
+    switch (i % 4) {
+      case 0: image[i] = 256.0 * rand() / ((double)RAND_MAX + 1); break;
+      case 1: image[i] = (double)(rand() % 256); break;
+      case 2: image[i] = nextafter((double)(rand() % 256 + 1), 0); break;
+      default: image[i] = 255.0 * (i % 1000) / 999; break;
+    }
+  }
+}
+
+/////////////////
+//   getSecs   //
+/////////////////
+static double getSecs(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
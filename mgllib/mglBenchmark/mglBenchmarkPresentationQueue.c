@@ -0,0 +1,413 @@
+#ifdef documentation
+=========================================================================
+
+     program: mglBenchmarkPresentationQueue.c
+          by: justin gardner
+        date: 10/19/2026
+   copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+     purpose: standalone test and benchmark of mglPresentationQueue.h,
+              which decides which frame scheduled with
+              mglMetalScheduleFrame to present on each display tick.
+              Runs the queue on a simulated display with a little
+              jitter, and checks that frames scheduled out of order go
+              up on the tick for their target time, that a missed tick
+              makes frames late without skipping any, that a frame that
+              can not be presented is counted as missed, that presented
+              times from another thread are kept, that the refresh
+              period follows a change of frame rate and that a full
+              queue refuses frames. Then schedules frames at frameRate
+              on a display at displayRate and reports how many went up
+              on time, and how long a tick takes. Needs no Matlab, and
+              builds on Linux or Mac with the makefile in this
+              directory.
+       usage: mglBenchmarkPresentationQueue [displayRate frameRate frames]
+
+=========================================================================
+#endif
+
+/////////////////////////
+//   include section   //
+/////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#include "../../metal/mglMetal/mglPresentationQueue.h"
+
+///////////////////////////////
+//   function declarations   //
+///////////////////////////////
+static int checkOnTime(void);
+static int checkLate(void);
+static int checkMissed(void);
+static int checkPresentedFromThread(void);
+static int checkRefreshPeriod(void);
+static int checkFull(void);
+static void *presentedThread(void *arg);
+static void simulatedVsyncTimes(double *ticks, double startTime, uint32_t count, double period);
+static double getSecs(void);
+
+////////////////////////
+//   define section   //
+////////////////////////
+#define PERIOD (1.0 / 60.0)
+#define START_TIME 100.0
+#define MAX_TICKS 64
+
+// frame numbers for the presented thread to fill in
+typedef struct presentedThreadArgs {
+  mglPresentationQueueState *queue;
+  uint32_t frameNumbers[MAX_TICKS];
+  double presentedTimes[MAX_TICKS];
+  uint32_t count;
+} presentedThreadArgs;
+
+//////////////
+//   main   //
+//////////////
+int main(int argc, char *argv[])
+{
+  double displayRate = (argc > 1) ? atof(argv[1]) : 60;
+  double frameRate = (argc > 2) ? atof(argv[2]) : 60;
+  uint32_t frames = (argc > 3) ? atoi(argv[3]) : 100000;
+  int failed = 0;
+
+  srand(1);
+  failed |= checkOnTime();
+  failed |= checkLate();
+  failed |= checkMissed();
+  failed |= checkPresentedFromThread();
+  failed |= checkRefreshPeriod();
+  failed |= checkFull();
+  if (!failed) printf("(mglBenchmarkPresentationQueue) Frames go up on time, late and missed frames are counted, OK\n");
+
+  // frames at frameRate on a display at displayRate, scheduled a few at a time as mglMetalScheduleFrame would
+  if ((displayRate <= 0) || (frameRate <= 0) || (frames < 1)) {
+    printf("(mglBenchmarkPresentationQueue) usage: mglBenchmarkPresentationQueue [displayRate frameRate frames]\n");
+    return 1;
+  }
+  mglPresentationQueueState queue;
+  mglPresentationQueueCreate(&queue, 1.0 / displayRate);
+  uint32_t scheduled = 0, presented = 0, onTime = 0, ticks = 0;
+  mglScheduledFrameRecord records[MGL_PRESENTATION_QUEUE_MAX_PENDING];
+  double tickSecs = 0;
+  while (presented < frames) {
+    while ((scheduled < frames) && (queue.pendingCount < 8)) {
+      mglPresentationQueueEnqueue(&queue, scheduled, START_TIME + 0.1 + scheduled / frameRate);
+      scheduled++;
+    }
+    double tickTime = START_TIME + ticks++ / displayRate + 0.0002 * (2.0 * rand() / RAND_MAX - 1);
+    int64_t frame;
+    uint32_t frameNumber;
+    double startTime = getSecs();
+    int due = mglPresentationQueueTick(&queue, tickTime, &frame, &frameNumber);
+    tickSecs += getSecs() - startTime;
+    if (due) {
+      uint32_t count = mglPresentationQueueTakeRecords(&queue, records, MGL_PRESENTATION_QUEUE_MAX_PENDING);
+      for (uint32_t i = 0; i < count; i++) onTime += (records[i].framesLate == 0);
+      presented += count;
+    }
+  }
+  printf("(mglBenchmarkPresentationQueue) %u frames at %0.1f Hz on a %0.1f Hz display: %u on time, %u late over %u ticks, %.1f ns a tick\n",
+         frames, frameRate, displayRate, onTime, presented - onTime, ticks, 1e9 * tickSecs / ticks);
+  mglPresentationQueueDestroy(&queue);
+  return failed;
+}
+
+/////////////////////
+//   checkOnTime   //
+/////////////////////
+static int checkOnTime(void)
+{
+  double ticks[30];
+  simulatedVsyncTimes(ticks, START_TIME, 30, PERIOD);
+  mglPresentationQueueState queue;
+  mglPresentationQueueCreate(&queue, PERIOD);
+  int failed = 0;
+
+  // schedule 10 frames for ticks 10-19, out of order
+  int64_t order[10] = {4, 0, 1, 2, 3, 9, 5, 6, 7, 8};
+  for (int i = 0; i < 10; i++) {
+    mglPresentationQueueEnqueue(&queue, order[i], START_TIME + (order[i] + 10) * PERIOD);
+  }
+  if (queue.pendingCount != 10) {
+    printf("(mglBenchmarkPresentationQueue) %u frames pending, expected 10 FAILED\n", queue.pendingCount);
+    failed = 1;
+  }
+
+  // each frame should go up on the tick for its target time, in order
+  for (int tick = 0; tick < 30; tick++) {
+    int64_t frame;
+    uint32_t frameNumber;
+    if (mglPresentationQueueTick(&queue, ticks[tick], &frame, &frameNumber) && (frame + 10 != tick)) {
+      printf("(mglBenchmarkPresentationQueue) Frame %lld went up on tick %d, expected %lld FAILED\n", (long long)frame, tick, (long long)frame + 10);
+      failed = 1;
+    }
+  }
+  if (queue.pendingCount != 0) {
+    printf("(mglBenchmarkPresentationQueue) %u frames still pending FAILED\n", queue.pendingCount);
+    failed = 1;
+  }
+  if (fabs(queue.refreshPeriod - PERIOD) > 0.0005) {
+    printf("(mglBenchmarkPresentationQueue) Refresh period is %f, expected %f FAILED\n", queue.refreshPeriod, PERIOD);
+    failed = 1;
+  }
+
+  // all of them on time, and taken only once
+  mglScheduledFrameRecord records[MAX_TICKS];
+  uint32_t count = mglPresentationQueueTakeRecords(&queue, records, MAX_TICKS);
+  uint32_t onTime = 0;
+  for (uint32_t i = 0; i < count; i++) onTime += (records[i].framesLate == 0) && !records[i].missed;
+  if ((count != 10) || (onTime != 10) || (mglPresentationQueueTakeRecords(&queue, records, MAX_TICKS) != 0)) {
+    printf("(mglBenchmarkPresentationQueue) %u records with %u on time, expected 10 on time FAILED\n", count, onTime);
+    failed = 1;
+  }
+  mglPresentationQueueDestroy(&queue);
+  return failed;
+}
+
+///////////////////
+//   checkLate   //
+///////////////////
+static int checkLate(void)
+{
+  double ticks[30];
+  simulatedVsyncTimes(ticks, START_TIME, 30, PERIOD);
+  mglPresentationQueueState queue;
+  mglPresentationQueueCreate(&queue, PERIOD);
+  int failed = 0;
+
+  // frames 0-4 for ticks 10-14, and frame 5 for the same time as frame 4
+  for (int frame = 0; frame < 5; frame++) {
+    if (mglPresentationQueueEnqueue(&queue, frame, START_TIME + (frame + 10) * PERIOD) != (uint32_t)frame + 1) {
+      printf("(mglBenchmarkPresentationQueue) Frame %d did not get frame number %d FAILED\n", frame, frame + 1);
+      failed = 1;
+    }
+  }
+  mglPresentationQueueEnqueue(&queue, 5, START_TIME + 14 * PERIOD);
+
+  // miss tick 11, as if the renderer was busy
+  for (int tick = 0; tick < 30; tick++) {
+    int64_t frame;
+    uint32_t frameNumber;
+    if ((tick != 11) && mglPresentationQueueTick(&queue, ticks[tick], &frame, &frameNumber)) {
+      mglPresentationQueuePresented(&queue, frameNumber, ticks[tick] + 0.001);
+    }
+  }
+
+  // frames are never skipped, so frame 1 goes up a tick late and pushes the ones after it back
+  // a tick, and frame 5 also has to wait a tick behind frame 4
+  mglScheduledFrameRecord records[MAX_TICKS];
+  uint32_t count = mglPresentationQueueTakeRecords(&queue, records, MAX_TICKS);
+  int32_t expectedLate[6] = {0, 1, 1, 1, 1, 2};
+  if (count != 6) {
+    printf("(mglBenchmarkPresentationQueue) %u late records, expected 6 FAILED\n", count);
+    failed = 1;
+  }
+  for (uint32_t i = 0; (i < count) && (i < 6); i++) {
+    if ((records[i].frameNumber != i + 1) || (records[i].framesLate != expectedLate[i]) || (records[i].presentedTime != records[i].tickTime + 0.001) || records[i].missed) {
+      printf("(mglBenchmarkPresentationQueue) Record %u is frame %u, %d late, expected frame %u, %d late FAILED\n", i, records[i].frameNumber, records[i].framesLate, i + 1, expectedLate[i]);
+      failed = 1;
+    }
+  }
+  mglPresentationQueueDestroy(&queue);
+  return failed;
+}
+
+/////////////////////
+//   checkMissed   //
+/////////////////////
+// A frame that was due but could not be presented (no drawable, say) is counted as missed, not dropped.
+static int checkMissed(void)
+{
+  double ticks[20];
+  simulatedVsyncTimes(ticks, START_TIME, 20, PERIOD);
+  mglPresentationQueueState queue;
+  mglPresentationQueueCreate(&queue, PERIOD);
+  int failed = 0;
+
+  for (int frame = 0; frame < 3; frame++) {
+    mglPresentationQueueEnqueue(&queue, frame, START_TIME + (frame + 5) * PERIOD);
+  }
+  for (int tick = 0; tick < 20; tick++) {
+    int64_t frame;
+    uint32_t frameNumber;
+    if (!mglPresentationQueueTick(&queue, ticks[tick], &frame, &frameNumber)) continue;
+    if (frame == 1) {
+      mglPresentationQueueMissed(&queue, frameNumber);
+    } else {
+      mglPresentationQueuePresented(&queue, frameNumber, ticks[tick] + 0.001);
+    }
+  }
+
+  // the missed frame still has its tick, so the one after it is on time
+  mglScheduledFrameRecord records[MAX_TICKS];
+  uint32_t count = mglPresentationQueueTakeRecords(&queue, records, MAX_TICKS);
+  uint32_t expectedMissed[3] = {0, 1, 0};
+  if (count != 3) {
+    printf("(mglBenchmarkPresentationQueue) %u records with a missed frame, expected 3 FAILED\n", count);
+    failed = 1;
+  }
+  for (uint32_t i = 0; (i < count) && (i < 3); i++) {
+    if ((records[i].missed != expectedMissed[i]) || (records[i].framesLate != 0) || ((records[i].presentedTime == 0) != expectedMissed[i])) {
+      printf("(mglBenchmarkPresentationQueue) Frame %u missed is %u, expected %u FAILED\n", records[i].frameNumber, records[i].missed, expectedMissed[i]);
+      failed = 1;
+    }
+  }
+  mglPresentationQueueDestroy(&queue);
+  return failed;
+}
+
+//////////////////////////////////
+//   checkPresentedFromThread   //
+//////////////////////////////////
+// The system reports presented times on other threads, while the renderer ticks and the client takes records.
+static int checkPresentedFromThread(void)
+{
+  double ticks[MAX_TICKS];
+  simulatedVsyncTimes(ticks, START_TIME, MAX_TICKS, PERIOD);
+  mglPresentationQueueState queue;
+  mglPresentationQueueCreate(&queue, PERIOD);
+  presentedThreadArgs args = {&queue, {0}, {0}, 0};
+  int failed = 0;
+
+  for (int frame = 0; frame < MAX_TICKS; frame++) {
+    mglPresentationQueueEnqueue(&queue, frame, ticks[frame]);
+  }
+  for (int tick = 0; tick < MAX_TICKS; tick++) {
+    int64_t frame;
+    if (mglPresentationQueueTick(&queue, ticks[tick], &frame, &args.frameNumbers[args.count])) {
+      args.presentedTimes[args.count++] = ticks[tick] + 0.001;
+    }
+  }
+  pthread_t thread;
+  pthread_create(&thread, NULL, presentedThread, &args);
+
+  // take records while presented times come in, then the rest after
+  mglScheduledFrameRecord records[MAX_TICKS];
+  uint32_t firstCount = mglPresentationQueueTakeRecords(&queue, records, MAX_TICKS / 2);
+  pthread_join(thread, NULL);
+  uint32_t count = firstCount + mglPresentationQueueTakeRecords(&queue, records + firstCount, MAX_TICKS - firstCount);
+  if (count != MAX_TICKS) {
+    printf("(mglBenchmarkPresentationQueue) %u records from %d ticks FAILED\n", count, MAX_TICKS);
+    failed = 1;
+  }
+
+  // records taken first may or may not have their presented time yet, the rest must
+  for (uint32_t i = 0; i < count; i++) {
+    int presentedOK = (records[i].presentedTime == records[i].tickTime + 0.001) || ((i < firstCount) && (records[i].presentedTime == 0));
+    if ((records[i].frameNumber != i + 1) || !presentedOK) {
+      printf("(mglBenchmarkPresentationQueue) Record %u is frame %u presented at %f FAILED\n", i, records[i].frameNumber, records[i].presentedTime);
+      failed = 1;
+      break;
+    }
+  }
+  mglPresentationQueueDestroy(&queue);
+  return failed;
+}
+
+/////////////////////////
+//   presentedThread   //
+/////////////////////////
+static void *presentedThread(void *arg)
+{
+  presentedThreadArgs *args = (presentedThreadArgs *)arg;
+  for (uint32_t i = 0; i < args->count; i++) {
+    mglPresentationQueuePresented(args->queue, args->frameNumbers[i], args->presentedTimes[i]);
+  }
+  return NULL;
+}
+
+////////////////////////////
+//   checkRefreshPeriod   //
+////////////////////////////
+// The refresh period follows the median tick interval, so it ignores a missed tick but follows a new frame rate.
+static int checkRefreshPeriod(void)
+{
+  mglPresentationQueueState queue;
+  mglPresentationQueueCreate(&queue, PERIOD);
+  int failed = 0;
+  int64_t frame;
+  uint32_t frameNumber;
+
+  double tickTime = START_TIME;
+  for (int tick = 0; tick < 20; tick++) {
+    tickTime += (tick == 10) ? 2 * PERIOD : PERIOD;
+    mglPresentationQueueTick(&queue, tickTime, &frame, &frameNumber);
+  }
+  if (fabs(queue.refreshPeriod - PERIOD) > 1e-9) {
+    printf("(mglBenchmarkPresentationQueue) Refresh period is %f after a missed tick, expected %f FAILED\n", queue.refreshPeriod, PERIOD);
+    failed = 1;
+  }
+  for (int tick = 0; tick < 10; tick++) {
+    tickTime += PERIOD / 2;
+    mglPresentationQueueTick(&queue, tickTime, &frame, &frameNumber);
+  }
+  if (fabs(queue.refreshPeriod - PERIOD / 2) > 1e-9) {
+    printf("(mglBenchmarkPresentationQueue) Refresh period is %f at twice the frame rate, expected %f FAILED\n", queue.refreshPeriod, PERIOD / 2);
+    failed = 1;
+  }
+  mglPresentationQueueDestroy(&queue);
+  return failed;
+}
+
+///////////////////
+//   checkFull   //
+///////////////////
+static int checkFull(void)
+{
+  mglPresentationQueueState queue;
+  mglPresentationQueueCreate(&queue, PERIOD);
+  int failed = 0;
+
+  // frames in reverse order of target time, and one too many
+  for (int frame = 0; frame < MGL_PRESENTATION_QUEUE_MAX_PENDING; frame++) {
+    if (mglPresentationQueueEnqueue(&queue, frame, START_TIME - frame * PERIOD) == 0) {
+      printf("(mglBenchmarkPresentationQueue) Frame %d refused before the queue is full FAILED\n", frame);
+      failed = 1;
+    }
+  }
+  if (mglPresentationQueueEnqueue(&queue, MGL_PRESENTATION_QUEUE_MAX_PENDING, START_TIME) != 0) {
+    printf("(mglBenchmarkPresentationQueue) Full queue took another frame FAILED\n");
+    failed = 1;
+  }
+
+  // removing them gives them back in order of target time
+  int64_t frames[MGL_PRESENTATION_QUEUE_MAX_PENDING];
+  uint32_t count = mglPresentationQueueRemoveAll(&queue, frames);
+  if ((count != MGL_PRESENTATION_QUEUE_MAX_PENDING) || (queue.pendingCount != 0)) {
+    printf("(mglBenchmarkPresentationQueue) Removed %u frames, expected %d FAILED\n", count, MGL_PRESENTATION_QUEUE_MAX_PENDING);
+    failed = 1;
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    if (frames[i] != MGL_PRESENTATION_QUEUE_MAX_PENDING - 1 - (int64_t)i) {
+      printf("(mglBenchmarkPresentationQueue) Removed frame %u is %lld FAILED\n", i, (long long)frames[i]);
+      failed = 1;
+      break;
+    }
+  }
+  mglPresentationQueueDestroy(&queue);
+  return failed;
+}
+
+/////////////////////////////
+//   simulatedVsyncTimes   //
+/////////////////////////////
+// Tick times from a simulated display, with a little jitter, starting at startTime.
+static void simulatedVsyncTimes(double *ticks, double startTime, uint32_t count, double period)
+{
+  for (uint32_t i = 0; i < count; i++) {
+    ticks[i] = startTime + i * period + 0.0002 * (2.0 * rand() / RAND_MAX - 1);
+  }
+}
+
+/////////////////
+//   getSecs   //
+/////////////////
+static double getSecs(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
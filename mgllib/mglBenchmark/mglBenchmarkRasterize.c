@@ -0,0 +1,743 @@
+#ifdef documentation
+=========================================================================
+
+     program: mglBenchmarkRasterize.c
+          by: justin gardner
+        date: 10/19/2026
+   copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+     purpose: standalone test and benchmark of mglRasterize.h, which
+              draws a stream of mglMetal commands on the CPU. Builds
+              streams the way the mgl drawing functions write them, and
+              checks clearing, that triangles that share edges cover
+              every pixel exactly once, coverage of random triangles
+              against a reference, the transform, dots, arcs and
+              wedges, texture sampling and phase, state carried from
+              frame to frame, errors for streams that cannot be drawn,
+              and that frames are the same however many threads draw
+              them. Then times drawing a stack of frames like the ones
+              mglRetinotopyCreateStimulusImage makes, on one thread and
+              on all of them. Needs no Matlab or GPU, and builds with
+              the makefile in this directory on Mac or Linux, with clang
+              or gcc.
+       usage: mglBenchmarkRasterize [width height frames]
+
+=========================================================================
+#endif
+
+/////////////////////////
+//   include section   //
+/////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "../mglRasterize.h"
+
+//////////////////////////////////////////
+//   static variable and type section   //
+//////////////////////////////////////////
+// a stream of commands, as mglSocketWrite would send them
+typedef struct {
+  uint8_t *bytes;
+  size_t count;
+  size_t capacity;
+} streamType;
+
+///////////////////////////////
+//   function declarations   //
+///////////////////////////////
+static void put(streamType *stream, const void *data, size_t numBytes);
+static void putCode(streamType *stream, mglCommandCode commandCode);
+static void putUInt32(streamType *stream, uint32_t value);
+static void putFloats(streamType *stream, const float *values, size_t count);
+static void putClear(streamType *stream, float r, float g, float b);
+static void putXform(streamType *stream, float scaleX, float scaleY, float offsetX, float offsetY);
+static void putTexture(streamType *stream, uint32_t width, uint32_t height, const float *pixels);
+static void putBlt(streamType *stream, uint32_t minMagFilter, uint32_t addressMode, const float *vertices, uint32_t nVertices, float phase, uint32_t textureNumber);
+static float *draw(const streamType *stream, uint32_t width, uint32_t height, int nThreads, uint32_t *frameCount);
+static float *pixel(float *frames, uint32_t width, uint32_t height, uint32_t frame, uint32_t x, uint32_t y, float rgba[4]);
+static int checkClear(void);
+static int checkTiling(void);
+static int checkTriangles(void);
+static int checkXform(void);
+static int checkDots(void);
+static int checkArcs(void);
+static int checkTextures(void);
+static int checkErrors(void);
+static void makeRetinotopyStream(streamType *stream, uint32_t nFrames);
+static double getSecs(void);
+
+//////////////
+//   main   //
+//////////////
+int main(int argc, char *argv[])
+{
+  uint32_t width = (argc > 1) ? atoi(argv[1]) : 800;
+  uint32_t height = (argc > 2) ? atoi(argv[2]) : 600;
+  uint32_t nFrames = (argc > 3) ? atoi(argv[3]) : 169;
+  int failed = 0;
+
+  failed |= checkClear();
+  failed |= checkTiling();
+  failed |= checkTriangles();
+  failed |= checkXform();
+  failed |= checkDots();
+  failed |= checkArcs();
+  failed |= checkTextures();
+  failed |= checkErrors();
+  if (!failed) printf("(mglBenchmarkRasterize) Clearing, triangles, transforms, dots, arcs, textures and errors are checked OK\n");
+
+  if ((width == 0) || (height == 0) || (nFrames == 0)) {
+    printf("(mglBenchmarkRasterize) usage: mglBenchmarkRasterize [width height frames]\n");
+    return 1;
+  }
+
+  // a stack of frames like mglRetinotopyCreateStimulusImage makes, one thread and all of them
+  streamType stream = {NULL, 0, 0};
+  makeRetinotopyStream(&stream, nFrames);
+  mglRasterizer rasterizer;
+  if (!mglRasterizeParse(&rasterizer, stream.bytes, stream.count, width, height)) {
+    printf("(mglBenchmarkRasterize) %s FAILED\n", rasterizer.error);
+    return 1;
+  }
+  size_t imageBytes = mglReadbackImageBytes(width, height, mglReadbackSingle);
+  float *single = (float *)malloc(imageBytes * nFrames);
+  float *parallel = (float *)malloc(imageBytes * nFrames);
+  if ((single == NULL) || (parallel == NULL)) {
+    printf("(mglBenchmarkRasterize) Could not allocate %u %ux%u frames FAILED\n", nFrames, width, height);
+    return 1;
+  }
+  double startSecs = getSecs();
+  mglRasterize(&rasterizer, single, mglReadbackSingle, 1);
+  double singleSecs = getSecs() - startSecs;
+  startSecs = getSecs();
+  int nThreads = mglRasterize(&rasterizer, parallel, mglReadbackSingle, 0);
+  double parallelSecs = getSecs() - startSecs;
+  if (memcmp(single, parallel, imageBytes * nFrames)) {
+    printf("(mglBenchmarkRasterize) Frames drawn on %d threads are different from one thread FAILED\n", nThreads);
+    failed = 1;
+  }
+  printf("(mglBenchmarkRasterize) %u %ux%u frames from a %.1f MB stream\n", nFrames, width, height, stream.count / 1e6);
+  printf("(mglBenchmarkRasterize)   1 thread %8.1f ms (%6.3f ms per frame)  %d threads %8.1f ms  %5.2fx\n",
+         1000 * singleSecs, 1000 * singleSecs / nFrames, nThreads, 1000 * parallelSecs, singleSecs / parallelSecs);
+  mglRasterizeFree(&rasterizer);
+  free(single);
+  free(parallel);
+  free(stream.bytes);
+  return failed;
+}
+
+/////////////
+//   put   //
+/////////////
+static void put(streamType *stream, const void *data, size_t numBytes)
+{
+  if (stream->count + numBytes > stream->capacity) {
+    stream->capacity = 2 * (stream->count + numBytes);
+    stream->bytes = (uint8_t *)realloc(stream->bytes, stream->capacity);
+    if (stream->bytes == NULL) {
+      printf("(mglBenchmarkRasterize) Out of memory for the stream FAILED\n");
+      exit(1);
+    }
+  }
+  memcpy(stream->bytes + stream->count, data, numBytes);
+  stream->count += numBytes;
+}
+
+static void putCode(streamType *stream, mglCommandCode commandCode) {put(stream, &commandCode, sizeof(commandCode));}
+static void putUInt32(streamType *stream, uint32_t value) {put(stream, &value, sizeof(value));}
+static void putFloats(streamType *stream, const float *values, size_t count) {put(stream, values, count * sizeof(float));}
+
+//////////////////
+//   putClear   //
+//////////////////
+// as mglClearScreen writes it
+static void putClear(streamType *stream, float r, float g, float b)
+{
+  float color[3] = {r, g, b};
+  putCode(stream, mglSetClearColor);
+  putFloats(stream, color, 3);
+}
+
+//////////////////
+//   putXform   //
+//////////////////
+// as mglTransform writes it, column major
+static void putXform(streamType *stream, float scaleX, float scaleY, float offsetX, float offsetY)
+{
+  float xform[16] = {scaleX, 0, 0, 0, 0, scaleY, 0, 0, 0, 0, 1, 0, offsetX, offsetY, 0, 1};
+  putCode(stream, mglSetXform);
+  putFloats(stream, xform, 16);
+}
+
+////////////////////
+//   putTexture   //
+////////////////////
+// as mglMetalCreateTexture writes it, rgba rows with the top row first
+static void putTexture(streamType *stream, uint32_t width, uint32_t height, const float *pixels)
+{
+  putCode(stream, mglCreateTexture);
+  putUInt32(stream, width);
+  putUInt32(stream, height);
+  putFloats(stream, pixels, (size_t)width * height * 4);
+}
+
+////////////////
+//   putBlt   //
+////////////////
+// as mglMetalBltTexture writes it, with [xyz uv] vertices
+static void putBlt(streamType *stream, uint32_t minMagFilter, uint32_t addressMode, const float *vertices, uint32_t nVertices, float phase, uint32_t textureNumber)
+{
+  putCode(stream, mglBltTexture);
+  putUInt32(stream, minMagFilter);
+  putUInt32(stream, 0);
+  putUInt32(stream, addressMode);
+  putUInt32(stream, nVertices);
+  putFloats(stream, vertices, 5 * (size_t)nVertices);
+  putFloats(stream, &phase, 1);
+  putUInt32(stream, textureNumber);
+}
+
+//////////////
+//   draw   //
+//////////////
+// Draw all the frames of a stream as single, or return NULL.
+static float *draw(const streamType *stream, uint32_t width, uint32_t height, int nThreads, uint32_t *frameCount)
+{
+  mglRasterizer rasterizer;
+  if (!mglRasterizeParse(&rasterizer, stream->bytes, stream->count, width, height)) {
+    printf("(mglBenchmarkRasterize) %s FAILED\n", rasterizer.error);
+    return NULL;
+  }
+  *frameCount = rasterizer.frameCount;
+  float *frames = (float *)calloc(1, mglReadbackImageBytes(width, height, mglReadbackSingle) * (rasterizer.frameCount ? rasterizer.frameCount : 1));
+  if (frames != NULL) mglRasterize(&rasterizer, frames, mglReadbackSingle, nThreads);
+  mglRasterizeFree(&rasterizer);
+  return frames;
+}
+
+///////////////
+//   pixel   //
+///////////////
+// Get a pixel of a height x width x 4 x frames stack, x and y from the top left.
+static float *pixel(float *frames, uint32_t width, uint32_t height, uint32_t frame, uint32_t x, uint32_t y, float rgba[4])
+{
+  size_t plane = (size_t)width * height;
+  for (int c = 0; c < 4; c++)
+    rgba[c] = frames[4 * plane * frame + c * plane + (size_t)x * height + y];
+  return rgba;
+}
+
+////////////////////
+//   checkClear   //
+////////////////////
+// Frames start gray, take the clear color set before anything is drawn in them, and keep it.
+static int checkClear(void)
+{
+  streamType stream = {NULL, 0, 0};
+  float quad[] = {-1, -1, 0, 1, 0, 0, -1, -0.9f, 0, 1, 0, 0, -0.9f, -1, 0, 1, 0, 0};
+  putCode(&stream, mglFlush);
+  putClear(&stream, 0.25f, 0.5f, 0.75f);
+  putCode(&stream, mglFlush);
+  putCode(&stream, mglQuad);
+  putUInt32(&stream, 3);
+  putFloats(&stream, quad, 18);
+  // too late for this frame, so it is for the next one
+  putClear(&stream, 1, 0, 0);
+  putCode(&stream, mglFlush);
+  putCode(&stream, mglFlush);
+  // not flushed, so not drawn
+  putClear(&stream, 0, 1, 0);
+
+  uint32_t frameCount;
+  float *frames = draw(&stream, 16, 8, 0, &frameCount);
+  free(stream.bytes);
+  if (frames == NULL) return 1;
+  float expected[4][3] = {{0.5f, 0.5f, 0.5f}, {0.25f, 0.5f, 0.75f}, {0.25f, 0.5f, 0.75f}, {1, 0, 0}};
+  int failed = (frameCount != 4);
+  for (uint32_t frame = 0; (frame < frameCount) && !failed; frame++) {
+    float rgba[4];
+    pixel(frames, 16, 8, frame, 8, 3, rgba);
+    if ((rgba[0] != expected[frame][0]) || (rgba[1] != expected[frame][1]) || (rgba[2] != expected[frame][2]) || (rgba[3] != 1))
+      failed = 1;
+  }
+  if (failed) printf("(mglBenchmarkRasterize) Clear colors are wrong in %u frames FAILED\n", frameCount);
+  free(frames);
+  return failed;
+}
+
+/////////////////////
+//   checkTiling   //
+/////////////////////
+// Triangles that tile the screen, on a jittered grid, blending a texture of alpha 0.5 over black,
+// should make every pixel 0.5, which it is not if a pixel on a shared edge is drawn twice or never.
+static int checkTiling(void)
+{
+  const uint32_t width = 97, height = 61, nAcross = 9, nDown = 7;
+  float grid[10][8][2];
+  srand(7);
+  for (uint32_t i = 0; i <= nAcross; i++) {
+    for (uint32_t j = 0; j <= nDown; j++) {
+      // edges of the screen stay put, with some points exactly on pixel centers and edges
+      float jitterX = ((i == 0) || (i == nAcross)) ? 0 : (float)(rand() % 64 - 32) / 400.0f;
+      float jitterY = ((j == 0) || (j == nDown)) ? 0 : (float)(rand() % 64 - 32) / 400.0f;
+      if ((i == 3) && (j > 0) && (j < nDown)) jitterX = 0;
+      grid[i][j][0] = -1 + 2.0f * i / nAcross + jitterX;
+      grid[i][j][1] = -1 + 2.0f * j / nDown + jitterY;
+    }
+  }
+  float texture[4] = {1, 1, 1, 0.5f};
+  streamType stream = {NULL, 0, 0};
+  putClear(&stream, 0, 0, 0);
+  putTexture(&stream, 1, 1, texture);
+  // as triangles, and as a strip of triangles down each column
+  float *vertices = (float *)malloc(6 * 5 * nAcross * nDown * sizeof(float));
+  size_t n = 0;
+  for (uint32_t i = 0; i < nAcross; i++) {
+    for (uint32_t j = 0; j < nDown; j++) {
+      int corners[6][2] = {{0, 0}, {1, 0}, {1, 1}, {0, 0}, {1, 1}, {0, 1}};
+      for (int k = 0; k < 6; k++) {
+        float *vertex = vertices + 5 * n++;
+        vertex[0] = grid[i + corners[k][0]][j + corners[k][1]][0];
+        vertex[1] = grid[i + corners[k][0]][j + corners[k][1]][1];
+        vertex[2] = 0;
+        vertex[3] = vertex[4] = 0.5f;
+      }
+    }
+  }
+  putBlt(&stream, 0, 2, vertices, (uint32_t)n, 0, 1);
+  putCode(&stream, mglFlush);
+  putClear(&stream, 0, 0, 0);
+  for (uint32_t i = 0; i < nAcross; i++) {
+    float strip[2 * 8][6];
+    for (uint32_t j = 0; j <= nDown; j++) {
+      for (int side = 0; side < 2; side++) {
+        float *vertex = strip[2 * j + side];
+        vertex[0] = grid[i + side][j][0];
+        vertex[1] = grid[i + side][j][1];
+        vertex[2] = 0;
+        vertex[3] = 0.5f; vertex[4] = vertex[5] = 0;
+      }
+    }
+    putCode(&stream, mglPolygon);
+    putUInt32(&stream, 2 * (nDown + 1));
+    putFloats(&stream, &strip[0][0], 6 * 2 * (nDown + 1));
+  }
+  putCode(&stream, mglFlush);
+  free(vertices);
+
+  uint32_t frameCount;
+  float *frames = draw(&stream, width, height, 0, &frameCount);
+  free(stream.bytes);
+  if (frames == NULL) return 1;
+  int failed = 0;
+  for (uint32_t frame = 0; frame < frameCount; frame++) {
+    uint32_t wrong = 0;
+    for (uint32_t y = 0; y < height; y++) {
+      for (uint32_t x = 0; x < width; x++) {
+        float rgba[4];
+        pixel(frames, width, height, frame, x, y, rgba);
+        if (rgba[0] != 0.5f) wrong++;
+      }
+    }
+    if (wrong) {
+      printf("(mglBenchmarkRasterize) %u of %u pixels were drawn other than once by %s FAILED\n", wrong, width * height, frame ? "strips" : "triangles");
+      failed = 1;
+    }
+  }
+  free(frames);
+  return failed;
+}
+
+////////////////////////
+//   checkTriangles   //
+////////////////////////
+// Random triangles against a reference that tests each pixel center, away from the edges,
+// drawn on one thread and on several.
+static int checkTriangles(void)
+{
+  const uint32_t width = 64, height = 48, nTriangles = 200;
+  streamType stream = {NULL, 0, 0};
+  float corners[200][3][2];
+  srand(11);
+  for (uint32_t t = 0; t < nTriangles; t++) {
+    float quad[18];
+    putClear(&stream, 0, 0, 0);
+    for (int k = 0; k < 3; k++) {
+      corners[t][k][0] = (float)(rand() % 3000 - 1500) / 1000.0f;
+      corners[t][k][1] = (float)(rand() % 3000 - 1500) / 1000.0f;
+      float vertex[6] = {corners[t][k][0], corners[t][k][1], 0, 1, 1, 1};
+      memcpy(quad + 6 * k, vertex, sizeof(vertex));
+    }
+    putCode(&stream, mglQuad);
+    putUInt32(&stream, 3);
+    putFloats(&stream, quad, 18);
+    putCode(&stream, mglFlush);
+  }
+  // one thread and several, whatever the number of processors, draw the same frames
+  uint32_t frameCount;
+  float *frames = draw(&stream, width, height, 1, &frameCount);
+  float *threaded = draw(&stream, width, height, 5, &frameCount);
+  free(stream.bytes);
+  if ((frames == NULL) || (threaded == NULL)) return 1;
+  int different = memcmp(frames, threaded, mglReadbackImageBytes(width, height, mglReadbackSingle) * frameCount);
+  free(threaded);
+  if (different) {
+    printf("(mglBenchmarkRasterize) Frames drawn on 5 threads are different from 1 thread FAILED\n");
+    free(frames);
+    return 1;
+  }
+
+  uint32_t wrong = 0, checked = 0;
+  for (uint32_t t = 0; t < nTriangles; t++) {
+    double p[3][2];
+    for (int k = 0; k < 3; k++) {
+      p[k][0] = (corners[t][k][0] * 0.5 + 0.5) * width;
+      p[k][1] = (0.5 - corners[t][k][1] * 0.5) * height;
+    }
+    double area = (p[1][0] - p[0][0]) * (p[2][1] - p[0][1]) - (p[1][1] - p[0][1]) * (p[2][0] - p[0][0]);
+    for (uint32_t y = 0; y < height; y++) {
+      for (uint32_t x = 0; x < width; x++) {
+        double cx = x + 0.5, cy = y + 0.5, nearest = INFINITY;
+        int inside = 1;
+        for (int k = 0; k < 3; k++) {
+          const double *a = p[k], *b = p[(k + 1) % 3];
+          double edge = ((b[0] - a[0]) * (cy - a[1]) - (b[1] - a[1]) * (cx - a[0])) * (area > 0 ? 1 : -1);
+          double distance = edge / hypot(b[0] - a[0], b[1] - a[1]);
+          if (distance < 0) inside = 0;
+          if (fabs(distance) < nearest) nearest = fabs(distance);
+        }
+        // too close to an edge to say without knowing about snapping
+        if ((nearest < 0.01) || (area == 0)) continue;
+        float rgba[4];
+        pixel(frames, width, height, t, x, y, rgba);
+        checked++;
+        if ((rgba[0] > 0.5f) != inside) wrong++;
+      }
+    }
+  }
+  if (wrong) printf("(mglBenchmarkRasterize) %u of %u pixels of random triangles are different from the reference FAILED\n", wrong, checked);
+  free(frames);
+  return (wrong != 0);
+}
+
+////////////////////
+//   checkXform   //
+////////////////////
+// A transform set in one frame is kept for the next, and vertices interpolate color.
+static int checkXform(void)
+{
+  const uint32_t width = 40, height = 20;
+  streamType stream = {NULL, 0, 0};
+  // degrees of 20x10 across the screen, with the origin in the middle
+  putXform(&stream, 2.0f / 20, 2.0f / 10, 0, 0);
+  putClear(&stream, 0, 0, 0);
+  putCode(&stream, mglFlush);
+  // a square from 0,0 to 5,5 in degrees, which is 10x10 pixels up and right of the center, red to blue
+  float quad[6][6] = {{0, 0, 0, 1, 0, 0}, {5, 0, 0, 1, 0, 0}, {5, 5, 0, 0, 0, 1}, {0, 0, 0, 1, 0, 0}, {5, 5, 0, 0, 0, 1}, {0, 5, 0, 0, 0, 1}};
+  putCode(&stream, mglQuad);
+  putUInt32(&stream, 6);
+  putFloats(&stream, &quad[0][0], 36);
+  putCode(&stream, mglFlush);
+
+  uint32_t frameCount;
+  float *frames = draw(&stream, width, height, 0, &frameCount);
+  free(stream.bytes);
+  if (frames == NULL) return 1;
+  int failed = (frameCount != 2);
+  for (uint32_t y = 0; (y < height) && !failed; y++) {
+    for (uint32_t x = 0; x < width; x++) {
+      float rgba[4];
+      pixel(frames, width, height, 1, x, y, rgba);
+      int inside = (x >= 20) && (x < 30) && (y < 10);
+      // red at the bottom, blue at the top, at each pixel center
+      float blue = (10 - (y + 0.5f)) / 10;
+      if (inside ? ((fabsf(rgba[2] - blue) > 1e-5f) || (fabsf(rgba[0] + rgba[2] - 1) > 1e-5f)) : (rgba[0] + rgba[2] != 0)) {
+        printf("(mglBenchmarkRasterize) Pixel %u,%u of a transformed square is %f %f %f FAILED\n", x, y, rgba[0], rgba[1], rgba[2]);
+        failed = 1;
+        break;
+      }
+    }
+  }
+  free(frames);
+  return failed;
+}
+
+///////////////////
+//   checkDots   //
+///////////////////
+static int checkDots(void)
+{
+  const uint32_t width = 64, height = 64;
+  streamType stream = {NULL, 0, 0};
+  putClear(&stream, 0, 0, 0);
+  // a 4x6 square dot on a pixel corner, and a round dot of diameter 20 with a half alpha
+  float dots[2][11] = {
+    {-0.5f, 0.5f, 0, 1, 0, 0, 1, 4, 6, 0, 0},
+    {0.5f, -0.5f, 0, 0, 1, 0, 0.5f, 20, 20, 1, 0}
+  };
+  putCode(&stream, mglDots);
+  putUInt32(&stream, 2);
+  putFloats(&stream, &dots[0][0], 22);
+  putCode(&stream, mglFlush);
+
+  uint32_t frameCount;
+  float *frames = draw(&stream, width, height, 0, &frameCount);
+  free(stream.bytes);
+  if (frames == NULL) return 1;
+  uint32_t squarePixels = 0, roundPixels = 0, wrong = 0;
+  for (uint32_t y = 0; y < height; y++) {
+    for (uint32_t x = 0; x < width; x++) {
+      float rgba[4];
+      pixel(frames, width, height, 0, x, y, rgba);
+      if (rgba[0] > 0) {
+        squarePixels++;
+        // the square is centered on pixel corner 16,16
+        if ((rgba[0] != 1) || (x < 14) || (x >= 18) || (y < 13) || (y >= 19)) wrong++;
+      }
+      if (rgba[1] > 0) {
+        roundPixels++;
+        double distance = hypot(x + 0.5 - 48, y + 0.5 - 48);
+        if ((rgba[1] != 0.5f) || (distance > 10)) wrong++;
+      }
+    }
+  }
+  int failed = wrong || (squarePixels != 24) || (fabs(roundPixels - M_PI * 100) > 20);
+  if (failed) printf("(mglBenchmarkRasterize) Dots cover %u and %u pixels (%u wrong) FAILED\n", squarePixels, roundPixels, wrong);
+  free(frames);
+  return failed;
+}
+
+///////////////////
+//   checkArcs   //
+///////////////////
+// A ring, as mglMetalArcs sends it, in degrees with a transform, and a quarter wedge.
+static int checkArcs(void)
+{
+  const uint32_t width = 80, height = 60;
+  streamType stream = {NULL, 0, 0};
+  // 1 pixel per degree, origin in the middle
+  putXform(&stream, 2.0f / width, 2.0f / height, 0, 0);
+  putClear(&stream, 0, 0, 0);
+  // [xyz rgba radii(innerX outerX innerY outerY) wedge(start sweep) border]
+  float arcs[2][14] = {
+    {-15, 0, 0, 1, 0, 0, 1, 5, 12, 5, 12, 0, 2 * (float)M_PI, 0},
+    {20, 10, 0, 0, 1, 0, 1, 0, 8, 0, 8, 0, (float)M_PI / 2, 0}
+  };
+  putCode(&stream, mglArcs);
+  putUInt32(&stream, 2);
+  putFloats(&stream, &arcs[0][0], 28);
+  putCode(&stream, mglFlush);
+
+  uint32_t frameCount;
+  float *frames = draw(&stream, width, height, 0, &frameCount);
+  free(stream.bytes);
+  if (frames == NULL) return 1;
+  uint32_t wrong = 0, ringPixels = 0, wedgePixels = 0;
+  for (uint32_t y = 0; y < height; y++) {
+    for (uint32_t x = 0; x < width; x++) {
+      float rgba[4];
+      pixel(frames, width, height, 0, x, y, rgba);
+      // in pixels from the center of each, with y up
+      double ringX = x + 0.5 - 25, ringY = 30 - (y + 0.5);
+      double ringDistance = hypot(ringX, ringY);
+      double wedgeX = x + 0.5 - 60, wedgeY = 20 - (y + 0.5);
+      double wedgeDistance = hypot(wedgeX, wedgeY);
+      int inRing = (ringDistance > 5.05) && (ringDistance < 11.95);
+      int outOfRing = (ringDistance < 4.95) || (ringDistance > 12.05);
+      // the quarter from 0 to 90 degrees is up and to the right
+      int inWedge = (wedgeDistance < 7.95) && (wedgeX > 0.05) && (wedgeY > 0.05);
+      int outOfWedge = (wedgeDistance > 8.05) || (wedgeX < -0.05) || (wedgeY < -0.05);
+      ringPixels += (rgba[0] > 0);
+      wedgePixels += (rgba[1] > 0);
+      if ((inRing && (rgba[0] != 1)) || (outOfRing && (rgba[0] != 0))) wrong++;
+      if ((inWedge && (rgba[1] != 1)) || (outOfWedge && (rgba[1] != 0))) wrong++;
+    }
+  }
+  int failed = wrong || (fabs(ringPixels - M_PI * (144 - 25)) > 30) || (fabs(wedgePixels - M_PI * 64 / 4) > 12);
+  if (failed) printf("(mglBenchmarkRasterize) Ring covers %u pixels and wedge %u (%u wrong) FAILED\n", ringPixels, wedgePixels, wrong);
+  free(frames);
+  return failed;
+}
+
+///////////////////////
+//   checkTextures   //
+///////////////////////
+// Nearest and linear sampling, address modes, and phase, which moves the color but not the alpha.
+static int checkTextures(void)
+{
+  const uint32_t width = 8, height = 4;
+  // 4x2 texture, red going across, green going down, alpha on the left half only
+  float texture[2][4][4];
+  for (int y = 0; y < 2; y++)
+    for (int x = 0; x < 4; x++) {
+      texture[y][x][0] = x / 4.0f;
+      texture[y][x][1] = y;
+      texture[y][x][2] = 0;
+      texture[y][x][3] = (x < 2) ? 1 : 0;
+    }
+  // the whole screen, with uv going from 0,0 at the top left to 1,1
+  float screen[6][5] = {{-1, 1, 0, 0, 0}, {1, 1, 0, 1, 0}, {1, -1, 0, 1, 1}, {-1, 1, 0, 0, 0}, {1, -1, 0, 1, 1}, {-1, -1, 0, 0, 1}};
+  streamType stream = {NULL, 0, 0};
+  putTexture(&stream, 4, 2, &texture[0][0][0]);
+  putClear(&stream, 0, 0, 0);
+  putBlt(&stream, 0, 2, &screen[0][0], 6, 0, 1);
+  putCode(&stream, mglFlush);
+  putClear(&stream, 0, 0, 0);
+  putBlt(&stream, 0, 2, &screen[0][0], 6, 0.5f, 1);
+  putCode(&stream, mglFlush);
+  putClear(&stream, 0, 0, 0);
+  putBlt(&stream, 1, 0, &screen[0][0], 6, 0, 1);
+  putCode(&stream, mglFlush);
+
+  uint32_t frameCount;
+  float *frames = draw(&stream, width, height, 0, &frameCount);
+  free(stream.bytes);
+  if (frames == NULL) return 1;
+  uint32_t wrong = 0;
+  for (uint32_t y = 0; y < height; y++) {
+    for (uint32_t x = 0; x < width; x++) {
+      float rgba[4];
+      // each texel is 2x2 pixels, and blends over black with its own alpha
+      uint32_t texelX = x / 2, texelY = y / 2;
+      float alpha = (texelX < 2) ? 1 : 0;
+      pixel(frames, width, height, 0, x, y, rgba);
+      if ((rgba[0] != alpha * texelX / 4.0f) || (rgba[1] != alpha * texelY) || (rgba[3] != alpha * alpha + 1 - alpha)) wrong++;
+      // half a texture over, the color comes from 2 texels right and a texel down (wrapping), the alpha does not
+      pixel(frames, width, height, 1, x, y, rgba);
+      if ((rgba[0] != alpha * ((texelX + 2) % 4) / 4.0f) || (rgba[1] != alpha * ((texelY + 1) % 2))) wrong++;
+      // linear with clamp to edge, red goes across evenly between texel centers
+      pixel(frames, width, height, 2, x, y, rgba);
+      float u = (x + 0.5f) / width * 4 - 0.5f;
+      u = (u < 0) ? 0 : ((u > 3) ? 3 : u);
+      float expectedAlpha = (u <= 1) ? 1 : ((u >= 2) ? 0 : 2 - u);
+      if ((fabsf(rgba[0] - expectedAlpha * u / 4.0f) > 1e-6f)) wrong++;
+    }
+  }
+  if (wrong) printf("(mglBenchmarkRasterize) %u texture pixels are wrong FAILED\n", wrong);
+  free(frames);
+  return (wrong != 0);
+}
+
+/////////////////////
+//   checkErrors   //
+/////////////////////
+// Streams that cannot be drawn say why, and draw nothing.
+static int checkErrors(void)
+{
+  int failed = 0;
+  mglRasterizer rasterizer;
+  float vertex[6] = {0};
+
+  // a command that is not drawn on the CPU
+  streamType stream = {NULL, 0, 0};
+  putCode(&stream, mglFlush);
+  putCode(&stream, mglSelectStencil);
+  putUInt32(&stream, 1);
+  if (mglRasterizeParse(&rasterizer, stream.bytes, stream.count, 8, 8) || !strstr(rasterizer.error, "mglSelectStencil at byte 2")) {
+    printf("(mglBenchmarkRasterize) A stencil was not refused (%s) FAILED\n", rasterizer.error);
+    failed = 1;
+  }
+
+  // vertices cut off at every length
+  stream.count = 0;
+  putCode(&stream, mglPolygon);
+  putUInt32(&stream, 2);
+  putFloats(&stream, vertex, 6);
+  putFloats(&stream, vertex, 6);
+  for (size_t count = 1; count < stream.count; count++) {
+    if (mglRasterizeParse(&rasterizer, stream.bytes, count, 8, 8) || !strstr(rasterizer.error, "Stream ends in")) {
+      printf("(mglBenchmarkRasterize) A stream cut off at %zu bytes was not refused (%s) FAILED\n", count, rasterizer.error);
+      failed = 1;
+      break;
+    }
+  }
+
+  // a texture that was never made, or was deleted, and one that would be too big
+  float pixels[4] = {1, 1, 1, 1};
+  stream.count = 0;
+  putBlt(&stream, 0, 0, vertex, 1, 0, 1);
+  if (mglRasterizeParse(&rasterizer, stream.bytes, stream.count, 8, 8) || !strstr(rasterizer.error, "texture 1")) {
+    printf("(mglBenchmarkRasterize) A missing texture was not refused (%s) FAILED\n", rasterizer.error);
+    failed = 1;
+  }
+  stream.count = 0;
+  putTexture(&stream, 1, 1, pixels);
+  putCode(&stream, mglDeleteTexture);
+  putUInt32(&stream, 1);
+  putBlt(&stream, 0, 0, vertex, 1, 0, 1);
+  if (mglRasterizeParse(&rasterizer, stream.bytes, stream.count, 8, 8) || !strstr(rasterizer.error, "texture 1")) {
+    printf("(mglBenchmarkRasterize) A deleted texture was not refused (%s) FAILED\n", rasterizer.error);
+    failed = 1;
+  }
+  stream.count = 0;
+  putCode(&stream, mglCreateTexture);
+  putUInt32(&stream, 0xFFFFFFFF);
+  putUInt32(&stream, 0xFFFFFFFF);
+  if (mglRasterizeParse(&rasterizer, stream.bytes, stream.count, 8, 8) || !strstr(rasterizer.error, "mglCreateTexture")) {
+    printf("(mglBenchmarkRasterize) An impossible texture was not refused (%s) FAILED\n", rasterizer.error);
+    failed = 1;
+  }
+  free(stream.bytes);
+  return failed;
+}
+
+//////////////////////////////
+//   makeRetinotopyStream   //
+//////////////////////////////
+// Frames like mglRetinotopyCreateStimulusImage draws: a gray screen with a white disc, then a
+// gray polygon masking all but a rotating wedge, and a strip of checks, with some dots on top.
+static void makeRetinotopyStream(streamType *stream, uint32_t nFrames)
+{
+  putXform(stream, 2.0f / 40, 2.0f / 30, 0, 0);
+  float disc[14] = {0, 0, 0, 1, 1, 1, 1, 0, 14, 0, 14, 0, 2 * (float)M_PI, 0};
+  for (uint32_t frame = 0; frame < nFrames; frame++) {
+    putClear(stream, 0.5f, 0.5f, 0.5f);
+    putCode(stream, mglArcs);
+    putUInt32(stream, 1);
+    putFloats(stream, disc, 14);
+
+    // a fan from the center around everything but a 45 degree wedge, as a strip back and forth to the center
+    float angle = 2 * (float)M_PI * frame / 24;
+    uint32_t nSteps = 64;
+    putCode(stream, mglPolygon);
+    putUInt32(stream, 2 * nSteps);
+    for (uint32_t step = 0; step < nSteps; step++) {
+      float stepAngle = angle + (float)M_PI / 4 + (2 * (float)M_PI - (float)M_PI / 4) * step / (nSteps - 1);
+      float center[6] = {0, 0, 0, 0.5f, 0.5f, 0.5f};
+      float edge[6] = {20 * cosf(stepAngle), 20 * sinf(stepAngle), 0, 0.5f, 0.5f, 0.5f};
+      putFloats(stream, center, 6);
+      putFloats(stream, edge, 6);
+    }
+
+    // a strip of black and white checks
+    putCode(stream, mglQuad);
+    putUInt32(stream, 6 * 40);
+    for (uint32_t check = 0; check < 40; check++) {
+      float x0 = -20 + check, x1 = x0 + 1, c = (float)((check + frame) % 2);
+      float quad[6][6] = {{x0, -15, 0, c, c, c}, {x1, -15, 0, c, c, c}, {x1, -13, 0, c, c, c},
+                          {x0, -15, 0, c, c, c}, {x1, -13, 0, c, c, c}, {x0, -13, 0, c, c, c}};
+      putFloats(stream, &quad[0][0], 36);
+    }
+
+    // some round dots
+    putCode(stream, mglDots);
+    putUInt32(stream, 100);
+    for (uint32_t dot = 0; dot < 100; dot++) {
+      float values[11] = {-18 + (float)((dot * 37 + frame) % 36), -10 + (float)((dot * 11) % 20), 0, 1, 0, 0, 1, 6, 6, 1, 1};
+      putFloats(stream, values, 11);
+    }
+    putCode(stream, mglFlush);
+  }
+}
+
+/////////////////
+//   getSecs   //
+/////////////////
+static double getSecs(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
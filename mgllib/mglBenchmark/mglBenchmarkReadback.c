@@ -0,0 +1,240 @@
+#ifdef documentation
+=========================================================================
+
+     program: mglBenchmarkReadback.c
+          by: justin gardner
+        date: 10/19/2026
+   copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+     purpose: standalone test and benchmark of mglReadback.h, which
+              converts rendered RGBA32Float rows, as the GPU copies
+              them out of a texture, into the height x width x 4 image
+              that mglMetalReadbackCollect returns. Checks the image
+              against a pixel by pixel reference for sizes that are and
+              are not whole tiles, with padding at the end of each row,
+              as single and as uint8, checks rounding and clamping to
+              uint8 and regions of interest. Then times converting a
+              frame against a plain pixel by pixel loop, and reports
+              how many bytes each format sends. Needs no Matlab, and
+              builds on Linux or Mac with the makefile in this
+              directory.
+       usage: mglBenchmarkReadback [width height repeats]
+
+=========================================================================
+#endif
+
+/////////////////////////
+//   include section   //
+/////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "../../metal/mglMetal/mglReadback.h"
+
+///////////////////////////////
+//   function declarations   //
+///////////////////////////////
+static int checkImage(uint32_t width, uint32_t height, uint32_t format);
+static int checkUInt8(void);
+static int checkRegions(void);
+static float *makeRows(uint32_t width, uint32_t height, size_t bytesPerRow);
+static void referenceImage(const float *rows, size_t bytesPerRow, uint32_t width, uint32_t height, uint32_t format, void *image);
+static double timeConvert(const float *rows, size_t bytesPerRow, uint32_t width, uint32_t height, uint32_t format, void *image, int repeats, int reference);
+static double getSecs(void);
+
+//////////////
+//   main   //
+//////////////
+int main(int argc, char *argv[])
+{
+  uint32_t width = (argc > 1) ? atoi(argv[1]) : 1920;
+  uint32_t height = (argc > 2) ? atoi(argv[2]) : 1080;
+  int repeats = (argc > 3) ? atoi(argv[3]) : 20;
+  int failed = 0;
+
+  // images of sizes that are whole tiles, are not, and are smaller than one
+  uint32_t sizes[][2] = {{1, 1}, {3, 5}, {32, 32}, {64, 31}, {33, 97}, {200, 150}};
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    failed |= checkImage(sizes[i][0], sizes[i][1], mglReadbackSingle);
+    failed |= checkImage(sizes[i][0], sizes[i][1], mglReadbackUInt8);
+  }
+  failed |= checkUInt8();
+  failed |= checkRegions();
+  if (!failed) printf("(mglBenchmarkReadback) Images match the reference as single and uint8, regions are checked OK\n");
+
+  // a frame, converted tile by tile and pixel by pixel
+  if ((width == 0) || (height == 0) || (repeats < 1)) {
+    printf("(mglBenchmarkReadback) usage: mglBenchmarkReadback [width height repeats]\n");
+    return 1;
+  }
+  size_t bytesPerRow = ((size_t)width * 4 * sizeof(float) + 255) / 256 * 256;
+  float *rows = makeRows(width, height, bytesPerRow);
+  void *image = malloc(mglReadbackImageBytes(width, height, mglReadbackSingle));
+  if ((rows == NULL) || (image == NULL)) {
+    printf("(mglBenchmarkReadback) Could not allocate a %ux%u frame FAILED\n", width, height);
+    return 1;
+  }
+  printf("(mglBenchmarkReadback) %ux%u frame, ms per frame over %d repeats\n", width, height, repeats);
+  const char *formatNames[] = {"single", "uint8"};
+  for (uint32_t format = mglReadbackSingle; format <= mglReadbackUInt8; format++) {
+    double pixelSecs = timeConvert(rows, bytesPerRow, width, height, format, image, repeats, 1);
+    double tileSecs = timeConvert(rows, bytesPerRow, width, height, format, image, repeats, 0);
+    printf("(mglBenchmarkReadback)   %-6s pixel by pixel %7.3f ms  tiled %7.3f ms  %5.2fx  sends %.1f MB\n",
+           formatNames[format], 1000 * pixelSecs, 1000 * tileSecs, pixelSecs / tileSecs,
+           mglReadbackImageBytes(width, height, format) / 1e6);
+  }
+  free(rows);
+  free(image);
+  return failed;
+}
+
+////////////////////
+//   checkImage   //
+////////////////////
+// Convert rows with padding and compare with the reference, and check nothing is written past the image.
+static int checkImage(uint32_t width, uint32_t height, uint32_t format)
+{
+  size_t bytesPerRow = (size_t)width * 4 * sizeof(float) + 48;
+  size_t imageBytes = mglReadbackImageBytes(width, height, format);
+  float *rows = makeRows(width, height, bytesPerRow);
+  uint8_t *image = (uint8_t *)malloc(imageBytes + 16);
+  uint8_t *expected = (uint8_t *)malloc(imageBytes);
+  int failed = 0;
+
+  memset(image, 0xAB, imageBytes + 16);
+  mglReadbackToImage(rows, bytesPerRow, width, height, format, image);
+  referenceImage(rows, bytesPerRow, width, height, format, expected);
+  if (memcmp(image, expected, imageBytes)) {
+    printf("(mglBenchmarkReadback) %ux%u %s image is different FAILED\n", width, height, format == mglReadbackUInt8 ? "uint8" : "single");
+    failed = 1;
+  }
+  for (size_t i = imageBytes; (i < imageBytes + 16) && !failed; i++) {
+    if (image[i] != 0xAB) {
+      printf("(mglBenchmarkReadback) %ux%u image wrote past its end FAILED\n", width, height);
+      failed = 1;
+    }
+  }
+  free(rows);
+  free(image);
+  free(expected);
+  return failed;
+}
+
+////////////////////
+//   checkUInt8   //
+////////////////////
+static int checkUInt8(void)
+{
+  struct {float value; uint8_t expected;} cases[] = {
+    {0.0f, 0}, {-0.5f, 0}, {NAN, 0}, {1.0f, 255}, {7.0f, 255}, {INFINITY, 255},
+    {0.5f, 128}, {1.0f / 255.0f, 1}, {0.499f / 255.0f, 0}, {254.6f / 255.0f, 255}, {100.0f / 255.0f, 100}
+  };
+  int failed = 0;
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+    uint8_t value = mglReadbackFloatToUInt8(cases[i].value);
+    if (value != cases[i].expected) {
+      printf("(mglBenchmarkReadback) %f is %u as uint8, expected %u FAILED\n", cases[i].value, value, cases[i].expected);
+      failed = 1;
+    }
+  }
+  return failed;
+}
+
+//////////////////////
+//   checkRegions   //
+//////////////////////
+static int checkRegions(void)
+{
+  struct {uint32_t x, y, width, height; int ok; uint32_t expectedWidth, expectedHeight;} cases[] = {
+    {0, 0, 0, 0, 1, 640, 480},
+    {10, 20, 0, 0, 1, 630, 460},
+    {10, 20, 100, 50, 1, 100, 50},
+    {0, 0, 640, 480, 1, 640, 480},
+    {639, 479, 1, 1, 1, 1, 1},
+    {640, 0, 0, 0, 0, 0, 0},
+    {0, 480, 0, 0, 0, 0, 0},
+    {600, 0, 41, 0, 0, 0, 0},
+    {0, 400, 0, 81, 0, 0, 0},
+    {1, 1, 0xFFFFFFFF, 1, 0, 0, 0}
+  };
+  int failed = 0;
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+    uint32_t width = cases[i].width, height = cases[i].height;
+    int ok = mglReadbackRegion(640, 480, cases[i].x, cases[i].y, &width, &height);
+    if ((ok != cases[i].ok) || (ok && ((width != cases[i].expectedWidth) || (height != cases[i].expectedHeight)))) {
+      printf("(mglBenchmarkReadback) Region %u %u %u %u of 640x480 is %s %ux%u FAILED\n",
+             cases[i].x, cases[i].y, cases[i].width, cases[i].height, ok ? "ok" : "refused", width, height);
+      failed = 1;
+    }
+  }
+  return failed;
+}
+
+//////////////////
+//   makeRows   //
+//////////////////
+// Rows of pixels with values mostly 0-1, and some outside, with garbage in the padding.
+static float *makeRows(uint32_t width, uint32_t height, size_t bytesPerRow)
+{
+  float *rows = (float *)malloc(bytesPerRow * height);
+  if (rows == NULL) return NULL;
+  memset(rows, 0x7F, bytesPerRow * height);
+  for (uint32_t y = 0; y < height; y++) {
+    float *row = (float *)((uint8_t *)rows + y * bytesPerRow);
+    for (uint32_t x = 0; x < width; x++) {
+      for (uint32_t c = 0; c < 4; c++) {
+        row[4 * x + c] = (float)((x * 7 + y * 13 + c * 61) % 300) / 280.0f - 0.03f;
+      }
+    }
+  }
+  return rows;
+}
+
+////////////////////////
+//   referenceImage   //
+////////////////////////
+// Pixel by pixel, as Matlab would do permute(frame, [3 2 1]) on the rows.
+static void referenceImage(const float *rows, size_t bytesPerRow, uint32_t width, uint32_t height, uint32_t format, void *image)
+{
+  for (uint32_t y = 0; y < height; y++) {
+    const float *row = (const float *)((const uint8_t *)rows + y * bytesPerRow);
+    for (uint32_t x = 0; x < width; x++) {
+      for (uint32_t c = 0; c < 4; c++) {
+        size_t index = y + (size_t)x * height + (size_t)c * width * height;
+        if (format == mglReadbackUInt8)
+          ((uint8_t *)image)[index] = mglReadbackFloatToUInt8(row[4 * x + c]);
+        else
+          ((float *)image)[index] = row[4 * x + c];
+      }
+    }
+  }
+}
+
+/////////////////////
+//   timeConvert   //
+/////////////////////
+static double timeConvert(const float *rows, size_t bytesPerRow, uint32_t width, uint32_t height, uint32_t format, void *image, int repeats, int reference)
+{
+  double bestSecs = INFINITY;
+  for (int i = 0; i < repeats; i++) {
+    double startSecs = getSecs();
+    if (reference)
+      referenceImage(rows, bytesPerRow, width, height, format, image);
+    else
+      mglReadbackToImage(rows, bytesPerRow, width, height, format, image);
+    double secs = getSecs() - startSecs;
+    if (secs < bestSecs) bestSecs = secs;
+  }
+  return bestSecs;
+}
+
+/////////////////
+//   getSecs   //
+/////////////////
+static double getSecs(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
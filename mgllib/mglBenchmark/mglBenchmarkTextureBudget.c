@@ -0,0 +1,339 @@
+#ifdef documentation
+=========================================================================
+
+     program: mglBenchmarkTextureBudget.c
+          by: justin gardner
+        date: 10/19/2026
+   copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+     purpose: standalone test and benchmark of mglTextureBudget.h, the
+              policy that mglMetalSetTextureBudget uses to choose which
+              textures to spill out of GPU memory. Drives the policy
+              against a fake texture store, which just remembers which
+              textures are resident, and checks that nothing is spilled
+              without a budget, that the least recently used textures
+              are spilled first (by texture number for ties), that
+              textures used in the frame being drawn and pinned textures
+              are never spilled while ones that are not pinned are, that
+              a single texture bigger than the budget spills everything
+              it can and still goes in, and that removing a spilled
+              texture takes it out of the counts. Then uses textures at
+              random with a budget smaller than all of them, and reports
+              how many were spilled and restored, and how long choosing
+              takes. Needs no Matlab, and builds on Linux or Mac with the
+              makefile in this directory.
+       usage: mglBenchmarkTextureBudget [textures budgetFraction frames]
+
+=========================================================================
+#endif
+
+/////////////////////////
+//   include section   //
+/////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../../metal/mglMetal/mglTextureBudget.h"
+
+///////////////////////////////
+//   function declarations   //
+///////////////////////////////
+static int checkPolicy(void);
+static int checkOverBudget(void);
+static int checkRemoveSpilled(void);
+static uint32_t makeRoom(mglTextureBudget *budget, uint64_t bytes, uint64_t frame, uint32_t *spilled);
+static uint32_t add(mglTextureBudget *budget, uint32_t textureNumber, uint64_t bytes, uint64_t frame, uint32_t *spilled);
+static uint32_t use(mglTextureBudget *budget, uint32_t textureNumber, uint64_t frame, uint32_t *spilled);
+static int checkSpilled(const char *name, const uint32_t *spilled, uint32_t count, const uint32_t *expected, uint32_t expectedCount);
+static int checkCounts(const char *name, mglTextureBudget *budget, uint32_t residentCount, uint64_t residentBytes, uint32_t spilledCount, uint64_t spilledBytes, uint64_t compressedBytes);
+static double getSecs(void);
+
+////////////////////////
+//   define section   //
+////////////////////////
+#define MAX_TEXTURES 65536
+// what the fake store says each spilled texture compresses to
+#define COMPRESSED_BYTES 10
+
+// the fake store, which textures are resident
+static uint8_t resident[MAX_TEXTURES];
+
+//////////////
+//   main   //
+//////////////
+int main(int argc, char *argv[])
+{
+  uint32_t textureCount = (argc > 1) ? atoi(argv[1]) : 2000;
+  double budgetFraction = (argc > 2) ? atof(argv[2]) : 0.5;
+  uint32_t frames = (argc > 3) ? atoi(argv[3]) : 2000;
+  int failed = 0;
+
+  failed |= checkPolicy();
+  failed |= checkOverBudget();
+  failed |= checkRemoveSpilled();
+  if (!failed) printf("(mglBenchmarkTextureBudget) Spill order, pinning, over budget textures and counts are checked OK\n");
+
+  // textures of a few sizes used at random, a few each frame, with a budget smaller than all of them
+  if ((textureCount < 1) || (textureCount >= MAX_TEXTURES) || (budgetFraction <= 0) || (frames < 1)) {
+    printf("(mglBenchmarkTextureBudget) usage: mglBenchmarkTextureBudget [textures budgetFraction frames], with textures 1-%d\n", MAX_TEXTURES - 1);
+    return 1;
+  }
+  mglTextureBudget budget;
+  memset(&budget, 0, sizeof(budget));
+  uint32_t *spilled = (uint32_t *)malloc(MAX_TEXTURES * sizeof(uint32_t));
+  uint64_t totalBytes = 0;
+  srand(1);
+  for (uint32_t textureNumber = 1; textureNumber <= textureCount; textureNumber++) {
+    uint64_t bytes = (uint64_t)(1 + rand() % 4) << 20;
+    add(&budget, textureNumber, bytes, 0, spilled);
+    totalBytes += bytes;
+  }
+  budget.budgetBytes = (uint64_t)(budgetFraction * totalBytes);
+  makeRoom(&budget, 0, 0, spilled);
+  double chooseSecs = 0;
+  uint64_t uses = 0;
+  for (uint64_t frame = 1; frame <= frames; frame++) {
+    for (int i = 0; i < 8; i++) {
+      uint32_t textureNumber = 1 + rand() % textureCount;
+      double startTime = getSecs();
+      use(&budget, textureNumber, frame, spilled);
+      chooseSecs += getSecs() - startTime;
+      uses++;
+    }
+  }
+  printf("(mglBenchmarkTextureBudget) %u textures, %0.0f MB with a %0.0f MB budget: %llu uses over %u frames, %llu spilled, %llu restored, %.2f us a use\n",
+         textureCount, totalBytes / 1048576.0, budget.budgetBytes / 1048576.0, (unsigned long long)uses, frames,
+         (unsigned long long)budget.spillCount, (unsigned long long)budget.restoreCount, 1e6 * chooseSecs / uses);
+  mglTextureBudgetFree(&budget);
+  free(spilled);
+  return failed;
+}
+
+/////////////////////
+//   checkPolicy   //
+/////////////////////
+static int checkPolicy(void)
+{
+  mglTextureBudget budget;
+  memset(&budget, 0, sizeof(budget));
+  uint32_t spilled[16];
+  uint32_t count;
+  int failed = 0;
+
+  // with no budget, nothing is spilled
+  failed |= checkSpilled("no budget", spilled, add(&budget, 1, 100, 0, spilled), NULL, 0);
+  failed |= checkSpilled("no budget", spilled, add(&budget, 2, 100, 1, spilled), NULL, 0);
+  failed |= checkSpilled("no budget", spilled, add(&budget, 3, 100, 2, spilled), NULL, 0);
+  failed |= checkSpilled("no budget", spilled, makeRoom(&budget, 1000, 2, spilled), NULL, 0);
+
+  // texture 1 is used again, so texture 2 is least recently used when texture 4 needs room
+  budget.budgetBytes = 300;
+  failed |= checkSpilled("resident use", spilled, use(&budget, 1, 3, spilled), NULL, 0);
+  count = add(&budget, 4, 100, 3, spilled);
+  failed |= checkSpilled("least recently used", spilled, count, (uint32_t[]){2}, 1);
+  failed |= checkCounts("least recently used", &budget, 3, 300, 1, 100, COMPRESSED_BYTES);
+
+  // using texture 2 restores it, spilling texture 3, and not texture 4, which is used in this frame
+  failed |= checkSpilled("used this frame", spilled, use(&budget, 4, 4, spilled), NULL, 0);
+  count = use(&budget, 2, 4, spilled);
+  failed |= checkSpilled("restore", spilled, count, (uint32_t[]){3}, 1);
+  if ((budget.spillCount != 2) || (budget.restoreCount != 1) || !resident[1] || !resident[2] || resident[3] || !resident[4]) {
+    printf("(mglBenchmarkTextureBudget) After restoring, %llu spills and %llu restores, expected 2 and 1 FAILED\n",
+           (unsigned long long)budget.spillCount, (unsigned long long)budget.restoreCount);
+    failed = 1;
+  }
+
+  // textures last used in the same frame are spilled in order of texture number
+  budget.budgetBytes = 0;
+  failed |= checkSpilled("ties", spilled, add(&budget, 6, 100, 5, spilled), NULL, 0);
+  failed |= checkSpilled("ties", spilled, add(&budget, 5, 100, 5, spilled), NULL, 0);
+  budget.budgetBytes = 400;
+  mglTextureBudgetPin(&budget, 1);
+  mglTextureBudgetPin(&budget, 2);
+  mglTextureBudgetPin(&budget, 4);
+  count = makeRoom(&budget, 100, 6, spilled);
+  failed |= checkSpilled("ties", spilled, count, (uint32_t[]){5, 6}, 2);
+
+  // a smaller budget spills all it can, but not pinned textures, while ones that are not pinned go
+  failed |= checkSpilled("pinned", spilled, use(&budget, 5, 7, spilled), NULL, 0);
+  mglTextureBudgetPin(&budget, 5);
+  failed |= checkSpilled("pinned", spilled, use(&budget, 6, 7, spilled), NULL, 0);
+  budget.budgetBytes = 100;
+  count = makeRoom(&budget, 0, 8, spilled);
+  failed |= checkSpilled("pinned", spilled, count, (uint32_t[]){6}, 1);
+  failed |= checkCounts("pinned", &budget, 4, 400, 2, 200, 2 * COMPRESSED_BYTES);
+
+  // only as many as asked for are chosen
+  budget.budgetBytes = 0;
+  for (uint32_t textureNumber = 10; textureNumber < 14; textureNumber++) add(&budget, textureNumber, 100, 9, spilled);
+  budget.budgetBytes = 500;
+  count = mglTextureBudgetChooseSpills(&budget, 0, 10, spilled, 2);
+  failed |= checkSpilled("max victims", spilled, count, (uint32_t[]){10, 11}, 2);
+
+  mglTextureBudgetFree(&budget);
+  return failed;
+}
+
+/////////////////////////
+//   checkOverBudget   //
+/////////////////////////
+// A texture bigger than the budget spills everything that can be spilled, and goes in anyway.
+static int checkOverBudget(void)
+{
+  mglTextureBudget budget;
+  memset(&budget, 0, sizeof(budget));
+  uint32_t spilled[16];
+  uint32_t count;
+  int failed = 0;
+
+  budget.budgetBytes = 300;
+  add(&budget, 1, 100, 0, spilled);
+  add(&budget, 2, 100, 1, spilled);
+  add(&budget, 3, 100, 2, spilled);
+  mglTextureBudgetPin(&budget, 3);
+  count = add(&budget, 4, 500, 3, spilled);
+  failed |= checkSpilled("over budget", spilled, count, (uint32_t[]){1, 2}, 2);
+  failed |= checkCounts("over budget", &budget, 2, 600, 2, 200, 2 * COMPRESSED_BYTES);
+
+  // and when it is used, with nothing left to spill, it stays resident
+  failed |= checkSpilled("over budget use", spilled, use(&budget, 4, 4, spilled), NULL, 0);
+  failed |= checkSpilled("over budget room", spilled, makeRoom(&budget, 0, 4, spilled), NULL, 0);
+
+  // a texture used in this frame is not spilled even for itself
+  mglTextureBudget single;
+  memset(&single, 0, sizeof(single));
+  single.budgetBytes = 100;
+  add(&single, 1, 1000, 0, spilled);
+  failed |= checkSpilled("over budget alone", spilled, use(&single, 1, 0, spilled), NULL, 0);
+  failed |= checkSpilled("over budget alone", spilled, makeRoom(&single, 0, 0, spilled), NULL, 0);
+  failed |= checkCounts("over budget alone", &single, 1, 1000, 0, 0, 0);
+
+  mglTextureBudgetFree(&budget);
+  mglTextureBudgetFree(&single);
+  return failed;
+}
+
+////////////////////////////
+//   checkRemoveSpilled   //
+////////////////////////////
+// Deleting textures, resident or spilled, takes them out of the counts.
+static int checkRemoveSpilled(void)
+{
+  mglTextureBudget budget;
+  memset(&budget, 0, sizeof(budget));
+  uint32_t spilled[16];
+  int failed = 0;
+
+  budget.budgetBytes = 200;
+  add(&budget, 1, 100, 0, spilled);
+  add(&budget, 2, 100, 1, spilled);
+  add(&budget, 3, 100, 2, spilled);
+  failed |= checkCounts("before remove", &budget, 2, 200, 1, 100, COMPRESSED_BYTES);
+
+  if ((mglTextureBudgetRemove(&budget, 1) != 1) || (mglTextureBudgetRemove(&budget, 1) != 0) || (mglTextureBudgetUse(&budget, 1, 3) != -1)) {
+    printf("(mglBenchmarkTextureBudget) Spilled texture was not removed FAILED\n");
+    failed = 1;
+  }
+  failed |= checkCounts("remove spilled", &budget, 2, 200, 0, 0, 0);
+
+  // restoring or spilling a removed texture changes nothing
+  mglTextureBudgetRestored(&budget, 1);
+  mglTextureBudgetSpilled(&budget, 1, COMPRESSED_BYTES);
+  failed |= checkCounts("removed restore", &budget, 2, 200, 0, 0, 0);
+
+  // and a resident one too, after which new textures fit without spilling
+  if (mglTextureBudgetRemove(&budget, 3) != 1) {
+    printf("(mglBenchmarkTextureBudget) Resident texture was not removed FAILED\n");
+    failed = 1;
+  }
+  failed |= checkCounts("remove resident", &budget, 1, 100, 0, 0, 0);
+  failed |= checkSpilled("after remove", spilled, add(&budget, 4, 100, 3, spilled), NULL, 0);
+
+  mglTextureBudgetFree(&budget);
+  return failed;
+}
+
+//////////////////
+//   makeRoom   //
+//////////////////
+// Spill what the policy chooses, as mglColorRenderingState does, returning how many.
+static uint32_t makeRoom(mglTextureBudget *budget, uint64_t bytes, uint64_t frame, uint32_t *spilled)
+{
+  uint32_t count = mglTextureBudgetChooseSpills(budget, bytes, frame, spilled, budget->entryCount);
+  for (uint32_t i = 0; i < count; i++) {
+    resident[spilled[i]] = 0;
+    mglTextureBudgetSpilled(budget, spilled[i], COMPRESSED_BYTES);
+  }
+  return count;
+}
+
+/////////////
+//   add   //
+/////////////
+static uint32_t add(mglTextureBudget *budget, uint32_t textureNumber, uint64_t bytes, uint64_t frame, uint32_t *spilled)
+{
+  uint32_t count = makeRoom(budget, bytes, frame, spilled);
+  if (!mglTextureBudgetAdd(budget, textureNumber, bytes, frame)) {
+    printf("(mglBenchmarkTextureBudget) Could not add texture %u FAILED\n", textureNumber);
+  }
+  resident[textureNumber] = 1;
+  return count;
+}
+
+/////////////
+//   use   //
+/////////////
+// Use a texture, restoring it first if it was spilled.
+static uint32_t use(mglTextureBudget *budget, uint32_t textureNumber, uint64_t frame, uint32_t *spilled)
+{
+  if (mglTextureBudgetUse(budget, textureNumber, frame) != 0) {
+    return 0;
+  }
+  mglTextureBudgetEntry *entry = mglTextureBudgetFind(budget, textureNumber);
+  uint32_t count = makeRoom(budget, entry->bytes, frame, spilled);
+  resident[textureNumber] = 1;
+  mglTextureBudgetRestored(budget, textureNumber);
+  return count;
+}
+
+//////////////////////
+//   checkSpilled   //
+//////////////////////
+static int checkSpilled(const char *name, const uint32_t *spilled, uint32_t count, const uint32_t *expected, uint32_t expectedCount)
+{
+  if ((count == expectedCount) && ((count == 0) || !memcmp(spilled, expected, count * sizeof(uint32_t)))) {
+    return 0;
+  }
+  printf("(mglBenchmarkTextureBudget) %s spilled", name);
+  for (uint32_t i = 0; i < count; i++) printf(" %u", spilled[i]);
+  printf(", expected");
+  for (uint32_t i = 0; i < expectedCount; i++) printf(" %u", expected[i]);
+  printf(" FAILED\n");
+  return 1;
+}
+
+/////////////////////
+//   checkCounts   //
+/////////////////////
+static int checkCounts(const char *name, mglTextureBudget *budget, uint32_t residentCount, uint64_t residentBytes, uint32_t spilledCount, uint64_t spilledBytes, uint64_t compressedBytes)
+{
+  if ((budget->residentCount == residentCount) && (budget->residentBytes == residentBytes) && (budget->spilledCount == spilledCount) &&
+      (budget->spilledBytes == spilledBytes) && (budget->compressedBytes == compressedBytes)) {
+    return 0;
+  }
+  printf("(mglBenchmarkTextureBudget) %s counts are %u/%llu resident, %u/%llu/%llu spilled, expected %u/%llu, %u/%llu/%llu FAILED\n", name,
+         budget->residentCount, (unsigned long long)budget->residentBytes, budget->spilledCount, (unsigned long long)budget->spilledBytes,
+         (unsigned long long)budget->compressedBytes, residentCount, (unsigned long long)residentBytes, spilledCount,
+         (unsigned long long)spilledBytes, (unsigned long long)compressedBytes);
+  return 1;
+}
+
+/////////////////
+//   getSecs   //
+/////////////////
+static double getSecs(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
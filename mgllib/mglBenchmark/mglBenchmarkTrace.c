@@ -0,0 +1,278 @@
+#ifdef documentation
+=========================================================================
+
+     program: mglBenchmarkTrace.c
+          by: justin gardner
+        date: 10/19/2026
+   copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+     purpose: standalone test and benchmark of mglTrace.c, the trace of
+              the render loop that mglMetal writes with mglMetalTrace.
+              Traces from several threads at once, and from one thread
+              faster than the flusher can drain, stops, then reads the
+              file back and checks the header and event names, that
+              the records of each thread are all there in the order they
+              were made, and that records dropped from a full buffer
+              are counted in a dropped record. Then times a trace call
+              with tracing on and off. Needs no Matlab, and builds on
+              Linux or Mac with the makefile in this directory.
+       usage: mglBenchmarkTrace [threads records]
+
+=========================================================================
+#endif
+
+/////////////////////////
+//   include section   //
+/////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include "../../metal/mglMetal/mglTrace.h"
+
+///////////////////////////////
+//   function declarations   //
+///////////////////////////////
+static void *traceThread(void *arg);
+static int checkFile(const char *path, int threadCount, uint64_t records, uint64_t burstRecords, uint64_t *dropped);
+static double timeTrace(int on, const char *path, uint64_t records);
+static double getSecs(void);
+
+////////////////////////
+//   define section   //
+////////////////////////
+// each thread traces args of its own, with the thread number in the high bits
+#define THREAD_ARG(thread, i) (((uint64_t)(thread) << 32) | (uint64_t)(i))
+#define MAX_THREADS 32
+
+// what each thread traces
+typedef struct traceThreadArgs {
+  int thread;
+  uint64_t records;
+  int instants;
+} traceThreadArgs;
+
+// threads wait for each other before exiting, since the buffer of a thread
+// that exits goes to the next thread that traces
+static pthread_mutex_t doneMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t doneCondition = PTHREAD_COND_INITIALIZER;
+static int threadsNotDone = 0;
+
+//////////////
+//   main   //
+//////////////
+int main(int argc, char *argv[])
+{
+  int threadCount = (argc > 1) ? atoi(argv[1]) : 4;
+  uint64_t records = (argc > 2) ? strtoull(argv[2], NULL, 10) : 5000;
+  int failed = 0;
+
+  // the pairs from each thread fit in its buffer, so none should be dropped
+  if ((threadCount < 1) || (threadCount >= MAX_THREADS) || (records < 1) || (2 * records > MGL_TRACE_BUFFER_RECORDS)) {
+    printf("(mglBenchmarkTrace) usage: mglBenchmarkTrace [threads records], with threads 1-%d and records 1-%d\n", MAX_THREADS - 1, MGL_TRACE_BUFFER_RECORDS / 2);
+    return 1;
+  }
+
+  // a file to write and read back
+  char path[256];
+  const char *tmpDir = getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp";
+  snprintf(path, sizeof(path), "%s/mglBenchmarkTraceXXXXXX", tmpDir);
+  int fileDescriptor = mkstemp(path);
+  if (fileDescriptor < 0) {
+    printf("(mglBenchmarkTrace) Could not make a file in %s\n", tmpDir);
+    return 1;
+  }
+  close(fileDescriptor);
+
+  // begin and end pairs from several threads at once, and a burst of instants
+  // from one more thread, many times what its buffer holds, so some are dropped
+  uint64_t burstRecords = 8 * (uint64_t)MGL_TRACE_BUFFER_RECORDS;
+  pthread_t threads[MAX_THREADS];
+  traceThreadArgs threadArgs[MAX_THREADS];
+  if (!mglTraceStart(path)) {
+    printf("(mglBenchmarkTrace) Could not start tracing to %s FAILED\n", path);
+    return 1;
+  }
+  threadsNotDone = threadCount + 1;
+  for (int i = 0; i <= threadCount; i++) {
+    threadArgs[i].thread = i + 1;
+    threadArgs[i].records = (i < threadCount) ? records : burstRecords;
+    threadArgs[i].instants = (i == threadCount);
+    pthread_create(&threads[i], NULL, traceThread, &threadArgs[i]);
+  }
+  for (int i = 0; i <= threadCount; i++) {
+    pthread_join(threads[i], NULL);
+  }
+  mglTraceStop();
+  if (mglTraceIsOn()) {
+    printf("(mglBenchmarkTrace) Tracing is still on after stopping FAILED\n");
+    failed = 1;
+  }
+
+  uint64_t dropped = 0;
+  failed |= checkFile(path, threadCount, records, burstRecords, &dropped);
+  if (!failed) printf("(mglBenchmarkTrace) %d threads of %llu begin and end pairs in order, %llu of %llu burst records dropped and counted, OK\n",
+                      threadCount, (unsigned long long)records, (unsigned long long)dropped, (unsigned long long)burstRecords);
+
+  // how long a trace call takes
+  double onSecs = timeTrace(1, path, MGL_TRACE_BUFFER_RECORDS / 4);
+  double offSecs = timeTrace(0, path, 1000000);
+  printf("(mglBenchmarkTrace) a trace call takes %.1f ns with tracing on, %.2f ns with it off\n", 1e9 * onSecs, 1e9 * offSecs);
+
+  unlink(path);
+  return failed;
+}
+
+/////////////////////
+//   traceThread   //
+/////////////////////
+static void *traceThread(void *arg)
+{
+  traceThreadArgs *args = (traceThreadArgs *)arg;
+  for (uint64_t i = 0; i < args->records; i++) {
+    if (args->instants) {
+      mglTraceInstant(mglTraceCommit, THREAD_ARG(args->thread, i));
+    } else {
+      mglTraceBegin(mglTraceDraw, THREAD_ARG(args->thread, i));
+      mglTraceEnd(mglTraceDraw, THREAD_ARG(args->thread, i));
+    }
+  }
+  pthread_mutex_lock(&doneMutex);
+  if (--threadsNotDone == 0) pthread_cond_broadcast(&doneCondition);
+  while (threadsNotDone > 0) pthread_cond_wait(&doneCondition, &doneMutex);
+  pthread_mutex_unlock(&doneMutex);
+  return NULL;
+}
+
+///////////////////
+//   checkFile   //
+///////////////////
+// Read the trace back and check it has everything each thread traced, in order.
+static int checkFile(const char *path, int threadCount, uint64_t records, uint64_t burstRecords, uint64_t *dropped)
+{
+  FILE *file = fopen(path, "rb");
+  if (file == NULL) {
+    printf("(mglBenchmarkTrace) Could not read %s FAILED\n", path);
+    return 1;
+  }
+
+  // the header and event names
+  char magic[8];
+  uint32_t header[4];
+  if ((fread(magic, 1, 8, file) != 8) || memcmp(magic, MGL_TRACE_MAGIC, 8) || (fread(header, sizeof(uint32_t), 4, file) != 4) ||
+      (header[0] != MGL_TRACE_VERSION) || (header[1] != sizeof(mglTraceRecord)) || (header[2] != mglTraceEventCount) || (header[3] != MGL_TRACE_EVENT_NAME_BYTES)) {
+    printf("(mglBenchmarkTrace) Header is wrong FAILED\n");
+    fclose(file);
+    return 1;
+  }
+  for (int i = 0; i < mglTraceEventCount; i++) {
+    char name[MGL_TRACE_EVENT_NAME_BYTES];
+    if ((fread(name, 1, MGL_TRACE_EVENT_NAME_BYTES, file) != MGL_TRACE_EVENT_NAME_BYTES) || strncmp(name, mglTraceEventName(i), MGL_TRACE_EVENT_NAME_BYTES)) {
+      printf("(mglBenchmarkTrace) Event name %d is wrong FAILED\n", i);
+      fclose(file);
+      return 1;
+    }
+  }
+
+  // the records of each thread, which should come from one trace thread number
+  // with args in order, begin before end, and times that never go back
+  uint64_t count[MAX_THREADS] = {0}, next[MAX_THREADS] = {0}, lastTime[MAX_THREADS] = {0}, droppedCount[MAX_THREADS] = {0};
+  uint32_t traceThread[MAX_THREADS] = {0};
+  int droppedRecords = 0, failed = 0;
+  mglTraceRecord record;
+  while (!failed && (fread(&record, sizeof(record), 1, file) == 1)) {
+    if (record.event == mglTraceDropped) {
+      for (int i = 0; i <= threadCount; i++) {
+        if (traceThread[i] == record.thread) droppedCount[i] += record.arg;
+      }
+      droppedRecords++;
+      continue;
+    }
+    int thread = (int)(record.arg >> 32) - 1;
+    uint64_t i = record.arg & 0xFFFFFFFF;
+    if ((thread < 0) || (thread > threadCount)) {
+      printf("(mglBenchmarkTrace) Record with arg %llx is from no thread FAILED\n", (unsigned long long)record.arg);
+      failed = 1;
+      break;
+    }
+    if (traceThread[thread] == 0) traceThread[thread] = record.thread;
+    if (record.thread != traceThread[thread]) {
+      printf("(mglBenchmarkTrace) Thread %d has records from trace threads %u and %u FAILED\n", thread, traceThread[thread], record.thread);
+      failed = 1;
+    }
+    if (record.time < lastTime[thread]) {
+      printf("(mglBenchmarkTrace) Thread %d record %llu is earlier than the one before FAILED\n", thread, (unsigned long long)i);
+      failed = 1;
+    }
+    lastTime[thread] = record.time;
+    if (thread < threadCount) {
+      // begin and end pairs, none dropped, in order
+      uint64_t expectedArg = next[thread] / 2;
+      uint8_t expectedPhase = (next[thread] % 2) ? mglTracePhaseEnd : mglTracePhaseBegin;
+      if ((record.event != mglTraceDraw) || (i != expectedArg) || (record.phase != expectedPhase)) {
+        printf("(mglBenchmarkTrace) Thread %d record %llu is %s %c %llu, expected draw %c %llu FAILED\n", thread, (unsigned long long)count[thread],
+               mglTraceEventName(record.event), record.phase, (unsigned long long)i, expectedPhase, (unsigned long long)expectedArg);
+        failed = 1;
+      }
+      next[thread]++;
+    } else {
+      // instants, in order, but maybe with some dropped in between
+      if ((record.event != mglTraceCommit) || (record.phase != mglTracePhaseInstant) || (i < next[thread])) {
+        printf("(mglBenchmarkTrace) Burst record %llu is %s %c after %llu FAILED\n", (unsigned long long)count[thread],
+               mglTraceEventName(record.event), record.phase, (unsigned long long)next[thread]);
+        failed = 1;
+      }
+      next[thread] = i + 1;
+    }
+    count[thread]++;
+  }
+  fclose(file);
+  if (failed) return 1;
+
+  // every record is there or counted as dropped
+  for (int i = 0; i < threadCount; i++) {
+    if ((count[i] != 2 * records) || droppedCount[i]) {
+      printf("(mglBenchmarkTrace) Thread %d has %llu records and %llu dropped, expected %llu and none FAILED\n", i,
+             (unsigned long long)count[i], (unsigned long long)droppedCount[i], (unsigned long long)(2 * records));
+      failed = 1;
+    }
+  }
+  if (count[threadCount] + droppedCount[threadCount] != burstRecords) {
+    printf("(mglBenchmarkTrace) Burst has %llu records and %llu dropped, expected %llu in all FAILED\n",
+           (unsigned long long)count[threadCount], (unsigned long long)droppedCount[threadCount], (unsigned long long)burstRecords);
+    failed = 1;
+  }
+  if (droppedRecords > 1) {
+    printf("(mglBenchmarkTrace) %d dropped records, expected one at most FAILED\n", droppedRecords);
+    failed = 1;
+  }
+  *dropped = droppedCount[threadCount];
+  return failed;
+}
+
+///////////////////
+//   timeTrace   //
+///////////////////
+// Seconds for one trace call, with few enough records when on that none are dropped.
+static double timeTrace(int on, const char *path, uint64_t records)
+{
+  if (on) mglTraceStart(path);
+  double startTime = getSecs();
+  for (uint64_t i = 0; i < records; i++) {
+    mglTraceInstant(mglTraceCommit, i);
+  }
+  double secs = (getSecs() - startTime) / (double)records;
+  if (on) mglTraceStop();
+  return secs;
+}
+
+/////////////////
+//   getSecs   //
+/////////////////
+static double getSecs(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
@@ -127,20 +127,36 @@ function retval = makeReturnStruct(w,h,t,cameraStart,cameraEnd,systemStart,syste
 retval.im = [];
 retval.filename = '';
 
-% figure out slope and offset of relationship to system time
-m = (systemEnd-systemStart)/(cameraEnd-cameraStart);
-% should be 1e-09, so check that to 3 decimal points and if it is then
-% just use that value
-if isequal(round(m*1e12),1e3)
-  m = 1e-9;
+% without mglClockAlign compiled, convert camera time to system time with
+% the line through the times at the start and end of this capture
+if exist('mglClockAlign')~=3
+  % figure out slope and offset of relationship to system time
+  m = (systemEnd-systemStart)/(cameraEnd-cameraStart);
+  % should be 1e-09, so check that to 3 decimal points and if it is then
+  % just use that value
+  if isequal(round(m*1e12),1e3)
+    m = 1e-9;
+  end
+  % get offset as average time difference for these two time points
+  offset = ((systemStart-cameraStart*m) + (systemEnd-cameraEnd*m))/2;
+  % convert camera time to system time based on these
+  retval.t = t*m+offset;
+else
+  % add the camera and system times from the start and end of the capture
+  % to the clock alignment fit for the camera (which counts nanoseconds),
+  % which keeps track of offset and drift across captures, rejecting
+  % outliers, and use it to convert camera time to system time
+  lastInfo = mglClockAlign('info','camera');
+  info = mglClockAlign('add','camera',[cameraStart cameraEnd],[systemStart systemEnd],1e-9);
+  if ~isempty(lastInfo) && (info.nRejected >= lastInfo.nRejected+2)
+    % neither time fits with earlier captures, the camera clock has
+    % probably been reset (e.g. camera reopened), so start the fit over
+    mglClockAlign('create','camera',1e-9);
+    mglClockAlign('add','camera',[cameraStart cameraEnd],[systemStart systemEnd]);
+  end
+  retval.t = mglClockAlign('toHost','camera',t);
 end
 
-% get offset as average time difference for these two time points
-offset = ((systemStart-cameraStart*m) + (systemEnd-cameraEnd*m))/2;
-
-% convert camera time to system time based on these
-retval.t = t*m+offset;
-
 % get camera delay setting
 cameraDelay = mglGetParam('mglCameraDelay');
 if ~isempty(cameraDelay)
@@ -65,6 +65,12 @@ if any(mgl.s.connectionSocketDescriptor == [mgl.activeSockets.connectionSocketDe
     mglSetParam('clearColor',clearColor);
 end
 
+% skip sending if mglMetal already has this clear color (see mglMetalSkipRedundantCommands)
+[skip, results] = mglPrivateSkipRedundant('mglSetClearColor', single(clearColor), socketInfo);
+if skip
+  return
+end
+
 % Setup timestamp can be used for measuring MGL frame timing,
 % for example with mglTestRenderingPipeline.
 setupTime = mglGetSecs();
@@ -78,5 +84,6 @@ results = mglReadCommandResults(socketInfo, ackTime, setupTime);
 % check if processedTime is negative which indicates an error
 if any([results.processedTime] < 0)
   % display error
+  mglPrivateSkipRedundant('invalidate', {'clearColor'}, socketInfo);
   mglPrivateDisplayProcessingError(socketInfo, results, mfilename);
 end
@@ -0,0 +1,186 @@
+#ifdef documentation
+=========================================================================
+
+     program: mglClockAlign.c
+          by: justin gardner
+        date: 10/19/2026
+     purpose: keeps online fits relating other clocks (GPU, eyetracker,
+              camera...) to mglGetSecs, and converts timestamps between
+              them in bulk (see mglClockAlign.m and mglClockAlign.h)
+   copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+       usage: info = mglClockAlign('add',domain,domainTimes,hostTimes,<nominalSlope>)
+              hostTimes = mglClockAlign('toHost',domain,domainTimes)
+              domainTimes = mglClockAlign('fromHost',domain,hostTimes)
+              info = mglClockAlign('info',domain)
+              info = mglClockAlign('create',domain,<nominalSlope>,<timeConstant>,<outlierThreshold>)
+              mglClockAlign('reset',<domain>)
+
+=========================================================================
+#endif
+
+/////////////////////////
+//   include section   //
+/////////////////////////
+#include "mgl.h"
+#include "mglClockAlign.h"
+
+//////////////////////
+//   define section //
+//////////////////////
+#define MAX_DOMAINS 16
+#define MAX_DOMAIN_NAME 64
+
+///////////////////////////////
+//   function declarations   //
+///////////////////////////////
+static mglClockAlignModel *getModel(const mxArray *domainArg, int create, double nominalSlope);
+static mxArray *makeInfo(const char *domain, const mglClockAlignModel *model);
+static double getOptionalDouble(int nrhs, const mxArray *prhs[], int index);
+
+/////////////////
+//   globals   //
+/////////////////
+// fits stay around between calls, until mglClockAlign is cleared
+static char gDomainNames[MAX_DOMAINS][MAX_DOMAIN_NAME];
+static mglClockAlignModel gModels[MAX_DOMAINS];
+static int gNumDomains = 0;
+
+//////////////
+//   main   //
+//////////////
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+  char command[32];
+  if ((nrhs < 1) || !mxIsChar(prhs[0]) || mxGetString(prhs[0], command, sizeof(command))) {
+    usageError("mglClockAlign");
+    return;
+  }
+
+  // reset one or all domains
+  if (!strcmp(command, "reset")) {
+    if (nrhs < 2) {
+      gNumDomains = 0;
+    }
+    else {
+      mglClockAlignModel *model = getModel(prhs[1], 0, 0);
+      if (model != NULL)
+        mglClockAlignInit(model, model->nominalSlope, model->timeConstant, model->outlierThreshold);
+    }
+    return;
+  }
+
+  // everything else needs a domain
+  if ((nrhs < 2) || !mxIsChar(prhs[1])) {
+    usageError("mglClockAlign");
+    return;
+  }
+  char domain[MAX_DOMAIN_NAME];
+  mxGetString(prhs[1], domain, sizeof(domain));
+
+  // start a domain over with the given settings
+  if (!strcmp(command, "create")) {
+    mglClockAlignModel *model = getModel(prhs[1], 1, 0);
+    if (model == NULL) return;
+    mglClockAlignInit(model, getOptionalDouble(nrhs, prhs, 2), getOptionalDouble(nrhs, prhs, 3), getOptionalDouble(nrhs, prhs, 4));
+    plhs[0] = makeInfo(domain, model);
+  }
+  // add paired samples
+  else if (!strcmp(command, "add")) {
+    if ((nrhs < 4) || !mxIsDouble(prhs[2]) || !mxIsDouble(prhs[3]) || (mxGetNumberOfElements(prhs[2]) != mxGetNumberOfElements(prhs[3]))) {
+      usageError("mglClockAlign");
+      return;
+    }
+    mglClockAlignModel *model = getModel(prhs[1], 1, getOptionalDouble(nrhs, prhs, 4));
+    if (model == NULL) return;
+    double *domainTimes = mxGetPr(prhs[2]);
+    double *hostTimes = mxGetPr(prhs[3]);
+    size_t n = mxGetNumberOfElements(prhs[2]);
+    for (size_t i = 0; i < n; i++)
+      mglClockAlignAdd(model, domainTimes[i], hostTimes[i]);
+    plhs[0] = makeInfo(domain, model);
+  }
+  // convert between domain and host times, keeping the shape of the input
+  else if (!strcmp(command, "toHost") || !strcmp(command, "fromHost")) {
+    if ((nrhs < 3) || !mxIsDouble(prhs[2])) {
+      usageError("mglClockAlign");
+      return;
+    }
+    mglClockAlignModel *model = getModel(prhs[1], 0, 0);
+    if ((model == NULL) || !model->hasSamples) {
+      mexPrintf("(mglClockAlign) No samples for clock %s yet, use mglClockAlign('add',...) first\n", domain);
+      plhs[0] = mxCreateDoubleMatrix(0, 0, mxREAL);
+      return;
+    }
+    plhs[0] = mxCreateNumericArray(mxGetNumberOfDimensions(prhs[2]), mxGetDimensions(prhs[2]), mxDOUBLE_CLASS, mxREAL);
+    if (!strcmp(command, "toHost"))
+      mglClockAlignToHost(model, mxGetPr(prhs[2]), mxGetPr(plhs[0]), mxGetNumberOfElements(prhs[2]));
+    else
+      mglClockAlignFromHost(model, mxGetPr(prhs[2]), mxGetPr(plhs[0]), mxGetNumberOfElements(prhs[2]));
+  }
+  // report the current fit
+  else if (!strcmp(command, "info")) {
+    mglClockAlignModel *model = getModel(prhs[1], 0, 0);
+    plhs[0] = (model == NULL) ? mxCreateDoubleMatrix(0, 0, mxREAL) : makeInfo(domain, model);
+  }
+  else {
+    mexPrintf("(mglClockAlign) Unknown command %s\n", command);
+    usageError("mglClockAlign");
+  }
+}
+
+//////////////////
+//   getModel   //
+//////////////////
+static mglClockAlignModel *getModel(const mxArray *domainArg, int create, double nominalSlope)
+{
+  char domain[MAX_DOMAIN_NAME];
+  if (!mxIsChar(domainArg) || mxGetString(domainArg, domain, sizeof(domain))) {
+    mexPrintf("(mglClockAlign) Clock name should be a string of less than %i characters\n", MAX_DOMAIN_NAME);
+    return NULL;
+  }
+  for (int i = 0; i < gNumDomains; i++) {
+    if (!strcmp(gDomainNames[i], domain))
+      return &gModels[i];
+  }
+  if (!create) return NULL;
+  if (gNumDomains == MAX_DOMAINS) {
+    mexPrintf("(mglClockAlign) Can only keep %i clocks, use mglClockAlign('reset') to start over\n", MAX_DOMAINS);
+    return NULL;
+  }
+  strcpy(gDomainNames[gNumDomains], domain);
+  mglClockAlignInit(&gModels[gNumDomains], nominalSlope, 0, 0);
+  return &gModels[gNumDomains++];
+}
+
+//////////////////
+//   makeInfo   //
+//////////////////
+static mxArray *makeInfo(const char *domain, const mglClockAlignModel *model)
+{
+  const char *fieldNames[] = {"domain", "slope", "driftPPM", "domainReference", "hostReference", "spread", "nSamples", "nRejected", "nominalSlope", "timeConstant", "outlierThreshold"};
+  mxArray *info = mxCreateStructMatrix(1, 1, 11, fieldNames);
+  double slope = mglClockAlignSlope(model);
+  mxSetField(info, 0, "domain", mxCreateString(domain));
+  mxSetField(info, 0, "slope", mxCreateDoubleScalar(slope));
+  mxSetField(info, 0, "driftPPM", mxCreateDoubleScalar(1e6 * (slope / model->nominalSlope - 1.0)));
+  mxSetField(info, 0, "domainReference", mxCreateDoubleScalar(model->domainReference));
+  mxSetField(info, 0, "hostReference", mxCreateDoubleScalar(model->hostReference));
+  mxSetField(info, 0, "spread", mxCreateDoubleScalar(mglClockAlignSpread(model)));
+  mxSetField(info, 0, "nSamples", mxCreateDoubleScalar(model->nSamples));
+  mxSetField(info, 0, "nRejected", mxCreateDoubleScalar(model->nRejected));
+  mxSetField(info, 0, "nominalSlope", mxCreateDoubleScalar(model->nominalSlope));
+  mxSetField(info, 0, "timeConstant", mxCreateDoubleScalar(model->timeConstant));
+  mxSetField(info, 0, "outlierThreshold", mxCreateDoubleScalar(model->outlierThreshold));
+  return info;
+}
+
+///////////////////////////
+//   getOptionalDouble   //
+///////////////////////////
+// 0 means use the default
+static double getOptionalDouble(int nrhs, const mxArray *prhs[], int index)
+{
+  if ((nrhs <= index) || mxIsEmpty(prhs[index]) || !mxIsNumeric(prhs[index]))
+    return 0;
+  return mxGetScalar(prhs[index]);
+}
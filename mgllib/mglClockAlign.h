@@ -0,0 +1,208 @@
+#ifdef documentation
+=========================================================================
+
+  program: mglClockAlign.h
+       by: justin gardner
+     date: 10/19/2026
+copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+  purpose: online linear model relating another clock (a "domain", like
+           the GPU timestamp counter, the eyetracker or a camera) to host
+           time as returned by mglGetSecs, used by mglClockAlign.
+
+           Each paired sample is a domain time and the host time it
+           corresponds to. The model is a line, host = hostReference +
+           slope * (domain - domainReference), so that it captures both
+           the offset between the clocks and the drift of one against the
+           other. It is fit by weighted least squares, where samples are
+           forgotten with a time constant (in host seconds), so the fit
+           follows slow changes in drift. The fit is kept as running sums
+           centered on the weighted mean of the samples, which keeps the
+           numbers small however long the clocks have been running.
+
+           Samples whose residual from the current fit is more than
+           outlierThreshold times the typical residual (the weighted mean
+           absolute residual, scaled to a standard deviation for normal
+           noise) are rejected, so that a sample delayed by a context
+           switch does not pull the fit. If many samples in a row are
+           rejected, the clock must have jumped (e.g. the device was
+           reset), so the model starts over.
+
+           nominalSlope is the expected number of host seconds per
+           domain unit (e.g. 1e-9 for a nanosecond counter). It is the
+           slope used until there are samples spread out enough in time
+           to fit one, and scales domain times so the fit is well
+           conditioned.
+
+           This is plain C with no Matlab dependencies, so that it can be
+           checked on its own with synthetic clocks.
+
+=========================================================================
+#endif
+
+#ifndef MGL_CLOCK_ALIGN_H
+#define MGL_CLOCK_ALIGN_H
+
+/////////////////////////
+//   include section   //
+/////////////////////////
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+//////////////////////
+//   define section //
+//////////////////////
+#define MGL_CLOCK_ALIGN_DEFAULT_TIME_CONSTANT 600.0
+#define MGL_CLOCK_ALIGN_DEFAULT_OUTLIER_THRESHOLD 4.0
+// typical residuals are not taken to be less than this, so that a run of
+// nearly perfect samples doesn't make every later sample an outlier
+#define MGL_CLOCK_ALIGN_MIN_SPREAD 1e-6
+// samples needed before any are rejected, and rejections in a row before starting over
+#define MGL_CLOCK_ALIGN_MIN_SAMPLES 5
+// the mean absolute residual of normal noise is sqrt(2/pi) times its standard deviation
+#define MGL_CLOCK_ALIGN_MAD_TO_SD 1.2533141373155
+
+typedef struct {
+  // settings
+  double nominalSlope;
+  double timeConstant;
+  double outlierThreshold;
+  // the point the fit is centered on, the weighted mean of the samples
+  int hasSamples;
+  double domainReference;
+  double hostReference;
+  double lastHostTime;
+  // exponentially weighted sums of samples relative to the reference, with
+  // domain times scaled by nominalSlope (u) and host times (v)
+  double sumW;
+  double sumUU;
+  double sumUV;
+  // weighted mean absolute residual of accepted samples
+  double meanAbsResidual;
+  // counts
+  uint32_t nSamples;
+  uint32_t nRejected;
+  uint32_t nRejectedInARow;
+} mglClockAlignModel;
+
+///////////////////////////
+//   mglClockAlignInit   //
+///////////////////////////
+static inline void mglClockAlignInit(mglClockAlignModel *model, double nominalSlope, double timeConstant, double outlierThreshold)
+{
+  memset(model, 0, sizeof(mglClockAlignModel));
+  model->nominalSlope = (nominalSlope > 0) ? nominalSlope : 1.0;
+  model->timeConstant = (timeConstant > 0) ? timeConstant : MGL_CLOCK_ALIGN_DEFAULT_TIME_CONSTANT;
+  model->outlierThreshold = (outlierThreshold > 0) ? outlierThreshold : MGL_CLOCK_ALIGN_DEFAULT_OUTLIER_THRESHOLD;
+}
+
+////////////////////////////
+//   mglClockAlignSlope   //
+////////////////////////////
+// Host seconds per domain unit.
+static inline double mglClockAlignSlope(const mglClockAlignModel *model)
+{
+  // need the samples to be spread out over at least a few ms to say anything about drift
+  if ((model->sumW <= 0) || (model->sumUU / model->sumW < 1e-5))
+    return model->nominalSlope;
+  return model->nominalSlope * (model->sumUV / model->sumUU);
+}
+
+/////////////////////////////
+//   mglClockAlignSpread   //
+/////////////////////////////
+// Typical residual of samples from the fit, as a standard deviation in host seconds.
+static inline double mglClockAlignSpread(const mglClockAlignModel *model)
+{
+  double spread = MGL_CLOCK_ALIGN_MAD_TO_SD * model->meanAbsResidual;
+  return (spread > MGL_CLOCK_ALIGN_MIN_SPREAD) ? spread : MGL_CLOCK_ALIGN_MIN_SPREAD;
+}
+
+////////////////////////////
+//   mglClockAlignToHost  //
+////////////////////////////
+static inline void mglClockAlignToHost(const mglClockAlignModel *model, const double *domainTimes, double *hostTimes, size_t n)
+{
+  double slope = mglClockAlignSlope(model);
+  for (size_t i = 0; i < n; i++)
+    hostTimes[i] = model->hostReference + slope * (domainTimes[i] - model->domainReference);
+}
+
+//////////////////////////////
+//   mglClockAlignFromHost  //
+//////////////////////////////
+static inline void mglClockAlignFromHost(const mglClockAlignModel *model, const double *hostTimes, double *domainTimes, size_t n)
+{
+  double slope = mglClockAlignSlope(model);
+  for (size_t i = 0; i < n; i++)
+    domainTimes[i] = model->domainReference + (hostTimes[i] - model->hostReference) / slope;
+}
+
+////////////////////////////
+//   mglClockAlignAdd     //
+////////////////////////////
+// Add one paired sample. Returns 1 if it was used, 0 if it was rejected as an outlier.
+static inline int mglClockAlignAdd(mglClockAlignModel *model, double domainTime, double hostTime)
+{
+  if (!isfinite(domainTime) || !isfinite(hostTime))
+    return 0;
+
+  // the first sample just sets the reference
+  if (!model->hasSamples) {
+    model->hasSamples = 1;
+    model->domainReference = domainTime;
+    model->hostReference = hostTime;
+    model->lastHostTime = hostTime;
+    model->sumW = 1.0;
+    model->nSamples = 1;
+    return 1;
+  }
+
+  // how far the sample is from the current fit
+  double predictedHostTime;
+  mglClockAlignToHost(model, &domainTime, &predictedHostTime, 1);
+  double residual = hostTime - predictedHostTime;
+
+  // reject outliers, unless so many in a row have been rejected that the clock must have jumped
+  if ((model->nSamples >= MGL_CLOCK_ALIGN_MIN_SAMPLES) && (fabs(residual) > model->outlierThreshold * mglClockAlignSpread(model))) {
+    model->nRejected++;
+    model->nRejectedInARow++;
+    if (model->nRejectedInARow < MGL_CLOCK_ALIGN_MIN_SAMPLES)
+      return 0;
+    uint32_t nRejected = model->nRejected;
+    mglClockAlignInit(model, model->nominalSlope, model->timeConstant, model->outlierThreshold);
+    model->nRejected = nRejected;
+    return mglClockAlignAdd(model, domainTime, hostTime);
+  }
+  model->nRejectedInARow = 0;
+
+  // forget old samples according to how much host time has passed
+  if (hostTime > model->lastHostTime) {
+    double decay = exp(-(hostTime - model->lastHostTime) / model->timeConstant);
+    model->sumW *= decay;
+    model->sumUU *= decay;
+    model->sumUV *= decay;
+    model->lastHostTime = hostTime;
+  }
+
+  // keep track of typical residuals, weighted like the samples
+  model->meanAbsResidual = (model->meanAbsResidual * model->sumW + fabs(residual)) / (model->sumW + 1.0);
+
+  // add the sample, relative to the reference
+  double u = (domainTime - model->domainReference) * model->nominalSlope;
+  double v = hostTime - model->hostReference;
+  double sumW = model->sumW + 1.0;
+  // the sums had the reference at their weighted mean, which moves toward the new sample by
+  // 1/sumW of the way, so shift everything to be centered on the new mean (Welford's update)
+  double du = u / sumW;
+  double dv = v / sumW;
+  model->sumUU += u * (u - du);
+  model->sumUV += u * (v - dv);
+  model->sumW = sumW;
+  model->domainReference += du / model->nominalSlope;
+  model->hostReference += dv;
+  model->nSamples++;
+  return 1;
+}
+
+#endif
@@ -0,0 +1,43 @@
+% mglClockAlign: relate other clocks (GPU, eyetracker, camera) to mglGetSecs
+%
+%      usage: info = mglClockAlign('add',clockName,clockTimes,hostTimes,<nominalSlope>)
+%             hostTimes = mglClockAlign('toHost',clockName,clockTimes)
+%             clockTimes = mglClockAlign('fromHost',clockName,hostTimes)
+%             info = mglClockAlign('info',clockName)
+%             info = mglClockAlign('create',clockName,<nominalSlope>,<timeConstant>,<outlierThreshold>)
+%             mglClockAlign('reset',<clockName>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: Keeps a running fit for each named clock of how its times
+%             map to host time (mglGetSecs), so that timestamps from it
+%             can be converted in bulk. Add paired samples (a time on the
+%             clock and the host time of the same moment) whenever you
+%             can get them, and the fit keeps up with the offset and the
+%             drift between the clocks. Old samples are forgotten with a
+%             time constant (default 600 s), and samples that are far off
+%             the fit (more than outlierThreshold, default 4, times the
+%             typical residual) are rejected, unless there are so many in
+%             a row that the clock must have been reset, in which case the
+%             fit starts over.
+%
+%             nominalSlope is the expected host seconds per clock unit,
+%             for example 1e-9 for a clock that counts nanoseconds or 1e-3
+%             for milliseconds. It can be given to 'create' or the first
+%             'add' for a clock. Default is 1.
+%
+%             info has the current slope, driftPPM (how fast the clock runs
+%             compared to nominal, in parts per million), the reference
+%             point of the fit, spread (typical residual in seconds),
+%             nSamples and nRejected.
+%
+%             mglMetalSampleTimestamps adds samples for the clock 'gpu',
+%             and mglCameraThread adds samples for 'camera' and uses the
+%             fit for image times.
+%
+%             % e.g. an eyetracker that counts milliseconds
+%             for i = 1:10
+%               mglClockAlign('add','eyelink',trackerTime(i),hostTime(i),1e-3);
+%             end
+%             sampleHostTimes = mglClockAlign('toHost','eyelink',sampleTrackerTimes);
+%
@@ -35,6 +35,11 @@ if ~isempty(mglFrameGrabTex)
   mglSetParam('mglFrameGrabTex',[]);
 end
 
+% delete the pages of the text glyph cache
+if exist('mglPrivateGlyphCache')==3
+  mglTextCache('clear');
+end
+
 % restore gamma table, if any
 if ~isempty(mglGetParam('initialGammaTable'))
   mglSetGammaTable(mglGetParam('initialGammaTable'));
@@ -65,6 +70,14 @@ if mglGetParam('movieMode'), mglMovie('closeWindow');end
 % But the callback might be delayed if the caller is holding a reference to
 % one of these sockets.  Explicitly shutting down here makes it immediate.
 global mgl
+if isfield(mgl, 'coalesceCommands') && mgl.coalesceCommands
+    mglMetalCoalesceCommands(0);
+end
+if isfield(mgl, 'mirrorFanOut') && mgl.mirrorFanOut
+    mglMirrorFanOut(0);
+end
+% nothing is known about the state of the next mglMetal
+mglPrivateSkipRedundant('invalidate', [], []);
 if isfield(mgl, 's')
     mglMetalShutdown(mgl.s);
 end
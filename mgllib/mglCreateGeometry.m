@@ -0,0 +1,90 @@
+% mglCreateGeometry.m
+%
+%       usage: [geometry, results] = mglCreateGeometry(geometryType, vertices, <socketInfo>)
+%          by: justin gardner
+%        date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%     purpose: Send vertices to mglMetal once, to be kept there and
+%              drawn by number with mglDrawGeometry, so that stimuli
+%              that don't change, or only change a little, do not need
+%              to be sent every frame. Parts of the vertices can be
+%              changed with mglUpdateGeometry, and the geometry freed
+%              with mglDeleteGeometry.
+%
+%              geometryType -- how to draw the vertices:
+%                'triangles': 6 x n [xyz rgb], like mglQuad
+%                'lines': 6 x n [xyz rgb], drawn as separate lines
+%                'triangleStrip': 6 x n [xyz rgb], like mglPolygon
+%                'dots': 11 x n [xyz rgba wh isRound borderSize],
+%                        like mglMetalDots
+%                'instancedLines': 9 x n [x0 y0 x1 y1 width rgba],
+%                                  like mglMetalLines
+%              vertices -- valuesPerVertex x n matrix of vertices
+%
+%              Returns a struct array with one element per active
+%              mirror, for use with mglDrawGeometry.
+%       e.g.:
+%
+% mglOpen;
+% mglVisualAngleCoordinates(57,[16 12]);
+% cross = mglCreateGeometry('triangles',[-2 2 2 -2 2 -2 -0.1 -0.1 0.1 -0.1 0.1 0.1;-0.1 -0.1 0.1 -0.1 0.1 0.1 -2 -2 2 -2 2 -2;zeros(1,12);ones(3,12)]);
+% mglDrawGeometry(cross);
+% mglFlush;
+function [geometry, results] = mglCreateGeometry(geometryType, vertices, socketInfo)
+
+geometry = [];
+results = [];
+if nargin < 2
+    help mglCreateGeometry
+    return
+end
+
+global mgl
+if nargin < 3 || isempty(socketInfo)
+    socketInfo = mgl.activeSockets;
+end
+
+% These need to match mglGeometryType in mglGeometry.swift.
+geometryTypes = {'triangles', 'lines', 'triangleStrip', 'dots', 'instancedLines'};
+valuesPerVertex = [6 6 6 11 9];
+typeIndex = find(strcmpi(geometryType, geometryTypes));
+if isempty(typeIndex)
+    fprintf('(mglCreateGeometry) Unknown geometryType %s\n', geometryType);
+    return
+end
+if size(vertices, 1) ~= valuesPerVertex(typeIndex)
+    fprintf('(mglCreateGeometry) Vertices for %s must have %i rows, not %i\n', geometryTypes{typeIndex}, valuesPerVertex(typeIndex), size(vertices, 1));
+    return
+end
+geometry.geometryType = geometryTypes{typeIndex};
+geometry.valuesPerVertex = valuesPerVertex(typeIndex);
+geometry.nVertices = size(vertices, 2);
+
+% Send the geometry create command and vertices to each socket.
+mglSocketWrite(socketInfo, socketInfo(1).command.mglCreateGeometry);
+ackTime = mglSocketRead(socketInfo, 'double');
+mglSocketWrite(socketInfo, uint32(typeIndex - 1));
+mglSocketWrite(socketInfo, uint32(geometry.nVertices));
+mglSocketWrite(socketInfo, single(vertices(:)));
+
+% Check each socket for processing results.
+responseIncoming = mglSocketRead(socketInfo, 'double');
+geometry = repmat(geometry, 1, numel(socketInfo));
+resultCell = cell([1, numel(socketInfo)]);
+for ii = 1:numel(socketInfo)
+    if (responseIncoming(ii) < 0)
+        % This socket shows an error processing the command.
+        geometry(ii).geometryNumber = -1;
+        resultCell{ii} = mglReadCommandResults(socketInfo(ii), ackTime(1,1,1,ii));
+        fprintf('(mglCreateGeometry) Error creating geometry, you might try again with Console running, or: log stream --level info --process mglMetal\n');
+    else
+        % This socket shows processing was OK, read the response.
+        geometry(ii).geometryNumber = mglSocketRead(socketInfo(ii), 'uint32');
+        numGeometries = mglSocketRead(socketInfo(ii), 'uint32');
+        resultCell{ii} = mglReadCommandResults(socketInfo(ii), ackTime(1,1,1,ii));
+        if isequal(socketInfo(ii), mgl.s)
+            mglSetParam('numGeometries', numGeometries);
+        end
+    end
+end
+results = [resultCell{:}];
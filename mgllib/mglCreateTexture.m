@@ -57,37 +57,48 @@ if nargin < 5 || isempty(socketInfo)
     socketInfo = mgl.activeSockets;
 end
 
-% check for uint textures (not yet supported by mglMetal
-if isequal(class(image),'uint8')
-    % shift dimensions as unit8 was 4xnxm (since that was the direct format
-    % supported by OpenGL
-    image = shiftdim(image,1);
+if (exist('mglSocketWriteTexture')==3) && any(strcmp(class(image),{'double','single','uint8'})) && isreal(image) && ~issparse(image)
+    % mglSocketWriteTexture converts the image to rgba as it sends it
+    % (uint8 rgba x width x height, grayscale and RGB too), so the copies
+    % below are not needed, only the divisor for values from 0 - 255
+    divisor = [];
+    if ~isa(image,'uint8') && (max(image(:)) > 1)
+        divisor = 255;
+    end
+    [texture, results] = mglMetalCreateTexture(image, [], [], [], socketInfo, divisor);
+else
+    % check for uint textures (not yet supported by mglMetal
+    if isequal(class(image),'uint8')
+        % rearrange dimensions as unit8 was rgba x width x height (since that was
+        % the direct format supported by OpenGL) to height x width x rgba
+        image = permute(image,[3 2 1]);
     
-    % need to convert to double
-    image = double(image)/255;
-end
+        % need to convert to double
+        image = double(image)/255;
+    end
 
-% create texture used to be values from 0 - 255
-maxVal = max(image(:));
-if maxVal > 1
-    % JG: THis is not a warning - this was the default behavior of mglCreateTexture
-    %fprintf('(mglCreateTexture) image shold be float-valued with elements in [0 1].  Normalizing by 255\n');
-    image = image / 255;
-end
+    % create texture used to be values from 0 - 255
+    maxVal = max(image(:));
+    if maxVal > 1
+        % JG: THis is not a warning - this was the default behavior of mglCreateTexture
+        %fprintf('(mglCreateTexture) image shold be float-valued with elements in [0 1].  Normalizing by 255\n');
+        image = image / 255;
+    end
 
-% check for grayscale image and convert to RGBA image
-[imageHeight, imageWidth, imageSlices] = size(image);
-if imageSlices == 1
-    % JG: THis is not a warning - this was the default behavior to do
-    % grayscale images
-    %fprintf('(mglCreateTexture) image shold be h x w x 4 rgba.  Resizing (%d x %d) -> (%d x %d x 4).\n', imageHeight, imageWidth, imageHeight, imageWidth);
-    image = cat(3, image, image, image, ones(size(image)));
-elseif imageSlices == 3
-    % convert RGB into RGBA
-    image = cat(3, image, ones(size(image,1:2)));
-end
+    % check for grayscale image and convert to RGBA image
+    [imageHeight, imageWidth, imageSlices] = size(image);
+    if imageSlices == 1
+        % JG: THis is not a warning - this was the default behavior to do
+        % grayscale images
+        %fprintf('(mglCreateTexture) image shold be h x w x 4 rgba.  Resizing (%d x %d) -> (%d x %d x 4).\n', imageHeight, imageWidth, imageHeight, imageWidth);
+        image = cat(3, image, image, image, ones(size(image)));
+    elseif imageSlices == 3
+        % convert RGB into RGBA
+        image = cat(3, image, ones(size(image,1:2)));
+    end
 
-[texture, results] = mglMetalCreateTexture(image, [], [], [], socketInfo);
+    [texture, results] = mglMetalCreateTexture(image, [], [], [], socketInfo);
+end
 
 % check if processedTime is negative which indicates an error
 if any([results.processedTime] < 0)
@@ -0,0 +1,37 @@
+% mglDeleteGeometry.m
+%
+%      usage: [geometry, results] = mglDeleteGeometry(geometry, <socketInfo>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: Deletes geometry made with mglCreateGeometry, freeing up
+%             the memory that mglMetal kept for it.
+%
+%       e.g.:
+% mglOpen;
+% square = mglCreateGeometry('triangles',[-1 1 1 1 -1 -1;-1 -1 1 1 1 -1;zeros(1,6);ones(3,6)]);
+% mglDrawGeometry(square);
+% mglFlush;
+% square = mglDeleteGeometry(square);
+function [geometry, results] = mglDeleteGeometry(geometry, socketInfo)
+
+results = [];
+if nargin < 1
+    help mglDeleteGeometry
+    return
+end
+
+if nargin < 2 || isempty(socketInfo)
+    global mgl
+    socketInfo = mgl.activeSockets;
+end
+
+if isfield(geometry,'geometryNumber')
+    mglSocketWrite(socketInfo, socketInfo(1).command.mglDeleteGeometry);
+    ackTime = mglSocketRead(socketInfo, 'double');
+    mglSocketWrite(socketInfo, uint32(geometry(1).geometryNumber));
+    results = mglReadCommandResults(socketInfo, ackTime);
+    [geometry.geometryNumber] = deal(-1);
+else
+    disp('(mglDeleteGeometry) Input is not a geometry');
+end
@@ -0,0 +1,54 @@
+% mglDrawGeometry.m
+%
+%       usage: results = mglDrawGeometry(geometry, <xform>, <socketInfo>)
+%          by: justin gardner
+%        date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%     purpose: Draw geometry made with mglCreateGeometry. Only the
+%              geometry number (and the transform, if any) is sent.
+%
+%              geometry -- struct returned by mglCreateGeometry
+%              xform -- optional 4x4 transform applied to the geometry,
+%                       after the current coordinates, for this draw
+%                       only. e.g. to move it by [x y]:
+%                       [1 0 0 x;0 1 0 y;0 0 1 0;0 0 0 1]
+%       e.g.:
+%
+% mglOpen;
+% mglVisualAngleCoordinates(57,[16 12]);
+% square = mglCreateGeometry('triangles',[-1 1 1 1 -1 -1;-1 -1 1 1 1 -1;zeros(1,6);ones(3,6)]);
+% mglDrawGeometry(square,[1 0 0 -4;0 1 0 0;0 0 1 0;0 0 0 1]);
+% mglDrawGeometry(square,[1 0 0 4;0 1 0 0;0 0 1 0;0 0 0 1]);
+% mglFlush;
+function results = mglDrawGeometry(geometry, xform, socketInfo)
+
+results = [];
+if nargin < 1
+    help mglDrawGeometry
+    return
+end
+if nargin < 2
+    xform = [];
+end
+if nargin < 3 || isempty(socketInfo)
+    global mgl
+    socketInfo = mgl.activeSockets;
+end
+
+if ~isfield(geometry, 'geometryNumber')
+    disp('(mglDrawGeometry) Input is not a geometry');
+    return
+end
+if ~isempty(xform) && ~isequal(size(xform), [4 4])
+    disp('(mglDrawGeometry) xform must be 4x4');
+    return
+end
+
+mglSocketWrite(socketInfo, socketInfo(1).command.mglDrawGeometry);
+ackTime = mglSocketRead(socketInfo, 'double');
+mglSocketWrite(socketInfo, uint32(geometry(1).geometryNumber));
+mglSocketWrite(socketInfo, uint32(~isempty(xform)));
+if ~isempty(xform)
+    mglSocketWrite(socketInfo, single(xform));
+end
+results = mglReadCommandResults(socketInfo, ackTime);
@@ -11,10 +11,14 @@
 %             mglFlush;
 %             mglClearScreen([0 1 0]);
 %             mglFlush;
+%
+%             With mglMetalCoalesceCommands on, the drawing commands of
+%             the frame are sent here, and results has one element for
+%             each of them, followed by the flush.
 function results = mglFlush(socketInfo)
 
+global mgl
 if nargin < 1 || isempty(socketInfo)
-    global mgl
     socketInfo = mgl.activeSockets;
 end
 
@@ -23,6 +27,11 @@ mglSocketWrite(socketInfo, socketInfo(1).command.mglFlush);
 ackTime = mglSocketRead(socketInfo, 'double');
 results = mglReadCommandResults(socketInfo, ackTime);
 
+% with coalescing, the results of the drawing commands that were just sent come first
+if isfield(mgl, 'coalesceCommands') && mgl.coalesceCommands
+    results = [mglSocketCoalesce(socketInfo); results];
+end
+
 % check if processedTime is negative which indicates an error
 if any([results.processedTime] < 0)
   % display error
@@ -14,6 +14,11 @@
 %      usage: mglFrameGrab('init'); % starts mglFrameGrab
 %             frame = mglFrameGrab; % grabs a frame (run this after drawing and doing mglFlush)
 %             mglFrameGrab('end')   % ends frame grab mode so you can draw to the screen again
+%
+%             Grabbing waits for the whole frame to be read back. To grab many frames, use
+%             mglMetalReadbackIssue after each mglFlush and mglMetalReadbackCollect a frame
+%             later, which reads back while the next frame is drawn, and can read back only
+%             a region, as uint8.
 % 
 %       e.g.: 
 % % open screen
@@ -0,0 +1,99 @@
+% mglFrameStats: summarize frame timing: dropped frames, late frames and jitter
+%
+%      usage: stats = mglFrameStats(<telemetry>, <frameRate>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: Summarizes frame telemetry from mglMetalGetFrameTelemetry
+%             (which is called to get all the frames still in mglMetal's
+%             buffer if telemetry is not passed in). frameRate defaults to
+%             mglGetParam('frameRate'), or if that is not set, is estimated
+%             from the frames' vsync target times. Returns a struct with
+%             one element per element of telemetry, with fields:
+%
+%               nFrames - how many frames were summarized
+%               nPending - frames not known to be presented yet
+%               nDropped - frames the system says were never presented
+%               nSkippedRefreshes - refreshes between presented frames
+%                       that showed no new frame. This counts dropped
+%                       frames when you draw every frame, but also counts
+%                       refreshes you chose not to draw.
+%               nLate - frames presented more than half a refresh after
+%                       their vsync target
+%               framePeriod - the refresh period in seconds
+%               intervalJitter - percentiles of the difference between
+%                       each presented interval and the refresh period
+%               latency - percentiles of time from commit to presentation
+%               gpuTime - percentiles of time the GPU spent on each frame
+%               percentiles - the percentiles above: [50 90 95 99 100]
+%
+%             Jitter, latency and GPU times are in seconds. With no
+%             output arguments, prints a summary.
+%
+%             mglOpen;
+%             for iFrame = 1:600, mglClearScreen(rand(1,3));mglFlush;end
+%             mglFrameStats;
+%
+function stats = mglFrameStats(telemetry, frameRate)
+
+if nargin < 1 || isempty(telemetry)
+  telemetry = mglMetalGetFrameTelemetry;
+end
+if nargin < 2 || isempty(frameRate)
+  frameRate = mglGetParam('frameRate');
+end
+
+percentiles = [50 90 95 99 100];
+for ii = 1:numel(telemetry)
+  t = telemetry(ii);
+
+  % get the refresh period, estimating it from vsync targets if need be
+  targetTimes = t.targetTime(t.targetTime > 0);
+  if ~isempty(frameRate) && (frameRate > 0)
+    framePeriod = 1/frameRate;
+  elseif length(targetTimes) > 1
+    framePeriod = median(diff(targetTimes));
+  else
+    framePeriod = nan;
+  end
+
+  % presented is -1 until it is known, and 0 if the frame was dropped
+  isPresented = t.presented > 0;
+  presentedTimes = sort(t.presented(isPresented));
+  intervals = diff(presentedTimes);
+
+  stats(ii).nFrames = length(t.frameNumber);
+  stats(ii).nPending = sum(t.presented < 0);
+  stats(ii).nDropped = sum(t.presented == 0);
+  stats(ii).nSkippedRefreshes = sum(max(0, round(intervals/framePeriod) - 1));
+  isTargeted = isPresented & (t.targetTime > 0);
+  stats(ii).nLate = sum((t.presented(isTargeted) - t.targetTime(isTargeted)) > framePeriod/2);
+  stats(ii).framePeriod = framePeriod;
+  stats(ii).intervalJitter = framePercentiles(intervals - framePeriod, percentiles);
+  stats(ii).latency = framePercentiles(t.presented(isPresented) - t.committed(isPresented), percentiles);
+  isGpuDone = t.gpuEnd > 0;
+  stats(ii).gpuTime = framePercentiles(t.gpuEnd(isGpuDone) - t.gpuStart(isGpuDone), percentiles);
+  stats(ii).percentiles = percentiles;
+
+  % print out a summary
+  if nargout == 0
+    disp(sprintf('(mglFrameStats) %i frames at %0.2f Hz: %i dropped, %i skipped refreshes, %i late, %i pending', stats(ii).nFrames, 1/framePeriod, stats(ii).nDropped, stats(ii).nSkippedRefreshes, stats(ii).nLate, stats(ii).nPending));
+    disp(sprintf('(mglFrameStats) Percentiles: %s', mat2str(percentiles)));
+    disp(sprintf('(mglFrameStats)   interval jitter (ms): %s', mat2str(1000*stats(ii).intervalJitter, 3)));
+    disp(sprintf('(mglFrameStats)   commit to present (ms): %s', mat2str(1000*stats(ii).latency, 3)));
+    disp(sprintf('(mglFrameStats)   GPU time (ms): %s', mat2str(1000*stats(ii).gpuTime, 3)));
+  end
+end
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%    framePercentiles    %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%
+% nearest-rank percentiles, so as not to need the statistics toolbox
+function values = framePercentiles(x, percentiles)
+
+x = sort(x(:))';
+if isempty(x)
+  values = nan(size(percentiles));
+  return
+end
+values = x(max(1, ceil(percentiles/100 * length(x))));
@@ -0,0 +1,71 @@
+% mglFrameStreamWrite: write precomputed frames to a file mglMetal can stream
+%
+%      usage: [filename, ok] = mglFrameStreamWrite(filename, frames, <frameRate>, <runLength>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: Writes a movie of precomputed stimulus frames to a frame
+%             stream file, which mglMetalFrameStreamOpen maps into memory
+%             and mglMetalFrameStreamShowFrame shows one exact frame at a
+%             time. Unlike making a texture of every frame, which takes
+%             GPU memory for all of them, or updating one texture every
+%             frame, which sends each frame over the socket, mglMetal
+%             decodes the next few frames on a background thread onto a
+%             ring of textures, so movies of any length can be shown
+%             without dropping frames.
+%
+%             frames is height x width x channels x n, or a cell array of
+%             n frames each height x width x channels, with 1 (gray),
+%             3 (rgb) or 4 (rgba) channels. uint8 and double frames are
+%             written with 8 bits per channel, double as 0-1 (or 0-255 if
+%             any value is bigger than 1). single frames, 0-1, are
+%             written as floats, four times as big, for when 8 bits is
+%             not enough (e.g. low contrast gratings).
+%
+%             frameRate is kept in the file for reference (default
+%             mglGetParam('frameRate'), or 60). With runLength (default
+%             true), frames that are smaller run length encoded are
+%             written that way, which shrinks frames with large areas
+%             of one color, like a stimulus on a gray background, and
+%             costs little to decode.
+%
+%             mglMetal runs in a sandbox, so the file goes in the sandbox
+%             folder (see mglMetalExecutableName) unless it is a full path
+%             within it. Returns the full path to the file.
+%
+%             [x y] = meshgrid(-2:1/64:2);
+%             for i = 1:240
+%               frames(:,:,1,i) = uint8(127.5+127.5*sin(2*pi*(x+i/60)).*exp(-(x.^2+y.^2)));
+%             end
+%             filename = mglFrameStreamWrite('grating.frames', frames);
+%
+function [filename, ok] = mglFrameStreamWrite(filename, frames, frameRate, runLength)
+
+% check arguments
+ok = false;
+if ~any(nargin == [2 3 4])
+  help mglFrameStreamWrite
+  return
+end
+
+% check that the writer is compiled
+if exist('mglPrivateFrameStreamWrite')~=3
+  disp(sprintf('(mglFrameStreamWrite) mglPrivateFrameStreamWrite is not compiled. Run mglMakeMetal'));
+  return
+end
+
+if nargin < 3 || isempty(frameRate)
+  frameRate = mglGetParam('frameRate');
+  if isempty(frameRate), frameRate = 60; end
+end
+if nargin < 4 || isempty(runLength), runLength = true; end
+
+% put the file in the sandbox where mglMetal can read it
+[~, mglMetalSandbox] = mglMetalExecutableName;
+if ~startsWith(filename, mglMetalSandbox)
+  [~, name, ext] = fileparts(filename);
+  if isempty(ext), ext = '.frames'; end
+  filename = fullfile(mglMetalSandbox, [name ext]);
+end
+
+ok = logical(mglPrivateFrameStreamWrite(filename, frames, double(frameRate), double(runLength)));
@@ -0,0 +1,405 @@
+#ifdef documentation
+=========================================================================
+
+  program: mglGlyphCache.h
+       by: justin gardner
+     date: 10/19/2026
+copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+  purpose: a cache of the images of single characters (glyphs) on atlas
+           pages, so that text can be drawn as one glyph quad for each
+           character, all with one mglMetalBltSprites command, and only
+           characters that have not been drawn before in that font need
+           to be rendered and sent to mglMetal. Making a texture for each
+           string (mglText) renders and sends the whole string every time
+           it changes, like a counter that changes every frame.
+
+           Fonts are named by a string, which should have everything that
+           changes how a glyph looks (mglTextCache uses the font name,
+           size, bold, italic and color), and numbered in the order they
+           are first used. A glyph is the ink of one character, its size
+           and where it is relative to the pen, the top left of the line
+           it is on, and how far it moves the pen to the right (advance).
+           Glyphs with no ink, like space, are kept for their advance.
+
+           Glyphs are packed onto pages as they come with the skyline
+           packer of mglAtlasPacker.h, opening a new page when one does
+           not fit on any open page. When maxPages are full, the caller
+           flushes the cache, which empties all the pages but keeps the
+           fonts, and adds the glyphs it needs again. Text uses a few
+           hundred glyphs at most, so this is rare, and much simpler than
+           freeing space in the middle of a skyline.
+
+           Layout puts the glyphs of a string next to each other, with
+           '\n' starting a new line, and aligns each line and the whole
+           block as mglBltTexture does, -1 left or top, 0 center and 1
+           right or bottom. Glyphs are looked up in an open addressing
+           hash table of font and character, so layout is a few
+           nanoseconds a character.
+
+           This is plain C with no Matlab dependencies, see
+           mglBenchmark/mglBenchmarkGlyphCache.c for a standalone test
+           and benchmark.
+
+=========================================================================
+#endif
+
+#ifndef MGL_GLYPH_CACHE_H
+#define MGL_GLYPH_CACHE_H
+
+/////////////////////////
+//   include section   //
+/////////////////////////
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mglAtlasPacker.h"
+
+// what mglGlyphCacheAdd returns when the pages are full, or memory could not be had
+#define MGL_GLYPH_CACHE_FULL -1
+#define MGL_GLYPH_CACHE_NO_MEMORY -2
+
+typedef struct {
+  uint32_t font;
+  uint32_t codepoint;
+  // page the ink is on, -1 for glyphs with no ink, like space
+  int32_t page;
+  // top left of the ink on its page, inside its padding, and its size in pixels
+  uint32_t x;
+  uint32_t y;
+  uint32_t width;
+  uint32_t height;
+  // top left of the ink relative to the pen, +y going down, and how far the pen moves
+  float left;
+  float top;
+  float advance;
+} mglGlyph;
+
+typedef struct {
+  char *name;
+  float lineHeight;
+} mglGlyphFont;
+
+// a glyph placed by layout, x and y are the top left of the ink, +y going down
+typedef struct {
+  float x;
+  float y;
+  float width;
+  float height;
+  float u0;
+  float v0;
+  float u1;
+  float v1;
+  int32_t page;
+} mglGlyphQuad;
+
+typedef struct {
+  uint32_t pageWidth;
+  uint32_t pageHeight;
+  uint32_t padding;
+  uint32_t maxPages;
+  mglAtlasSkyline *skylines;
+  uint32_t pageCount;
+  mglGlyph *glyphs;
+  uint32_t glyphCount;
+  uint32_t glyphCapacity;
+  // index of each glyph + 1, 0 for empty, size is a power of 2 at least twice glyphCount
+  uint32_t *table;
+  uint32_t tableSize;
+  mglGlyphFont *fonts;
+  uint32_t fontCount;
+  uint32_t fontCapacity;
+  // counted by layout, for each character looked up, and by flush
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t flushes;
+} mglGlyphCache;
+
+//////////////////////////
+//   mglGlyphCacheHash  //
+//////////////////////////
+static inline uint32_t mglGlyphCacheHash(uint32_t font, uint32_t codepoint)
+{
+  uint64_t key = ((uint64_t)font << 32) | codepoint;
+  key ^= key >> 33;
+  key *= 0xff51afd7ed558ccdULL;
+  key ^= key >> 33;
+  return (uint32_t)key;
+}
+
+//////////////////////////
+//   mglGlyphCacheInit  //
+//////////////////////////
+// An empty cache with pages of pageWidth x pageHeight, padding pixels around each glyph,
+// and at most maxPages pages. Returns 0 if memory could not be had.
+static inline int mglGlyphCacheInit(mglGlyphCache *cache, uint32_t pageWidth, uint32_t pageHeight, uint32_t padding, uint32_t maxPages)
+{
+  memset(cache, 0, sizeof(mglGlyphCache));
+  cache->pageWidth = pageWidth;
+  cache->pageHeight = pageHeight;
+  cache->padding = padding;
+  cache->maxPages = maxPages;
+  cache->tableSize = 256;
+  cache->table = (uint32_t *)calloc(cache->tableSize, sizeof(uint32_t));
+  return cache->table != NULL;
+}
+
+///////////////////////////
+//   mglGlyphCacheFlush  //
+///////////////////////////
+// Empty all the glyphs and pages, but keep the fonts, so their numbers stay the same.
+static inline void mglGlyphCacheFlush(mglGlyphCache *cache)
+{
+  uint32_t i;
+  for (i = 0; i < cache->pageCount; i++)
+    free(cache->skylines[i].segments);
+  cache->pageCount = 0;
+  cache->glyphCount = 0;
+  if (cache->table != NULL)
+    memset(cache->table, 0, cache->tableSize * sizeof(uint32_t));
+  cache->flushes++;
+}
+
+//////////////////////////
+//   mglGlyphCacheFree  //
+//////////////////////////
+static inline void mglGlyphCacheFree(mglGlyphCache *cache)
+{
+  mglGlyphCacheFlush(cache);
+  uint32_t i;
+  for (i = 0; i < cache->fontCount; i++)
+    free(cache->fonts[i].name);
+  free(cache->fonts);
+  free(cache->skylines);
+  free(cache->glyphs);
+  free(cache->table);
+  memset(cache, 0, sizeof(mglGlyphCache));
+}
+
+//////////////////////////
+//   mglGlyphCacheFont  //
+//////////////////////////
+// The number of the font with this name, added if it is new. Returns -1 if memory could not be had.
+static inline int32_t mglGlyphCacheFont(mglGlyphCache *cache, const char *name)
+{
+  uint32_t i;
+  for (i = 0; i < cache->fontCount; i++)
+    if (!strcmp(cache->fonts[i].name, name)) return (int32_t)i;
+
+  if (cache->fontCount == cache->fontCapacity) {
+    uint32_t newCapacity = cache->fontCapacity ? 2 * cache->fontCapacity : 8;
+    mglGlyphFont *newFonts = (mglGlyphFont *)realloc(cache->fonts, newCapacity * sizeof(mglGlyphFont));
+    if (newFonts == NULL) return -1;
+    cache->fonts = newFonts;
+    cache->fontCapacity = newCapacity;
+  }
+  size_t length = strlen(name);
+  char *copy = (char *)malloc(length + 1);
+  if (copy == NULL) return -1;
+  memcpy(copy, name, length + 1);
+  cache->fonts[cache->fontCount].name = copy;
+  cache->fonts[cache->fontCount].lineHeight = 0;
+  return (int32_t)cache->fontCount++;
+}
+
+//////////////////////////
+//   mglGlyphCacheFind  //
+//////////////////////////
+// The index of the glyph of this character in this font, or -1 if it is not cached.
+static inline int32_t mglGlyphCacheFind(const mglGlyphCache *cache, uint32_t font, uint32_t codepoint)
+{
+  uint32_t mask = cache->tableSize - 1;
+  uint32_t slot = mglGlyphCacheHash(font, codepoint) & mask;
+  while (cache->table[slot]) {
+    const mglGlyph *glyph = &cache->glyphs[cache->table[slot] - 1];
+    if ((glyph->codepoint == codepoint) && (glyph->font == font)) return (int32_t)(cache->table[slot] - 1);
+    slot = (slot + 1) & mask;
+  }
+  return -1;
+}
+
+/////////////////////////////
+//   mglGlyphCacheMissing  //
+/////////////////////////////
+// The characters of a string that are not cached in this font, each once, in the order they
+// first come, and not '\n'. missing must have room for n. Returns how many there are.
+static inline uint32_t mglGlyphCacheMissing(const mglGlyphCache *cache, uint32_t font, const uint32_t *codepoints, uint32_t n, uint32_t *missing)
+{
+  uint32_t nMissing = 0, i, j;
+  for (i = 0; i < n; i++) {
+    if ((codepoints[i] == '\n') || (mglGlyphCacheFind(cache, font, codepoints[i]) >= 0)) continue;
+    for (j = 0; j < nMissing; j++)
+      if (missing[j] == codepoints[i]) break;
+    if (j == nMissing) missing[nMissing++] = codepoints[i];
+  }
+  return nMissing;
+}
+
+///////////////////////////////
+//   mglGlyphCacheGrowTable  //
+///////////////////////////////
+static inline int mglGlyphCacheGrowTable(mglGlyphCache *cache)
+{
+  uint32_t newSize = 2 * cache->tableSize;
+  uint32_t *newTable = (uint32_t *)calloc(newSize, sizeof(uint32_t));
+  if (newTable == NULL) return 0;
+  uint32_t i;
+  for (i = 0; i < cache->glyphCount; i++) {
+    uint32_t slot = mglGlyphCacheHash(cache->glyphs[i].font, cache->glyphs[i].codepoint) & (newSize - 1);
+    while (newTable[slot]) slot = (slot + 1) & (newSize - 1);
+    newTable[slot] = i + 1;
+  }
+  free(cache->table);
+  cache->table = newTable;
+  cache->tableSize = newSize;
+  return 1;
+}
+
+///////////////////////////
+//   mglGlyphCachePlace  //
+///////////////////////////
+// Find room for width x height of ink on the first page it fits, opening a new page if
+// there is none. Returns MGL_GLYPH_CACHE_FULL if all maxPages are full.
+static inline int mglGlyphCachePlace(mglGlyphCache *cache, uint32_t width, uint32_t height, mglGlyph *glyph)
+{
+  uint32_t paddedWidth = width + 2 * cache->padding, paddedHeight = height + 2 * cache->padding;
+  if ((paddedWidth > cache->pageWidth) || (paddedHeight > cache->pageHeight)) return MGL_GLYPH_CACHE_FULL;
+
+  uint32_t page, segment = 0, y = 0;
+  for (page = 0; page < cache->pageCount; page++)
+    if (mglAtlasSkylineChoose(&cache->skylines[page], paddedWidth, paddedHeight, cache->pageWidth, cache->pageHeight, &segment, &y)) break;
+
+  if (page == cache->pageCount) {
+    if (cache->pageCount == cache->maxPages) return MGL_GLYPH_CACHE_FULL;
+    if (cache->skylines == NULL) {
+      cache->skylines = (mglAtlasSkyline *)calloc(cache->maxPages, sizeof(mglAtlasSkyline));
+      if (cache->skylines == NULL) return MGL_GLYPH_CACHE_NO_MEMORY;
+    }
+    // a skyline has at most one segment for each column of the page
+    mglAtlasSkyline *skyline = &cache->skylines[page];
+    skyline->segments = (mglAtlasSegment *)malloc(cache->pageWidth * sizeof(mglAtlasSegment));
+    if (skyline->segments == NULL) return MGL_GLYPH_CACHE_NO_MEMORY;
+    skyline->segments[0].x = 0;
+    skyline->segments[0].y = 0;
+    skyline->segments[0].width = cache->pageWidth;
+    skyline->segmentCount = 1;
+    cache->pageCount++;
+    segment = 0;
+    y = 0;
+  }
+
+  glyph->page = (int32_t)page;
+  glyph->x = cache->skylines[page].segments[segment].x + cache->padding;
+  glyph->y = y + cache->padding;
+  mglAtlasSkylineAdd(&cache->skylines[page], segment, y, paddedWidth, paddedHeight);
+  return 0;
+}
+
+/////////////////////////
+//   mglGlyphCacheAdd  //
+/////////////////////////
+// Add the glyph of a character in a font, with width x height of ink (0 x 0 for none) at
+// left, top from the pen and moving the pen by advance, from a line lineHeight high. Returns
+// the index of the glyph, which is the one already cached if there is one, or
+// MGL_GLYPH_CACHE_FULL if it does not fit on maxPages, or MGL_GLYPH_CACHE_NO_MEMORY.
+static inline int32_t mglGlyphCacheAdd(mglGlyphCache *cache, uint32_t font, uint32_t codepoint, uint32_t width, uint32_t height, float left, float top, float advance, float lineHeight)
+{
+  if (font >= cache->fontCount) return MGL_GLYPH_CACHE_NO_MEMORY;
+  int32_t found = mglGlyphCacheFind(cache, font, codepoint);
+  if (found >= 0) return found;
+
+  if (2 * (cache->glyphCount + 1) > cache->tableSize)
+    if (!mglGlyphCacheGrowTable(cache)) return MGL_GLYPH_CACHE_NO_MEMORY;
+  if (cache->glyphCount == cache->glyphCapacity) {
+    uint32_t newCapacity = cache->glyphCapacity ? 2 * cache->glyphCapacity : 128;
+    mglGlyph *newGlyphs = (mglGlyph *)realloc(cache->glyphs, newCapacity * sizeof(mglGlyph));
+    if (newGlyphs == NULL) return MGL_GLYPH_CACHE_NO_MEMORY;
+    cache->glyphs = newGlyphs;
+    cache->glyphCapacity = newCapacity;
+  }
+
+  mglGlyph *glyph = &cache->glyphs[cache->glyphCount];
+  glyph->font = font;
+  glyph->codepoint = codepoint;
+  glyph->page = -1;
+  glyph->x = glyph->y = 0;
+  if ((width == 0) || (height == 0))
+    width = height = 0;
+  else {
+    int placed = mglGlyphCachePlace(cache, width, height, glyph);
+    if (placed < 0) return placed;
+  }
+  glyph->width = width;
+  glyph->height = height;
+  glyph->left = left;
+  glyph->top = top;
+  glyph->advance = advance;
+  if (lineHeight > cache->fonts[font].lineHeight) cache->fonts[font].lineHeight = lineHeight;
+
+  uint32_t mask = cache->tableSize - 1;
+  uint32_t slot = mglGlyphCacheHash(font, codepoint) & mask;
+  while (cache->table[slot]) slot = (slot + 1) & mask;
+  cache->table[slot] = cache->glyphCount + 1;
+  return (int32_t)cache->glyphCount++;
+}
+
+////////////////////////////
+//   mglGlyphCacheLayout  //
+////////////////////////////
+// Lay out a string in a font as one quad for each glyph with ink, in pixels from the position
+// the text is aligned to, +y going down. hAlignment is -1 left, 0 center or 1 right, and lines
+// are each aligned this way. vAlignment is -1 top, 0 center or 1 bottom of the block of lines.
+// quads must have room for n. Characters that are not cached are left out and counted as misses.
+// width and height are the size of the block. Returns the number of quads.
+static inline uint32_t mglGlyphCacheLayout(mglGlyphCache *cache, uint32_t font, const uint32_t *codepoints, uint32_t n, int hAlignment, int vAlignment, mglGlyphQuad *quads, float *width, float *height)
+{
+  *width = *height = 0;
+  if (font >= cache->fontCount) return 0;
+  float lineHeight = cache->fonts[font].lineHeight;
+  float penX = 0, penY = 0;
+  float uScale = 1.0f / cache->pageWidth, vScale = 1.0f / cache->pageHeight;
+  uint32_t nQuads = 0, lineStart = 0, nLines = 1, i, j;
+  for (i = 0; i <= n; i++) {
+    // end of a line, align it
+    if ((i == n) || (codepoints[i] == '\n')) {
+      float shift = (hAlignment < 0) ? 0 : ((hAlignment > 0) ? -penX : -penX / 2);
+      for (j = lineStart; j < nQuads; j++)
+        quads[j].x += shift;
+      if (penX > *width) *width = penX;
+      if (i == n) break;
+      penX = 0;
+      penY += lineHeight;
+      lineStart = nQuads;
+      nLines++;
+      continue;
+    }
+    int32_t index = mglGlyphCacheFind(cache, font, codepoints[i]);
+    if (index < 0) {
+      cache->misses++;
+      continue;
+    }
+    cache->hits++;
+    const mglGlyph *glyph = &cache->glyphs[index];
+    if (glyph->page >= 0) {
+      mglGlyphQuad *quad = &quads[nQuads++];
+      quad->x = penX + glyph->left;
+      quad->y = penY + glyph->top;
+      quad->width = (float)glyph->width;
+      quad->height = (float)glyph->height;
+      quad->u0 = glyph->x * uScale;
+      quad->v0 = glyph->y * vScale;
+      quad->u1 = (glyph->x + glyph->width) * uScale;
+      quad->v1 = (glyph->y + glyph->height) * vScale;
+      quad->page = glyph->page;
+    }
+    penX += glyph->advance;
+  }
+
+  // align the block
+  *height = nLines * lineHeight;
+  float shift = (vAlignment < 0) ? 0 : ((vAlignment > 0) ? -*height : -*height / 2);
+  for (j = 0; j < nQuads; j++)
+    quads[j].y += shift;
+  return nQuads;
+}
+
+#endif // MGL_GLYPH_CACHE_H
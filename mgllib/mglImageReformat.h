@@ -0,0 +1,253 @@
+#ifdef documentation
+=========================================================================
+
+  program: mglImageReformat.h
+       by: justin gardner
+     date: 10/19/2026
+copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+  purpose: converts a Matlab image of doubles (height x width, height x
+           width x 3 or height x width x 4, column-major, values 0-255) to
+           rgba bytes with the top row first, the layout that
+           mglPrivateCreateTexture gives to OpenGL.
+
+           Going through the image a column at a time writes a byte at a
+           time a whole output row apart, which misses the cache on every
+           pixel of a large image. Instead the image is done in tiles. In
+           each tile, pixels are converted and packed down each column,
+           where the doubles are contiguous, into a small buffer, and then
+           the buffer is transposed 4x4 pixels at a time into whole
+           output rows. Both steps use SSE2 (with AVX loads when the
+           compiler has them) or NEON, with a scalar fallback, and tiles
+           can be split across threads.
+
+           Each value becomes the low 8 bits of the value truncated to an
+           integer, as the (GLubyte) cast did on Intel, so the result is
+           the same as before for anything up to 2^31, and bit-identical
+           on every path for values 0-255 (including fractions). Values
+           outside that were undefined for the cast, and are not checked.
+
+           This is plain C with no Matlab dependencies, see
+           mglBenchmark/mglBenchmarkImageReformat.c for a standalone
+           test and benchmark.
+
+=========================================================================
+#endif
+
+#ifndef MGL_IMAGE_REFORMAT_H
+#define MGL_IMAGE_REFORMAT_H
+
+/////////////////////////
+//   include section   //
+/////////////////////////
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+//////////////////////
+//   define section //
+//////////////////////
+// tiles are this many rows by columns, so that a tile of packed pixels (16K) stays in L1, and
+// each column of a tile reads long enough runs of doubles to keep the prefetcher going
+#define MGL_IMAGE_REFORMAT_TILE_ROWS 128
+#define MGL_IMAGE_REFORMAT_TILE_COLUMNS 32
+#define MGL_IMAGE_REFORMAT_MAX_THREADS 64
+// images smaller than this many pixels for each thread are not worth another thread
+#define MGL_IMAGE_REFORMAT_PIXELS_PER_THREAD 65536
+
+typedef struct {
+  const double *image;
+  size_t height;
+  size_t width;
+  int nChannels;
+  uint8_t *output;
+  size_t tilesAcross;
+  size_t nTiles;
+  size_t nextTile;
+} mglImageReformatWork;
+
+//////////////////////////////
+//   mglImageReformatPixel  //
+//////////////////////////////
+// One pixel, packed as rgba bytes in a little-endian uint32, as the scalar fallback.
+static inline uint32_t mglImageReformatPixel(const double *image, size_t index, size_t imageSize, int nChannels)
+{
+  uint32_t r = (uint8_t)(int32_t)image[index];
+  if (nChannels == 1)
+    return r | (r << 8) | (r << 16) | 0xFF000000u;
+  uint32_t g = (uint8_t)(int32_t)image[index + imageSize];
+  uint32_t b = (uint8_t)(int32_t)image[index + 2 * imageSize];
+  uint32_t a = (nChannels == 4) ? (uint8_t)(int32_t)image[index + 3 * imageSize] : 0xFF;
+  return r | (g << 8) | (b << 16) | (a << 24);
+}
+
+///////////////////////////////
+//   mglImageReformatColumn  //
+///////////////////////////////
+// Pack n pixels down a column, from index in the image, into packed.
+static inline void mglImageReformatColumn(const double *image, size_t index, size_t imageSize, int nChannels, size_t n, uint32_t *packed)
+{
+  size_t i = 0;
+#if defined(__SSE2__)
+  const __m128i lowByte = _mm_set1_epi32(0xFF);
+  const __m128i opaque = _mm_set1_epi32((int)0xFF000000u);
+  for (; i + 4 <= n; i += 4) {
+    __m128i channel[4];
+    for (int c = 0; c < ((nChannels == 1) ? 1 : nChannels); c++) {
+      const double *p = image + index + i + c * imageSize;
+#if defined(__AVX__)
+      channel[c] = _mm_and_si128(_mm256_cvttpd_epi32(_mm256_loadu_pd(p)), lowByte);
+#else
+      channel[c] = _mm_and_si128(_mm_unpacklo_epi64(_mm_cvttpd_epi32(_mm_loadu_pd(p)), _mm_cvttpd_epi32(_mm_loadu_pd(p + 2))), lowByte);
+#endif
+    }
+    if (nChannels == 1) {
+      channel[1] = channel[0];
+      channel[2] = channel[0];
+    }
+    __m128i pixels = _mm_or_si128(channel[0], _mm_or_si128(_mm_slli_epi32(channel[1], 8), _mm_slli_epi32(channel[2], 16)));
+    pixels = _mm_or_si128(pixels, (nChannels == 4) ? _mm_slli_epi32(channel[3], 24) : opaque);
+    _mm_storeu_si128((__m128i *)(packed + i), pixels);
+  }
+#elif defined(__ARM_NEON)
+  const uint32x4_t lowByte = vdupq_n_u32(0xFF);
+  const uint32x4_t opaque = vdupq_n_u32(0xFF000000u);
+  for (; i + 4 <= n; i += 4) {
+    uint32x4_t channel[4];
+    for (int c = 0; c < ((nChannels == 1) ? 1 : nChannels); c++) {
+      const double *p = image + index + i + c * imageSize;
+      // truncate to 64 bits and keep the low 32, which is the same as truncating to 32 bits up to 2^31
+      int32x4_t truncated = vcombine_s32(vmovn_s64(vcvtq_s64_f64(vld1q_f64(p))), vmovn_s64(vcvtq_s64_f64(vld1q_f64(p + 2))));
+      channel[c] = vandq_u32(vreinterpretq_u32_s32(truncated), lowByte);
+    }
+    if (nChannels == 1) {
+      channel[1] = channel[0];
+      channel[2] = channel[0];
+    }
+    uint32x4_t pixels = vorrq_u32(channel[0], vorrq_u32(vshlq_n_u32(channel[1], 8), vshlq_n_u32(channel[2], 16)));
+    pixels = vorrq_u32(pixels, (nChannels == 4) ? vshlq_n_u32(channel[3], 24) : opaque);
+    vst1q_u32(packed + i, pixels);
+  }
+#endif
+  for (; i < n; i++)
+    packed[i] = mglImageReformatPixel(image, index + i, imageSize, nChannels);
+}
+
+//////////////////////////////////
+//   mglImageReformatTranspose  //
+//////////////////////////////////
+// Write a tile of packed pixels, stored a column at a time, into rows of the output.
+static inline void mglImageReformatTranspose(const uint32_t *packed, size_t rows, size_t columns, uint8_t *output, size_t outputRowBytes)
+{
+  const size_t tile = MGL_IMAGE_REFORMAT_TILE_ROWS;
+  size_t i = 0, j;
+#if defined(__SSE2__) || defined(__ARM_NEON)
+  // 4x4 blocks of pixels
+  for (; i + 4 <= rows; i += 4) {
+    for (j = 0; j + 4 <= columns; j += 4) {
+      const uint32_t *in = packed + j * tile + i;
+#if defined(__SSE2__)
+      __m128i c0 = _mm_loadu_si128((const __m128i *)in);
+      __m128i c1 = _mm_loadu_si128((const __m128i *)(in + tile));
+      __m128i c2 = _mm_loadu_si128((const __m128i *)(in + 2 * tile));
+      __m128i c3 = _mm_loadu_si128((const __m128i *)(in + 3 * tile));
+      __m128i t0 = _mm_unpacklo_epi32(c0, c1), t1 = _mm_unpackhi_epi32(c0, c1);
+      __m128i t2 = _mm_unpacklo_epi32(c2, c3), t3 = _mm_unpackhi_epi32(c2, c3);
+      _mm_storeu_si128((__m128i *)(output + i * outputRowBytes + 4 * j), _mm_unpacklo_epi64(t0, t2));
+      _mm_storeu_si128((__m128i *)(output + (i + 1) * outputRowBytes + 4 * j), _mm_unpackhi_epi64(t0, t2));
+      _mm_storeu_si128((__m128i *)(output + (i + 2) * outputRowBytes + 4 * j), _mm_unpacklo_epi64(t1, t3));
+      _mm_storeu_si128((__m128i *)(output + (i + 3) * outputRowBytes + 4 * j), _mm_unpackhi_epi64(t1, t3));
+#else
+      uint32x4_t c0 = vld1q_u32(in), c1 = vld1q_u32(in + tile);
+      uint32x4_t c2 = vld1q_u32(in + 2 * tile), c3 = vld1q_u32(in + 3 * tile);
+      uint32x4_t t0 = vzip1q_u32(c0, c1), t1 = vzip2q_u32(c0, c1);
+      uint32x4_t t2 = vzip1q_u32(c2, c3), t3 = vzip2q_u32(c2, c3);
+      vst1q_u32((uint32_t *)(output + i * outputRowBytes + 4 * j), vreinterpretq_u32_u64(vzip1q_u64(vreinterpretq_u64_u32(t0), vreinterpretq_u64_u32(t2))));
+      vst1q_u32((uint32_t *)(output + (i + 1) * outputRowBytes + 4 * j), vreinterpretq_u32_u64(vzip2q_u64(vreinterpretq_u64_u32(t0), vreinterpretq_u64_u32(t2))));
+      vst1q_u32((uint32_t *)(output + (i + 2) * outputRowBytes + 4 * j), vreinterpretq_u32_u64(vzip1q_u64(vreinterpretq_u64_u32(t1), vreinterpretq_u64_u32(t3))));
+      vst1q_u32((uint32_t *)(output + (i + 3) * outputRowBytes + 4 * j), vreinterpretq_u32_u64(vzip2q_u64(vreinterpretq_u64_u32(t1), vreinterpretq_u64_u32(t3))));
+#endif
+    }
+    // columns left over at the right of the tile
+    for (; j < columns; j++)
+      for (size_t k = 0; k < 4; k++)
+        memcpy(output + (i + k) * outputRowBytes + 4 * j, packed + j * tile + i + k, 4);
+  }
+#endif
+  // rows left over at the bottom of the tile
+  for (; i < rows; i++)
+    for (j = 0; j < columns; j++)
+      memcpy(output + i * outputRowBytes + 4 * j, packed + j * tile + i, 4);
+}
+
+//////////////////////////////
+//   mglImageReformatTiles  //
+//////////////////////////////
+// Thread function that takes tiles until there are none left.
+static void *mglImageReformatTiles(void *data)
+{
+  mglImageReformatWork *work = (mglImageReformatWork *)data;
+  const size_t tileRows = MGL_IMAGE_REFORMAT_TILE_ROWS;
+  const size_t tileColumns = MGL_IMAGE_REFORMAT_TILE_COLUMNS;
+  const size_t imageSize = work->height * work->width;
+  uint32_t packed[MGL_IMAGE_REFORMAT_TILE_ROWS * MGL_IMAGE_REFORMAT_TILE_COLUMNS];
+
+  size_t tileIndex;
+  while ((tileIndex = __atomic_fetch_add(&work->nextTile, 1, __ATOMIC_RELAXED)) < work->nTiles) {
+    // tiles go across each band of rows, so that threads write to nearby rows
+    size_t firstRow = (tileIndex / work->tilesAcross) * tileRows;
+    size_t firstColumn = (tileIndex % work->tilesAcross) * tileColumns;
+    size_t rows = (firstRow + tileRows <= work->height) ? tileRows : work->height - firstRow;
+    size_t columns = (firstColumn + tileColumns <= work->width) ? tileColumns : work->width - firstColumn;
+    for (size_t j = 0; j < columns; j++)
+      mglImageReformatColumn(work->image, (firstColumn + j) * work->height + firstRow, imageSize, work->nChannels, rows, packed + j * tileRows);
+    mglImageReformatTranspose(packed, rows, columns, work->output + 4 * (firstRow * work->width + firstColumn), 4 * work->width);
+  }
+  return NULL;
+}
+
+/////////////////////////
+//   mglImageReformat  //
+/////////////////////////
+// Convert a height x width x nChannels (1, 3 or 4) image of doubles to 4 x width x height rgba bytes,
+// on up to nThreads threads (0 for the number of processors). Returns the number of threads used.
+static inline int mglImageReformat(const double *image, size_t height, size_t width, int nChannels, uint8_t *output, int nThreads)
+{
+  mglImageReformatWork work;
+  work.image = image;
+  work.height = height;
+  work.width = width;
+  work.nChannels = nChannels;
+  work.output = output;
+  work.tilesAcross = (width + MGL_IMAGE_REFORMAT_TILE_COLUMNS - 1) / MGL_IMAGE_REFORMAT_TILE_COLUMNS;
+  work.nTiles = work.tilesAcross * ((height + MGL_IMAGE_REFORMAT_TILE_ROWS - 1) / MGL_IMAGE_REFORMAT_TILE_ROWS);
+  work.nextTile = 0;
+  if (work.nTiles == 0) return 0;
+
+  // no more threads than processors, tiles, or the image is worth
+  if (nThreads <= 0) nThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  size_t worthwhile = height * width / MGL_IMAGE_REFORMAT_PIXELS_PER_THREAD + 1;
+  if ((size_t)nThreads > worthwhile) nThreads = (int)worthwhile;
+  if ((size_t)nThreads > work.nTiles) nThreads = (int)work.nTiles;
+  if (nThreads > MGL_IMAGE_REFORMAT_MAX_THREADS) nThreads = MGL_IMAGE_REFORMAT_MAX_THREADS;
+  if (nThreads < 1) nThreads = 1;
+
+  // run on this thread and the rest on their own, any that do not start leave their tiles to the others
+  pthread_t threads[MGL_IMAGE_REFORMAT_MAX_THREADS];
+  int started[MGL_IMAGE_REFORMAT_MAX_THREADS];
+  int iThread;
+  for (iThread = 1; iThread < nThreads; iThread++)
+    started[iThread] = (pthread_create(&threads[iThread], NULL, mglImageReformatTiles, &work) == 0);
+  mglImageReformatTiles(&work);
+  for (iThread = 1; iThread < nThreads; iThread++)
+    if (started[iThread]) pthread_join(threads[iThread], NULL);
+  return nThreads;
+}
+
+#endif
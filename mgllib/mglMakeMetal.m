@@ -233,6 +233,12 @@ if isfield(info,'mexopts')
   mexopts = info.mexopts;
 end
 
+% headers shared with mglMetal (e.g. mglDotMotion.h) live with mglCommandTypes.h
+mglMetalPath = fileparts(which('mglCommandTypes.h'));
+if ~isempty(mglMetalPath)
+  mexopts = sprintf('%s -I%s',mexopts,mglMetalPath);
+end
+
 % create mex commands
 info.mexCommand = sprintf('mex %s CFLAGS=''%s'' LDFLAGS=''%s'' ',mexopts,cFlags,ldFlags);
 
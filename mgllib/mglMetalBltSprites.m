@@ -0,0 +1,91 @@
+% mglMetalBltSprites.m
+%
+%       usage: results = mglMetalBltSprites(atlas, spriteIds, x, y, <width>, <height>, <rotation>, <alpha>, <socketInfo>)
+%          by: justin gardner
+%        date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%     purpose: Function to draw many sprites from an atlas made by
+%              mglAtlasCreate with one command, instead of one
+%              mglBltTexture for each. Each sprite sends 44 bytes, and
+%              mglMetal draws them all as instances of a quad, in the
+%              order given, so later sprites are drawn over earlier ones.
+%     inputs: atlas - made by mglAtlasCreate
+%             spriteIds - 1 x n matrix of which images of the atlas to
+%                         draw, the same image can be drawn many times
+%             x, y - 1 x n matrix of sprite centers (device units)
+%             width, height - 1 x n matrix of sprite sizes (device units)
+%                             default is the size of the image in pixels
+%             rotation - degrees counterclockwise about the center, as
+%                        for mglBltTexture (default 0)
+%             alpha - multiplies the alpha of the image (default 1)
+%
+%             All inputs but spriteIds can be scalars for all sprites or
+%             one value for each.
+%       e.g.:
+%
+% mglOpen(0);
+% mglVisualAngleCoordinates(57,[16 12]);
+% for i = 1:10
+%   faces{i} = rand(64,48);
+% end
+% atlas = mglAtlasCreate(faces);
+% for frame = 1:600
+%   ids = mod(frame+(1:10),10)+1;
+%   mglClearScreen(0.5);
+%   mglMetalBltSprites(atlas, ids, linspace(-6,6,10), 0, 1.2, 1.6, 10*sin(frame/20+(1:10)), 0.8);
+%   mglFlush;
+% end
+% mglDeleteTexture(atlas.pages);
+function results = mglMetalBltSprites(atlas, spriteIds, x, y, width, height, rotation, alpha, socketInfo)
+
+results = [];
+if nargin < 4
+    help mglMetalBltSprites
+    return
+end
+
+spriteIds = spriteIds(:)';
+nSprites = numel(spriteIds);
+if any(spriteIds < 1) || any(spriteIds > numel(atlas.page)) || any(atlas.page(spriteIds) == 0)
+    fprintf('(mglMetalBltSprites) spriteIds must be images 1 to %d of the atlas that were packed onto a page\n', numel(atlas.page));
+    return;
+end
+
+if nargin < 5 || isempty(width)
+    width = atlas.imageWidth(spriteIds) * mglGetParam('xPixelsToDevice');
+end
+if nargin < 6 || isempty(height)
+    height = atlas.imageHeight(spriteIds) * mglGetParam('yPixelsToDevice');
+end
+if nargin < 7 || isempty(rotation)
+    rotation = 0;
+end
+if nargin < 8 || isempty(alpha)
+    alpha = 1;
+end
+if nargin < 9 || isempty(socketInfo)
+    global mgl;
+    socketInfo = mgl.activeSockets;
+end
+
+% Pack one record per sprite: [x y width height rotation alpha u0 v0 u1 v1 textureNumber]
+values = {x, y, width, height, rotation, alpha};
+records = zeros(11, nSprites);
+for iValue = 1:numel(values)
+    records(iValue, :) = values{iValue}(:)' .* ones(1, nSprites);
+end
+records(7:10, :) = atlas.uv(:, spriteIds);
+records(11, :) = atlas.textureNumber(spriteIds);
+
+setupTime = mglGetSecs();
+
+mglSocketWrite(socketInfo, socketInfo(1).command.mglBltSprites);
+ackTime = mglSocketRead(socketInfo, 'double');
+mglSocketWrite(socketInfo, uint32(nSprites));
+mglSocketWrite(socketInfo, single(records));
+results = mglReadCommandResults(socketInfo, ackTime, setupTime);
+
+% check if processedTime is negative which indicates an error
+if any([results.processedTime] < 0)
+    mglPrivateDisplayProcessingError(socketInfo, results, mfilename);
+end
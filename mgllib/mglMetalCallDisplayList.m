@@ -0,0 +1,86 @@
+% mglMetalCallDisplayList: draw a display list, with parameters swapped in.
+%
+%      usage: results = mglMetalCallDisplayList(displayList, <params>, <socketInfo>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: Draw all the commands recorded in a display list (see
+%             mglMetalStartDisplayList) into the current frame, with a
+%             single command. Follow with mglFlush as usual.
+%
+%             Inputs:
+%               - displayList - struct from mglMetalFinishDisplayList
+%               - params - optional struct array, one element per value to
+%                          swap in for this call only. Each has a
+%                          commandIndex, saying which recorded command
+%                          (counting from 1) the value is for, and one of:
+%                   texture - texture (or texture number) for mglBltTexture
+%                   xform - 4x4 transform for mglTransform (e.g. as set by
+%                           mglVisualAngleCoordinates) or mglDrawGeometry
+%                   color - [r g b] for mglClearScreen
+%
+%             See mglMetalStartDisplayList for an example.
+function results = mglMetalCallDisplayList(displayList, params, socketInfo)
+
+results = [];
+if nargin < 1
+    help mglMetalCallDisplayList
+    return
+end
+if nargin < 2
+    params = [];
+end
+if nargin < 3 || isempty(socketInfo)
+    global mgl
+    socketInfo = mgl.activeSockets;
+end
+
+if ~isfield(displayList, 'displayListNumber')
+    disp('(mglMetalCallDisplayList) Input is not a display list');
+    return
+end
+
+% check that each parameter has a value to swap in
+for iParam = 1:numel(params)
+    if isempty(getParamField(params(iParam), 'texture')) && isempty(getParamField(params(iParam), 'xform')) && isempty(getParamField(params(iParam), 'color'))
+        fprintf('(mglMetalCallDisplayList) Parameter %i has no texture, xform or color\n', iParam);
+        return
+    end
+end
+
+% the recorded commands may set any state
+mglPrivateSkipRedundant('invalidate', [], socketInfo);
+mglSocketWrite(socketInfo, socketInfo(1).command.mglCallDisplayList);
+ackTime = mglSocketRead(socketInfo, 'double');
+mglSocketWrite(socketInfo, uint32(displayList(1).displayListNumber));
+mglSocketWrite(socketInfo, uint32(numel(params)));
+
+% These kinds need to match mglDisplayListParameter in mglDisplayList.swift.
+for iParam = 1:numel(params)
+    mglSocketWrite(socketInfo, uint32(params(iParam).commandIndex - 1));
+    if ~isempty(getParamField(params(iParam), 'texture'))
+        texture = params(iParam).texture;
+        if isstruct(texture)
+            texture = texture(1).textureNumber;
+        end
+        mglSocketWrite(socketInfo, uint32(0));
+        mglSocketWrite(socketInfo, uint32(texture));
+    elseif ~isempty(getParamField(params(iParam), 'xform'))
+        mglSocketWrite(socketInfo, uint32(1));
+        mglSocketWrite(socketInfo, single(params(iParam).xform));
+    else
+        mglSocketWrite(socketInfo, uint32(2));
+        mglSocketWrite(socketInfo, single(params(iParam).color(1:3)));
+    end
+end
+results = mglReadCommandResults(socketInfo, ackTime);
+
+%%%%%%%%%%%%%%%%%%%%%%%
+%    getParamField    %
+%%%%%%%%%%%%%%%%%%%%%%%
+function value = getParamField(param, fieldName)
+
+value = [];
+if isfield(param, fieldName)
+    value = param.(fieldName);
+end
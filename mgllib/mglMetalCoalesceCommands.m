@@ -0,0 +1,53 @@
+% mglMetalCoalesceCommands: send each frame of drawing commands at mglFlush
+%
+%      usage: mglMetalCoalesceCommands(<coalesce>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: Turn on or off coalescing of drawing commands (see
+%             mglSocketCoalesce). When on, drawing functions like
+%             mglClearScreen, mglQuad, mglMetalDots and mglMetalBltTexture
+%             do not wait for a round trip to mglMetal. Their commands are
+%             held and sent in one write at mglFlush, and mglFlush returns
+%             the results for all the commands of the frame, with the
+%             flush last. Drawing functions themselves return placeholder
+%             results (ackTime and processedTime of 0).
+%
+%             Returns whether coalescing is on. Do not use with
+%             mglMetalStartBatch.
+%
+%             mglOpen;
+%             mglMetalCoalesceCommands(1);
+%             mglClearScreen([1 0 0]);
+%             mglQuad([-1 1 1 -1]',[-1 -1 1 1]',[0 0 1]');
+%             results = mglFlush
+%             mglMetalCoalesceCommands(0);
+%
+function retval = mglMetalCoalesceCommands(coalesce)
+
+global mgl
+
+% check arguments
+if ~any(nargin == [0 1])
+  help mglMetalCoalesceCommands
+  return
+end
+if nargin < 1, coalesce = true; end
+
+% check that the mex function is compiled
+if exist('mglSocketCoalesce')~=3
+  disp(sprintf('(mglMetalCoalesceCommands) mglSocketCoalesce is not compiled. Run mglMakeSocket'));
+  retval = false;
+  return
+end
+
+if ~isfield(mgl,'activeSockets') || isempty(mgl.activeSockets)
+  disp(sprintf('(mglMetalCoalesceCommands) No mglMetal is open. Run mglOpen first'));
+  retval = false;
+  return
+end
+
+% turn on or off, sending anything that is still held
+mglSocketCoalesce(mgl.activeSockets, double(coalesce));
+mgl.coalesceCommands = logical(coalesce);
+retval = mgl.coalesceCommands;
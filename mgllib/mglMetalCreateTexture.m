@@ -1,6 +1,6 @@
 % mglMetalCreateTexture.m
 %
-%       usage: [tex, results] = mglMetalCreateTexture(im, [minMagFilter, mipFilter, addressMode])
+%       usage: [tex, results] = mglMetalCreateTexture(im, [minMagFilter, mipFilter, addressMode, socketInfo, divisor])
 %          by: justin gardner
 %        date: 09/28/2021
 %  copyright: (c) 2021 Justin Gardner (GPL see mgl/COPYING)
@@ -10,6 +10,10 @@
 %              functions are called by mglCreateTexture and mglBltTexture.
 %
 %              im -- m x n x 4 rgba single precision float image.
+%                    When mglSocketWriteTexture is compiled, im can also
+%                    be m x n x 3 rgb or m x n grayscale, or a uint8
+%                    4 x n x m image as mglCreateTexture takes, and is
+%                    sent as it is without any copies.
 %              minMagFilter -- optional value to choose sampler filtering:
 %                              0: nearest
 %                              1: linear (default)
@@ -24,6 +28,8 @@
 %                              3: mirror repeat
 %                              4: clamp to zero
 %                              5: clamp to border color
+%              divisor -- optional value that image values are divided
+%                         by (default 1, or 255 for uint8 images)
 %
 %              Returns a struct array of texture info for use with other
 %              mgl texture functions, like mglMetalBltTexture.
@@ -32,7 +38,7 @@
 %              and/or mglMirrorActivate, returns a struct arrauy with one
 %              element per active mirror.
 %
-function [tex, results] = mglMetalCreateTexture(im, minMagFilter, mipFilter, addressMode, socketInfo)
+function [tex, results] = mglMetalCreateTexture(im, minMagFilter, mipFilter, addressMode, socketInfo, divisor)
 
 % empty image, nothing to do.
 if isempty(im)
@@ -58,8 +64,21 @@ if nargin < 5 || isempty(socketInfo)
     socketInfo = mgl.activeSockets;
 end
 
-[tex.imageHeight, tex.imageWidth, tex.colorDim] = size(im);
-if (tex.colorDim ~= 4)
+if nargin < 6
+    divisor = [];
+end
+
+% mglSocketWriteTexture sends the image as it is, converting it a few rows
+% at a time, so none of the copies below are made
+useWriteTexture = (exist('mglSocketWriteTexture')==3) && any(strcmp(class(im),{'double','single','uint8'})) && isreal(im) && ~issparse(im);
+if isa(im,'uint8')
+    [tex.colorDim, tex.imageWidth, tex.imageHeight] = size(im);
+else
+    [tex.imageHeight, tex.imageWidth, tex.colorDim] = size(im);
+end
+if useWriteTexture && any(tex.colorDim == [1 3 4])
+    tex.colorDim = 4;
+elseif (tex.colorDim ~= 4) || isa(im,'uint8')
     error('(mglMetalCreateTexture) im must be mxnx4 rgba float.\n')
 end
 
@@ -85,14 +104,23 @@ tex.addressMode = addressMode;
 %   [R1, G1, B1, A1, R2, G2, B2, A1, R3, G3, B3, A3 ... ]
 % So we swap the dimensions to be indexed by (channel, column, row)
 % That way when serialized we traverse channel and column first.
-im = permute(im, [3,2,1]);
+if ~useWriteTexture
+    im = permute(im, [3,2,1]);
+    if ~isempty(divisor)
+        im = im / divisor;
+    end
+end
 
 % Send the texture create command and image data to each socket.
 mglSocketWrite(socketInfo, socketInfo(1).command.mglCreateTexture);
 ackTime = mglSocketRead(socketInfo, 'double');
 mglSocketWrite(socketInfo, uint32(tex.imageWidth));
 mglSocketWrite(socketInfo, uint32(tex.imageHeight));
-mglSocketWrite(socketInfo, single(im(:)));
+if useWriteTexture
+    mglSocketWriteTexture(socketInfo, im, divisor);
+else
+    mglSocketWrite(socketInfo, single(im(:)));
+end
 
 % Check each socket for processing results.
 responseIncoming = mglSocketRead(socketInfo, 'double');
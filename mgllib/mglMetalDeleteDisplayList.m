@@ -0,0 +1,34 @@
+% mglMetalDeleteDisplayList: free a display list.
+%
+%      usage: displayList = mglMetalDeleteDisplayList(displayList, <socketInfo>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: Tell the Mgl Metal app to forget a display list made with
+%             mglMetalStartDisplayList and mglMetalFinishDisplayList.
+%
+%             See mglMetalStartDisplayList for an example.
+function displayList = mglMetalDeleteDisplayList(displayList, socketInfo)
+
+if nargin < 1
+    help mglMetalDeleteDisplayList
+    return
+end
+if nargin < 2 || isempty(socketInfo)
+    global mgl
+    socketInfo = mgl.activeSockets;
+end
+
+if ~isfield(displayList, 'displayListNumber')
+    disp('(mglMetalDeleteDisplayList) Input is not a display list');
+    return
+end
+
+mglSocketWrite(socketInfo, socketInfo(1).command.mglDeleteDisplayList);
+mglSocketRead(socketInfo, 'double');
+mglSocketWrite(socketInfo, uint32(displayList(1).displayListNumber));
+removed = mglSocketRead(socketInfo, 'uint32');
+if ~all(removed(:))
+    disp('(mglMetalDeleteDisplayList) Display list was not found');
+end
+[displayList.displayListNumber] = deal(-1);
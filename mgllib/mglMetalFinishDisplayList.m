@@ -0,0 +1,39 @@
+% mglMetalFinishDisplayList: stop recording Metal commands into a display list.
+%
+%      usage: displayList = mglMetalFinishDisplayList(<socketInfo>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: Returns the Mgl Metal app to its normal state, after
+%             mglMetalStartDisplayList, and keeps the commands sent in
+%             between as a display list that can be drawn with
+%             mglMetalCallDisplayList.
+%
+%             Returns:
+%               - displayList - struct with displayListNumber and
+%                               nCommands, with one element per active
+%                               mirror. displayListNumber is -1 if the
+%                               display list could not be kept, for
+%                               example if a command was sent that
+%                               can't be recorded.
+%
+%             See mglMetalStartDisplayList for an example.
+function displayList = mglMetalFinishDisplayList(socketInfo)
+
+global mgl
+if nargin < 1 || isempty(socketInfo)
+    socketInfo = mgl.activeSockets;
+end
+
+mglPrivateSkipRedundant('resume', [], socketInfo);
+mglSocketWrite(socketInfo, socketInfo(1).command.mglFinishDisplayList);
+ackTime = mglSocketRead(socketInfo, 'double');
+for ii = 1:numel(socketInfo)
+    displayList(ii).displayListNumber = double(mglSocketRead(socketInfo(ii), 'uint32'));
+    displayList(ii).nCommands = double(mglSocketRead(socketInfo(ii), 'uint32'));
+    displayList(ii).ackTime = ackTime(1,1,1,ii);
+    if displayList(ii).displayListNumber == 0
+        displayList(ii).displayListNumber = -1;
+        fprintf('(mglMetalFinishDisplayList) Could not keep display list, some commands could not be recorded. You might try again with Console running, or: log stream --level info --process mglMetal\n');
+    end
+end
@@ -0,0 +1,59 @@
+% mglMetalFrameStreamClose: close a frame stream and report how its frames were shown
+%
+%      usage: [stats, results] = mglMetalFrameStreamClose(frameStream, <socketInfo>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: Closes a frame stream opened with mglMetalFrameStreamOpen,
+%             letting go of its textures and the file. stats has how many
+%             frames were ready when they were shown (readyCount), how
+%             many had to be waited for (waitedCount), how many were not
+%             ready in time and left out (missedCount), and the longest
+%             wait in seconds (maxWaitSecs). The first frame is usually
+%             waited for, unless there is time between opening and
+%             showing it.
+%
+%             frameStream = mglMetalFrameStreamOpen('grating.frames');
+%             for i = 1:frameStream.frameCount
+%               mglMetalFrameStreamShowFrame(frameStream, i);
+%               mglFlush;
+%             end
+%             stats = mglMetalFrameStreamClose(frameStream)
+%
+function [stats, results] = mglMetalFrameStreamClose(frameStream, socketInfo)
+
+stats = [];
+results = [];
+if ~any(nargin == [1 2])
+  help mglMetalFrameStreamClose
+  return
+end
+
+global mgl
+if nargin < 2 || isempty(socketInfo)
+  socketInfo = mgl.activeSockets;
+end
+
+mglSocketWrite(socketInfo, socketInfo(1).command.mglFrameStreamClose);
+ackTime = mglSocketRead(socketInfo, 'double');
+mglSocketWrite(socketInfo, uint32(frameStream(1).frameStreamNumber));
+
+% Check each socket for processing results.
+responseIncoming = mglSocketRead(socketInfo, 'double');
+stats = repmat(struct('readyCount', 0, 'waitedCount', 0, 'missedCount', 0, 'maxWaitSecs', 0), 1, numel(socketInfo));
+resultCell = cell([1, numel(socketInfo)]);
+for ii = 1:numel(socketInfo)
+  if (responseIncoming(ii) >= 0)
+    stats(ii).readyCount = double(mglSocketRead(socketInfo(ii), 'uint32'));
+    stats(ii).waitedCount = double(mglSocketRead(socketInfo(ii), 'uint32'));
+    stats(ii).missedCount = double(mglSocketRead(socketInfo(ii), 'uint32'));
+    stats(ii).maxWaitSecs = mglSocketRead(socketInfo(ii), 'double');
+  end
+  resultCell{ii} = mglReadCommandResults(socketInfo(ii), ackTime(1,1,1,ii));
+end
+results = [resultCell{:}];
+
+% check if processedTime is negative which indicates an error
+if any([results.processedTime] < 0)
+  mglPrivateDisplayProcessingError(socketInfo, results, mfilename);
+end
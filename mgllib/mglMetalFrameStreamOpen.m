@@ -0,0 +1,78 @@
+% mglMetalFrameStreamOpen: open a file of precomputed frames to show in mglMetal
+%
+%      usage: [frameStream, results] = mglMetalFrameStreamOpen(filename, <slotCount>, <socketInfo>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: Opens a frame stream written by mglFrameStreamWrite.
+%             mglMetal maps the file into memory and starts a background
+%             thread that decodes the frames that will be shown next onto
+%             a ring of slotCount textures (default 8, at least 3), so
+%             that mglMetalFrameStreamShowFrame finds each frame ready.
+%             More slots ride out longer hiccups reading from disk, at
+%             width*height*4 bytes each (16 for float frames).
+%
+%             frameStream has frameStreamNumber, frameCount, width,
+%             height and frameRate. Close it with mglMetalFrameStreamClose.
+%
+%             frameStream = mglMetalFrameStreamOpen('grating.frames');
+%             for i = 1:frameStream.frameCount
+%               mglMetalFrameStreamShowFrame(frameStream, i);
+%               mglFlush;
+%             end
+%             stats = mglMetalFrameStreamClose(frameStream)
+%
+function [frameStream, results] = mglMetalFrameStreamOpen(filename, slotCount, socketInfo)
+
+frameStream = [];
+results = [];
+if ~any(nargin == [1 2 3])
+  help mglMetalFrameStreamOpen
+  return
+end
+
+global mgl
+if nargin < 2 || isempty(slotCount), slotCount = 8; end
+if nargin < 3 || isempty(socketInfo)
+  socketInfo = mgl.activeSockets;
+end
+
+% files are in the sandbox where mglMetal can read them
+[~, mglMetalSandbox] = mglMetalExecutableName;
+if ~startsWith(filename, mglMetalSandbox)
+  [~, name, ext] = fileparts(filename);
+  if isempty(ext), ext = '.frames'; end
+  filename = fullfile(mglMetalSandbox, [name ext]);
+end
+
+mglSocketWrite(socketInfo, socketInfo(1).command.mglFrameStreamOpen);
+ackTime = mglSocketRead(socketInfo, 'double');
+mglSocketWrite(socketInfo, uint32(length(filename)));
+mglSocketWrite(socketInfo, uint16(filename));
+mglSocketWrite(socketInfo, uint32(slotCount));
+
+% Check each socket for processing results.
+responseIncoming = mglSocketRead(socketInfo, 'double');
+frameStream = struct('filename', filename, 'frameStreamNumber', -1, 'frameCount', 0, 'width', 0, 'height', 0, 'frameRate', 0);
+frameStream = repmat(frameStream, 1, numel(socketInfo));
+resultCell = cell([1, numel(socketInfo)]);
+for ii = 1:numel(socketInfo)
+  if (responseIncoming(ii) < 0)
+    % This socket could not open the file.
+    resultCell{ii} = mglReadCommandResults(socketInfo(ii), ackTime(1,1,1,ii));
+  else
+    frameStream(ii).frameStreamNumber = mglSocketRead(socketInfo(ii), 'uint32');
+    frameStream(ii).frameCount = double(mglSocketRead(socketInfo(ii), 'uint32'));
+    frameStream(ii).width = double(mglSocketRead(socketInfo(ii), 'uint32'));
+    frameStream(ii).height = double(mglSocketRead(socketInfo(ii), 'uint32'));
+    frameStream(ii).frameRate = mglSocketRead(socketInfo(ii), 'double');
+    resultCell{ii} = mglReadCommandResults(socketInfo(ii), ackTime(1,1,1,ii));
+  end
+end
+results = [resultCell{:}];
+
+% check if processedTime is negative which indicates an error
+if any([results.processedTime] < 0)
+  disp(sprintf('(mglMetalFrameStreamOpen) Could not open %s. Is it a file written by mglFrameStreamWrite?', filename));
+  mglPrivateDisplayProcessingError(socketInfo, results, mfilename);
+end
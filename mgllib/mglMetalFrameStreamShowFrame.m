@@ -0,0 +1,88 @@
+% mglMetalFrameStreamShowFrame: show one frame of a frame stream on the next flush
+%
+%      usage: results = mglMetalFrameStreamShowFrame(frameStream, frame, <position>, <width>, <height>, <timeoutSecs>, <socketInfo>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: Draws frame (1 to frameStream.frameCount) of a frame stream
+%             opened with mglMetalFrameStreamOpen, like mglBltTexture
+%             draws a texture, centered at position (default [0 0]) and
+%             width x height in device units (default the size of the
+%             frames in pixels). The frame shows on the next mglFlush.
+%
+%             mglMetal keeps decoding the frames after the last one
+%             asked for, so showing frames in order (or skipping ahead a
+%             few) finds them ready. A frame that is not ready waits up
+%             to timeoutSecs (default one refresh) to be decoded, and if
+%             it is still not ready, is left out and this returns an
+%             error. mglMetalFrameStreamClose reports how many frames
+%             were ready, waited for, or missed.
+%
+%             frameStream = mglMetalFrameStreamOpen('grating.frames');
+%             for i = 1:frameStream.frameCount
+%               mglClearScreen(0.5);
+%               mglMetalFrameStreamShowFrame(frameStream, i, [0 0], 8, 8);
+%               mglFlush;
+%             end
+%             mglMetalFrameStreamClose(frameStream);
+%
+function results = mglMetalFrameStreamShowFrame(frameStream, frame, position, width, height, timeoutSecs, socketInfo)
+
+results = [];
+if nargin < 2
+  help mglMetalFrameStreamShowFrame
+  return
+end
+
+if numel(frameStream) > 1
+  frameStream = frameStream(1);
+end
+if (frame < 1) || (frame > frameStream.frameCount)
+  disp(sprintf('(mglMetalFrameStreamShowFrame) frame must be 1 to %i', frameStream.frameCount));
+  return
+end
+
+% default arguments
+if nargin < 3 || isempty(position), position = [0 0]; end
+if nargin < 4 || isempty(width), width = frameStream.width*mglGetParam('xPixelsToDevice'); end
+if nargin < 5 || isempty(height), height = frameStream.height*mglGetParam('yPixelsToDevice'); end
+if nargin < 6 || isempty(timeoutSecs)
+  frameRate = mglGetParam('frameRate');
+  if isempty(frameRate) || (frameRate <= 0), frameRate = 60; end
+  timeoutSecs = 1/frameRate;
+end
+if nargin < 7 || isempty(socketInfo)
+  global mgl;
+  socketInfo = mgl.activeSockets;
+end
+
+% two triangles for the rectangle, with texture coordinates
+% Note: Metal texture coordinates have +Y going down, opposite of vertices!
+left = position(1)-width/2; right = position(1)+width/2;
+bottom = position(2)-height/2; top = position(2)+height/2;
+verticesWithTextureCoordinates = [...
+    right top 0 1 0;
+    left top 0 0 0;
+    left bottom 0 0 1;
+
+    right top 0 1 0;
+    left bottom 0 0 1;
+    right bottom 0 1 1;
+    ]';
+nVertices = 6;
+
+setupTime = mglGetSecs();
+
+mglSocketWrite(socketInfo, socketInfo(1).command.mglFrameStreamShowFrame);
+ackTime = mglSocketRead(socketInfo, 'double');
+mglSocketWrite(socketInfo, uint32(frameStream.frameStreamNumber));
+mglSocketWrite(socketInfo, uint32(frame-1));
+mglSocketWrite(socketInfo, single(timeoutSecs));
+mglSocketWrite(socketInfo, uint32(nVertices));
+mglSocketWrite(socketInfo, single(verticesWithTextureCoordinates));
+results = mglReadCommandResults(socketInfo, ackTime, setupTime);
+
+% check if processedTime is negative which indicates an error
+if any([results.processedTime] < 0)
+  mglPrivateDisplayProcessingError(socketInfo, results, mfilename);
+end
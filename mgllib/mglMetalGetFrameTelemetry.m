@@ -0,0 +1,70 @@
+% mglMetalGetFrameTelemetry: get timing of every onscreen frame from mglMetal
+%
+%      usage: [telemetry, results] = mglMetalGetFrameTelemetry(<afterFrame>, <socketInfo>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: mglMetal keeps timing for every onscreen frame it presents
+%             in a ring buffer that holds the last 8192 frames (about a
+%             minute at 120Hz). This gets the frames after afterFrame
+%             (default 0, for all frames still in the buffer) with one
+%             command and one read, so it is cheap enough to call during
+%             a run. Returns a struct with one element per active mirror,
+%             with fields (with one value per frame, times in seconds
+%             comparable to mglGetSecs):
+%
+%               frameNumber - frames are numbered from 1 as they are committed
+%               targetTime - when the display link wanted the frame
+%                            presented (the vsync target), 0 if not known
+%               drawableAcquired - when the drawable was acquired
+%               committed - when the frame was committed to the GPU
+%               gpuStart, gpuEnd - when the GPU did the frame's work,
+%                            0 if not done yet
+%               presented - when the frame was presented, -1 if not
+%                            known yet, 0 if the frame was dropped
+%
+%             and frameCount, the number of frames committed in all. Pass
+%             the last frameNumber you got as afterFrame to get only new
+%             frames next time. If frameNumber(1) is more than afterFrame+1,
+%             frames were overwritten before you asked for them.
+%
+%             mglOpen;
+%             for iFrame = 1:120, mglClearScreen(rand(1,3));mglFlush;end
+%             telemetry = mglMetalGetFrameTelemetry;
+%             mglFrameStats(telemetry)
+%
+function [telemetry, results] = mglMetalGetFrameTelemetry(afterFrame, socketInfo)
+
+global mgl
+if nargin < 1 || isempty(afterFrame)
+  afterFrame = 0;
+end
+if nargin < 2 || isempty(socketInfo)
+  socketInfo = mgl.activeSockets;
+end
+
+fieldNames = {'frameNumber','targetTime','drawableAcquired','committed','gpuStart','gpuEnd','presented'};
+
+mglSocketWrite(socketInfo, socketInfo(1).command.mglGetFrameTelemetry);
+ackTime = mglSocketRead(socketInfo, 'double');
+mglSocketWrite(socketInfo, double(afterFrame));
+for ii = 1:numel(socketInfo)
+  telemetry(ii).frameCount = mglSocketRead(socketInfo(ii), 'double');
+  % all the frames come as one array, with all of each field in turn
+  nValues = double(mglSocketRead(socketInfo(ii), 'uint32'));
+  nFrames = nValues / length(fieldNames);
+  if nFrames > 0
+    values = mglSocketRead(socketInfo(ii), 'double', nFrames, length(fieldNames));
+  else
+    values = zeros(0, length(fieldNames));
+  end
+  for iField = 1:length(fieldNames)
+    telemetry(ii).(fieldNames{iField}) = values(:,iField)';
+  end
+end
+results = mglReadCommandResults(socketInfo, ackTime);
+
+% check if processedTime is negative which indicates an error
+if any([results.processedTime] < 0)
+  mglPrivateDisplayProcessingError(socketInfo, results, mfilename);
+end
@@ -0,0 +1,55 @@
+% mglMetalGetScheduledFrameStats: get when scheduled frames were presented
+%
+%      usage: stats = mglMetalGetScheduledFrameStats(<socketInfo>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: Returns records of frames scheduled with
+%             mglMetalScheduleFrame that were due since the last call, as a struct with one element per active mirror and
+%             fields (with one value per frame):
+%
+%               frameNumber - as returned by mglMetalScheduleFrame
+%               targetTime - the time the frame was scheduled for
+%               tickTime - the time of the display refresh it was
+%                          presented on
+%               presentedTime - when the system says it was actually
+%                          presented, or 0 if not known yet
+%               framesLate - how many refreshes late it was, 0 is on time
+%               missed - 1 if it was due on tickTime but could not be
+%                          presented (e.g. no drawable), so never went up
+%
+%             and also nPending (frames still waiting to be presented),
+%             nOnTime, nLate and nMissed.
+%
+%             See mglMetalScheduleFrame for an example.
+%
+function stats = mglMetalGetScheduledFrameStats(socketInfo)
+
+global mgl
+if nargin < 1 || isempty(socketInfo)
+  socketInfo = mgl.activeSockets;
+end
+
+mglSocketWrite(socketInfo, socketInfo(1).command.mglGetScheduledFrameStats);
+ackTime = mglSocketRead(socketInfo, 'double');
+for ii = 1:numel(socketInfo)
+  stats(ii).nPending = double(mglSocketRead(socketInfo(ii), 'uint32'));
+  nFrames = double(mglSocketRead(socketInfo(ii), 'uint32'));
+  fieldNames = {'frameNumber','targetTime','tickTime','presentedTime','framesLate','missed'};
+  for iField = 1:length(fieldNames)
+    if nFrames > 0
+      stats(ii).(fieldNames{iField}) = mglSocketRead(socketInfo(ii), 'double', 1, nFrames);
+    else
+      stats(ii).(fieldNames{iField}) = [];
+    end
+  end
+  stats(ii).nOnTime = sum((stats(ii).framesLate == 0) & ~stats(ii).missed);
+  stats(ii).nLate = sum((stats(ii).framesLate > 0) & ~stats(ii).missed);
+  stats(ii).nMissed = sum(stats(ii).missed ~= 0);
+end
+results = mglReadCommandResults(socketInfo, ackTime);
+
+% check if processedTime is negative which indicates an error
+if any([results.processedTime] < 0)
+  mglPrivateDisplayProcessingError(socketInfo, results, mfilename);
+end
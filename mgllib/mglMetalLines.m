@@ -1,6 +1,6 @@
 % mglMetalLines.m
 %
-%       usage: mglMetalLines(x0, y0, x1, y1, lineWidth, color)
+%       usage: mglMetalLines(x0, y0, x1, y1, lineWidth, color, <socketInfo>)
 %          by: ben heasly
 %        date: 06/13/2022 adapted from mglLines2, updated for Metal
 %  copyright: (c) 2021 Justin Gardner (GPL see mgl/COPYING)
@@ -10,7 +10,13 @@
 %             x1 - 1 x n matrix of line ending x-positions
 %             y1 - 1 x n matrix of line ending y-positions
 %             lineWidth - 1 x n matrix of line widths (device units, not pixels)
-%             color -- 3 x n matrix of RGB colors for the lines
+%             color -- 3 x n matrix of RGB colors for the lines, or 4 x n
+%                      with alpha
+%
+%             Each line is sent as a single record [x0 y0 x1 y1 width rgba]
+%             and mglMetal widens it into a quad as it draws it (see
+%             mglInstancedLines.h). mglMetalRects draws rotated rectangles
+%             the same way.
 %       e.g.:
 %
 % Draw one line:
@@ -24,7 +30,7 @@
 % mglVisualAngleCoordinates(57,[16 12]);
 % mglMetalLines(rand(1,10)*5-2.5, rand(1,10)*10-5, rand(1,10)*5-2.5, rand(1,10)*3-1.5, 0.5, [0 0.6 1]');
 % mglFlush;
-function results = mglMetalLines(x0, y0, x1, y1, lineWidth, color)
+function results = mglMetalLines(x0, y0, x1, y1, lineWidth, color, socketInfo)
 
 nLines = numel(x0);
 if ~isequal(numel(y0), nLines) || ~isequal(numel(x1), nLines) || ~isequal(numel(y1), nLines)
@@ -43,18 +49,29 @@ end
 if nargin < 6
     color = [1 1 1]';
 end
+if any(numel(color) == [3 4])
+    color = color(:);
+end
+if size(color, 1) == 3
+    color(4, :) = 1;
+end
 if size(color, 2) == 1
-    color = repmat(color(1:3), [1, nLines]);
+    color = repmat(color(1:4), [1, nLines]);
 end
 
-% Widen each line by its lineWidth, perpendicular to its start-end heading.
-deltaX = x1 - x0;
-deltaY = y1 - y0;
-angle = atan2(deltaY, deltaX);
-offsetX = 0.5 * lineWidth .* -sin(angle);
-offsetY = 0.5 * lineWidth .* cos(angle);
+if nargin < 7 || isempty(socketInfo)
+    global mgl;
+    socketInfo = mgl.activeSockets;
+end
+
+% Pack one record per line, mglMetal widens each line by its lineWidth,
+% perpendicular to its start-end heading.
+records = cat(1, x0(:)', y0(:)', x1(:)', y1(:)', lineWidth(:)', color);
+
+setupTime = mglGetSecs();
 
-% Pack up and draw the widened lines as quads.
-quadX = cat(1, x0 + offsetX, x1 + offsetX, x1 - offsetX, x0 - offsetX);
-quadY = cat(1, y0 + offsetY, y1 + offsetY, y1 - offsetY, y0 - offsetY);
-results = mglQuad(quadX, quadY, color);
+mglSocketWrite(socketInfo, socketInfo(1).command.mglInstancedLines);
+ackTime = mglSocketRead(socketInfo, 'double');
+mglSocketWrite(socketInfo, uint32(nLines));
+mglSocketWrite(socketInfo, single(records));
+results = mglReadCommandResults(socketInfo, ackTime, setupTime);
@@ -0,0 +1,83 @@
+% mglMetalProceduralGratings.m
+%
+%       usage: mglMetalProceduralGratings(x, y, width, height, sf, angle, phase, <contrast>, <sdx>, <sdy>, <alphaMask>, <socketInfo>)
+%          by: justin gardner
+%        date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%     purpose: Function to draw gratings and gabors that mglMetal computes
+%              as it draws them, so there is no texture to make or upload,
+%              and changing contrast or phase from frame to frame only
+%              sends 44 bytes per grating.
+%     inputs: x, y - 1 x n matrix of grating centers (device units)
+%             width, height - 1 x n matrix of grating sizes (device units)
+%             sf - cycles per device unit, as for mglMakeGrating
+%             angle, phase - degrees, as for mglMakeGrating
+%             contrast - 0 to 1 (default 1)
+%             sdx, sdy - gaussian envelope, as for mglMakeGaussian and
+%                        centered on the grating. 0 (the default) is no
+%                        envelope.
+%             alphaMask - 0 (default) to show the gabor around gray, as
+%                        (contrast*grating*gaussian+1)/2, or 1 to show the
+%                        grating as (contrast*grating+1)/2 with the
+%                        gaussian as alpha, as taskTemplateStaircase does
+%
+%             All inputs can be scalars for all gratings or one value for
+%             each. The result looks the same as blting a texture made
+%             with mglMakeGrating and mglMakeGaussian, with the width and
+%             height of the texture as it is shown. mglPrivateProceduralGratings
+%             draws the same thing on the CPU (see mglTestProceduralGratings).
+%       e.g.:
+%
+% mglOpen(0);
+% mglVisualAngleCoordinates(57,[16 12]);
+% mglClearScreen(0.5);
+% for phase = 0:10:720
+%   mglMetalProceduralGratings(0, 0, 8, 8, 1.5, 45, phase, 0.5, 1, 1);
+%   mglFlush;
+% end
+function results = mglMetalProceduralGratings(x, y, width, height, sf, angle, phase, contrast, sdx, sdy, alphaMask, socketInfo)
+
+results = [];
+if nargin < 7
+    help mglMetalProceduralGratings
+    return
+end
+
+nGratings = numel(x);
+if ~isequal(numel(y), nGratings)
+    fprintf('(mglMetalProceduralGratings) Number of values for y must match number of values for x (%d)', nGratings);
+    help mglMetalProceduralGratings
+    return;
+end
+
+if nargin < 8
+    contrast = 1;
+end
+if nargin < 9
+    sdx = 0;
+end
+if nargin < 10
+    sdy = sdx;
+end
+if nargin < 11
+    alphaMask = 0;
+end
+if nargin < 12 || isempty(socketInfo)
+    global mgl;
+    socketInfo = mgl.activeSockets;
+end
+
+% Pack one record per grating: [x y width height sf angle phase contrast sdx sdy alphaMask]
+values = {x, y, width, height, sf, angle, phase, contrast, sdx, sdy, alphaMask};
+records = zeros(numel(values), nGratings);
+for iValue = 1:numel(values)
+    records(iValue, :) = values{iValue}(:)' .* ones(1, nGratings);
+end
+
+setupTime = mglGetSecs();
+
+mglSocketWrite(socketInfo, socketInfo(1).command.mglProceduralGratings);
+ackTime = mglSocketRead(socketInfo, 'double');
+mglSocketWrite(socketInfo, uint32(nGratings));
+mglSocketWrite(socketInfo, single(records));
+results = mglReadCommandResults(socketInfo, ackTime, setupTime);
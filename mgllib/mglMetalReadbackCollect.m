@@ -0,0 +1,72 @@
+% mglMetalReadbackCollect: get the image of a readback started with mglMetalReadbackIssue
+%
+%      usage: [im, waitedSecs, results] = mglMetalReadbackCollect(readback, <socketInfo>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: Returns the image read back by mglMetalReadbackIssue, as a
+%             height x width x 4 matrix of RGBA values, single or uint8
+%             as asked for, ready to use without permuting. If the GPU
+%             has not copied the image yet, this waits for it, and
+%             waitedSecs says how long. Collecting a frame or more after
+%             issuing usually waits for nothing. Each readback can only
+%             be collected once.
+%
+%             If multiple sockets have been activated with mglMirrorOpen
+%             and/or mglMirrorActivate, im has an extra dimension for
+%             which mirror the image came from [height, width, 4, mirrorIndex].
+%
+%             mglFrameGrab('init');
+%             mglClearScreen([1 0 0]);
+%             mglFlush;
+%             readback = mglMetalReadbackIssue([], [0 0 64 64], 'uint8');
+%             % ... draw the next frame ...
+%             im = mglMetalReadbackCollect(readback);
+%             mglFrameGrab('end');
+%
+function [im, waitedSecs, results] = mglMetalReadbackCollect(readback, socketInfo)
+
+im = [];
+waitedSecs = [];
+results = [];
+if ~any(nargin == [1 2])
+  help mglMetalReadbackCollect
+  return
+end
+
+if nargin < 2 || isempty(socketInfo)
+  global mgl
+  socketInfo = mgl.activeSockets;
+end
+
+mglSocketWrite(socketInfo, socketInfo(1).command.mglReadbackCollect);
+ackTime = mglSocketRead(socketInfo, 'double');
+mglSocketWrite(socketInfo, uint32(readback(1).ticket));
+
+% Check each socket for processing results.
+responseIncoming = mglSocketRead(socketInfo, 'double');
+im = zeros([readback(1).height, readback(1).width, 4, numel(socketInfo)], readback(1).format);
+waitedSecs = nan(1, numel(socketInfo));
+resultCell = cell([1, numel(socketInfo)]);
+for ii = 1:numel(socketInfo)
+  if (responseIncoming(ii) >= 0)
+    width = double(mglSocketRead(socketInfo(ii), 'uint32'));
+    height = double(mglSocketRead(socketInfo(ii), 'uint32'));
+    formatCode = mglSocketRead(socketInfo(ii), 'uint32');
+    waitedSecs(ii) = mglSocketRead(socketInfo(ii), 'double');
+    % the image comes already in matlab order, after its length in bytes
+    byteCount = mglSocketRead(socketInfo(ii), 'uint32');
+    if formatCode == 1
+      im(:,:,:,ii) = mglSocketRead(socketInfo(ii), 'uint8', height, width, 4);
+    else
+      im(:,:,:,ii) = mglSocketRead(socketInfo(ii), 'single', height, width, 4);
+    end
+  end
+  resultCell{ii} = mglReadCommandResults(socketInfo(ii), ackTime(1,1,1,ii));
+end
+results = [resultCell{:}];
+
+% check if processedTime is negative which indicates an error
+if any([results.processedTime] < 0)
+  mglPrivateDisplayProcessingError(socketInfo, results, mfilename);
+end
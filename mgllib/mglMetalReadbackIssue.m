@@ -0,0 +1,100 @@
+% mglMetalReadbackIssue: start reading back what was drawn, without waiting for it
+%
+%      usage: [readback, results] = mglMetalReadbackIssue(<tex>, <roi>, <format>, <socketInfo>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: Starts reading back the offscreen render target (set with
+%             mglFrameGrab('init') or mglMetalSetRenderTarget), or the
+%             texture tex, as it is after the frames flushed so far.
+%             Unlike mglFrameGrab and mglMetalReadTexture, this returns
+%             right away: the GPU copies the image into a staging
+%             buffer after the frame, while you go on drawing the next
+%             one, and mglMetalReadbackCollect gets the image later,
+%             usually without waiting for anything.
+%
+%             roi is [x y width height] in pixels from the top left
+%             (default [], all of it, a width or height of 0 means to the
+%             edge). format is 'single' (default) or 'uint8', which
+%             clamps values to 0-255 and is a quarter of the bytes to
+%             send back. Up to 4 readbacks can be waiting to be collected.
+%
+%             readback has ticket, width, height, format and the frame
+%             count it was issued in, to pass to mglMetalReadbackCollect.
+%
+%             % grab each frame, collecting each one a frame later
+%             mglFrameGrab('init');
+%             for i = 1:100
+%               mglClearScreen(i/100);
+%               mglFlush;
+%               readback(i) = mglMetalReadbackIssue([], [], 'uint8');
+%               if i > 1, frames(:,:,:,i-1) = mglMetalReadbackCollect(readback(i-1)); end
+%             end
+%             frames(:,:,:,100) = mglMetalReadbackCollect(readback(100));
+%             mglFrameGrab('end');
+%
+function [readback, results] = mglMetalReadbackIssue(tex, roi, format, socketInfo)
+
+readback = [];
+results = [];
+if ~any(nargin == [0 1 2 3 4])
+  help mglMetalReadbackIssue
+  return
+end
+
+% default arguments
+if nargin < 1 || isempty(tex)
+  textureNumber = 0;
+else
+  textureNumber = tex(1).textureNumber;
+end
+if nargin < 2 || isempty(roi), roi = [0 0 0 0]; end
+if nargin < 3 || isempty(format), format = 'single'; end
+if nargin < 4 || isempty(socketInfo)
+  global mgl
+  socketInfo = mgl.activeSockets;
+end
+
+if numel(roi) ~= 4
+  disp(sprintf('(mglMetalReadbackIssue) roi should be [x y width height]'));
+  return
+end
+switch format
+  case 'single'
+    formatCode = 0;
+  case 'uint8'
+    formatCode = 1;
+  otherwise
+    disp(sprintf('(mglMetalReadbackIssue) Unknown format %s, should be single or uint8', format));
+    return
+end
+
+mglSocketWrite(socketInfo, socketInfo(1).command.mglReadbackIssue);
+ackTime = mglSocketRead(socketInfo, 'double');
+mglSocketWrite(socketInfo, uint32(textureNumber));
+mglSocketWrite(socketInfo, uint32(roi(1)));
+mglSocketWrite(socketInfo, uint32(roi(2)));
+mglSocketWrite(socketInfo, uint32(roi(3)));
+mglSocketWrite(socketInfo, uint32(roi(4)));
+mglSocketWrite(socketInfo, uint32(formatCode));
+
+% Check each socket for processing results.
+responseIncoming = mglSocketRead(socketInfo, 'double');
+readback = struct('ticket', 0, 'width', 0, 'height', 0, 'format', format, 'frame', 0);
+readback = repmat(readback, 1, numel(socketInfo));
+resultCell = cell([1, numel(socketInfo)]);
+for ii = 1:numel(socketInfo)
+  if (responseIncoming(ii) >= 0)
+    readback(ii).ticket = mglSocketRead(socketInfo(ii), 'uint32');
+    readback(ii).width = double(mglSocketRead(socketInfo(ii), 'uint32'));
+    readback(ii).height = double(mglSocketRead(socketInfo(ii), 'uint32'));
+    readback(ii).frame = mglSocketRead(socketInfo(ii), 'double');
+  end
+  resultCell{ii} = mglReadCommandResults(socketInfo(ii), ackTime(1,1,1,ii));
+end
+results = [resultCell{:}];
+
+% check if processedTime is negative which indicates an error
+if any([results.processedTime] < 0)
+  mglPrivateDisplayProcessingError(socketInfo, results, mfilename);
+end
@@ -0,0 +1,58 @@
+% mglMetalRects.m
+%
+%       usage: mglMetalRects(x, y, width, height, angle, color, <socketInfo>)
+%          by: justin gardner
+%        date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%     purpose: Function to draw filled, rotated rectangles on a screen
+%              opened with mglOpen.
+%     inputs: x - 1 x n matrix of rectangle center x-positions
+%             y - 1 x n matrix of rectangle center y-positions
+%             width - 1 x n matrix of rectangle widths (device units)
+%             height - 1 x n matrix of rectangle heights (device units)
+%             angle - 1 x n matrix of angles in degrees, counterclockwise
+%             color -- 3 x n matrix of RGB colors, or 4 x n with alpha
+%
+%             Each rectangle is sent as a line through its center along
+%             its angle, with its height as the line width, and drawn with
+%             mglMetalLines so that each is a single record.
+%       e.g.:
+%
+% mglOpen;
+% mglVisualAngleCoordinates(57,[16 12]);
+% mglMetalRects(rand(1,10)*10-5, rand(1,10)*8-4, 2, 0.5, rand(1,10)*360, [1 0.6 0]');
+% mglFlush;
+function results = mglMetalRects(x, y, width, height, angle, color, socketInfo)
+
+results = [];
+if nargin < 4
+    help mglMetalRects
+    return
+end
+
+nRects = numel(x);
+if ~isequal(numel(y), nRects)
+    fprintf('(mglMetalRects) Number of values for y must match number of values for x (%d)', nRects);
+    help mglMetalRects
+    return;
+end
+
+if nargin < 5
+    angle = 0;
+end
+if nargin < 6
+    color = [1 1 1]';
+end
+if nargin < 7
+    socketInfo = [];
+end
+
+% make everything the same length
+width = width(:)' .* ones(1, nRects);
+height = height(:)' .* ones(1, nRects);
+angle = angle(:)' .* ones(1, nRects);
+
+% get the ends of the line through the center of each rectangle
+halfX = 0.5 * width .* cos(pi * angle / 180);
+halfY = 0.5 * width .* sin(pi * angle / 180);
+results = mglMetalLines(x(:)' - halfX, y(:)' - halfY, x(:)' + halfX, y(:)' + halfY, height, color, socketInfo);
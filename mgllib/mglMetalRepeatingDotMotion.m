@@ -0,0 +1,119 @@
+% mglMetalRepeatingDotMotion.m
+%
+%        $Id$
+%      usage: [ackTime, drawTimes, frameTimes] = mglMetalRepeatingDotMotion(nFrames, stimParams, randomSeed)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: Send one command that causes multiple frames of moving dots,
+%             which mglMetal moves itself each frame. Only the motion
+%             parameters are sent, not the dots.
+%      usage: [ackTime, drawTimes, frameTimes] = mglMetalRepeatingDotMotion(nFrames, stimParams, randomSeed)
+%     inputs: nFrames -- how long in frames the dots should last
+%             stimParams -- motion parameters with the same fields that
+%                           dotMotionFrame uses:
+%                 nPoints -- number of dots
+%                 coherence -- fraction of dots moving coherently
+%                 coherentMotionType -- 'expanding', 'contracting', 'translating' or 'rotating'
+%                 incoherentMotionType -- 'random', 'brownian' or 'movshon'
+%                 speed -- in device units/sec
+%                 lifetime -- dot lifetime in frames
+%                 direction -- direction(s) in radians, for translating
+%                 spatial.origin -- [x y] for expanding and contracting
+%               and optionally how the dots look:
+%                 color -- [r g b] or [r g b a], defaults to white
+%                 dotSize -- in device units, defaults to 0.1
+%                 shape -- 0 for square or 1 for round (default)
+%                 border -- antialiasing border in pixels, defaults to 0
+%             randomSeed -- integer seed. The dots follow dotMotionFrame
+%                           with rng(randomSeed,'twister') and displayParams
+%                           of mglGetParam('deviceRect') and 'frameRate'.
+%                           See mglTestDotMotion.
+%
+%             This will return a single ackTime for when the command was
+%             received, an array of nFrames drawTimes, indicating when
+%             drawing was completed during each frame, and an array of
+%             nFrames frameTimes indicating when each frame was completed.
+%
+% mglOpen();
+% mglVisualAngleCoordinates(57,[40 30]);
+% stimParams = struct('nPoints',1000,'coherence',0.5,'coherentMotionType','translating','incoherentMotionType','random','speed',5,'lifetime',20,'direction',0);
+% [ackTime, drawTimes, frameTimes] = mglMetalRepeatingDotMotion(300, stimParams);
+function [ackTime, drawTimes, frameTimes] = mglMetalRepeatingDotMotion(nFrames, stimParams, randomSeed, socketInfo)
+
+ackTime = [];drawTimes = [];frameTimes = [];
+if nargin < 2
+    help mglMetalRepeatingDotMotion
+    return
+end
+
+if nargin < 3
+    randomSeed = 0;
+end
+
+if nargin < 4 || isempty(socketInfo)
+    global mgl;
+    socketInfo = mgl.activeSockets;
+end
+
+% motion types, these need to match the enums in mglDotMotion.h
+coherentMotionType = find(strcmp(stimParams.coherentMotionType, {'expanding', 'contracting', 'translating', 'rotating'})) - 1;
+incoherentMotionType = find(strcmp(stimParams.incoherentMotionType, {'random', 'brownian', 'movshon'})) - 1;
+if isempty(coherentMotionType) || isempty(incoherentMotionType)
+    fprintf('(mglMetalRepeatingDotMotion) Unsupported motion type %s/%s\n', stimParams.coherentMotionType, stimParams.incoherentMotionType);
+    return
+end
+
+% get directions and origin
+direction = [];
+if isfield(stimParams, 'direction')
+    direction = stimParams.direction(:)';
+end
+if (coherentMotionType == 2) && (isempty(direction) || (length(direction) > 8))
+    fprintf('(mglMetalRepeatingDotMotion) Translating motion needs between 1 and 8 directions\n');
+    return
+end
+origin = [0 0];
+if isfield(stimParams, 'spatial') && isfield(stimParams.spatial, 'origin')
+    origin = stimParams.spatial.origin;
+end
+
+% and how the dots look
+color = [1 1 1 1];
+if isfield(stimParams, 'color')
+    color(1:length(stimParams.color)) = stimParams.color;
+end
+dotSize = 0.1;
+if isfield(stimParams, 'dotSize')
+    dotSize = stimParams.dotSize;
+end
+wh = [dotSize * mglGetParam('xDeviceToPixels'), dotSize * mglGetParam('yDeviceToPixels')];
+shape = 1;
+if isfield(stimParams, 'shape')
+    shape = stimParams.shape;
+end
+border = 0;
+if isfield(stimParams, 'border')
+    border = stimParams.border;
+end
+
+mglSocketWrite(socketInfo, socketInfo(1).command.mglRepeatDotMotion);
+ackTime = mglSocketRead(socketInfo, 'double');
+mglSocketWrite(socketInfo, uint32(nFrames));
+mglSocketWrite(socketInfo, uint32(stimParams.nPoints));
+mglSocketWrite(socketInfo, uint32(randomSeed));
+mglSocketWrite(socketInfo, uint32(coherentMotionType));
+mglSocketWrite(socketInfo, uint32(incoherentMotionType));
+mglSocketWrite(socketInfo, uint32(length(direction)));
+% the motion as double so that the dots move as dotMotionFrame moves them,
+% and how they look as single, as for mglMetalDots
+mglSocketWrite(socketInfo, double([direction stimParams.coherence stimParams.speed stimParams.lifetime origin(1) origin(2) mglGetParam('frameRate') mglGetParam('deviceRect')]));
+mglSocketWrite(socketInfo, single([color wh shape border]));
+
+drawTimes = zeros(1, nFrames);
+frameTimes = zeros(1, nFrames);
+for ii = 1:nFrames
+    drawTimes(ii) = mglSocketRead(socketInfo, 'double');
+    results = mglReadCommandResults(socketInfo);
+    frameTimes(ii) = results.processedTime;
+end
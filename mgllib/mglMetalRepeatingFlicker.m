@@ -41,6 +41,8 @@ if nargin < 3 || isempty(socketInfo)
     socketInfo = mgl.activeSockets;
 end
 
+% each frame sets its own clear color
+mglPrivateSkipRedundant('invalidate', {'clearColor'}, socketInfo);
 mglSocketWrite(socketInfo, socketInfo(1).command.mglRepeatFlicker);
 ackTime = mglSocketRead(socketInfo, 'double');
 mglSocketWrite(socketInfo, uint32(nFrames));
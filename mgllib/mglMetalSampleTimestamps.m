@@ -10,6 +10,10 @@
 %               cpu: a CPU timestamp in seconds, comparable to mglGetSecs
 %               gpu: a GPU timestamp in unspecified units (GPU nanos?)
 %
+%             Each pair is also added to the clock alignment fit for
+%             'gpu' (see mglClockAlign), so that GPU timestamps can be
+%             converted to mglGetSecs with mglClockAlign('toHost','gpu',t)
+%
 %             % Get some samples!
 %             mglOpen();
 %             [cpu, gpu] = mglMetalSampleTimestamps()
@@ -26,3 +30,8 @@ ackTime = mglSocketRead(socketInfo, 'double');
 cpu = mglSocketRead(socketInfo, 'double');
 gpu = mglSocketRead(socketInfo, 'double');
 results = mglReadCommandResults(socketInfo, ackTime);
+
+% keep the clock alignment for the gpu up to date (mirrors share a GPU, so use the first)
+if gpu(1) > 0
+  mglClockAlign('add', 'gpu', gpu(1), cpu(1), 1e-9);
+end
@@ -0,0 +1,66 @@
+% mglMetalScheduleFrame: render the next frame ahead of time and present it at a target time.
+%
+%      usage: [frameNumber, results] = mglMetalScheduleFrame(targetTime, <socketInfo>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: Normally mglFlush presents a frame on the next display
+%             refresh. Call this before the drawing commands of a frame
+%             to have mglMetal instead render the frame into one of a
+%             pool of offscreen textures, and hold it until the display
+%             refresh that matches targetTime (in the same seconds as
+%             mglGetSecs), when it is copied to the screen. mglFlush
+%             then returns as soon as the frame is rendered, so several
+%             frames (up to 8) can be queued ahead of their times.
+%
+%             A frame is presented on the first refresh that is no more
+%             than half a refresh before its target time. Frames are
+%             presented in order of target time, one per refresh, and
+%             none are skipped, so a frame that misses its refresh goes
+%             up late. mglMetalGetScheduledFrameStats reports when each
+%             frame went up and how many refreshes late it was.
+%
+%             Returns the frameNumber, to find the frame in the stats, or
+%             0 if the frame could not be scheduled (for example if 8
+%             frames are already waiting).
+%
+%             Stencils created onscreen do not apply to scheduled frames,
+%             which have their own depth and stencil planes, as with
+%             mglMetalSetRenderTarget.
+%
+%             mglOpen;
+%             frameInterval = 1/mglGetParam('frameRate');
+%             startTime = mglGetSecs + 0.25;
+%             for iFrame = 1:8
+%               mglMetalScheduleFrame(startTime + iFrame*frameInterval);
+%               mglClearScreen(iFrame/8);
+%               mglFlush;
+%             end
+%             mglWaitSecs(0.5);
+%             stats = mglMetalGetScheduledFrameStats
+%
+function [frameNumber, results] = mglMetalScheduleFrame(targetTime, socketInfo)
+
+frameNumber = 0;
+results = [];
+if nargin < 1
+  help mglMetalScheduleFrame
+  return
+end
+
+global mgl
+if nargin < 2 || isempty(socketInfo)
+  socketInfo = mgl.activeSockets;
+end
+
+mglSocketWrite(socketInfo, socketInfo(1).command.mglScheduleFrame);
+ackTime = mglSocketRead(socketInfo, 'double');
+mglSocketWrite(socketInfo, double(targetTime));
+frameNumber = squeeze(double(mglSocketRead(socketInfo, 'uint32')))';
+results = mglReadCommandResults(socketInfo, ackTime);
+
+% check if processedTime is negative which indicates an error
+if any([results.processedTime] < 0)
+  frameNumber(:) = 0;
+  mglPrivateDisplayProcessingError(socketInfo, results, mfilename);
+end
@@ -46,7 +46,16 @@ if nargin < 2 || isempty(socketInfo)
     socketInfo = mgl.activeSockets;
 end
 
+% skip sending if this is already the render target (see mglMetalSkipRedundantCommands)
+[skip, results] = mglPrivateSkipRedundant('mglSetRenderTarget', uint32(renderTarget), socketInfo);
+if skip
+    return
+end
+
 mglSocketWrite(socketInfo, socketInfo(1).command.mglSetRenderTarget);
 ackTime = mglSocketRead(socketInfo, 'double');
 mglSocketWrite(socketInfo, renderTarget);
 results = mglReadCommandResults(socketInfo, ackTime);
+if any([results.processedTime] < 0)
+    mglPrivateSkipRedundant('invalidate', {'renderTarget'}, socketInfo);
+end
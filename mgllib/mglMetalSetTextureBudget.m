@@ -0,0 +1,51 @@
+% mglMetalSetTextureBudget: set how much texture memory mglMetal keeps on the GPU
+%
+%      usage: results = mglMetalSetTextureBudget(budgetBytes, <socketInfo>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: Sets a budget for how many bytes of textures mglMetal keeps
+%             in GPU memory. With about 1 GB of textures loaded, mglMetal
+%             can stall for 7-14 ms getting each frame to draw into. With
+%             a budget, when making a texture (or using one that was
+%             spilled) would go over it, the textures that were least
+%             recently blted are compressed into host memory and let go
+%             of on the GPU. They are restored as they were the next time
+%             they are used, which takes time in that frame, so set the
+%             budget large enough to hold what is shown together. Textures
+%             used in the frame being drawn and textures that were render
+%             targets are never spilled. budgetBytes of 0 (the default
+%             when mglMetal starts) keeps all textures on the GPU.
+%
+%             Each texture takes width*height*16 bytes. mglInfo reports
+%             the budget and how many textures and bytes are resident and
+%             spilled in info.texture.
+%
+%             mglOpen;
+%             mglMetalSetTextureBudget(512*1024^2);
+%             for i = 1:60, tex(i) = mglCreateTexture(rand(1080,1920));end
+%             info = mglInfo;
+%             info.texture
+%
+function results = mglMetalSetTextureBudget(budgetBytes, socketInfo)
+
+results = [];
+if ~any(nargin == [1 2])
+  help mglMetalSetTextureBudget
+  return
+end
+
+global mgl
+if nargin < 2 || isempty(socketInfo)
+  socketInfo = mgl.activeSockets;
+end
+
+mglSocketWrite(socketInfo, socketInfo(1).command.mglSetTextureBudget);
+ackTime = mglSocketRead(socketInfo, 'double');
+mglSocketWrite(socketInfo, double(max(budgetBytes,0)));
+results = mglReadCommandResults(socketInfo, ackTime);
+
+% check if processedTime is negative which indicates an error
+if any([results.processedTime] < 0)
+  mglPrivateDisplayProcessingError(socketInfo, results, mfilename);
+end
@@ -63,8 +63,17 @@ if numel(socketInfo) > 1
     fprintf('(mglMetalSetViewColorPixelFormat) If you want to set the pixel format for one window only, first use mglMirrorActivate to activate a single window.\n');
 end
 
+% skip sending if the view already has this format (see mglMetalSkipRedundantCommands)
+[skip, results] = mglPrivateSkipRedundant('mglSetViewColorPixelFormat', uint32(formatIndex), socketInfo);
+if skip
+    return
+end
+
 mglSocketWrite(socketInfo, socketInfo(1).command.mglSetViewColorPixelFormat);
 ackTime = mglSocketRead(socketInfo, 'double');
 mglSocketWrite(socketInfo, uint32(formatIndex));
 results = mglReadCommandResults(socketInfo, ackTime);
+if any([results.processedTime] < 0)
+    mglPrivateSkipRedundant('invalidate', {'pixelFormat'}, socketInfo);
+end
 
@@ -0,0 +1,56 @@
+% mglMetalSkipRedundantCommands: skip commands that would not change mglMetal state
+%
+%      usage: counts = mglMetalSkipRedundantCommands(<skip>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: mglMetal keeps its transform, clear color, selected stencil,
+%             render target and view color pixel format from one frame to
+%             the next. But mglTransform, mglClearScreen and others send
+%             them every time they are called. When this is on, a copy of
+%             that state is kept in Matlab, and commands that would set it
+%             to what it already is are not sent. They return results with
+%             ackTime and processedTime of 0.
+%
+%             skip -- 1 to turn on, 0 to turn off. Leave out to just get
+%                     the counts.
+%
+%             Returns a struct with the number of commands skipped and sent
+%             for each kind of command since it was turned on.
+%
+%             mglOpen;
+%             mglMetalSkipRedundantCommands(1);
+%             mglVisualAngleCoordinates(57,[16 12]);
+%             for iFrame = 1:60
+%               mglClearScreen(0.5);
+%               mglFillOval(0,0,[iFrame iFrame]/10,[1 1 1]);
+%               mglFlush;
+%             end
+%             counts = mglMetalSkipRedundantCommands(0)
+%
+function counts = mglMetalSkipRedundantCommands(skip)
+
+global mgl
+
+% check arguments
+if ~any(nargin == [0 1])
+  help mglMetalSkipRedundantCommands
+  return
+end
+
+% get counts so far
+counts = [];
+if isfield(mgl, 'shadowState') && ~isempty(mgl.shadowState)
+  counts.skipCount = mgl.shadowState.skipCount;
+  counts.sendCount = mgl.shadowState.sendCount;
+end
+
+% turn on or off, starting with nothing known
+if nargin == 1
+  if skip
+    mgl.shadowState = [];
+    [~, mgl.shadowState] = mglPrivateShadowState([], 'invalidate', [], []);
+  else
+    mgl.shadowState = [];
+  end
+end
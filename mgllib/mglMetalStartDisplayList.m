@@ -0,0 +1,56 @@
+% mglMetalStartDisplayList: start recording Metal commands into a display list.
+%
+%      usage: mglMetalStartDisplayList(<socketInfo>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: Put the Mgl Metal app into display list recording state.
+%
+%             Drawing commands sent after this (like mglClearScreen,
+%             mglTransform, mglBltTexture, mglMetalDots, mglQuad,
+%             mglMetalLines, mglDrawGeometry) are kept by the app in a
+%             display list instead of being drawn. Each gets an
+%             immediate placeholder response. Call
+%             mglMetalFinishDisplayList to stop recording and get the
+%             display list, then draw it with one command, as often as
+%             you like, with mglMetalCallDisplayList.
+%
+%             Unlike a command batch (mglMetalStartBatch), which still
+%             sends every command and runs each once, a display list is
+%             sent once and replayed each time it is called, with a few
+%             parameters (texture, transform or color) swapped in.
+%
+%             Commands that flush, repeat across frames, or query the
+%             app (like mglFlush, mglCreateTexture) can't be recorded.
+%             Record display lists between frames, after an mglFlush.
+%
+%             % Record the drawing for a frame once.
+%             mglOpen();
+%             mglVisualAngleCoordinates(57,[16 12]);
+%             tex = mglCreateTexture(255*rand(64,64));
+%             mglMetalStartDisplayList();
+%             mglClearScreen(0.5);
+%             mglBltTexture(tex,[0 0 4 4]);
+%             mglFillRect(0,0,[0.5 0.5],[1 0 0]);
+%             displayList = mglMetalFinishDisplayList();
+%
+%             % Replay it each frame, changing the background color.
+%             for iFrame = 1:60
+%               params.commandIndex = 1;
+%               params.color = [0 0 iFrame/60];
+%               mglMetalCallDisplayList(displayList,params);
+%               mglFlush();
+%             end
+%             mglMetalDeleteDisplayList(displayList);
+%             mglClose();
+function ackTime = mglMetalStartDisplayList(socketInfo)
+
+global mgl
+if nargin < 1 || isempty(socketInfo)
+    socketInfo = mgl.activeSockets;
+end
+
+% send every command while recording, since none of them change state until the list is called
+mglPrivateSkipRedundant('suspend', [], socketInfo);
+mglSocketWrite(socketInfo, socketInfo(1).command.mglStartDisplayList);
+ackTime = mglSocketRead(socketInfo, 'double');
@@ -0,0 +1,60 @@
+% mglMetalTrace: start or stop tracing the mglMetal render loop
+%
+%      usage: [traceFile, results] = mglMetalTrace(<traceFile>, <socketInfo>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: Starts mglMetal writing a low-overhead binary trace of its
+%             render loop (reading commands, each command's work and
+%             drawing, acquiring drawables, committing frames, and when
+%             the GPU finished and frames were presented). Records are
+%             kept in per-thread buffers and written to the file by a
+%             background thread, so tracing is cheap enough to leave on
+%             while running an experiment.
+%
+%             mglMetal runs in a sandbox, so the trace file goes in the
+%             sandbox folder (see mglMetalExecutableName) unless it is a
+%             full path within it. Default is mglMetal.trace. Returns the
+%             full path to the trace file. Call with an empty traceFile
+%             to stop tracing.
+%
+%             Convert the trace with mglMetalTraceToChrome to look at it
+%             in chrome://tracing or https://ui.perfetto.dev
+%
+%             mglOpen;
+%             traceFile = mglMetalTrace;
+%             for iFrame = 1:120, mglClearScreen(rand(1,3));mglFlush;end
+%             mglMetalTrace([]);
+%             mglMetalTraceToChrome(traceFile);
+%
+function [traceFile, results] = mglMetalTrace(traceFile, socketInfo)
+
+global mgl
+if nargin < 1
+  traceFile = 'mglMetal.trace';
+end
+if nargin < 2 || isempty(socketInfo)
+  socketInfo = mgl.activeSockets;
+end
+
+% put the trace file in the sandbox where mglMetal can write it
+if ~isempty(traceFile)
+  [~, mglMetalSandbox] = mglMetalExecutableName;
+  if ~startsWith(traceFile, mglMetalSandbox)
+    [~, name, ext] = fileparts(traceFile);
+    traceFile = fullfile(mglMetalSandbox, [name ext]);
+  end
+end
+
+mglSocketWrite(socketInfo, socketInfo(1).command.mglSetTrace);
+ackTime = mglSocketRead(socketInfo, 'double');
+mglSocketWrite(socketInfo, uint32(length(traceFile)));
+if ~isempty(traceFile)
+  mglSocketWrite(socketInfo, uint16(traceFile));
+end
+results = mglReadCommandResults(socketInfo, ackTime);
+
+% check if processedTime is negative which indicates an error
+if any([results.processedTime] < 0)
+  mglPrivateDisplayProcessingError(socketInfo, results, mfilename);
+end
@@ -0,0 +1,91 @@
+% mglMetalTraceToChrome: convert an mglMetal trace to Chrome trace / Perfetto JSON
+%
+%      usage: [jsonFile, trace] = mglMetalTraceToChrome(traceFile, <jsonFile>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: Reads a binary trace written by mglMetal (see mglMetalTrace)
+%             and writes it as JSON in the Chrome trace event format,
+%             which can be opened in chrome://tracing or
+%             https://ui.perfetto.dev. jsonFile defaults to the trace file
+%             name with a .json extension. Also returns the trace as a
+%             struct with one field per record field (time in seconds,
+%             comparable to mglGetSecs), and the event names.
+%
+%             Each thread in mglMetal shows up as its own track. draw and
+%             nondrawingWork events are named by command, and presented
+%             and gpuDone events have the frame number as their arg.
+%
+function [jsonFile, trace] = mglMetalTraceToChrome(traceFile, jsonFile)
+
+if nargin < 1
+  help mglMetalTraceToChrome
+  return
+end
+if nargin < 2 || isempty(jsonFile)
+  [traceDir, name] = fileparts(traceFile);
+  jsonFile = fullfile(traceDir, [name '.json']);
+end
+
+% read the header, which names the events (see mglTrace.h)
+fid = fopen(traceFile, 'r', 'ieee-le');
+if fid == -1
+  error('(mglMetalTraceToChrome) Could not open trace file %s', traceFile);
+end
+magic = fread(fid, [1 8], '*char');
+if ~strcmp(magic, 'MGLTRACE')
+  fclose(fid);
+  error('(mglMetalTraceToChrome) %s is not an mglMetal trace file', traceFile);
+end
+header = fread(fid, 4, 'uint32');
+recordBytes = header(2);
+eventCount = header(3);
+eventNameBytes = header(4);
+eventNames = cell(1, eventCount);
+for iEvent = 1:eventCount
+  eventNames{iEvent} = deblank(fread(fid, [1 eventNameBytes], '*char'));
+end
+
+% read all the records at once and pick out the fields:
+% uint64 time (ns), uint64 arg, uint16 event, uint8 phase, uint8 reserved, uint32 thread
+bytes = fread(fid, [recordBytes inf], '*uint8');
+fclose(fid);
+trace.time = double(typecast(reshape(bytes(1:8,:), 1, []), 'uint64')) / 1e9;
+trace.arg = double(typecast(reshape(bytes(9:16,:), 1, []), 'uint64'));
+trace.event = double(typecast(reshape(bytes(17:18,:), 1, []), 'uint16'));
+trace.phase = char(bytes(19,:));
+trace.thread = double(typecast(reshape(bytes(21:24,:), 1, []), 'uint32'));
+trace.eventNames = eventNames;
+
+% name command events by command, using the codes shared with mglMetal
+commandCodes = mglSocketCommandTypes();
+commandNames = fieldnames(commandCodes);
+commandValues = cellfun(@(name) double(commandCodes.(name)), commandNames);
+names = eventNames(trace.event + 1);
+isCommandEvent = ismember(names, {'draw', 'nondrawingWork'});
+[isKnownCommand, whichCommand] = ismember(trace.arg, commandValues);
+for iRecord = find(isCommandEvent & isKnownCommand)
+  names{iRecord} = sprintf('%s %s', names{iRecord}, commandNames{whichCommand(iRecord)});
+end
+
+% write the events in the Chrome trace format, with times in microseconds
+% from the first record, and sorted so each track reads in order
+[~, order] = sort(trace.time);
+startTime = min(trace.time);
+events = struct( ...
+  'name', names(order), ...
+  'ph', num2cell(trace.phase(order)), ...
+  'ts', num2cell(1e6 * (trace.time(order) - startTime)), ...
+  'pid', 1, ...
+  'tid', num2cell(trace.thread(order)), ...
+  's', 't', ...
+  'args', num2cell(struct('arg', num2cell(trace.arg(order)))));
+
+fid = fopen(jsonFile, 'w');
+if fid == -1
+  error('(mglMetalTraceToChrome) Could not open %s for writing', jsonFile);
+end
+fprintf(fid, '%s', jsonencode(struct('traceEvents', events, 'displayTimeUnit', 'ms')));
+fclose(fid);
+
+disp(sprintf('(mglMetalTraceToChrome) Wrote %i events to %s', length(events), jsonFile));
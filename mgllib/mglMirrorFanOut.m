@@ -0,0 +1,55 @@
+% mglMirrorFanOut: Send to the primary and mirrored windows at once.
+%
+%      usage: stats = mglMirrorFanOut(<fanOut>, <mirrorTimeout>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: Turn on or off fan-out to the primary and mirrored windows
+%             (see mglSocketFanOut). When on, commands are written to all
+%             windows without blocking, and replies are read as they
+%             arrive, so that a slow mirror does not hold up the reply
+%             from the primary window. The primary window is always waited
+%             for. Mirrors are waited for up to mirrorTimeout seconds
+%             (default Inf, wait as long as it takes), after which their
+%             reply is read as zeros and skipped when it comes.
+%
+%             Returns stats for the primary window followed by each
+%             mirror, with how long their replies took and how many timed
+%             out.
+%
+%             mglOpen(0);
+%             mglMirrorOpen(0);
+%             mglMirrorFanOut(1, 0.05);
+%             mglClearScreen([1 0 0]);
+%             mglFlush;
+%             stats = mglMirrorFanOut(0)
+%
+function stats = mglMirrorFanOut(fanOut, mirrorTimeout)
+
+global mgl
+stats = [];
+
+% check arguments
+if ~any(nargin == [0 1 2])
+  help mglMirrorFanOut
+  return
+end
+if nargin < 1 || isempty(fanOut), fanOut = true; end
+if nargin < 2 || isempty(mirrorTimeout), mirrorTimeout = inf; end
+
+% check that the mex function is compiled
+if exist('mglSocketFanOut')~=3
+  disp(sprintf('(mglMirrorFanOut) mglSocketFanOut is not compiled. Run mglMakeSocket'));
+  return
+end
+
+if ~isfield(mgl,'s') || isempty(mgl.s)
+  disp(sprintf('(mglMirrorFanOut) No mglMetal is open. Run mglOpen first'));
+  return
+end
+
+% primary window first, then the mirrors
+sockets = [mgl.s, mgl.mirrorSockets];
+timeouts = [inf, repmat(mirrorTimeout, 1, numel(mgl.mirrorSockets))];
+stats = mglSocketFanOut(sockets, double(fanOut), timeouts);
+mgl.mirrorFanOut = logical(fanOut);
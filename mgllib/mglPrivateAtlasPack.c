@@ -0,0 +1,88 @@
+#ifdef documentation
+=========================================================================
+
+     program: mglPrivateAtlasPack.c
+          by: justin gardner
+        date: 10/19/2026
+     purpose: packs images of the given sizes onto atlas pages with the
+              skyline packer in mglAtlasPacker.h, for mglAtlasCreate
+   copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+       usage: [page x y nPages] = mglPrivateAtlasPack(widths,heights,[pageWidth pageHeight],<padding>)
+
+              widths and heights are the sizes of each image in pixels.
+              page is the page each image went on, starting at 1, or 0
+              for an image that is too big for a page with its padding.
+              x and y are the column and row of the top left pixel of
+              each image on its page, starting at 1. padding (default 1)
+              is the number of pixels left around each image. nPages is
+              the number of pages used.
+
+=========================================================================
+#endif
+
+/////////////////////////
+//   include section   //
+/////////////////////////
+#include "mgl.h"
+#include "mglAtlasPacker.h"
+
+//////////////
+//   main   //
+//////////////
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+  // check arguments
+  if ((nrhs < 3) || (nrhs > 4) || !mxIsDouble(prhs[0]) || !mxIsDouble(prhs[1]) || mxIsComplex(prhs[0]) || mxIsComplex(prhs[1]) ||
+      (mxGetNumberOfElements(prhs[0]) != mxGetNumberOfElements(prhs[1])) ||
+      !mxIsDouble(prhs[2]) || (mxGetNumberOfElements(prhs[2]) != 2) ||
+      ((nrhs > 3) && (!mxIsDouble(prhs[3]) || (mxGetNumberOfElements(prhs[3]) != 1)))) {
+    usageError("mglPrivateAtlasPack");
+    return;
+  }
+  uint32_t n = (uint32_t)mxGetNumberOfElements(prhs[0]);
+  double pageWidth = mxGetPr(prhs[2])[0];
+  double pageHeight = mxGetPr(prhs[2])[1];
+  double padding = (nrhs > 3) ? mxGetScalar(prhs[3]) : 1;
+  if ((pageWidth < 1) || (pageHeight < 1) || (padding < 0)) {
+    usageError("mglPrivateAtlasPack");
+    return;
+  }
+
+  // sizes as whole pixels
+  uint32_t *widths = (uint32_t *)mxMalloc((n ? n : 1)*sizeof(uint32_t));
+  uint32_t *heights = (uint32_t *)mxMalloc((n ? n : 1)*sizeof(uint32_t));
+  mglAtlasPlacement *placements = (mglAtlasPlacement *)mxMalloc((n ? n : 1)*sizeof(mglAtlasPlacement));
+  uint32_t i;
+  for (i = 0; i < n; i++) {
+    double width = mxGetPr(prhs[0])[i], height = mxGetPr(prhs[1])[i];
+    widths[i] = (width > 0) ? (uint32_t)width : 0;
+    heights[i] = (height > 0) ? (uint32_t)height : 0;
+  }
+
+  uint32_t nPages = 0;
+  if (mglAtlasPack(widths, heights, n, (uint32_t)pageWidth, (uint32_t)pageHeight, (uint32_t)padding, placements, &nPages) < 0) {
+    mexPrintf("(mglPrivateAtlasPack) Could not allocate memory to pack %i images\n", n);
+    nPages = 0;
+    for (i = 0; i < n; i++)
+      placements[i].page = -1;
+  }
+
+  // return with the shape of widths, starting at 1 as Matlab does
+  int output;
+  for (output = 0; (output < 3) && ((output == 0) || (output < nlhs)); output++) {
+    plhs[output] = mxCreateNumericArray(mxGetNumberOfDimensions(prhs[0]), mxGetDimensions(prhs[0]), mxDOUBLE_CLASS, mxREAL);
+    double *values = mxGetPr(plhs[output]);
+    for (i = 0; i < n; i++) {
+      if (output == 0)
+        values[i] = placements[i].page + 1;
+      else if (placements[i].page >= 0)
+        values[i] = ((output == 1) ? placements[i].x : placements[i].y) + 1;
+    }
+  }
+  if (nlhs > 3)
+    plhs[3] = mxCreateDoubleScalar(nPages);
+
+  mxFree(widths);
+  mxFree(heights);
+  mxFree(placements);
+}
@@ -16,6 +16,7 @@ $Id$
 //   include section   //
 /////////////////////////
 #include "mgl.h"
+#include "mglImageReformat.h"
 
 ////////////////////////
 //   define section   //
@@ -101,7 +102,6 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 {
   // declare some variables
   GLenum textureType;
-  int i,j;
   int liveBuffer = 0;
   double *textureParams;
   int profile = 0;
@@ -265,69 +265,10 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     }
 
     
-    // and fill it with the image
-    ////////////////////////////
-    // grayscale image
-    int widthDepth = imageWidth*BYTEDEPTH;
-    int c=0;
-    if (imageType == 1) {
-        for (j = 0; j < imageWidth; j++, c+=BYTEDEPTH) { //cols
-            int colStart = j*imageHeight;
-
-            for (i = 0; i < imageHeight; i++) { //rows
-                int ind = i + colStart;
-                int outind = i*widthDepth;
-
-                imageFormatted[c+outind] = (GLubyte)imageData[ind];
-                imageFormatted[c+outind+1] = (GLubyte)imageData[ind];
-                imageFormatted[c+outind+2] = (GLubyte)imageData[ind];
-                imageFormatted[c+outind+3] = (GLubyte)255;
-            }
-        }
-    }
-    
-    ////////////////////////////
-    // color image
-    else if (imageType == 3) {
-        int imageSize = imageWidth*imageHeight;
-        int imageSize2 = imageSize*2;
-        
-        for (j = 0; j < imageWidth; j++, c+=BYTEDEPTH) {
-            int colStart = j*imageHeight;
-
-            for (i = 0; i < imageHeight; i++) {
-                int ind = i + colStart;
-                int outind = i*widthDepth;
-                
-                imageFormatted[c+outind]   = (GLubyte)imageData[ind];
-                imageFormatted[c+outind+1] = (GLubyte)imageData[ind+imageSize];
-                imageFormatted[c+outind+2] = (GLubyte)imageData[ind+imageSize2];
-                imageFormatted[c+outind+3] = (GLubyte)255;
-            }
-        }
-    }
-    
-    ////////////////////////////
-    // color+alpha image
-    else if (imageType == 4) {
-        int imageSize = imageWidth*imageHeight;
-        int imageSize2 = imageSize*2;
-        int imageSize3 = imageSize*3;
-        
-        for (j = 0; j < imageWidth;j++, c+=BYTEDEPTH) {
-            int colStart = j*imageHeight;
-            
-            for (i = 0; i < imageHeight; i++) {
-                int ind = i + colStart;
-                int outind = i*widthDepth;
-
-                imageFormatted[c+outind] = (GLubyte)imageData[ind];
-                imageFormatted[c+outind+1] = (GLubyte)imageData[ind+imageSize];
-                imageFormatted[c+outind+2] = (GLubyte)imageData[ind+imageSize2];
-                imageFormatted[c+outind+3] = (GLubyte)imageData[ind+imageSize3];
-            }
-        }
-    }
+    // and fill it with the image, a tile at a time on all processors
+    // (grayscale, color or color+alpha, see mglImageReformat.h)
+    int nThreads = mglImageReformat(imageData,imageHeight,imageWidth,(int)imageType,imageFormatted,0);
+    if (profile) mexPrintf("(mglPrivateCreateTexture) Reformatting on %i threads\n",nThreads);
   }
 
   
@@ -0,0 +1,169 @@
+#ifdef documentation
+=========================================================================
+
+     program: mglPrivateDotMotion.c
+          by: justin gardner
+        date: 10/19/2026
+     purpose: runs the procedural dot motion that mglMetal uses for
+              mglMetalRepeatingDotMotion (mglDotMotion.h) for a number of
+              frames so that it can be checked against dotMotionFrame.m.
+              Starting from rng(seed,'twister') dotMotionFrame should give
+              the same dots (see mglTestDotMotion).
+   copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+       usage: [coords direction lifetime] = mglPrivateDotMotion(stimParams,displayParams,nFrames,seed)
+
+              stimParams has the fields nPoints, coherence,
+              coherentMotionType, incoherentMotionType, speed, lifetime,
+              direction and spatial.origin as for dotMotionFrame.
+              displayParams has fields frameRate and deviceRect.
+
+              coords is nPoints x 2 x nFrames, direction and lifetime are
+              nPoints x nFrames, each column is the state after that frame
+
+=========================================================================
+#endif
+
+/////////////////////////
+//   include section   //
+/////////////////////////
+#include "mgl.h"
+#include "mglDotMotion.h"
+
+///////////////////////////////
+//   function declarations   //
+///////////////////////////////
+static int getParams(const mxArray *stimParams, const mxArray *displayParams, mglDotMotionParams *params, uint32_t *nDots);
+static int getDouble(const mxArray *s, const char *fieldName, double *value, size_t n);
+static int getType(const mxArray *s, const char *fieldName, const char **names, int nNames, uint32_t *type);
+
+//////////////
+//   main   //
+//////////////
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+  // check arguments
+  if ((nrhs != 4) || !mxIsStruct(prhs[0]) || !mxIsStruct(prhs[1])) {
+    usageError("mglPrivateDotMotion");
+    return;
+  }
+
+  // get parameters
+  mglDotMotionParams params;
+  uint32_t nDots;
+  if (!getParams(prhs[0],prhs[1],&params,&nDots)) return;
+  size_t nFrames = (size_t)mxGetScalar(prhs[2]);
+  uint32_t seed = (uint32_t)mxGetScalar(prhs[3]);
+
+  // create the dots
+  mglDotMotionState state;
+  if (!mglDotMotionCreate(&state,nDots,seed)) {
+    mglDotMotionDestroy(&state);
+    mexErrMsgTxt("(mglPrivateDotMotion) Could not allocate memory for dots");
+  }
+
+  // create outputs
+  mwSize coordsDims[3] = {nDots,2,nFrames};
+  plhs[0] = mxCreateNumericArray(3,coordsDims,mxDOUBLE_CLASS,mxREAL);
+  plhs[1] = mxCreateDoubleMatrix(nDots,nFrames,mxREAL);
+  plhs[2] = mxCreateDoubleMatrix(nDots,nFrames,mxREAL);
+  double *coords = mxGetPr(plhs[0]), *direction = mxGetPr(plhs[1]), *lifetime = mxGetPr(plhs[2]);
+
+  // run the frames
+  size_t frameNum;
+  for (frameNum = 0; frameNum < nFrames; frameNum++) {
+    mglDotMotionFrame(&state,&params);
+    memcpy(coords+2*nDots*frameNum,state.x,nDots*sizeof(double));
+    memcpy(coords+2*nDots*frameNum+nDots,state.y,nDots*sizeof(double));
+    memcpy(direction+nDots*frameNum,state.direction,nDots*sizeof(double));
+    memcpy(lifetime+nDots*frameNum,state.lifetime,nDots*sizeof(double));
+  }
+  mglDotMotionDestroy(&state);
+}
+
+///////////////////
+//   getParams   //
+///////////////////
+static int getParams(const mxArray *stimParams, const mxArray *displayParams, mglDotMotionParams *params, uint32_t *nDots)
+{
+  const char *coherentNames[] = {"expanding","contracting","translating","rotating"};
+  const char *incoherentNames[] = {"random","brownian","movshon"};
+  double nPoints;
+
+  memset(params,0,sizeof(mglDotMotionParams));
+  if (!getDouble(stimParams,"nPoints",&nPoints,1) ||
+      !getDouble(stimParams,"coherence",&params->coherence,1) ||
+      !getDouble(stimParams,"speed",&params->speed,1) ||
+      !getDouble(stimParams,"lifetime",&params->lifetime,1) ||
+      !getType(stimParams,"coherentMotionType",coherentNames,4,&params->coherentMotionType) ||
+      !getType(stimParams,"incoherentMotionType",incoherentNames,3,&params->incoherentMotionType) ||
+      !getDouble(displayParams,"frameRate",&params->frameRate,1) ||
+      !getDouble(displayParams,"deviceRect",params->deviceRect,4))
+    return 0;
+  *nDots = (uint32_t)nPoints;
+
+  // origin is needed for expanding and contracting
+  mxArray *spatial = mxGetField(stimParams,0,"spatial");
+  if ((spatial != NULL) && mxIsStruct(spatial) && (mxGetField(spatial,0,"origin") != NULL)) {
+    if (!getDouble(spatial,"origin",params->origin,2)) return 0;
+  }
+  else if ((params->coherentMotionType == mglDotMotionExpanding) || (params->coherentMotionType == mglDotMotionContracting)) {
+    mexPrintf("(mglPrivateDotMotion) stimParams.spatial.origin is needed for %s motion\n",coherentNames[params->coherentMotionType]);
+    return 0;
+  }
+
+  // directions are needed for translating
+  mxArray *direction = mxGetField(stimParams,0,"direction");
+  if (direction != NULL) {
+    params->nDirections = (uint32_t)mxGetNumberOfElements(direction);
+    if ((params->nDirections > MGL_DOT_MOTION_MAX_DIRECTIONS) || !getDouble(stimParams,"direction",params->direction,params->nDirections)) {
+      mexPrintf("(mglPrivateDotMotion) stimParams.direction should have at most %i directions\n",MGL_DOT_MOTION_MAX_DIRECTIONS);
+      return 0;
+    }
+  }
+  if ((params->coherentMotionType == mglDotMotionTranslating) && (params->nDirections == 0)) {
+    mexPrintf("(mglPrivateDotMotion) stimParams.direction is needed for translating motion\n");
+    return 0;
+  }
+  return 1;
+}
+
+///////////////////
+//   getDouble   //
+///////////////////
+// get n doubles from a numeric field
+static int getDouble(const mxArray *s, const char *fieldName, double *value, size_t n)
+{
+  mxArray *field = mxGetField(s,0,fieldName);
+  if ((field == NULL) || !mxIsDouble(field) || mxIsComplex(field) || (mxGetNumberOfElements(field) != n)) {
+    mexPrintf("(mglPrivateDotMotion) Field %s should be %i double value(s)\n",fieldName,(int)n);
+    return 0;
+  }
+  memcpy(value,mxGetPr(field),n*sizeof(double));
+  return 1;
+}
+
+/////////////////
+//   getType   //
+/////////////////
+// convert a motion type name to its code
+static int getType(const mxArray *s, const char *fieldName, const char **names, int nNames, uint32_t *type)
+{
+  mxArray *field = mxGetField(s,0,fieldName);
+  if ((field != NULL) && mxIsChar(field)) {
+    char *name = mxArrayToString(field);
+    int i;
+    for (i = 0; i < nNames; i++) {
+      if (strcmp(name,names[i]) == 0) {
+        *type = i;
+        mxFree(name);
+        return 1;
+      }
+    }
+    mxFree(name);
+  }
+  mexPrintf("(mglPrivateDotMotion) Field %s should be one of:",fieldName);
+  int i;
+  for (i = 0; i < nNames; i++) mexPrintf(" %s",names[i]);
+  mexPrintf("\n");
+  return 0;
+}
@@ -0,0 +1,62 @@
+#ifdef documentation
+=========================================================================
+
+     program: mglPrivateExpandArcs.c
+          by: justin gardner
+        date: 10/19/2026
+     purpose: expands arc records [xyz rgba radii wedge border], as
+              mglMetalArcs sends them, into the vertices that the
+              vertex_arcs shader makes for each instance (mglArcs.h), so
+              that the packing can be checked without a GPU
+              (see mglTestInstancedArcs)
+   copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+       usage: vertices = mglPrivateExpandArcs(records,viewportSize)
+
+              records is 14 x nArcs, viewportSize is [width height] and
+              vertices is 19 x (6*nArcs) with each column
+              [xyz rgba radii wedge border centerPosition viewportSize],
+              which is what mglArcsCommand used to copy for each vertex
+
+=========================================================================
+#endif
+
+/////////////////////////
+//   include section   //
+/////////////////////////
+#include "mgl.h"
+#include "mglArcs.h"
+
+//////////////
+//   main   //
+//////////////
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+  // check arguments
+  if ((nrhs != 2) || !mxIsNumeric(prhs[0]) || mxIsComplex(prhs[0]) || (mxGetM(prhs[0]) != MGL_ARC_VALUES) || !mxIsDouble(prhs[1]) || (mxGetNumberOfElements(prhs[1]) != 2)) {
+    usageError("mglPrivateExpandArcs");
+    return;
+  }
+  uint32_t nArcs = (uint32_t)mxGetN(prhs[0]);
+  double *viewportSize = mxGetPr(prhs[1]);
+
+  // convert records to single, as they are sent to mglMetal
+  float *records = (float *)mxMalloc((nArcs ? nArcs : 1)*MGL_ARC_VALUES*sizeof(float));
+  if (mxIsSingle(prhs[0]))
+    memcpy(records,mxGetData(prhs[0]),nArcs*MGL_ARC_VALUES*sizeof(float));
+  else if (mxIsDouble(prhs[0])) {
+    double *doubleRecords = mxGetPr(prhs[0]);
+    size_t i;
+    for (i = 0; i < nArcs*MGL_ARC_VALUES; i++)
+      records[i] = (float)doubleRecords[i];
+  }
+  else {
+    mxFree(records);
+    usageError("mglPrivateExpandArcs");
+    return;
+  }
+
+  // expand and return as single
+  plhs[0] = mxCreateNumericMatrix(MGL_ARC_VERTEX_VALUES,MGL_ARC_VERTICES*nArcs,mxSINGLE_CLASS,mxREAL);
+  mglArcsExpand(records,nArcs,(float)viewportSize[0],(float)viewportSize[1],(float *)mxGetData(plhs[0]));
+  mxFree(records);
+}
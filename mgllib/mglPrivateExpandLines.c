@@ -0,0 +1,59 @@
+#ifdef documentation
+=========================================================================
+
+     program: mglPrivateExpandLines.c
+          by: justin gardner
+        date: 10/19/2026
+     purpose: expands line records [x0 y0 x1 y1 width rgba] into the
+              quads that mglMetal draws for them (mglInstancedLines.h),
+              so that the expansion can be checked without a GPU
+              (see mglTestInstancedLines)
+   copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+       usage: vertices = mglPrivateExpandLines(records)
+
+              records is 9 x nLines, vertices is 7 x (6*nLines) with
+              each column [xyz rgba], two triangles per line in the
+              same order as mglQuad
+
+=========================================================================
+#endif
+
+/////////////////////////
+//   include section   //
+/////////////////////////
+#include "mgl.h"
+#include "mglInstancedLines.h"
+
+//////////////
+//   main   //
+//////////////
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+  // check arguments
+  if ((nrhs != 1) || !mxIsNumeric(prhs[0]) || mxIsComplex(prhs[0]) || (mxGetM(prhs[0]) != MGL_INSTANCED_LINE_VALUES)) {
+    usageError("mglPrivateExpandLines");
+    return;
+  }
+  uint32_t nLines = (uint32_t)mxGetN(prhs[0]);
+
+  // convert records to single, as they are sent to mglMetal
+  float *records = (float *)mxMalloc((nLines ? nLines : 1)*MGL_INSTANCED_LINE_VALUES*sizeof(float));
+  if (mxIsSingle(prhs[0]))
+    memcpy(records,mxGetData(prhs[0]),nLines*MGL_INSTANCED_LINE_VALUES*sizeof(float));
+  else if (mxIsDouble(prhs[0])) {
+    double *doubleRecords = mxGetPr(prhs[0]);
+    size_t i;
+    for (i = 0; i < nLines*MGL_INSTANCED_LINE_VALUES; i++)
+      records[i] = (float)doubleRecords[i];
+  }
+  else {
+    mxFree(records);
+    usageError("mglPrivateExpandLines");
+    return;
+  }
+
+  // expand and return as single
+  plhs[0] = mxCreateNumericMatrix(MGL_INSTANCED_LINE_VERTEX_VALUES,MGL_INSTANCED_LINE_VERTICES*nLines,mxSINGLE_CLASS,mxREAL);
+  mglInstancedLinesExpand(records,nLines,(float *)mxGetData(plhs[0]));
+  mxFree(records);
+}
@@ -0,0 +1,162 @@
+#ifdef documentation
+=========================================================================
+
+     program: mglPrivateFrameStreamWrite.c
+          by: justin gardner
+        date: 10/19/2026
+     purpose: writes frames to a frame stream file (see mglFrameStream.h)
+              that mglMetal can map into memory and show frame by frame,
+              for mglFrameStreamWrite
+   copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+       usage: ok = mglPrivateFrameStreamWrite(filename,frames,frameRate,runLength)
+
+              frames is height x width x channels x n, or a cell array of
+              n frames each height x width x channels, all the same size
+              and class, with 1 (gray), 3 (rgb) or 4 (rgba) channels.
+              uint8 frames are written as 8 bit rgba. single frames,
+              which should be 0-1, are written as float rgba. double
+              frames are written as 8 bit rgba, from 0-1, or from 0-255
+              if any value is bigger than 1. With runLength set, frames
+              that are smaller run length encoded are written that way.
+              Returns 1 if the whole file was written.
+
+=========================================================================
+#endif
+
+/////////////////////////
+//   include section   //
+/////////////////////////
+#include "mgl.h"
+#include "mglFrameStream.h"
+
+///////////////////////////////
+//   function declarations   //
+///////////////////////////////
+static const mxArray *getFrame(const mxArray *frames, size_t frame, size_t *dims);
+static void reformatFrame(const mxArray *frames, size_t frame, const size_t *dims, double scale, uint8_t *pixels);
+
+//////////////
+//   main   //
+//////////////
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+  // check arguments
+  if ((nrhs != 4) || !mxIsChar(prhs[0]) || (!mxIsCell(prhs[1]) && !mxIsNumeric(prhs[1])) ||
+      !mxIsDouble(prhs[2]) || !mxIsDouble(prhs[3])) {
+    usageError("mglPrivateFrameStreamWrite");
+    return;
+  }
+  plhs[0] = mxCreateDoubleScalar(0);
+
+  // size of every frame, which all need to be the same
+  size_t frameCount = mxIsCell(prhs[1]) ? mxGetNumberOfElements(prhs[1]) : 1;
+  size_t dims[4] = {0, 0, 1, 1};
+  const mxArray *first = getFrame(prhs[1], 0, dims);
+  if (!mxIsCell(prhs[1])) frameCount = dims[3];
+  if ((first == NULL) || (frameCount == 0) || (dims[0] == 0) || (dims[1] == 0) || (mxIsCell(prhs[1]) && (dims[3] != 1)) ||
+      ((dims[2] != 1) && (dims[2] != 3) && (dims[2] != 4)) ||
+      (!mxIsUint8(first) && !mxIsSingle(first) && !mxIsDouble(first)) || mxIsComplex(first)) {
+    mexPrintf("(mglPrivateFrameStreamWrite) Frames must be height x width x 1, 3 or 4 channels of uint8, single or double\n");
+    return;
+  }
+  mxClassID classID = mxGetClassID(first);
+  size_t frame;
+  for (frame = 1; mxIsCell(prhs[1]) && (frame < frameCount); frame++) {
+    size_t frameDims[4] = {0, 0, 1, 1};
+    const mxArray *other = getFrame(prhs[1], frame, frameDims);
+    if ((other == NULL) || (mxGetClassID(other) != classID) || memcmp(frameDims, dims, 3 * sizeof(size_t)) || (frameDims[3] != 1)) {
+      mexPrintf("(mglPrivateFrameStreamWrite) Frame %i is not the same size and class as the first\n", (int)frame + 1);
+      return;
+    }
+  }
+
+  // double frames are 0-255 if any value is bigger than 1
+  double scale = 1;
+  if (classID == mxDOUBLE_CLASS) {
+    scale = 255;
+    for (frame = 0; (frame < frameCount) && (scale == 255); frame++) {
+      const mxArray *frameArray = mxIsCell(prhs[1]) ? mxGetCell(prhs[1], frame) : prhs[1];
+      const double *values = mxGetPr(frameArray);
+      size_t count = mxGetNumberOfElements(frameArray), i;
+      for (i = 0; i < count; i++) {
+        if (values[i] > 1) {
+          scale = 1;
+          break;
+        }
+      }
+    }
+  }
+
+  char *filename = mxArrayToString(prhs[0]);
+  uint32_t pixelFormat = (classID == mxSINGLE_CLASS) ? mglFrameStreamRGBA32Float : mglFrameStreamRGBA8;
+  mglFrameStreamWriter writer;
+  if (!mglFrameStreamWriterOpen(&writer, filename, (uint32_t)dims[1], (uint32_t)dims[0], pixelFormat, mxGetScalar(prhs[2]), mxGetScalar(prhs[3]) != 0)) {
+    mexPrintf("(mglPrivateFrameStreamWrite) Could not open %s for writing\n", filename);
+    mxFree(filename);
+    return;
+  }
+
+  // reformat each frame into rows of rgba, top row first, and add it
+  uint8_t *pixels = (uint8_t *)mxMalloc(dims[0] * dims[1] * mglFrameStreamPixelBytes(pixelFormat));
+  int written = 1;
+  for (frame = 0; (frame < frameCount) && written; frame++) {
+    reformatFrame(prhs[1], frame, dims, scale, pixels);
+    written = mglFrameStreamWriterAdd(&writer, pixels);
+  }
+  if (!mglFrameStreamWriterClose(&writer) || !written) {
+    mexPrintf("(mglPrivateFrameStreamWrite) Could not write all %i frames to %s\n", (int)frameCount, filename);
+  } else {
+    *mxGetPr(plhs[0]) = 1;
+  }
+  mxFree(pixels);
+  mxFree(filename);
+}
+
+//////////////////
+//   getFrame   //
+//////////////////
+// the array a frame is in, with its dimensions as height, width, channels and frames
+static const mxArray *getFrame(const mxArray *frames, size_t frame, size_t *dims)
+{
+  const mxArray *frameArray = mxIsCell(frames) ? mxGetCell(frames, frame) : frames;
+  if ((frameArray == NULL) || !mxIsNumeric(frameArray) || (mxGetNumberOfDimensions(frameArray) > 4))
+    return NULL;
+  size_t i;
+  for (i = 0; i < mxGetNumberOfDimensions(frameArray); i++)
+    dims[i] = mxGetDimensions(frameArray)[i];
+  return frameArray;
+}
+
+///////////////////////
+//   reformatFrame   //
+///////////////////////
+// Matlab frames are column major with channels last, the file is rows of rgba pixels
+static void reformatFrame(const mxArray *frames, size_t frame, const size_t *dims, double scale, uint8_t *pixels)
+{
+  const mxArray *frameArray = mxIsCell(frames) ? mxGetCell(frames, frame) : frames;
+  size_t height = dims[0], width = dims[1], channels = dims[2];
+  size_t planeCount = height * width;
+  size_t frameOffset = mxIsCell(frames) ? 0 : frame * planeCount * channels;
+  mxClassID classID = mxGetClassID(frameArray);
+  size_t x, y, c;
+  for (y = 0; y < height; y++) {
+    for (x = 0; x < width; x++) {
+      size_t pixel = y * width + x;
+      size_t source = frameOffset + x * height + y;
+      for (c = 0; c < 4; c++) {
+        // gray is copied to rgb, and alpha is 1 when not given
+        size_t channel = (channels == 1) ? 0 : c;
+        int hasChannel = (c < 3) || (channels == 4);
+        size_t index = source + channel * planeCount;
+        if (classID == mxSINGLE_CLASS) {
+          ((float *)pixels)[pixel * 4 + c] = hasChannel ? ((const float *)mxGetData(frameArray))[index] : 1.0f;
+        } else if (classID == mxUINT8_CLASS) {
+          pixels[pixel * 4 + c] = hasChannel ? ((const uint8_t *)mxGetData(frameArray))[index] : 255;
+        } else {
+          double value = hasChannel ? mxGetPr(frameArray)[index] * scale : 255;
+          pixels[pixel * 4 + c] = (uint8_t)((value < 0) ? 0 : ((value > 255) ? 255 : value + 0.5));
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,577 @@
+#ifdef documentation
+=========================================================================
+
+     program: mglPrivateGetTaskParameters.c
+          by: justin gardner
+        date: 10/19/2026
+     purpose: native version of the event loop in getTaskParameters. Walks
+              the myscreen.events columns once for a task and groups them
+              by phase, trial and segment, returning per-trial timing,
+              volume, block, response and user trace arrays along with the
+              trials structure. Parameters and randVars are filled in by
+              getTaskParameters from the returned block numbers. Returns a
+              status of -1 for anything it does not handle exactly the
+              same way as the m-file, so that getTaskParameters can fall
+              back on its own loop.
+   copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+       usage: [phases volumeTR status] = mglPrivateGetTaskParameters(events,phaseInfo,stimtrace,numTraces,volumeTR)
+
+              phaseInfo is a struct array with one element per phase and
+              fields segmentTrace, phaseTrace, responseTrace, numTrials,
+              blockTrialn (trialn of each block) and getResponse ([] if
+              the task does not have the field, hasGetResponse says which)
+
+              status is 0 if all events were processed, 1 if events were
+              recorded past the end of the last trial and -1 if the m-file
+              should be used instead.
+
+=========================================================================
+#endif
+
+/////////////////////////
+//   include section   //
+/////////////////////////
+#include "mgl.h"
+
+/////////////////
+//   defines   //
+/////////////////
+#define STATUS_OK 0
+#define STATUS_PAST_END 1
+#define STATUS_FALLBACK -1
+
+//////////////////
+//   typedefs   //
+//////////////////
+// a growable row of doubles, which becomes [] when empty like in matlab
+typedef struct doubleRow {
+  double *data;
+  size_t n;
+  size_t allocated;
+} doubleRow;
+
+// everything kept for one trial
+typedef struct trialRecord {
+  doubleRow response, responseVolume, responseSegnum, reactionTime, responseTimeRaw;
+  doubleRow traceTracenum, traceVal, traceTime;
+  doubleRow segtime, volnum, ticknum;
+} trialRecord;
+
+// everything kept for one phase
+typedef struct phaseRecord {
+  int entered;
+  double nTrials;
+  size_t trialCount, trialsAllocated;
+  doubleRow trialTime, trialTicknum, trialVolume, blockNum, blockTrialNum;
+  doubleRow response, responseVolume, reactionTime, responseTimeRaw;
+  double *traces;
+  trialRecord *trials;
+} phaseRecord;
+
+// settings for one phase
+typedef struct phaseSettings {
+  double segmentTrace, phaseTrace, responseTrace, numTrials;
+  double *blockTrialn;
+  size_t nBlocks;
+  double *getResponse;
+  size_t getResponseLength;
+  int hasGetResponse;
+} phaseSettings;
+
+///////////////////////////////
+//   function declarations   //
+///////////////////////////////
+static void rowSet(doubleRow *row, size_t index, double value);
+static void rowAppend(doubleRow *row, double value);
+static mxArray *rowToArray(doubleRow *row);
+static void rowFree(doubleRow *row);
+static double *getNumericField(const mxArray *s, mwIndex index, const char *fieldName, size_t *length);
+static double getScalarField(const mxArray *s, mwIndex index, const char *fieldName, int *ok);
+static double medianOfNotNan(const double *x, size_t n);
+static int compareDoubles(const void *a, const void *b);
+static int signOf(double x);
+static mxArray *makePhasesOutput(phaseRecord *phases, size_t nPhases, size_t numTraces);
+static void freePhases(phaseRecord *phases, size_t nPhases);
+static void returnFallback(mxArray *plhs[], const mxArray *volumeTR);
+
+//////////////
+//   main   //
+//////////////
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+  // check arguments
+  if ((nrhs != 5) || !mxIsStruct(prhs[0]) || !mxIsStruct(prhs[1])) {
+    usageError("mglPrivateGetTaskParameters");
+    returnFallback(plhs,(nrhs == 5) ? prhs[4] : NULL);
+    return;
+  }
+  int verbose = (int)mglGetGlobalDouble("verbose");
+
+  // get the events
+  int ok = 1;
+  size_t n = (size_t)getScalarField(prhs[0],0,"n",&ok);
+  size_t tracenumLength, dataLength, timeLength, ticknumLength, volnumLength;
+  double *tracenum = getNumericField(prhs[0],0,"tracenum",&tracenumLength);
+  double *data = getNumericField(prhs[0],0,"data",&dataLength);
+  double *eventTime = getNumericField(prhs[0],0,"time",&timeLength);
+  double *ticknum = getNumericField(prhs[0],0,"ticknum",&ticknumLength);
+  double *eventVolnum = getNumericField(prhs[0],0,"volnum",&volnumLength);
+  if (!ok || !tracenum || !data || !eventTime || !ticknum || !eventVolnum || (tracenumLength < n) || (dataLength < n) || (timeLength < n) || (ticknumLength < n) || (volnumLength < n) || (tracenumLength != dataLength)) {
+    if (verbose) mexPrintf("(mglPrivateGetTaskParameters) Events are missing fields or are not numeric\n");
+    mxFree(tracenum);mxFree(data);mxFree(eventTime);mxFree(ticknum);mxFree(eventVolnum);
+    returnFallback(plhs,prhs[4]);
+    return;
+  }
+
+  // get the settings for each phase
+  size_t phaseNum, nPhases = mxGetNumberOfElements(prhs[1]);
+  phaseSettings *settings = (phaseSettings *)mxCalloc(nPhases > 0 ? nPhases : 1,sizeof(phaseSettings));
+  for (phaseNum = 0; phaseNum < nPhases; phaseNum++) {
+    settings[phaseNum].segmentTrace = getScalarField(prhs[1],phaseNum,"segmentTrace",&ok);
+    settings[phaseNum].phaseTrace = getScalarField(prhs[1],phaseNum,"phaseTrace",&ok);
+    settings[phaseNum].responseTrace = getScalarField(prhs[1],phaseNum,"responseTrace",&ok);
+    settings[phaseNum].numTrials = getScalarField(prhs[1],phaseNum,"numTrials",&ok);
+    settings[phaseNum].hasGetResponse = (int)getScalarField(prhs[1],phaseNum,"hasGetResponse",&ok);
+    settings[phaseNum].blockTrialn = getNumericField(prhs[1],phaseNum,"blockTrialn",&settings[phaseNum].nBlocks);
+    settings[phaseNum].getResponse = getNumericField(prhs[1],phaseNum,"getResponse",&settings[phaseNum].getResponseLength);
+    if ((settings[phaseNum].blockTrialn == NULL) || (settings[phaseNum].getResponse == NULL)) ok = 0;
+  }
+  double stimtrace = mxGetScalar(prhs[2]);
+  size_t numTraces = (size_t)mxGetScalar(prhs[3]);
+  if (!ok || (nPhases < 1) || !(mxIsDouble(prhs[4]) || mxIsEmpty(prhs[4]))) {
+    if (verbose) mexPrintf("(mglPrivateGetTaskParameters) Could not get phase settings\n");
+    mxFree(tracenum);mxFree(data);mxFree(eventTime);mxFree(ticknum);mxFree(eventVolnum);
+    for (phaseNum = 0; phaseNum < nPhases; phaseNum++) {mxFree(settings[phaseNum].blockTrialn);mxFree(settings[phaseNum].getResponse);}
+    mxFree(settings);
+    returnFallback(plhs,prhs[4]);
+    return;
+  }
+
+  // copy volumeTR, which keeps growing across tasks
+  doubleRow volumeTR = {NULL,0,0};
+  size_t i, volumeTRInLength = mxGetNumberOfElements(prhs[4]);
+  double *volumeTRIn = mxIsEmpty(prhs[4]) ? NULL : mxGetPr(prhs[4]);
+  for (i = 0; i < volumeTRInLength; i++)
+    rowAppend(&volumeTR,volumeTRIn[i]);
+
+  // the m-file looks for the next volume event (tracenum 1 with data 1)
+  // after each backtick with a find. Do that once for all events here,
+  // going backwards, over the whole length of the event arrays
+  size_t *nextVolEvent = (size_t *)mxCalloc(tracenumLength+1,sizeof(size_t));
+  size_t nextVol = 0;
+  for (i = tracenumLength; i > 0; i--) {
+    nextVolEvent[i-1] = nextVol;
+    if ((tracenum[i-1] == 1) && (data[i-1] == 1)) nextVol = i;
+  }
+
+  // allocate per-phase records
+  phaseRecord *phases = (phaseRecord *)mxCalloc(nPhases,sizeof(phaseRecord));
+
+  // init some variables the same way as the m-file
+  double exptStartTime = mxGetInf();
+  double volnum = 0, nextVolNum = 1, volTime = 0, nextVolTime = mxGetInf();
+  double thisseg = 0, segtime = 0;
+  size_t blockNum = 1, blockTrialNum = 0, tnum = 0;
+  int status = STATUS_OK;
+  phaseNum = 1;
+  phases[0].entered = 1;
+  phaseSettings *phase = &settings[0];
+  phaseRecord *record = &phases[0];
+
+  size_t enumber;
+  for (enumber = 0; (enumber < n) && (status == STATUS_OK); enumber++) {
+    double thisTracenum = tracenum[enumber];
+    double thisData = data[enumber];
+    double thisTime = eventTime[enumber];
+    // get the volume number of the event, if we are closer to the next volume
+    // than the current one, then use the following volume
+    volnum = eventVolnum[enumber];
+    if ((thisTime-volTime) > (nextVolTime-thisTime))
+      volnum = nextVolNum;
+    // deal with segment trace
+    if (thisTracenum == phase->segmentTrace) {
+      if ((round(thisData) != thisData) || (thisData < 1)) {
+        mexPrintf("(getTaskParameters) Bad segmentTrace (%i) value %i at %i\n",(int)thisTracenum,(int)thisData,(int)(enumber+1));
+        continue;
+      }
+      thisseg = thisData;
+      segtime = thisTime;
+      // check for new trial
+      if (thisseg == 1) {
+        tnum++;
+        if (tnum > phase->numTrials) {
+          status = STATUS_PAST_END;
+          break;
+        }
+        record->nTrials = tnum;
+        exptStartTime = fmin(segtime,exptStartTime);
+        // see if we have to go over to the next block
+        blockTrialNum++;
+        if (blockNum > phase->nBlocks) {status = STATUS_FALLBACK;break;}
+        if (phase->blockTrialn[blockNum-1] < blockTrialNum) {
+          blockNum++;
+          blockTrialNum = 1;
+        }
+        if (blockNum > phase->nBlocks) {status = STATUS_FALLBACK;break;}
+        // grow the trial list
+        if (tnum > record->trialsAllocated) {
+          size_t oldAllocated = record->trialsAllocated;
+          record->trialsAllocated = (oldAllocated == 0) ? 64 : 2*oldAllocated;
+          record->trials = (trialRecord *)mxRealloc(record->trials,record->trialsAllocated*sizeof(trialRecord));
+          memset(record->trials+oldAllocated,0,(record->trialsAllocated-oldAllocated)*sizeof(trialRecord));
+          record->traces = (double *)mxRealloc(record->traces,(numTraces > 0 ? numTraces : 1)*record->trialsAllocated*sizeof(double));
+        }
+        record->trialCount = tnum;
+        rowSet(&record->trialTime,tnum-1,segtime-exptStartTime);
+        rowSet(&record->trialTicknum,tnum-1,ticknum[enumber]);
+        rowSet(&record->trialVolume,tnum-1,volnum);
+        rowSet(&record->blockNum,tnum-1,blockNum);
+        rowSet(&record->blockTrialNum,tnum-1,blockTrialNum);
+        for (i = 0; i < numTraces; i++)
+          record->traces[i+(tnum-1)*numTraces] = mxGetNaN();
+        rowSet(&record->response,tnum-1,mxGetNaN());
+        rowSet(&record->responseVolume,tnum-1,mxGetNaN());
+        rowSet(&record->reactionTime,tnum-1,mxGetNaN());
+        rowSet(&record->responseTimeRaw,tnum-1,mxGetNaN());
+      }
+      // set the segment time for this trial
+      if (tnum == 0) {status = STATUS_FALLBACK;break;}
+      segtime = segtime-exptStartTime;
+      trialRecord *trial = &record->trials[tnum-1];
+      rowSet(&trial->segtime,(size_t)thisseg-1,segtime);
+      rowSet(&trial->volnum,(size_t)thisseg-1,volnum);
+      rowSet(&trial->ticknum,(size_t)thisseg-1,ticknum[enumber]);
+    }
+    // deal with volnum event
+    else if (thisTracenum == 1) {
+      // if data is set to one then it means that we got a backtick
+      if (thisData) {
+        volTime = thisTime;
+        // get the next volume time
+        if (nextVolEvent[enumber]) {
+          size_t next = nextVolEvent[enumber]-1;
+          if ((next >= timeLength) || (next >= volnumLength)) {status = STATUS_FALLBACK;break;}
+          nextVolTime = eventTime[next];
+          nextVolNum = eventVolnum[next]+1;
+        }
+        else {
+          // set the final+1 volume to happen one volume later, so that events
+          // after the last volume get a volume number of nan
+          double medianTR = medianOfNotNan(volumeTR.data,volumeTR.n);
+          nextVolTime = mxIsNaN(medianTR) ? mxGetInf() : volTime+medianTR;
+          nextVolNum = mxGetNaN();
+        }
+        // keep the amount of time each volume takes
+        rowAppend(&volumeTR,nextVolTime-volTime);
+      }
+    }
+    // deal with phasenum event
+    else if (thisTracenum == phase->phaseTrace) {
+      if ((thisData != round(thisData)) || (thisData < 1)) {status = STATUS_FALLBACK;break;}
+      phaseNum = (size_t)thisData;
+      if (phaseNum <= nPhases) {
+        // the m-file does not fully reinitialize a phase that is entered twice
+        if (phases[phaseNum-1].entered) {status = STATUS_FALLBACK;break;}
+        blockNum = 1;
+        blockTrialNum = 0;
+        phase = &settings[phaseNum-1];
+        record = &phases[phaseNum-1];
+        record->entered = 1;
+        record->nTrials = 1;
+        tnum = 0;
+      }
+      else
+        break;
+    }
+    // deal with response
+    else if (thisTracenum == phase->responseTrace) {
+      double whichButton = thisData;
+      if (tnum) {
+        // reaction time relative to beginning of segment, and response
+        // time relative to the beginning of the experiment
+        double reactionTime = thisTime-exptStartTime-segtime;
+        double responseTimeRaw = thisTime-exptStartTime;
+        trialRecord *trial = &record->trials[tnum-1];
+        // add the length of previous segments in which the subject could have responded
+        if (phase->hasGetResponse && (phase->getResponseLength >= thisseg)) {
+          long s = (long)thisseg-1;
+          while ((s >= 1) && phase->getResponse[s-1]) {
+            if (s >= (long)trial->segtime.n) {status = STATUS_FALLBACK;break;}
+            reactionTime = reactionTime+(trial->segtime.data[s]-trial->segtime.data[s-1]);
+            s--;
+          }
+          if (status != STATUS_OK) break;
+        }
+        // save the first response in the response array
+        if (mxIsNaN(record->response.data[tnum-1])) {
+          record->response.data[tnum-1] = whichButton;
+          record->reactionTime.data[tnum-1] = reactionTime;
+          record->responseTimeRaw.data[tnum-1] = responseTimeRaw;
+          record->responseVolume.data[tnum-1] = volnum;
+        }
+        // save all responses in trial
+        rowAppend(&trial->response,whichButton);
+        rowAppend(&trial->reactionTime,reactionTime);
+        rowAppend(&trial->responseTimeRaw,responseTimeRaw);
+        rowAppend(&trial->responseSegnum,thisseg);
+        rowAppend(&trial->responseVolume,volnum);
+      }
+    }
+    // deal with user traces
+    else if (thisTracenum >= stimtrace) {
+      if (tnum) {
+        size_t traceIndex = (size_t)(thisTracenum-stimtrace);
+        if ((traceIndex >= numTraces) || (thisTracenum != round(thisTracenum))) {status = STATUS_FALLBACK;break;}
+        // store it if it is the first setting
+        double *traceValue = &record->traces[traceIndex+(tnum-1)*numTraces];
+        if (mxIsNaN(*traceValue)) *traceValue = thisData;
+        // put it in trial
+        trialRecord *trial = &record->trials[tnum-1];
+        rowAppend(&trial->traceTracenum,traceIndex+1);
+        rowAppend(&trial->traceVal,thisData);
+        rowAppend(&trial->traceTime,thisTime-exptStartTime);
+      }
+    }
+  }
+
+  // make the outputs
+  if (status == STATUS_FALLBACK) {
+    if (verbose) mexPrintf("(mglPrivateGetTaskParameters) Falling back on getTaskParameters at event %i\n",(int)(enumber+1));
+    returnFallback(plhs,prhs[4]);
+  }
+  else {
+    plhs[0] = makePhasesOutput(phases,nPhases,numTraces);
+    plhs[1] = rowToArray(&volumeTR);
+    plhs[2] = mxCreateDoubleScalar(status);
+  }
+
+  // clean up
+  freePhases(phases,nPhases);
+  rowFree(&volumeTR);
+  mxFree(nextVolEvent);
+  mxFree(tracenum);mxFree(data);mxFree(eventTime);mxFree(ticknum);mxFree(eventVolnum);
+  for (phaseNum = 0; phaseNum < nPhases; phaseNum++) {mxFree(settings[phaseNum].blockTrialn);mxFree(settings[phaseNum].getResponse);}
+  mxFree(settings);
+}
+
+////////////////////////
+//   makePhasesOutput //
+////////////////////////
+static mxArray *makePhasesOutput(phaseRecord *phases, size_t nPhases, size_t numTraces)
+{
+  const char *phaseFieldNames[] = {"entered","nTrials","trialCount","trialTime","trialTicknum","trialVolume","blockNum","blockTrialNum","response","responseVolume","reactionTime","responseTimeRaw","traces","trials"};
+  const char *trialFieldNames[] = {"response","responseVolume","responseSegnum","reactionTime","responseTimeRaw","traces","segtime","volnum","ticknum"};
+  const char *traceFieldNames[] = {"tracenum","val","time"};
+  mxArray *output = mxCreateStructMatrix(1,nPhases,14,phaseFieldNames);
+  size_t phaseNum, t;
+  for (phaseNum = 0; phaseNum < nPhases; phaseNum++) {
+    phaseRecord *record = &phases[phaseNum];
+    mxSetField(output,phaseNum,"entered",mxCreateDoubleScalar(record->entered));
+    mxSetField(output,phaseNum,"nTrials",mxCreateDoubleScalar(record->nTrials));
+    mxSetField(output,phaseNum,"trialCount",mxCreateDoubleScalar(record->trialCount));
+    mxSetField(output,phaseNum,"trialTime",rowToArray(&record->trialTime));
+    mxSetField(output,phaseNum,"trialTicknum",rowToArray(&record->trialTicknum));
+    mxSetField(output,phaseNum,"trialVolume",rowToArray(&record->trialVolume));
+    mxSetField(output,phaseNum,"blockNum",rowToArray(&record->blockNum));
+    mxSetField(output,phaseNum,"blockTrialNum",rowToArray(&record->blockTrialNum));
+    mxSetField(output,phaseNum,"response",rowToArray(&record->response));
+    mxSetField(output,phaseNum,"responseVolume",rowToArray(&record->responseVolume));
+    mxSetField(output,phaseNum,"reactionTime",rowToArray(&record->reactionTime));
+    mxSetField(output,phaseNum,"responseTimeRaw",rowToArray(&record->responseTimeRaw));
+    // user traces are numTraces x trialCount
+    mxArray *traces = mxCreateDoubleMatrix(numTraces,record->trialCount,mxREAL);
+    if ((numTraces > 0) && (record->trialCount > 0))
+      memcpy(mxGetPr(traces),record->traces,numTraces*record->trialCount*sizeof(double));
+    mxSetField(output,phaseNum,"traces",traces);
+    // and the trials structure
+    mxArray *trials = mxCreateStructMatrix(1,record->trialCount,9,trialFieldNames);
+    for (t = 0; t < record->trialCount; t++) {
+      trialRecord *trial = &record->trials[t];
+      mxSetField(trials,t,"response",rowToArray(&trial->response));
+      mxSetField(trials,t,"responseVolume",rowToArray(&trial->responseVolume));
+      mxSetField(trials,t,"responseSegnum",rowToArray(&trial->responseSegnum));
+      mxSetField(trials,t,"reactionTime",rowToArray(&trial->reactionTime));
+      mxSetField(trials,t,"responseTimeRaw",rowToArray(&trial->responseTimeRaw));
+      mxArray *trialTraces = mxCreateStructMatrix(1,1,3,traceFieldNames);
+      mxSetField(trialTraces,0,"tracenum",rowToArray(&trial->traceTracenum));
+      mxSetField(trialTraces,0,"val",rowToArray(&trial->traceVal));
+      mxSetField(trialTraces,0,"time",rowToArray(&trial->traceTime));
+      mxSetField(trials,t,"traces",trialTraces);
+      mxSetField(trials,t,"segtime",rowToArray(&trial->segtime));
+      mxSetField(trials,t,"volnum",rowToArray(&trial->volnum));
+      mxSetField(trials,t,"ticknum",rowToArray(&trial->ticknum));
+    }
+    mxSetField(output,phaseNum,"trials",trials);
+  }
+  return output;
+}
+
+//////////////////
+//   freePhases //
+//////////////////
+static void freePhases(phaseRecord *phases, size_t nPhases)
+{
+  size_t phaseNum, t;
+  for (phaseNum = 0; phaseNum < nPhases; phaseNum++) {
+    phaseRecord *record = &phases[phaseNum];
+    rowFree(&record->trialTime);rowFree(&record->trialTicknum);rowFree(&record->trialVolume);
+    rowFree(&record->blockNum);rowFree(&record->blockTrialNum);
+    rowFree(&record->response);rowFree(&record->responseVolume);
+    rowFree(&record->reactionTime);rowFree(&record->responseTimeRaw);
+    for (t = 0; t < record->trialsAllocated; t++) {
+      trialRecord *trial = &record->trials[t];
+      rowFree(&trial->response);rowFree(&trial->responseVolume);rowFree(&trial->responseSegnum);
+      rowFree(&trial->reactionTime);rowFree(&trial->responseTimeRaw);
+      rowFree(&trial->traceTracenum);rowFree(&trial->traceVal);rowFree(&trial->traceTime);
+      rowFree(&trial->segtime);rowFree(&trial->volnum);rowFree(&trial->ticknum);
+    }
+    mxFree(record->trials);
+    mxFree(record->traces);
+  }
+  mxFree(phases);
+}
+
+////////////////
+//   rowSet   //
+////////////////
+// set an element of a row, growing with zeros like matlab indexed assignment
+static void rowSet(doubleRow *row, size_t index, double value)
+{
+  if (index >= row->allocated) {
+    size_t oldAllocated = row->allocated;
+    row->allocated = (oldAllocated == 0) ? 8 : 2*oldAllocated;
+    while (row->allocated <= index) row->allocated *= 2;
+    row->data = (double *)mxRealloc(row->data,row->allocated*sizeof(double));
+    memset(row->data+oldAllocated,0,(row->allocated-oldAllocated)*sizeof(double));
+  }
+  row->data[index] = value;
+  if (index >= row->n) row->n = index+1;
+}
+
+///////////////////
+//   rowAppend   //
+///////////////////
+static void rowAppend(doubleRow *row, double value)
+{
+  rowSet(row,row->n,value);
+}
+
+////////////////////
+//   rowToArray   //
+////////////////////
+// an empty row is [] (0x0) otherwise 1xn
+static mxArray *rowToArray(doubleRow *row)
+{
+  if (row->n == 0) return mxCreateDoubleMatrix(0,0,mxREAL);
+  mxArray *retval = mxCreateDoubleMatrix(1,row->n,mxREAL);
+  memcpy(mxGetPr(retval),row->data,row->n*sizeof(double));
+  return retval;
+}
+
+/////////////////
+//   rowFree   //
+/////////////////
+static void rowFree(doubleRow *row)
+{
+  if (row->data != NULL) mxFree(row->data);
+  row->data = NULL;
+  row->n = row->allocated = 0;
+}
+
+/////////////////////////
+//   getNumericField   //
+/////////////////////////
+// copy a numeric or logical field into a double array to be freed with mxFree
+static double *getNumericField(const mxArray *s, mwIndex index, const char *fieldName, size_t *length)
+{
+  mxArray *field = mxGetField(s,index,fieldName);
+  if ((field == NULL) || !(mxIsNumeric(field) || mxIsLogical(field)) || mxIsComplex(field)) return NULL;
+  size_t i, n = mxGetNumberOfElements(field);
+  double *retval = (double *)mxCalloc(n > 0 ? n : 1,sizeof(double));
+  void *p = mxGetData(field);
+  for (i = 0; i < n; i++) {
+    switch (mxGetClassID(field)) {
+      case mxDOUBLE_CLASS: retval[i] = ((double *)p)[i];break;
+      case mxSINGLE_CLASS: retval[i] = ((float *)p)[i];break;
+      case mxLOGICAL_CLASS: retval[i] = ((mxLogical *)p)[i];break;
+      case mxINT8_CLASS: retval[i] = ((int8_t *)p)[i];break;
+      case mxUINT8_CLASS: retval[i] = ((uint8_t *)p)[i];break;
+      case mxINT16_CLASS: retval[i] = ((int16_t *)p)[i];break;
+      case mxUINT16_CLASS: retval[i] = ((uint16_t *)p)[i];break;
+      case mxINT32_CLASS: retval[i] = ((int32_t *)p)[i];break;
+      case mxUINT32_CLASS: retval[i] = ((uint32_t *)p)[i];break;
+      default: mxFree(retval);return NULL;
+    }
+  }
+  *length = n;
+  return retval;
+}
+
+////////////////////////
+//   getScalarField   //
+////////////////////////
+static double getScalarField(const mxArray *s, mwIndex index, const char *fieldName, int *ok)
+{
+  size_t length;
+  double *values = getNumericField(s,index,fieldName,&length);
+  if ((values == NULL) || (length != 1)) {
+    mxFree(values);
+    *ok = 0;
+    return 0;
+  }
+  double retval = values[0];
+  mxFree(values);
+  return retval;
+}
+
+////////////////////////
+//   medianOfNotNan   //
+////////////////////////
+// median of the values that are not nan, or nan if there are none.
+// even counts are averaged the same way matlab median does
+static double medianOfNotNan(const double *x, size_t n)
+{
+  size_t i, count = 0;
+  double *sorted = (double *)mxCalloc(n > 0 ? n : 1,sizeof(double));
+  for (i = 0; i < n; i++)
+    if (!mxIsNaN(x[i])) sorted[count++] = x[i];
+  if (count == 0) {
+    mxFree(sorted);
+    return mxGetNaN();
+  }
+  qsort(sorted,count,sizeof(double),compareDoubles);
+  double retval;
+  if (count % 2)
+    retval = sorted[count/2];
+  else {
+    double a = sorted[count/2-1], b = sorted[count/2];
+    if ((signOf(a) != signOf(b)) || mxIsInf(a) || mxIsInf(b))
+      retval = (a+b)/2;
+    else
+      retval = a+(b-a)/2;
+  }
+  mxFree(sorted);
+  return retval;
+}
+
+static int compareDoubles(const void *a, const void *b)
+{
+  double x = *(const double *)a, y = *(const double *)b;
+  return (x < y) ? -1 : ((x > y) ? 1 : 0);
+}
+
+static int signOf(double x)
+{
+  return (x > 0) - (x < 0);
+}
+
+////////////////////////
+//   returnFallback   //
+////////////////////////
+// tell getTaskParameters to use its own loop
+static void returnFallback(mxArray *plhs[], const mxArray *volumeTR)
+{
+  plhs[0] = mxCreateDoubleMatrix(0,0,mxREAL);
+  plhs[1] = (volumeTR != NULL) ? mxDuplicateArray(volumeTR) : mxCreateDoubleMatrix(0,0,mxREAL);
+  plhs[2] = mxCreateDoubleScalar(STATUS_FALLBACK);
+}
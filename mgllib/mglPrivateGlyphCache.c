@@ -0,0 +1,279 @@
+#ifdef documentation
+=========================================================================
+
+     program: mglPrivateGlyphCache.c
+          by: justin gardner
+        date: 10/19/2026
+     purpose: keeps the glyph cache of mglGlyphCache.h for mglTextCache,
+              which renders the glyphs and keeps the atlas pages they are
+              on as textures
+   copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+       usage: missing = mglPrivateGlyphCache('missing',font,str)
+              [page x y flushed] = mglPrivateGlyphCache('add',font,characters,widths,heights,left,top,advance,lineHeight)
+              [quads size] = mglPrivateGlyphCache('layout',font,str,position,pixelsToDevice,hAlignment,vAlignment,rotation)
+              mglPrivateGlyphCache('clear',<[pageWidth pageHeight]>,<maxPages>)
+              info = mglPrivateGlyphCache('info')
+
+              font is a string naming everything that changes how
+              glyphs look. missing is the characters of str (as double)
+              that are not cached in that font, each once. add caches
+              the glyphs of characters, with widths x heights of ink
+              (0 for none) at left, top pixels from the pen at the top
+              of a line lineHeight high, moving the pen by advance. page
+              is the page each one went on, starting at 1, 0 for no ink,
+              and x and y the column and row of its top left pixel. If
+              the pages are full, the cache is emptied first and flushed
+              is true, and then only these glyphs are cached. layout
+              gives a 9 x n matrix of [x y width height u0 v0 u1 v1 page]
+              for each glyph of str with ink, the center and size in
+              device units of str drawn at position, aligned as
+              mglBltTexture does and rotated by rotation degrees about
+              position, for mglMetalBltSprites. size is the [width height]
+              of the text in pixels. clear empties the cache, and sets
+              the size of new pages (default 512 x 512) and how many
+              there can be (default 4).
+
+=========================================================================
+#endif
+
+/////////////////////////
+//   include section   //
+/////////////////////////
+#include "mgl.h"
+#include "mglGlyphCache.h"
+
+///////////////////////////////
+//   function declarations   //
+///////////////////////////////
+static int32_t getFont(const mxArray *fontName);
+static uint32_t *getCodepoints(const mxArray *str, uint32_t *n);
+static void mglPrivateGlyphCacheOnExit(void);
+
+////////////////////////
+//   define section   //
+////////////////////////
+#define DEFAULT_PAGE_SIZE 512
+#define DEFAULT_MAX_PAGES 4
+
+// the cache, kept until the mex function is cleared
+static mglGlyphCache *glyphCache = NULL;
+
+//////////////
+//   main   //
+//////////////
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+  if ((nrhs < 1) || !mxIsChar(prhs[0])) {
+    usageError("mglPrivateGlyphCache");
+    return;
+  }
+  char command[16];
+  mxGetString(prhs[0], command, sizeof(command));
+
+  // clear, which also makes the cache the first time
+  if (!strcmp(command, "clear") || (glyphCache == NULL)) {
+    uint32_t pageWidth = DEFAULT_PAGE_SIZE, pageHeight = DEFAULT_PAGE_SIZE, maxPages = DEFAULT_MAX_PAGES;
+    if (!strcmp(command, "clear")) {
+      if ((nrhs > 1) && !mxIsEmpty(prhs[1])) {
+        if (!mxIsDouble(prhs[1]) || (mxGetNumberOfElements(prhs[1]) != 2) || (mxGetPr(prhs[1])[0] < 1) || (mxGetPr(prhs[1])[1] < 1)) {
+          usageError("mglPrivateGlyphCache");
+          return;
+        }
+        pageWidth = (uint32_t)mxGetPr(prhs[1])[0];
+        pageHeight = (uint32_t)mxGetPr(prhs[1])[1];
+      }
+      if ((nrhs > 2) && !mxIsEmpty(prhs[2])) maxPages = (mxGetScalar(prhs[2]) >= 1) ? (uint32_t)mxGetScalar(prhs[2]) : 1;
+    }
+    if (glyphCache == NULL) {
+      glyphCache = (mglGlyphCache *)malloc(sizeof(mglGlyphCache));
+      if (glyphCache == NULL) {
+        mexPrintf("(mglPrivateGlyphCache) Could not allocate memory for the glyph cache\n");
+        return;
+      }
+      mexAtExit(mglPrivateGlyphCacheOnExit);
+    }
+    else
+      mglGlyphCacheFree(glyphCache);
+    if (!mglGlyphCacheInit(glyphCache, pageWidth, pageHeight, 1, maxPages)) {
+      mexPrintf("(mglPrivateGlyphCache) Could not allocate memory for the glyph cache\n");
+      free(glyphCache);
+      glyphCache = NULL;
+      return;
+    }
+    if (!strcmp(command, "clear")) return;
+  }
+
+  // missing characters of a string
+  if (!strcmp(command, "missing")) {
+    int32_t font = (nrhs == 3) ? getFont(prhs[1]) : -1;
+    uint32_t n;
+    uint32_t *codepoints = (font >= 0) ? getCodepoints(prhs[2], &n) : NULL;
+    if (codepoints == NULL) {
+      usageError("mglPrivateGlyphCache");
+      return;
+    }
+    uint32_t *missing = (uint32_t *)mxMalloc((n ? n : 1) * sizeof(uint32_t));
+    uint32_t nMissing = mglGlyphCacheMissing(glyphCache, (uint32_t)font, codepoints, n, missing);
+    plhs[0] = mxCreateDoubleMatrix(1, nMissing, mxREAL);
+    uint32_t i;
+    for (i = 0; i < nMissing; i++)
+      mxGetPr(plhs[0])[i] = missing[i];
+    mxFree(missing);
+    mxFree(codepoints);
+  }
+  // add rendered glyphs
+  else if (!strcmp(command, "add")) {
+    int32_t font = (nrhs == 9) ? getFont(prhs[1]) : -1;
+    int i;
+    for (i = 2; (font >= 0) && (i < 8); i++)
+      if (!mxIsDouble(prhs[i]) || (mxGetNumberOfElements(prhs[i]) != mxGetNumberOfElements(prhs[2]))) font = -1;
+    if ((font < 0) || !mxIsDouble(prhs[8]) || mxIsEmpty(prhs[8])) {
+      usageError("mglPrivateGlyphCache");
+      return;
+    }
+    uint32_t n = (uint32_t)mxGetNumberOfElements(prhs[2]), iGlyph;
+    double *codepoints = mxGetPr(prhs[2]), *widths = mxGetPr(prhs[3]), *heights = mxGetPr(prhs[4]);
+    double *left = mxGetPr(prhs[5]), *top = mxGetPr(prhs[6]), *advance = mxGetPr(prhs[7]);
+    float lineHeight = (float)mxGetScalar(prhs[8]);
+    int flushed = 0;
+    mxArray *outputs[3];
+    for (i = 0; i < 3; i++)
+      outputs[i] = mxCreateDoubleMatrix(1, n, mxREAL);
+    for (iGlyph = 0; iGlyph < n; iGlyph++) {
+      uint32_t width = (widths[iGlyph] > 0) ? (uint32_t)widths[iGlyph] : 0;
+      uint32_t height = (heights[iGlyph] > 0) ? (uint32_t)heights[iGlyph] : 0;
+      int32_t index = mglGlyphCacheAdd(glyphCache, (uint32_t)font, (uint32_t)codepoints[iGlyph], width, height, (float)left[iGlyph], (float)top[iGlyph], (float)advance[iGlyph], lineHeight);
+      // full, so empty the cache and start over with these glyphs
+      if ((index == MGL_GLYPH_CACHE_FULL) && !flushed) {
+        mglGlyphCacheFlush(glyphCache);
+        flushed = 1;
+        iGlyph = (uint32_t)-1;
+        continue;
+      }
+      if (index < 0) {
+        mexPrintf("(mglPrivateGlyphCache) Could not cache a %ix%i glyph on %i pages of %ix%i\n", width, height, glyphCache->maxPages, glyphCache->pageWidth, glyphCache->pageHeight);
+        continue;
+      }
+      const mglGlyph *glyph = &glyphCache->glyphs[index];
+      if (glyph->page >= 0) {
+        mxGetPr(outputs[0])[iGlyph] = glyph->page + 1;
+        mxGetPr(outputs[1])[iGlyph] = glyph->x + 1;
+        mxGetPr(outputs[2])[iGlyph] = glyph->y + 1;
+      }
+    }
+    for (i = 0; i < 3; i++) {
+      if ((i == 0) || (i < nlhs))
+        plhs[i] = outputs[i];
+      else
+        mxDestroyArray(outputs[i]);
+    }
+    if (nlhs > 3) plhs[3] = mxCreateLogicalScalar(flushed);
+  }
+  // glyph quads for a string, in device units
+  else if (!strcmp(command, "layout")) {
+    int32_t font = (nrhs == 8) ? getFont(prhs[1]) : -1;
+    uint32_t n = 0;
+    uint32_t *codepoints = (font >= 0) ? getCodepoints(prhs[2], &n) : NULL;
+    if ((codepoints == NULL) || !mxIsDouble(prhs[3]) || (mxGetNumberOfElements(prhs[3]) < 2) ||
+        !mxIsDouble(prhs[4]) || (mxGetNumberOfElements(prhs[4]) != 2)) {
+      if (codepoints != NULL) mxFree(codepoints);
+      usageError("mglPrivateGlyphCache");
+      return;
+    }
+    double *position = mxGetPr(prhs[3]), *pixelsToDevice = mxGetPr(prhs[4]);
+    int hAlignment = (int)mxGetScalar(prhs[5]), vAlignment = (int)mxGetScalar(prhs[6]);
+    double rotation = mxGetScalar(prhs[7]) * M_PI / 180;
+    double cosRotation = cos(rotation), sinRotation = sin(rotation);
+
+    mglGlyphQuad *quads = (mglGlyphQuad *)mxMalloc((n ? n : 1) * sizeof(mglGlyphQuad));
+    float width, height;
+    uint32_t nQuads = mglGlyphCacheLayout(glyphCache, (uint32_t)font, codepoints, n, hAlignment, vAlignment, quads, &width, &height);
+    plhs[0] = mxCreateDoubleMatrix(9, nQuads, mxREAL);
+    double *out = mxGetPr(plhs[0]);
+    uint32_t i;
+    for (i = 0; i < nQuads; i++, out += 9) {
+      // center in device units, +y going up, rotated about position as mglBltTexture does
+      double x = (quads[i].x + quads[i].width / 2) * pixelsToDevice[0];
+      double y = -(quads[i].y + quads[i].height / 2) * pixelsToDevice[1];
+      out[0] = position[0] + cosRotation * x - sinRotation * y;
+      out[1] = position[1] + sinRotation * x + cosRotation * y;
+      out[2] = quads[i].width * pixelsToDevice[0];
+      out[3] = quads[i].height * pixelsToDevice[1];
+      out[4] = quads[i].u0;
+      out[5] = quads[i].v0;
+      out[6] = quads[i].u1;
+      out[7] = quads[i].v1;
+      out[8] = quads[i].page + 1;
+    }
+    if (nlhs > 1) {
+      plhs[1] = mxCreateDoubleMatrix(1, 2, mxREAL);
+      mxGetPr(plhs[1])[0] = width;
+      mxGetPr(plhs[1])[1] = height;
+    }
+    mxFree(quads);
+    mxFree(codepoints);
+  }
+  // how full the cache is and how well it is doing
+  else if (!strcmp(command, "info")) {
+    const char *fieldNames[] = {"glyphs", "fonts", "pages", "maxPages", "pageWidth", "pageHeight", "hits", "misses", "flushes"};
+    double values[] = {glyphCache->glyphCount, glyphCache->fontCount, glyphCache->pageCount, glyphCache->maxPages,
+                       glyphCache->pageWidth, glyphCache->pageHeight, (double)glyphCache->hits, (double)glyphCache->misses, (double)glyphCache->flushes};
+    plhs[0] = mxCreateStructMatrix(1, 1, 9, fieldNames);
+    int i;
+    for (i = 0; i < 9; i++)
+      mxSetField(plhs[0], 0, fieldNames[i], mxCreateDoubleScalar(values[i]));
+  }
+  else {
+    mexPrintf("(mglPrivateGlyphCache) Unknown command %s\n", command);
+  }
+}
+
+/////////////////
+//   getFont   //
+/////////////////
+// The number of the named font, -1 if it is not a string.
+static int32_t getFont(const mxArray *fontName)
+{
+  if (!mxIsChar(fontName)) return -1;
+  char *name = mxArrayToString(fontName);
+  if (name == NULL) return -1;
+  int32_t font = mglGlyphCacheFont(glyphCache, name);
+  mxFree(name);
+  if (font < 0) mexPrintf("(mglPrivateGlyphCache) Could not allocate memory for a font\n");
+  return font;
+}
+
+///////////////////////
+//   getCodepoints   //
+///////////////////////
+// The characters of a string, or of a double array of characters. NULL if it is neither.
+static uint32_t *getCodepoints(const mxArray *str, uint32_t *n)
+{
+  *n = (uint32_t)mxGetNumberOfElements(str);
+  if (!mxIsChar(str) && !mxIsDouble(str)) return NULL;
+  uint32_t *codepoints = (uint32_t *)mxMalloc((*n ? *n : 1) * sizeof(uint32_t));
+  uint32_t i;
+  if (mxIsChar(str)) {
+    const mxChar *chars = mxGetChars(str);
+    for (i = 0; i < *n; i++)
+      codepoints[i] = chars[i];
+  }
+  else {
+    const double *chars = mxGetPr(str);
+    for (i = 0; i < *n; i++)
+      codepoints[i] = (chars[i] > 0) ? (uint32_t)chars[i] : 0;
+  }
+  return codepoints;
+}
+
+////////////////////////////////////
+//   mglPrivateGlyphCacheOnExit   //
+////////////////////////////////////
+static void mglPrivateGlyphCacheOnExit(void)
+{
+  if (glyphCache != NULL) {
+    mglGlyphCacheFree(glyphCache);
+    free(glyphCache);
+    glyphCache = NULL;
+  }
+}
@@ -0,0 +1,213 @@
+#ifdef documentation
+=========================================================================
+
+     program: mglPrivateMakeStimulusImage.c
+          by: justin gardner
+        date: 10/19/2026
+     purpose: makes grating, gaussian, gabor and plaid images (see
+              mglStimulusImage.h), or a family of them with different
+              angles and phases, split across a number of threads. Called
+              by mglMakeStimulusImage, which sets up the params
+   copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+       usage: im = mglPrivateMakeStimulusImage(params,<nThreads>)
+
+              params has fields type ('grating','gaussian','gabor' or
+              'plaid'), format ('double','single','rgba' or 'uint8'),
+              widthPixels, heightPixels, xStart, xStep, yStart, yStep,
+              sf, contrast, angle, phase, plaidAngle, sdx, sdy, xCenter,
+              yCenter and alphaMask. nThreads defaults to the number of
+              processors.
+
+=========================================================================
+#endif
+
+/////////////////////////
+//   include section   //
+/////////////////////////
+#include "mgl.h"
+#include "mglStimulusImage.h"
+#include <pthread.h>
+#include <unistd.h>
+
+////////////////////////
+//   define section   //
+////////////////////////
+#define MAX_THREADS 64
+// lines of an image that a thread makes at a time
+#define LINES_PER_CHUNK 32
+
+//////////////////////////////////////////
+//   static variable and type section   //
+//////////////////////////////////////////
+// threads take chunks of lines of images until there are none left
+typedef struct {
+  const mglStimulusImage *stimulus;
+  size_t chunksPerImage;
+  size_t nChunks;
+  size_t nextChunk;
+} workType;
+
+///////////////////////////////
+//   function declarations   //
+///////////////////////////////
+static void *makeChunks(void *data);
+static double getField(const mxArray *params, const char *name, double defaultValue);
+static int getStringField(const mxArray *params, const char *name, const char **names, int nNames);
+
+//////////////
+//   main   //
+//////////////
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+  // check arguments
+  if ((nrhs < 1) || (nrhs > 2) || !mxIsStruct(prhs[0])) {
+    usageError("mglPrivateMakeStimulusImage");
+    return;
+  }
+  const mxArray *params = prhs[0];
+
+  // get the stimulus
+  mglStimulusImage stimulus;
+  const char *typeNames[] = {"grating", "gaussian", "gabor", "plaid"};
+  const char *formatNames[] = {"double", "single", "rgba", "uint8"};
+  stimulus.type = getStringField(params, "type", typeNames, 4);
+  stimulus.format = getStringField(params, "format", formatNames, 4);
+  if ((stimulus.type < 0) || (stimulus.format < 0)) {
+    mexPrintf("(mglPrivateMakeStimulusImage) Unknown type or format\n");
+    plhs[0] = mxCreateDoubleMatrix(0, 0, mxREAL);
+    return;
+  }
+  stimulus.alphaMask = (int)getField(params, "alphaMask", 0);
+  stimulus.width = (size_t)getField(params, "widthPixels", 0);
+  stimulus.height = (size_t)getField(params, "heightPixels", 0);
+  stimulus.xStart = getField(params, "xStart", 0);
+  stimulus.xStep = getField(params, "xStep", 0);
+  stimulus.yStart = getField(params, "yStart", 0);
+  stimulus.yStep = getField(params, "yStep", 0);
+  stimulus.sf = getField(params, "sf", 1);
+  stimulus.contrast = getField(params, "contrast", 1);
+  stimulus.plaidAngle = getField(params, "plaidAngle", 90);
+  stimulus.sdx = getField(params, "sdx", 1);
+  stimulus.sdy = getField(params, "sdy", 1);
+  stimulus.xCenter = getField(params, "xCenter", 0);
+  stimulus.yCenter = getField(params, "yCenter", 0);
+
+  // angles and phases, one for all images or one for each
+  static const double zero = 0;
+  const mxArray *angles = mxGetField(params, 0, "angle");
+  const mxArray *phases = mxGetField(params, 0, "phase");
+  stimulus.nAngles = ((angles != NULL) && mxIsDouble(angles)) ? mxGetNumberOfElements(angles) : 0;
+  stimulus.nPhases = ((phases != NULL) && mxIsDouble(phases)) ? mxGetNumberOfElements(phases) : 0;
+  stimulus.angles = stimulus.nAngles ? mxGetPr(angles) : &zero;
+  stimulus.phases = stimulus.nPhases ? mxGetPr(phases) : &zero;
+  if ((stimulus.nAngles > 1) && (stimulus.nPhases > 1) && (stimulus.nAngles != stimulus.nPhases)) {
+    mexPrintf("(mglPrivateMakeStimulusImage) angle and phase should have the same length, or one of them should be a scalar\n");
+    plhs[0] = mxCreateDoubleMatrix(0, 0, mxREAL);
+    return;
+  }
+  stimulus.nImages = (stimulus.nAngles > stimulus.nPhases) ? stimulus.nAngles : stimulus.nPhases;
+  if (stimulus.nImages < 1) stimulus.nImages = 1;
+
+  // create output
+  mwSize dims[4];
+  mwSize nDims = 3;
+  mxClassID classID = mxSINGLE_CLASS;
+  switch (stimulus.format) {
+    case MGL_STIMULUS_FORMAT_DOUBLE:
+      classID = mxDOUBLE_CLASS;
+      // same shape as single
+    case MGL_STIMULUS_FORMAT_SINGLE:
+      dims[0] = stimulus.height; dims[1] = stimulus.width; dims[2] = stimulus.nImages;
+      break;
+    case MGL_STIMULUS_FORMAT_RGBA:
+      dims[0] = stimulus.height; dims[1] = stimulus.width; dims[2] = 4; dims[3] = stimulus.nImages;
+      nDims = 4;
+      break;
+    case MGL_STIMULUS_FORMAT_UINT8:
+      classID = mxUINT8_CLASS;
+      dims[0] = 4; dims[1] = stimulus.width; dims[2] = stimulus.height; dims[3] = stimulus.nImages;
+      nDims = 4;
+      break;
+  }
+  plhs[0] = mxCreateNumericArray(nDims, dims, classID, mxREAL);
+  stimulus.output = mxGetData(plhs[0]);
+  if ((stimulus.width == 0) || (stimulus.height == 0)) return;
+
+  // split the images into chunks of lines
+  workType work;
+  work.stimulus = &stimulus;
+  work.chunksPerImage = (mglStimulusImageLineCount(&stimulus) + LINES_PER_CHUNK - 1) / LINES_PER_CHUNK;
+  work.nChunks = work.chunksPerImage * stimulus.nImages;
+  work.nextChunk = 0;
+
+  // no more threads than processors or chunks
+  int nThreads = (nrhs > 1) ? (int)mxGetScalar(prhs[1]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+  if (nThreads > work.nChunks) nThreads = (int)work.nChunks;
+  if (nThreads > MAX_THREADS) nThreads = MAX_THREADS;
+  if (nThreads < 1) nThreads = 1;
+
+  // run on this thread and the rest on their own
+  pthread_t threads[MAX_THREADS];
+  int started[MAX_THREADS];
+  int iThread;
+  for (iThread = 1; iThread < nThreads; iThread++) {
+    started[iThread] = (pthread_create(&threads[iThread], NULL, makeChunks, &work) == 0);
+    if (!started[iThread]) {
+      // the other threads will pick up the work
+      mexPrintf("(mglPrivateMakeStimulusImage) Could not create thread %i\n", iThread);
+    }
+  }
+  makeChunks(&work);
+  for (iThread = 1; iThread < nThreads; iThread++) {
+    if (started[iThread]) pthread_join(threads[iThread], NULL);
+  }
+}
+
+////////////////////
+//   makeChunks   //
+////////////////////
+static void *makeChunks(void *data)
+{
+  workType *work = (workType *)data;
+  const mglStimulusImage *stimulus = work->stimulus;
+  size_t lineCount = mglStimulusImageLineCount(stimulus);
+  double *scratch = (double *)malloc(mglStimulusImageScratchSize(stimulus) * sizeof(double));
+  if (scratch == NULL) return NULL;
+
+  size_t chunk;
+  while ((chunk = __atomic_fetch_add(&work->nextChunk, 1, __ATOMIC_RELAXED)) < work->nChunks) {
+    size_t image = chunk / work->chunksPerImage;
+    size_t firstLine = (chunk % work->chunksPerImage) * LINES_PER_CHUNK;
+    size_t nLines = (firstLine + LINES_PER_CHUNK <= lineCount) ? LINES_PER_CHUNK : lineCount - firstLine;
+    mglStimulusImageLines(stimulus, image, firstLine, nLines, scratch);
+  }
+  free(scratch);
+  return NULL;
+}
+
+//////////////////
+//   getField   //
+//////////////////
+static double getField(const mxArray *params, const char *name, double defaultValue)
+{
+  const mxArray *field = mxGetField(params, 0, name);
+  if ((field == NULL) || mxIsEmpty(field) || !(mxIsNumeric(field) || mxIsLogical(field)))
+    return defaultValue;
+  return mxGetScalar(field);
+}
+
+////////////////////////
+//   getStringField   //
+////////////////////////
+// Returns the index of the field's value in names, or -1.
+static int getStringField(const mxArray *params, const char *name, const char **names, int nNames)
+{
+  char value[32];
+  const mxArray *field = mxGetField(params, 0, name);
+  if ((field == NULL) || !mxIsChar(field) || mxGetString(field, value, sizeof(value)))
+    return -1;
+  for (int i = 0; i < nNames; i++) {
+    if (!strcmp(value, names[i])) return i;
+  }
+  return -1;
+}
@@ -0,0 +1,267 @@
+#ifdef documentation
+=========================================================================
+
+     program: mglPrivateMakeTraces.c
+          by: justin gardner
+        date: 10/19/2026
+     purpose: native version of the event loop in makeTraces. Walks the
+              myscreen.events columns once and fills the trace matrix
+              and the piecewise linear time trace. Returns empty matrices
+              for anything it does not handle exactly the same way as
+              the m-file, so that makeTraces can fall back on its own loop.
+   copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+       usage: [traces time] = mglPrivateMakeTraces(events,maxtick,endtimeSecs,framesPerSecond,time)
+
+=========================================================================
+#endif
+
+/////////////////////////
+//   include section   //
+/////////////////////////
+#include "mgl.h"
+#include <float.h>
+
+///////////////////////////////
+//   function declarations   //
+///////////////////////////////
+double *getEventField(const mxArray *events, const char *fieldName, size_t minLength, size_t *length);
+long colonLength(double a, double d, double b);
+void colonFill(double *dest, double a, double d, double b, long n);
+mxArray *fallback(mxArray *plhs[]);
+
+//////////////
+//   main   //
+//////////////
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+  // check arguments
+  if ((nrhs != 5) || !mxIsStruct(prhs[0])) {
+    usageError("mglPrivateMakeTraces");
+    fallback(plhs);
+    return;
+  }
+  int verbose = (int)mglGetGlobalDouble("verbose");
+
+  // get the number of events
+  mxArray *nField = mxGetField(prhs[0],0,"n");
+  if (nField == NULL) {
+    fallback(plhs);
+    return;
+  }
+  size_t n = (size_t)mxGetScalar(nField);
+
+  // get the event columns (tracenum is used for its full length
+  // since the number of traces is computed from all of it)
+  size_t tracenumLength;
+  double *tracenum = getEventField(prhs[0],"tracenum",n,&tracenumLength);
+  double *data = getEventField(prhs[0],"data",n,NULL);
+  double *ticknum = getEventField(prhs[0],"ticknum",n,NULL);
+  double *eventTime = getEventField(prhs[0],"time",n,NULL);
+  double *force = getEventField(prhs[0],"force",n,NULL);
+  if ((tracenum == NULL) || (data == NULL) || (ticknum == NULL) || (eventTime == NULL) || (force == NULL) || (tracenumLength == 0)) {
+    if (verbose) mexPrintf("(mglPrivateMakeTraces) Events are missing fields or are not numeric\n");
+    mxFree(tracenum);mxFree(data);mxFree(ticknum);mxFree(eventTime);mxFree(force);
+    fallback(plhs);
+    return;
+  }
+
+  long maxtick = (long)mxGetScalar(prhs[1]);
+  double endtimeSecs = mxGetScalar(prhs[2]);
+  double framesPerSecond = mxGetScalar(prhs[3]);
+  if (!mxIsDouble(prhs[4]) || (mxGetNumberOfElements(prhs[4]) < 1)) {
+    mxFree(tracenum);mxFree(data);mxFree(ticknum);mxFree(eventTime);mxFree(force);
+    fallback(plhs);
+    return;
+  }
+
+  // number of traces is the largest trace number
+  size_t i, numTraces = 0;
+  for (i = 0; i < tracenumLength; i++)
+    if (tracenum[i] > numTraces) numTraces = (size_t)tracenum[i];
+
+  // fix up any nan ticknums the same way makeTraces does, using the last
+  // event which has a good ticknum. Also check that everything fits
+  long lastGoodEvent = -1;
+  for (i = 0; i < n; i++)
+    if (!mxIsNaN(ticknum[i])) lastGoodEvent = i;
+  long maxEventTick = 0;
+  int ok = 1;
+  for (i = 0; i < n; i++) {
+    if (mxIsNaN(ticknum[i])) {
+      if (lastGoodEvent < 0) {ok = 0;break;}
+      ticknum[i] = ticknum[lastGoodEvent] + round((eventTime[i]-eventTime[lastGoodEvent])*framesPerSecond);
+      mexPrintf("(makeTraces) Fixing bad ticknum for event %i: %i\n",(int)(i+1),(int)ticknum[i]);
+    }
+    if ((ticknum[i] < 1) || (ticknum[i] != floor(ticknum[i])) || (ticknum[i] > maxtick) || (tracenum[i] < 1) || (tracenum[i] != floor(tracenum[i]))) {ok = 0;break;}
+    if (ticknum[i] > maxEventTick) maxEventTick = (long)ticknum[i];
+  }
+
+  // allocate the time trace, which keeps whatever was in myscreen.time
+  // and grows to hold maxtick values
+  size_t timeInLength = mxGetNumberOfElements(prhs[4]);
+  size_t timeLength = timeInLength;
+  if ((maxtick > 2) && (maxtick > timeLength)) timeLength = maxtick;
+  if (maxEventTick > timeLength) timeLength = maxEventTick;
+  double *time = (double *)mxCalloc(timeLength,sizeof(double));
+  memcpy(time,mxGetPr(prhs[4]),timeInLength*sizeof(double));
+
+  // make up time in between first and end time
+  if (ok && (maxtick > 2)) {
+    double step = (endtimeSecs-time[0])/(maxtick-2);
+    if (colonLength(time[0],step,endtimeSecs) == maxtick-1)
+      colonFill(time+1,time[0],step,endtimeSecs,maxtick-1);
+    else
+      ok = 0;
+  }
+
+  // create the traces matrix, filled with zeros
+  if (!ok || (maxtick < 1)) {
+    mxFree(tracenum);mxFree(data);mxFree(ticknum);mxFree(eventTime);mxFree(force);mxFree(time);
+    fallback(plhs);
+    return;
+  }
+  plhs[0] = mxCreateDoubleMatrix(numTraces,maxtick,mxREAL);
+  double *traces = mxGetPr(plhs[0]);
+
+  // now go through the events
+  long lastticknum = 1, thisticknum, t;
+  for (i = 0; (i < n) && ok; i++) {
+    thisticknum = (long)ticknum[i];
+    size_t row = (size_t)tracenum[i]-1;
+    // put the data into the trace, if it is a force, then only set the current one
+    if (force[i])
+      traces[row+(thisticknum-1)*numTraces] = data[i];
+    else
+      for (t = thisticknum; t <= maxtick; t++)
+        traces[row+(t-1)*numTraces] = data[i];
+    // get the time in between the last tick and this tick
+    double thistime = eventTime[i];
+    double lasttime = time[lastticknum-1];
+    if (lastticknum == thisticknum)
+      time[thisticknum-1] = thistime;
+    else if (thisticknum > lastticknum) {
+      if ((lasttime-thistime) != 0) {
+        double step = (thistime-lasttime)/(thisticknum-lastticknum);
+        if (colonLength(lasttime,step,thistime) == thisticknum-lastticknum+1)
+          colonFill(time+lastticknum-1,lasttime,step,thistime,thisticknum-lastticknum+1);
+        else
+          ok = 0;
+      }
+      else
+        for (t = lastticknum; t <= thisticknum; t++)
+          time[t-1] = lasttime;
+    }
+    lastticknum = thisticknum;
+  }
+  mxFree(tracenum);mxFree(data);mxFree(ticknum);mxFree(eventTime);mxFree(force);
+
+  if (!ok) {
+    mxDestroyArray(plhs[0]);
+    mxFree(time);
+    fallback(plhs);
+    return;
+  }
+
+  // make time start at 0
+  double time0 = time[0];
+  plhs[1] = mxCreateDoubleMatrix(1,timeLength,mxREAL);
+  double *timeOut = mxGetPr(plhs[1]);
+  for (i = 0; i < timeLength; i++)
+    timeOut[i] = time[i]-time0;
+  mxFree(time);
+}
+
+//////////////////////
+//   getEventField  //
+//////////////////////
+// copy a numeric field of the events structure into a double array,
+// returns NULL if the field is missing, not numeric/logical or shorter
+// than minLength. The returned array should be freed with mxFree
+double *getEventField(const mxArray *events, const char *fieldName, size_t minLength, size_t *length)
+{
+  mxArray *field = mxGetField(events,0,fieldName);
+  if ((field == NULL) || !(mxIsNumeric(field) || mxIsLogical(field)) || mxIsComplex(field)) return NULL;
+  size_t i, n = mxGetNumberOfElements(field);
+  if (n < minLength) return NULL;
+  double *retval = (double *)mxCalloc(n > 0 ? n : 1,sizeof(double));
+  void *p = mxGetData(field);
+  for (i = 0; i < n; i++) {
+    switch (mxGetClassID(field)) {
+      case mxDOUBLE_CLASS: retval[i] = ((double *)p)[i];break;
+      case mxSINGLE_CLASS: retval[i] = ((float *)p)[i];break;
+      case mxLOGICAL_CLASS: retval[i] = ((mxLogical *)p)[i];break;
+      case mxINT8_CLASS: retval[i] = ((int8_t *)p)[i];break;
+      case mxUINT8_CLASS: retval[i] = ((uint8_t *)p)[i];break;
+      case mxINT16_CLASS: retval[i] = ((int16_t *)p)[i];break;
+      case mxUINT16_CLASS: retval[i] = ((uint16_t *)p)[i];break;
+      case mxINT32_CLASS: retval[i] = ((int32_t *)p)[i];break;
+      case mxUINT32_CLASS: retval[i] = ((uint32_t *)p)[i];break;
+      default: mxFree(retval);return NULL;
+    }
+  }
+  if (length != NULL) *length = n;
+  return retval;
+}
+
+/////////////////////
+//   colonLength   //
+/////////////////////
+// number of elements matlab would make for a:d:b. This follows the
+// way the built-in colon operator is documented to compute its
+// length, so that we can tell if the m-file would have given a
+// size mismatch (in which case we let it do so).
+long colonLength(double a, double d, double b)
+{
+  if (!mxIsFinite(a) || !mxIsFinite(d) || !mxIsFinite(b)) return -1;
+  if ((d == 0) || ((a < b) && (d < 0)) || ((b < a) && (d > 0))) return 0;
+  double tol = 2.0*DBL_EPSILON*fmax(fabs(a),fabs(b));
+  double sig = (d > 0) ? 1 : -1;
+  double n;
+  if ((a == floor(a)) && (d == 1))
+    n = floor(b)-a;
+  else if ((a == floor(a)) && (d == floor(d))) {
+    double q = floor(a/d);
+    double r = a-q*d;
+    n = floor((b-r)/d)-q;
+  }
+  else {
+    n = round((b-a)/d);
+    if (sig*(a+n*d-b) > tol) n = n-1;
+  }
+  return (long)n+1;
+}
+
+///////////////////
+//   colonFill   //
+///////////////////
+// fill dest with the count elements of a:d:b. Like the built-in the
+// values are computed from both ends so that they are symmetric about
+// the mid-point and the last value hits b exactly
+void colonFill(double *dest, double a, double d, double b, long count)
+{
+  long k, n = count-1;
+  double last = a+n*d;
+  double tol = 2.0*DBL_EPSILON*fmax(fabs(a),fabs(b));
+  double sig = (d > 0) ? 1 : -1;
+  if ((a == floor(a)) && (d == floor(d)))
+    ;
+  else if (sig*(last-b) > -tol)
+    last = b;
+  for (k = 0; k <= n/2; k++) {
+    dest[k] = a+k*d;
+    dest[n-k] = last-k*d;
+  }
+  if ((n%2) == 0)
+    dest[n/2] = (a+last)/2;
+}
+
+//////////////////
+//   fallback   //
+//////////////////
+// return empties to tell makeTraces to use its own loop
+mxArray *fallback(mxArray *plhs[])
+{
+  plhs[0] = mxCreateDoubleMatrix(0,0,mxREAL);
+  plhs[1] = mxCreateDoubleMatrix(0,0,mxREAL);
+  return plhs[0];
+}
@@ -0,0 +1,113 @@
+#ifdef documentation
+=========================================================================
+
+     program: mglPrivateProceduralGratings.c
+          by: justin gardner
+        date: 10/19/2026
+     purpose: draws grating records [x y width height sf angle phase
+              contrast sdx sdy alphaMask] on the CPU, the same way that
+              mglMetal draws them for mglMetalProceduralGratings
+              (mglProceduralGratings.h), so that they can be checked
+              without a GPU (see mglTestProceduralGratings)
+   copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+       usage: frame = mglPrivateProceduralGratings(records,[left top],[xDeg2pix yDeg2pix],[width height],<background>)
+
+              records is 11 x nGratings. The frame is width x height
+              pixels, with the top left corner at left, top in device
+              units, and deg2pix pixels per device unit. background is
+              the rgba that the gratings are drawn over (default gray
+              [0.5 0.5 0.5 1]). frame is single height x width x 4 with
+              the top row first, like the rgba that mglFrameGrab returns.
+
+=========================================================================
+#endif
+
+/////////////////////////
+//   include section   //
+/////////////////////////
+#include "mgl.h"
+#include "mglProceduralGratings.h"
+
+///////////////////////////////
+//   function declarations   //
+///////////////////////////////
+static int getPair(const mxArray *pair, double *first, double *second);
+
+//////////////
+//   main   //
+//////////////
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+  // check arguments
+  double left, top, xDeg2pix, yDeg2pix, width, height;
+  if ((nrhs < 4) || (nrhs > 5) || !mxIsNumeric(prhs[0]) || mxIsComplex(prhs[0]) || (mxGetM(prhs[0]) != MGL_PROCEDURAL_GRATING_VALUES) ||
+      !getPair(prhs[1], &left, &top) || !getPair(prhs[2], &xDeg2pix, &yDeg2pix) || !getPair(prhs[3], &width, &height) ||
+      (xDeg2pix <= 0) || (yDeg2pix <= 0) || (width < 0) || (height < 0)) {
+    usageError("mglPrivateProceduralGratings");
+    return;
+  }
+  uint32_t nGratings = (uint32_t)mxGetN(prhs[0]);
+  uint32_t widthPixels = (uint32_t)width;
+  uint32_t heightPixels = (uint32_t)height;
+
+  // background
+  float background[4] = {0.5, 0.5, 0.5, 1};
+  if (nrhs > 4) {
+    if (!mxIsDouble(prhs[4]) || (mxGetNumberOfElements(prhs[4]) != 4)) {
+      usageError("mglPrivateProceduralGratings");
+      return;
+    }
+    int i;
+    for (i = 0; i < 4; i++)
+      background[i] = (float)mxGetPr(prhs[4])[i];
+  }
+
+  // convert records to single, as they are sent to mglMetal
+  float *records = (float *)mxMalloc((nGratings ? nGratings : 1)*MGL_PROCEDURAL_GRATING_VALUES*sizeof(float));
+  if (mxIsSingle(prhs[0]))
+    memcpy(records,mxGetData(prhs[0]),nGratings*MGL_PROCEDURAL_GRATING_VALUES*sizeof(float));
+  else if (mxIsDouble(prhs[0])) {
+    double *doubleRecords = mxGetPr(prhs[0]);
+    size_t i;
+    for (i = 0; i < nGratings*MGL_PROCEDURAL_GRATING_VALUES; i++)
+      records[i] = (float)doubleRecords[i];
+  }
+  else {
+    mxFree(records);
+    usageError("mglPrivateProceduralGratings");
+    return;
+  }
+
+  // draw into interleaved rgba, top row first, as the GPU does
+  size_t nPixels = (size_t)widthPixels*heightPixels;
+  float *rgba = (float *)mxMalloc((nPixels ? nPixels : 1)*4*sizeof(float));
+  size_t iPixel;
+  for (iPixel = 0; iPixel < nPixels; iPixel++)
+    memcpy(rgba+4*iPixel,background,sizeof(background));
+  mglProceduralGratingsRasterize(records,nGratings,left,top,xDeg2pix,yDeg2pix,widthPixels,heightPixels,rgba);
+
+  // and return as height x width x 4
+  mwSize dims[3] = {heightPixels, widthPixels, 4};
+  plhs[0] = mxCreateNumericArray(3,dims,mxSINGLE_CLASS,mxREAL);
+  float *frame = (float *)mxGetData(plhs[0]);
+  uint32_t row, column;
+  int channel;
+  for (row = 0; row < heightPixels; row++)
+    for (column = 0; column < widthPixels; column++)
+      for (channel = 0; channel < 4; channel++)
+        frame[row + (size_t)column*heightPixels + channel*nPixels] = rgba[4*((size_t)row*widthPixels + column) + channel];
+  mxFree(rgba);
+  mxFree(records);
+}
+
+/////////////////
+//   getPair   //
+/////////////////
+static int getPair(const mxArray *pair, double *first, double *second)
+{
+  if (!mxIsDouble(pair) || mxIsComplex(pair) || (mxGetNumberOfElements(pair) != 2))
+    return 0;
+  *first = mxGetPr(pair)[0];
+  *second = mxGetPr(pair)[1];
+  return 1;
+}
@@ -0,0 +1,109 @@
+#ifdef documentation
+=========================================================================
+
+     program: mglPrivateRandomDots.c
+          by: justin gardner
+        date: 10/19/2026
+     purpose: makes the random dots that mglMetal draws for
+              mglMetalRepeatingDots (mglRandomDots.h), split across a
+              number of threads, so that it can be checked that the dots
+              do not depend on the number of threads and timed
+              (see mglTestRandomDots)
+   copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+       usage: dots = mglPrivateRandomDots(nDots,seed,frame,<nThreads>)
+
+              dots is a single 11 x nDots array with each column
+              [xyz rgba wh isRound borderSize] as in the vertex buffer.
+              frame starts at 0 for the first frame of the command.
+
+=========================================================================
+#endif
+
+/////////////////////////
+//   include section   //
+/////////////////////////
+#include "mgl.h"
+#include "mglRandomDots.h"
+#include <pthread.h>
+
+////////////////////////
+//   define section   //
+////////////////////////
+#define MAX_THREADS 64
+
+//////////////////////////////////////////
+//   static variable and type section   //
+//////////////////////////////////////////
+typedef struct {
+  uint32_t seed;
+  uint32_t frame;
+  uint32_t firstDot;
+  uint32_t nDots;
+  float *buffer;
+} chunkType;
+
+///////////////////////////////
+//   function declarations   //
+///////////////////////////////
+static void *packChunk(void *data);
+
+//////////////
+//   main   //
+//////////////
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+  // check arguments
+  if ((nrhs < 3) || (nrhs > 4)) {
+    usageError("mglPrivateRandomDots");
+    return;
+  }
+  uint32_t nDots = (uint32_t)mxGetScalar(prhs[0]);
+  uint32_t seed = (uint32_t)mxGetScalar(prhs[1]);
+  uint32_t frame = (uint32_t)mxGetScalar(prhs[2]);
+  int nThreads = (nrhs > 3) ? (int)mxGetScalar(prhs[3]) : 1;
+  if (nThreads < 1) nThreads = 1;
+  if (nThreads > MAX_THREADS) nThreads = MAX_THREADS;
+
+  // create output
+  plhs[0] = mxCreateNumericMatrix(MGL_RANDOM_DOTS_VALUES_PER_DOT,nDots,mxSINGLE_CLASS,mxREAL);
+  float *buffer = (float *)mxGetData(plhs[0]);
+
+  // split the dots evenly between the threads. Note that the chunks
+  // do not have to line up with the groups of dots that mglRandomDots
+  // makes, which is part of what this checks
+  chunkType chunks[MAX_THREADS];
+  pthread_t threads[MAX_THREADS];
+  int started[MAX_THREADS];
+  int iThread;
+  for (iThread = 0; iThread < nThreads; iThread++) {
+    chunks[iThread].seed = seed;
+    chunks[iThread].frame = frame;
+    chunks[iThread].firstDot = (uint32_t)(((uint64_t)nDots*iThread)/nThreads);
+    chunks[iThread].nDots = (uint32_t)(((uint64_t)nDots*(iThread+1))/nThreads) - chunks[iThread].firstDot;
+    chunks[iThread].buffer = buffer + MGL_RANDOM_DOTS_VALUES_PER_DOT*chunks[iThread].firstDot;
+  }
+
+  // run the first chunk on this thread and the rest on their own
+  for (iThread = 1; iThread < nThreads; iThread++) {
+    started[iThread] = (pthread_create(&threads[iThread],NULL,packChunk,&chunks[iThread]) == 0);
+    if (!started[iThread]) {
+      // could not start the thread, so just do it here
+      mexPrintf("(mglPrivateRandomDots) Could not create thread %i\n",iThread);
+      packChunk(&chunks[iThread]);
+    }
+  }
+  packChunk(&chunks[0]);
+  for (iThread = 1; iThread < nThreads; iThread++) {
+    if (started[iThread]) pthread_join(threads[iThread],NULL);
+  }
+}
+
+///////////////////
+//   packChunk   //
+///////////////////
+static void *packChunk(void *data)
+{
+  chunkType *chunk = (chunkType *)data;
+  mglRandomDotsPack(chunk->seed,chunk->frame,chunk->firstDot,chunk->nDots,chunk->buffer);
+  return NULL;
+}
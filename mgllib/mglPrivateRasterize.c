@@ -0,0 +1,80 @@
+#ifdef documentation
+=========================================================================
+
+     program: mglPrivateRasterize.c
+          by: justin gardner
+        date: 10/19/2026
+     purpose: draws a recorded stream of mglMetal commands on the CPU (see
+              mglRasterize.h), one frame for each mglFlush, split across
+              a number of threads. Called by mglRasterize, which records
+              the stream
+   copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+       usage: frames = mglPrivateRasterize(stream,width,height,<format>,<nThreads>)
+
+              stream is the uint8 bytes written to mglMetal, width and
+              height are the size of the frames in pixels, format is
+              'single' (default) or 'uint8' and nThreads defaults to the
+              number of processors. frames is height x width x 4 x the
+              number of frames, empty if the stream could not be drawn.
+
+=========================================================================
+#endif
+
+/////////////////////////
+//   include section   //
+/////////////////////////
+#include "mgl.h"
+#include "mglRasterize.h"
+
+//////////////
+//   main   //
+//////////////
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+  // check arguments
+  if ((nrhs < 3) || (nrhs > 5) || !mxIsClass(prhs[0], "uint8") || !mxIsNumeric(prhs[1]) || !mxIsNumeric(prhs[2])) {
+    usageError("mglPrivateRasterize");
+    return;
+  }
+  mglReadbackFormat format = mglReadbackSingle;
+  if ((nrhs > 3) && !mxIsEmpty(prhs[3])) {
+    char *formatName = mxArrayToString(prhs[3]);
+    if ((formatName != NULL) && !strcmp(formatName, "uint8"))
+      format = mglReadbackUInt8;
+    else if ((formatName == NULL) || strcmp(formatName, "single")) {
+      mexPrintf("(mglPrivateRasterize) Unknown format, should be single or uint8\n");
+      mxFree(formatName);
+      plhs[0] = mxCreateDoubleMatrix(0, 0, mxREAL);
+      return;
+    }
+    mxFree(formatName);
+  }
+  int nThreads = ((nrhs > 4) && !mxIsEmpty(prhs[4])) ? (int)mxGetScalar(prhs[4]) : 0;
+  double width = mxGetScalar(prhs[1]), height = mxGetScalar(prhs[2]);
+  if (!(width >= 1) || !(height >= 1) || (width > 65536) || (height > 65536)) {
+    mexPrintf("(mglPrivateRasterize) Width and height should be from 1 to 65536 pixels\n");
+    plhs[0] = mxCreateDoubleMatrix(0, 0, mxREAL);
+    return;
+  }
+
+  // check the stream and find its frames
+  mglRasterizer rasterizer;
+  if (!mglRasterizeParse(&rasterizer, (const uint8_t *)mxGetData(prhs[0]), mxGetNumberOfElements(prhs[0]), (uint32_t)width, (uint32_t)height)) {
+    mexPrintf("(mglPrivateRasterize) %s\n", rasterizer.error);
+    plhs[0] = mxCreateDoubleMatrix(0, 0, mxREAL);
+    return;
+  }
+
+  // create output, height x width x 4 x frames
+  mwSize dims[4];
+  dims[0] = rasterizer.height; dims[1] = rasterizer.width; dims[2] = 4; dims[3] = rasterizer.frameCount;
+  plhs[0] = mxCreateNumericArray(4, dims, (format == mglReadbackUInt8) ? mxUINT8_CLASS : mxSINGLE_CLASS, mxREAL);
+
+  // draw them
+  if ((rasterizer.frameCount > 0) && (mglRasterize(&rasterizer, mxGetData(plhs[0]), format, nThreads) < 0)) {
+    mexPrintf("(mglPrivateRasterize) Could not allocate memory to draw %ux%u frames\n", rasterizer.width, rasterizer.height);
+    mxDestroyArray(plhs[0]);
+    plhs[0] = mxCreateDoubleMatrix(0, 0, mxREAL);
+  }
+  mglRasterizeFree(&rasterizer);
+}
@@ -0,0 +1,92 @@
+% mglPrivateShadowState.m
+%
+%      usage: [skip, shadowState] = mglPrivateShadowState(shadowState, commandName, value, descriptors)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: Private function that keeps a copy of the state that mglMetal
+%             keeps from one command (and frame) to the next, so that
+%             commands that would set it to what it already is can be
+%             skipped (see mglMetalSkipRedundantCommands). This function
+%             does not talk to mglMetal, so it can be tested on its own
+%             (see mglTestSkipRedundantCommands).
+%
+%             shadowState -- struct from an earlier call, or [] to start
+%             commandName -- one of the commands that set state
+%               (mglSetXform, mglSetClearColor, mglSelectStencil,
+%               mglSetRenderTarget, mglSetViewColorPixelFormat), or
+%               'invalidate' to forget the state named in value (a cell
+%               array of field names like {'xform'}, or [] for all of it),
+%               or 'suspend' / 'resume' to stop and start skipping, for
+%               example while a display list is being recorded.
+%             value -- the value the command sends
+%             descriptors -- connectionSocketDescriptors the command goes
+%               to. State is only known for one set of sockets at a time.
+%
+%             Returns whether the command can be skipped, and the updated
+%             shadowState, with skipCount and sendCount for each command.
+%
+function [skip, shadowState] = mglPrivateShadowState(shadowState, commandName, value, descriptors)
+
+skip = false;
+
+% these need to match state that mglMetal keeps
+commandNames = {'mglSetXform','mglSetClearColor','mglSelectStencil','mglSetRenderTarget','mglSetViewColorPixelFormat'};
+fieldNames = {'xform','clearColor','stencil','renderTarget','pixelFormat'};
+
+% start with nothing known
+if isempty(shadowState)
+  shadowState.descriptors = [];
+  shadowState.suspended = false;
+  for iField = 1:length(fieldNames)
+    shadowState.(fieldNames{iField}) = [];
+  end
+  for iCommand = 1:length(commandNames)
+    shadowState.skipCount.(commandNames{iCommand}) = 0;
+    shadowState.sendCount.(commandNames{iCommand}) = 0;
+  end
+end
+
+switch commandName
+  case 'invalidate'
+    if isempty(value), value = fieldNames; end
+    for iField = 1:length(value)
+      shadowState.(value{iField}) = [];
+    end
+    return
+  case 'suspend'
+    [~, shadowState] = mglPrivateShadowState(shadowState, 'invalidate', [], descriptors);
+    shadowState.suspended = true;
+    return
+  case 'resume'
+    [~, shadowState] = mglPrivateShadowState(shadowState, 'invalidate', [], descriptors);
+    shadowState.suspended = false;
+    return
+end
+
+iCommand = find(strcmp(commandName, commandNames));
+if isempty(iCommand)
+  disp(sprintf('(mglPrivateShadowState) Unknown command %s',commandName));
+  return
+end
+fieldName = fieldNames{iCommand};
+
+% nothing is known about a different set of sockets
+descriptors = descriptors(:)';
+if ~isequal(descriptors, shadowState.descriptors)
+  [~, shadowState] = mglPrivateShadowState(shadowState, 'invalidate', [], descriptors);
+  shadowState.descriptors = descriptors;
+end
+
+% skip if the state already has this value
+if ~shadowState.suspended && ~isempty(shadowState.(fieldName)) && isequal(shadowState.(fieldName), value)
+  skip = true;
+  shadowState.skipCount.(commandName) = shadowState.skipCount.(commandName) + 1;
+  return
+end
+
+% otherwise it will be sent, so remember it, unless recording for later
+shadowState.sendCount.(commandName) = shadowState.sendCount.(commandName) + 1;
+if ~shadowState.suspended
+  shadowState.(fieldName) = value;
+end
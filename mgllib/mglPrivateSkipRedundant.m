@@ -0,0 +1,48 @@
+% mglPrivateSkipRedundant.m
+%
+%      usage: [skip, results] = mglPrivateSkipRedundant(commandName, value, socketInfo)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: Private function called by functions that set mglMetal state
+%             (like mglTransform and mglClearScreen) before they send their
+%             command. When mglMetalSkipRedundantCommands is on, and the
+%             command would set the state to what it already is, returns
+%             skip true along with results like mglReadCommandResults
+%             would give, but with ackTime and processedTime of 0, so the
+%             command does not need to be sent. Also takes
+%             'invalidate', 'suspend' and 'resume' (see mglPrivateShadowState).
+%
+function [skip, results] = mglPrivateSkipRedundant(commandName, value, socketInfo)
+
+global mgl
+skip = false;
+results = [];
+
+% nothing to do unless turned on
+if ~isfield(mgl, 'shadowState') || isempty(mgl.shadowState)
+  return
+end
+
+descriptors = [];
+if isstruct(socketInfo)
+  descriptors = [socketInfo.connectionSocketDescriptor];
+end
+[skip, mgl.shadowState] = mglPrivateShadowState(mgl.shadowState, commandName, value, descriptors);
+
+% make results as if the command was sent and succeeded
+if skip
+  resultSize = [1 numel(socketInfo)];
+  results = repmat(struct( ...
+    'commandCode', socketInfo(1).command.(commandName), ...
+    'success', uint32(1), ...
+    'ackTime', 0, ...
+    'setupTime', 0, ...
+    'processedTime', 0, ...
+    'vertexStart', 0, ...
+    'vertexEnd', 0, ...
+    'fragmentStart', 0, ...
+    'fragmentEnd', 0, ...
+    'drawableAcquired', 0, ...
+    'drawablePresented', 0), resultSize);
+end
@@ -0,0 +1,308 @@
+#ifdef documentation
+=========================================================================
+
+     program: mglPrivateStimvolIndex.c
+          by: justin gardner
+        date: 10/19/2026
+     purpose: inverted index used by getStimvolFromVarname. An index is
+              built once from the value a variable took on each trial and
+              maps each value to the sorted list of trials on which it
+              was set, so that asking which trials had a set of values
+              does not need to scan all trials again. Also does the set
+              intersection of sorted volume numbers that is used when
+              crossing conditions.
+   copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+       usage: index = mglPrivateStimvolIndex(varval)
+
+              builds the index from varval (value on each trial). The
+              index is a structure with fields values (sorted unique
+              values, nan is left out since it never matches anything),
+              first and count (where in trials the list for each value
+              starts and how long it is), trials and dims (size of varval)
+
+              isTrial = mglPrivateStimvolIndex(index,values)
+
+              returns a logical array the size of varval which is true
+              for trials on which varval was one of values. This is the
+              same as ismember(varval,values).
+
+              [c ia ib status] = mglPrivateStimvolIndex('intersect',a,b)
+
+              intersection of two row vectors that are sorted in
+              ascending order (duplicates are allowed), returns the same
+              as [c ia ib] = intersect(a,b). status is 0 if a or b was
+              not a sorted row vector of doubles without nans, in which
+              case the caller should use intersect instead.
+
+=========================================================================
+#endif
+
+/////////////////////////
+//   include section   //
+/////////////////////////
+#include "mgl.h"
+
+//////////////////
+//   typedefs   //
+//////////////////
+typedef struct valueTrial {
+  double value;
+  size_t trial;
+} valueTrial;
+
+///////////////////////////////
+//   function declarations   //
+///////////////////////////////
+static void buildIndex(int nlhs, mxArray *plhs[], const mxArray *varval);
+static void queryIndex(int nlhs, mxArray *plhs[], const mxArray *index, const mxArray *values);
+static void intersectSorted(int nlhs, mxArray *plhs[], const mxArray *a, const mxArray *b);
+static double *getDoubles(const mxArray *array, size_t *length);
+static int isSortedRow(const mxArray *array);
+static int compareValueTrial(const void *a, const void *b);
+static long findValue(const double *values, size_t n, double value);
+
+//////////////
+//   main   //
+//////////////
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+  // build an index
+  if ((nrhs == 1) && (mxIsNumeric(prhs[0]) || mxIsLogical(prhs[0])) && !mxIsComplex(prhs[0]))
+    buildIndex(nlhs,plhs,prhs[0]);
+  // query an index
+  else if ((nrhs == 2) && mxIsStruct(prhs[0]))
+    queryIndex(nlhs,plhs,prhs[0],prhs[1]);
+  // intersect sorted arrays
+  else if ((nrhs == 3) && mxIsChar(prhs[0])) {
+    char command[32];
+    mxGetString(prhs[0],command,32);
+    if (strcmp(command,"intersect") == 0)
+      intersectSorted(nlhs,plhs,prhs[1],prhs[2]);
+    else
+      mexErrMsgTxt("(mglPrivateStimvolIndex) Unknown command");
+  }
+  else {
+    usageError("mglPrivateStimvolIndex");
+  }
+}
+
+////////////////////
+//   buildIndex   //
+////////////////////
+static void buildIndex(int nlhs, mxArray *plhs[], const mxArray *varval)
+{
+  size_t i, n, nValid = 0, nValues = 0;
+  double *values = getDoubles(varval,&n);
+  if (values == NULL) mexErrMsgTxt("(mglPrivateStimvolIndex) varval must be a real numeric array");
+
+  // pair each value with its trial, leaving out nan since nan == nan
+  // is never true. Then sort by value, ties are sorted by trial
+  valueTrial *pairs = (valueTrial *)mxCalloc(n > 0 ? n : 1,sizeof(valueTrial));
+  for (i = 0; i < n; i++) {
+    if (!mxIsNaN(values[i])) {
+      pairs[nValid].value = values[i];
+      pairs[nValid++].trial = i+1;
+    }
+  }
+  qsort(pairs,nValid,sizeof(valueTrial),compareValueTrial);
+
+  // count unique values
+  for (i = 0; i < nValid; i++)
+    if ((i == 0) || (pairs[i].value != pairs[i-1].value)) nValues++;
+
+  // and make the output structure
+  const char *fieldNames[] = {"values","first","count","trials","dims"};
+  plhs[0] = mxCreateStructMatrix(1,1,5,fieldNames);
+  mxArray *uniqueValues = mxCreateDoubleMatrix(1,nValues,mxREAL);
+  mxArray *first = mxCreateDoubleMatrix(1,nValues,mxREAL);
+  mxArray *count = mxCreateDoubleMatrix(1,nValues,mxREAL);
+  mxArray *trials = mxCreateDoubleMatrix(1,nValid,mxREAL);
+  double *uniqueValuesPtr = mxGetPr(uniqueValues), *firstPtr = mxGetPr(first);
+  double *countPtr = mxGetPr(count), *trialsPtr = mxGetPr(trials);
+  long valueNum = -1;
+  for (i = 0; i < nValid; i++) {
+    if ((i == 0) || (pairs[i].value != pairs[i-1].value)) {
+      valueNum++;
+      uniqueValuesPtr[valueNum] = pairs[i].value;
+      firstPtr[valueNum] = i+1;
+    }
+    countPtr[valueNum]++;
+    trialsPtr[i] = pairs[i].trial;
+  }
+
+  // keep the dimensions of varval so queries return the same shape
+  mwSize nDims = mxGetNumberOfDimensions(varval);
+  const mwSize *dims = mxGetDimensions(varval);
+  mxArray *dimsArray = mxCreateDoubleMatrix(1,nDims,mxREAL);
+  for (i = 0; i < nDims; i++)
+    mxGetPr(dimsArray)[i] = dims[i];
+
+  mxSetField(plhs[0],0,"values",uniqueValues);
+  mxSetField(plhs[0],0,"first",first);
+  mxSetField(plhs[0],0,"count",count);
+  mxSetField(plhs[0],0,"trials",trials);
+  mxSetField(plhs[0],0,"dims",dimsArray);
+
+  mxFree(pairs);
+  mxFree(values);
+}
+
+////////////////////
+//   queryIndex   //
+////////////////////
+static void queryIndex(int nlhs, mxArray *plhs[], const mxArray *index, const mxArray *values)
+{
+  mxArray *uniqueValuesField = mxGetField(index,0,"values");
+  mxArray *firstField = mxGetField(index,0,"first");
+  mxArray *countField = mxGetField(index,0,"count");
+  mxArray *trialsField = mxGetField(index,0,"trials");
+  mxArray *dimsField = mxGetField(index,0,"dims");
+  if ((uniqueValuesField == NULL) || (firstField == NULL) || (countField == NULL) || (trialsField == NULL) || (dimsField == NULL) || !mxIsDouble(uniqueValuesField) || !mxIsDouble(firstField) || !mxIsDouble(countField) || !mxIsDouble(trialsField) || !mxIsDouble(dimsField))
+    mexErrMsgTxt("(mglPrivateStimvolIndex) Index structure is not valid");
+
+  // create the output array the same size as varval was
+  size_t i, j, nDims = mxGetNumberOfElements(dimsField), nTrials = 1;
+  mwSize *dims = (mwSize *)mxCalloc(nDims > 2 ? nDims : 2,sizeof(mwSize));
+  for (i = 0; i < nDims; i++) {
+    dims[i] = (mwSize)mxGetPr(dimsField)[i];
+    nTrials *= dims[i];
+  }
+  plhs[0] = mxCreateLogicalArray(nDims,dims);
+  mxLogical *isTrial = mxGetLogicals(plhs[0]);
+  mxFree(dims);
+
+  // look up each value and mark its trials
+  size_t nQuery, nValues = mxGetNumberOfElements(uniqueValuesField);
+  size_t nIndexTrials = mxGetNumberOfElements(trialsField);
+  double *query = getDoubles(values,&nQuery);
+  if (query == NULL) mexErrMsgTxt("(mglPrivateStimvolIndex) values must be a real numeric array");
+  double *uniqueValues = mxGetPr(uniqueValuesField);
+  double *first = mxGetPr(firstField), *count = mxGetPr(countField), *trials = mxGetPr(trialsField);
+  for (i = 0; i < nQuery; i++) {
+    long valueNum = findValue(uniqueValues,nValues,query[i]);
+    if (valueNum < 0) continue;
+    for (j = 0; j < (size_t)count[valueNum]; j++) {
+      size_t k = (size_t)first[valueNum]-1+j;
+      if ((k < nIndexTrials) && (trials[k] >= 1) && (trials[k] <= nTrials))
+        isTrial[(size_t)trials[k]-1] = 1;
+    }
+  }
+  mxFree(query);
+}
+
+/////////////////////////
+//   intersectSorted   //
+/////////////////////////
+static void intersectSorted(int nlhs, mxArray *plhs[], const mxArray *a, const mxArray *b)
+{
+  // check that we can do this with a merge
+  if (!isSortedRow(a) || !isSortedRow(b)) {
+    plhs[0] = mxCreateDoubleMatrix(0,0,mxREAL);
+    plhs[1] = mxCreateDoubleMatrix(0,0,mxREAL);
+    plhs[2] = mxCreateDoubleMatrix(0,0,mxREAL);
+    plhs[3] = mxCreateDoubleScalar(0);
+    return;
+  }
+
+  // walk down both arrays, the first occurrence of each common
+  // value is kept for the indexes just like intersect does
+  size_t nA = mxGetNumberOfElements(a), nB = mxGetNumberOfElements(b);
+  size_t maxLength = (nA < nB) ? nA : nB;
+  double *aPtr = mxGetPr(a), *bPtr = mxGetPr(b);
+  double *c = (double *)mxCalloc(maxLength > 0 ? maxLength : 1,sizeof(double));
+  double *ia = (double *)mxCalloc(maxLength > 0 ? maxLength : 1,sizeof(double));
+  double *ib = (double *)mxCalloc(maxLength > 0 ? maxLength : 1,sizeof(double));
+  size_t i = 0, j = 0, n = 0;
+  while ((i < nA) && (j < nB)) {
+    if (aPtr[i] < bPtr[j]) i++;
+    else if (bPtr[j] < aPtr[i]) j++;
+    else {
+      double value = aPtr[i];
+      c[n] = value;ia[n] = i+1;ib[n++] = j+1;
+      while ((i < nA) && (aPtr[i] == value)) i++;
+      while ((j < nB) && (bPtr[j] == value)) j++;
+    }
+  }
+
+  // c is a row, indexes are columns
+  plhs[0] = mxCreateDoubleMatrix(1,n,mxREAL);
+  plhs[1] = mxCreateDoubleMatrix(n,1,mxREAL);
+  plhs[2] = mxCreateDoubleMatrix(n,1,mxREAL);
+  memcpy(mxGetPr(plhs[0]),c,n*sizeof(double));
+  memcpy(mxGetPr(plhs[1]),ia,n*sizeof(double));
+  memcpy(mxGetPr(plhs[2]),ib,n*sizeof(double));
+  plhs[3] = mxCreateDoubleScalar(1);
+  mxFree(c);mxFree(ia);mxFree(ib);
+}
+
+////////////////////
+//   getDoubles   //
+////////////////////
+// copy a real numeric or logical array into doubles, free with mxFree
+static double *getDoubles(const mxArray *array, size_t *length)
+{
+  if (!(mxIsNumeric(array) || mxIsLogical(array)) || mxIsComplex(array)) return NULL;
+  size_t i, n = mxGetNumberOfElements(array);
+  double *retval = (double *)mxCalloc(n > 0 ? n : 1,sizeof(double));
+  void *p = mxGetData(array);
+  for (i = 0; i < n; i++) {
+    switch (mxGetClassID(array)) {
+      case mxDOUBLE_CLASS: retval[i] = ((double *)p)[i];break;
+      case mxSINGLE_CLASS: retval[i] = ((float *)p)[i];break;
+      case mxLOGICAL_CLASS: retval[i] = ((mxLogical *)p)[i];break;
+      case mxINT8_CLASS: retval[i] = ((int8_t *)p)[i];break;
+      case mxUINT8_CLASS: retval[i] = ((uint8_t *)p)[i];break;
+      case mxINT16_CLASS: retval[i] = ((int16_t *)p)[i];break;
+      case mxUINT16_CLASS: retval[i] = ((uint16_t *)p)[i];break;
+      case mxINT32_CLASS: retval[i] = ((int32_t *)p)[i];break;
+      case mxUINT32_CLASS: retval[i] = ((uint32_t *)p)[i];break;
+      default: mxFree(retval);return NULL;
+    }
+  }
+  *length = n;
+  return retval;
+}
+
+/////////////////////
+//   isSortedRow   //
+/////////////////////
+// true for a 1xn double array in ascending order without nans
+static int isSortedRow(const mxArray *array)
+{
+  if (!mxIsDouble(array) || mxIsComplex(array) || (mxGetNumberOfDimensions(array) != 2) || (mxGetM(array) != 1)) return 0;
+  size_t i, n = mxGetN(array);
+  double *p = mxGetPr(array);
+  for (i = 0; i < n; i++) {
+    if (mxIsNaN(p[i])) return 0;
+    if ((i > 0) && (p[i] < p[i-1])) return 0;
+  }
+  return 1;
+}
+
+///////////////////////////
+//   compareValueTrial   //
+///////////////////////////
+static int compareValueTrial(const void *a, const void *b)
+{
+  const valueTrial *x = (const valueTrial *)a, *y = (const valueTrial *)b;
+  if (x->value < y->value) return -1;
+  if (x->value > y->value) return 1;
+  return (x->trial < y->trial) ? -1 : ((x->trial > y->trial) ? 1 : 0);
+}
+
+///////////////////
+//   findValue   //
+///////////////////
+// binary search for value in the sorted values, -1 if not there
+static long findValue(const double *values, size_t n, double value)
+{
+  size_t lo = 0, hi = n;
+  if (mxIsNaN(value)) return -1;
+  while (lo < hi) {
+    size_t mid = lo+(hi-lo)/2;
+    if (values[mid] < value) lo = mid+1;
+    else hi = mid;
+  }
+  if ((lo < n) && (values[lo] == value)) return (long)lo;
+  return -1;
+}
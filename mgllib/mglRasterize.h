@@ -0,0 +1,869 @@
+#ifdef documentation
+=========================================================================
+
+  program: mglRasterize.h
+       by: justin gardner
+     date: 10/19/2026
+copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+  purpose: draws a stream of mglMetal commands, exactly the bytes that
+           mglSocketWrite would send to mglMetal, on the CPU, into one
+           image for each mglFlush, so that stimulus images can be made
+           on a machine with no display or GPU (see mglRasterize.m,
+           which records the stream with mglSocketCoalesce).
+
+           Draws what mglMetal draws for mglSetClearColor, mglSetXform,
+           mglPolygon (a triangle strip), mglQuad (triangles), mglMetalDots,
+           mglMetalArcs and mglMetalBltTexture, with textures made with
+           mglCreateTexture in the stream, into RGBA float frames blended
+           as the pipelines in mglColorRenderingConfig.swift do (source
+           alpha over one minus source alpha). Vertices go through the
+           deg2metal transform to pixels, snapped to 1/256 of a pixel as
+           the GPU does, and pixels are covered when their centers are
+           inside a triangle, with the top left rule for centers on an
+           edge. Dots and arcs use the same math as fragment_dots and
+           fragment_arcs in mglShaders.metal, in float. Colors and texture
+           coordinates are interpolated linearly in screen space, which
+           is what the GPU does for the 2D vertices mgl sends. Linear
+           texture filtering uses full precision weights, where the GPU
+           uses fewer bits, so blts can differ by a bit or so.
+
+           The stream is first read through once, to check every command
+           and find where each frame starts, with the transform and clear
+           color it starts with, and to copy out textures. Then the frames
+           are drawn independently, split across threads, and each is
+           converted to height x width x 4 in Matlab order with
+           mglReadback.h, as single or uint8. Any other command, or a
+           stream that ends in the middle of a command, is an error
+           that says which command and where, rather than an image
+           that silently differs from what the display would show.
+           Commands after the last mglFlush are not drawn, as on the
+           display.
+
+           This is plain C with no Matlab dependencies, see
+           mglBenchmark/mglBenchmarkRasterize.c for a standalone test
+           and benchmark.
+
+=========================================================================
+#endif
+
+#ifndef MGL_RASTERIZE_H
+#define MGL_RASTERIZE_H
+
+/////////////////////////
+//   include section   //
+/////////////////////////
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "mglCommandTypes.h"
+#include "mglReadback.h"
+
+//////////////////////
+//   define section //
+//////////////////////
+#define MGL_RASTERIZE_MAX_THREADS 64
+// vertices are snapped to 1/256 of a pixel, and kept as integers in those units
+#define MGL_RASTERIZE_SUBPIXELS 256
+// vertices further off screen than this many pixels are clamped, so edge functions fit in 64 bits
+#define MGL_RASTERIZE_MAX_COORDINATE 1048576.0
+// values per vertex after xyz, as mglCommandInterface readVertices extraVals
+#define MGL_RASTERIZE_COLOR_VALUES 6
+#define MGL_RASTERIZE_DOT_VALUES 11
+#define MGL_RASTERIZE_ARC_VALUES 14
+#define MGL_RASTERIZE_TEXTURE_VALUES 5
+
+// a texture made with mglCreateTexture, rgba rows with the top row first
+typedef struct {
+  uint32_t width;
+  uint32_t height;
+  float *pixels;
+  int deleted;
+} mglRasterizeTexture;
+
+// where the commands of a frame are in the stream, and the state it starts with
+typedef struct {
+  size_t start;
+  size_t end;
+  float xform[16];
+  float clearColor[3];
+} mglRasterizeFrame;
+
+typedef struct {
+  const uint8_t *stream;
+  size_t streamBytes;
+  uint32_t width;
+  uint32_t height;
+  mglRasterizeTexture *textures;
+  uint32_t textureCount;
+  mglRasterizeFrame *frames;
+  uint32_t frameCount;
+  char error[256];
+} mglRasterizer;
+
+// one command read from the stream, with its vertices left in place in the stream
+typedef struct {
+  mglCommandCode commandCode;
+  uint32_t count;
+  size_t values;
+  uint32_t valuesPerVertex;
+  uint32_t minMagFilter;
+  uint32_t addressMode;
+  uint32_t textureNumber;
+  float phase;
+  float xform[16];
+  float color[3];
+  uint32_t textureWidth;
+  uint32_t textureHeight;
+} mglRasterizeCommand;
+
+// how to color the pixels of a triangle
+typedef enum {
+  mglRasterizeShadeColor = 0,
+  mglRasterizeShadeTexture = 1,
+  mglRasterizeShadeArc = 2
+} mglRasterizeShadeType;
+
+typedef struct {
+  mglRasterizeShadeType type;
+  // per vertex color or texture coordinates, for the 3 vertices of the triangle
+  float attributes[3][3];
+  // for blts
+  const mglRasterizeTexture *texture;
+  uint32_t minMagFilter;
+  uint32_t addressMode;
+  float phase;
+  // for arcs, what vertex_arcs passes to fragment_arcs
+  float color[4];
+  float startAngle;
+  float halfSweep;
+  float centerPosition[2];
+  float outerRadius[2];
+  float innerRadius[2];
+  float halfBorderOuterRadiusRatio[2];
+} mglRasterizeShading;
+
+// threads take frames until there are none left
+typedef struct {
+  const mglRasterizer *rasterizer;
+  void *images;
+  uint32_t format;
+  uint32_t nextFrame;
+} mglRasterizeWork;
+
+////////////////////////////
+//   mglRasterizeSetError //
+////////////////////////////
+static inline int mglRasterizeSetError(mglRasterizer *rasterizer, size_t offset, const char *message, mglCommandCode commandCode)
+{
+  const char *name = NULL;
+  for (size_t i = 0; i < sizeof(mglCommandCodes) / sizeof(mglCommandCodes[0]); i++)
+    if (mglCommandCodes[i] == commandCode) name = mglCommandNames[i];
+  if (name != NULL)
+    snprintf(rasterizer->error, sizeof(rasterizer->error), "%s %s at byte %zu", message, name, offset);
+  else
+    snprintf(rasterizer->error, sizeof(rasterizer->error), "%s %u at byte %zu", message, (unsigned)commandCode, offset);
+  return 0;
+}
+
+////////////////////////
+//   mglRasterizeRead //
+////////////////////////
+// Copy bytes out of the stream, which has no alignment, returning 0 if it ends first.
+static inline int mglRasterizeRead(const mglRasterizer *rasterizer, size_t *offset, void *data, size_t numBytes)
+{
+  if ((*offset > rasterizer->streamBytes) || (numBytes > rasterizer->streamBytes - *offset)) return 0;
+  memcpy(data, rasterizer->stream + *offset, numBytes);
+  *offset += numBytes;
+  return 1;
+}
+
+////////////////////////////////
+//   mglRasterizeReadVertices //
+////////////////////////////////
+// A count, then count vertices of xyz and extra values, as readVertices reads them.
+static inline int mglRasterizeReadVertices(const mglRasterizer *rasterizer, size_t *offset, mglRasterizeCommand *command, uint32_t valuesPerVertex)
+{
+  if (!mglRasterizeRead(rasterizer, offset, &command->count, sizeof(uint32_t))) return 0;
+  size_t numBytes = (size_t)command->count * valuesPerVertex * sizeof(float);
+  if ((*offset > rasterizer->streamBytes) || (numBytes > rasterizer->streamBytes - *offset)) return 0;
+  command->values = *offset;
+  command->valuesPerVertex = valuesPerVertex;
+  *offset += numBytes;
+  return 1;
+}
+
+///////////////////////////////
+//   mglRasterizeReadCommand //
+///////////////////////////////
+// Read the next command, returning 0 with an error for one that cannot be drawn, or that is cut off.
+static inline int mglRasterizeReadCommand(mglRasterizer *rasterizer, size_t *offset, mglRasterizeCommand *command)
+{
+  size_t commandOffset = *offset;
+  int ok = 1;
+  memset(command, 0, sizeof(mglRasterizeCommand));
+  if (!mglRasterizeRead(rasterizer, offset, &command->commandCode, sizeof(mglCommandCode)))
+    return mglRasterizeSetError(rasterizer, commandOffset, "Stream ends in a command code", 0xFFFF);
+
+  switch (command->commandCode) {
+    case mglFlush:
+      break;
+    case mglSetClearColor:
+      ok = mglRasterizeRead(rasterizer, offset, command->color, 3 * sizeof(float));
+      break;
+    case mglSetXform:
+      ok = mglRasterizeRead(rasterizer, offset, command->xform, 16 * sizeof(float));
+      break;
+    case mglPolygon:
+    case mglQuad:
+      ok = mglRasterizeReadVertices(rasterizer, offset, command, MGL_RASTERIZE_COLOR_VALUES);
+      break;
+    case mglDots:
+      ok = mglRasterizeReadVertices(rasterizer, offset, command, MGL_RASTERIZE_DOT_VALUES);
+      break;
+    case mglArcs:
+      ok = mglRasterizeReadVertices(rasterizer, offset, command, MGL_RASTERIZE_ARC_VALUES);
+      break;
+    case mglBltTexture: {
+      uint32_t mipFilter;
+      ok = mglRasterizeRead(rasterizer, offset, &command->minMagFilter, sizeof(uint32_t)) &&
+           mglRasterizeRead(rasterizer, offset, &mipFilter, sizeof(uint32_t)) &&
+           mglRasterizeRead(rasterizer, offset, &command->addressMode, sizeof(uint32_t)) &&
+           mglRasterizeReadVertices(rasterizer, offset, command, MGL_RASTERIZE_TEXTURE_VALUES) &&
+           mglRasterizeRead(rasterizer, offset, &command->phase, sizeof(float)) &&
+           mglRasterizeRead(rasterizer, offset, &command->textureNumber, sizeof(uint32_t));
+      break;
+    }
+    case mglCreateTexture: {
+      ok = mglRasterizeRead(rasterizer, offset, &command->textureWidth, sizeof(uint32_t)) &&
+           mglRasterizeRead(rasterizer, offset, &command->textureHeight, sizeof(uint32_t));
+      size_t pixelBytes = 4 * sizeof(float);
+      if (ok && command->textureWidth && (command->textureHeight > SIZE_MAX / pixelBytes / command->textureWidth)) ok = 0;
+      size_t numBytes = ok ? (size_t)command->textureWidth * command->textureHeight * pixelBytes : 0;
+      if (ok && (numBytes > rasterizer->streamBytes - *offset)) ok = 0;
+      if (ok) {
+        command->values = *offset;
+        *offset += numBytes;
+      }
+      break;
+    }
+    case mglDeleteTexture:
+      ok = mglRasterizeRead(rasterizer, offset, &command->textureNumber, sizeof(uint32_t));
+      break;
+    default:
+      return mglRasterizeSetError(rasterizer, commandOffset, "Cannot draw", command->commandCode);
+  }
+  if (!ok) return mglRasterizeSetError(rasterizer, commandOffset, "Stream ends in", command->commandCode);
+  return 1;
+}
+
+/////////////////////////
+//   mglRasterizeFree  //
+/////////////////////////
+static inline void mglRasterizeFree(mglRasterizer *rasterizer)
+{
+  for (uint32_t i = 0; i < rasterizer->textureCount; i++)
+    free(rasterizer->textures[i].pixels);
+  free(rasterizer->textures);
+  free(rasterizer->frames);
+  rasterizer->textures = NULL;
+  rasterizer->textureCount = 0;
+  rasterizer->frames = NULL;
+  rasterizer->frameCount = 0;
+}
+
+///////////////////////////
+//   mglRasterizeGrow    //
+///////////////////////////
+// Make room for one more element in an array that starts with 16 and doubles as it fills.
+static inline int mglRasterizeGrow(void **array, uint32_t count, size_t elementBytes)
+{
+  if ((count != 0) && ((count < 16) || (count & (count - 1)))) return 1;
+  void *newArray = realloc(*array, (count ? 2 * (size_t)count : 16) * elementBytes);
+  if (newArray == NULL) return 0;
+  *array = newArray;
+  return 1;
+}
+
+//////////////////////////
+//   mglRasterizeParse  //
+//////////////////////////
+// Read through the stream of commands for width x height frames, checking every command, and
+// finding the frames and textures. The stream must stay around until the frames are drawn.
+// Returns 0 with rasterizer->error set if the stream cannot be drawn.
+static inline int mglRasterizeParse(mglRasterizer *rasterizer, const void *stream, size_t streamBytes, uint32_t width, uint32_t height)
+{
+  memset(rasterizer, 0, sizeof(mglRasterizer));
+  rasterizer->stream = (const uint8_t *)stream;
+  rasterizer->streamBytes = streamBytes;
+  rasterizer->width = width;
+  rasterizer->height = height;
+  if ((width == 0) || (height == 0)) {
+    snprintf(rasterizer->error, sizeof(rasterizer->error), "Frames must be at least 1x1, not %ux%u", width, height);
+    return 0;
+  }
+
+  // mglMetal starts with the identity transform and a gray clear color
+  float xform[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+  float clearColor[3] = {0.5f, 0.5f, 0.5f};
+  mglRasterizeFrame frame;
+  int frameHasDrawn = 0;
+  memcpy(frame.xform, xform, sizeof(xform));
+  frame.start = 0;
+
+  size_t offset = 0;
+  while (offset < streamBytes) {
+    size_t commandOffset = offset;
+    mglRasterizeCommand command;
+    if (!mglRasterizeReadCommand(rasterizer, &offset, &command)) {
+      mglRasterizeFree(rasterizer);
+      return 0;
+    }
+    switch (command.commandCode) {
+      case mglSetClearColor:
+        // the clear color is set before the frame is cleared, unless something was drawn already
+        memcpy(clearColor, command.color, sizeof(clearColor));
+        continue;
+      case mglSetXform:
+        memcpy(xform, command.xform, sizeof(xform));
+        continue;
+      case mglCreateTexture: {
+        if (!mglRasterizeGrow((void **)&rasterizer->textures, rasterizer->textureCount, sizeof(mglRasterizeTexture))) {
+          mglRasterizeFree(rasterizer);
+          snprintf(rasterizer->error, sizeof(rasterizer->error), "Out of memory for textures");
+          return 0;
+        }
+        size_t numBytes = (size_t)command.textureWidth * command.textureHeight * 4 * sizeof(float);
+        mglRasterizeTexture *texture = &rasterizer->textures[rasterizer->textureCount++];
+        texture->width = command.textureWidth;
+        texture->height = command.textureHeight;
+        texture->deleted = 0;
+        texture->pixels = (float *)malloc(numBytes ? numBytes : 1);
+        if (texture->pixels == NULL) {
+          mglRasterizeFree(rasterizer);
+          snprintf(rasterizer->error, sizeof(rasterizer->error), "Out of memory for a %ux%u texture", command.textureWidth, command.textureHeight);
+          return 0;
+        }
+        memcpy(texture->pixels, rasterizer->stream + command.values, numBytes);
+        continue;
+      }
+      case mglDeleteTexture:
+        if ((command.textureNumber >= 1) && (command.textureNumber <= rasterizer->textureCount))
+          rasterizer->textures[command.textureNumber - 1].deleted = 1;
+        continue;
+      case mglBltTexture:
+        // textures are numbered from 1 in the order they are made, as in mglColorRenderingState
+        if ((command.textureNumber < 1) || (command.textureNumber > rasterizer->textureCount) ||
+            rasterizer->textures[command.textureNumber - 1].deleted) {
+          snprintf(rasterizer->error, sizeof(rasterizer->error), "mglBltTexture of texture %u, which was not made in the stream, at byte %zu", command.textureNumber, commandOffset);
+          mglRasterizeFree(rasterizer);
+          return 0;
+        }
+        break;
+      default:
+        break;
+    }
+
+    // the frame is cleared with the clear color when the first thing is drawn in it
+    if (!frameHasDrawn) {
+      memcpy(frame.clearColor, clearColor, sizeof(clearColor));
+      frameHasDrawn = 1;
+    }
+    if (command.commandCode == mglFlush) {
+      frame.end = commandOffset;
+      if (!mglRasterizeGrow((void **)&rasterizer->frames, rasterizer->frameCount, sizeof(mglRasterizeFrame))) {
+        mglRasterizeFree(rasterizer);
+        snprintf(rasterizer->error, sizeof(rasterizer->error), "Out of memory for frames");
+        return 0;
+      }
+      rasterizer->frames[rasterizer->frameCount++] = frame;
+      frame.start = offset;
+      memcpy(frame.xform, xform, sizeof(xform));
+      frameHasDrawn = 0;
+    }
+  }
+  return 1;
+}
+
+////////////////////////////////
+//   mglRasterizeToPixels     //
+////////////////////////////////
+// Transform a vertex with deg2metal (column major) to pixels from the top left, snapped to subpixels.
+static inline void mglRasterizeToPixels(const mglRasterizer *rasterizer, const float *xform, float x, float y, float z, int64_t pixel[2])
+{
+  float clip[4];
+  for (int row = 0; row < 4; row++)
+    clip[row] = xform[row] * x + xform[4 + row] * y + xform[8 + row] * z + xform[12 + row];
+  double pixelX = ((double)clip[0] / clip[3] * 0.5 + 0.5) * rasterizer->width;
+  double pixelY = (0.5 - (double)clip[1] / clip[3] * 0.5) * rasterizer->height;
+  // NaN ends up off screen
+  if (!(pixelX > -MGL_RASTERIZE_MAX_COORDINATE)) pixelX = -MGL_RASTERIZE_MAX_COORDINATE;
+  if (!(pixelY > -MGL_RASTERIZE_MAX_COORDINATE)) pixelY = -MGL_RASTERIZE_MAX_COORDINATE;
+  if (pixelX > MGL_RASTERIZE_MAX_COORDINATE) pixelX = MGL_RASTERIZE_MAX_COORDINATE;
+  if (pixelY > MGL_RASTERIZE_MAX_COORDINATE) pixelY = MGL_RASTERIZE_MAX_COORDINATE;
+  pixel[0] = (int64_t)llround(pixelX * MGL_RASTERIZE_SUBPIXELS);
+  pixel[1] = (int64_t)llround(pixelY * MGL_RASTERIZE_SUBPIXELS);
+}
+
+///////////////////////////////
+//   mglRasterizeSmoothstep  //
+///////////////////////////////
+// As Metal smoothstep, including when the edges are the same, which makes it a step.
+static inline float mglRasterizeSmoothstep(float edge0, float edge1, float x)
+{
+  float t = fminf(fmaxf((x - edge0) / (edge1 - edge0), 0.0f), 1.0f);
+  return t * t * (3.0f - 2.0f * t);
+}
+
+////////////////////////////
+//   mglRasterizeAddress  //
+////////////////////////////
+// Wrap a texel index with an MTLSamplerAddressMode, -1 for outside a clamp to zero or border.
+static inline int64_t mglRasterizeAddress(int64_t i, int64_t n, uint32_t addressMode)
+{
+  switch (addressMode) {
+    case 0: // clampToEdge
+      return (i < 0) ? 0 : ((i >= n) ? n - 1 : i);
+    case 1: // mirrorClampToEdge
+      if (i < 0) i = -i - 1;
+      return (i >= n) ? n - 1 : i;
+    case 3: // mirrorRepeat
+      i %= 2 * n;
+      if (i < 0) i += 2 * n;
+      return (i < n) ? i : 2 * n - 1 - i;
+    case 4: // clampToZero
+    case 5: // clampToBorderColor, transparent black
+      return ((i < 0) || (i >= n)) ? -1 : i;
+    default: // repeat, which is also what mglBltTextureCommand uses for unknown modes
+      i %= n;
+      return (i < 0) ? i + n : i;
+  }
+}
+
+///////////////////////////
+//   mglRasterizeSample  //
+///////////////////////////
+// Sample a texture at u,v (0-1 across the texture, v going down), nearest (0) or linear (1, and anything else).
+static inline void mglRasterizeSample(const mglRasterizeTexture *texture, uint32_t minMagFilter, uint32_t addressMode, float u, float v, float rgba[4])
+{
+  memset(rgba, 0, 4 * sizeof(float));
+  if ((texture->width == 0) || (texture->height == 0)) return;
+  float x = u * texture->width;
+  float y = v * texture->height;
+  if (minMagFilter != 0) {
+    x -= 0.5f;
+    y -= 0.5f;
+  }
+  // keep far away coordinates, and NaN, from overflowing
+  if (!(x > -1e12f)) x = -1e12f;
+  if (!(y > -1e12f)) y = -1e12f;
+  if (x > 1e12f) x = 1e12f;
+  if (y > 1e12f) y = 1e12f;
+  float floorX = floorf(x), floorY = floorf(y);
+  int64_t i0 = (int64_t)floorX, j0 = (int64_t)floorY;
+
+  if (minMagFilter == 0) {
+    int64_t i = mglRasterizeAddress(i0, texture->width, addressMode);
+    int64_t j = mglRasterizeAddress(j0, texture->height, addressMode);
+    if ((i >= 0) && (j >= 0)) memcpy(rgba, texture->pixels + 4 * (j * texture->width + i), 4 * sizeof(float));
+    return;
+  }
+
+  float fractionX = x - floorX, fractionY = y - floorY;
+  for (int dj = 0; dj < 2; dj++) {
+    int64_t j = mglRasterizeAddress(j0 + dj, texture->height, addressMode);
+    float weightY = dj ? fractionY : 1.0f - fractionY;
+    for (int di = 0; di < 2; di++) {
+      int64_t i = mglRasterizeAddress(i0 + di, texture->width, addressMode);
+      if ((i < 0) || (j < 0)) continue;
+      float weight = weightY * (di ? fractionX : 1.0f - fractionX);
+      const float *texel = texture->pixels + 4 * (j * texture->width + i);
+      for (int c = 0; c < 4; c++) rgba[c] += weight * texel[c];
+    }
+  }
+}
+
+//////////////////////////
+//   mglRasterizeShade  //
+//////////////////////////
+// The color of a pixel at x,y (its center, in pixels) with the given barycentric weights.
+static inline void mglRasterizeShade(const mglRasterizeShading *shading, float x, float y, const float weights[3], float rgba[4])
+{
+  switch (shading->type) {
+    default:
+    case mglRasterizeShadeColor:
+      // fragment_with_color, where a color that is the same at all the vertices stays exactly that
+      for (int c = 0; c < 3; c++) {
+        const float a0 = shading->attributes[0][c], a1 = shading->attributes[1][c], a2 = shading->attributes[2][c];
+        rgba[c] = ((a0 == a1) && (a1 == a2)) ? a0 : weights[0] * a0 + weights[1] * a1 + weights[2] * a2;
+      }
+      rgba[3] = 1.0f;
+      break;
+    case mglRasterizeShadeTexture: {
+      // fragment_textures, the phase moves the color but not the alpha
+      float u = weights[0] * shading->attributes[0][0] + weights[1] * shading->attributes[1][0] + weights[2] * shading->attributes[2][0];
+      float v = weights[0] * shading->attributes[0][1] + weights[1] * shading->attributes[1][1] + weights[2] * shading->attributes[2][1];
+      float alpha[4];
+      mglRasterizeSample(shading->texture, shading->minMagFilter, shading->addressMode, u + shading->phase, v + shading->phase, rgba);
+      mglRasterizeSample(shading->texture, shading->minMagFilter, shading->addressMode, u, v, alpha);
+      rgba[3] = alpha[3];
+      break;
+    }
+    case mglRasterizeShadeArc: {
+      // fragment_arcs
+      float centeredX = x - shading->centerPosition[0];
+      float centeredY = y - shading->centerPosition[1];
+      float angle = atan2f(-centeredY, centeredX);
+      float distanceToCenter = sqrtf(centeredX * centeredX + centeredY * centeredY);
+      // cos and sin of angle times distance are just the centered x and -y, which saves the trig and powers
+      float cosAngle = (distanceToCenter > 0) ? centeredX / distanceToCenter : 1.0f;
+      float sinAngle = (distanceToCenter > 0) ? -centeredY / distanceToCenter : 0.0f;
+      float outerX = centeredX / shading->outerRadius[0], outerY = centeredY / shading->outerRadius[1];
+      float innerX = centeredX / shading->innerRadius[0], innerY = centeredY / shading->innerRadius[1];
+      float borderX = cosAngle * shading->halfBorderOuterRadiusRatio[0], borderY = sinAngle * shading->halfBorderOuterRadiusRatio[1];
+      float outerRadius = sqrtf(outerX * outerX + outerY * outerY);
+      float innerRadius = sqrtf(innerX * innerX + innerY * innerY);
+      float halfBorderOuterRadiusRatio = sqrtf(borderX * borderX + borderY * borderY);
+      float innerOuterRadiusRatio = outerRadius / innerRadius;
+      float aOuter = 1.0f - mglRasterizeSmoothstep(1.0f - halfBorderOuterRadiusRatio, 1.0f + halfBorderOuterRadiusRatio, outerRadius);
+      float aInner = mglRasterizeSmoothstep(innerOuterRadiusRatio - halfBorderOuterRadiusRatio, innerOuterRadiusRatio + halfBorderOuterRadiusRatio, outerRadius);
+      float positiveCenter = shading->startAngle + shading->halfSweep;
+      float aPositive = 1.0f - mglRasterizeSmoothstep(shading->halfSweep, shading->halfSweep, fabsf(angle - positiveCenter));
+      float negativeCenter = shading->startAngle - 2.0f * (float)M_PI + shading->halfSweep;
+      float aNegative = 1.0f - mglRasterizeSmoothstep(shading->halfSweep, shading->halfSweep, fabsf(angle - negativeCenter));
+      memcpy(rgba, shading->color, 3 * sizeof(float));
+      rgba[3] = shading->color[3] * aInner * aOuter * (aPositive + aNegative);
+      break;
+    }
+  }
+}
+
+//////////////////////////
+//   mglRasterizeBlend  //
+//////////////////////////
+// Source alpha over one minus source alpha, for color and alpha, as the pipelines blend.
+static inline void mglRasterizeBlend(float *pixel, const float rgba[4])
+{
+  float alpha = rgba[3];
+  for (int c = 0; c < 4; c++)
+    pixel[c] = rgba[c] * alpha + pixel[c] * (1.0f - alpha);
+}
+
+/////////////////////////////
+//   mglRasterizeTopLeft   //
+/////////////////////////////
+// With the vertices clockwise on screen, pixel centers on top edges and left edges are covered.
+static inline int mglRasterizeTopLeft(const int64_t *a, const int64_t *b)
+{
+  return ((a[1] == b[1]) && (b[0] > a[0])) || (b[1] < a[1]);
+}
+
+/////////////////////////////
+//   mglRasterizeTriangle  //
+/////////////////////////////
+// Cover the pixels whose centers are in a triangle of vertices in subpixels, and blend in their shading.
+static inline void mglRasterizeTriangle(const mglRasterizer *rasterizer, float *rows, const int64_t vertex[3][2], const mglRasterizeShading *shading)
+{
+  const int64_t subpixels = MGL_RASTERIZE_SUBPIXELS;
+  // vertices in clockwise order on screen (y goes down), keeping track of which is which
+  int order[3] = {0, 1, 2};
+  const int64_t *v0 = vertex[0], *v1 = vertex[1], *v2 = vertex[2];
+  int64_t area = (v1[0] - v0[0]) * (v2[1] - v0[1]) - (v1[1] - v0[1]) * (v2[0] - v0[0]);
+  if (area == 0) return;
+  if (area < 0) {
+    v1 = vertex[2]; v2 = vertex[1];
+    order[1] = 2; order[2] = 1;
+    area = -area;
+  }
+
+  // pixels whose centers are within the bounding box
+  int64_t minX = v0[0], maxX = v0[0], minY = v0[1], maxY = v0[1];
+  if (v1[0] < minX) minX = v1[0];
+  if (v2[0] < minX) minX = v2[0];
+  if (v1[0] > maxX) maxX = v1[0];
+  if (v2[0] > maxX) maxX = v2[0];
+  if (v1[1] < minY) minY = v1[1];
+  if (v2[1] < minY) minY = v2[1];
+  if (v1[1] > maxY) maxY = v1[1];
+  if (v2[1] > maxY) maxY = v2[1];
+  int64_t firstX = (minX - subpixels / 2 + subpixels - 1) / subpixels;
+  int64_t lastX = (maxX - subpixels / 2) / subpixels;
+  int64_t firstY = (minY - subpixels / 2 + subpixels - 1) / subpixels;
+  int64_t lastY = (maxY - subpixels / 2) / subpixels;
+  if (minX - subpixels / 2 < 0) firstX = 0;
+  if (minY - subpixels / 2 < 0) firstY = 0;
+  if (lastX >= (int64_t)rasterizer->width) lastX = (int64_t)rasterizer->width - 1;
+  if (lastY >= (int64_t)rasterizer->height) lastY = (int64_t)rasterizer->height - 1;
+  if ((maxX - subpixels / 2 < 0) || (maxY - subpixels / 2 < 0) || (firstX > lastX) || (firstY > lastY)) return;
+
+  // edge functions, each is the weight of the vertex opposite, times area, and steps as x goes across
+  const int64_t *edgeStart[3] = {v1, v2, v0};
+  const int64_t *edgeEnd[3] = {v2, v0, v1};
+  int64_t bias[3], stepX[3], rowStart[3];
+  int64_t centerX = firstX * subpixels + subpixels / 2, centerY = firstY * subpixels + subpixels / 2;
+  for (int e = 0; e < 3; e++) {
+    const int64_t *a = edgeStart[e], *b = edgeEnd[e];
+    bias[e] = mglRasterizeTopLeft(a, b) ? 0 : -1;
+    stepX[e] = -(b[1] - a[1]) * subpixels;
+    rowStart[e] = (b[0] - a[0]) * (centerY - a[1]) - (b[1] - a[1]) * (centerX - a[0]);
+  }
+
+  // each row covers a span of pixels where all the edges are in, worked out from the edges
+  // so that long thin triangles do not test every pixel of their bounding box
+  const double inverseArea = 1.0 / (double)area;
+  for (int64_t y = firstY; y <= lastY; y++) {
+    int64_t first = 0, last = lastX - firstX;
+    for (int e = 0; e < 3; e++) {
+      // steps across the row until the edge is in (positive step) or out (negative step)
+      int64_t need = -bias[e] - rowStart[e];
+      if (stepX[e] > 0) {
+        int64_t steps = (need <= 0) ? 0 : (need + stepX[e] - 1) / stepX[e];
+        if (steps > first) first = steps;
+      }
+      else if (stepX[e] < 0) {
+        int64_t steps = (need > 0) ? -1 : (-need) / (-stepX[e]);
+        if (steps < last) last = steps;
+      }
+      else if (need > 0) last = -1;
+    }
+    float *pixel = rows + 4 * ((size_t)y * rasterizer->width + firstX + first);
+    for (int64_t step = first; step <= last; step++, pixel += 4) {
+      float weights[3], rgba[4];
+      weights[order[0]] = (float)((rowStart[0] + step * stepX[0]) * inverseArea);
+      weights[order[1]] = (float)((rowStart[1] + step * stepX[1]) * inverseArea);
+      weights[order[2]] = (float)((rowStart[2] + step * stepX[2]) * inverseArea);
+      mglRasterizeShade(shading, (float)(firstX + step) + 0.5f, (float)y + 0.5f, weights, rgba);
+      mglRasterizeBlend(pixel, rgba);
+    }
+    for (int e = 0; e < 3; e++)
+      rowStart[e] += (edgeEnd[e][0] - edgeStart[e][0]) * subpixels;
+  }
+}
+
+/////////////////////////////
+//   mglRasterizeVertices  //
+/////////////////////////////
+// Draw triangles (strip 0) or a triangle strip (strip 1) of [xyz rgb] or [xyz uv] vertices.
+static inline void mglRasterizeVertices(const mglRasterizer *rasterizer, float *rows, const float *xform, const mglRasterizeCommand *command, int strip, mglRasterizeShading *shading)
+{
+  size_t vertexBytes = command->valuesPerVertex * sizeof(float);
+  size_t nTriangles = strip ? ((command->count >= 3) ? command->count - 2 : 0) : command->count / 3;
+  for (size_t triangle = 0; triangle < nTriangles; triangle++) {
+    int64_t vertex[3][2];
+    for (int corner = 0; corner < 3; corner++) {
+      float values[MGL_RASTERIZE_COLOR_VALUES];
+      size_t index = strip ? triangle + corner : 3 * triangle + corner;
+      memcpy(values, rasterizer->stream + command->values + index * vertexBytes, vertexBytes);
+      mglRasterizeToPixels(rasterizer, xform, values[0], values[1], values[2], vertex[corner]);
+      memcpy(shading->attributes[corner], values + 3, (command->valuesPerVertex - 3) * sizeof(float));
+    }
+    mglRasterizeTriangle(rasterizer, rows, (const int64_t (*)[2])vertex, shading);
+  }
+}
+
+/////////////////////////
+//   mglRasterizeDots  //
+/////////////////////////
+// Points of [xyz rgba w h isRound border], with sizes in pixels, as vertex_dots and fragment_dots draw them.
+static inline void mglRasterizeDots(const mglRasterizer *rasterizer, float *rows, const float *xform, const mglRasterizeCommand *command)
+{
+  for (uint32_t dot = 0; dot < command->count; dot++) {
+    float values[MGL_RASTERIZE_DOT_VALUES];
+    memcpy(values, rasterizer->stream + command->values + (size_t)dot * sizeof(values), sizeof(values));
+    int64_t center[2];
+    mglRasterizeToPixels(rasterizer, xform, values[0], values[1], values[2], center);
+    float pointSize = fmaxf(values[7], values[8]);
+    if (!(pointSize > 0)) continue;
+    float halfSize[2] = {values[7] / pointSize / 2.0f, values[8] / pointSize / 2.0f};
+    int isRound = (values[9] != 0);
+    float halfBorder = values[10] / pointSize / 2.0f;
+
+    // pixels whose centers are within the point
+    double left = (double)center[0] / MGL_RASTERIZE_SUBPIXELS - pointSize / 2.0;
+    double top = (double)center[1] / MGL_RASTERIZE_SUBPIXELS - pointSize / 2.0;
+    double firstX = ceil(left - 0.5), firstY = ceil(top - 0.5);
+    double lastX = ceil(left + pointSize - 0.5) - 1, lastY = ceil(top + pointSize - 0.5) - 1;
+    if (firstX < 0) firstX = 0;
+    if (firstY < 0) firstY = 0;
+    if (lastX > rasterizer->width - 1.0) lastX = rasterizer->width - 1.0;
+    if (lastY > rasterizer->height - 1.0) lastY = rasterizer->height - 1.0;
+    if ((firstX > lastX) || (firstY > lastY)) continue;
+    for (double y = firstY; y <= lastY; y++) {
+      float *pixel = rows + 4 * ((size_t)y * rasterizer->width + (size_t)firstX);
+      for (double x = firstX; x <= lastX; x++, pixel += 4) {
+        float centeredX = fabsf((float)((x + 0.5 - left) / pointSize) - 0.5f);
+        float centeredY = fabsf((float)((y + 0.5 - top) / pointSize) - 0.5f);
+        float a;
+        if (isRound) {
+          float radius = (centeredX * centeredX) / (halfSize[0] * halfSize[0]) + (centeredY * centeredY) / (halfSize[1] * halfSize[1]);
+          a = values[6] * (1.0f - mglRasterizeSmoothstep(1.0f - halfBorder, 1.0f + halfBorder, radius));
+        }
+        else {
+          float aX = 1.0f - mglRasterizeSmoothstep(halfSize[0], halfSize[0], centeredX);
+          float aY = 1.0f - mglRasterizeSmoothstep(halfSize[1], halfSize[1], centeredY);
+          a = values[6] * aX * aY;
+        }
+        if (a == 0) continue;
+        float rgba[4] = {values[3], values[4], values[5], a};
+        mglRasterizeBlend(pixel, rgba);
+      }
+    }
+  }
+}
+
+/////////////////////////
+//   mglRasterizeArcs  //
+/////////////////////////
+// Arcs of [xyz rgba radii(4) wedge(2) border], as the square of two triangles that vertex_arcs makes.
+static inline void mglRasterizeArcs(const mglRasterizer *rasterizer, float *rows, const float *xform, const mglRasterizeCommand *command)
+{
+  static const float cornerX[6] = {-1, -1, 1, -1, 1, 1};
+  static const float cornerY[6] = {-1, 1, 1, -1, -1, 1};
+  for (uint32_t arc = 0; arc < command->count; arc++) {
+    float values[MGL_RASTERIZE_ARC_VALUES];
+    memcpy(values, rasterizer->stream + command->values + (size_t)arc * sizeof(values), sizeof(values));
+    const float *radii = values + 7, *wedge = values + 11;
+    float border = values[13];
+
+    mglRasterizeShading shading;
+    shading.type = mglRasterizeShadeArc;
+    memcpy(shading.color, values + 3, sizeof(shading.color));
+    shading.startAngle = wedge[0];
+    shading.halfSweep = wedge[1] / 2.0f;
+    // the center with y flipped, in pixels, without flipping y back
+    float center[4];
+    for (int row = 0; row < 4; row++)
+      center[row] = xform[row] * values[0] - xform[4 + row] * values[1] + xform[8 + row] * values[2] + xform[12 + row];
+    shading.centerPosition[0] = (center[0] / center[3] * 0.5f + 0.5f) * rasterizer->width;
+    shading.centerPosition[1] = (center[1] / center[3] * 0.5f + 0.5f) * rasterizer->height;
+    shading.outerRadius[0] = (xform[0] * radii[1] / 2.0f) * rasterizer->width;
+    shading.outerRadius[1] = (xform[5] * radii[3] / 2.0f) * rasterizer->height;
+    shading.innerRadius[0] = (xform[0] * radii[0] / 2.0f) * rasterizer->width;
+    shading.innerRadius[1] = (xform[5] * radii[2] / 2.0f) * rasterizer->height;
+    shading.halfBorderOuterRadiusRatio[0] = (border / radii[1]) / 2.0f;
+    shading.halfBorderOuterRadiusRatio[1] = (border / radii[3]) / 2.0f;
+
+    // the corners of a square around the arc, out to the outer radius + half the border
+    int64_t corners[6][2];
+    for (int corner = 0; corner < 6; corner++) {
+      float x = values[0] + cornerX[corner] * (radii[1] + border / 2.0f);
+      float y = values[1] + cornerY[corner] * (radii[3] + border / 2.0f);
+      mglRasterizeToPixels(rasterizer, xform, x, y, values[2], corners[corner]);
+    }
+    mglRasterizeTriangle(rasterizer, rows, (const int64_t (*)[2])corners, &shading);
+    mglRasterizeTriangle(rasterizer, rows, (const int64_t (*)[2])(corners + 3), &shading);
+  }
+}
+
+/////////////////////////////
+//   mglRasterizeDrawFrame //
+/////////////////////////////
+// Draw one frame into width x height rgba rows, top row first.
+static inline void mglRasterizeDrawFrame(const mglRasterizer *rasterizer, uint32_t frameIndex, float *rows)
+{
+  const mglRasterizeFrame *frame = &rasterizer->frames[frameIndex];
+  size_t nPixels = (size_t)rasterizer->width * rasterizer->height;
+  for (size_t i = 0; i < nPixels; i++) {
+    memcpy(rows + 4 * i, frame->clearColor, 3 * sizeof(float));
+    rows[4 * i + 3] = 1.0f;
+  }
+
+  float xform[16];
+  memcpy(xform, frame->xform, sizeof(xform));
+  size_t offset = frame->start;
+  while (offset < frame->end) {
+    mglRasterizeCommand command;
+    // the stream was checked by mglRasterizeParse, so this only reads
+    if (!mglRasterizeReadCommand((mglRasterizer *)rasterizer, &offset, &command)) return;
+    mglRasterizeShading shading;
+    switch (command.commandCode) {
+      case mglSetXform:
+        memcpy(xform, command.xform, sizeof(xform));
+        break;
+      case mglPolygon:
+      case mglQuad:
+        shading.type = mglRasterizeShadeColor;
+        mglRasterizeVertices(rasterizer, rows, xform, &command, command.commandCode == mglPolygon, &shading);
+        break;
+      case mglBltTexture:
+        shading.type = mglRasterizeShadeTexture;
+        shading.texture = &rasterizer->textures[command.textureNumber - 1];
+        shading.minMagFilter = command.minMagFilter;
+        shading.addressMode = command.addressMode;
+        shading.phase = command.phase;
+        mglRasterizeVertices(rasterizer, rows, xform, &command, 0, &shading);
+        break;
+      case mglDots:
+        mglRasterizeDots(rasterizer, rows, xform, &command);
+        break;
+      case mglArcs:
+        mglRasterizeArcs(rasterizer, rows, xform, &command);
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+/////////////////////////////
+//   mglRasterizeFrames    //
+/////////////////////////////
+// Thread function that takes frames until there are none left.
+static void *mglRasterizeFrames(void *data)
+{
+  mglRasterizeWork *work = (mglRasterizeWork *)data;
+  const mglRasterizer *rasterizer = work->rasterizer;
+  size_t bytesPerRow = (size_t)rasterizer->width * 4 * sizeof(float);
+  size_t imageBytes = mglReadbackImageBytes(rasterizer->width, rasterizer->height, work->format);
+  float *rows = (float *)malloc(bytesPerRow * rasterizer->height);
+  if (rows == NULL) return NULL;
+
+  uint32_t frameIndex;
+  while ((frameIndex = __atomic_fetch_add(&work->nextFrame, 1, __ATOMIC_RELAXED)) < rasterizer->frameCount) {
+    mglRasterizeDrawFrame(rasterizer, frameIndex, rows);
+    mglReadbackToImage(rows, bytesPerRow, rasterizer->width, rasterizer->height, work->format, (uint8_t *)work->images + frameIndex * imageBytes);
+  }
+  free(rows);
+  return NULL;
+}
+
+////////////////////
+//   mglRasterize //
+////////////////////
+// Draw all the frames found by mglRasterizeParse into height x width x 4 x frameCount images, single or
+// uint8 (see mglReadback.h), on up to nThreads threads (0 for the number of processors). Returns the
+// number of threads used, or -1 if there was no memory to draw with. A thread that cannot get memory
+// leaves its frames to the others.
+static inline int mglRasterize(const mglRasterizer *rasterizer, void *images, uint32_t format, int nThreads)
+{
+  mglRasterizeWork work;
+  work.rasterizer = rasterizer;
+  work.images = images;
+  work.format = format;
+  work.nextFrame = 0;
+  if (rasterizer->frameCount == 0) return 0;
+
+  // no more threads than processors or frames
+  if (nThreads <= 0) nThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  if ((uint32_t)nThreads > rasterizer->frameCount) nThreads = (int)rasterizer->frameCount;
+  if (nThreads > MGL_RASTERIZE_MAX_THREADS) nThreads = MGL_RASTERIZE_MAX_THREADS;
+  if (nThreads < 1) nThreads = 1;
+
+  // run on this thread and the rest on their own, any that do not start leave their frames to the others
+  pthread_t threads[MGL_RASTERIZE_MAX_THREADS];
+  int started[MGL_RASTERIZE_MAX_THREADS];
+  int iThread;
+  for (iThread = 1; iThread < nThreads; iThread++)
+    started[iThread] = (pthread_create(&threads[iThread], NULL, mglRasterizeFrames, &work) == 0);
+  mglRasterizeFrames(&work);
+  for (iThread = 1; iThread < nThreads; iThread++)
+    if (started[iThread]) pthread_join(threads[iThread], NULL);
+  if (work.nextFrame < rasterizer->frameCount) return -1;
+  return nThreads;
+}
+
+#endif
@@ -0,0 +1,127 @@
+% mglRasterize: draw frames on the CPU, without a display or GPU
+%
+%      usage: mglRasterize('open', width, height)
+%             frames = mglRasterize('close', <format>, <nThreads>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: Makes stimulus images offline, for example for reconstructing
+%             what a subject saw in the scanner, on a machine with no
+%             display, like a Linux compute server. mglRasterize('open')
+%             takes the place of mglOpen: the usual drawing functions
+%             write their commands as if to mglMetal, but they are
+%             recorded (see mglSocketCoalesce) instead of sent. Each
+%             mglFlush ends a frame. mglRasterize('close') draws all the
+%             frames on the CPU, split across threads (mglPrivateRasterize),
+%             and puts back whatever display was open before.
+%
+%             frames is height x width x 4 x the number of frames, RGBA,
+%             single (default) or uint8 if format is 'uint8'. nThreads
+%             defaults to the number of processors.
+%
+%             Draws mglClearScreen, mglTransform (and so
+%             mglVisualAngleCoordinates), mglPolygon, mglQuad,
+%             mglMetalDots (mglPoints2), mglMetalArcs (mglFillOval,
+%             mglGluDisk etc.) and mglBltTexture of textures made while
+%             recording, as mglMetal would. Anything else, like mglLines,
+%             stencils or text, can not be drawn, and close says which
+%             command it was and returns empty.
+%
+%             mglRasterize('open', 80, 60);
+%             mglVisualAngleCoordinates(57, [16 12]);
+%             for i = 1:10
+%               mglClearScreen(0.5);
+%               mglFillOval(0, 0, [i i], [1 1 1]);
+%               mglFlush;
+%             end
+%             frames = mglRasterize('close');
+%             imagesc(frames(:,:,1,10));
+%
+function frames = mglRasterize(command, arg1, arg2)
+
+frames = [];
+if ~any(nargin == [1 2 3])
+  help mglRasterize
+  return
+end
+
+% what mgl was before opening, to put back at close, and the size of the frames
+persistent savedMgl savedMGL rasterizeSize
+global mgl
+global MGL
+
+% check that the mex functions are compiled
+if exist('mglPrivateRasterize')~=3
+  disp(sprintf('(mglRasterize) mglPrivateRasterize is not compiled. Run mglMakeMetal'));
+  return
+end
+if exist('mglSocketCoalesce')~=3
+  disp(sprintf('(mglRasterize) mglSocketCoalesce is not compiled. Run mglMakeSocket'));
+  return
+end
+
+switch lower(command)
+  case 'open'
+    if nargin ~= 3
+      help mglRasterize
+      return
+    end
+    if ~isempty(rasterizeSize)
+      disp(sprintf('(mglRasterize) Already open, use mglRasterize(''close'') first'));
+      return
+    end
+    savedMgl = mgl;
+    savedMGL = MGL;
+    rasterizeSize = [arg1 arg2];
+
+    % a socket that is never connected to anything, only recorded
+    socketInfo = struct('address', 'mglRasterize', 'pollMilliseconds', 0, 'maxConnections', 0, ...
+      'boundSocketDescriptor', -1, 'connectionSocketDescriptor', 2^30);
+    socketInfo.command = mglSocketCommandTypes();
+    mglSocketCoalesce(socketInfo, 2);
+    mgl.s = socketInfo;
+    mgl.activeSockets = socketInfo;
+    mgl.mirrorSockets = [];
+    mgl.shadowState = [];
+    mgl.coalesceCommands = false;
+
+    % set up the mgl context as mglMetalOpen does for a window this size
+    mglSetParam('displayNumber', 0);
+    mglSetParam('screenX', 0);
+    mglSetParam('screenY', 0);
+    mglSetParam('screenWidth', arg1);
+    mglSetParam('screenHeight', arg2);
+    mglSetParam('xPixelsToDevice', 2 / arg1);
+    mglSetParam('yPixelsToDevice', 2 / arg2);
+    mglSetParam('xDeviceToPixels', arg1 / 2);
+    mglSetParam('yDeviceToPixels', arg2 / 2);
+    mglSetParam('deviceWidth', 2);
+    mglSetParam('deviceHeight', 2);
+    mglSetParam('deviceCoords', 'default');
+    mglSetParam('deviceRect', [-1 -1 1 1]);
+    mglSetParam('stencilBits', 8);
+    mglSetParam('numTextures', 0);
+    mglTransform('set', eye(4));
+
+  case 'close'
+    if isempty(rasterizeSize)
+      disp(sprintf('(mglRasterize) Not open, use mglRasterize(''open'', width, height) first'));
+      return
+    end
+    if nargin < 2 || isempty(arg1), arg1 = 'single'; end
+    if nargin < 3, arg2 = []; end
+
+    % take the recorded commands, and put back what was open before
+    [~, stream] = mglSocketCoalesce(mgl.s, 0);
+    mgl = savedMgl;
+    MGL = savedMGL;
+    frameSize = rasterizeSize;
+    savedMgl = [];
+    savedMGL = [];
+    rasterizeSize = [];
+
+    frames = mglPrivateRasterize(stream, frameSize(1), frameSize(2), arg1, arg2);
+
+  otherwise
+    disp(sprintf('(mglRasterize) Unknown command %s, should be open or close', command));
+end
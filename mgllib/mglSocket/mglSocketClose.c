@@ -15,6 +15,9 @@ copyright: (c) 2019 Justin Gardner (GPL see mgl/COPYING)
 //   include section   //
 /////////////////////////
 #include "mgl.h"
+#include "mglCommandTypes.h"
+#include "mglSocketCoalesce.h"
+#include "mglSocketFanOut.h"
 #include <sys/socket.h>
 
 //////////////
@@ -62,6 +65,16 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
             if (verbose) {
                 mexPrintf("(mglSocketClose) closing connectionSocketDescriptor %d.\n", connectionSocketDescriptor);
             }
+            // Forget anything held for this socket, in case commands were being coalesced.
+            mglSocketCoalesceSocket* coalesceSocket = mglSocketCoalesceGetSocket(mglSocketCoalesceGetState(), connectionSocketDescriptor, 0);
+            if (coalesceSocket != NULL) {
+                mglSocketCoalesceFreeSocket(coalesceSocket);
+            }
+            // And forget its fan-out settings, since the descriptor may be reused.
+            mglSocketFanOutSocket* fanOutSocket = mglSocketFanOutGetSocket(mglSocketFanOutGetState(), connectionSocketDescriptor, 0);
+            if (fanOutSocket != NULL) {
+                mglSocketFanOutFreeSocket(fanOutSocket);
+            }
             close(connectionSocketDescriptor);
         }
     }
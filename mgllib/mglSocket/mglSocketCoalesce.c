@@ -0,0 +1,236 @@
+#ifdef documentation
+=========================================================================
+
+  program: mglSocketCoalesce.c
+       by: justin gardner
+     date: 10/19/2026
+copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+  purpose: mex function to turn on or off coalescing of drawing commands
+           (see mglSocketCoalesce.h), and to get back the results of
+           commands that were coalesced, or to record the commands
+           written to a socket instead of sending them
+    usage: [results, recorded] = mglSocketCoalesce(s, <coalesce>)
+
+=========================================================================
+#endif
+
+/////////////////////////
+//   include section   //
+/////////////////////////
+#include "mgl.h"
+#include "mglCommandTypes.h"
+#include "mglSocketCoalesce.h"
+#include "mglSocketFanOut.h"
+#include <sys/socket.h>
+
+mxArray* takeResults(const mxArray* socketInfo, mglSocketCoalesceState* state);
+mxArray* takeRecorded(const mxArray* socketInfo, mglSocketCoalesceState* state);
+void turnOff(const mxArray* socketInfo, mglSocketCoalesceState* state);
+
+//////////////
+//   main   //
+//////////////
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
+
+    // Check for expected usage.
+    if (nrhs < 1 || nrhs > 2 || !mxIsStruct(prhs[0])) {
+        mxArray *callInput[] = { mxCreateString("mglSocketCoalesce") };
+        mexCallMATLAB(0, NULL, 1, callInput, "help");
+        plhs[0] = mxCreateDoubleMatrix(0, 0, mxREAL);
+        if (nlhs > 1) {
+            plhs[1] = mxCreateNumericMatrix(0, 1, mxUINT8_CLASS, mxREAL);
+        }
+        return;
+    }
+
+    int verbose = (int)mglGetGlobalDouble("verbose");
+    mglSocketCoalesceState* state = mglSocketCoalesceGetState();
+    size_t socketCount = mxGetM(prhs[0]) * mxGetN(prhs[0]);
+    int coalesce = (nrhs == 2) ? (int)mxGetScalar(prhs[1]) : -1;
+
+    // Coalesced replies are read without fan-out timeouts or skipping (see mglSocketFanOut.h).
+    if ((coalesce == 1) && ((state == NULL) || !state->coalescing) && mglSocketFanOutHasTimeouts(mglSocketFanOutGetState())) {
+        mexErrMsgTxt("(mglSocketCoalesce) Can not coalesce commands while mglSocketFanOut has timeouts or late replies to skip. Set timeouts to Inf first.");
+    }
+
+    // Turn coalescing or recording on by making the shared state.
+    if ((coalesce > 0) && (state == NULL)) {
+        state = (mglSocketCoalesceState*)calloc(1, sizeof(mglSocketCoalesceState));
+        if (state == NULL) {
+            mexPrintf("(mglSocketCoalesce) Could not allocate memory to coalesce commands.\n");
+            plhs[0] = mxCreateDoubleMatrix(0, 0, mxREAL);
+            if (nlhs > 1) {
+                plhs[1] = mxCreateNumericMatrix(0, 1, mxUINT8_CLASS, mxREAL);
+            }
+            return;
+        }
+        int i;
+        for (i = 0; i < MGL_SOCKET_COALESCE_MAX_SOCKETS; i++) {
+            state->sockets[i].socketDescriptor = -1;
+        }
+        mxArray* statePointer = mxCreateNumericMatrix(1, 1, mxUINT64_CLASS, mxREAL);
+        *(uint64_t*)mxGetData(statePointer) = (uint64_t)(uintptr_t)state;
+        mexPutVariable("global", MGL_SOCKET_COALESCE_VARIABLE, statePointer);
+        mxDestroyArray(statePointer);
+    }
+    if ((coalesce == 1) && !state->coalescing) {
+        state->coalescing = 1;
+        if (verbose) {
+            mexPrintf("(mglSocketCoalesce) Coalescing drawing commands.\n");
+        }
+    }
+
+    // Record the sockets, which makes entries for them even though nothing is written to them yet.
+    if (coalesce == 2) {
+        int index;
+        for (index = 0; index < socketCount; index++) {
+            mxArray* field = mxGetField(prhs[0], index, "connectionSocketDescriptor");
+            if ((field == NULL) || ((int)mxGetScalar(field) < 0)) continue;
+            mglSocketCoalesceSocket* socket = mglSocketCoalesceGetSocket(state, (int)mxGetScalar(field), 1);
+            if (socket == NULL) {
+                mexPrintf("(mglSocketCoalesce) Can not record more than %d sockets.\n", MGL_SOCKET_COALESCE_MAX_SOCKETS);
+                continue;
+            }
+            socket->recording = 1;
+            if (verbose) {
+                mexPrintf("(mglSocketCoalesce) Recording commands for connectionSocketDescriptor %d.\n", socket->socketDescriptor);
+            }
+        }
+    }
+
+    // Send anything still held, so that its results can be returned.
+    if (state != NULL) {
+        int index;
+        for (index = 0; index < socketCount; index++) {
+            mxArray* field = mxGetField(prhs[0], index, "connectionSocketDescriptor");
+            if (field == NULL) continue;
+            mglSocketCoalesceSocket* socket = mglSocketCoalesceGetSocket(state, (int)mxGetScalar(field), 0);
+            if ((socket == NULL) || socket->recording) continue;
+            if (socket->bufferBytes > 0) {
+                mglSocketCoalesceSend(socket);
+            }
+            mglSocketCoalesceReadReplies(socket);
+        }
+    }
+
+    // Return results for everything coalesced since the last call, and what was recorded.
+    plhs[0] = takeResults(prhs[0], state);
+    if (nlhs > 1) {
+        plhs[1] = takeRecorded(prhs[0], state);
+    }
+
+    if ((coalesce == 0) && (state != NULL)) {
+        turnOff(prhs[0], state);
+        if (verbose) {
+            mexPrintf("(mglSocketCoalesce) Not coalescing or recording commands for these sockets.\n");
+        }
+    }
+}
+
+/////////////////
+//   turnOff   //
+/////////////////
+// Stop recording the sockets in socketInfo, or if none of them are recorded, stop coalescing
+// for all sockets. The shared state is freed once it is neither coalescing nor recording.
+void turnOff(const mxArray* socketInfo, mglSocketCoalesceState* state) {
+    size_t socketCount = mxGetM(socketInfo) * mxGetN(socketInfo);
+    int endsRecording = 0;
+    int index;
+    for (index = 0; index < socketCount; index++) {
+        mxArray* field = mxGetField(socketInfo, index, "connectionSocketDescriptor");
+        if (field == NULL) continue;
+        mglSocketCoalesceSocket* socket = mglSocketCoalesceGetSocket(state, (int)mxGetScalar(field), 0);
+        if ((socket != NULL) && socket->recording) {
+            mglSocketCoalesceFreeSocket(socket);
+            endsRecording = 1;
+        }
+    }
+    int socketsLeft = 0;
+    int i;
+    for (i = 0; i < MGL_SOCKET_COALESCE_MAX_SOCKETS; i++) {
+        if (state->sockets[i].socketDescriptor < 0) continue;
+        if (!endsRecording && !state->sockets[i].recording) {
+            mglSocketCoalesceFreeSocket(&state->sockets[i]);
+        } else {
+            socketsLeft = 1;
+        }
+    }
+    if (!endsRecording) {
+        state->coalescing = 0;
+    }
+    if (state->coalescing || socketsLeft) return;
+    free(state);
+    mxArray* empty = mxCreateDoubleMatrix(0, 0, mxREAL);
+    mexPutVariable("global", MGL_SOCKET_COALESCE_VARIABLE, empty);
+    mxDestroyArray(empty);
+}
+
+//////////////////////
+//   takeRecorded   //
+//////////////////////
+// Return the bytes recorded for the first socket in socketInfo as a uint8 column, and forget them.
+mxArray* takeRecorded(const mxArray* socketInfo, mglSocketCoalesceState* state) {
+    mglSocketCoalesceSocket* socket = NULL;
+    if ((state != NULL) && (mxGetM(socketInfo) * mxGetN(socketInfo) > 0)) {
+        mxArray* field = mxGetField(socketInfo, 0, "connectionSocketDescriptor");
+        if (field != NULL) {
+            socket = mglSocketCoalesceGetSocket(state, (int)mxGetScalar(field), 0);
+        }
+    }
+    if ((socket == NULL) || !socket->recording) {
+        return mxCreateNumericMatrix(0, 1, mxUINT8_CLASS, mxREAL);
+    }
+    mxArray* recorded = mxCreateNumericMatrix(socket->bufferBytes, 1, mxUINT8_CLASS, mxREAL);
+    memcpy(mxGetData(recorded), socket->buffer, socket->bufferBytes);
+    socket->bufferBytes = 0;
+    socket->holding = 0;
+    return recorded;
+}
+
+/////////////////////
+//   takeResults   //
+/////////////////////
+// Make a struct array of results, with one row per command and one column per socket,
+// with the same fields as mglReadCommandResults, and forget them.
+mxArray* takeResults(const mxArray* socketInfo, mglSocketCoalesceState* state) {
+    const char* fieldNames[] = {"commandCode", "success", "ackTime", "setupTime", "processedTime", "vertexStart", "vertexEnd", "fragmentStart", "fragmentEnd", "drawableAcquired", "drawablePresented"};
+    size_t socketCount = mxGetM(socketInfo) * mxGetN(socketInfo);
+
+    // find what is held for each socket, and the most results any has
+    mglSocketCoalesceSocket* sockets[socketCount > 0 ? socketCount : 1];
+    size_t commandCount = 0;
+    int index;
+    for (index = 0; index < socketCount; index++) {
+        sockets[index] = NULL;
+        mxArray* field = mxGetField(socketInfo, index, "connectionSocketDescriptor");
+        if ((state == NULL) || (field == NULL)) continue;
+        sockets[index] = mglSocketCoalesceGetSocket(state, (int)mxGetScalar(field), 0);
+        if ((sockets[index] != NULL) && (sockets[index]->resultCount > commandCount)) {
+            commandCount = sockets[index]->resultCount;
+        }
+    }
+
+    mxArray* results = mxCreateStructMatrix(commandCount, socketCount, 11, fieldNames);
+    for (index = 0; index < socketCount; index++) {
+        if (sockets[index] == NULL) continue;
+        int commandIndex;
+        for (commandIndex = 0; commandIndex < sockets[index]->resultCount; commandIndex++) {
+            mglSocketCoalesceResult* result = &sockets[index]->results[commandIndex];
+            mwIndex resultIndex = index * commandCount + commandIndex;
+            mxArray* commandCode = mxCreateNumericMatrix(1, 1, mxUINT16_CLASS, mxREAL);
+            *(mglCommandCode*)mxGetData(commandCode) = result->commandCode;
+            mxArray* success = mxCreateNumericMatrix(1, 1, mxUINT32_CLASS, mxREAL);
+            *(mglUInt32*)mxGetData(success) = result->success;
+            mxSetFieldByNumber(results, resultIndex, 0, commandCode);
+            mxSetFieldByNumber(results, resultIndex, 1, success);
+            mxSetFieldByNumber(results, resultIndex, 2, mxCreateDoubleScalar(result->ackTime));
+            mxSetFieldByNumber(results, resultIndex, 3, mxCreateDoubleScalar(0));
+            int timestampIndex;
+            for (timestampIndex = 0; timestampIndex < 7; timestampIndex++) {
+                mxSetFieldByNumber(results, resultIndex, 4 + timestampIndex, mxCreateDoubleScalar(result->timestamps[timestampIndex]));
+            }
+        }
+        sockets[index]->resultCount = 0;
+    }
+    return results;
+}
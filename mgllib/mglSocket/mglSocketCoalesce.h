@@ -0,0 +1,331 @@
+#ifdef documentation
+=========================================================================
+
+  program: mglSocketCoalesce.h
+       by: justin gardner
+     date: 10/19/2026
+copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+  purpose: shared by mglSocketWrite, mglSocketRead, mglSocketClose and
+           mglSocketCoalesce to hold drawing commands on the client side
+           and send them to mglMetal all together at mglFlush.
+
+           Normally each drawing function writes its command and then
+           blocks reading an ack and results, so each command costs a
+           round trip. When coalescing is turned on (mglSocketCoalesce),
+           drawing commands (ones that have no query results and draw
+           into one frame) are appended to a buffer instead of sent, and
+           reads for them return placeholder values right away (ack of 0,
+           the command code, success of 1, and 0 timestamps). At mglFlush,
+           or at any other command that needs a real answer, the buffer is
+           sent in one write, and the real acks and results for the held
+           commands are read and kept, so that mglSocketCoalesce can
+           return them as a struct array, one element per command.
+
+           Each mex function is its own shared library, so they cannot
+           share static variables. The state lives in malloced memory,
+           and its address is kept in the Matlab global variable
+           mglSocketCoalesceState, which only mglSocketCoalesce sets.
+
+           A socket can also be recorded instead (mglSocketCoalesce with
+           2), which holds every command and never sends anything, so
+           that mglRasterize can draw the stream on the CPU. Reads for
+           recorded commands all get placeholders, except that the
+           texture number and count that mglMetalCreateTexture reads are
+           the number of textures made so far, as mglMetal would number
+           them. The socket does not need to be connected to anything.
+
+=========================================================================
+#endif
+
+#ifndef MGL_SOCKET_COALESCE_H
+#define MGL_SOCKET_COALESCE_H
+
+/////////////////////////
+//   include section   //
+/////////////////////////
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+
+//////////////////////
+//   define section //
+//////////////////////
+#define MGL_SOCKET_COALESCE_VARIABLE "mglSocketCoalesceState"
+#define MGL_SOCKET_COALESCE_MAX_SOCKETS 16
+
+// mglMetal sends an ack timestamp when it reads each command, then a results record
+// when it is done with the command: command code, status, and 7 timestamps.
+#define MGL_SOCKET_COALESCE_REPLY_BYTES (sizeof(mglDouble) + sizeof(mglCommandCode) + sizeof(mglUInt32) + 7 * sizeof(mglDouble))
+
+// real results for one held command
+typedef struct {
+  mglDouble ackTime;
+  mglCommandCode commandCode;
+  mglUInt32 success;
+  mglDouble timestamps[7];
+} mglSocketCoalesceResult;
+
+// what is held for one socket
+typedef struct {
+  int socketDescriptor;
+  // whether the command being written now is held, so reads for it get placeholders
+  int holding;
+  mglCommandCode holdingCode;
+  // whether everything is held and never sent, how many textures that made, and uint32 placeholders read
+  int recording;
+  uint32_t recordedTextures;
+  uint32_t placeholderReads;
+  // bytes of held commands, not yet sent
+  char *buffer;
+  size_t bufferBytes;
+  size_t bufferCapacity;
+  // how many held commands are in the buffer, and how many were sent but not yet replied to
+  uint32_t heldCount;
+  uint32_t unreadCount;
+  // real results read back for held commands
+  mglSocketCoalesceResult *results;
+  uint32_t resultCount;
+  uint32_t resultCapacity;
+} mglSocketCoalesceSocket;
+
+typedef struct {
+  // whether writes to sockets not yet seen are coalesced, as opposed to only recorded sockets
+  int coalescing;
+  mglSocketCoalesceSocket sockets[MGL_SOCKET_COALESCE_MAX_SOCKETS];
+} mglSocketCoalesceState;
+
+////////////////////////////////
+//   mglSocketCoalesceCanHold //
+////////////////////////////////
+// Commands that can be held are ones that mglMetal answers with just an ack and a results
+// record, with no query results, and that don't repeat across frames.
+static inline int mglSocketCoalesceCanHold(mglCommandCode commandCode)
+{
+  switch (commandCode) {
+    case mglBltTexture:
+    case mglSetXform:
+    case mglDots:
+    case mglLine:
+    case mglQuad:
+    case mglPolygon:
+    case mglArcs:
+    case mglUpdateTexture:
+    case mglSelectStencil:
+    case mglSetClearColor:
+    case mglInstancedLines:
+    case mglProceduralGratings:
+    case mglBltSprites:
+    case mglFrameStreamShowFrame:
+    case mglDrawGeometry:
+    case mglCallDisplayList:
+    case mglUpdateGeometry:
+      return 1;
+    default:
+      return 0;
+  }
+}
+
+/////////////////////////////////
+//   mglSocketCoalesceGetState //
+/////////////////////////////////
+// Returns NULL when coalescing is off, which is the usual case.
+static inline mglSocketCoalesceState *mglSocketCoalesceGetState(void)
+{
+  const mxArray *statePointer = mexGetVariablePtr("global", MGL_SOCKET_COALESCE_VARIABLE);
+  if ((statePointer == NULL) || !mxIsClass(statePointer, "uint64") || (mxGetNumberOfElements(statePointer) != 1))
+    return NULL;
+  return (mglSocketCoalesceState *)(uintptr_t)(*(uint64_t *)mxGetData(statePointer));
+}
+
+//////////////////////////////////
+//   mglSocketCoalesceGetSocket //
+//////////////////////////////////
+// Find what is held for a socket, optionally making a new entry for it.
+static inline mglSocketCoalesceSocket *mglSocketCoalesceGetSocket(mglSocketCoalesceState *state, int socketDescriptor, int create)
+{
+  if (state == NULL) return NULL;
+  mglSocketCoalesceSocket *emptySocket = NULL;
+  for (int i = 0; i < MGL_SOCKET_COALESCE_MAX_SOCKETS; i++) {
+    if (state->sockets[i].socketDescriptor == socketDescriptor)
+      return &state->sockets[i];
+    if ((emptySocket == NULL) && (state->sockets[i].socketDescriptor < 0))
+      emptySocket = &state->sockets[i];
+  }
+  if (!create || (emptySocket == NULL)) return NULL;
+  memset(emptySocket, 0, sizeof(mglSocketCoalesceSocket));
+  emptySocket->socketDescriptor = socketDescriptor;
+  return emptySocket;
+}
+
+///////////////////////////////////
+//   mglSocketCoalesceFreeSocket //
+///////////////////////////////////
+static inline void mglSocketCoalesceFreeSocket(mglSocketCoalesceSocket *socket)
+{
+  free(socket->buffer);
+  free(socket->results);
+  memset(socket, 0, sizeof(mglSocketCoalesceSocket));
+  socket->socketDescriptor = -1;
+}
+
+///////////////////////////
+//   mglSocketSendAll   //
+///////////////////////////
+// Send all the bytes, as mglSocketWrite does, returning how many were sent.
+static inline size_t mglSocketSendAll(int socketDescriptor, const void *dataBytes, size_t numBytes)
+{
+  size_t totalSent = 0;
+  while (totalSent < numBytes) {
+    ssize_t sent = send(socketDescriptor, (const char *)dataBytes + totalSent, numBytes - totalSent, 0);
+    if (sent < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK)
+        continue;
+      else
+        break;
+    }
+    totalSent += sent;
+  }
+  return totalSent;
+}
+
+//////////////////////////////
+//   mglSocketCoalesceAppend //
+//////////////////////////////
+static inline int mglSocketCoalesceAppend(mglSocketCoalesceSocket *socket, const void *dataBytes, size_t numBytes)
+{
+  if (socket->bufferBytes + numBytes > socket->bufferCapacity) {
+    size_t newCapacity = socket->bufferCapacity ? socket->bufferCapacity : 65536;
+    while (newCapacity < socket->bufferBytes + numBytes) newCapacity *= 2;
+    char *newBuffer = realloc(socket->buffer, newCapacity);
+    if (newBuffer == NULL) return 0;
+    socket->buffer = newBuffer;
+    socket->bufferCapacity = newCapacity;
+  }
+  memcpy(socket->buffer + socket->bufferBytes, dataBytes, numBytes);
+  socket->bufferBytes += numBytes;
+  return 1;
+}
+
+////////////////////////////
+//   mglSocketCoalesceSend //
+////////////////////////////
+// Send whatever is held in one write. The held commands' replies are read later, before the next real read.
+static inline int mglSocketCoalesceSend(mglSocketCoalesceSocket *socket)
+{
+  size_t sent = mglSocketSendAll(socket->socketDescriptor, socket->buffer, socket->bufferBytes);
+  int success = (sent == socket->bufferBytes);
+  socket->bufferBytes = 0;
+  socket->unreadCount += socket->heldCount;
+  socket->heldCount = 0;
+  socket->holding = 0;
+  return success;
+}
+
+/////////////////////////////
+//   mglSocketCoalesceWrite //
+/////////////////////////////
+// Called by mglSocketWrite for each socket. Returns the number of bytes taken care of, or -1 if
+// the write has nothing to do with held commands and should just be sent as usual.
+static inline double mglSocketCoalesceWrite(mglSocketCoalesceSocket *socket, const void *dataBytes, size_t numBytes, int isCommandCode)
+{
+  if (socket == NULL) return -1;
+
+  // recorded sockets keep everything, and number textures as mglMetal would
+  if (socket->recording) {
+    if (!mglSocketCoalesceAppend(socket, dataBytes, numBytes)) return 0;
+    if (isCommandCode) {
+      socket->holding = 1;
+      socket->holdingCode = *(const mglCommandCode *)dataBytes;
+      socket->placeholderReads = 0;
+      if (socket->holdingCode == mglCreateTexture) socket->recordedTextures++;
+    }
+    return numBytes;
+  }
+
+  if (isCommandCode) {
+    mglCommandCode commandCode = *(const mglCommandCode *)dataBytes;
+    if (!mglSocketCoalesceAppend(socket, dataBytes, numBytes)) return 0;
+    if (mglSocketCoalesceCanHold(commandCode)) {
+      // hold this command, and give placeholders for its ack and results
+      socket->holding = 1;
+      socket->holdingCode = commandCode;
+      socket->heldCount++;
+      return numBytes;
+    }
+    // anything else, including mglFlush, needs a real answer, so send everything now
+    return mglSocketCoalesceSend(socket) ? numBytes : 0;
+  }
+
+  // data that goes with a held command is held too
+  if (socket->holding)
+    return mglSocketCoalesceAppend(socket, dataBytes, numBytes) ? numBytes : 0;
+
+  return -1;
+}
+
+///////////////////////////////////
+//   mglSocketCoalesceReadReplies //
+///////////////////////////////////
+// Read the real acks and results for commands that were held and then sent, and keep them.
+static inline int mglSocketCoalesceReadReplies(mglSocketCoalesceSocket *socket)
+{
+  while (socket->unreadCount > 0) {
+    char reply[MGL_SOCKET_COALESCE_REPLY_BYTES];
+    ssize_t readBytes = recv(socket->socketDescriptor, reply, sizeof(reply), MSG_WAITALL);
+    if (readBytes < (ssize_t)sizeof(reply)) {
+      socket->unreadCount = 0;
+      return 0;
+    }
+    if (socket->resultCount == socket->resultCapacity) {
+      uint32_t newCapacity = socket->resultCapacity ? 2 * socket->resultCapacity : 256;
+      mglSocketCoalesceResult *newResults = realloc(socket->results, newCapacity * sizeof(mglSocketCoalesceResult));
+      if (newResults == NULL) return 0;
+      socket->results = newResults;
+      socket->resultCapacity = newCapacity;
+    }
+    mglSocketCoalesceResult *result = &socket->results[socket->resultCount++];
+    char *replyPointer = reply;
+    memcpy(&result->ackTime, replyPointer, sizeof(mglDouble)); replyPointer += sizeof(mglDouble);
+    memcpy(&result->commandCode, replyPointer, sizeof(mglCommandCode)); replyPointer += sizeof(mglCommandCode);
+    memcpy(&result->success, replyPointer, sizeof(mglUInt32)); replyPointer += sizeof(mglUInt32);
+    memcpy(result->timestamps, replyPointer, 7 * sizeof(mglDouble));
+    socket->unreadCount--;
+  }
+  return 1;
+}
+
+////////////////////////////
+//   mglSocketCoalesceRead //
+////////////////////////////
+// Called by mglSocketRead for each socket. Returns the number of bytes filled in with placeholders,
+// or -1 if the read should come from the socket as usual (after any held replies have been read).
+static inline double mglSocketCoalesceRead(mglSocketCoalesceSocket *socket, void *dataBytes, size_t numBytes, mxClassID classID)
+{
+  if (socket == NULL) return -1;
+
+  if (socket->holding || socket->recording) {
+    // placeholders: the command code, success, and zeros for timestamps
+    if (classID == mxUINT16_CLASS) {
+      for (size_t i = 0; i < numBytes / sizeof(mglCommandCode); i++)
+        ((mglCommandCode *)dataBytes)[i] = socket->holdingCode;
+    }
+    else if (classID == mxUINT32_CLASS) {
+      for (size_t i = 0; i < numBytes / sizeof(mglUInt32); i++) {
+        // the texture number and count of a recorded mglCreateTexture come before its success
+        int isTextureCount = socket->recording && (socket->holdingCode == mglCreateTexture) && (socket->placeholderReads < 2);
+        ((mglUInt32 *)dataBytes)[i] = isTextureCount ? socket->recordedTextures : 1;
+        socket->placeholderReads++;
+      }
+    }
+    else
+      memset(dataBytes, 0, numBytes);
+    return numBytes;
+  }
+
+  mglSocketCoalesceReadReplies(socket);
+  return -1;
+}
+
+#endif
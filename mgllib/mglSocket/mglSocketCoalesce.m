@@ -0,0 +1,58 @@
+% mglSocketCoalesce: Hold drawing commands and send them together.
+%
+%      usage: [results, recorded] = mglSocketCoalesce(s, <coalesce>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: Turns on or off coalescing of drawing commands written with
+%             mglSocketWrite, and returns the results of commands that
+%             were coalesced.
+%
+%             Normally each drawing function writes its command to
+%             mglMetal and then waits to read an ack and results, so each
+%             command costs a round trip. When coalescing is on, drawing
+%             commands that have no query results (like mglClearScreen,
+%             mglQuad, mglMetalDots, mglMetalBltTexture) are held in a
+%             buffer instead of sent, and mglSocketRead returns
+%             placeholders for them right away (ackTime 0, the command
+%             code, success 1 and timestamps of 0). The next command that
+%             needs a real answer, usually mglFlush, sends everything that
+%             is held in one write. The real acks and results for the held
+%             commands are read and kept until this function is called.
+%
+%      usage: [results, recorded] = mglSocketCoalesce(s, <coalesce>)
+%             s -- a socket info struct returned from
+%                  mglSocketCreateClient(), or a struct array of these.
+%             coalesce -- 1 to turn coalescing on, 0 to turn it off. 2 to
+%                  record the sockets in s instead. Leave out to leave it
+%                  as it is.
+%
+%             Sends anything still held, then returns the results of the
+%             coalesced commands as a struct array with the same fields as
+%             mglReadCommandResults, of size [commandCount, numel(s)], and
+%             forgets them.
+%
+%             Recording holds every command written to the sockets in s
+%             and never sends anything, so s does not have to be
+%             connected. Reads get placeholders, with texture numbers
+%             counting up from 1 for mglMetalCreateTexture. recorded is
+%             the bytes written to s(1) since the last call, as a uint8
+%             column, which mglRasterize draws on the CPU. Turning off
+%             (0) stops recording the sockets in s, or if they are not
+%             being recorded, stops coalescing.
+%
+%             Coalescing can not be turned on while mglSocketFanOut has
+%             timeouts set, or late reply bytes still to skip, since
+%             coalesced replies are read without them.
+%
+%             Do not use with mglMetalStartBatch, which has its own way
+%             of giving placeholders. mglSocketDataWaiting does not know
+%             about held commands.
+%
+%             mglOpen;
+%             mglSocketCoalesce(mgl.activeSockets, 1);
+%             mglClearScreen([1 0 0]);
+%             mglQuad([-1 1 1 -1]',[-1 -1 1 1]',[0 0 1]');
+%             mglFlush;
+%             results = mglSocketCoalesce(mgl.activeSockets, 0)
+%
@@ -0,0 +1,143 @@
+#ifdef documentation
+=========================================================================
+
+  program: mglSocketFanOut.c
+       by: justin gardner
+     date: 10/19/2026
+copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+  purpose: mex function to turn on or off writing to and reading from
+           several sockets at once (see mglSocketFanOut.h), set read
+           timeouts for each socket, and get back statistics of how long
+           each socket took
+    usage: stats = mglSocketFanOut(s, <fanOut>, <timeouts>)
+
+=========================================================================
+#endif
+
+/////////////////////////
+//   include section   //
+/////////////////////////
+#include "mgl.h"
+#include "mglCommandTypes.h"
+#include "mglSocketCoalesce.h"
+#include "mglSocketFanOut.h"
+#include <sys/socket.h>
+
+mxArray* makeStats(const mxArray* socketInfo, mglSocketFanOutState* state);
+
+//////////////
+//   main   //
+//////////////
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
+
+    // Check for expected usage.
+    if (nrhs < 1 || nrhs > 3 || !mxIsStruct(prhs[0])) {
+        mxArray *callInput[] = { mxCreateString("mglSocketFanOut") };
+        mexCallMATLAB(0, NULL, 1, callInput, "help");
+        plhs[0] = mxCreateDoubleMatrix(0, 0, mxREAL);
+        return;
+    }
+
+    int verbose = (int)mglGetGlobalDouble("verbose");
+    mglSocketFanOutState* state = mglSocketFanOutGetState();
+    size_t socketCount = mxGetM(prhs[0]) * mxGetN(prhs[0]);
+
+    // Coalesced replies are read without timeouts (see mglSocketFanOut.h), so refuse to set any.
+    mglSocketCoalesceState* coalesceState = mglSocketCoalesceGetState();
+    if ((nrhs == 3) && (coalesceState != NULL) && coalesceState->coalescing && mxIsDouble(prhs[2])) {
+        size_t timeoutIndex;
+        for (timeoutIndex = 0; timeoutIndex < mxGetNumberOfElements(prhs[2]); timeoutIndex++) {
+            double timeout = mxGetPr(prhs[2])[timeoutIndex];
+            if (isfinite(timeout) && (timeout > 0)) {
+                mexErrMsgTxt("(mglSocketFanOut) Can not set timeouts while coalescing commands. Turn off mglSocketCoalesce first.");
+            }
+        }
+    }
+
+    // Turn fan-out on by making the shared state.
+    if ((nrhs >= 2) && !mxIsEmpty(prhs[1]) && (mxGetScalar(prhs[1]) != 0) && (state == NULL)) {
+        state = (mglSocketFanOutState*)calloc(1, sizeof(mglSocketFanOutState));
+        if (state == NULL) {
+            mexPrintf("(mglSocketFanOut) Could not allocate memory for fan-out.\n");
+            plhs[0] = mxCreateDoubleMatrix(0, 0, mxREAL);
+            return;
+        }
+        int i;
+        for (i = 0; i < MGL_SOCKET_FAN_OUT_MAX_SOCKETS; i++) {
+            state->sockets[i].socketDescriptor = -1;
+        }
+        mxArray* statePointer = mxCreateNumericMatrix(1, 1, mxUINT64_CLASS, mxREAL);
+        *(uint64_t*)mxGetData(statePointer) = (uint64_t)(uintptr_t)state;
+        mexPutVariable("global", MGL_SOCKET_FAN_OUT_VARIABLE, statePointer);
+        mxDestroyArray(statePointer);
+        if (verbose) {
+            mexPrintf("(mglSocketFanOut) Writing to and reading from sockets at once.\n");
+        }
+    }
+
+    // Set the read timeout for each socket, from a scalar for all or one for each.
+    if ((nrhs == 3) && (state != NULL) && mxIsDouble(prhs[2]) && !mxIsEmpty(prhs[2])) {
+        size_t timeoutCount = mxGetNumberOfElements(prhs[2]);
+        double* timeouts = mxGetPr(prhs[2]);
+        int index;
+        for (index = 0; index < socketCount; index++) {
+            mxArray* field = mxGetField(prhs[0], index, "connectionSocketDescriptor");
+            if ((field == NULL) || (mxGetScalar(field) < 0)) continue;
+            mglSocketFanOutSocket* socket = mglSocketFanOutGetSocket(state, (int)mxGetScalar(field), 1);
+            if (socket == NULL) {
+                mexPrintf("(mglSocketFanOut) Can only fan out to %d sockets.\n", MGL_SOCKET_FAN_OUT_MAX_SOCKETS);
+                continue;
+            }
+            double timeout = timeouts[(timeoutCount == 1) ? 0 : ((index < timeoutCount) ? index : timeoutCount - 1)];
+            // Inf, 0 or negative all mean wait as long as it takes
+            socket->timeout = (isfinite(timeout) && (timeout > 0)) ? timeout : 0;
+        }
+    }
+
+    // Return statistics for each socket.
+    plhs[0] = makeStats(prhs[0], state);
+
+    // Turn fan-out off by freeing the shared state.
+    if ((nrhs >= 2) && !mxIsEmpty(prhs[1]) && (mxGetScalar(prhs[1]) == 0) && (state != NULL)) {
+        free(state);
+        mxArray* empty = mxCreateDoubleMatrix(0, 0, mxREAL);
+        mexPutVariable("global", MGL_SOCKET_FAN_OUT_VARIABLE, empty);
+        mxDestroyArray(empty);
+        if (verbose) {
+            mexPrintf("(mglSocketFanOut) Writing to and reading from sockets one at a time.\n");
+        }
+    }
+}
+
+///////////////////
+//   makeStats   //
+///////////////////
+// Make a struct array with the settings and statistics of each socket, with waits in seconds.
+mxArray* makeStats(const mxArray* socketInfo, mglSocketFanOutState* state) {
+    const char* fieldNames[] = {"connectionSocketDescriptor", "timeout", "readCount", "timeoutCount", "meanReadWait", "maxReadWait", "lastReadWait", "writeCount", "meanWriteWait", "maxWriteWait", "bytesSkipped", "bytesToSkip"};
+    size_t m = mxGetM(socketInfo);
+    size_t n = mxGetN(socketInfo);
+    mxArray* stats = mxCreateStructMatrix(m, n, 12, fieldNames);
+    int index;
+    for (index = 0; index < m * n; index++) {
+        mxArray* field = mxGetField(socketInfo, index, "connectionSocketDescriptor");
+        int socketDescriptor = (field == NULL) ? -1 : (int)mxGetScalar(field);
+        mglSocketFanOutSocket emptySocket;
+        memset(&emptySocket, 0, sizeof(emptySocket));
+        mglSocketFanOutSocket* socket = (socketDescriptor < 0) ? NULL : mglSocketFanOutGetSocket(state, socketDescriptor, 0);
+        if (socket == NULL) socket = &emptySocket;
+        mxSetField(stats, index, "connectionSocketDescriptor", mxCreateDoubleScalar(socketDescriptor));
+        mxSetField(stats, index, "timeout", mxCreateDoubleScalar((socket->timeout > 0) ? socket->timeout : mxGetInf()));
+        mxSetField(stats, index, "readCount", mxCreateDoubleScalar(socket->readCount));
+        mxSetField(stats, index, "timeoutCount", mxCreateDoubleScalar(socket->timeoutCount));
+        mxSetField(stats, index, "meanReadWait", mxCreateDoubleScalar(socket->readCount ? socket->sumReadWait / socket->readCount : 0));
+        mxSetField(stats, index, "maxReadWait", mxCreateDoubleScalar(socket->maxReadWait));
+        mxSetField(stats, index, "lastReadWait", mxCreateDoubleScalar(socket->lastReadWait));
+        mxSetField(stats, index, "writeCount", mxCreateDoubleScalar(socket->writeCount));
+        mxSetField(stats, index, "meanWriteWait", mxCreateDoubleScalar(socket->writeCount ? socket->sumWriteWait / socket->writeCount : 0));
+        mxSetField(stats, index, "maxWriteWait", mxCreateDoubleScalar(socket->maxWriteWait));
+        mxSetField(stats, index, "bytesSkipped", mxCreateDoubleScalar(socket->bytesSkipped));
+        mxSetField(stats, index, "bytesToSkip", mxCreateDoubleScalar(socket->skipBytes));
+    }
+    return stats;
+}
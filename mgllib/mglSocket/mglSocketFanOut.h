@@ -0,0 +1,305 @@
+#ifdef documentation
+=========================================================================
+
+  program: mglSocketFanOut.h
+       by: justin gardner
+     date: 10/19/2026
+copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+  purpose: shared by mglSocketWrite, mglSocketRead, mglSocketClose and
+           mglSocketFanOut to write to and read from several sockets at
+           once, as when drawing to a primary window and its mirrors
+           (mglMirrorOpen).
+
+           Normally mglSocketWrite sends to each socket in turn, and
+           mglSocketRead waits for all of the reply from each socket in
+           turn, so the ack from the primary window waits behind any
+           mirror that is slow. When fan-out is turned on
+           (mglSocketFanOut), writes go out without blocking to all the
+           sockets, and replies are read with poll, from whichever socket
+           has data, until all have arrived.
+
+           Each socket can have a timeout for reads. If a reply does not
+           arrive in time, its data is returned as zeros, and the bytes
+           still to come are remembered and skipped when they do arrive,
+           so that the next reply lines up again. Writes have no timeout,
+           since a command that is only partly written would leave the
+           socket out of step.
+
+           For each socket, it keeps how long reads and writes waited, and
+           how many reads timed out, which mglSocketFanOut returns.
+
+           Commands held by mglSocketCoalesce are sent and their replies
+           read one socket at a time, without timeouts or skipping, so
+           mglSocketFanOut will not set timeouts while coalescing, and
+           mglSocketCoalesce will not start coalescing while any socket
+           has a timeout or late bytes to skip.
+
+           Each mex function is its own shared library, so they cannot
+           share static variables. The state lives in malloced memory,
+           and its address is kept in the Matlab global variable
+           mglSocketFanOutState, which only mglSocketFanOut sets.
+
+=========================================================================
+#endif
+
+#ifndef MGL_SOCKET_FAN_OUT_H
+#define MGL_SOCKET_FAN_OUT_H
+
+/////////////////////////
+//   include section   //
+/////////////////////////
+#include <errno.h>
+#include <math.h>
+#include <poll.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+
+//////////////////////
+//   define section //
+//////////////////////
+#define MGL_SOCKET_FAN_OUT_VARIABLE "mglSocketFanOutState"
+#define MGL_SOCKET_FAN_OUT_MAX_SOCKETS 16
+
+// settings and statistics for one socket
+typedef struct {
+  int socketDescriptor;
+  // how long to wait for a reply in seconds, 0 to wait as long as it takes
+  double timeout;
+  // bytes of replies that timed out, still to come and to be skipped
+  size_t skipBytes;
+  // statistics, with waits in seconds from the start of the read or write
+  uint32_t readCount;
+  uint32_t timeoutCount;
+  uint32_t writeCount;
+  double sumReadWait;
+  double maxReadWait;
+  double lastReadWait;
+  double sumWriteWait;
+  double maxWriteWait;
+  double bytesSkipped;
+} mglSocketFanOutSocket;
+
+typedef struct {
+  mglSocketFanOutSocket sockets[MGL_SOCKET_FAN_OUT_MAX_SOCKETS];
+} mglSocketFanOutState;
+
+//////////////////////////
+//   mglSocketFanOutNow //
+//////////////////////////
+static inline double mglSocketFanOutNow(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + 1e-9 * (double)now.tv_nsec;
+}
+
+///////////////////////////////
+//   mglSocketFanOutGetState //
+///////////////////////////////
+// Returns NULL when fan-out is off, which is the usual case.
+static inline mglSocketFanOutState *mglSocketFanOutGetState(void)
+{
+  const mxArray *statePointer = mexGetVariablePtr("global", MGL_SOCKET_FAN_OUT_VARIABLE);
+  if ((statePointer == NULL) || !mxIsClass(statePointer, "uint64") || (mxGetNumberOfElements(statePointer) != 1))
+    return NULL;
+  return (mglSocketFanOutState *)(uintptr_t)(*(uint64_t *)mxGetData(statePointer));
+}
+
+////////////////////////////////
+//   mglSocketFanOutGetSocket //
+////////////////////////////////
+// Find the settings and statistics for a socket, optionally making a new entry for it.
+static inline mglSocketFanOutSocket *mglSocketFanOutGetSocket(mglSocketFanOutState *state, int socketDescriptor, int create)
+{
+  if (state == NULL) return NULL;
+  mglSocketFanOutSocket *emptySocket = NULL;
+  for (int i = 0; i < MGL_SOCKET_FAN_OUT_MAX_SOCKETS; i++) {
+    if (state->sockets[i].socketDescriptor == socketDescriptor)
+      return &state->sockets[i];
+    if ((emptySocket == NULL) && (state->sockets[i].socketDescriptor < 0))
+      emptySocket = &state->sockets[i];
+  }
+  if (!create || (emptySocket == NULL)) return NULL;
+  memset(emptySocket, 0, sizeof(mglSocketFanOutSocket));
+  emptySocket->socketDescriptor = socketDescriptor;
+  return emptySocket;
+}
+
+////////////////////////////////////
+//   mglSocketFanOutHasTimeouts   //
+////////////////////////////////////
+// Whether any socket has a read timeout, or late reply bytes still to skip. Coalesced commands
+// (mglSocketCoalesce.h) read their replies one socket at a time without either, so the two
+// can not be used together.
+static inline int mglSocketFanOutHasTimeouts(const mglSocketFanOutState *state)
+{
+  if (state == NULL) return 0;
+  for (int i = 0; i < MGL_SOCKET_FAN_OUT_MAX_SOCKETS; i++)
+    if ((state->sockets[i].socketDescriptor >= 0) && ((state->sockets[i].timeout > 0) || (state->sockets[i].skipBytes > 0)))
+      return 1;
+  return 0;
+}
+
+/////////////////////////////////
+//   mglSocketFanOutFreeSocket //
+/////////////////////////////////
+static inline void mglSocketFanOutFreeSocket(mglSocketFanOutSocket *socket)
+{
+  memset(socket, 0, sizeof(mglSocketFanOutSocket));
+  socket->socketDescriptor = -1;
+}
+
+///////////////////////////
+//   mglSocketFanOutSend //
+///////////////////////////
+// Send the same bytes to all the sockets, a little to each as it can take them, and wait until
+// all is sent. Fills in how many bytes went to each socket, less than numBytes on error.
+static inline void mglSocketFanOutSend(mglSocketFanOutSocket **sockets, size_t count, const void *dataBytes, size_t numBytes, double *sentBytes)
+{
+  double startTime = mglSocketFanOutNow();
+  size_t sent[count > 0 ? count : 1];
+  int done[count > 0 ? count : 1];
+  struct pollfd pollFds[count > 0 ? count : 1];
+  size_t pending = count;
+  for (size_t i = 0; i < count; i++) {
+    sent[i] = 0;
+    done[i] = 0;
+  }
+
+  while (pending > 0) {
+    // send as much as each socket will take without blocking
+    size_t pollCount = 0;
+    for (size_t i = 0; i < count; i++) {
+      if (done[i]) continue;
+      int failed = 0;
+      while (sent[i] < numBytes) {
+        ssize_t n = send(sockets[i]->socketDescriptor, (const char *)dataBytes + sent[i], numBytes - sent[i], MSG_DONTWAIT);
+        if (n > 0)
+          sent[i] += n;
+        else if ((n < 0) && (errno == EINTR))
+          continue;
+        else {
+          failed = !((n < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)));
+          break;
+        }
+      }
+      if (failed || (sent[i] == numBytes)) {
+        double wait = mglSocketFanOutNow() - startTime;
+        sockets[i]->writeCount++;
+        sockets[i]->sumWriteWait += wait;
+        if (wait > sockets[i]->maxWriteWait) sockets[i]->maxWriteWait = wait;
+        done[i] = 1;
+        pending--;
+      }
+      else {
+        pollFds[pollCount].fd = sockets[i]->socketDescriptor;
+        pollFds[pollCount].events = POLLOUT;
+        pollFds[pollCount].revents = 0;
+        pollCount++;
+      }
+    }
+    // wait until any of the rest can take more
+    if (pollCount > 0)
+      poll(pollFds, pollCount, -1);
+  }
+
+  for (size_t i = 0; i < count; i++)
+    sentBytes[i] = sent[i];
+}
+
+///////////////////////////
+//   mglSocketFanOutRecv //
+///////////////////////////
+// Read a reply of numBytes from each socket into its buffer, taking data from whichever socket
+// has it, until all have arrived or timed out. Replies that time out are set to zeros, and the
+// rest of them is skipped when it arrives. Fills in how many bytes were read for each socket,
+// which is numBytes when the reply arrived, and less on timeout or error.
+static inline void mglSocketFanOutRecv(mglSocketFanOutSocket **sockets, size_t count, char **buffers, size_t numBytes, double *readBytes)
+{
+  double startTime = mglSocketFanOutNow();
+  size_t got[count > 0 ? count : 1];
+  int done[count > 0 ? count : 1];
+  struct pollfd pollFds[count > 0 ? count : 1];
+  char skipBuffer[4096];
+  size_t pending = count;
+  for (size_t i = 0; i < count; i++) {
+    got[i] = 0;
+    done[i] = 0;
+  }
+
+  while (pending > 0) {
+    // take whatever has arrived on each socket, skipping what is left of earlier replies that timed out
+    size_t pollCount = 0;
+    double now = mglSocketFanOutNow();
+    double pollTimeout = -1;
+    for (size_t i = 0; i < count; i++) {
+      if (done[i]) continue;
+      mglSocketFanOutSocket *socket = sockets[i];
+      int failed = 0;
+      while (got[i] < numBytes) {
+        ssize_t n;
+        if (socket->skipBytes > 0) {
+          n = recv(socket->socketDescriptor, skipBuffer, (socket->skipBytes < sizeof(skipBuffer)) ? socket->skipBytes : sizeof(skipBuffer), MSG_DONTWAIT);
+          if (n > 0) {
+            socket->skipBytes -= n;
+            socket->bytesSkipped += n;
+            continue;
+          }
+        }
+        else {
+          n = recv(socket->socketDescriptor, buffers[i] + got[i], numBytes - got[i], MSG_DONTWAIT);
+          if (n > 0) {
+            got[i] += n;
+            continue;
+          }
+        }
+        if ((n < 0) && (errno == EINTR))
+          continue;
+        // 0 means the other end closed the socket
+        failed = !((n < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)));
+        break;
+      }
+
+      now = mglSocketFanOutNow();
+      if (failed || (got[i] == numBytes)) {
+        double wait = now - startTime;
+        socket->readCount++;
+        socket->sumReadWait += wait;
+        socket->lastReadWait = wait;
+        if (wait > socket->maxReadWait) socket->maxReadWait = wait;
+        done[i] = 1;
+        pending--;
+      }
+      else if ((socket->timeout > 0) && (now - startTime >= socket->timeout)) {
+        // give up on this reply for now, and line up with the next one
+        socket->skipBytes += numBytes - got[i];
+        socket->timeoutCount++;
+        memset(buffers[i], 0, numBytes);
+        done[i] = 1;
+        pending--;
+      }
+      else {
+        pollFds[pollCount].fd = socket->socketDescriptor;
+        pollFds[pollCount].events = POLLIN;
+        pollFds[pollCount].revents = 0;
+        pollCount++;
+        // wake up for the soonest timeout
+        if (socket->timeout > 0) {
+          double remaining = startTime + socket->timeout - now;
+          if ((pollTimeout < 0) || (remaining < pollTimeout)) pollTimeout = remaining;
+        }
+      }
+    }
+    // wait until any of the rest has data
+    if (pollCount > 0)
+      poll(pollFds, pollCount, (pollTimeout < 0) ? -1 : (int)ceil(1000 * pollTimeout));
+  }
+
+  for (size_t i = 0; i < count; i++)
+    readBytes[i] = got[i];
+}
+
+#endif
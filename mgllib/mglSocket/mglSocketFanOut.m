@@ -0,0 +1,49 @@
+% mglSocketFanOut: Write to and read from several sockets at once.
+%
+%      usage: stats = mglSocketFanOut(s, <fanOut>, <timeouts>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: Turns on or off fan-out for mglSocketWrite and
+%             mglSocketRead, sets read timeouts, and returns how long
+%             each socket has been taking.
+%
+%             Normally, given a struct array of sockets (like
+%             mgl.activeSockets with mirrored windows open), mglSocketWrite
+%             writes to each in turn, and mglSocketRead waits for the whole
+%             reply from each in turn, so a slow mirror holds up the reply
+%             from the primary window. When fan-out is on, writes go to all
+%             sockets without blocking, and replies are taken from
+%             whichever socket has data until all are in.
+%
+%      usage: stats = mglSocketFanOut(s, <fanOut>, <timeouts>)
+%             s -- a socket info struct returned from
+%                  mglSocketCreateClient(), or a struct array of these.
+%             fanOut -- 1 to turn fan-out on, 0 to turn it off. Leave out
+%                  or empty to leave it as it is.
+%             timeouts -- how long in seconds to wait for a reply on each
+%                  socket, a scalar for all of s or one value for each.
+%                  Inf (the default) waits as long as it takes. A reply
+%                  that times out is read as zeros, and is skipped when it
+%                  does arrive so that the next reply lines up. Writes do
+%                  not time out.
+%
+%             stats is a struct array the same size as s, with the
+%             timeout, readCount, timeoutCount, mean, max and last wait
+%             for replies (in seconds from when mglSocketRead was called),
+%             writeCount, mean and max wait for writes, bytesSkipped from
+%             late replies, and bytesToSkip still to come.
+%
+%             Replies to coalesced commands (mglSocketCoalesce) are read
+%             one socket at a time and do not skip late replies, so
+%             setting a timeout while coalescing is an error, as is
+%             turning coalescing on while any socket has a timeout or
+%             late reply bytes still to skip.
+%
+%             mglOpen;
+%             mglMirrorOpen(0);
+%             mglSocketFanOut(mgl.activeSockets, 1, [Inf 0.05]);
+%             mglClearScreen([1 0 0]);
+%             mglFlush;
+%             stats = mglSocketFanOut(mgl.activeSockets, 0)
+%
@@ -16,10 +16,12 @@ copyright: (c) 2019 Justin Gardner (GPL see mgl/COPYING)
 /////////////////////////
 #include "mgl.h"
 #include "mglCommandTypes.h"
+#include "mglSocketCoalesce.h"
+#include "mglSocketFanOut.h"
 #include <string.h>
 #include <sys/socket.h>
 
-mxDouble readForStructElement(const mxArray* socketInfo, mwIndex index, void* dataBytes, size_t numBytes, int verbose);
+mxDouble readForStructElement(const mxArray* socketInfo, mwIndex index, void* dataBytes, size_t numBytes, mxClassID classID, mglSocketCoalesceState* coalesceState, mglSocketFanOutState* fanOutState, mglSocketFanOutSocket** fanOutSocket, int verbose);
 
 //////////////
 //   main   //
@@ -103,17 +105,46 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
     // Aggregate read results from multiple sockets, one from each element
     // of the given socket info struct array.
+    mglSocketCoalesceState* coalesceState = mglSocketCoalesceGetState();
+
+    // With fan-out on, sockets are read all together below, as their replies arrive (see mglSocketFanOut.h).
+    mglSocketFanOutState* fanOutState = mglSocketFanOutGetState();
+    mglSocketFanOutSocket* fanOutSockets[socketCount > 0 ? socketCount : 1];
+    char* fanOutBuffers[socketCount > 0 ? socketCount : 1];
+    size_t fanOutCount = 0;
+
     void* dataBytes = mxGetData(data);
     int index;
     for (index = 0; index < socketCount; index++) {
         size_t socketOffset = index * numBytes;
-        readForStructElement(prhs[0], index, dataBytes + socketOffset, numBytes, verbose);
+        mglSocketFanOutSocket* fanOutSocket = NULL;
+        readForStructElement(prhs[0], index, dataBytes + socketOffset, numBytes, mxGetClassID(data), coalesceState, fanOutState, &fanOutSocket, verbose);
+        if (fanOutSocket != NULL) {
+            fanOutSockets[fanOutCount] = fanOutSocket;
+            fanOutBuffers[fanOutCount] = (char*)dataBytes + socketOffset;
+            fanOutCount++;
+        }
+    }
+
+    if (fanOutCount > 0) {
+        mxDouble readBytes[fanOutCount];
+        mglSocketFanOutRecv(fanOutSockets, fanOutCount, fanOutBuffers, numBytes, readBytes);
+        if (verbose) {
+            for (index = 0; index < fanOutCount; index++) {
+                if (readBytes[index] < numBytes) {
+                    mexPrintf("(mglSocketRead) Expected to read %d bytes but read %d on connectionSocketDescriptor %d (%d bytes still to skip).\n", numBytes, (int)readBytes[index], fanOutSockets[index]->socketDescriptor, (int)fanOutSockets[index]->skipBytes);
+                }
+            }
+            mexPrintf("(mglSocketRead) Read %d bytes from %d sockets at once.\n", numBytes, fanOutCount);
+        }
     }
 
     plhs[0] = data;
 }
 
-mxDouble readForStructElement(const mxArray* socketInfo, mwIndex index, void* dataBytes, size_t numBytes, int verbose) {
+// Read data from the socket from the index-th element of socketInfo. With fan-out on, the
+// socket is returned in fanOutSocket to be read together with the others, instead.
+mxDouble readForStructElement(const mxArray* socketInfo, mwIndex index, void* dataBytes, size_t numBytes, mxClassID classID, mglSocketCoalesceState* coalesceState, mglSocketFanOutState* fanOutState, mglSocketFanOutSocket** fanOutSocket, int verbose) {
     // Get the connectionSocketDescriptor to read from.
     mxArray* field = mxGetField(socketInfo, index, "connectionSocketDescriptor");
     if (field == NULL) {
@@ -130,6 +161,22 @@ mxDouble readForStructElement(const mxArray* socketInfo, mwIndex index, void* da
         return -1;
     }
 
+    // When coalescing, reads for held commands get placeholders, and other reads
+    // first catch up on the replies for held commands that were sent.
+    if (coalesceState != NULL) {
+        mxDouble placeholderBytes = mglSocketCoalesceRead(mglSocketCoalesceGetSocket(coalesceState, connectionSocketDescriptor, 0), dataBytes, numBytes, classID);
+        if (placeholderBytes >= 0) {
+            return placeholderBytes;
+        }
+    }
+
+    if (fanOutState != NULL) {
+        *fanOutSocket = mglSocketFanOutGetSocket(fanOutState, connectionSocketDescriptor, 1);
+        if (*fanOutSocket != NULL) {
+            return 0;
+        }
+    }
+
     // Read data from the socket into the Matlab data matrix.
     int readBytes = recv(connectionSocketDescriptor, dataBytes, numBytes, MSG_WAITALL);
     if (verbose) {
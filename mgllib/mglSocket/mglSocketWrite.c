@@ -16,9 +16,11 @@ copyright: (c) 2019 Justin Gardner (GPL see mgl/COPYING)
 /////////////////////////
 #include "mgl.h"
 #include "mglCommandTypes.h"
+#include "mglSocketCoalesce.h"
+#include "mglSocketFanOut.h"
 #include <sys/socket.h>
 
-mxDouble writeForStructElement(const mxArray* socketInfo, mwIndex index, const void* dataBytes, size_t numBytes, int verbose);
+mxDouble writeForStructElement(const mxArray* socketInfo, mwIndex index, const void* dataBytes, size_t numBytes, int isCommandCode, mglSocketCoalesceState* coalesceState, mglSocketFanOutState* fanOutState, mglSocketFanOutSocket** fanOutSocket, int verbose);
 
 //////////////
 //   main   //
@@ -66,17 +68,48 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
         mexPrintf("(mglSocketWrite) Sending %d elements of type %s as %d bytes on %d sockets.\n", numElements, mxGetClassName(prhs[1]), numBytes, socketCount);
     }
 
+    // A single uint16 is a command code, which matters if commands are being coalesced (see mglSocketCoalesce.h).
+    int isCommandCode = mxIsClass(prhs[1], "uint16") && (numElements == 1);
+    mglSocketCoalesceState* coalesceState = mglSocketCoalesceGetState();
+
+    // With fan-out on, sockets are written all together below, instead of one at a time (see mglSocketFanOut.h).
+    mglSocketFanOutState* fanOutState = mglSocketFanOutGetState();
+    mglSocketFanOutSocket* fanOutSockets[socketCount > 0 ? socketCount : 1];
+    size_t fanOutIndices[socketCount > 0 ? socketCount : 1];
+    size_t fanOutCount = 0;
+
     void* dataBytes = mxGetData(prhs[1]);
     int index;
     for (index = 0; index < socketCount; index++) {
-        mxDouble bytesWritten = writeForStructElement(prhs[0], index, dataBytes, numBytes, verbose);
+        mglSocketFanOutSocket* fanOutSocket = NULL;
+        mxDouble bytesWritten = writeForStructElement(prhs[0], index, dataBytes, numBytes, isCommandCode, coalesceState, fanOutState, &fanOutSocket, verbose);
         resultDoubles[index] = bytesWritten;
+        if (fanOutSocket != NULL) {
+            fanOutSockets[fanOutCount] = fanOutSocket;
+            fanOutIndices[fanOutCount] = index;
+            fanOutCount++;
+        }
+    }
+
+    if (fanOutCount > 0) {
+        mxDouble sentBytes[fanOutCount];
+        mglSocketFanOutSend(fanOutSockets, fanOutCount, dataBytes, numBytes, sentBytes);
+        for (index = 0; index < fanOutCount; index++) {
+            resultDoubles[fanOutIndices[index]] = sentBytes[index];
+            if (verbose && (sentBytes[index] < numBytes)) {
+                mexPrintf("(mglSocketWrite) Expected to send %d bytes but sent %d on connectionSocketDescriptor %d, errno: %d\n", numBytes, (int)sentBytes[index], fanOutSockets[index]->socketDescriptor, errno);
+            }
+        }
+        if (verbose) {
+            mexPrintf("(mglSocketWrite) Sent %d bytes to %d sockets at once.\n", numBytes, fanOutCount);
+        }
     }
 }
 
 // Write data to the socket from the index-th element of socketInfo.
-// Return the number of bytes written, or -1.0 on error.
-mxDouble writeForStructElement(const mxArray* socketInfo, mwIndex index, const void* dataBytes, size_t numBytes, int verbose) {
+// Return the number of bytes written, or -1.0 on error. With fan-out on, the socket is
+// returned in fanOutSocket to be written together with the others, instead.
+mxDouble writeForStructElement(const mxArray* socketInfo, mwIndex index, const void* dataBytes, size_t numBytes, int isCommandCode, mglSocketCoalesceState* coalesceState, mglSocketFanOutState* fanOutState, mglSocketFanOutSocket** fanOutSocket, int verbose) {
     // Get the connectionSocketDescriptor to write to.
     mxArray* field = mxGetField(socketInfo, index, "connectionSocketDescriptor");
     if (field == NULL) {
@@ -93,6 +126,25 @@ mxDouble writeForStructElement(const mxArray* socketInfo, mwIndex index, const v
         return -1;
     }
 
+    // When coalescing, drawing commands are held to be sent all together. Recorded sockets hold everything.
+    if (coalesceState != NULL) {
+        mglSocketCoalesceSocket* coalesceSocket = mglSocketCoalesceGetSocket(coalesceState, connectionSocketDescriptor, coalesceState->coalescing);
+        mxDouble bytesHeld = mglSocketCoalesceWrite(coalesceSocket, dataBytes, numBytes, isCommandCode);
+        if (bytesHeld >= 0) {
+            if (verbose) {
+                mexPrintf("(mglSocketWrite) Coalesced %d bytes for connectionSocketDescriptor %d (index %d).\n", numBytes, connectionSocketDescriptor, index);
+            }
+            return bytesHeld;
+        }
+    }
+
+    if (fanOutState != NULL) {
+        *fanOutSocket = mglSocketFanOutGetSocket(fanOutState, connectionSocketDescriptor, 1);
+        if (*fanOutSocket != NULL) {
+            return 0;
+        }
+    }
+
     if (verbose) {
         mexPrintf("(mglSocketWrite) Sending %d bytes on connectionSocketDescriptor %d (index %d).\n", numBytes, connectionSocketDescriptor, index);
     }
@@ -0,0 +1,193 @@
+#ifdef documentation
+=========================================================================
+
+  program: mglSocketWriteTexture.c
+       by: justin gardner
+     date: 10/19/2026
+copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+  purpose: mex function to write an image to one or more posix sockets
+           as the rgba singles that mglMetal reads for mglCreateTexture,
+           converting it a band of rows at a time as it is sent (see
+           mglSocketWriteTexture.h), instead of making copies of the
+           whole image in Matlab first
+    usage: byteCount = mglSocketWriteTexture(s, im, <divisor>, <chunkBytes>)
+
+=========================================================================
+#endif
+
+/////////////////////////
+//   include section   //
+/////////////////////////
+#include "mgl.h"
+#include "mglCommandTypes.h"
+#include "mglSocketCoalesce.h"
+#include "mglSocketFanOut.h"
+#include "mglSocketWriteTexture.h"
+#include <sys/socket.h>
+
+// where each band of the image goes
+typedef struct {
+    size_t socketCount;
+    int socketDescriptors[MGL_SOCKET_FAN_OUT_MAX_SOCKETS];
+    // held with coalesced drawing commands, or NULL to send
+    mglSocketCoalesceSocket* coalesceSockets[MGL_SOCKET_FAN_OUT_MAX_SOCKETS];
+    // sent all together with fan-out on, or NULL to send one at a time
+    mglSocketFanOutSocket* fanOutSockets[MGL_SOCKET_FAN_OUT_MAX_SOCKETS];
+    double bytesWritten[MGL_SOCKET_FAN_OUT_MAX_SOCKETS];
+    int failed[MGL_SOCKET_FAN_OUT_MAX_SOCKETS];
+} textureDestinations;
+
+int getImage(const mxArray* im, mglSocketTextureImage* image);
+void sendChunk(void* context, const float* chunk, size_t numBytes);
+
+//////////////
+//   main   //
+//////////////
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
+
+    // Check for expected usage.
+    mglSocketTextureImage image;
+    if (nrhs < 2 || nrhs > 4 || !mxIsStruct(prhs[0]) || !getImage(prhs[1], &image)) {
+        mxArray *callInput[] = { mxCreateString("mglSocketWriteTexture") };
+        mexCallMATLAB(0, NULL, 1, callInput, "help");
+        plhs[0] = mxCreateDoubleMatrix(0, 0, mxREAL);
+        return;
+    }
+    if (nrhs >= 3 && !mxIsEmpty(prhs[2])) {
+        image.divisor = mxGetScalar(prhs[2]);
+    }
+    size_t chunkBytes = 0;
+    if (nrhs >= 4 && !mxIsEmpty(prhs[3])) {
+        chunkBytes = (size_t)mxGetScalar(prhs[3]);
+    }
+
+    int verbose = (int)mglGetGlobalDouble("verbose");
+
+    size_t m = mxGetM(prhs[0]);
+    size_t n = mxGetN(prhs[0]);
+    plhs[0] = mxCreateDoubleMatrix(m, n, mxREAL);
+    mxDouble* resultDoubles = mxGetPr(plhs[0]);
+    size_t socketCount = m * n;
+    if (socketCount > MGL_SOCKET_FAN_OUT_MAX_SOCKETS) {
+        mexPrintf("(mglSocketWriteTexture) Can only write to %d sockets at a time, not %d.\n", MGL_SOCKET_FAN_OUT_MAX_SOCKETS, socketCount);
+        int index;
+        for (index = 0; index < socketCount; index++) {
+            resultDoubles[index] = -1;
+        }
+        return;
+    }
+
+    // Find where each band goes. This has to be done here, since the bands are sent from another thread, which can not call Matlab.
+    mglSocketCoalesceState* coalesceState = mglSocketCoalesceGetState();
+    mglSocketFanOutState* fanOutState = mglSocketFanOutGetState();
+    textureDestinations destinations;
+    memset(&destinations, 0, sizeof(destinations));
+    int index;
+    for (index = 0; index < socketCount; index++) {
+        mxArray* field = mxGetField(prhs[0], index, "connectionSocketDescriptor");
+        int connectionSocketDescriptor = (field == NULL) ? -1 : (int) mxGetScalar(field);
+        if (connectionSocketDescriptor < 0) {
+            if (verbose) {
+                mexPrintf("(mglSocketWriteTexture) Not ready to write to connectionSocketDescriptor %d (index %d), please use mglSocketCreateClient first.\n", connectionSocketDescriptor, index);
+            }
+            continue;
+        }
+        size_t i = destinations.socketCount++;
+        destinations.socketDescriptors[i] = connectionSocketDescriptor;
+        // Only data that goes with a held drawing command is held. mglCreateTexture is not one, so this is usually NULL.
+        mglSocketCoalesceSocket* coalesceSocket = mglSocketCoalesceGetSocket(coalesceState, connectionSocketDescriptor, 0);
+        if ((coalesceSocket != NULL) && coalesceSocket->holding) {
+            destinations.coalesceSockets[i] = coalesceSocket;
+        } else {
+            destinations.fanOutSockets[i] = mglSocketFanOutGetSocket(fanOutState, connectionSocketDescriptor, 1);
+        }
+    }
+
+    if (verbose) {
+        mexPrintf("(mglSocketWriteTexture) Sending %dx%dx%d %s image as %d bytes on %d sockets.\n", image.height, image.width, image.nChannels, mxGetClassName(prhs[1]), image.height * image.width * MGL_SOCKET_TEXTURE_PIXEL_BYTES, destinations.socketCount);
+    }
+
+    if (destinations.socketCount > 0) {
+        if (mglSocketTextureSend(&image, chunkBytes, sendChunk, &destinations) == 0) {
+            mexPrintf("(mglSocketWriteTexture) Could not allocate memory to send image.\n");
+        }
+    }
+
+    // Report bytes written in the order of the socket info, with -1 for sockets not written.
+    size_t i = 0;
+    for (index = 0; index < socketCount; index++) {
+        mxArray* field = mxGetField(prhs[0], index, "connectionSocketDescriptor");
+        if ((field == NULL) || ((int) mxGetScalar(field) < 0)) {
+            resultDoubles[index] = -1;
+            continue;
+        }
+        resultDoubles[index] = destinations.bytesWritten[i];
+        if (verbose && destinations.failed[i]) {
+            mexPrintf("(mglSocketWriteTexture) Sent only %d bytes on connectionSocketDescriptor %d, errno: %d\n", (int)destinations.bytesWritten[i], destinations.socketDescriptors[i], errno);
+        }
+        i++;
+    }
+}
+
+// Check that im is a real double or single height x width x (1, 3 or 4)
+// image, or a uint8 (1, 3 or 4) x width x height image, and describe it.
+int getImage(const mxArray* im, mglSocketTextureImage* image) {
+    if (mxIsComplex(im) || mxIsSparse(im) || mxIsEmpty(im) || mxGetNumberOfDimensions(im) > 3) {
+        return 0;
+    }
+    const mwSize* dims = mxGetDimensions(im);
+    size_t thirdDim = (mxGetNumberOfDimensions(im) > 2) ? dims[2] : 1;
+    image->data = mxGetData(im);
+    if (mxIsClass(im, "double") || mxIsClass(im, "single")) {
+        image->imageClass = mxIsClass(im, "double") ? mglSocketTextureDouble : mglSocketTextureSingle;
+        image->height = dims[0];
+        image->width = dims[1];
+        image->nChannels = thirdDim;
+        image->divisor = 1;
+    } else if (mxIsClass(im, "uint8")) {
+        image->imageClass = mglSocketTextureUInt8;
+        image->nChannels = dims[0];
+        image->width = dims[1];
+        image->height = thirdDim;
+        image->divisor = 255;
+    } else {
+        return 0;
+    }
+    return (image->nChannels == 1) || (image->nChannels == 3) || (image->nChannels == 4);
+}
+
+// Send one band of the image to each socket, called from the sending thread.
+void sendChunk(void* context, const float* chunk, size_t numBytes) {
+    textureDestinations* destinations = (textureDestinations*)context;
+    mglSocketFanOutSocket* fanOutSockets[MGL_SOCKET_FAN_OUT_MAX_SOCKETS];
+    size_t fanOutIndices[MGL_SOCKET_FAN_OUT_MAX_SOCKETS];
+    size_t fanOutCount = 0;
+    size_t i;
+    for (i = 0; i < destinations->socketCount; i++) {
+        if (destinations->failed[i]) {
+            continue;
+        }
+        size_t sent;
+        if (destinations->coalesceSockets[i] != NULL) {
+            sent = mglSocketCoalesceAppend(destinations->coalesceSockets[i], chunk, numBytes) ? numBytes : 0;
+        } else if (destinations->fanOutSockets[i] != NULL) {
+            fanOutSockets[fanOutCount] = destinations->fanOutSockets[i];
+            fanOutIndices[fanOutCount] = i;
+            fanOutCount++;
+            continue;
+        } else {
+            sent = mglSocketSendAll(destinations->socketDescriptors[i], chunk, numBytes);
+        }
+        destinations->bytesWritten[i] += sent;
+        destinations->failed[i] = (sent < numBytes);
+    }
+
+    if (fanOutCount > 0) {
+        double sentBytes[fanOutCount];
+        mglSocketFanOutSend(fanOutSockets, fanOutCount, chunk, numBytes, sentBytes);
+        for (i = 0; i < fanOutCount; i++) {
+            destinations->bytesWritten[fanOutIndices[i]] += sentBytes[i];
+            destinations->failed[fanOutIndices[i]] = (sentBytes[i] < numBytes);
+        }
+    }
+}
@@ -0,0 +1,245 @@
+#ifdef documentation
+=========================================================================
+
+  program: mglSocketWriteTexture.h
+       by: justin gardner
+     date: 10/19/2026
+copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+  purpose: used by mglSocketWriteTexture to turn a Matlab image into
+           the rgba single values that mglMetal reads for mglCreateTexture
+           a band of rows at a time, and to send each band while the next
+           one is converted.
+
+           mglMetal wants interleaved rgba, row 1 first, which used to be
+           made in Matlab with permute, cat and single, each a full copy
+           of the image. Here the image is read where it is, a band of
+           rows goes into one of two small staging buffers, and a second
+           thread sends the band that is ready while the first converts
+           the next, so memory stays at two buffers however large the
+           image is. The values are the same as single(permute(im,[3 2 1]))
+           of the image made by the Matlab code.
+
+           Plain C with no Matlab, so that it can be checked on its own.
+
+=========================================================================
+#endif
+
+#ifndef MGL_SOCKET_WRITE_TEXTURE_H
+#define MGL_SOCKET_WRITE_TEXTURE_H
+
+/////////////////////////
+//   include section   //
+/////////////////////////
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+//////////////////////
+//   define section //
+//////////////////////
+// size of each of the two staging buffers, a band is at least one row
+#define MGL_SOCKET_TEXTURE_CHUNK_BYTES 1048576
+#define MGL_SOCKET_TEXTURE_PIXEL_BYTES (4 * sizeof(float))
+
+typedef enum {
+  mglSocketTextureDouble,
+  mglSocketTextureSingle,
+  // rgba x width x height, as mglCreateTexture takes uint8 images
+  mglSocketTextureUInt8
+} mglSocketTextureClass;
+
+// the image as Matlab has it
+typedef struct {
+  const void *data;
+  mglSocketTextureClass imageClass;
+  size_t height;
+  size_t width;
+  // 1 for grayscale, 3 for rgb, or 4 for rgba, alpha is 1 when missing
+  size_t nChannels;
+  // values are divided by this, 255 for images that are 0-255
+  double divisor;
+} mglSocketTextureImage;
+
+// called with each band of rgba singles, in order
+typedef void (*mglSocketTextureSendFunction)(void *context, const float *chunk, size_t numBytes);
+
+// two staging buffers, passed between the converting and sending threads
+typedef struct {
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  float *buffers[2];
+  size_t bytes[2];
+  int full[2];
+  int finished;
+  mglSocketTextureSendFunction sendChunk;
+  void *context;
+} mglSocketTexturePipe;
+
+////////////////////////////////////
+//   mglSocketTextureEncodeRows   //
+////////////////////////////////////
+// Convert nRows rows starting at firstRow to rgba singles, row by row. Matlab
+// images are column-major, so each column of the band is read as a run of
+// values, and written with a stride into the staging buffer, which is small
+// enough to stay in cache.
+static inline void mglSocketTextureEncodeRows(const mglSocketTextureImage *image, size_t firstRow, size_t nRows, float *output)
+{
+  size_t height = image->height, width = image->width, nChannels = image->nChannels;
+  size_t rowValues = 4 * width;
+  size_t planeSize = height * width;
+  size_t row, column, channel;
+
+  if (image->imageClass == mglSocketTextureUInt8) {
+    // already pixel by pixel, row by row, so just convert
+    const uint8_t *data = (const uint8_t *)image->data + firstRow * width * nChannels;
+    for (row = 0; row < nRows; row++)
+      for (column = 0; column < width; column++, data += nChannels, output += 4)
+        for (channel = 0; channel < 4; channel++) {
+          size_t fromChannel = (nChannels == 1) ? ((channel < 3) ? 0 : 1) : channel;
+          output[channel] = (fromChannel < nChannels) ? (float)((double)data[fromChannel] / image->divisor) : 1.0f;
+        }
+    return;
+  }
+
+  for (column = 0; column < width; column++) {
+    for (channel = 0; channel < 4; channel++) {
+      float *out = output + 4 * column + channel;
+      // gray goes to r, g and b, and missing alpha is 1
+      size_t fromChannel = (nChannels == 1) ? ((channel < 3) ? 0 : 1) : channel;
+      if (fromChannel >= nChannels) {
+        for (row = 0; row < nRows; row++, out += rowValues)
+          *out = 1.0f;
+        continue;
+      }
+      size_t start = firstRow + column * height + fromChannel * planeSize;
+      if (image->imageClass == mglSocketTextureDouble) {
+        const double *in = (const double *)image->data + start;
+        if (image->divisor == 1)
+          for (row = 0; row < nRows; row++, out += rowValues)
+            *out = (float)in[row];
+        else
+          for (row = 0; row < nRows; row++, out += rowValues)
+            *out = (float)(in[row] / image->divisor);
+      }
+      else {
+        // single images are divided in single, as Matlab does
+        const float *in = (const float *)image->data + start;
+        float divisor = (float)image->divisor;
+        if (divisor == 1)
+          for (row = 0; row < nRows; row++, out += rowValues)
+            *out = in[row];
+        else
+          for (row = 0; row < nRows; row++, out += rowValues)
+            *out = in[row] / divisor;
+      }
+    }
+  }
+}
+
+//////////////////////////////
+//   mglSocketTextureSender //
+//////////////////////////////
+// Sends the buffers in turn as they are filled, until there are no more.
+static void *mglSocketTextureSender(void *arg)
+{
+  mglSocketTexturePipe *staging = (mglSocketTexturePipe *)arg;
+  int i = 0;
+  while (1) {
+    pthread_mutex_lock(&staging->mutex);
+    while (!staging->full[i] && !staging->finished)
+      pthread_cond_wait(&staging->cond, &staging->mutex);
+    int full = staging->full[i];
+    pthread_mutex_unlock(&staging->mutex);
+    if (!full) break;
+
+    staging->sendChunk(staging->context, staging->buffers[i], staging->bytes[i]);
+
+    pthread_mutex_lock(&staging->mutex);
+    staging->full[i] = 0;
+    pthread_cond_broadcast(&staging->cond);
+    pthread_mutex_unlock(&staging->mutex);
+    i = !i;
+  }
+  return NULL;
+}
+
+////////////////////////////
+//   mglSocketTextureSend //
+////////////////////////////
+// Convert and send the image a band at a time, with chunkBytes buffers (0 for the default).
+// Returns the number of bytes sent to sendChunk, or 0 if memory could not be had.
+static inline size_t mglSocketTextureSend(const mglSocketTextureImage *image, size_t chunkBytes, mglSocketTextureSendFunction sendChunk, void *context)
+{
+  size_t rowBytes = image->width * MGL_SOCKET_TEXTURE_PIXEL_BYTES;
+  if ((rowBytes == 0) || (image->height == 0)) return 0;
+  if (chunkBytes == 0) chunkBytes = MGL_SOCKET_TEXTURE_CHUNK_BYTES;
+  size_t bandRows = chunkBytes / rowBytes;
+  if (bandRows < 1) bandRows = 1;
+  if (bandRows > image->height) bandRows = image->height;
+  size_t nBands = (image->height + bandRows - 1) / bandRows;
+
+  mglSocketTexturePipe staging;
+  staging.buffers[0] = (float *)malloc(bandRows * rowBytes);
+  staging.buffers[1] = (nBands > 1) ? (float *)malloc(bandRows * rowBytes) : NULL;
+  if ((staging.buffers[0] == NULL) || ((nBands > 1) && (staging.buffers[1] == NULL))) {
+    free(staging.buffers[0]);
+    free(staging.buffers[1]);
+    return 0;
+  }
+
+  // one band needs no second thread
+  if (nBands == 1) {
+    mglSocketTextureEncodeRows(image, 0, image->height, staging.buffers[0]);
+    sendChunk(context, staging.buffers[0], image->height * rowBytes);
+    free(staging.buffers[0]);
+    return image->height * rowBytes;
+  }
+
+  pthread_mutex_init(&staging.mutex, NULL);
+  pthread_cond_init(&staging.cond, NULL);
+  staging.full[0] = staging.full[1] = 0;
+  staging.finished = 0;
+  staging.sendChunk = sendChunk;
+  staging.context = context;
+  pthread_t sender;
+  int threaded = (pthread_create(&sender, NULL, mglSocketTextureSender, &staging) == 0);
+
+  size_t band;
+  for (band = 0; band < nBands; band++) {
+    int i = band & 1;
+    size_t firstRow = band * bandRows;
+    size_t nRows = (firstRow + bandRows <= image->height) ? bandRows : image->height - firstRow;
+    if (threaded) {
+      // wait for the sender to be done with this buffer
+      pthread_mutex_lock(&staging.mutex);
+      while (staging.full[i])
+        pthread_cond_wait(&staging.cond, &staging.mutex);
+      pthread_mutex_unlock(&staging.mutex);
+    }
+    mglSocketTextureEncodeRows(image, firstRow, nRows, staging.buffers[i]);
+    if (threaded) {
+      pthread_mutex_lock(&staging.mutex);
+      staging.bytes[i] = nRows * rowBytes;
+      staging.full[i] = 1;
+      pthread_cond_broadcast(&staging.cond);
+      pthread_mutex_unlock(&staging.mutex);
+    }
+    else
+      sendChunk(context, staging.buffers[i], nRows * rowBytes);
+  }
+
+  if (threaded) {
+    pthread_mutex_lock(&staging.mutex);
+    staging.finished = 1;
+    pthread_cond_broadcast(&staging.cond);
+    pthread_mutex_unlock(&staging.mutex);
+    pthread_join(sender, NULL);
+  }
+  pthread_mutex_destroy(&staging.mutex);
+  pthread_cond_destroy(&staging.cond);
+  free(staging.buffers[0]);
+  free(staging.buffers[1]);
+  return image->height * rowBytes;
+}
+
+#endif // MGL_SOCKET_WRITE_TEXTURE_H
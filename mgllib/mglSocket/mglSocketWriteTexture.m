@@ -0,0 +1,55 @@
+% mglSocketWriteTexture: Write an image to one or more opened sockets as a texture.
+%
+%      usage: byteCount = mglSocketWriteTexture(s, im, <divisor>, <chunkBytes>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: Writes an image to a socket that was opened by
+%             mglSocketCreateClient() or mglSocketCreateServer(), or an
+%             array of these, as the rgba single values that mglMetal
+%             reads for mglCreateTexture.
+%
+%             Sends the same bytes as
+%                 mglSocketWrite(s, single(permute(im, [3 2 1])) / divisor)
+%             with im made rgba, but without making any copies of the
+%             image. It is converted a band of rows at a time into a small
+%             buffer, and each band is sent while the next is converted
+%             (see mglSocketWriteTexture.h), so memory stays about the same
+%             however large the image is.
+%
+%      usage: byteCount = mglSocketWriteTexture(s, im, divisor, chunkBytes)
+%             s -- a socket info struct returned from
+%                  mglSocketCreateClient() or mglSocketCreateServer().
+%                  s can also be a struct array of these.
+%             im -- a double or single m x n x 4 rgba, m x n x 3 rgb or
+%                   m x n grayscale image, or a uint8 4 x n x m, 3 x n x m
+%                   or 1 x n x m image, as mglCreateTexture takes. Missing
+%                   alpha is 1.
+%             divisor -- values are divided by this (default 1, and 255
+%                        for uint8 images).
+%             chunkBytes -- size of the buffer for each band of rows
+%                           (default 1 MB), which is at least one row.
+%
+%             Returns the number of bytes written to the socket, which is
+%             m*n*16, or less on error, or -1 for a socket that is not
+%             connected. When s is an mxn struct array, the result also
+%             has size mxn.
+%
+% % Create a client and server that can talk over sockets.
+% socketFile = '/tmp/test.socket';
+% if isfile(socketFile)
+%     delete(socketFile);
+% end
+%
+% server = mglSocketCreateServer(socketFile);
+% client = mglSocketCreateClient(socketFile);
+% server = mglSocketAcceptConnection(server);
+%
+% % Send a small grayscale image and read it back as rgba.
+% im = rand(3, 5);
+% mglSocketWriteTexture(client, im);
+% rgba = mglSocketRead(server, 'single', 4, 5, 3)
+%
+% mglSocketClose(client)
+% mglSocketClose(server)
+%
@@ -0,0 +1,133 @@
+% mglTestSocketFanOut.m
+%
+%      usage: mglTestSocketFanOut(socketCount=3, socketDir='/tmp')
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: Test writing to and reading from several sockets at once
+%             with mglSocketFanOut, using local servers as stand-ins for
+%             the primary and mirrored windows. Checks that data gets to
+%             and from all of them intact, that a server that does not
+%             reply times out without holding up the others, and that its
+%             late reply is skipped so that the next reply lines up.
+%      usage:
+%             % You want to rebuild the socket functions first.
+%             mglMakeSocket()
+%             mglTestSocketFanOut()
+%
+function mglTestSocketFanOut(socketCount, socketDir)
+
+if nargin < 1
+    socketCount = 3;
+end
+
+if nargin < 2
+    socketDir = '/tmp';
+end
+
+if ~isfolder(socketDir)
+    mkdir(socketDir);
+end
+
+socketFiles = cell(1, socketCount);
+for ii = 1:socketCount
+    socketFiles{ii} = fullfile(socketDir, sprintf('test-fan-out-%d.socket', ii));
+    if isfile(socketFiles{ii})
+        delete(socketFiles{ii});
+    end
+end
+
+fprintf('Testing fan-out to %d sockets\n', socketCount);
+
+% Set up a server for each socketFile and a client connected to each.
+serverCell = cell(1, socketCount);
+clientCell = cell(1, socketCount);
+cleanups = cell(1, 2 * socketCount);
+for ii = 1:socketCount
+    serverCell{ii} = mglSocketCreateServer(socketFiles{ii});
+    clientCell{ii} = mglSocketCreateClient(socketFiles{ii});
+    serverCell{ii} = mglSocketAcceptConnection(serverCell{ii});
+    server = serverCell{ii};
+    client = clientCell{ii};
+    cleanups{2*ii-1} = onCleanup(@() mglSocketClose(server));
+    cleanups{2*ii} = onCleanup(@() mglSocketClose(client));
+    assert(serverCell{ii}.connectionSocketDescriptor >= 0, 'Server connectionSocketDescriptor should be non-negative but it was %d', serverCell{ii}.connectionSocketDescriptor);
+end
+clients = [clientCell{:}];
+servers = [serverCell{:}];
+
+% The last client stands in for a slow mirror, with a short timeout.
+timeout = 0.1;
+timeouts = [inf(1, socketCount-1), timeout];
+fanOutCleanup = onCleanup(@() mglSocketFanOut(clients, 0));
+mglSocketFanOut(clients, 1, timeouts);
+
+% Data written by the clients all at once should get to every server.
+rows = 5;
+columns = 3;
+slices = 2;
+originalData = rand([rows, columns, slices], 'double');
+byteCount = mglSocketWrite(clients, originalData);
+assert(all(byteCount == numel(originalData) * 8), 'All sent byte counts should be %d but were: %s', numel(originalData) * 8, num2str(byteCount));
+receivedData = mglSocketRead(servers, 'double', rows, columns, slices);
+for ii = 1:socketCount
+    assert(isequal(receivedData(:, :, :, ii), originalData), 'Received data for server %d was not equal to original data.', ii);
+end
+
+% Replies from all servers should be read all at once.
+replies = rand(1, socketCount);
+for ii = 1:socketCount
+    mglSocketWrite(servers(ii), replies(ii));
+end
+receivedReplies = mglSocketRead(clients, 'double');
+assert(isequal(receivedReplies(:)', replies), 'Replies were not read correctly: %s instead of %s', num2str(receivedReplies(:)'), num2str(replies));
+
+% When the last server does not reply, the others should be read, and the
+% last should time out and be read as zero.
+replies = rand(1, socketCount);
+for ii = 1:socketCount-1
+    mglSocketWrite(servers(ii), replies(ii));
+end
+timer = tic();
+receivedReplies = mglSocketRead(clients, 'double');
+readDuration = toc(timer);
+assert(isequal(receivedReplies(1:end-1)', replies(1:end-1)), 'Replies from servers that replied were not read correctly');
+assert(receivedReplies(end) == 0, 'Reply that timed out should be 0 but was %f', receivedReplies(end));
+assert(readDuration >= timeout && readDuration < timeout + 0.5, 'Read should have waited for the timeout of %f but took %f', timeout, readDuration);
+
+% The late reply should be skipped, and the next reply read in its place.
+mglSocketWrite(servers(end), replies(end));
+replies = rand(1, socketCount);
+for ii = 1:socketCount
+    mglSocketWrite(servers(ii), replies(ii));
+end
+receivedReplies = mglSocketRead(clients, 'double');
+assert(isequal(receivedReplies(:)', replies), 'Reply after a timeout did not line up: %s instead of %s', num2str(receivedReplies(:)'), num2str(replies));
+
+% Check the stats.
+stats = mglSocketFanOut(clients);
+assert(isequal([stats.readCount], [3 * ones(1, socketCount-1), 2]), 'Read counts were not right: %s', num2str([stats.readCount]));
+assert(isequal([stats.timeoutCount], [zeros(1, socketCount-1), 1]), 'Timeout counts were not right: %s', num2str([stats.timeoutCount]));
+assert(isequal([stats.writeCount], ones(1, socketCount)), 'Write counts were not right: %s', num2str([stats.writeCount]));
+assert(stats(end).bytesSkipped == 8 && stats(end).bytesToSkip == 0, 'Late reply should have been skipped');
+assert(all([stats.maxReadWait] >= 0), 'Read waits should not be negative');
+disp(struct2table(stats));
+
+% Coalesced replies are read without timeouts, so the two modes refuse each other.
+coalesceError = [];
+try
+    mglSocketCoalesce(clients, 1);
+catch coalesceError
+end
+assert(~isempty(coalesceError), 'Coalescing should not turn on while a socket has a timeout');
+mglSocketFanOut(clients, [], inf);
+mglSocketCoalesce(clients, 1);
+timeoutError = [];
+try
+    mglSocketFanOut(clients, [], timeouts);
+catch timeoutError
+end
+mglSocketCoalesce(clients, 0);
+assert(~isempty(timeoutError), 'Timeouts should not be set while coalescing');
+
+fprintf('OK\n');
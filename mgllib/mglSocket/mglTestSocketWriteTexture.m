@@ -0,0 +1,78 @@
+% mglTestSocketWriteTexture.m
+%
+%      usage: mglTestSocketWriteTexture(socketFile='/tmp/test-write-texture.socket')
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: Test that mglSocketWriteTexture sends the same bytes that
+%             mglCreateTexture used to make in Matlab with permute, cat
+%             and single, for double, single and uint8 images, in color
+%             and grayscale, with and without a divisor, and in bands
+%             smaller than the image, using a local server as a stand-in
+%             for mglMetal.
+%      usage:
+%             % You want to rebuild the socket functions first.
+%             mglMakeSocket()
+%             mglTestSocketWriteTexture()
+%
+function mglTestSocketWriteTexture(socketFile)
+
+if nargin < 1
+    socketFile = '/tmp/test-write-texture.socket';
+end
+
+if isfile(socketFile)
+    delete(socketFile);
+end
+
+server = mglSocketCreateServer(socketFile);
+client = mglSocketCreateClient(socketFile);
+server = mglSocketAcceptConnection(server);
+serverCleanup = onCleanup(@() mglSocketClose(server));
+clientCleanup = onCleanup(@() mglSocketClose(client));
+
+% Images are small enough to fit in the socket buffers, since the server
+% only reads after the client is done writing. Bands of 2 rows leave a
+% short band at the end.
+height = 9;
+width = 5;
+chunkBytes = 2 * width * 16;
+images = { ...
+    rand(height, width, 4), 1; ...
+    255 * rand(height, width, 4), 255; ...
+    single(rand(height, width, 3)), 1; ...
+    single(255 * rand(height, width)), 255; ...
+    rand(height, width), 1; ...
+    uint8(randi([0 255], 4, width, height)), []; ...
+    uint8(randi([0 255], 3, width, height)), []; ...
+    };
+
+for ii = 1:size(images, 1)
+    [im, divisor] = images{ii, :};
+    for bandBytes = [chunkBytes, 0]
+        byteCount = mglSocketWriteTexture(client, im, divisor, bandBytes);
+        assert(byteCount == height * width * 16, 'Image %d sent %d bytes but should have sent %d', ii, byteCount, height * width * 16);
+        received = mglSocketRead(server, 'single', 4, width, height);
+        expected = oldTextureFormat(im);
+        assert(isequal(received, expected), 'Image %d (%s, %d channels, bands of %d bytes) was not received as mglCreateTexture would have sent it', ii, class(im), size(expected, 1), bandBytes);
+    end
+    fprintf('Image %d (%s) OK\n', ii, class(im));
+end
+
+fprintf('OK\n');
+
+% The conversion that mglCreateTexture and mglMetalCreateTexture did in Matlab.
+function image = oldTextureFormat(image)
+if isequal(class(image), 'uint8')
+    image = permute(image, [3 2 1]);
+    image = double(image) / 255;
+end
+if max(image(:)) > 1
+    image = image / 255;
+end
+if size(image, 3) == 1
+    image = cat(3, image, image, image, ones(size(image)));
+elseif size(image, 3) == 3
+    image = cat(3, image, ones(size(image, 1:2)));
+end
+image = single(permute(image, [3 2 1]));
@@ -60,6 +60,7 @@ results = startStencilCreation(stencilNumber, invert, socketInfo);
 
 
 function results = startStencilCreation(stencilNumber, invert, socketInfo)
+mglPrivateSkipRedundant('invalidate', {'stencil'}, socketInfo);
 mglSocketWrite(socketInfo, socketInfo(1).command.mglStartStencilCreation);
 ackTime = mglSocketRead(socketInfo, 'double');
 mglSocketWrite(socketInfo, uint32(stencilNumber));
@@ -34,6 +34,7 @@ end
 mglFlush(socketInfo);
 
 % Get ready for regular drawign with no stencil selected.
+mglPrivateSkipRedundant('invalidate', {'stencil'}, socketInfo);
 mglSocketWrite(socketInfo, socketInfo(1).command.mglFinishStencilCreation);
 ackTime = mglSocketRead(socketInfo, 'double');
 results = mglReadCommandResults(socketInfo, ackTime);
@@ -29,7 +29,16 @@ if nargin < 2 || isempty(socketInfo)
     socketInfo = mgl.activeSockets;
 end
 
+% skip sending if this stencil is already selected (see mglMetalSkipRedundantCommands)
+[skip, results] = mglPrivateSkipRedundant('mglSelectStencil', uint32(stencilNumber), socketInfo);
+if skip
+    return
+end
+
 mglSocketWrite(socketInfo, socketInfo(1).command.mglSelectStencil);
 ackTime = mglSocketRead(socketInfo, 'double');
 mglSocketWrite(socketInfo, uint32(stencilNumber));
 results = mglReadCommandResults(socketInfo, ackTime);
+if any([results.processedTime] < 0)
+    mglPrivateSkipRedundant('invalidate', {'stencil'}, socketInfo);
+end
@@ -0,0 +1,279 @@
+#ifdef documentation
+=========================================================================
+
+  program: mglStimulusImage.h
+       by: justin gardner
+     date: 10/19/2026
+copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+  purpose: makes grating, gaussian, gabor and plaid images, with the same
+           coordinates and conventions as mglMakeGrating and
+           mglMakeGaussian, for mglPrivateMakeStimulusImage.
+
+           All of these images are separable, or sums of separable
+           images. A grating is cos(a*x + b*y + phase), which is
+           cos(a*x + phase)*cos(b*y) - sin(a*x + phase)*sin(b*y), and a
+           gaussian is exp(-(x-xCenter)^2/(2 sdx^2)) * exp(-(y-yCenter)^2/
+           (2 sdy^2)). So cos, sin and exp are only computed once for each
+           column and once for each row, and each pixel takes a couple of
+           multiplies and an add, in loops that the compiler vectorizes.
+           This is both faster and more accurate than approximating cos
+           and exp for every pixel.
+
+           Images are made a line at a time (columns, or rows for the
+           uint8 format, whichever is contiguous in the output), so that
+           any range of lines of any image can be made independently of
+           the others, on as many threads as there are.
+
+           Output formats are:
+             double or single: height x width, values like mglMakeGrating
+             rgba: single height x width x 4, in 0-1, as mglCreateTexture
+                   and mglMetalCreateTexture take
+             uint8: uint8 4 x width x height rgba, in 0-255, the
+                   preformatted layout that mglCreateTexture takes
+           with one such image for each image of a family. In rgba and
+           uint8, values v of gratings, plaids and gabors are shown as
+           (v+1)/2 and gaussians as v, with alpha 1. With alphaMask, a
+           gabor is instead the grating with the gaussian as its alpha.
+
+           This is plain C with no Matlab dependencies.
+
+=========================================================================
+#endif
+
+#ifndef MGL_STIMULUS_IMAGE_H
+#define MGL_STIMULUS_IMAGE_H
+
+/////////////////////////
+//   include section   //
+/////////////////////////
+#include <math.h>
+#include <stdint.h>
+#include <stddef.h>
+
+//////////////////////
+//   define section //
+//////////////////////
+#define MGL_STIMULUS_GRATING 0
+#define MGL_STIMULUS_GAUSSIAN 1
+#define MGL_STIMULUS_GABOR 2
+#define MGL_STIMULUS_PLAID 3
+
+#define MGL_STIMULUS_FORMAT_DOUBLE 0
+#define MGL_STIMULUS_FORMAT_SINGLE 1
+#define MGL_STIMULUS_FORMAT_RGBA 2
+#define MGL_STIMULUS_FORMAT_UINT8 3
+
+// gaussians are clamped to 0 below this, as mglMakeGaussian does, so they fade completely to gray
+#define MGL_STIMULUS_GAUSSIAN_CLAMP 0.01
+
+// tables of values along a line, and the line itself, for mglStimulusImageLines
+#define MGL_STIMULUS_SCRATCH_LINES 7
+
+typedef struct {
+  int type;
+  int format;
+  int alphaMask;
+  // size in pixels, and coordinates in degrees of the first pixel and between pixels
+  size_t width;
+  size_t height;
+  double xStart;
+  double xStep;
+  double yStart;
+  double yStep;
+  // grating, in cycles/degree and degrees as for mglMakeGrating, where angle 0 is horizontal.
+  // A family of images has an angle and a phase for each image (or one for all).
+  double sf;
+  double contrast;
+  const double *angles;
+  size_t nAngles;
+  const double *phases;
+  size_t nPhases;
+  // a plaid adds a second grating at this many degrees from the first
+  double plaidAngle;
+  // gaussian, in degrees as for mglMakeGaussian
+  double sdx;
+  double sdy;
+  double xCenter;
+  double yCenter;
+  // the output, laid out as above for nImages images
+  size_t nImages;
+  void *output;
+} mglStimulusImage;
+
+////////////////////////////////////
+//   mglStimulusImageLineCount    //
+////////////////////////////////////
+// Number of lines in each image: columns, or rows for uint8 where rows are contiguous.
+static inline size_t mglStimulusImageLineCount(const mglStimulusImage *s)
+{
+  return (s->format == MGL_STIMULUS_FORMAT_UINT8) ? s->height : s->width;
+}
+
+/////////////////////////////////////
+//   mglStimulusImageScratchSize   //
+/////////////////////////////////////
+// Number of doubles of scratch space that mglStimulusImageLines needs.
+static inline size_t mglStimulusImageScratchSize(const mglStimulusImage *s)
+{
+  size_t longest = (s->width > s->height) ? s->width : s->height;
+  return MGL_STIMULUS_SCRATCH_LINES * longest;
+}
+
+/////////////////////////////////////
+//   mglStimulusImageGratingTable  //
+/////////////////////////////////////
+// cos and sin of k*coordinate + phase along an axis, for one grating component.
+static inline void mglStimulusImageGratingTable(double k, double phase, double start, double step, size_t n, double *cosTable, double *sinTable)
+{
+  for (size_t i = 0; i < n; i++) {
+    double t = k * (start + step * i) + phase;
+    cosTable[i] = cos(t);
+    sinTable[i] = sin(t);
+  }
+}
+
+//////////////////////////////////////
+//   mglStimulusImageGaussianTable  //
+//////////////////////////////////////
+static inline void mglStimulusImageGaussianTable(double center, double sd, double start, double step, size_t n, double *table)
+{
+  double scale = 1.0 / (2 * sd * sd);
+  for (size_t i = 0; i < n; i++) {
+    double d = start + step * i - center;
+    table[i] = exp(-d * d * scale);
+  }
+}
+
+///////////////////////////////
+//   mglStimulusImageLines   //
+///////////////////////////////
+// Make nLines lines of one image of the family, starting at firstLine. scratch needs to hold
+// mglStimulusImageScratchSize doubles. Different images and lines can be made at the same time
+// on different threads, each with its own scratch.
+static inline void mglStimulusImageLines(const mglStimulusImage *s, size_t image, size_t firstLine, size_t nLines, double *scratch)
+{
+  // lines are columns (running along y) unless the format is uint8
+  int linesAreColumns = (s->format != MGL_STIMULUS_FORMAT_UINT8);
+  size_t lineLength = linesAreColumns ? s->height : s->width;
+  double innerStart = linesAreColumns ? s->yStart : s->xStart;
+  double innerStep = linesAreColumns ? s->yStep : s->xStep;
+  double outerStart = linesAreColumns ? s->xStart : s->yStart;
+  double outerStep = linesAreColumns ? s->xStep : s->yStep;
+
+  // scratch is tables along the line for up to two grating components and the gaussian, then the line and its gaussian
+  double *cos1 = scratch;
+  double *sin1 = cos1 + lineLength;
+  double *cos2 = sin1 + lineLength;
+  double *sin2 = cos2 + lineLength;
+  double *gauss = sin2 + lineLength;
+  double *line = gauss + lineLength;
+  double *mask = line + lineLength;
+
+  int hasGrating = (s->type != MGL_STIMULUS_GAUSSIAN);
+  int hasGaussian = (s->type == MGL_STIMULUS_GAUSSIAN) || (s->type == MGL_STIMULUS_GABOR);
+  int hasPlaid = (s->type == MGL_STIMULUS_PLAID);
+
+  // grating wave vectors, with angle 0 horizontal and phase in radians as in mglMakeGrating.
+  // The phase goes with the outer axis, and the inner axis tables have none.
+  double angle = s->angles[(s->nAngles > 1) ? image : 0];
+  double phase = M_PI * s->phases[(s->nPhases > 1) ? image : 0] / 180;
+  double kInner[2], kOuter[2];
+  for (int component = 0; component < 2; component++) {
+    double componentAngle = M_PI * (angle - 90 + component * s->plaidAngle) / 180;
+    double a = cos(componentAngle) * s->sf * 2 * M_PI;
+    double b = sin(componentAngle) * s->sf * 2 * M_PI;
+    kInner[component] = linesAreColumns ? b : a;
+    kOuter[component] = linesAreColumns ? a : b;
+  }
+  if (hasGrating)
+    mglStimulusImageGratingTable(kInner[0], 0, innerStart, innerStep, lineLength, cos1, sin1);
+  if (hasPlaid)
+    mglStimulusImageGratingTable(kInner[1], 0, innerStart, innerStep, lineLength, cos2, sin2);
+  if (hasGaussian)
+    mglStimulusImageGaussianTable(linesAreColumns ? s->yCenter : s->xCenter, linesAreColumns ? s->sdy : s->sdx, innerStart, innerStep, lineLength, gauss);
+  double outerCenter = linesAreColumns ? s->xCenter : s->yCenter;
+  double outerScale = 1.0 / (2 * (linesAreColumns ? s->sdx : s->sdy) * (linesAreColumns ? s->sdx : s->sdy));
+
+  // gratings are shown around gray, and alpha is 1 unless it is the gaussian mask
+  int maskInAlpha = s->alphaMask && (s->type == MGL_STIMULUS_GABOR);
+  double grayOffset = (s->type == MGL_STIMULUS_GAUSSIAN) ? 0 : 1;
+  double grayScale = (s->type == MGL_STIMULUS_GAUSSIAN) ? 1 : 0.5;
+  size_t pixelsPerImage = s->width * s->height;
+
+  for (size_t lineIndex = firstLine; lineIndex < firstLine + nLines; lineIndex++) {
+    // values along the outer axis are the same for the whole line
+    double outer = outerStart + outerStep * lineIndex;
+    double outerCos1 = cos(kOuter[0] * outer + phase), outerSin1 = sin(kOuter[0] * outer + phase);
+    double outerCos2 = cos(kOuter[1] * outer + phase), outerSin2 = sin(kOuter[1] * outer + phase);
+    double outerGauss = exp(-(outer - outerCenter) * (outer - outerCenter) * outerScale);
+    double contrast = hasPlaid ? s->contrast / 2 : s->contrast;
+
+    // the line, as mglMakeGrating or mglMakeGaussian would make it
+    size_t i;
+    if (hasGrating) {
+      for (i = 0; i < lineLength; i++)
+        line[i] = contrast * (outerCos1 * cos1[i] - outerSin1 * sin1[i]);
+      if (hasPlaid) {
+        for (i = 0; i < lineLength; i++)
+          line[i] += contrast * (outerCos2 * cos2[i] - outerSin2 * sin2[i]);
+      }
+    }
+    if (hasGaussian) {
+      // clamped gaussian, multiplied into the grating unless it is kept for alpha
+      for (i = 0; i < lineLength; i++) {
+        double g = outerGauss * gauss[i];
+        mask[i] = (g < MGL_STIMULUS_GAUSSIAN_CLAMP) ? 0 : g;
+      }
+      if (!hasGrating) {
+        for (i = 0; i < lineLength; i++)
+          line[i] = mask[i];
+      }
+      else if (!maskInAlpha) {
+        for (i = 0; i < lineLength; i++)
+          line[i] *= mask[i];
+      }
+    }
+
+    // store it
+    switch (s->format) {
+      case MGL_STIMULUS_FORMAT_DOUBLE: {
+        double *out = (double *)s->output + image * pixelsPerImage + lineIndex * lineLength;
+        for (i = 0; i < lineLength; i++)
+          out[i] = line[i];
+        break;
+      }
+      case MGL_STIMULUS_FORMAT_SINGLE: {
+        float *out = (float *)s->output + image * pixelsPerImage + lineIndex * lineLength;
+        for (i = 0; i < lineLength; i++)
+          out[i] = (float)line[i];
+        break;
+      }
+      case MGL_STIMULUS_FORMAT_RGBA: {
+        // four planes of height x width
+        float *out = (float *)s->output + 4 * image * pixelsPerImage + lineIndex * lineLength;
+        for (i = 0; i < lineLength; i++) {
+          float value = (float)((line[i] + grayOffset) * grayScale);
+          out[i] = value;
+          out[pixelsPerImage + i] = value;
+          out[2 * pixelsPerImage + i] = value;
+          out[3 * pixelsPerImage + i] = maskInAlpha ? (float)mask[i] : 1.0f;
+        }
+        break;
+      }
+      case MGL_STIMULUS_FORMAT_UINT8: {
+        // rgba interleaved, a row at a time
+        uint8_t *out = (uint8_t *)s->output + 4 * (image * pixelsPerImage + lineIndex * lineLength);
+        for (i = 0; i < lineLength; i++) {
+          uint8_t value = (uint8_t)(255 * (line[i] + grayOffset) * grayScale + 0.5);
+          out[4 * i] = value;
+          out[4 * i + 1] = value;
+          out[4 * i + 2] = value;
+          out[4 * i + 3] = maskInAlpha ? (uint8_t)(255 * mask[i] + 0.5) : 255;
+        }
+        break;
+      }
+    }
+  }
+}
+
+#endif
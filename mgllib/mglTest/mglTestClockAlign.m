@@ -0,0 +1,89 @@
+% mglTestClockAlign.m
+%
+%      usage: mglTestClockAlign(<nSamples>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: test mglClockAlign with synthetic drifting clocks: a
+%             nanosecond clock that runs 40 ppm fast, sampled with 50us
+%             of jitter on the host side and with 5% of samples delayed
+%             by several ms, as if by a context switch. Checks that the
+%             fit finds the drift, rejects the delayed samples, converts
+%             back and forth to within the jitter, and starts over when
+%             the clock is reset. Does not need a display or any device.
+%
+%             mglTestClockAlign(2000);
+%
+function retval = mglTestClockAlign(nSamples)
+
+% check arguments
+retval = [];
+if ~any(nargin == [0 1])
+  help mglTestClockAlign
+  return
+end
+if ieNotDefined('nSamples'),nSamples = 2000;end
+
+% check that the native version is compiled
+if exist('mglClockAlign')~=3
+  disp(sprintf('(mglTestClockAlign) mglClockAlign is not compiled. Run mglMakeMetal'));
+  return
+end
+
+% save the random state so we can put it back
+randState = rng;
+rng(0,'twister');
+
+% the true clocks: host time sampled about every half second, and a
+% nanosecond clock that started at some arbitrary count and runs fast
+driftPPM = 40;
+jitter = 50e-6;
+hostTimes = 1000 + cumsum(0.5+0.1*rand(1,nSamples));
+clockTimes = 7e12 + (hostTimes-hostTimes(1))*(1+driftPPM*1e-6)*1e9;
+
+% measured host times have jitter, and some are delayed a lot
+measuredHostTimes = hostTimes + jitter*randn(1,nSamples);
+isDelayed = rand(1,nSamples) < 0.05;
+measuredHostTimes(isDelayed) = measuredHostTimes(isDelayed) + 0.002 + 0.01*rand(1,sum(isDelayed));
+
+% add the samples a few at a time, as they would come in
+mglClockAlign('create','synthetic',1e-9);
+for iSample = 1:10:nSamples
+  samples = iSample:min(iSample+9,nSamples);
+  info = mglClockAlign('add','synthetic',clockTimes(samples),measuredHostTimes(samples));
+end
+
+% check the fit
+retval = true;
+retval = checkValue(retval,'drift (ppm)',info.driftPPM,driftPPM,0.5);
+retval = checkValue(retval,'rejected samples',info.nRejected,sum(isDelayed),0.1*sum(isDelayed));
+retval = checkValue(retval,'spread (s)',info.spread,jitter,0.5*jitter);
+
+% convert the last couple of minutes of clock times in bulk, they
+% should come out within the jitter of the true host times
+recent = hostTimes > (hostTimes(end)-120);
+convertedHostTimes = mglClockAlign('toHost','synthetic',clockTimes(recent));
+retval = checkValue(retval,'max conversion error (s)',max(abs(convertedHostTimes-hostTimes(recent))),0,2*jitter);
+retval = checkValue(retval,'round trip error (ns)',max(abs(mglClockAlign('fromHost','synthetic',convertedHostTimes)-clockTimes(recent))),0,1);
+
+% reset the clock, as if the device was reopened, the fit should start over
+lastHostTime = hostTimes(end);
+newHostTimes = lastHostTime + (1:20)*0.5;
+newClockTimes = (newHostTimes-lastHostTime)*(1+driftPPM*1e-6)*1e9;
+mglClockAlign('add','synthetic',newClockTimes,newHostTimes);
+retval = checkValue(retval,'error after clock reset (s)',mglClockAlign('toHost','synthetic',newClockTimes(end))-newHostTimes(end),0,2*jitter);
+
+mglClockAlign('reset','synthetic');
+rng(randState);
+
+%%%%%%%%%%%%%%%%%%%%
+%    checkValue    %
+%%%%%%%%%%%%%%%%%%%%
+function retval = checkValue(retval,name,value,expected,tolerance)
+
+if abs(value-expected) <= tolerance
+  disp(sprintf('(mglTestClockAlign) %s: %g (expected %g) OK',name,value,expected));
+else
+  disp(sprintf('(mglTestClockAlign) %s: %g (expected %g +/- %g) FAILED',name,value,expected,tolerance));
+  retval = false;
+end
@@ -0,0 +1,81 @@
+% mglTestDotMotion.m
+%
+%      usage: mglTestDotMotion(<nFrames>,<nPoints>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: test that the dot motion that mglMetal runs for
+%             mglMetalRepeatingDotMotion (checked here through
+%             mglPrivateDotMotion) moves the dots the same way that
+%             dotMotionFrame does when started from the same random seed,
+%             and time how long a frame takes
+%
+%             mglTestDotMotion(60,1000);
+%
+function retval = mglTestDotMotion(nFrames,nPoints)
+
+% check arguments
+retval = [];
+if ~any(nargin == [0 1 2])
+  help mglTestDotMotion
+  return
+end
+if ieNotDefined('nFrames'),nFrames = 60;end
+if ieNotDefined('nPoints'),nPoints = 1000;end
+
+% check that the native version is compiled
+if exist('mglPrivateDotMotion')~=3
+  disp(sprintf('(mglTestDotMotion) mglPrivateDotMotion is not compiled. Run mglMakeMetal'));
+  return
+end
+
+% display parameters, with a short lifetime and fast dots so that
+% dots die and go out of range during the test
+displayParams.frameRate = 60;
+displayParams.deviceRect = [-10 -7.5 10 7.5];
+stimParams.nPoints = nPoints;
+stimParams.speed = 20;
+stimParams.lifetime = 10;
+stimParams.spatial.origin = [1 -1];
+
+% save the random state so we can put it back
+randState = rng;
+
+% check each type of motion at a few coherences
+retval = true;
+seed = 0;
+for coherentMotionType = {'expanding','contracting','translating','rotating'}
+  for incoherentMotionType = {'random','brownian','movshon'}
+    for coherence = [0 0.5 1]
+      stimParams.coherentMotionType = coherentMotionType{1};
+      stimParams.incoherentMotionType = incoherentMotionType{1};
+      stimParams.coherence = coherence;
+      stimParams.direction = [0 pi/3];
+      % run dotMotionFrame
+      seed = seed+1;
+      rng(seed,'twister');
+      coords = [];direction = [];lifetime = [];
+      for iFrame = 1:nFrames
+        [coords direction lifetime] = dotMotionFrame(coords,direction,lifetime,stimParams,[],displayParams);
+      end
+      % and the native version
+      [nativeCoords nativeDirection nativeLifetime] = mglPrivateDotMotion(stimParams,displayParams,nFrames,seed);
+      if (max(abs(coords(:)-reshape(nativeCoords(:,:,end),[],1))) > 1e-9) || (max(abs(direction-nativeDirection(:,end))) > 1e-9) || ~isequal(lifetime,nativeLifetime(:,end))
+        disp(sprintf('(mglTestDotMotion) %s/%s motion at coherence %0.1f does not match dotMotionFrame',coherentMotionType{1},incoherentMotionType{1},coherence));
+        retval = false;
+      end
+    end
+  end
+end
+
+% time a frame of each
+stimParams.coherentMotionType = 'translating';
+stimParams.incoherentMotionType = 'random';
+stimParams.coherence = 0.5;
+rng(seed,'twister');
+coords = [];direction = [];lifetime = [];
+tic;for iFrame = 1:nFrames,[coords direction lifetime] = dotMotionFrame(coords,direction,lifetime,stimParams,[],displayParams);end;matlabTime = toc;
+tic;mglPrivateDotMotion(stimParams,displayParams,nFrames,seed);nativeTime = toc;
+disp(sprintf('(mglTestDotMotion) %i dots: %0.4f ms/frame (dotMotionFrame: %0.4f ms/frame)',nPoints,1000*nativeTime/nFrames,1000*matlabTime/nFrames));
+
+rng(randState);
@@ -0,0 +1,76 @@
+% mglTestInstancedArcs.m
+%
+%      usage: mglTestInstancedArcs(<nArcs>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: test that drawing arcs as instances, with the vertex_arcs
+%             shader reading one record per arc, gives the shader the same
+%             vertices that mglArcsCommand used to make by copying each
+%             record into 6 vertices (checked here on the CPU with
+%             mglPrivateExpandArcs), and compare how much is uploaded
+%
+%             mglTestInstancedArcs(5000);
+%
+function retval = mglTestInstancedArcs(nArcs)
+
+% check arguments
+retval = [];
+if ~any(nargin == [0 1])
+  help mglTestInstancedArcs
+  return
+end
+if ieNotDefined('nArcs'),nArcs = 5000;end
+
+% check that the native version is compiled
+if exist('mglPrivateExpandArcs')~=3
+  disp(sprintf('(mglTestInstancedArcs) mglPrivateExpandArcs is not compiled. Run mglMakeMetal'));
+  return
+end
+
+% make up some annulus segments, as mglMetalArcs would send them
+xyz = [rand(2,nArcs)*20-10;zeros(1,nArcs)];
+rgba = rand(4,nArcs);
+innerRadius = rand(1,nArcs)*2;
+outerRadius = innerRadius+rand(1,nArcs)*2;
+radii = [innerRadius;outerRadius;innerRadius*1.1;outerRadius*1.1];
+wedge = [rand(1,nArcs)*2*pi;rand(1,nArcs)*pi];
+border = rand(1,nArcs)*0.1;
+records = single(cat(1,xyz,rgba,radii,wedge,border));
+viewportSize = [1920 1080];
+
+% expand them the old way, and as the shader does now
+retval = true;
+oldVertices = oldExpandArcs(records,viewportSize);
+vertices = mglPrivateExpandArcs(records,viewportSize);
+if ~isequal(vertices,oldVertices)
+  disp(sprintf('(mglTestInstancedArcs) Arcs expanded from records do not match the vertices mglArcsCommand used to make'));
+  retval = false;
+end
+
+% compare how much is uploaded per frame
+disp(sprintf('(mglTestInstancedArcs) %i arcs: %i bytes uploaded (was %i bytes)',nArcs,4*numel(records),4*numel(oldVertices)));
+
+%%%%%%%%%%%%%%%%%%%%%%%
+%    oldExpandArcs    %
+%%%%%%%%%%%%%%%%%%%%%%%
+function v = oldExpandArcs(records,viewportSize)
+
+% this is how mglArcsCommand copied each record into the corners of two triangles
+nArcs = size(records,2);
+v = zeros(19,6*nArcs,'single');
+for iArc = 1:nArcs
+  r = records(:,iArc);
+  x = r(1);y = r(2);
+  % radius is the outer radius + half the border
+  rX = r(9)+r(14)/2;
+  rY = r(11)+r(14)/2;
+  xLocs = [x-rX, x-rX, x+rX, x-rX, x+rX, x+rX];
+  yLocs = [y-rY, y+rY, y+rY, y-rY, y-rY, y+rY];
+  for iVertex = 1:6
+    thisVertex = [r;r(1);-r(2);r(3);single(viewportSize(:))];
+    thisVertex(1) = xLocs(iVertex);
+    thisVertex(2) = yLocs(iVertex);
+    v(:,(iArc-1)*6+iVertex) = thisVertex;
+  end
+end
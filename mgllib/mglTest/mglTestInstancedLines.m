@@ -0,0 +1,109 @@
+% mglTestInstancedLines.m
+%
+%      usage: mglTestInstancedLines(<nLines>,<nRepeats>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: test that the line records that mglMetalLines now sends
+%             expand (as mglMetal does, checked here on the CPU with
+%             mglPrivateExpandLines) to the same quads that mglMetalLines
+%             used to make in Matlab and send through mglQuad, and compare
+%             how many bytes are sent and how long it takes to pack them
+%
+%             mglTestInstancedLines(1000,100);
+%
+function retval = mglTestInstancedLines(nLines,nRepeats)
+
+% check arguments
+retval = [];
+if ~any(nargin == [0 1 2])
+  help mglTestInstancedLines
+  return
+end
+if ieNotDefined('nLines'),nLines = 1000;end
+if ieNotDefined('nRepeats'),nRepeats = 100;end
+
+% check that the native version is compiled
+if exist('mglPrivateExpandLines')~=3
+  disp(sprintf('(mglTestInstancedLines) mglPrivateExpandLines is not compiled. Run mglMakeMetal'));
+  return
+end
+
+% make up some lines, including one with no length and a vertical one
+x0 = rand(1,nLines)*10-5;y0 = rand(1,nLines)*10-5;
+x1 = rand(1,nLines)*10-5;y1 = rand(1,nLines)*10-5;
+x1(1) = x0(1);y1(1) = y0(1);
+x1(2) = x0(2);
+lineWidth = rand(1,nLines)*2;
+color = rand(3,nLines);
+
+% expand them the old way, and the new way
+quadVertices = oldExpandLines(x0,y0,x1,y1,lineWidth,color);
+records = newPackLines(x0,y0,x1,y1,lineWidth,color);
+vertices = double(mglPrivateExpandLines(records));
+
+% check that they match, to within the precision of single
+retval = true;
+if ~isequal(size(vertices),[7 6*nLines])
+  disp(sprintf('(mglTestInstancedLines) Expanded lines are the wrong size'));
+  retval = false;
+elseif (max(max(abs(vertices(1:3,:)-quadVertices(1:3,:)))) > 1e-4) || (max(max(abs(vertices(4:6,:)-quadVertices(4:6,:)))) > 1e-6) || any(vertices(7,:)~=1)
+  disp(sprintf('(mglTestInstancedLines) Expanded lines do not match the quads that mglMetalLines used to make'));
+  retval = false;
+end
+
+% check that rectangles come out with the right corners
+x = 1;y = 2;width = 4;height = 2;angle = 90;
+halfX = 0.5*width*cos(pi*angle/180);halfY = 0.5*width*sin(pi*angle/180);
+rectVertices = double(mglPrivateExpandLines([x-halfX;y-halfY;x+halfX;y+halfY;height;1;1;1;1]));
+if max(max(abs(sortrows(unique(round(rectVertices(1:2,:)'*1e4)/1e4,'rows'))-[0 0;0 4;2 0;2 4]))) > 1e-4
+  disp(sprintf('(mglTestInstancedLines) Rotated rectangle has the wrong corners'));
+  retval = false;
+end
+
+% compare bytes sent and time to pack them
+tic;for iRepeat = 1:nRepeats,oldExpandLines(x0,y0,x1,y1,lineWidth,color);end;oldTime = toc;
+tic;for iRepeat = 1:nRepeats,newPackLines(x0,y0,x1,y1,lineWidth,color);end;newTime = toc;
+disp(sprintf('(mglTestInstancedLines) %i lines: %i bytes in %0.4f ms (was %i bytes in %0.4f ms)',nLines,4*numel(records),1000*newTime/nRepeats,4*numel(quadVertices),1000*oldTime/nRepeats));
+
+%%%%%%%%%%%%%%%%%%%%%%%%
+%    oldExpandLines    %
+%%%%%%%%%%%%%%%%%%%%%%%%
+function v = oldExpandLines(x0,y0,x1,y1,lineWidth,color)
+
+% this is how mglMetalLines widened lines into quads
+deltaX = x1 - x0;
+deltaY = y1 - y0;
+angle = atan2(deltaY, deltaX);
+offsetX = 0.5 * lineWidth .* -sin(angle);
+offsetY = 0.5 * lineWidth .* cos(angle);
+quadX = cat(1, x0 + offsetX, x1 + offsetX, x1 - offsetX, x0 - offsetX);
+quadY = cat(1, y0 + offsetY, y1 + offsetY, y1 - offsetY, y0 - offsetY);
+
+% and how mglQuad made them into triangles
+nQuads = size(quadX, 2);
+v = zeros(6, nQuads * 6);
+for iQuad = 1:nQuads
+  v(1:2, iQuad * 6 - 5) = [quadX(1, iQuad), quadY(1, iQuad)];
+  v(4:6, iQuad * 6 - 5) = color(:, iQuad);
+  v(1:2, iQuad * 6 - 4) = [quadX(2, iQuad), quadY(2, iQuad)];
+  v(4:6, iQuad * 6 - 4) = color(:, iQuad);
+  v(1:2, iQuad * 6 - 3) = [quadX(3, iQuad), quadY(3, iQuad)];
+  v(4:6, iQuad * 6 - 3) = color(:, iQuad);
+  v(1:2, iQuad * 6 - 2) = [quadX(3, iQuad), quadY(3, iQuad)];
+  v(4:6, iQuad * 6 - 2) = color(:, iQuad);
+  v(1:2, iQuad * 6 - 1) = [quadX(4, iQuad), quadY(4, iQuad)];
+  v(4:6, iQuad * 6 - 1) = color(:, iQuad);
+  v(1:2, iQuad * 6) = [quadX(1, iQuad), quadY(1, iQuad)];
+  v(4:6, iQuad * 6) = color(:, iQuad);
+end
+v = single(v);
+
+%%%%%%%%%%%%%%%%%%%%%%
+%    newPackLines    %
+%%%%%%%%%%%%%%%%%%%%%%
+function records = newPackLines(x0,y0,x1,y1,lineWidth,color)
+
+% this is how mglMetalLines packs records now
+color(4,:) = 1;
+records = single(cat(1, x0(:)', y0(:)', x1(:)', y1(:)', lineWidth(:)', color));
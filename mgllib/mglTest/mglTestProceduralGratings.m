@@ -0,0 +1,95 @@
+% mglTestProceduralGratings.m
+%
+%      usage: mglTestProceduralGratings()
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: test that gratings and gabors drawn by
+%             mglMetalProceduralGratings (checked here on the CPU with
+%             mglPrivateProceduralGratings, which draws them the way
+%             mglMetal does) look the same as textures made with
+%             mglMakeGrating and mglMakeGaussian would when blted, and
+%             compare how many bytes each sends per frame. Does not need
+%             a display.
+%
+%             mglTestProceduralGratings;
+%
+function retval = mglTestProceduralGratings()
+
+% check arguments
+retval = [];
+if ~any(nargin == [0])
+  help mglTestProceduralGratings
+  return
+end
+
+% check that the native version is compiled
+if exist('mglPrivateProceduralGratings')~=3
+  disp(sprintf('(mglTestProceduralGratings) mglPrivateProceduralGratings is not compiled. Run mglMakeMetal'));
+  return
+end
+
+% a stimulus like the one in taskTemplateStaircase, with an odd angle and
+% phase so nothing lines up by accident. Values are exact in single, so
+% only the computation differs. width*xDeg2pix and height*yDeg2pix are
+% even, so that mglMakeGrating samples at pixel centers of the screen
+width = 8;height = 6;sf = 1.5;angle = 37;phase = 123;contrast = 0.75;
+sdx = 1.25;sdy = 0.75;xDeg2pix = 40;yDeg2pix = 50;
+grating = mglMakeGrating(width,height,sf,angle,phase,xDeg2pix,yDeg2pix);
+gaussian = mglMakeGaussian(width,height,sdx,sdy,0,0,xDeg2pix,yDeg2pix);
+
+% the texture is shown one pixel bigger than width and height, since
+% mglMakeGrating has a sample at each edge
+[heightPixels widthPixels] = size(grating);
+shownWidth = widthPixels/xDeg2pix;shownHeight = heightPixels/yDeg2pix;
+x = 0.5;y = -1.5;
+frameArgs = {[x-shownWidth/2 y+shownHeight/2],[xDeg2pix yDeg2pix],[widthPixels heightPixels]};
+gray = [0.5 0.5 0.5 1];
+bound = 1e-6;
+
+% gabor, shown around gray
+retval = true;
+frame = mglPrivateProceduralGratings([x;y;shownWidth;shownHeight;sf;angle;phase;contrast;sdx;sdy;0],frameArgs{:},gray);
+expected = (contrast*grating.*gaussian+1)/2;
+retval = checkFrame(retval,'gabor',cat(3,expected,expected,expected,ones(size(expected))),frame,bound);
+
+% gabor with the gaussian in alpha, blended over gray
+frame = mglPrivateProceduralGratings([x;y;shownWidth;shownHeight;sf;angle;phase;contrast;sdx;sdy;1],frameArgs{:},gray);
+expected = ((contrast*grating+1)/2).*gaussian + 0.5*(1-gaussian);
+retval = checkFrame(retval,'masked gabor',cat(3,expected,expected,expected,gaussian.^2+1-gaussian),frame,bound);
+
+% grating with no envelope, in a frame with a margin that should be left
+% as the background
+margin = 5;
+frame = mglPrivateProceduralGratings([x;y;shownWidth;shownHeight;sf;angle;phase;contrast;0;0;0],[x-shownWidth/2-margin/xDeg2pix y+shownHeight/2+margin/yDeg2pix],[xDeg2pix yDeg2pix],[widthPixels heightPixels]+2*margin,[0 0 0 1]);
+expected = zeros(heightPixels+2*margin,widthPixels+2*margin);
+expected(margin+1:end-margin,margin+1:end-margin) = (contrast*grating+1)/2;
+alpha = ones(size(expected));
+retval = checkFrame(retval,'grating',cat(3,expected,expected,expected,alpha),frame,bound);
+
+% a vertical grating as a 1D texture, stretched over the height as
+% taskTemplateContrast10bit does
+frame = mglPrivateProceduralGratings([x;y;shownWidth;shownHeight;sf;90;phase;contrast;0;0;0],frameArgs{:},gray);
+expected = repmat((contrast*mglMakeGrating(width,nan,sf,0,phase,xDeg2pix,yDeg2pix)+1)/2,heightPixels,1);
+retval = checkFrame(retval,'1D grating',cat(3,expected,expected,expected,ones(size(expected))),frame,bound);
+
+% bytes sent for each frame of a drifting grating
+disp(sprintf('(mglTestProceduralGratings) %ix%i gabor: %i bytes per frame (texture was %i bytes)',widthPixels,heightPixels,4*11,4*4*widthPixels*heightPixels));
+
+%%%%%%%%%%%%%%%%%%%%
+%    checkFrame    %
+%%%%%%%%%%%%%%%%%%%%
+function retval = checkFrame(retval,name,expected,frame,bound)
+
+if ~isequal(size(expected),size(frame))
+  disp(sprintf('(mglTestProceduralGratings) %s is %s but should be %s FAILED',name,mat2str(size(frame)),mat2str(size(expected))));
+  retval = false;
+  return
+end
+maxError = max(abs(double(frame(:))-expected(:)));
+if maxError <= bound
+  disp(sprintf('(mglTestProceduralGratings) %s: max error %g OK',name,maxError));
+else
+  disp(sprintf('(mglTestProceduralGratings) %s: max error %g (bound %g) FAILED',name,maxError,bound));
+  retval = false;
+end
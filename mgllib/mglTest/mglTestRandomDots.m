@@ -0,0 +1,75 @@
+% mglTestRandomDots.m
+%
+%      usage: mglTestRandomDots(<nDots>,<nRepeats>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: test that the random dots that mglMetal makes for
+%             mglMetalRepeatingDots (checked here through
+%             mglPrivateRandomDots) come out the same for a given seed
+%             however many threads make them, and time how many dots
+%             are made per ms
+%
+%             mglTestRandomDots(100000,100);
+%
+function retval = mglTestRandomDots(nDots,nRepeats)
+
+% check arguments
+retval = [];
+if ~any(nargin == [0 1 2])
+  help mglTestRandomDots
+  return
+end
+if ieNotDefined('nDots'),nDots = 100000;end
+if ieNotDefined('nRepeats'),nRepeats = 100;end
+
+% check that the native version is compiled
+if exist('mglPrivateRandomDots')~=3
+  disp(sprintf('(mglTestRandomDots) mglPrivateRandomDots is not compiled. Run mglMakeMetal'));
+  return
+end
+
+% check that the dots do not depend on the number of threads
+retval = true;
+seed = 42;frame = 3;
+dots = mglPrivateRandomDots(nDots,seed,frame,1);
+for nThreads = [2 3 7 16]
+  if ~isequal(dots,mglPrivateRandomDots(nDots,seed,frame,nThreads))
+    disp(sprintf('(mglTestRandomDots) Dots made with %i threads do not match dots made with 1 thread',nThreads));
+    retval = false;
+  end
+end
+
+% check that any range of dots matches the same dots made all together
+partDots = mglPrivateRandomDots(nDots-1,seed,frame,5);
+if ~isequal(partDots,dots(:,1:nDots-1))
+  disp(sprintf('(mglTestRandomDots) Dots made in a different number do not match'));
+  retval = false;
+end
+
+% check that different frames and seeds give different dots
+if isequal(dots,mglPrivateRandomDots(nDots,seed,frame+1)) || isequal(dots,mglPrivateRandomDots(nDots,seed+1,frame))
+  disp(sprintf('(mglTestRandomDots) Dots for different frames or seeds are the same'));
+  retval = false;
+end
+
+% check the ranges and that xy and rgb look uniform
+xy = dots(1:2,:);rgb = dots(4:6,:);
+if any(xy(:) < -1) || any(xy(:) >= 1) || any(rgb(:) < 0) || any(rgb(:) >= 1)
+  disp(sprintf('(mglTestRandomDots) Dots are out of range'));
+  retval = false;
+end
+if any(abs(mean(xy,2)) > 0.02) || any(abs(mean(rgb,2)-0.5) > 0.01) || any(abs(var(rgb,0,2)-1/12) > 0.005)
+  disp(sprintf('(mglTestRandomDots) Dots do not look uniform'));
+  retval = false;
+end
+if ~isequal(dots([3 7:11],:),repmat(single([0 1 1 1 0 0]'),1,nDots))
+  disp(sprintf('(mglTestRandomDots) Fixed dot values are wrong'));
+  retval = false;
+end
+
+% time it with different numbers of threads
+for nThreads = [1 2 4 8]
+  tic;for iRepeat = 1:nRepeats,mglPrivateRandomDots(nDots,seed,iRepeat,nThreads);end;elapsedTime = toc;
+  disp(sprintf('(mglTestRandomDots) %i threads: %0.0f dots/ms',nThreads,nDots*nRepeats/(1000*elapsedTime)));
+end
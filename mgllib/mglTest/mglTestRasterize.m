@@ -0,0 +1,120 @@
+% mglTestRasterize.m
+%
+%      usage: mglTestRasterize(<compareToDisplay>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: test that mglRasterize draws frames of clear colors,
+%             polygons, quads, dots, ovals and textures in visual angle
+%             coordinates, that uint8 frames are the single ones rounded,
+%             that frames do not depend on the number of threads, and
+%             that commands it can not draw give an empty result. With
+%             compareToDisplay set, also draws the same frames with
+%             mglMetal and mglFrameGrab, and reports how many pixels are
+%             different, which should only be a few on the edges of
+%             ovals and in linearly filtered textures.
+%
+%             mglTestRasterize(true);
+%
+function retval = mglTestRasterize(compareToDisplay)
+
+% check arguments
+retval = [];
+if ~any(nargin == [0 1])
+  help mglTestRasterize
+  return
+end
+if ieNotDefined('compareToDisplay'),compareToDisplay = false;end
+
+% check that the native version is compiled
+if exist('mglPrivateRasterize')~=3
+  disp(sprintf('(mglTestRasterize) mglPrivateRasterize is not compiled. Run mglMakeMetal'));
+  return
+end
+
+retval = true;
+width = 80;height = 60;
+
+% frames of clear colors, with nothing else drawn
+mglRasterize('open',width,height);
+mglClearScreen([1 0 0]);mglFlush;
+mglClearScreen([0 0.25 0.75]);mglFlush;
+frames = mglRasterize('close');
+retval = check(retval,'number of frames',isequal(size(frames),[height width 4 2]));
+retval = check(retval,'clear colors',isequal(squeeze(frames(1,1,:,:)),single([1 0;0 0.25;0 0.75;1 1])));
+
+% a scene drawn with and without threads, and as uint8
+[frames,nFrames] = drawScene(width,height,[],'single');
+retval = check(retval,'number of scene frames',size(frames,4) == nFrames);
+retval = check(retval,'threads',isequal(frames,drawScene(width,height,1,'single')));
+retval = check(retval,'uint8',isequal(drawScene(width,height,[],'uint8'),uint8(round(frames*255))));
+
+% the oval is white in the middle and the polygon gray over the left half
+retval = check(retval,'oval',isequal(squeeze(frames(height/2,width/2+2,1:3,1)),single([1;1;1])));
+retval = check(retval,'polygon',all(all(frames(:,1:width/2-1,1,2) == single(0.5))));
+
+% lines are not drawn on the CPU, so the frames are empty
+mglRasterize('open',width,height);
+mglLines2(-1,-1,1,1,1,[1 1 1]);
+mglFlush;
+disp(sprintf('(mglTestRasterize) Expect a message about mglLine'));
+retval = check(retval,'lines not drawn',isempty(mglRasterize('close')));
+
+% compare with what mglMetal draws
+if compareToDisplay
+  mglOpen(0,width,height);
+  mglFrameGrab('init');
+  displayFrames = drawScene(width,height,[],'single',true);
+  mglFrameGrab('end');
+  mglClose;
+  differentPixels = squeeze(sum(sum(any(abs(displayFrames-frames) > 1.5/255,3),1),2));
+  disp(sprintf('(mglTestRasterize) Pixels different from mglMetal in each frame: %s',num2str(differentPixels(:)')));
+  retval = check(retval,'same as display',all(differentPixels <= 0.02*width*height));
+end
+
+if retval
+  disp(sprintf('(mglTestRasterize) All OK'));
+end
+
+%%%%%%%%%%%%%%%%%%%
+%    drawScene    %
+%%%%%%%%%%%%%%%%%%%
+% a few frames in visual angle coordinates, drawn with mglRasterize, or
+% with mglMetal and grabbed if onDisplay
+function [frames,nFrames] = drawScene(width,height,nThreads,format,onDisplay)
+
+if nargin < 5,onDisplay = false;end
+if ~onDisplay,mglRasterize('open',width,height);end
+mglVisualAngleCoordinates(57,[16 12]);
+texture = mglCreateTexture(cat(3,repmat(linspace(0,1,8),8,1),zeros(8,8),ones(8,8),0.5*ones(8,8)));
+
+nFrames = 3;
+frames = [];
+for iFrame = 1:nFrames
+  mglClearScreen(0);
+  mglFillOval(0,0,[6 6],[1 1 1]);
+  if iFrame >= 2
+    mglPolygon([-8 0 0 -8],[-6 -6 6 6],0.5);
+  end
+  if iFrame >= 3
+    mglQuad([2;6;6;2],[2;2;5;5],[0;1;0]);
+    mglPoints2(-4+(0:3),3*ones(1,4),3,[0 0 1]);
+    mglBltTexture(texture,[4 -3 4 3]);
+  end
+  mglFlush;
+  if onDisplay
+    frames(:,:,:,iFrame) = mglFrameGrab;
+  end
+end
+mglDeleteTexture(texture);
+if ~onDisplay,frames = mglRasterize('close',format,nThreads);end
+
+%%%%%%%%%%%%%%%
+%    check    %
+%%%%%%%%%%%%%%%
+function retval = check(retval,name,ok)
+
+if ~ok
+  disp(sprintf('(mglTestRasterize) %s is wrong',name));
+  retval = false;
+end
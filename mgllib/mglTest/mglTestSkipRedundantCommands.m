@@ -0,0 +1,122 @@
+% mglTestSkipRedundantCommands.m
+%
+%      usage: mglTestSkipRedundantCommands(<nCommands>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: test that skipping redundant commands (see
+%             mglMetalSkipRedundantCommands) does not change what is drawn.
+%             Makes up a random stream of commands that set mglMetal state,
+%             draws, display list calls and recordings, sent to one or two
+%             mglMetal windows. Applies the whole stream, and the stream
+%             left after mglPrivateShadowState skips commands, to a model
+%             of the state each mglMetal keeps, and checks that the two
+%             have the same state every time something is drawn. Does not
+%             need mglMetal, so it can run anywhere.
+%
+%             mglTestSkipRedundantCommands(10000);
+%
+function retval = mglTestSkipRedundantCommands(nCommands)
+
+% check arguments
+retval = [];
+if ~any(nargin == [0 1])
+  help mglTestSkipRedundantCommands
+  return
+end
+if ieNotDefined('nCommands'),nCommands = 10000;end
+
+% values that each command can send, few enough that repeats are common
+commandNames = {'mglSetXform','mglSetClearColor','mglSelectStencil','mglSetRenderTarget','mglSetViewColorPixelFormat'};
+fieldNames = {'xform','clearColor','stencil','renderTarget','pixelFormat'};
+values{1} = {single(eye(4)),single(diag([0.1 0.1 1 1])),single([eye(3) zeros(3,1);0.2 0 0 1]')};
+values{2} = {single([0;0;0]),single([0.5;0.5;0.5]),single([1;0;0])};
+values{3} = {uint32(0),uint32(1),uint32(2)};
+values{4} = {uint32(0),uint32(3)};
+values{5} = {uint32(0),uint32(4)};
+socketSets = {3,[3 4]};
+
+% make up the stream, weighted towards setting state and drawing
+rand('seed',0);
+kinds = {'set','set','set','set','draw','draw','call','record'};
+shadowState = [];
+[~, shadowState] = mglPrivateShadowState(shadowState, 'invalidate', [], []);
+fullState = emptyState(fieldNames);
+skipState = emptyState(fieldNames);
+recording = false;
+retval = true;
+nDraws = 0;
+for iCommand = 1:nCommands
+  descriptors = socketSets{ceil(rand*length(socketSets))};
+  % while recording, stay on the same sockets
+  if recording, descriptors = recordingDescriptors; end
+  switch kinds{ceil(rand*length(kinds))}
+    case 'set'
+      iField = ceil(rand*length(fieldNames));
+      value = values{iField}{ceil(rand*length(values{iField}))};
+      [skip, shadowState] = mglPrivateShadowState(shadowState, commandNames{iField}, value, descriptors);
+      % recorded commands do not change state when they are sent
+      if ~recording
+        fullState = setState(fullState, descriptors, fieldNames{iField}, value);
+        if ~skip
+          skipState = setState(skipState, descriptors, fieldNames{iField}, value);
+        end
+      end
+    case 'draw'
+      % everything drawn should see the same state
+      if ~recording
+        nDraws = nDraws+1;
+        for iDescriptor = descriptors
+          if ~isequal(fullState(iDescriptor),skipState(iDescriptor))
+            disp(sprintf('(mglTestSkipRedundantCommands) State differs at command %i for socket %i',iCommand,iDescriptor));
+            retval = false;
+            return
+          end
+        end
+      end
+    case 'call'
+      % calling a display list can set any state behind our back
+      if ~recording
+        [~, shadowState] = mglPrivateShadowState(shadowState, 'invalidate', [], descriptors);
+        iField = ceil(rand*length(fieldNames));
+        value = values{iField}{ceil(rand*length(values{iField}))};
+        fullState = setState(fullState, descriptors, fieldNames{iField}, value);
+        skipState = setState(skipState, descriptors, fieldNames{iField}, value);
+      end
+    case 'record'
+      % start or finish recording a display list
+      if recording
+        [~, shadowState] = mglPrivateShadowState(shadowState, 'resume', [], descriptors);
+      else
+        [~, shadowState] = mglPrivateShadowState(shadowState, 'suspend', [], descriptors);
+        recordingDescriptors = descriptors;
+      end
+      recording = ~recording;
+  end
+end
+
+% report how much was skipped
+for iCommand = 1:length(commandNames)
+  disp(sprintf('(mglTestSkipRedundantCommands) %s: skipped %i of %i',commandNames{iCommand},shadowState.skipCount.(commandNames{iCommand}),shadowState.skipCount.(commandNames{iCommand})+shadowState.sendCount.(commandNames{iCommand})));
+end
+disp(sprintf('(mglTestSkipRedundantCommands) %i draws checked',nDraws));
+
+%%%%%%%%%%%%%%%%%%%%
+%    emptyState    %
+%%%%%%%%%%%%%%%%%%%%
+function state = emptyState(fieldNames)
+
+% state of each mglMetal, indexed by socket descriptor, starting out unset
+for iField = 1:length(fieldNames)
+  s.(fieldNames{iField}) = [];
+end
+state = repmat(s,1,4);
+
+%%%%%%%%%%%%%%%%%%
+%    setState    %
+%%%%%%%%%%%%%%%%%%
+function state = setState(state, descriptors, fieldName, value)
+
+for iDescriptor = descriptors
+  state(iDescriptor).(fieldName) = value;
+end
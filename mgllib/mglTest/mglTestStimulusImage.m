@@ -0,0 +1,130 @@
+% mglTestStimulusImage.m
+%
+%      usage: mglTestStimulusImage(<nImages>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: test that mglMakeStimulusImage makes the same gratings,
+%             gaussians and gabors as mglMakeGrating and mglMakeGaussian,
+%             to within a bound for each format, that a family of images
+%             is the same as making each image on its own, that the
+%             images do not depend on the number of threads, and time it
+%             against the Matlab functions. Does not need a display.
+%
+%             mglTestStimulusImage(36);
+%
+function retval = mglTestStimulusImage(nImages)
+
+% check arguments
+retval = [];
+if ~any(nargin == [0 1])
+  help mglTestStimulusImage
+  return
+end
+if ieNotDefined('nImages'),nImages = 36;end
+
+% check that the native version is compiled
+if exist('mglPrivateMakeStimulusImage')~=3
+  disp(sprintf('(mglTestStimulusImage) mglPrivateMakeStimulusImage is not compiled. Run mglMakeMetal'));
+  return
+end
+
+% a stimulus like the one in taskTemplateStaircase, with an odd angle
+% and phase so nothing lines up by accident
+width = 8;height = 6;sf = 1.5;angle = 37;phase = 123;
+sdx = 1.2;sdy = 0.9;xCenter = 0.3;yCenter = -0.4;
+xDeg2pix = 41.3;yDeg2pix = 40.7;
+pix = {'xDeg2pix',xDeg2pix,'yDeg2pix',yDeg2pix};
+grating = mglMakeGrating(width,height,sf,angle,phase,xDeg2pix,yDeg2pix);
+gaussian = mglMakeGaussian(width,height,sdx,sdy,xCenter,yCenter,xDeg2pix,yDeg2pix);
+gabor = grating.*gaussian;
+gaussianArgs = {'sdx',sdx,'sdy',sdy,'xCenter',xCenter,'yCenter',yCenter};
+gratingArgs = {'sf',sf,'angle',angle,'phase',phase};
+
+% check against the Matlab functions, with a bound for each format (for
+% rgba and uint8, twice the rounding, since gratings are shown as (m+1)/2)
+retval = true;
+formats = {'double','single','rgba','uint8'};
+bounds = [1e-12 1e-6 2e-6 1.001/255];
+for iFormat = 1:length(formats)
+  format = formats{iFormat};
+  retval = checkImage(retval,'grating',grating,toValues(mglMakeStimulusImage('grating',width,height,gratingArgs{:},pix{:},'format',format),format,true),bounds(iFormat));
+  retval = checkImage(retval,'gaussian',gaussian,toValues(mglMakeStimulusImage('gaussian',width,height,gaussianArgs{:},pix{:},'format',format),format,false),bounds(iFormat));
+  retval = checkImage(retval,'gabor',gabor,toValues(mglMakeStimulusImage('gabor',width,height,gratingArgs{:},gaussianArgs{:},pix{:},'format',format),format,true),bounds(iFormat));
+end
+
+% 1D grating, and a plaid, which is the mean of two gratings
+retval = checkImage(retval,'1D grating',mglMakeGrating(width,nan,sf,angle,phase,xDeg2pix,yDeg2pix),mglMakeStimulusImage('grating',width,nan,gratingArgs{:},pix{:}),bounds(1));
+plaid = (grating + mglMakeGrating(width,height,sf,angle+60,phase,xDeg2pix,yDeg2pix))/2;
+retval = checkImage(retval,'plaid',plaid,mglMakeStimulusImage('plaid',width,height,gratingArgs{:},'plaidAngle',60,pix{:}),bounds(1));
+
+% gabor with the gaussian in alpha, as taskTemplateStaircase makes it
+masked = mglMakeStimulusImage('gabor',width,height,gratingArgs{:},gaussianArgs{:},pix{:},'format','rgba','alphaMask',1);
+retval = checkImage(retval,'masked gabor',cat(3,(grating+1)/2,(grating+1)/2,(grating+1)/2,gaussian),masked,bounds(2));
+
+% a family of phases and angles should be the same as making each one
+phases = (0:nImages-1)*360/nImages;
+angles = mod((0:nImages-1)*45,180);
+family = mglMakeStimulusImage('gabor',width,height,'sf',sf,'angle',angles,'phase',phases,gaussianArgs{:},pix{:},'format','uint8');
+for iImage = [1 2 nImages]
+  if ~isequal(family(:,:,:,iImage),mglMakeStimulusImage('gabor',width,height,'sf',sf,'angle',angles(iImage),'phase',phases(iImage),gaussianArgs{:},pix{:},'format','uint8'))
+    disp(sprintf('(mglTestStimulusImage) Image %i of the family does not match the same image on its own',iImage));
+    retval = false;
+  end
+end
+
+% the images should not depend on the number of threads
+for nThreads = [1 3 16]
+  if ~isequal(family,mglMakeStimulusImage('gabor',width,height,'sf',sf,'angle',angles,'phase',phases,gaussianArgs{:},pix{:},'format','uint8','nThreads',nThreads))
+    disp(sprintf('(mglTestStimulusImage) Family made with %i threads does not match',nThreads));
+    retval = false;
+  end
+end
+
+% time a family of textures against making them in Matlab
+tic;
+for iImage = 1:nImages
+  g = mglMakeGrating(width,height,sf,angles(iImage),phases(iImage),xDeg2pix,yDeg2pix);
+  m = 255*(g.*mglMakeGaussian(width,height,sdx,sdy,xCenter,yCenter,xDeg2pix,yDeg2pix)+1)/2;
+end
+matlabTime = toc;
+tic;
+family = mglMakeStimulusImage('gabor',width,height,'sf',sf,'angle',angles,'phase',phases,gaussianArgs{:},pix{:},'format','uint8');
+nativeTime = toc;
+disp(sprintf('(mglTestStimulusImage) %i gabors of %ix%i: %0.1f ms in Matlab, %0.1f ms native (%0.0fx)',nImages,size(family,2),size(family,3),1000*matlabTime,1000*nativeTime,matlabTime/nativeTime));
+
+%%%%%%%%%%%%%%%%%%
+%    toValues    %
+%%%%%%%%%%%%%%%%%%
+% convert an image in any format back to values like mglMakeGrating
+function values = toValues(im,format,aroundGray)
+
+switch format
+  case 'rgba'
+    values = double(im(:,:,1));
+  case 'uint8'
+    values = double(squeeze(im(1,:,:))')/255;
+  otherwise
+    values = double(im);
+end
+if aroundGray && any(strcmp(format,{'rgba','uint8'}))
+  values = 2*values-1;
+end
+
+%%%%%%%%%%%%%%%%%%%%
+%    checkImage    %
+%%%%%%%%%%%%%%%%%%%%
+function retval = checkImage(retval,name,expected,im,bound)
+
+if ~isequal(size(expected),size(im))
+  disp(sprintf('(mglTestStimulusImage) %s is %s but should be %s FAILED',name,mat2str(size(im)),mat2str(size(expected))));
+  retval = false;
+  return
+end
+maxError = max(abs(double(im(:))-expected(:)));
+if maxError <= bound
+  disp(sprintf('(mglTestStimulusImage) %s: max error %g OK',name,maxError));
+else
+  disp(sprintf('(mglTestStimulusImage) %s: max error %g (bound %g) FAILED',name,maxError,bound));
+  retval = false;
+end
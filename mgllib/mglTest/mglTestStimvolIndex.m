@@ -0,0 +1,61 @@
+% mglTestStimvolIndex.m
+%
+%      usage: mglTestStimvolIndex(<nTrials>,<nRepeats>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: test that the inverted index used by getStimvolFromVarname
+%             (mglPrivateStimvolIndex) gives the same answers as ismember
+%             and intersect, and time how long the queries take
+%
+%             mglTestStimvolIndex(1000,1000);
+%
+function retval = mglTestStimvolIndex(nTrials,nRepeats)
+
+% check arguments
+retval = [];
+if ~any(nargin == [0 1 2])
+  help mglTestStimvolIndex
+  return
+end
+if ieNotDefined('nTrials'),nTrials = 1000;end
+if ieNotDefined('nRepeats'),nRepeats = 1000;end
+
+% check that the native version is compiled
+if exist('mglPrivateStimvolIndex')~=3
+  disp(sprintf('(mglTestStimvolIndex) mglPrivateStimvolIndex is not compiled. Run mglMakeMetal'));
+  return
+end
+
+% make up some trial values, with a few nans
+varval = ceil(rand(1,nTrials)*8)/2;
+varval(ceil(rand(1,5)*nTrials)) = nan;
+index = mglPrivateStimvolIndex(varval);
+
+% check lookups against ismember
+retval = true;
+for condval = {2,[0.5 1.5],[1 2 3 4],nan,[],17}
+  if ~isequal(mglPrivateStimvolIndex(index,condval{1}),ismember(varval,condval{1}))
+    disp(sprintf('(mglTestStimvolIndex) Lookup of [%s] does not match ismember',num2str(condval{1})));
+    retval = false;
+  end
+end
+
+% check intersection of sorted volume numbers against intersect
+for iTest = 1:100
+  a = sort(ceil(rand(1,ceil(rand*nTrials))*nTrials));
+  b = sort(ceil(rand(1,ceil(rand*nTrials))*nTrials));
+  [c ia ib status] = mglPrivateStimvolIndex('intersect',a,b);
+  [matC matIa matIb] = intersect(a,b);
+  if ~status || ~isequal(c,matC) || ~isequal(ia,matIa) || ~isequal(ib,matIb)
+    disp(sprintf('(mglTestStimvolIndex) Intersect does not match for test %i',iTest));
+    retval = false;
+  end
+end
+
+% time the lookups
+tic;for iRepeat = 1:nRepeats,mglPrivateStimvolIndex(index,[1 2]);end;indexTime = toc;
+tic;for iRepeat = 1:nRepeats,ismember(varval,[1 2]);end;ismemberTime = toc;
+tic;for iRepeat = 1:nRepeats,mglPrivateStimvolIndex('intersect',a,b);end;sortedTime = toc;
+tic;for iRepeat = 1:nRepeats,intersect(a,b);end;intersectTime = toc;
+disp(sprintf('(mglTestStimvolIndex) Lookup: %0.4f ms (ismember: %0.4f ms) Intersect: %0.4f ms (intersect: %0.4f ms)',1000*indexTime/nRepeats,1000*ismemberTime/nRepeats,1000*sortedTime/nRepeats,1000*intersectTime/nRepeats));
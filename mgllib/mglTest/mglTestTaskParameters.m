@@ -0,0 +1,67 @@
+% mglTestTaskParameters.m
+%
+%      usage: mglTestTaskParameters(stimfilenames)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: test that the native event loops (mglPrivateMakeTraces and
+%             mglPrivateGetTaskParameters) give the same results as the
+%             m-file versions of makeTraces and getTaskParameters. Pass in
+%             the name of a stimfile or a cell array of names:
+%
+%             mglTestTaskParameters({'stimfile1','stimfile2'});
+%
+function retval = mglTestTaskParameters(stimfilenames)
+
+% check arguments
+retval = [];
+if ~any(nargin == [1])
+  help mglTestTaskParameters
+  return
+end
+if ~iscell(stimfilenames),stimfilenames = {stimfilenames};end
+
+% check that the native versions are compiled
+if (exist('mglPrivateMakeTraces')~=3) || (exist('mglPrivateGetTaskParameters')~=3)
+  disp(sprintf('(mglTestTaskParameters) Native versions are not compiled. Run mglMakeMetal'));
+  return
+end
+
+% remember what nativeTaskParameters was set to
+nativeTaskParameters = mglGetParam('nativeTaskParameters');
+
+retval = true;
+for iFile = 1:length(stimfilenames)
+  % load the stimfile
+  stimfile = load(stimfilenames{iFile});
+  if ~isfield(stimfile,'myscreen') || ~isfield(stimfile,'task')
+    disp(sprintf('(mglTestTaskParameters) %s is not a stimfile',stimfilenames{iFile}));
+    continue;
+  end
+  myscreen = stimfile.myscreen;
+  % remove the traces so that makeTraces recomputes them
+  if isfield(myscreen,'traces'),myscreen = rmfield(myscreen,'traces');end
+
+  % compute with the m-files
+  mglSetParam('nativeTaskParameters',0);
+  tic;
+  mScreen = makeTraces(myscreen);
+  mExperiment = getTaskParameters(mScreen,stimfile.task);
+  mTime = toc;
+
+  % and with the native versions
+  mglSetParam('nativeTaskParameters',1);
+  tic;
+  nativeScreen = makeTraces(myscreen);
+  nativeExperiment = getTaskParameters(nativeScreen,stimfile.task);
+  nativeTime = toc;
+
+  % compare
+  tracesMatch = isequaln(mScreen.traces,nativeScreen.traces) && isequaln(mScreen.time,nativeScreen.time);
+  experimentMatch = isequaln(mExperiment,nativeExperiment);
+  disp(sprintf('(mglTestTaskParameters) %s: traces match: %i experiment matches: %i (m-file: %0.3f s native: %0.3f s)',stimfilenames{iFile},tracesMatch,experimentMatch,mTime,nativeTime));
+  retval = retval && tracesMatch && experimentMatch;
+end
+
+% set nativeTaskParameters back
+mglSetParam('nativeTaskParameters',nativeTaskParameters);
@@ -18,6 +18,23 @@ end
 mglOpen(0.8);
 mglScreenCoordinates;
 
+% check that a preformatted uint8 texture that is not square (rgba x
+% width x height) comes back height x width x rgba, not transposed
+checkWidth = 5;checkHeight = 3;
+checkImage = zeros(4,checkWidth,checkHeight);
+checkImage(1,:,:) = repmat((1:checkWidth)',1,checkHeight);
+checkImage(2,:,:) = repmat(1:checkHeight,checkWidth,1);
+checkImage(4,:,:) = 255;
+checkImage = uint8(checkImage);
+checkTex = mglCreateTexture(checkImage);
+readImage = mglMetalReadTexture(checkTex);
+mglDeleteTexture(checkTex);
+expectedImage = permute(double(checkImage),[3 2 1])/255;
+retval = isequal(size(readImage),[checkHeight checkWidth 4]) && (max(abs(double(readImage(:))-expectedImage(:))) < 1e-6);
+if ~retval
+  disp(sprintf('(mglTestTexFast) Non-square uint8 texture of %ix%i was read back as %s',checkWidth,checkHeight,mat2str(size(readImage))));
+end
+
 % size of image to blt
 imageWidth = 800;
 imageHeight = 600;
@@ -0,0 +1,101 @@
+% mglTestTextCache.m
+%
+%      usage: mglTestTextCache(<screenNumber>,<nFrames>)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: test that mglTextDraw draws from the glyph cache
+%             (mglTextCache), rendering each character only once for
+%             each font, and compare how long a counter that changes
+%             every frame takes to draw with the cache and with a new
+%             mglText texture each frame.
+%
+%             mglTestTextCache(0,300);
+%
+function retval = mglTestTextCache(screenNumber,nFrames)
+
+% check arguments
+retval = [];
+if ~any(nargin == [0 1 2])
+  help mglTestTextCache
+  return
+end
+if ieNotDefined('screenNumber'),screenNumber = 0;end
+if ieNotDefined('nFrames'),nFrames = 300;end
+
+% check that the cache is compiled
+if exist('mglPrivateGlyphCache')~=3
+  disp(sprintf('(mglTestTextCache) mglPrivateGlyphCache is not compiled. Run mglMakeMetal'));
+  return
+end
+
+retval = true;
+mglOpen(screenNumber);
+mglVisualAngleCoordinates(57,[16 12]);
+mglTextSet('Helvetica',32,[1 1 1],0,0,0,0,0,0,0);
+mglTextCache('clear');
+
+% a counter, drawn with the cache
+counter = @(frame) sprintf('Correct: %i/%i\nTime: %0.2f s',floor(frame/3),frame,frame/60);
+startTime = mglGetSecs;
+for frame = 1:nFrames
+  mglClearScreen(0.5);
+  mglTextDraw(counter(frame),[0 0]);
+  mglFlush;
+end
+cacheTime = mglGetSecs(startTime);
+
+% each character is rendered once, and every one after is found
+info = mglTextCache('info');
+characters = unique(cell2mat(arrayfun(counter,1:nFrames,'UniformOutput',false)));
+characters = setdiff(characters,sprintf('\n'));
+retval = check(retval,'glyphs rendered once',info.glyphs == numel(characters));
+retval = check(retval,'one font',info.fonts == 1);
+retval = check(retval,'no misses after rendering',info.misses == 0);
+
+% a new font makes new glyphs, and the first one stays
+mglTextSet('Helvetica',32,[1 0 0],0,0,0,1,0,0,0);
+mglClearScreen(0.5);
+mglTextDraw('Correct',[0 0]);
+mglFlush;
+info = mglTextCache('info');
+retval = check(retval,'new font',(info.fonts == 2) && (info.glyphs == numel(characters)+numel(unique('Correct'))));
+mglTextSet('Helvetica',32,[1 1 1],0,0,0,0,0,0,0);
+
+% the same counter as a new texture each frame
+startTime = mglGetSecs;
+for frame = 1:nFrames
+  mglClearScreen(0.5);
+  tex = mglText(counter(frame));
+  mglBltTexture(tex,[0 0]);
+  mglDeleteTexture(tex);
+  mglFlush;
+end
+textureTime = mglGetSecs(startTime);
+disp(sprintf('(mglTestTextCache) %i frames of a counter: %0.1f ms a frame with the glyph cache, %0.1f ms with mglText',nFrames,1000*cacheTime/nFrames,1000*textureTime/nFrames));
+
+% a cache too small for the text is emptied, and the text is still drawn
+mglTextCache('clear',64,1);
+mglClearScreen(0.5);
+mglTextDraw('ABCDEFGHIJKLMNOPQRSTUVWXYZ',[0 0]);
+mglFlush;
+mglTextDraw('abcdefghijklmnopqrstuvwxyz',[0 -2]);
+mglFlush;
+info = mglTextCache('info');
+retval = check(retval,'flushed when full',info.flushes >= 1);
+mglTextCache('clear');
+
+mglClose;
+if retval
+  disp(sprintf('(mglTestTextCache) All OK'));
+end
+
+%%%%%%%%%%%%%%%
+%    check    %
+%%%%%%%%%%%%%%%
+function retval = check(retval,name,ok)
+
+if ~ok
+  disp(sprintf('(mglTestTextCache) %s is wrong',name));
+  retval = false;
+end
@@ -0,0 +1,52 @@
+% mglTestMetalDisplayList: an automated and/or interactive test for rendering.
+%
+%      usage: mglTestMetalDisplayList(isInteractive)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: Test recording a display list and calling it with parameters.
+%      usage:
+%             % You can run it by hand with no args.
+%             mglTestMetalDisplayList();
+%
+%             % Or mglRunRenderingTests can run it, in non-interactive mode.
+%             mglTestMetalDisplayList(false);
+%
+function mglTestMetalDisplayList(isInteractive)
+
+if nargin < 1
+    isInteractive = true;
+end
+
+if (isInteractive)
+    mglOpen();
+    cleanup = onCleanup(@() mglClose());
+end
+
+%% How to:
+
+mglVisualAngleCoordinates(50, [20, 20]);
+
+% Record some lines, and a square drawn from geometry, into a display list.
+square = mglCreateGeometry('triangles', [-1 1 1 1 -1 -1; -1 -1 1 1 1 -1; zeros(1, 6); ones(3, 6)]);
+mglMetalStartDisplayList();
+mglMetalLines([-8 -4], [-8 -8], [-8 -4], [-4 -4], [0.5 1], [1 0 0; 0 1 0]');
+mglDrawGeometry(square, [1 0 0 -5; 0 1 0 5; 0 0 1 0; 0 0 0 1]);
+displayList = mglMetalFinishDisplayList();
+
+% Call it twice, moving the square to the right the second time.
+mglMetalCallDisplayList(displayList);
+params.commandIndex = 2;
+params.xform = [2 0 0 5; 0 2 0 5; 0 0 1 0; 0 0 0 1];
+mglMetalCallDisplayList(displayList, params);
+
+disp('There should be a small white square on the left, a big one on the right, and 2 lines below.')
+
+mglFlush();
+
+mglMetalDeleteDisplayList(displayList);
+mglDeleteGeometry(square);
+
+if (isInteractive)
+    mglPause();
+end
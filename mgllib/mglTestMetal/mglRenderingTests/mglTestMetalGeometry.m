@@ -0,0 +1,57 @@
+% mglTestMetalGeometry: an automated and/or interactive test for rendering.
+%
+%      usage: mglTestMetalGeometry(isInteractive)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: Test drawing geometry kept in Metal, with updates and transforms.
+%      usage:
+%             % You can run it by hand with no args.
+%             mglTestMetalGeometry();
+%
+%             % Or mglRunRenderingTests can run it, in non-interactive mode.
+%             mglTestMetalGeometry(false);
+%
+function mglTestMetalGeometry(isInteractive)
+
+if nargin < 1
+    isInteractive = true;
+end
+
+if (isInteractive)
+    mglOpen();
+    cleanup = onCleanup(@() mglClose());
+end
+
+%% How to:
+
+mglVisualAngleCoordinates(50, [20, 20]);
+
+% Make a white square once, as two triangles.
+x = [-1 1 1 1 -1 -1];
+y = [-1 -1 1 1 1 -1];
+square = mglCreateGeometry('triangles', [x; y; zeros(1, 6); ones(3, 6)]);
+
+% Draw it on the left, then make its second triangle red and draw it on the right.
+% The left square should stay all white.
+mglDrawGeometry(square, [2 0 0 -5; 0 2 0 0; 0 0 1 0; 0 0 0 1]);
+mglUpdateGeometry(square, [x(4:6); y(4:6); zeros(1, 3); repmat([1; 0; 0], 1, 3)], 4);
+mglDrawGeometry(square, [2 0 0 5; 0 2 0 0; 0 0 1 0; 0 0 0 1]);
+
+% Draw a row of lines kept in Metal, with no transform.
+nLines = 5;
+x0 = linspace(-8, 8, nLines);
+records = [x0; -8 * ones(1, nLines); x0; -4 * ones(1, nLines); linspace(0.2, 1, nLines); jet(nLines)'; ones(1, nLines)];
+lines = mglCreateGeometry('instancedLines', records);
+mglDrawGeometry(lines);
+
+disp('There should be a white square on the left, a half white half red square on the right, and 5 lines below.')
+
+mglFlush();
+
+mglDeleteGeometry(square);
+mglDeleteGeometry(lines);
+
+if (isInteractive)
+    mglPause();
+end
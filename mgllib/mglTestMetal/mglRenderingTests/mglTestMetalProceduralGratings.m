@@ -0,0 +1,47 @@
+% mglTestMetalProceduralGratings: an automated and/or interactive test for rendering.
+%
+%      usage: mglTestMetalProceduralGratings(isInteractive)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: Test rendering gratings and gabors computed in Metal.
+%      usage:
+%             % You can run it by hand with no args.
+%             mglTestMetalProceduralGratings();
+%
+%             % Or mglRunRenderingTests can run it, in non-interactive mode.
+%             mglTestMetalProceduralGratings(false);
+%
+function mglTestMetalProceduralGratings(isInteractive)
+
+if nargin < 1
+    isInteractive = true;
+end
+
+if (isInteractive)
+    mglOpen();
+    cleanup = onCleanup(@() mglClose());
+end
+
+%% How to:
+
+mglVisualAngleCoordinates(50, [20, 20]);
+mglClearScreen(0.5);
+
+% A grating, a gabor around gray, and a gabor with its envelope in alpha.
+x = [-5 0 5];
+y = [5 -2 5];
+angle = [0 45 90];
+phase = [0 90 180];
+contrast = [1 0.5 1];
+sd = [0 1.5 1];
+alphaMask = [0 0 1];
+mglMetalProceduralGratings(x, y, 6, 6, 1, angle, phase, contrast, sd, sd, alphaMask);
+
+disp('There should be a horizontal grating, a faint tilted gabor, and a vertical gabor.')
+
+mglFlush();
+
+if (isInteractive)
+    mglPause();
+end
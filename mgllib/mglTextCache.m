@@ -0,0 +1,219 @@
+% mglTextCache: draw text from a cache of glyphs on atlas pages
+%
+%      usage: results = mglTextCache('draw', str, pos, <hAlignment>, <vAlignment>)
+%             mglTextCache('clear', <pageSize>, <maxPages>)
+%             info = mglTextCache('info')
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: Draws text as one quad for each character, all with one
+%             mglMetalBltSprites command, from glyphs (the images of single
+%             characters) kept on a few atlas page textures. Only
+%             characters that have not been drawn before in the font set
+%             by mglTextSet are rendered (with a Matlab figure, as
+%             mglFigureText does) and added to the pages, so a string
+%             that changes every frame, like a feedback counter, costs no
+%             rendering and only a few bytes a character to draw, instead
+%             of rendering and sending a whole new texture as mglText
+%             does. mglTextDraw uses this.
+%
+%             draw is as mglTextDraw: pos is [x y] in device units,
+%             hAlignment -1 left, 0 center (default) or 1 right and
+%             vAlignment -1 top, 0 center (default) or 1 bottom. Text
+%             can have several lines, separated by newline characters,
+%             and is rotated by fontRotation about pos. Glyphs are cached
+%             for each font name, size, bold, italic and color, and
+%             characters are placed by the width of each one alone, so
+%             there is no kerning between pairs of characters.
+%
+%             clear deletes the page textures and empties the cache, and
+%             sets the size of new pages in pixels (default 512) and how
+%             many there can be (default 4). When they are full, the
+%             cache is emptied and the glyphs that are needed rendered
+%             again. mglClose clears the cache.
+%
+%             info says how many glyphs, fonts and pages are cached, and
+%             how many characters were found (hits) or not (misses).
+%
+%             mglOpen;
+%             mglVisualAngleCoordinates(57,[16 12]);
+%             mglTextSet('Helvetica',32,[1 1 1],0,0,0,0,0,0,0);
+%             for frame = 1:600
+%               mglClearScreen(0.5);
+%               mglTextCache('draw',sprintf('Frame %i',frame),[0 0]);
+%               mglFlush;
+%             end
+%             mglTextCache('info')
+%
+function retval = mglTextCache(command, str, pos, hAlignment, vAlignment)
+
+% check arguments
+retval = [];
+if ~any(nargin == [1 2 3 4 5])
+  help mglTextCache
+  return
+end
+
+% the page textures, and the images on them, which stay as long as the cache
+persistent pageTextures pageImages
+
+% check that the cache is compiled
+if exist('mglPrivateGlyphCache')~=3
+  disp(sprintf('(mglTextCache) mglPrivateGlyphCache is not compiled. Run mglMakeMetal'));
+  return
+end
+
+switch lower(command)
+  case 'draw'
+    if nargin < 3
+      help mglTextCache
+      return
+    end
+    if nargin < 4 || isempty(hAlignment), hAlignment = 0; end
+    if nargin < 5 || isempty(vAlignment), vAlignment = 0; end
+    if isempty(str), return, end
+    str = char(str);
+    font = fontName;
+
+    % render and add the glyphs that are not cached. If the pages are full, the cache
+    % is emptied, so other characters of str may be missing again, but only once.
+    changedPages = false(1, numel(pageImages));
+    for attempt = 1:2
+      missing = mglPrivateGlyphCache('missing', font, str);
+      if isempty(missing), break, end
+      glyphs = renderGlyphs(missing);
+      [page x y flushed] = mglPrivateGlyphCache('add', font, missing, glyphs.width, glyphs.height, glyphs.left, glyphs.top, glyphs.advance, glyphs.lineHeight);
+      if flushed
+        for iPage = 1:numel(pageImages)
+          pageImages{iPage}(:) = 0;
+        end
+        changedPages = true(1, numel(pageImages));
+      end
+      % put the new glyphs on their pages
+      info = mglPrivateGlyphCache('info');
+      for iGlyph = find(page > 0)
+        if page(iGlyph) > numel(pageImages)
+          pageImages{page(iGlyph)} = zeros(info.pageHeight, info.pageWidth, 4, 'single');
+        end
+        pageImages{page(iGlyph)}(y(iGlyph)+(0:glyphs.height(iGlyph)-1), x(iGlyph)+(0:glyphs.width(iGlyph)-1), :) = glyphs.images{iGlyph};
+        changedPages(page(iGlyph)) = true;
+      end
+      if ~flushed, break, end
+    end
+
+    % send the pages that changed, once for all the new glyphs
+    for iPage = find(changedPages)
+      if iPage > numel(pageTextures)
+        tex = mglCreateTexture(pageImages{iPage});
+        if isempty(pageTextures)
+          pageTextures = tex;
+        else
+          pageTextures(iPage) = tex;
+        end
+      else
+        mglUpdateTexture(pageTextures(iPage), pageImages{iPage});
+      end
+    end
+
+    % draw all the glyphs with one command
+    rotation = mglGetParam('fontRotation');
+    if isempty(rotation), rotation = 0; end
+    quads = mglPrivateGlyphCache('layout', font, str, pos, [mglGetParam('xPixelsToDevice') mglGetParam('yPixelsToDevice')], hAlignment, vAlignment, rotation);
+    if isempty(quads), return, end
+    atlas.page = quads(9,:);
+    atlas.uv = quads(5:8,:);
+    atlas.textureNumber = [pageTextures(quads(9,:)).textureNumber];
+    retval = mglMetalBltSprites(atlas, 1:size(quads,2), quads(1,:), quads(2,:), quads(3,:), quads(4,:), rotation);
+
+  case 'clear'
+    if ~isempty(pageTextures) && (mglGetParam('displayNumber') ~= -1)
+      mglDeleteTexture(pageTextures);
+    end
+    pageTextures = [];
+    pageImages = {};
+    pageSize = [];
+    maxPages = [];
+    if nargin > 1, pageSize = str; end
+    if nargin > 2, maxPages = pos; end
+    if length(pageSize) == 1, pageSize = [pageSize pageSize]; end
+    mglPrivateGlyphCache('clear', pageSize, maxPages);
+
+  case 'info'
+    retval = mglPrivateGlyphCache('info');
+
+  otherwise
+    disp(sprintf('(mglTextCache) Unknown command %s, should be draw, clear or info', command));
+end
+
+%%%%%%%%%%%%%%%%%%
+%    fontName    %
+%%%%%%%%%%%%%%%%%%
+% everything set by mglTextSet that changes how a glyph looks
+function font = fontName
+
+fontColor = mglGetParam('fontColor');
+if isempty(fontColor), fontColor = [1 1 1 1]; end
+if numel(fontColor) < 4, fontColor(4) = 1; end
+font = sprintf('%s %g %i %i %s', mglGetParam('fontName'), mglGetParam('fontSize'), ...
+  isequal(mglGetParam('fontBold'),1), isequal(mglGetParam('fontItalic'),1), mat2str(fontColor));
+
+%%%%%%%%%%%%%%%%%%%%%%
+%    renderGlyphs    %
+%%%%%%%%%%%%%%%%%%%%%%
+% render each character alone in a Matlab figure, as mglFigureText does, and
+% find its ink, where the ink is from the pen at the top of the line, and how
+% far it moves the pen
+function glyphs = renderGlyphs(characters)
+
+nGlyphs = numel(characters);
+glyphs.images = cell(1, nGlyphs);
+glyphs.width = zeros(1, nGlyphs);
+glyphs.height = zeros(1, nGlyphs);
+glyphs.left = zeros(1, nGlyphs);
+glyphs.top = zeros(1, nGlyphs);
+glyphs.advance = zeros(1, nGlyphs);
+
+% white text on black, as in mglFigureText
+fig = figure('Units', 'pixels', 'Color', [0 0 0], 'Visible', 'off', 'MenuBar', 'none', 'ToolBar', 'none');
+closeFigure = onCleanup(@()close(fig));
+ax = axes('Parent', fig, 'Units', 'normalized', 'Position', [0 0 1 1], 'Visible', 'off');
+txt = text('Parent', ax, 'Units', 'pixels', 'Position', [0 0], 'Interpreter', 'none', 'String', 'Hg', ...
+  'FontUnits', 'points', 'ColorMode', 'manual', 'Color', [1 1 1], 'EdgeColor', 'none', ...
+  'BackgroundColor', 'none', 'LineStyle', 'none', 'Margin', 1, 'Clipping', 'off', ...
+  'HorizontalAlignment', 'left', 'VerticalAlignment', 'top');
+if ~isempty(mglGetParam('fontName')), set(txt, 'FontName', mglGetParam('fontName')); end
+if ~isempty(mglGetParam('fontSize')), set(txt, 'FontSize', mglGetParam('fontSize') / 2); end
+if isequal(mglGetParam('fontBold'),1), set(txt, 'FontWeight', 'bold'); end
+if isequal(mglGetParam('fontItalic'),1), set(txt, 'FontAngle', 'italic'); end
+fontColor = mglGetParam('fontColor');
+if isempty(fontColor), fontColor = [1 1 1 1]; end
+if numel(fontColor) < 4, fontColor(4) = 1; end
+
+% the line is as high as a string with an ascender and a descender, and the
+% figure big enough for any one character, with the top of the line at a
+% fixed place
+drawnow();
+glyphs.lineHeight = ceil(txt.Extent(4));
+figureSize = 4 * glyphs.lineHeight;
+fig.Position = [0 0 figureSize figureSize];
+txt.Position = [glyphs.lineHeight figureSize - glyphs.lineHeight];
+
+for iGlyph = 1:nGlyphs
+  set(txt, 'String', char(characters(iGlyph)));
+  drawnow();
+  extent = txt.Extent;
+  glyphs.advance(iGlyph) = extent(3);
+  % the box of the line this character is on, with a pixel of margin, as in mglFigureText
+  box = [extent(1) extent(2)+extent(4)-glyphs.lineHeight extent(3) glyphs.lineHeight];
+  frame = getframe(ax, box + [-1 -1 2 2]);
+  mask = single(frame2im(frame));
+  mask = mask(:,:,1) / 255;
+  [rows, cols] = find(mask);
+  if isempty(rows), continue, end
+  mask = mask(min(rows):max(rows), min(cols):max(cols));
+  glyphs.height(iGlyph) = size(mask, 1);
+  glyphs.width(iGlyph) = size(mask, 2);
+  glyphs.left(iGlyph) = min(cols) - 2;
+  glyphs.top(iGlyph) = min(rows) - 2;
+  glyphs.images{iGlyph} = cat(3, mask * fontColor(1), mask * fontColor(2), mask * fontColor(3), mask * fontColor(4));
+end
@@ -5,11 +5,13 @@
 %         by: justin gardner
 %       date: 05/13/06
 %  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
-%    purpose: wrapper around mglText and mglBltTexture to
-%             draw some text on the string. If you need
-%             to draw text more quickly, you will have to
-%             pre-make the text textures with mglText and
-%             then use mglBltTexture when you want it
+%    purpose: draw some text on the screen. Draws each
+%             character from a cache of glyphs (see
+%             mglTextCache), so only characters that have
+%             not been drawn before are rendered, and text
+%             that changes every frame is quick to draw.
+%             Flipped text (fontVFlip or fontHFlip) is
+%             drawn as a texture made with mglText.
 %             str = desired string
 %             pos = [x y] - position on screen
 %             hAlignment = {-1 = left,0 = center,1 = right}
@@ -27,6 +29,7 @@
 function retval = mglTextDraw(str,pos,hAlignment,vAlignment)
 
 % check arguments
+retval = [];
 if ~any(nargin == [2:4])
     help mglTextDraw
     return
@@ -36,8 +39,14 @@ end
 if ~exist('hAlignment'),hAlignment = 0;,end
 if ~exist('vAlignment'),vAlignment = 0;,end
 
+% draw from the glyph cache
+if (exist('mglPrivateGlyphCache')==3) && ~isequal(mglGetParam('fontVFlip'),1) && ~isequal(mglGetParam('fontHFlip'),1)
+  retval = mglTextCache('draw',str,pos,hAlignment,vAlignment);
+  return
+end
+
 % make the text texture and blt it to the screen
 tex = mglText(str);
-mglMetalBltTexture(tex,pos,hAlignment,vAlignment);
+retval = mglMetalBltTexture(tex,pos,hAlignment,vAlignment);
 
 mglDeleteTexture(tex);
@@ -53,8 +53,16 @@ if any(mgl.s.connectionSocketDescriptor == [mgl.activeSockets.connectionSocketDe
     mgl.currentMatrix = currentMatrix;
 end
 
-% Always update the mglMetal process with the new matrix.
+% Update the mglMetal process with the new matrix, unless it already has it
+% (see mglMetalSkipRedundantCommands).
+[skip, results] = mglPrivateSkipRedundant('mglSetXform', single(mgl.currentMatrix), socketInfo);
+if skip
+    return
+end
 mglSocketWrite(socketInfo, socketInfo(1).command.mglSetXform);
 ackTime = mglSocketRead(socketInfo, 'double');
 mglSocketWrite(socketInfo, single(mgl.currentMatrix));
 results = mglReadCommandResults(socketInfo, ackTime);
+if any([results.processedTime] < 0)
+    mglPrivateSkipRedundant('invalidate', {'xform'}, socketInfo);
+end
@@ -0,0 +1,62 @@
+% mglUpdateGeometry.m
+%
+%       usage: results = mglUpdateGeometry(geometry, vertices, <firstVertex>, <socketInfo>)
+%          by: justin gardner
+%        date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%     purpose: Change some of the vertices of geometry made with
+%              mglCreateGeometry, sending only the vertices that change.
+%
+%              geometry -- struct returned by mglCreateGeometry
+%              vertices -- valuesPerVertex x n matrix of new vertices
+%              firstVertex -- which vertex the new vertices start at
+%                             (default 1)
+%
+%              The new vertices can be sent before or after the geometry
+%              is drawn in a frame. If it was already drawn in the frame
+%              that is being put together, mglMetal changes a copy so
+%              that what was drawn keeps the old vertices.
+%       e.g.:
+%
+% mglOpen;
+% mglVisualAngleCoordinates(57,[16 12]);
+% dots = mglCreateGeometry('dots',[rand(2,100)*10-5;zeros(1,100);ones(4,100);0.2*ones(2,100);zeros(2,100)]);
+% mglDrawGeometry(dots);mglFlush;
+% mglUpdateGeometry(dots,[0;0;0;1;0;0;1;1;1;1;0],10);
+% mglDrawGeometry(dots);mglFlush;
+function results = mglUpdateGeometry(geometry, vertices, firstVertex, socketInfo)
+
+results = [];
+if nargin < 2
+    help mglUpdateGeometry
+    return
+end
+if nargin < 3 || isempty(firstVertex)
+    firstVertex = 1;
+end
+if nargin < 4 || isempty(socketInfo)
+    global mgl
+    socketInfo = mgl.activeSockets;
+end
+
+if ~isfield(geometry, 'geometryNumber')
+    disp('(mglUpdateGeometry) Input is not a geometry');
+    return
+end
+if size(vertices, 1) ~= geometry(1).valuesPerVertex
+    fprintf('(mglUpdateGeometry) Vertices for %s must have %i rows, not %i\n', geometry(1).geometryType, geometry(1).valuesPerVertex, size(vertices, 1));
+    return
+end
+if (firstVertex < 1) || (firstVertex + size(vertices, 2) - 1 > geometry(1).nVertices)
+    fprintf('(mglUpdateGeometry) Vertices %i:%i are outside the %i vertices of the geometry\n', firstVertex, firstVertex + size(vertices, 2) - 1, geometry(1).nVertices);
+    return
+end
+
+% Send the range as values, so mglMetal can copy them straight into place.
+mglSocketWrite(socketInfo, socketInfo(1).command.mglUpdateGeometry);
+ackTime = mglSocketRead(socketInfo, 'double');
+mglSocketWrite(socketInfo, uint32(geometry(1).geometryNumber));
+mglSocketWrite(socketInfo, uint32((firstVertex - 1) * geometry(1).valuesPerVertex));
+mglSocketWrite(socketInfo, uint32(numel(vertices)));
+mglSocketWrite(socketInfo, single(vertices(:)));
+results = mglReadCommandResults(socketInfo, ackTime);
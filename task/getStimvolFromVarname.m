@@ -169,13 +169,13 @@ if iscell(varnameIn)
           % intersect each condition with existing conditions and union them together
           for iStimvol = 1:length(stimvol)
             if iStimvol == 1
-              stimvolOut{iVarname}{1} = intersect(oldStimvolOut{iVarname}{iOldStimvolOut}, stimvol{iStimvol});
+              stimvolOut{iVarname}{1} = sortedIntersect(oldStimvolOut{iVarname}{iOldStimvolOut}, stimvol{iStimvol});
               stimNamesOut{iVarname}{1} = sprintf('(%s & %s)', oldStimNamesOut{iVarname}{iOldStimvolOut}, stimNames{iStimvol});
-              trialNumOut{iVarname}{1} = intersect(oldTrialNumOut{iVarname}{iOldStimvolOut}, trialNum{iStimvol});
+              trialNumOut{iVarname}{1} = sortedIntersect(oldTrialNumOut{iVarname}{iOldStimvolOut}, trialNum{iStimvol});
             else
-              stimvolOut{iVarname}{1} = union(stimvolOut{iVarname}{1}, intersect(oldStimvolOut{iVarname}{iOldStimvolOut}, stimvol{iStimvol}));
+              stimvolOut{iVarname}{1} = union(stimvolOut{iVarname}{1}, sortedIntersect(oldStimvolOut{iVarname}{iOldStimvolOut}, stimvol{iStimvol}));
               stimNamesOut{iVarname}{1} = sprintf('%s or (%s & %s)', stimNamesOut{iVarname}{1}, oldStimNamesOut{iVarname}{iOldStimvolOut}, stimNames{iStimvol});
-              trialNumOut{iVarname}{1} = union(trialNumOut{iVarname}{1}, intersect(oldTrialNumOut{iVarname}{iOldStimvolOut}, trialNum{iStimvol}));
+              trialNumOut{iVarname}{1} = union(trialNumOut{iVarname}{1}, sortedIntersect(oldTrialNumOut{iVarname}{iOldStimvolOut}, trialNum{iStimvol}));
             end
           end
         end
@@ -239,7 +239,7 @@ if ~isempty(strfind(varnameIn, '_x_'))
       newCrossTrialNum = {};
       for iCross = 1:length(crossStimvol)
         for iStimvol = 1:length(stimvol)
-          [newCrossStimvol{end+1}, crossIndex] = intersect(crossStimvol{iCross}, stimvol{iStimvol});
+          [newCrossStimvol{end+1}, crossIndex] = sortedIntersect(crossStimvol{iCross}, stimvol{iStimvol});
           newCrossStimNames{end+1} = sprintf('%s and %s', crossStimNames{iCross}, stimNames{iStimvol});
           newCrossTrialNum{end+1} = crossTrialNum{iCross}(crossIndex);
         end
@@ -308,8 +308,9 @@ else
   end
 end
 
-% get the task parameters
-e = getTaskParameters(myscreen,task);
+% get the task parameters, these are cached so that repeated
+% calls for the same stimfile do not have to recompute them
+[e cacheKey] = stimvolIndex(myscreen,task,numSigDigits);
 % make sure it is a cell array
 if ~iscell(e),olde = e;clear e;e{1} = olde;,end
 
@@ -380,7 +381,8 @@ else
           for j = 1:length(varname{i})
             % get the value of the variable in question
             % on each trial
-            varval = getVarFromParameters(mystrtok(varname{i}{j},'='),e{tnum}(pnum));
+            varinfo = stimvolIndex(cacheKey,tnum,pnum,mystrtok(varname{i}{j},'='));
+            varval = varinfo.varval;
             % check to make sure it is not empty
             if isempty(varval)
               disp(sprintf('(getStimvolFromVarname) Could not find variable %s in task %i phase %i',mystrtok(varname{i}{j},'='),tnum,pnum));
@@ -391,9 +393,14 @@ else
               % if it is then for each particular setting
               % of the variable, we make a stim type. Use getVarFromParameters
               % to return all the possible settings for the variable
-              vartypes = getVarFromParameters(varname{i}{j},e{tnum}(pnum),1);
+              vartypes = stimvolIndex(cacheKey,tnum,pnum,varname{i}{j},'vartypes');
               for k = 1:length(vartypes)
-                stimvol{i}{end+1} = varval==vartypes(k);
+                % look the trials up in the index if we have one
+                if ~isempty(varinfo.index) && isa(vartypes,'double')
+                  stimvol{i}{end+1} = mglPrivateStimvolIndex(varinfo.index,vartypes(k));
+                else
+                  stimvol{i}{end+1} = varval==vartypes(k);
+                end
                 stimnames{i}{end+1} = sprintf('%s=%s',varname{i}{j},num2str(vartypes(k)));
               end
             end
@@ -405,7 +412,8 @@ else
           for j = 1:length(varname{i})
             % get the value of the variable in question
             % on each trial
-            varval = getVarFromParameters(mystrtok(varname{i}{j},'='),e{tnum}(pnum));
+            varinfo = stimvolIndex(cacheKey,tnum,pnum,mystrtok(varname{i}{j},'='));
+            varval = varinfo.varval;
             % round the values to numSigDigits. This is so that if you have
             % multiple significant digits you still get the string to match, which
             % won't have as many significant digits. (e.g. if your value was pi, and
@@ -413,10 +421,10 @@ else
             % values we have so that we can spit out a warning if this manipulation
             % causes some conditions to get grouped together (i.e. this would happen
             % if you have a variable that only difference after the numSigDigitis decimal place)
+            % (the rounded values and their unique count are kept with the index)
             if isnumeric(varval)
-              nUniqueVarval = length(unique(varval));
-              varval = round(varval*10^numSigDigits)/10^numSigDigits;
-              if length(unique(varval)) ~= nUniqueVarval
+              varval = varinfo.roundedVarval;
+              if varinfo.nUniqueRounded ~= varinfo.nUnique
                 disp(sprintf('(getStimvolFromVarname) WARNING: Variable %s has values that only differe after %i significant figures that will be grouped together',mystrtok(varname{i}{j},'='),numSigDigits));
               end
             end
@@ -425,8 +433,14 @@ else
             if ~isempty(strfind(varname{i}{j},'='))
               [t,r] = mystrtok(varname{i}{j},'=');
               varcond = mystrtok(r,'=');
-              % if it is then get the conditions
-              varval = eval(sprintf('ismember(varval,%s)',varcond));
+              % if it is then get the conditions, looking them up in the
+              % index of rounded values if we have one
+              condval = eval(varcond);
+              if ~isempty(varinfo.roundedIndex) && isa(condval,'double') && isreal(condval)
+                varval = mglPrivateStimvolIndex(varinfo.roundedIndex,condval);
+              else
+                varval = ismember(varval,condval);
+              end
               % if we dont have any applied conditions applied then
               % this is the condition
               if isempty(stimvol{i})
@@ -528,6 +542,128 @@ if verbose
   end
 end
 
+%%%%%%%%%%%%%%%%%%%%%%
+%    stimvolIndex    %
+%%%%%%%%%%%%%%%%%%%%%%
+% keeps a cache for each stimfile of the task parameters and, for each
+% variable that has been asked for, its value on each trial along with
+% an inverted index (value -> trials) built by mglPrivateStimvolIndex
+%
+% [e cacheKey] = stimvolIndex(myscreen,task,numSigDigits) returns the
+% task parameters computing them if they are not already cached.
+% varinfo = stimvolIndex(cacheKey,tnum,pnum,varname) returns the
+% values of the variable and its indexes, and
+% vartypes = stimvolIndex(cacheKey,tnum,pnum,varname,'vartypes')
+% returns all the possible values of the variable
+function [retval cacheKey] = stimvolIndex(arg1,arg2,arg3,varname,vartypes)
+
+persistent cache;
+persistent cacheCount;
+if isempty(cacheCount),cacheCount = 0;end
+% number of stimfiles to keep
+maxCache = 4;
+
+if isstruct(arg1)
+  myscreen = arg1;task = arg2;numSigDigits = arg3;
+  % look for this stimfile in the cache
+  for iCache = 1:length(cache)
+    if isequal(cache(iCache).events,myscreen.events) && isequal(cache(iCache).stimtrace,myscreen.stimtrace) && isequal(cache(iCache).task,task)
+      cacheCount = cacheCount+1;
+      cache(iCache).lastUsed = cacheCount;
+      retval = cache(iCache).e;
+      cacheKey = cache(iCache).key;
+      return
+    end
+  end
+  % not found, so compute the task parameters
+  e = getTaskParameters(myscreen,task);
+  % make sure it is a cell array
+  if ~iscell(e),olde = e;clear e;e{1} = olde;,end
+  % and add to the cache, replacing the least recently used
+  cacheCount = cacheCount+1;
+  thisCache.key = cacheCount;
+  thisCache.lastUsed = cacheCount;
+  thisCache.events = myscreen.events;
+  thisCache.stimtrace = myscreen.stimtrace;
+  thisCache.task = task;
+  thisCache.e = e;
+  thisCache.numSigDigits = numSigDigits;
+  thisCache.varinfo = {};
+  if length(cache) < maxCache
+    cache = [cache thisCache];
+  else
+    [dump iCache] = min([cache.lastUsed]);
+    cache(iCache) = thisCache;
+  end
+  retval = e;
+  cacheKey = thisCache.key;
+  return
+end
+
+% otherwise we are being asked for a variable
+cacheKey = arg1;tnum = arg2;pnum = arg3;
+iCache = find([cache.key] == cacheKey);
+e = cache(iCache).e;
+numSigDigits = cache(iCache).numSigDigits;
+if isempty(cache(iCache).varinfo)
+  cache(iCache).varinfo = struct('tnum',{},'pnum',{},'varname',{},'varval',{},'index',{},'roundedVarval',{},'roundedIndex',{},'nUnique',{},'nUniqueRounded',{},'vartypes',{},'haveVartypes',{});
+end
+varinfo = cache(iCache).varinfo;
+iVar = find(([varinfo.tnum] == tnum) & ([varinfo.pnum] == pnum) & strcmp({varinfo.varname},varname));
+
+% make a new entry if we have not seen this variable yet
+if isempty(iVar)
+  thisVar.tnum = tnum;
+  thisVar.pnum = pnum;
+  thisVar.varname = varname;
+  thisVar.varval = getVarFromParameters(varname,e{tnum}(pnum));
+  thisVar.index = [];
+  thisVar.roundedVarval = [];
+  thisVar.roundedIndex = [];
+  thisVar.nUnique = [];
+  thisVar.nUniqueRounded = [];
+  thisVar.vartypes = [];
+  thisVar.haveVartypes = false;
+  if isnumeric(thisVar.varval) && ~isempty(thisVar.varval)
+    % round the values the same way as above
+    thisVar.roundedVarval = round(thisVar.varval*10^numSigDigits)/10^numSigDigits;
+    thisVar.nUnique = length(unique(thisVar.varval));
+    thisVar.nUniqueRounded = length(unique(thisVar.roundedVarval));
+    % and build the indexes
+    if isa(thisVar.varval,'double') && isreal(thisVar.varval) && (exist('mglPrivateStimvolIndex')==3)
+      thisVar.index = mglPrivateStimvolIndex(thisVar.varval);
+      thisVar.roundedIndex = mglPrivateStimvolIndex(thisVar.roundedVarval);
+    end
+  end
+  varinfo(end+1) = thisVar;
+  iVar = length(varinfo);
+end
+
+% get all possible values if asked for
+if nargin >= 5
+  if ~varinfo(iVar).haveVartypes
+    varinfo(iVar).vartypes = getVarFromParameters(varname,e{tnum}(pnum),1);
+    varinfo(iVar).haveVartypes = true;
+  end
+  retval = varinfo(iVar).vartypes;
+else
+  retval = varinfo(iVar);
+end
+cache(iCache).varinfo = varinfo;
+
+%%%%%%%%%%%%%%%%%%%%%%%%%
+%    sortedIntersect    %
+%%%%%%%%%%%%%%%%%%%%%%%%%
+% same as intersect, but stimvols and trial numbers are normally
+% sorted, so use the mex version which can merge them directly
+function [c ia ib] = sortedIntersect(a,b)
+
+if exist('mglPrivateStimvolIndex')==3
+  [c ia ib status] = mglPrivateStimvolIndex('intersect',a,b);
+  if status,return,end
+end
+[c ia ib] = intersect(a,b);
+
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %    makeEveryCombination    %
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
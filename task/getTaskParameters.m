@@ -88,7 +88,22 @@ for taskNum = 1:length(allTasks)
   experiment = initPhase([],phaseNum,numTraces,task{phaseNum});
   tnum = 0;
 
+  % try the native event loop first. If it is not compiled or it
+  % runs into something it does not handle, then nativeDone will
+  % be false and we go through the events below.
+  nativeDone = false;
   if (task{phaseNum}.segmentTrace)
+    [nativeExperiment volumeTR pastEnd nativeDone] = nativeTaskParameters(experiment,myscreen,task,numTraces,volumeTR);
+    if nativeDone
+      experiment = nativeExperiment;
+      if pastEnd
+	fprintf('Recorded trace events past end of last trial.\n');
+	return
+      end
+    end
+  end
+
+  if (task{phaseNum}.segmentTrace) && ~nativeDone
     % go through the events, looking for the segment  
     for enum = 1:myscreen.events.n
       % get the volume number of the event
@@ -398,4 +413,92 @@ for iRandVarType = 1:length(randVarTypes)
   end
 end
 
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+%    nativeTaskParameters    %
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+function [experiment volumeTR pastEnd nativeDone] = nativeTaskParameters(experiment,myscreen,task,numTraces,volumeTR)
+
+pastEnd = false;nativeDone = false;
+
+% check that the native version is available and has not been turned off
+if (exist('mglPrivateGetTaskParameters')~=3) || isequal(mglGetParam('nativeTaskParameters'),0)
+  return
+end
 
+% get the settings for each phase that the event loop needs
+try
+  for phaseNum = 1:length(task)
+    phaseInfo(phaseNum).segmentTrace = task{phaseNum}.segmentTrace;
+    phaseInfo(phaseNum).phaseTrace = task{phaseNum}.phaseTrace;
+    phaseInfo(phaseNum).responseTrace = task{phaseNum}.responseTrace;
+    phaseInfo(phaseNum).numTrials = task{phaseNum}.numTrials;
+    phaseInfo(phaseNum).blockTrialn = [task{phaseNum}.block(:).trialn];
+    phaseInfo(phaseNum).hasGetResponse = isfield(task{phaseNum},'getResponse');
+    if phaseInfo(phaseNum).hasGetResponse
+      phaseInfo(phaseNum).getResponse = double(task{phaseNum}.getResponse);
+    else
+      phaseInfo(phaseNum).getResponse = [];
+    end
+  end
+catch
+  return
+end
+
+% run through the events
+[phases nativeVolumeTR status] = mglPrivateGetTaskParameters(myscreen.events,phaseInfo,myscreen.stimtrace,numTraces,volumeTR);
+if status == -1,return,end
+volumeTR = nativeVolumeTR;
+pastEnd = (status == 1);
+nativeDone = true;
+
+% now set the experiment structure for each phase that was entered,
+% in the same order that the event loop would set the fields
+for phaseNum = 1:length(phases)
+  if ~phases(phaseNum).entered,continue,end
+  if phaseNum > 1
+    experiment = initPhase(experiment,phaseNum,numTraces,task{phaseNum});
+  end
+  experiment(phaseNum).nTrials = phases(phaseNum).nTrials;
+  nTrials = phases(phaseNum).trialCount;
+  if nTrials == 0,continue,end
+  experiment(phaseNum).trialTime = phases(phaseNum).trialTime;
+  experiment(phaseNum).trialTicknum = phases(phaseNum).trialTicknum;
+  experiment(phaseNum).trialVolume = phases(phaseNum).trialVolume;
+  experiment(phaseNum).blockNum = phases(phaseNum).blockNum;
+  experiment(phaseNum).blockTrialNum = phases(phaseNum).blockTrialNum;
+  experiment(phaseNum).trials = phases(phaseNum).trials;
+  if numTraces > 0
+    experiment(phaseNum).traces = phases(phaseNum).traces;
+  end
+  experiment(phaseNum).response = phases(phaseNum).response;
+  experiment(phaseNum).responseVolume = phases(phaseNum).responseVolume;
+  experiment(phaseNum).reactionTime = phases(phaseNum).reactionTime;
+  experiment(phaseNum).responseTimeRaw = phases(phaseNum).responseTimeRaw;
+  % get all the random parameters
+  for rnum = 1:task{phaseNum}.randVars.n_
+    varname = task{phaseNum}.randVars.names_{rnum};
+    experiment(phaseNum).randVars.(varname)(1:nTrials) = task{phaseNum}.randVars.(varname)(mod((1:nTrials)-1,task{phaseNum}.randVars.varlen_(rnum))+1);
+  end
+  if isfield(task{phaseNum},'parameterCode')
+    experiment(phaseNum).parameterCode = task{phaseNum}.parameterCode;
+  end
+  % and get all parameters, a block at a time
+  blockNum = experiment(phaseNum).blockNum;
+  blockTrialNum = experiment(phaseNum).blockTrialNum;
+  for iBlock = unique(blockNum,'stable')
+    trialNums = find(blockNum == iBlock);
+    parameterNames = fieldnames(task{phaseNum}.block(iBlock).parameter);
+    for pnum = 1:length(parameterNames)
+      thisParam = task{phaseNum}.block(iBlock).parameter.(parameterNames{pnum});
+      % if it is an array then it is just a regular parameter
+      if size(thisParam,1) == 1
+	experiment(phaseNum).parameter.(parameterNames{pnum})(trialNums) = thisParam(blockTrialNum(trialNums));
+      % otherwise there are multiple values per each trial
+      else
+	for paramRowNum = 1:size(thisParam,1)
+	  experiment(phaseNum).parameter.(sprintf('%s%i',parameterNames{pnum},paramRowNum))(trialNums) = thisParam(paramRowNum,blockTrialNum(trialNums));
+	end
+      end
+    end
+  end
+end
@@ -27,6 +27,19 @@ end
 % while the task is running
 if (isfield(myscreen,'events'))
   maxtick = myscreen.tick;
+  % use the native version of the loop below if it has been compiled. It
+  % returns empty if it comes across anything it doesn't handle exactly
+  % the way this m-file does, in which case we just run the loop here
+  if (exist('mglPrivateMakeTraces')==3) && ~isequal(mglGetParam('nativeTaskParameters'),0)
+    if isfield(myscreen,'framesPerSecond'),framesPerSecond = myscreen.framesPerSecond;else framesPerSecond = nan;end
+    [traces time] = mglPrivateMakeTraces(myscreen.events,maxtick,myscreen.endtimeSecs,framesPerSecond,myscreen.time);
+    if ~isempty(traces)
+      myscreen.traces = traces;
+      myscreen.time = time;
+      myscreen.events = truncateEvents(myscreen.events);
+      return
+    end
+  end
   % make up time in between first and end time, we will make this 
   % piecewise linear for each event later.
   if (maxtick > 2)
@@ -83,13 +96,20 @@ if (isfield(myscreen,'events'))
     if exist('disppercent')&&verbose,disppercent(i/myscreen.events.n);end
   end
   % truncate unused parts of event traces
-  myscreen.events.tracenum = myscreen.events.tracenum(1:myscreen.events.n);
-  myscreen.events.data = myscreen.events.data(1:myscreen.events.n);
-  myscreen.events.ticknum = myscreen.events.ticknum(1:myscreen.events.n);
-  myscreen.events.volnum = myscreen.events.volnum(1:myscreen.events.n);
-  myscreen.events.time = myscreen.events.time(1:myscreen.events.n);
+  myscreen.events = truncateEvents(myscreen.events);
   % make time start at 0
   myscreen.time = myscreen.time - myscreen.time(1);
 end
 if exist('disppercent')&&verbose,disppercent(inf);end
 
+
+%%%%%%%%%%%%%%%%%%%%%%%%
+%    truncateEvents    %
+%%%%%%%%%%%%%%%%%%%%%%%%
+function events = truncateEvents(events)
+
+events.tracenum = events.tracenum(1:events.n);
+events.data = events.data(1:events.n);
+events.ticknum = events.ticknum(1:events.n);
+events.volnum = events.volnum(1:events.n);
+events.time = events.time(1:events.n);
@@ -0,0 +1,141 @@
+% mglMakeStimulusImage.m
+%
+%      usage: im = mglMakeStimulusImage(type,width,height,<'sf',sf>,<'angle',angle>,<'phase',phase>,...)
+%         by: justin gardner
+%       date: 10/19/2026
+%  copyright: (c) 2006 Justin Gardner, Jonas Larsson (GPL see mgl/COPYING)
+%    purpose: make grating, gaussian, gabor or plaid images natively, on
+%             all processors, the same as mglMakeGrating and
+%             mglMakeGaussian would make them. Can make a whole family of
+%             images with different angles and phases at once, and can
+%             give them as textures ready for mglCreateTexture.
+%
+%             type is 'grating', 'gaussian', 'gabor' (grating times
+%             gaussian) or 'plaid' (the mean of two gratings, plaidAngle
+%             degrees apart). width and height are in degrees of visual
+%             angle, and height of nan makes a 1D grating, as for
+%             mglMakeGrating. Other arguments are name/value pairs:
+%
+%             sf: cycles/degree (default 1)
+%             angle, phase: degrees, as for mglMakeGrating (default 0).
+%                Either or both can be vectors to make a family of
+%                images, one for each angle and phase.
+%             contrast: scales the grating (default 1)
+%             plaidAngle: degrees between plaid components (default 90)
+%             sdx, sdy, xCenter, yCenter: as for mglMakeGaussian
+%                (default 1, 1, 0, 0)
+%             xDeg2pix, yDeg2pix: as for mglMakeGrating (default from the
+%                open screen)
+%             format: 'double' (default) or 'single' are height x width
+%                (x nImages) with the same values as mglMakeGrating and
+%                mglMakeGaussian. 'rgba' is single height x width x 4
+%                (x nImages) from 0 to 1, and 'uint8' is uint8 4 x width x
+%                height (x nImages) from 0 to 255, which mglCreateTexture
+%                takes directly. In these, gratings, gabors and plaids
+%                are shown around gray as (m+1)/2, and gaussians as m.
+%             alphaMask: for 'gabor' in 'rgba' or 'uint8', put the grating
+%                in rgb and the gaussian in alpha instead of multiplying
+%                them (default 0)
+%             nThreads: default is the number of processors
+%
+%       e.g.:
+%
+% mglOpen;
+% mglVisualAngleCoordinates(57,[16 12]);
+% gabors = mglMakeStimulusImage('gabor',8,8,'sf',1.5,'phase',0:30:330,'sdx',1,'sdy',1,'format','uint8');
+% for i = 1:size(gabors,4)
+%   tex(i) = mglCreateTexture(gabors(:,:,:,i));
+% end
+% mglBltTexture(tex(1),[0 0]);
+% mglFlush;
+%
+function im = mglMakeStimulusImage(type,width,height,varargin)
+
+% check arguments
+im = [];
+if (nargin < 3) || mod(length(varargin),2)
+  help mglMakeStimulusImage
+  return
+end
+
+% check that the native version is compiled
+if exist('mglPrivateMakeStimulusImage')~=3
+  disp(sprintf('(mglMakeStimulusImage) mglPrivateMakeStimulusImage is not compiled. Run mglMakeMetal'));
+  return
+end
+
+% defaults
+params.type = type;
+params.format = 'double';
+params.sf = 1;
+params.angle = 0;
+params.phase = 0;
+params.contrast = 1;
+params.plaidAngle = 90;
+params.sdx = 1;
+params.sdy = 1;
+params.xCenter = 0;
+params.yCenter = 0;
+params.alphaMask = 0;
+xDeg2pix = [];
+yDeg2pix = [];
+nThreads = [];
+
+% name/value arguments
+for iArg = 1:2:length(varargin)
+  switch(varargin{iArg})
+    case {'sf','angle','phase','contrast','plaidAngle','sdx','sdy','xCenter','yCenter','alphaMask','format'}
+      params.(varargin{iArg}) = varargin{iArg+1};
+    case 'xDeg2pix'
+      xDeg2pix = varargin{iArg+1};
+    case 'yDeg2pix'
+      yDeg2pix = varargin{iArg+1};
+    case 'nThreads'
+      nThreads = varargin{iArg+1};
+    otherwise
+      disp(sprintf('(mglMakeStimulusImage) Unknown argument %s',varargin{iArg}));
+      return
+  end
+end
+params.angle = double(params.angle(:)');
+params.phase = double(params.phase(:)');
+
+% defaults for xDeg2pix and yDeg2pix
+if isempty(xDeg2pix)
+  if isempty(mglGetParam('xDeviceToPixels'))
+    disp(sprintf('(mglMakeStimulusImage) mgl is not initialized'));
+    return
+  end
+  xDeg2pix = mglGetParam('xDeviceToPixels');
+end
+if isempty(yDeg2pix)
+  if isempty(mglGetParam('yDeviceToPixels'))
+    disp(sprintf('(mglMakeStimulusImage) mgl is not initialized'));
+    return
+  end
+  yDeg2pix = mglGetParam('yDeviceToPixels');
+end
+
+% get size in pixels, and coordinates of pixels, as mglMakeGrating does
+params.widthPixels = round(width*xDeg2pix);
+params.widthPixels = params.widthPixels + mod(params.widthPixels+1,2);
+params.xStart = -width/2;
+params.xStep = width/max(params.widthPixels-1,1);
+if isnan(height)
+  % 1D grating, which ignores orientation
+  params.heightPixels = 1;
+  params.yStart = 0;
+  params.yStep = 0;
+  params.angle = 90;
+else
+  params.heightPixels = round(height*yDeg2pix);
+  params.heightPixels = params.heightPixels + mod(params.heightPixels+1,2);
+  params.yStart = -height/2;
+  params.yStep = height/max(params.heightPixels-1,1);
+end
+
+if isempty(nThreads)
+  im = mglPrivateMakeStimulusImage(params);
+else
+  im = mglPrivateMakeStimulusImage(params,nThreads);
+end
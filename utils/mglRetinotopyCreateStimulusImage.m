@@ -36,29 +36,56 @@ if s.stimulus.stimulusType == 3
   s.elementAngle = e.randVars.elementAngle;
 end
 
-% open the screen
+% draw on the CPU if we can, which needs no display or GPU, otherwise open the screen
 screenWidth = 80;screenHeight = 60;
-if mglGetParam('displayNumber') ~= -1,mglClose;end
-mglSetParam('offscreenContext',1);
-mglOpen(0,screenWidth,screenHeight);
+useRasterize = (exist('mglPrivateRasterize')==3);
+if useRasterize
+  mglRasterize('open',screenWidth,screenHeight);
+else
+  if mglGetParam('displayNumber') ~= -1,mglClose;end
+  mglSetParam('offscreenContext',1);
+  mglOpen(0,screenWidth,screenHeight);
+  % draw into an offscreen texture, so that frames can be read back
+  mglFrameGrab('init');
+end
 mglVisualAngleCoordinates(s.myscreen.displayDistance,s.myscreen.displaySize);
 
+% each frame is read back while the next one is drawn, and collected after,
+% or when drawing on the CPU, all the frames are drawn at the end
 timePoints = 0:1.5:252;
 disppercent(-inf,'(mglRetinotopy) Computing mask images');
 for iImage = 1:length(timePoints)
-  maskImage(iImage,1:screenWidth,1:screenHeight) = createMaskImage(s,timePoints(iImage));
+  if useRasterize
+    createMaskImage(s,timePoints(iImage),false);
+  else
+    readback(iImage) = createMaskImage(s,timePoints(iImage),true);
+    if iImage > 1
+      maskImage(iImage-1,1:screenWidth,1:screenHeight) = collectMaskImage(readback(iImage-1));
+    end
+  end
   disppercent(iImage/length(timePoints));
 end
+if useRasterize
+  frames = mglRasterize('close');
+  for iImage = 1:size(frames,4)
+    maskImage(iImage,1:screenWidth,1:screenHeight) = blackAndWhite(frames(:,:,:,iImage));
+  end
+else
+  maskImage(iImage,1:screenWidth,1:screenHeight) = collectMaskImage(readback(iImage));
+end
 disppercent(inf);
 
 % close screen
-mglSetParam('offscreenContext',0);
-mglClose;
+if ~useRasterize
+  mglFrameGrab('end');
+  mglSetParam('offscreenContext',0);
+  mglClose;
+end
 
 %%%%%%%%%%%%%%%%%%%%%%%%%
 %    createMaskImage    %
 %%%%%%%%%%%%%%%%%%%%%%%%%
-function maskImage = createMaskImage(s,t)
+function readback = createMaskImage(s,t,doReadback)
 
 % find the beginning of the experiment
 firstTimepoint = find(s.vol);
@@ -124,8 +151,24 @@ end
 % flush
 mglFlush;
 
-% grab the screen
-maskImage = mglFrameGrab;
+% start reading back the screen, without waiting for it
+readback = [];
+if doReadback
+  readback = mglMetalReadbackIssue;
+end
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%
+%    collectMaskImage    %
+%%%%%%%%%%%%%%%%%%%%%%%%%%
+function maskImage = collectMaskImage(readback)
+
+% get the screen read back by createMaskImage
+maskImage = blackAndWhite(mglMetalReadbackCollect(readback));
+
+%%%%%%%%%%%%%%%%%%%%%%%
+%    blackAndWhite    %
+%%%%%%%%%%%%%%%%%%%%%%%
+function maskImage = blackAndWhite(maskImage)
 
 % make into a black and white image
 maskImage((maskImage > 0.51) | (maskImage < 0.49)) = 1;